@@ -9,6 +9,10 @@ uniform vec3 eyePosition;
 uniform float stepSize;
 uniform sampler3D volumeSampler;
 uniform sampler1D colorMapSampler;
+uniform sampler3D blockSampler;
+uniform vec3 blockTextureScale;
+uniform vec3 bcScale;
+uniform vec3 bcOffset;
 
 varying vec3 mcPosition;
 varying vec3 dcPosition;
@@ -37,6 +41,11 @@ void main()
 	/* Convert the ray direction to data coordinates: */
 	vec3 dcDir=mcDir*mcScale;
 	
+	/* Convert the ray direction to block coordinates, nudging zero components to keep block exit distances finite: */
+	vec3 bcDir=dcDir*bcScale;
+	bcDir+=vec3(equal(bcDir,vec3(0.0)))*1.0e-6;
+	vec3 bcExitFace=step(0.0,bcDir);
+	
 	/* Cast the ray and accumulate opacities and colors: */
 	vec4 accum=vec4(0.0,0.0,0.0,0.0);
 	
@@ -48,19 +57,37 @@ void main()
 		samplePos+=dcDir*lambda;
 		for(int i=0;i<1500;++i)
 			{
-			/* Get the volume data value at the current sample position: */
-			vec4 vol=texture1D(colorMapSampler,texture3D(volumeSampler,samplePos).a);
-			
-			/* Accumulate color and opacity: */
-			accum+=vol*(1.0-accum.a);
+			/* Check whether the block containing the current sample position is fully transparent: */
+			vec3 bcPos=samplePos*bcScale+bcOffset;
+			vec3 block=floor(bcPos);
+			if(texture3D(blockSampler,(block+vec3(0.5))*blockTextureScale).r==0.0)
+				{
+				/* Leap to the first sample position past the block's exit point, staying on integer multiples of the step size: */
+				vec3 exitDist=(block+bcExitFace-bcPos)/bcDir;
+				float numSteps=floor(min(exitDist.x,min(exitDist.y,exitDist.z)))+1.0;
+				samplePos+=dcDir*numSteps;
+				lambda+=numSteps;
+				}
+			else
+				{
+				/* Get the volume data value at the current sample position: */
+				vec4 vol=texture1D(colorMapSampler,texture3D(volumeSampler,samplePos).a);
+				
+				/* Accumulate color and opacity: */
+				accum+=vol*(1.0-accum.a);
+				
+				/* Bail out when opacity hits 1.0: */
+				if(accum.a>=1.0-1.0/256.0)
+					break;
+				
+				/* Advance the sample position: */
+				samplePos+=dcDir;
+				lambda+=1.0;
+				}
 			
-			/* Bail out when opacity hits 1.0: */
-			if(accum.a>=1.0-1.0/256.0||lambda>=lambdaMax)
+			/* Stop before the ray's exit point, where the next brick along the ray takes over: */
+			if(lambda>=lambdaMax)
 				break;
-			
-			/* Advance the sample position: */
-			samplePos+=dcDir;
-			lambda+=1.0;
 			}
 		}
 	
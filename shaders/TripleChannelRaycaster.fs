@@ -65,12 +65,16 @@ void main()
 			accum+=vol*(1.0-accum.a);
 			
 			/* Bail out when opacity hits 1.0: */
-			if(accum.a>=1.0-1.0/256.0||lambda>=lambdaMax)
+			if(accum.a>=1.0-1.0/256.0)
 				break;
 			
 			/* Advance the sample position: */
 			samplePos+=dcDir;
 			lambda+=1.0;
+			
+			/* Stop before the ray's exit point, where the next brick along the ray takes over: */
+			if(lambda>=lambdaMax)
+				break;
 			}
 		}
 	
@@ -54,14 +54,14 @@ void* Extractor::masterExtractorThreadMethod(void)
 		#ifdef __DARWIN__
 		if(terminate)
 			return 0;
-		while(seedParameters==0)
+		while(seedParameters==0||held)
 			{
 			seedRequestCond.wait(seedRequestMutex);
 			if(terminate)
 				return 0;
 			}
 		#else
-		while(seedParameters==0)
+		while(seedParameters==0||held)
 			seedRequestCond.wait(seedRequestMutex);
 		#endif
 		
@@ -71,6 +71,7 @@ void* Extractor::masterExtractorThreadMethod(void)
 		
 		/* Grab the seed request ID: */
 		requestID=seedRequestID;
+		extracting=true;
 		}
 		
 		/* Get the next free visualization element: */
@@ -164,6 +165,13 @@ void* Extractor::masterExtractorThreadMethod(void)
 			mostRecentIndex=nextIndex;
 			update();
 			}
+		
+		/* Tell waiting threads that the element is finished: */
+		{
+		Threads::Mutex::Lock seedRequestLock(seedRequestMutex);
+		extracting=false;
+		idleCond.broadcast();
+		}
 		}
 	
 	return 0;
@@ -188,6 +196,10 @@ void* Extractor::slaveExtractorThreadMethod(void)
 		if(terminate)
 			return 0;
 		#endif
+		{
+		Threads::Mutex::Lock seedRequestLock(seedRequestMutex);
+		extracting=true;
+		}
 		
 		/* Get the next free visualization element: */
 		int nextIndex=(lockedIndex+1)%3;
@@ -228,6 +240,13 @@ void* Extractor::slaveExtractorThreadMethod(void)
 			mostRecentIndex=nextIndex;
 			update();
 			}
+		
+		/* Tell waiting threads that the element is finished: */
+		{
+		Threads::Mutex::Lock seedRequestLock(seedRequestMutex);
+		extracting=false;
+		idleCond.broadcast();
+		}
 		}
 	
 	return 0;
@@ -241,6 +260,7 @@ Extractor::Extractor(Extractor::Algorithm* sExtractor)
 	 finalElementPending(false),finalSeedRequestID(0),
 	 seedParameters(0),
 	 seedRequestID(0),
+	 held(false),extracting(false),
 	 lockedIndex(0),mostRecentIndex(0)
 	{
 	/* Initialize the extraction thread communications: */
@@ -314,6 +334,32 @@ void Extractor::finalize(unsigned int newFinalSeedRequestID)
 	finalSeedRequestID=newFinalSeedRequestID;
 	}
 
+void Extractor::hold(void)
+	{
+	Threads::Mutex::Lock seedRequestLock(seedRequestMutex);
+	held=true;
+	}
+
+void Extractor::release(void)
+	{
+	Threads::Mutex::Lock seedRequestLock(seedRequestMutex);
+	held=false;
+	seedRequestCond.signal();
+	}
+
+bool Extractor::isIdle(void)
+	{
+	Threads::Mutex::Lock seedRequestLock(seedRequestMutex);
+	return !extracting;
+	}
+
+void Extractor::waitIdle(void)
+	{
+	Threads::Mutex::Lock seedRequestLock(seedRequestMutex);
+	while(extracting)
+		idleCond.wait(seedRequestMutex);
+	}
+
 Extractor::ElementPointer Extractor::checkUpdates(void)
 	{
 	/* Get the most recent visualization element from the extractor thread: */
@@ -321,7 +367,7 @@ Extractor::ElementPointer Extractor::checkUpdates(void)
 		{
 		/* Delete the previously locked visualization element: */
 		trackedElements[lockedIndex]=0;
-
+		
 		/* Lock the most recent visualization element: */
 		lockedIndex=mostRecentIndex;
 		}
@@ -69,6 +69,9 @@ class Extractor
 	Threads::Cond seedRequestCond; // Condition variable for the extractor thread to block on
 	Parameters* volatile seedParameters; // Extraction parameters for the most recently requested visualization element
 	volatile unsigned int seedRequestID; // ID of current seed request
+	bool held; // Flag whether the extractor thread must not start extracting new visualization elements
+	bool extracting; // Flag whether the extractor thread is currently extracting or receiving a visualization element
+	Threads::Cond idleCond; // Condition variable signalled when the extractor thread finishes a visualization element
 	
 	/* Extractor thread communication output: */
 	volatile int lockedIndex; // Index of locked element
@@ -93,6 +96,10 @@ class Extractor
 		}
 	void seedRequest(unsigned int newSeedRequestID,Parameters* newSeedParameters); // Posts a new seed request to the extraction thread
 	void finalize(unsigned int newFinalSeedRequestID); // Posts a finalization request for the given seed request ID
+	void hold(void); // Keeps the extraction thread from starting new visualization elements; seed requests are kept until the extractor is released
+	void release(void); // Lets the extraction thread process seed requests again
+	bool isIdle(void); // Returns true if the extraction thread is not working on a visualization element
+	void waitIdle(void); // Blocks until the extraction thread is not working on a visualization element
 	bool isFinalizationPending(void) const // Returns true if the main thread is waiting for a new final visualization element
 		{
 		return finalElementPending;
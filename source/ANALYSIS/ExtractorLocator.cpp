@@ -57,6 +57,31 @@ void ExtractorLocator::busyFunction(float percentageCompletion)
 		}
 	}
 
+void ExtractorLocator::parametersChangedFunction(Extractor::Algorithm* algorithm)
+	{
+	/* Don't replace the seed request of a pending final extraction: */
+	if(isFinalizationPending())
+		return;
+	
+	/* Bump up the seed request ID: */
+	if((++lastSeedRequestID)==0) // 0 is an invalid ID
+		++lastSeedRequestID;
+	
+	if(extractor->isMaster())
+		{
+		#ifdef VISUALIZER_USE_COLLABORATION
+		if(application->sharedVisualizationClient!=0)
+			{
+			/* Send a seed request to the shared visualization server: */
+			application->sharedVisualizationClient->postSeedRequest(this,lastSeedRequestID,extractor->cloneParameters());
+			}
+		#endif
+		
+		/* Post a seed request to preview an element for the changed parameters: */
+		seedRequest(lastSeedRequestID,extractor->cloneParameters());
+		}
+	}
+
 ExtractorLocator::ExtractorLocator(Vrui::LocatorTool * sLocatorTool, VirtualATR * sApplication, Extractor::Algorithm * sExtractor)
 	:BaseLocator(sLocatorTool,sApplication),Extractor(sExtractor),
 	 settingsDialog(extractor->createSettingsDialog(Vrui::getWidgetManager())),
@@ -68,6 +93,9 @@ ExtractorLocator::ExtractorLocator(Vrui::LocatorTool * sLocatorTool, VirtualATR
 	/* Set the algorithm's busy function: */
 	extractor->setBusyFunction(new Misc::VoidMethodCall<float,ExtractorLocator>(this,&ExtractorLocator::busyFunction));
 	
+	/* Set the algorithm's parameters changed function: */
+	extractor->setParametersChangedFunction(new Misc::VoidMethodCall<Extractor::Algorithm*,ExtractorLocator>(this,&ExtractorLocator::parametersChangedFunction));
+	
 	#ifdef VISUALIZER_USE_COLLABORATION
 	if(application->sharedVisualizationClient!=0)
 		{
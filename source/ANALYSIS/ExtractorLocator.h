@@ -39,6 +39,7 @@ class ExtractorLocator:public BaseLocator,public Extractor
 	/* Private methods: */
 	GLMotif::PopupWindow* createBusyDialog(const char* algorithmName); // Creates the busy dialog
 	void busyFunction(float completionPercentage); // Called during long-running operations
+	void parametersChangedFunction(Algorithm* algorithm); // Called when the algorithm's parameters are changed from its settings dialog
 	
 	/* Constructors and destructors: */
 	public:
@@ -40,7 +40,7 @@ Methods of class Algortithm:
 Algorithm::Algorithm(VariableManager* sVariableManager,Comm::MulticastPipe* sPipe)
 	:variableManager(sVariableManager),pipe(sPipe),
 	 master(pipe==0||pipe->isMaster()),
-	 busyFunction(0)
+	 busyFunction(0),parametersChangedFunction(0)
 	{
 	}
 
@@ -49,8 +49,9 @@ Algorithm::~Algorithm(void)
 	/* Shut down a cluster communication pipe (doesn't do anything if there was no pipe): */
 	delete pipe;
 	
-	/* Delete the busy function: */
+	/* Delete the busy function and the parameters changed function: */
 	delete busyFunction;
+	delete parametersChangedFunction;
 	}
 
 void Algorithm::setBusyFunction(Algorithm::BusyFunction* newBusyFunction)
@@ -62,6 +63,15 @@ void Algorithm::setBusyFunction(Algorithm::BusyFunction* newBusyFunction)
 	busyFunction=newBusyFunction;
 	}
 
+void Algorithm::setParametersChangedFunction(Algorithm::ParametersChangedFunction* newParametersChangedFunction)
+	{
+	/* Delete the previous parameters changed function: */
+	delete parametersChangedFunction;
+	
+	/* Set the parameters changed function: */
+	parametersChangedFunction=newParametersChangedFunction;
+	}
+
 bool Algorithm::hasGlobalCreator(void) const
 	{
 	return false;
@@ -57,6 +57,7 @@ class Algorithm
 	/* Embedded classes: */
 	public:
 	typedef Misc::FunctionCall<float> BusyFunction; // Type for functions called during long-running operations
+	typedef Misc::FunctionCall<Algorithm*> ParametersChangedFunction; // Type for functions called when the extraction parameters are changed from the settings dialog
 	
 	/* Elements: */
 	private:
@@ -64,6 +65,7 @@ class Algorithm
 	Comm::MulticastPipe* pipe; // Multicast pipe to synchronize element extraction in a cluster-based environment; created externally but owned by Algorithm object
 	bool master; // Flag if this instance of the algorithm runs on the master node of a visualization cluster
 	BusyFunction* busyFunction; // Function called at regular intervals during a long-running operation
+	ParametersChangedFunction* parametersChangedFunction; // Function called when the algorithm wants a new element extracted for changed parameters
 	
 	/* Constructors and destructors: */
 	public:
@@ -93,6 +95,12 @@ class Algorithm
 		if(busyFunction!=0)
 			(*busyFunction)(completionPercentage);
 		}
+	void setParametersChangedFunction(ParametersChangedFunction* newParametersChangedFunction); // Sets the parameters changed function; object inherits function call object
+	void callParametersChangedFunction(void) // Calls the parameters changed function
+		{
+		if(parametersChangedFunction!=0)
+			(*parametersChangedFunction)(this);
+		}
 	virtual const char* getName(void) const =0; // Returns the algorithm's name
 	virtual bool hasGlobalCreator(void) const; // Returns true if the algorithm has a global creation method
 	virtual bool hasSeededCreator(void) const; // Returns true if the algorithm has a seeded creation method
@@ -61,6 +61,32 @@ bool DataSet::Locator::setOrientation(const DataSet::Orientation& newOrientation
 	return result;
 	}
 
+void DataSet::Locator::calcScalars(const ScalarExtractor* scalarExtractor,size_t numPoints,const DataSet::Point* positions,DataSet::VScalar* values,bool* valids) const
+	{
+	/* Evaluate the positions one at a time using a copy of this locator: */
+	Locator* probe=clone();
+	for(size_t i=0;i<numPoints;++i)
+		{
+		probe->setPosition(positions[i]);
+		if((valids[i]=probe->isValid()))
+			values[i]=probe->calcScalar(scalarExtractor);
+		}
+	delete probe;
+	}
+
+void DataSet::Locator::calcVectors(const VectorExtractor* vectorExtractor,size_t numPoints,const DataSet::Point* positions,DataSet::VVector* values,bool* valids) const
+	{
+	/* Evaluate the positions one at a time using a copy of this locator: */
+	Locator* probe=clone();
+	for(size_t i=0;i<numPoints;++i)
+		{
+		probe->setPosition(positions[i]);
+		if((valids[i]=probe->isValid()))
+			values[i]=probe->calcVector(vectorExtractor);
+		}
+	delete probe;
+	}
+
 /************************
 Methods of class DataSet:
 ************************/
@@ -82,6 +108,11 @@ ScalarExtractor* DataSet::getScalarExtractor(int scalarVariableIndex) const
 	return 0;
 	}
 
+unsigned int DataSet::getScalarVariableVersion(int scalarVariableIndex) const
+	{
+	return 0;
+	}
+
 int DataSet::getNumVectorVariables(void) const
 	{
 	return 0;
@@ -99,6 +130,60 @@ VectorExtractor* DataSet::getVectorExtractor(int vectorVariableIndex) const
 	return 0;
 	}
 
+int DataSet::addDerivedScalarVariable(const char* name,const char* expression)
+	{
+	Misc::throwStdErr("DataSet::addDerivedScalarVariable: data set does not support derived variables");
+	return -1;
+	}
+
+int DataSet::addResampledScalarVariable(const char* name,const DataSet* source,int sourceScalarVariableIndex)
+	{
+	Misc::throwStdErr("DataSet::addResampledScalarVariable: data set does not support resampled variables");
+	return -1;
+	}
+
+int DataSet::getNumSteps(void) const
+	{
+	return 1;
+	}
+
+const char* DataSet::getStepName(int stepIndex) const
+	{
+	if(stepIndex!=0)
+		Misc::throwStdErr("DataSet::getStepName: invalid step index %d",stepIndex);
+	return "";
+	}
+
+int DataSet::getCurrentStep(void) const
+	{
+	return 0;
+	}
+
+void DataSet::requestStep(int stepIndex)
+	{
+	if(stepIndex!=0)
+		Misc::throwStdErr("DataSet::requestStep: invalid step index %d",stepIndex);
+	}
+
+bool DataSet::isStepLoaded(int stepIndex) const
+	{
+	return stepIndex==0;
+	}
+
+void DataSet::showStep(int stepIndex)
+	{
+	if(stepIndex!=0)
+		Misc::throwStdErr("DataSet::showStep: invalid step index %d",stepIndex);
+	}
+
+void DataSet::updateScalarExtractor(ScalarExtractor* scalarExtractor,int scalarVariableIndex) const
+	{
+	}
+
+void DataSet::updateVectorExtractor(VectorExtractor* vectorExtractor,int vectorVariableIndex) const
+	{
+	}
+
 }
 
 }
@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef VISUALIZATION_ABSTRACT_DATASET_INCLUDED
 #define VISUALIZATION_ABSTRACT_DATASET_INCLUDED
 
+#include <stddef.h>
 #include <utility>
 #include <Geometry/Point.h>
 #include <Geometry/Rotation.h>
@@ -87,6 +88,8 @@ class DataSet
 		virtual bool isValid(void) const =0; // Returns true if the locator is inside the data set's domain
 		virtual VScalar calcScalar(const ScalarExtractor* scalarExtractor) const =0; // Calculates scalar value at current locator position (locator must be valid)
 		virtual VVector calcVector(const VectorExtractor* vectorExtractor) const =0; // Calculates vector value at current locator position (locator must be valid)
+		virtual void calcScalars(const ScalarExtractor* scalarExtractor,size_t numPoints,const Point* positions,VScalar* values,bool* valids) const; // Calculates scalar values at many positions without moving the locator; stores whether each position is inside the data set's domain, and leaves values outside the domain unchanged
+		virtual void calcVectors(const VectorExtractor* vectorExtractor,size_t numPoints,const Point* positions,VVector* values,bool* valids) const; // Ditto for vector values
 		};
 	
 	/* Constructors and destructors: */
@@ -109,12 +112,23 @@ class DataSet
 	virtual int getNumScalarVariables(void) const; // Returns number of scalar variables contained in the data set
 	virtual const char* getScalarVariableName(int scalarVariableIndex) const; // Returns descriptive name of a scalar variable
 	virtual ScalarExtractor* getScalarExtractor(int scalarVariableIndex) const; // Returns scalar extractor for a scalar variable
+	virtual unsigned int getScalarVariableVersion(int scalarVariableIndex) const; // Returns a number that changes whenever the values of a scalar variable change, such as after showing another value step
 	virtual VScalarRange calcScalarValueRange(const ScalarExtractor* scalarExtractor) const =0; // Calculates the range of scalar values extracted by the given extractor
 	virtual int getNumVectorVariables(void) const; // Returns number of vector variables contained in the data set
 	virtual const char* getVectorVariableName(int vectorVariableIndex) const; // Returns descriptive name of a vector variable
 	virtual VectorExtractor* getVectorExtractor(int vectorVariableIndex) const; // Returns vector extractor for a vector variable
 	virtual VScalarRange calcVectorValueMagnitudeRange(const VectorExtractor* vectorExtractor) const =0; // Calculates the magnitude range of vector values extracted by the given extractor
+	virtual int addDerivedScalarVariable(const char* name,const char* expression); // Adds a scalar variable defined by an expression over the existing scalar variables, such as "if([Relative Error]>0.1,0,[Flux])"; returns the new variable's index; throws exception if the data set does not support derived variables
+	virtual int addResampledScalarVariable(const char* name,const DataSet* source,int sourceScalarVariableIndex); // Adds a scalar variable holding the given data set's scalar variable resampled at this data set's vertices; returns the new variable's index; throws exception if the data set does not support resampled variables
 	virtual Locator* getLocator(void) const =0; // Returns an invalid locator for the data set
+	virtual int getNumSteps(void) const; // Returns number of value steps sharing the data set's grid, such as simulation runs at different parameter settings
+	virtual const char* getStepName(int stepIndex) const; // Returns descriptive name of a value step
+	virtual int getCurrentStep(void) const; // Returns the index of the value step whose values are currently stored in the data set
+	virtual void requestStep(int stepIndex); // Requests the given value step to be shown; its values are loaded in the background if necessary
+	virtual bool isStepLoaded(int stepIndex) const; // Returns true if the given value step can be shown without waiting for its values to load
+	virtual void showStep(int stepIndex); // Makes the given value step current, waiting for its values to load if necessary; must not be called while any extraction reads the data set's values
+	virtual void updateScalarExtractor(ScalarExtractor* scalarExtractor,int scalarVariableIndex) const; // Points a scalar extractor returned by getScalarExtractor at the variable's values of the current value step
+	virtual void updateVectorExtractor(VectorExtractor* vectorExtractor,int vectorVariableIndex) const; // Ditto for vector extractors
 	};
 
 }
@@ -0,0 +1,56 @@
+/***********************************************************************
+ExtractionIndex - Abstract base class for acceleration indices built
+over a scalar variable of a data set to speed up global extraction of
+visualization elements. Indices are built on demand by visualization
+algorithms and cached by the variable manager.
+Part of the abstract interface to the templatized visualization
+components.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_ABSTRACT_EXTRACTIONINDEX_INCLUDED
+#define VISUALIZATION_ABSTRACT_EXTRACTIONINDEX_INCLUDED
+
+#include <Threads/RefCounted.h>
+
+namespace Visualization {
+
+namespace Abstract {
+
+class ExtractionIndex:public Threads::RefCounted
+	{
+	/* Constructors and destructors: */
+	public:
+	ExtractionIndex(void)
+		{
+		}
+	private:
+	ExtractionIndex(const ExtractionIndex& source); // Prohibit copy constructor
+	ExtractionIndex& operator=(const ExtractionIndex& source); // Prohibit assignment operator
+	public:
+	virtual ~ExtractionIndex(void)
+		{
+		}
+	};
+
+}
+
+}
+
+#endif
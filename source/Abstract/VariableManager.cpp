@@ -49,7 +49,8 @@ Methods of class VariableManager::ScalarVariable:
 VariableManager::ScalarVariable::ScalarVariable(void)
 	:scalarExtractor(0),
 	 colorMap(0),
-	 palette(0)
+	 palette(0),
+	 extractionIndexVersion(0)
 	{
 	}
 
@@ -230,11 +231,14 @@ void VariableManager::setCurrentScalarVariable(int newCurrentScalarVariableIndex
 		sv.palette=0;
 		}
 	
+	/* Display the new scalar variable's control point values linearly: */
+	paletteEditor->setQuantizer(ScalarQuantizer());
+	
 	/* Update the palette editor's title: */
 	char title[256];
 	snprintf(title,sizeof(title),"Palette Editor - %s",dataSet->getScalarVariableName(newCurrentScalarVariableIndex));
 	paletteEditor->setTitleString(title);
-
+	
 	/* Update the color bar dialog: */
 	snprintf(title,sizeof(title),"Color Bar - %s",dataSet->getScalarVariableName(newCurrentScalarVariableIndex));
 	colorBarDialogPopup->setTitleString(title);
@@ -303,6 +307,43 @@ const VectorExtractor* VariableManager::getVectorExtractor(int vectorVariableInd
 	return vectorExtractors[vectorVariableIndex];
 	}
 
+VariableManager::ExtractionIndexPointer VariableManager::getExtractionIndex(int scalarVariableIndex)
+	{
+	if(scalarVariableIndex<0||scalarVariableIndex>=numScalarVariables)
+		return ExtractionIndexPointer();
+	
+	Threads::Mutex::Lock extractionIndexLock(extractionIndexMutex);
+	ScalarVariable& sv=scalarVariables[scalarVariableIndex];
+	
+	/* Drop an index that was built from since changed values, such as another value step: */
+	if(sv.extractionIndex.getPointer()!=0&&sv.extractionIndexVersion!=dataSet->getScalarVariableVersion(scalarVariableIndex))
+		sv.extractionIndex=ExtractionIndexPointer();
+	
+	return sv.extractionIndex;
+	}
+
+void VariableManager::setExtractionIndex(int scalarVariableIndex,unsigned int version,VariableManager::ExtractionIndexPointer newExtractionIndex)
+	{
+	if(scalarVariableIndex<0||scalarVariableIndex>=numScalarVariables)
+		return;
+	
+	Threads::Mutex::Lock extractionIndexLock(extractionIndexMutex);
+	ScalarVariable& sv=scalarVariables[scalarVariableIndex];
+	sv.extractionIndex=newExtractionIndex;
+	sv.extractionIndexVersion=version;
+	}
+
+void VariableManager::updateExtractors(void)
+	{
+	/* Update the extractors in place, as their clients keep pointers to them: */
+	for(int i=0;i<numScalarVariables;++i)
+		if(scalarVariables[i].scalarExtractor!=0)
+			dataSet->updateScalarExtractor(scalarVariables[i].scalarExtractor,i);
+	for(int i=0;i<numVectorVariables;++i)
+		if(vectorExtractors[i]!=0)
+			dataSet->updateVectorExtractor(vectorExtractors[i],i);
+	}
+
 void VariableManager::showColorBar(bool show)
 	{
 	/* Hide or show color bar dialog based on parameter: */
@@ -447,6 +488,21 @@ void VariableManager::insertPaletteEditorControlPoint(double newControlPoint)
 	paletteEditor->getColorMap()->insertControlPoint(newControlPoint);
 	}
 
+bool VariableManager::isPaletteEditorQuantized(int scalarVariableIndex) const
+	{
+	return scalarVariableIndex==currentScalarVariableIndex&&paletteEditor->getQuantizer().getMode()!=ScalarQuantizer::LINEAR;
+	}
+
+bool VariableManager::setPaletteEditorQuantizer(int scalarVariableIndex,const ScalarQuantizer& newQuantizer)
+	{
+	/* The palette editor only shows the current scalar variable's palette: */
+	if(scalarVariableIndex!=currentScalarVariableIndex)
+		return false;
+	
+	paletteEditor->setQuantizer(newQuantizer);
+	return true;
+	}
+
 }
 
 }
@@ -23,7 +23,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef VISUALIZATION_ABSTRACT_VARIABLEMANAGER_INCLUDED
 #define VISUALIZATION_ABSTRACT_VARIABLEMANAGER_INCLUDED
 
+#include <Misc/Autopointer.h>
+#include <Threads/Mutex.h>
+
 #include <Abstract/DataSet.h>
+#include <Abstract/ExtractionIndex.h>
 #include <PaletteEditor.h>
 
 /* Forward declarations: */
@@ -57,6 +61,8 @@ class VariableManager
 		RAINBOW
 		};
 	
+	typedef Misc::Autopointer<ExtractionIndex> ExtractionIndexPointer; // Type for pointers to cached extraction indices
+	
 	private:
 	struct ScalarVariable // Structure containing state of a scalar variable
 		{
@@ -66,6 +72,8 @@ class VariableManager
 		DataSet::VScalarRange valueRange; // Value range of the scalar variable
 		GLColorMap* colorMap; // The color map to render the scalar variable
 		PaletteEditor::Storage* palette; // Pointer to palette editor state for the scalar variable
+		ExtractionIndexPointer extractionIndex; // Acceleration index for global extraction from the scalar variable, or null if not built yet
+		unsigned int extractionIndexVersion; // Version number of the scalar variable's values from which the acceleration index was built
 		
 		/* Constructors and destructors: */
 		ScalarVariable(void);
@@ -84,6 +92,7 @@ class VariableManager
 	VectorExtractor** vectorExtractors; // Array of extractors for the data set's vector variables
 	int currentScalarVariableIndex; // The index of the currently selected scalar variable
 	int currentVectorVariableIndex; // The index of the currently selected vector variable
+	Threads::Mutex extractionIndexMutex; // Mutex serializing access to the scalar variables' acceleration indices from extraction threads
 	
 	/* Private methods: */
 	void prepareScalarVariable(int scalarVariableIndex);
@@ -128,6 +137,9 @@ class VariableManager
 	const DataSet::VScalarRange& getScalarValueRange(int scalarVariableIndex); // Returns the value range of the given scalar variable
 	const GLColorMap* getColorMap(int scalarVariableIndex); // Returns the color map for the given scalar variable
 	const VectorExtractor* getVectorExtractor(int vectorVariableIndex); // Returns a new vector extractor for the given vector variable
+	ExtractionIndexPointer getExtractionIndex(int scalarVariableIndex); // Returns the acceleration index cached for the given scalar variable's current values, or null if there is none
+	void setExtractionIndex(int scalarVariableIndex,unsigned int version,ExtractionIndexPointer newExtractionIndex); // Caches an acceleration index built for the given scalar variable from the values of the given version
+	void updateExtractors(void); // Points all scalar and vector extractors at the data set's values after the value step changed; must not be called while any extraction is running
 	const ScalarExtractor* getCurrentScalarExtractor(void) const // Returns the current scalar extractor
 		{
 		return scalarVariables[currentScalarVariableIndex].scalarExtractor;
@@ -149,6 +161,8 @@ class VariableManager
 	void createPalette(int newPaletteType); // Creates a default palette for the current scalar variable
 	void loadPalette(const char* paletteFileName); // Loads a palette for the current scalar variable
 	void insertPaletteEditorControlPoint(double newControlPoint); // Inserts a new control point into the palette editor at the given value
+	bool isPaletteEditorQuantized(int scalarVariableIndex) const; // Returns true if the palette editor displays the given scalar variable's control point values through a non-linear quantizer
+	bool setPaletteEditorQuantizer(int scalarVariableIndex,const ScalarQuantizer& newQuantizer); // Displays the palette editor's control point values through the given quantizer until another scalar variable is selected; returns false if the given scalar variable is not the current one
 	};
 
 }
@@ -65,7 +65,7 @@ void ColorBar::updateTickMarks(void)
 	for(int i=0;i<numTickMarks;++i)
 		{
 		/* Calculate the tick mark value: */
-		double value=valueMin+(valueMax-valueMin)*double(i)/double(numTickMarks-1);
+		double value=quantizer.unmap(double(i)/double(numTickMarks-1));
 		
 		/* Create the tick mark label: */
 		char label[20];
@@ -395,7 +395,7 @@ void ColorBar::initContext(GLContextData& contextData) const
 	contextData.addDataItem(this,dataItem);
 	}
 
-void ColorBar::setColorMap(GLColorMap* newColorMap)
+void ColorBar::setColorMap(const GLColorMap* newColorMap)
 	{
 	/* Set the color map: */
 	colorMap=newColorMap;
@@ -403,9 +403,16 @@ void ColorBar::setColorMap(GLColorMap* newColorMap)
 
 void ColorBar::setValueRange(double newValueMin,double newValueMax)
 	{
-	/* Set the new value range: */
-	valueMin=newValueMin;
-	valueMax=newValueMax;
+	/* Label the new value range linearly: */
+	setQuantizer(ScalarQuantizer(ScalarQuantizer::LINEAR,newValueMin,newValueMax));
+	}
+
+void ColorBar::setQuantizer(const ScalarQuantizer& newQuantizer)
+	{
+	/* Set the new value range and quantizer: */
+	valueMin=newQuantizer.getValueMin();
+	valueMax=newQuantizer.getValueMax();
+	quantizer=newQuantizer;
 	
 	/* Update the tick marks: */
 	updateTickMarks();
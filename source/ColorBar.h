@@ -28,6 +28,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <GL/GLFont.h>
 #include <GLMotif/Widget.h>
 
+#include <ScalarQuantizer.h>
+
 /* Forward declarations: */
 class GLColorMap;
 
@@ -64,7 +66,7 @@ class ColorBar:public Widget,public GLObject
 		int numTickMarks; // Number of tick mark label texture objects
 		GLuint* textureObjectIds; // Array of tick mark label texture objects
 		GLuint tickMarksVersion; // Version number of all tick marks
-
+		
 		/* Constructors and destructors: */
 		DataItem(int sNumTickMarks);
 		virtual ~DataItem(void);
@@ -75,7 +77,8 @@ class ColorBar:public Widget,public GLObject
 	GLfloat colorBarHeight; // Preferred height of color bar
 	Box colorBarBox; // Position and size of color bar
 	double valueMin,valueMax; // Value range of color bar
-	GLColorMap* colorMap; // Pointer to used color map
+	ScalarQuantizer quantizer; // Quantizer mapping positions along the color bar back to values for the tick mark labels
+	const GLColorMap* colorMap; // Pointer to used color map
 	GLFont* font; // Pointer to the font used to render tick marks
 	GLfloat tickMarkHeight; // Height of tick marks themselves
 	GLfloat tickMarkWidth; // Width of tick mark at the base
@@ -105,8 +108,9 @@ class ColorBar:public Widget,public GLObject
 	virtual void initContext(GLContextData& contextData) const;
 	
 	/* New methods: */
-	void setColorMap(GLColorMap* newColorMap); // Sets a new color map
-	void setValueRange(double newValueMin,double newValueMax); // Sets a new value range
+	void setColorMap(const GLColorMap* newColorMap); // Sets a new color map
+	void setValueRange(double newValueMin,double newValueMax); // Sets a new value range with linear tick mark labels
+	void setQuantizer(const ScalarQuantizer& newQuantizer); // Sets a new value range whose tick mark labels follow the given quantizer's inverse mapping
 	};
 
 }
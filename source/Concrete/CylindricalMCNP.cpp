@@ -0,0 +1,167 @@
+/***********************************************************************
+CylindricalMCNP - Reads the cylindrical mesh tallies of a Mesh Tally file
+generated by a MCNP run into a cylindrical data set, such that points
+are located analytically in radius, height, and angle. This is a 3D
+Visualizer module.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <Misc/ThrowStdErr.h>
+#include <Misc/Timer.h>
+#include <Plugins/FactoryManager.h>
+
+#include <Concrete/CylindricalMCNP.h>
+#include <Concrete/MCNPResultParser.h>
+#include <Concrete/MCNPMeshtalIndex.h>
+
+#define PI 3.1415926535897932384626
+
+namespace Visualization {
+
+namespace Concrete {
+
+/*********************************
+Methods of class CylindricalMCNP:
+*********************************/
+
+/***********************************************************************
+Constructor for CylindricalMCNP class. Contains no code except the
+definition of its own name.
+***********************************************************************/
+
+CylindricalMCNP::CylindricalMCNP(void)
+	:BaseModule("CylindricalMCNP")
+	{
+	}
+
+/***********************************************************************
+Method to load a data set from a file, given a particular command line.
+Reads all energy bins of the first cylindrical mesh tally in an ASCII
+Mesh Tally file; vertices are placed at the mesh cell centers.
+***********************************************************************/
+
+Visualization::Abstract::DataSet* CylindricalMCNP::load(const std::vector<std::string>& args, Comm::MulticastPipe* pipe) const
+	{
+	/* Map the Mesh Tally file provided and index all its tallies and energy bins in a single pass: */
+	MCNPResultParser parser(args[0].c_str());
+	MCNPMeshtalIndex index(parser.getFileStart(),parser.getFileEnd());
+	
+	/* Find the first tally on a cylindrical mesh: */
+	int tallyIndex;
+	for(tallyIndex=0;tallyIndex<index.getNumTallies()&&!index.getTally(tallyIndex).cylindrical;++tallyIndex)
+		;
+	if(tallyIndex==index.getNumTallies())
+		Misc::throwStdErr("CylindricalMCNP::load: No complete cylindrical mesh tally in Mesh Tally file %s",args[0].c_str());
+	const MCNPMeshtalIndex::Tally& tally=index.getTally(tallyIndex);
+	std::vector<int> binIndices;
+	for(int binIndex=0;binIndex<index.getNumBins();++binIndex)
+		if(index.getBin(binIndex).tallyIndex==tallyIndex)
+			binIndices.push_back(binIndex);
+	
+	/* Create the result data set: */
+	DataSet* result=new DataSet;
+	DS& dataSet=result->getDs(); // Get the internal data representation from the result data set
+	
+	/* Define the result data set's grid layout; the angular axis wraps around if the mesh covers a full revolution: */
+	DS::Index numVertices=tally.getNumVertices(); // One vertex per mesh cell
+	const std::vector<double>& angles=tally.boundaries[2];
+	bool closedAngle=fabs(angles.back()-angles.front()-1.0)<1.0e-6;
+	dataSet.setGrid(numVertices,0,closedAngle);
+	
+	/* Place the vertices at the mesh cell centers, resized to fit in the core and with angles converted from revolutions to radians: */
+	for(int axis=0;axis<3;++axis)
+		{
+		DS::Scalar* coords=dataSet.getVertexCoordinates(axis);
+		const std::vector<double>& boundaries=tally.boundaries[axis];
+		double scale=axis==2?2.0*PI:0.01;
+		for(int i=0;i<numVertices[axis];++i)
+			coords[i]=DS::Scalar((boundaries[i]+boundaries[i+1])*0.5*scale);
+		}
+	
+	/* Read the flux and relative error of all energy bins in parallel, directly into the data set: */
+	Misc::Timer parseTimer;
+	const int valueColumns[2]={tally.resultColumn,tally.relativeErrorColumn};
+	for(std::vector<int>::iterator biIt=binIndices.begin();biIt!=binIndices.end();++biIt)
+		{
+		const MCNPMeshtalIndex::Bin& bin=index.getBin(*biIt);
+		int firstSlice=dataSet.addSlice();
+		dataSet.addSlice();
+		DS::ValueScalar* const slices[2]={dataSet.getSliceArray(firstSlice),dataSet.getSliceArray(firstSlice+1)};
+		parser.parseResultBlock(bin.blockStart,bin.blockEnd,numVertices,tally.coordinateColumns,0,2,valueColumns,slices);
+		}
+	parseTimer.elapse();
+	std::cout<<"CylindricalMCNP: Parsed "<<binIndices.size()<<" energy bins of "<<numVertices.calcIncrement(-1)<<" result rows in "<<parseTimer.getTime()*1000.0<<" ms"<<std::endl;
+	
+	/* Define the result data set's variables as they are selected in 3D Visualizer's menus: */
+	DataValue& dataValue=result->getDataValue(); // Get the internal representations of the data set's value space
+	dataValue.initialize(&dataSet); // Initialize the value space for the data set
+	int sliceIndex=0;
+	for(std::vector<int>::iterator biIt=binIndices.begin();biIt!=binIndices.end();++biIt,sliceIndex+=2)
+		{
+		std::string energySuffix;
+		const std::string& energyLabel=index.getBin(*biIt).energyLabel;
+		if(!energyLabel.empty())
+			energySuffix=" ("+energyLabel+")";
+		dataValue.setScalarVariableName(sliceIndex,("Flux"+energySuffix).c_str());
+		dataValue.setScalarVariableName(sliceIndex+1,("Relative Error"+energySuffix).c_str());
+		}
+	
+	/* Place the cylinder in the core the same way as rectangular meshes: aligned with its axis, moved to its origin, and rotated to fit: */
+	DS::Vector axis(DS::Scalar(tally.axis[0]),DS::Scalar(tally.axis[1]),DS::Scalar(tally.axis[2]));
+	DS::Vector origin(DS::Scalar(tally.origin[0]*0.01),DS::Scalar(tally.origin[1]*0.01),DS::Scalar((tally.origin[2]-20.51685)*0.01));
+	DS::GridTransformation gridTransformation=DS::GridTransformation::rotate(DS::GridTransformation::Rotation::rotateZ(DS::Scalar(PI/4)));
+	gridTransformation*=DS::GridTransformation::translate(origin);
+	gridTransformation*=DS::GridTransformation::rotate(DS::GridTransformation::Rotation::rotateFromTo(DS::Vector(0,0,1),axis));
+	dataSet.setGridTransformation(gridTransformation);
+	
+	/* Finalize the data set's grid structure (required): */
+	dataSet.finalizeGrid();
+	
+	/* Return the result data set: */
+	return result;
+	}
+
+}
+
+}
+
+/***********************************************************************
+Plug-in interface functions. These allow loading dynamically loading
+modules into 3D Visualizer at run-time, and do not have to be changed
+except for the name of the generated module class.
+***********************************************************************/
+
+extern "C" Visualization::Abstract::Module* createFactory(Plugins::FactoryManager<Visualization::Abstract::Module>& manager)
+	{
+	/* Create module object and insert it into class hierarchy: */
+	Visualization::Concrete::CylindricalMCNP* module=new Visualization::Concrete::CylindricalMCNP();
+	
+	/* Return module object: */
+	return module;
+	}
+
+extern "C" void destroyFactory(Visualization::Abstract::Module* module)
+	{
+	delete module;
+	}
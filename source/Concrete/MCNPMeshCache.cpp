@@ -0,0 +1,371 @@
+/***********************************************************************
+MCNPMeshCache - Class to write and memory-map binary cache files
+holding the grid axes and vertex value slices of MCNP mesh tallies, to
+avoid re-parsing large ASCII meshtal files on every start.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <Concrete/MCNPMeshCache.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+namespace Visualization {
+
+namespace Concrete {
+
+namespace {
+
+/***********************************************************************
+Layout of cache files. All values are stored in little-endian byte
+order; the header is followed by the per-axis vertex coordinate arrays,
+and each value slice starts on its own page boundary such that slices
+can be used directly from the memory-mapped file.
+***********************************************************************/
+
+const char cacheFileMagic[8]={'M','C','N','P','M','S','H','C'};
+const uint32_t cacheFileVersion=2U;
+const uint64_t cacheFilePageSize=4096U; // Alignment of value slices inside the file; multiple of all common page sizes
+const size_t sourceSampleSize=16384; // Size of the samples taken from the head and tail of the source file
+
+struct FileHeader
+	{
+	/* Elements: */
+	public:
+	char magic[8]; // File identifier
+	uint32_t version; // File format version number
+	uint32_t headerSize; // Size of this header in bytes
+	char formatName[32]; // Name of the module that wrote the cache file
+	uint64_t sourceSize; // Size of the source file in bytes at the time the cache was written
+	int64_t sourceMTime; // Modification time of the source file at the time the cache was written
+	int64_t sourceMTimeNsec; // Nanoseconds of the source file's modification time
+	uint64_t sourceChecksum; // Checksum of the head and tail of the source file
+	int32_t numVertices[3]; // Number of grid vertices along each axis
+	int32_t numSlices; // Number of value slices
+	uint64_t coordinatesOffset; // Offset of the first vertex coordinate array from the beginning of the file
+	uint64_t slicesOffset; // Offset of the first value slice from the beginning of the file
+	uint64_t sliceStride; // Distance between the beginnings of consecutive value slices
+	uint64_t fileSize; // Total size of the cache file in bytes
+	uint64_t dataChecksum; // Checksum of all vertex coordinates and slice values
+	uint64_t headerChecksum; // Checksum of all preceding header fields
+	};
+
+struct FileLayout // Structure describing the placement of data inside a cache file
+	{
+	/* Elements: */
+	public:
+	uint64_t numCoordinates; // Total number of vertex coordinates along all axes
+	uint64_t sliceSize; // Number of values in each slice
+	uint64_t coordinatesOffset;
+	uint64_t slicesOffset;
+	uint64_t sliceStride;
+	uint64_t fileSize;
+	
+	/* Constructors and destructors: */
+	FileLayout(const int32_t numVertices[3],int32_t numSlices)
+		{
+		numCoordinates=uint64_t(numVertices[0])+uint64_t(numVertices[1])+uint64_t(numVertices[2]);
+		sliceSize=uint64_t(numVertices[0])*uint64_t(numVertices[1])*uint64_t(numVertices[2]);
+		coordinatesOffset=sizeof(FileHeader);
+		slicesOffset=alignToPage(coordinatesOffset+numCoordinates*sizeof(float));
+		sliceStride=alignToPage(sliceSize*sizeof(float));
+		fileSize=slicesOffset+uint64_t(numSlices)*sliceStride;
+		}
+	
+	/* Methods: */
+	static uint64_t alignToPage(uint64_t offset)
+		{
+		return ((offset+cacheFilePageSize-1)/cacheFilePageSize)*cacheFilePageSize;
+		}
+	};
+
+inline bool isLittleEndian(void)
+	{
+	const uint32_t test=1U;
+	return *reinterpret_cast<const unsigned char*>(&test)==1U;
+	}
+
+uint64_t updateChecksum(uint64_t checksum,const void* data,size_t dataSize)
+	{
+	/* Calculate a Fletcher-64 checksum over 32-bit words, deferring the modulo operations as long as the sums cannot overflow: */
+	const uint32_t* wordPtr=static_cast<const uint32_t*>(data);
+	size_t numWords=dataSize/sizeof(uint32_t);
+	uint64_t sum1=checksum&0xffffffffU;
+	uint64_t sum2=checksum>>32;
+	while(numWords>0)
+		{
+		size_t blockSize=numWords<65536?numWords:65536;
+		numWords-=blockSize;
+		for(size_t i=0;i<blockSize;++i,++wordPtr)
+			{
+			sum1+=*wordPtr;
+			sum2+=sum1;
+			}
+		sum1%=0xffffffffU;
+		sum2%=0xffffffffU;
+		}
+	return (sum2<<32)|sum1;
+	}
+
+bool calcSourceChecksum(const char* sourceFileName,uint64_t sourceSize,uint64_t& checksum)
+	{
+	/* Checksum the head and tail of the source file, which change when a tally is rewritten even if its size and modification time to the nanosecond do not: */
+	int sourceFd=::open(sourceFileName,O_RDONLY);
+	if(sourceFd<0)
+		return false;
+	uint32_t sample[sourceSampleSize/sizeof(uint32_t)];
+	size_t sampleSize=sourceSize<uint64_t(sourceSampleSize)?size_t(sourceSize):sourceSampleSize;
+	off_t sampleOffsets[2]={0,off_t(sourceSize-uint64_t(sampleSize))};
+	bool ok=true;
+	checksum=0;
+	for(int i=0;i<2&&ok;++i)
+		{
+		memset(sample,0,sizeof(sample));
+		ok=pread(sourceFd,sample,sampleSize,sampleOffsets[i])==ssize_t(sampleSize);
+		checksum=updateChecksum(checksum,sample,sizeof(sample));
+		}
+	close(sourceFd);
+	return ok;
+	}
+
+bool writeBlock(FILE* file,const void* data,size_t dataSize)
+	{
+	return dataSize==0||fwrite(data,1,dataSize,file)==dataSize;
+	}
+
+bool writePadding(FILE* file,uint64_t paddingSize)
+	{
+	static const char zeros[cacheFilePageSize]={0};
+	while(paddingSize>0)
+		{
+		size_t blockSize=paddingSize<cacheFilePageSize?size_t(paddingSize):size_t(cacheFilePageSize);
+		if(!writeBlock(file,zeros,blockSize))
+			return false;
+		paddingSize-=blockSize;
+		}
+	return true;
+	}
+
+}
+
+/******************************
+Methods of class MCNPMeshCache:
+******************************/
+
+MCNPMeshCache::MCNPMeshCache(void* sMapAddress,size_t sMapSize)
+	:mapAddress(sMapAddress),mapSize(sMapSize),
+	 numSlices(0),slices(0)
+	{
+	/* Extract the grid layout from the file header: */
+	const FileHeader* header=static_cast<const FileHeader*>(mapAddress);
+	for(int i=0;i<3;++i)
+		numVertices[i]=header->numVertices[i];
+	char* base=static_cast<char*>(mapAddress);
+	
+	/* Point the vertex coordinate arrays into the mapped file: */
+	float* coordPtr=reinterpret_cast<float*>(base+header->coordinatesOffset);
+	for(int i=0;i<3;++i)
+		{
+		vertexCoordinates[i]=coordPtr;
+		coordPtr+=numVertices[i];
+		}
+	
+	/* Point the value slices into the mapped file: */
+	numSlices=header->numSlices;
+	slices=new float*[numSlices];
+	for(int slice=0;slice<numSlices;++slice)
+		slices[slice]=reinterpret_cast<float*>(base+header->slicesOffset+uint64_t(slice)*header->sliceStride);
+	}
+
+MCNPMeshCache::~MCNPMeshCache(void)
+	{
+	delete[] slices;
+	munmap(mapAddress,mapSize);
+	}
+
+std::string MCNPMeshCache::getCacheFileName(const char* sourceFileName)
+	{
+	std::string result=sourceFileName;
+	result.append(".cache");
+	return result;
+	}
+
+MCNPMeshCache* MCNPMeshCache::open(const char* sourceFileName,const char* formatName,int numSlices,bool verifyData)
+	{
+	/* Cache files are stored in little-endian order and mapped without conversion: */
+	if(!isLittleEndian())
+		return 0;
+	
+	/* Get the source file's current size and modification time: */
+	struct stat sourceStat;
+	if(stat(sourceFileName,&sourceStat)!=0)
+		return 0;
+	
+	/* Open the cache file: */
+	std::string cacheFileName=getCacheFileName(sourceFileName);
+	int cacheFd=::open(cacheFileName.c_str(),O_RDONLY);
+	if(cacheFd<0)
+		return 0;
+	struct stat cacheStat;
+	if(fstat(cacheFd,&cacheStat)!=0||size_t(cacheStat.st_size)<sizeof(FileHeader))
+		{
+		close(cacheFd);
+		return 0;
+		}
+	
+	/* Map the entire cache file privately, such that slice values can be modified in memory without affecting the file: */
+	size_t mapSize=size_t(cacheStat.st_size);
+	void* mapAddress=mmap(0,mapSize,PROT_READ|PROT_WRITE,MAP_PRIVATE,cacheFd,0);
+	close(cacheFd);
+	if(mapAddress==MAP_FAILED)
+		return 0;
+	
+	/* Check the cache file's header: */
+	const FileHeader* header=static_cast<const FileHeader*>(mapAddress);
+	bool valid=memcmp(header->magic,cacheFileMagic,sizeof(cacheFileMagic))==0
+	           &&header->version==cacheFileVersion
+	           &&header->headerSize==sizeof(FileHeader)
+	           &&header->headerChecksum==updateChecksum(0,header,offsetof(FileHeader,headerChecksum))
+	           &&strncmp(header->formatName,formatName,sizeof(header->formatName))==0
+	           &&header->numSlices==numSlices;
+	
+	/* Check whether the source file changed since the cache file was written: */
+	valid=valid&&header->sourceSize==uint64_t(sourceStat.st_size)&&header->sourceMTime==int64_t(sourceStat.st_mtim.tv_sec)&&header->sourceMTimeNsec==int64_t(sourceStat.st_mtim.tv_nsec);
+	uint64_t sourceChecksum;
+	valid=valid&&calcSourceChecksum(sourceFileName,header->sourceSize,sourceChecksum)&&header->sourceChecksum==sourceChecksum;
+	
+	/* Check the cache file's layout: */
+	if(valid)
+		{
+		for(int i=0;i<3;++i)
+			valid=valid&&header->numVertices[i]>1;
+		}
+	if(valid)
+		{
+		FileLayout layout(header->numVertices,header->numSlices);
+		valid=layout.coordinatesOffset==header->coordinatesOffset
+		      &&layout.slicesOffset==header->slicesOffset
+		      &&layout.sliceStride==header->sliceStride
+		      &&layout.fileSize==header->fileSize
+		      &&layout.fileSize==uint64_t(mapSize);
+		
+		if(valid&&verifyData)
+			{
+			/* Verify the checksum of the cached data; this touches every page of the file, so it is only done on request: */
+			const char* base=static_cast<const char*>(mapAddress);
+			uint64_t checksum=updateChecksum(0,base+layout.coordinatesOffset,layout.numCoordinates*sizeof(float));
+			for(int slice=0;slice<numSlices;++slice)
+				checksum=updateChecksum(checksum,base+layout.slicesOffset+uint64_t(slice)*layout.sliceStride,layout.sliceSize*sizeof(float));
+			valid=checksum==header->dataChecksum;
+			}
+		}
+	
+	if(!valid)
+		{
+		munmap(mapAddress,mapSize);
+		return 0;
+		}
+	
+	return new MCNPMeshCache(mapAddress,mapSize);
+	}
+
+bool MCNPMeshCache::write(const char* sourceFileName,const char* formatName,const MCNPMeshCache::Index& numVertices,const float* const vertexCoordinates[3],int numSlices,const float* const slices[])
+	{
+	/* Only write cache files that can be mapped without conversion: */
+	if(!isLittleEndian())
+		return false;
+	
+	/* Get the source file's current size and modification time: */
+	struct stat sourceStat;
+	if(stat(sourceFileName,&sourceStat)!=0)
+		return false;
+	
+	/* Create the file header: */
+	FileHeader header;
+	memset(&header,0,sizeof(FileHeader));
+	memcpy(header.magic,cacheFileMagic,sizeof(cacheFileMagic));
+	header.version=cacheFileVersion;
+	header.headerSize=sizeof(FileHeader);
+	strncpy(header.formatName,formatName,sizeof(header.formatName)-1);
+	header.sourceSize=uint64_t(sourceStat.st_size);
+	header.sourceMTime=int64_t(sourceStat.st_mtim.tv_sec);
+	header.sourceMTimeNsec=int64_t(sourceStat.st_mtim.tv_nsec);
+	if(!calcSourceChecksum(sourceFileName,header.sourceSize,header.sourceChecksum))
+		return false;
+	for(int i=0;i<3;++i)
+		header.numVertices[i]=int32_t(numVertices[i]);
+	header.numSlices=int32_t(numSlices);
+	FileLayout layout(header.numVertices,header.numSlices);
+	header.coordinatesOffset=layout.coordinatesOffset;
+	header.slicesOffset=layout.slicesOffset;
+	header.sliceStride=layout.sliceStride;
+	header.fileSize=layout.fileSize;
+	
+	/* Calculate the data and header checksums: */
+	uint64_t checksum=0;
+	for(int i=0;i<3;++i)
+		checksum=updateChecksum(checksum,vertexCoordinates[i],size_t(numVertices[i])*sizeof(float));
+	for(int slice=0;slice<numSlices;++slice)
+		checksum=updateChecksum(checksum,slices[slice],size_t(layout.sliceSize)*sizeof(float));
+	header.dataChecksum=checksum;
+	header.headerChecksum=updateChecksum(0,&header,offsetof(FileHeader,headerChecksum));
+	
+	/* Write the cache into a uniquely named temporary file next to the cache file first, so that readers never see a partial cache file and concurrent writers on other processes or cluster nodes do not clobber each other's files: */
+	std::string cacheFileName=getCacheFileName(sourceFileName);
+	std::string tempFileName=cacheFileName+".XXXXXX";
+	int tempFd=mkstemp(&tempFileName[0]);
+	if(tempFd<0)
+		return false;
+	fchmod(tempFd,S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH);
+	FILE* file=fdopen(tempFd,"wb");
+	if(file==0)
+		{
+		close(tempFd);
+		unlink(tempFileName.c_str());
+		return false;
+		}
+	bool ok=writeBlock(file,&header,sizeof(FileHeader));
+	for(int i=0;i<3&&ok;++i)
+		ok=writeBlock(file,vertexCoordinates[i],size_t(numVertices[i])*sizeof(float));
+	ok=ok&&writePadding(file,layout.slicesOffset-layout.coordinatesOffset-layout.numCoordinates*sizeof(float));
+	for(int slice=0;slice<numSlices&&ok;++slice)
+		{
+		ok=writeBlock(file,slices[slice],size_t(layout.sliceSize)*sizeof(float));
+		ok=ok&&writePadding(file,layout.sliceStride-layout.sliceSize*sizeof(float));
+		}
+	ok=fclose(file)==0&&ok;
+	
+	/* Replace any previous cache file: */
+	ok=ok&&rename(tempFileName.c_str(),cacheFileName.c_str())==0;
+	if(!ok)
+		unlink(tempFileName.c_str());
+	
+	return ok;
+	}
+
+}
+
+}
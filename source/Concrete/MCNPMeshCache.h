@@ -0,0 +1,79 @@
+/***********************************************************************
+MCNPMeshCache - Class to write and memory-map binary cache files
+holding the grid axes and vertex value slices of MCNP mesh tallies, to
+avoid re-parsing large ASCII meshtal files on every start.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_CONCRETE_MCNPMESHCACHE_INCLUDED
+#define VISUALIZATION_CONCRETE_MCNPMESHCACHE_INCLUDED
+
+#include <stddef.h>
+#include <string>
+#include <Misc/ArrayIndex.h>
+
+#include <Templatized/ExternalSliceStorage.h>
+
+namespace Visualization {
+
+namespace Concrete {
+
+class MCNPMeshCache:public Templatized::ExternalSliceStorage
+	{
+	/* Embedded classes: */
+	public:
+	typedef Misc::ArrayIndex<3> Index; // Type for grid sizes
+	
+	/* Elements: */
+	private:
+	void* mapAddress; // Start address of the memory-mapped cache file
+	size_t mapSize; // Size of the memory-mapped cache file in bytes
+	Index numVertices; // Number of vertices of the cached grid
+	float* vertexCoordinates[3]; // Pointers to the cached vertex coordinate arrays along each grid axis
+	int numSlices; // Number of cached value slices
+	float** slices; // Array of pointers to the cached value slices
+	
+	/* Constructors and destructors: */
+	MCNPMeshCache(void* sMapAddress,size_t sMapSize); // Creates cache object for an already validated memory-mapped cache file
+	public:
+	virtual ~MCNPMeshCache(void); // Unmaps the cache file; invalidates all slice arrays handed out by the cache
+	
+	/* Methods: */
+	static std::string getCacheFileName(const char* sourceFileName); // Returns the name of the cache file associated with the given source file
+	static MCNPMeshCache* open(const char* sourceFileName,const char* formatName,int numSlices,bool verifyData =false); // Maps the given source file's cache file; returns null if there is no cache file or it is outdated by the source file's size, modification time, or the contents of its head and tail, has a corrupt header or length, or was written by a different module; only checks the cached data against its checksum if verifyData is true
+	static bool write(const char* sourceFileName,const char* formatName,const Index& numVertices,const float* const vertexCoordinates[3],int numSlices,const float* const slices[]); // Writes a cache file for the given source file; returns false if the cache file could not be written
+	const Index& getNumVertices(void) const // Returns the number of vertices of the cached grid
+		{
+		return numVertices;
+		}
+	const float* const* getVertexCoordinates(void) const // Returns the array of cached vertex coordinate arrays
+		{
+		return vertexCoordinates;
+		}
+	float* getSliceArray(int sliceIndex) const // Returns one of the cached value slices; array is valid until the cache object is destroyed
+		{
+		return slices[sliceIndex];
+		}
+	};
+
+}
+
+}
+
+#endif
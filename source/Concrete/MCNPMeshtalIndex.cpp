@@ -0,0 +1,248 @@
+/***********************************************************************
+MCNPMeshtalIndex - Class to index all mesh tallies and energy bins in an
+MCNP meshtal file in a single pass, recording the byte ranges of their
+result blocks such that the values can be parsed on demand.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <Concrete/MCNPMeshtalIndex.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <Concrete/MCNPResultParser.h>
+
+namespace Visualization {
+
+namespace Concrete {
+
+namespace {
+
+/***********************************************************************
+Helper functions to take apart header lines:
+***********************************************************************/
+
+void splitTokens(const std::string& line,std::vector<std::string>& tokens)
+	{
+	tokens.clear();
+	std::string::size_type pos=0;
+	while(true)
+		{
+		pos=line.find_first_not_of(" \t\r\n",pos);
+		if(pos==std::string::npos)
+			break;
+		std::string::size_type tokenEnd=line.find_first_of(" \t\r\n",pos);
+		if(tokenEnd==std::string::npos)
+			tokenEnd=line.size();
+		tokens.push_back(line.substr(pos,tokenEnd-pos));
+		pos=tokenEnd;
+		}
+	}
+
+bool parseColumnHeader(const std::string& line,MCNPMeshtalIndex::Tally& tally)
+	{
+	/* Assign column indices to the column names, merging multi-word names like "Rel Error" and "Rslt * Vol": */
+	std::vector<std::string> tokens;
+	splitTokens(line,tokens);
+	for(int i=0;i<3;++i)
+		tally.coordinateColumns[i]=-1;
+	tally.resultColumn=-1;
+	tally.relativeErrorColumn=-1;
+	int column=0;
+	for(size_t i=0;i<tokens.size();++i,++column)
+		{
+		if(tally.cylindrical)
+			{
+			if(tokens[i]=="R")
+				tally.coordinateColumns[0]=column;
+			else if(tokens[i]=="Z")
+				tally.coordinateColumns[1]=column;
+			else if(tokens[i]=="Th")
+				tally.coordinateColumns[2]=column;
+			}
+		else
+			{
+			if(tokens[i]=="X")
+				tally.coordinateColumns[0]=column;
+			else if(tokens[i]=="Y")
+				tally.coordinateColumns[1]=column;
+			else if(tokens[i]=="Z")
+				tally.coordinateColumns[2]=column;
+			}
+		if(tokens[i]=="Result")
+			tally.resultColumn=column;
+		else if(tokens[i]=="Rel"&&i+1<tokens.size()&&tokens[i+1]=="Error")
+			{
+			tally.relativeErrorColumn=column;
+			++i;
+			}
+		else if(tokens[i]=="Rslt"&&i+2<tokens.size()&&tokens[i+1]=="*"&&tokens[i+2]=="Vol")
+			i+=2;
+		}
+	
+	return tally.coordinateColumns[0]>=0&&tally.coordinateColumns[1]>=0&&tally.coordinateColumns[2]>=0&&tally.resultColumn>=0&&tally.relativeErrorColumn>=0;
+	}
+
+}
+
+/*********************************
+Methods of class MCNPMeshtalIndex:
+*********************************/
+
+MCNPMeshtalIndex::MCNPMeshtalIndex(const char* fileStart,const char* fileEnd)
+	{
+	static const char* const directionTags[6]={"X direction:","Y direction:","Z direction:","R direction:","Theta direction","Cylinder origin at"};
+	static const char* const energyTag="Energy bin boundaries:";
+	static const char* const tallyTag="Mesh Tally Number";
+	static const char* const axisTag="axis in";
+	
+	/* State of the tally whose header is currently being read: */
+	Tally tally;
+	std::vector<std::string> energyBoundaries;
+	
+	const char* linePtr=fileStart;
+	while(linePtr<fileEnd)
+		{
+		const char* nextLinePtr=MCNPResultParser::getNextLine(linePtr,fileEnd);
+		std::string line(linePtr,nextLinePtr);
+		linePtr=nextLinePtr;
+		
+		std::string::size_type found;
+		if((found=line.find(tallyTag))!=std::string::npos)
+			{
+			/* Start a new tally: */
+			tally=Tally();
+			tally.tallyNumber=atoi(line.c_str()+found+strlen(tallyTag));
+			energyBoundaries.clear();
+			continue;
+			}
+		
+		if((found=line.find(directionTags[5]))!=std::string::npos)
+			{
+			/* Read the origin and axis direction of a cylindrical mesh; the origin is followed by a comma: */
+			tally.cylindrical=true;
+			std::string values=line.substr(found+strlen(directionTags[5]));
+			std::replace(values.begin(),values.end(),',',' ');
+			const char* valueEnd=values.c_str()+values.size();
+			const char* valuePtr=values.c_str();
+			for(int i=0;i<3;++i)
+				MCNPResultParser::parseNumber(valuePtr,valueEnd,tally.origin[i]);
+			if((found=values.find(axisTag))!=std::string::npos)
+				{
+				valuePtr=values.c_str()+found+strlen(axisTag);
+				for(int i=0;i<3;++i)
+					MCNPResultParser::parseNumber(valuePtr,valueEnd,tally.axis[i]);
+				}
+			continue;
+			}
+		
+		bool isBoundaryLine=false;
+		for(int tag=0;tag<5&&!isBoundaryLine;++tag)
+			if((found=line.find(directionTags[tag]))!=std::string::npos)
+				{
+				/* Cylindrical meshes store radius, height, and angle boundaries in that order: */
+				int axis=tag;
+				if(tag>=3)
+					{
+					tally.cylindrical=true;
+					axis=tag==3?0:2;
+					}
+				else if(tag==2&&tally.cylindrical)
+					axis=1;
+				
+				/* Read the mesh boundaries along the axis; the angle's tag is followed by its unit: */
+				tally.boundaries[axis].clear();
+				std::string::size_type valueStart=line.find(':',found);
+				if(valueStart==std::string::npos)
+					break;
+				const char* valuePtr=line.c_str()+valueStart+1;
+				const char* valueEnd=line.c_str()+line.size();
+				double boundary;
+				while(MCNPResultParser::parseNumber(valuePtr,valueEnd,boundary))
+					tally.boundaries[axis].push_back(boundary);
+				isBoundaryLine=true;
+				}
+		if(isBoundaryLine)
+			continue;
+		
+		if((found=line.find(energyTag))!=std::string::npos)
+			{
+			/* Remember the energy bin boundaries as written, to label the bins: */
+			splitTokens(line.substr(found+strlen(energyTag)),energyBoundaries);
+			continue;
+			}
+		
+		if(line.find("Result")!=std::string::npos)
+			{
+			/* Determine the layout of the result rows; files without a recognized column header contain rows of x, y, z, result, and relative error: */
+			if(!parseColumnHeader(line,tally))
+				{
+				for(int i=0;i<3;++i)
+					tally.coordinateColumns[i]=i;
+				tally.resultColumn=3;
+				tally.relativeErrorColumn=4;
+				}
+			
+			/* Skip tallies with incomplete meshes; cylindrical meshes can have a single angular bin: */
+			bool validMesh=true;
+			for(int axis=0;axis<3;++axis)
+				validMesh=validMesh&&tally.boundaries[axis].size()>=(tally.cylindrical&&axis==2?2U:3U);
+			if(validMesh)
+				{
+				/* Result rows are grouped by energy bin, followed by the sum over all bins if there is more than one: */
+				int numEnergyBins=energyBoundaries.size()>=2?int(energyBoundaries.size())-1:1;
+				int numBlocks=numEnergyBins>1?numEnergyBins+1:numEnergyBins;
+				size_t numRows=size_t(tally.getNumVertices().calcIncrement(-1));
+				
+				/* Skip over all result rows, recording each bin's byte range: */
+				std::vector<Bin> tallyBins;
+				for(int block=0;block<numBlocks&&linePtr<fileEnd;++block)
+					{
+					Bin bin;
+					bin.tallyIndex=int(tallies.size());
+					if(numEnergyBins>1)
+						bin.energyLabel=block<numEnergyBins?energyBoundaries[block]+" - "+energyBoundaries[block+1]+" MeV":"Total";
+					bin.blockStart=linePtr;
+					size_t row;
+					for(row=0;row<numRows&&linePtr<fileEnd;++row)
+						linePtr=MCNPResultParser::getNextLine(linePtr,fileEnd);
+					bin.blockEnd=linePtr;
+					
+					/* Only keep complete bins: */
+					if(row==numRows)
+						tallyBins.push_back(bin);
+					}
+				
+				if(!tallyBins.empty())
+					{
+					tallies.push_back(tally);
+					bins.insert(bins.end(),tallyBins.begin(),tallyBins.end());
+					}
+				}
+			
+			/* Prepare for the next tally: */
+			tally=Tally();
+			energyBoundaries.clear();
+			}
+		}
+	}
+
+}
+
+}
@@ -0,0 +1,118 @@
+/***********************************************************************
+MCNPMeshtalIndex - Class to index all mesh tallies and energy bins in an
+MCNP meshtal file in a single pass, recording the byte ranges of their
+result blocks such that the values can be parsed on demand.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_CONCRETE_MCNPMESHTALINDEX_INCLUDED
+#define VISUALIZATION_CONCRETE_MCNPMESHTALINDEX_INCLUDED
+
+#include <string>
+#include <vector>
+#include <Misc/ArrayIndex.h>
+
+namespace Visualization {
+
+namespace Concrete {
+
+class MCNPMeshtalIndex
+	{
+	/* Embedded classes: */
+	public:
+	typedef Misc::ArrayIndex<3> Index; // Type for grid sizes
+	
+	struct Tally // Structure describing a mesh tally
+		{
+		/* Elements: */
+		public:
+		int tallyNumber; // MCNP tally number, or -1 if the file does not name its tallies
+		bool cylindrical; // Flag whether the tally uses a cylindrical instead of a rectangular mesh
+		double origin[3]; // Origin of a cylindrical mesh
+		double axis[3]; // Axis direction of a cylindrical mesh
+		std::vector<double> boundaries[3]; // Mesh boundaries along the x, y, and z axes, or along the radius, height, and angle (in revolutions) for cylindrical meshes
+		int coordinateColumns[3]; // Indices of the x, y, and z (or radius, height, and angle) columns in the tally's result rows
+		int resultColumn; // Index of the result column in the tally's result rows
+		int relativeErrorColumn; // Index of the relative error column in the tally's result rows
+		
+		/* Constructors and destructors: */
+		Tally(void) // Creates an unnamed rectangular tally without boundaries
+			:tallyNumber(-1),cylindrical(false)
+			{
+			for(int i=0;i<3;++i)
+				{
+				origin[i]=0.0;
+				axis[i]=i==2?1.0:0.0;
+				}
+			}
+		
+		/* Methods: */
+		Index getNumVertices(void) const // Returns the number of result rows per energy bin along each axis
+			{
+			return Index(int(boundaries[0].size())-1,int(boundaries[1].size())-1,int(boundaries[2].size())-1);
+			}
+		};
+	
+	struct Bin // Structure describing the result block of one energy bin of a mesh tally
+		{
+		/* Elements: */
+		public:
+		int tallyIndex; // Index of the tally containing the bin
+		std::string energyLabel; // Energy range of the bin, "Total" for the sum over all bins, or empty if the tally has a single bin
+		const char* blockStart; // Beginning of the bin's first result row
+		const char* blockEnd; // End of the bin's last result row
+		};
+	
+	/* Elements: */
+	private:
+	std::vector<Tally> tallies; // List of complete tallies in the file
+	std::vector<Bin> bins; // List of energy bins of all tallies in the file
+	
+	/* Constructors and destructors: */
+	public:
+	MCNPMeshtalIndex(const char* fileStart,const char* fileEnd); // Indexes the meshtal file contents in the given memory range
+	
+	/* Methods: */
+	int getNumTallies(void) const // Returns the number of complete tallies in the file
+		{
+		return int(tallies.size());
+		}
+	const Tally& getTally(int tallyIndex) const // Returns one tally
+		{
+		return tallies[tallyIndex];
+		}
+	int getNumBins(void) const // Returns the total number of energy bins in the file
+		{
+		return int(bins.size());
+		}
+	const Bin& getBin(int binIndex) const // Returns one energy bin
+		{
+		return bins[binIndex];
+		}
+	const Tally& getBinTally(int binIndex) const // Returns the tally containing the given energy bin
+		{
+		return tallies[bins[binIndex].tallyIndex];
+		}
+	};
+
+}
+
+}
+
+#endif
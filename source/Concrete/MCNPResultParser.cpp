@@ -0,0 +1,465 @@
+/***********************************************************************
+MCNPResultParser - Class to parse the per-vertex result rows of MCNP
+mesh tally files in parallel, writing coordinates and values directly
+into a data set's per-axis coordinate arrays and value slices.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <Concrete/MCNPResultParser.h>
+
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <Misc/ThrowStdErr.h>
+#include <Threads/Thread.h>
+
+#include <WorkerThreads.h>
+
+namespace Visualization {
+
+namespace Concrete {
+
+namespace {
+
+/***********************************************************************
+Exactly representable powers of ten; multiplying or dividing an exactly
+represented mantissa by one of these yields a correctly rounded result.
+***********************************************************************/
+
+const double powersOfTen[23]=
+	{
+	1.0e0,1.0e1,1.0e2,1.0e3,1.0e4,1.0e5,1.0e6,1.0e7,1.0e8,1.0e9,1.0e10,1.0e11,
+	1.0e12,1.0e13,1.0e14,1.0e15,1.0e16,1.0e17,1.0e18,1.0e19,1.0e20,1.0e21,1.0e22
+	};
+
+inline bool isBlank(char c)
+	{
+	return c==' '||c=='\t'||c=='\r';
+	}
+
+inline bool isDigit(char c)
+	{
+	return c>='0'&&c<='9';
+	}
+
+}
+
+/*************************************************
+Declaration of struct MCNPResultParser::ParseJob:
+*************************************************/
+
+struct MCNPResultParser::ParseJob
+	{
+	/* Elements: */
+	public:
+	const char* chunkStart; // Beginning of the first line in the job's chunk
+	const char* chunkEnd; // End of the job's chunk; always at the beginning of a line or at the end of the file
+	size_t numLines; // Number of line starts in the job's chunk
+	size_t firstRow; // Row index of the first line in the job's chunk
+	Index numVertices; // Number of grid vertices
+	size_t numRows; // Total number of rows in the result block
+	int numColumns; // Number of columns that need to be read from each row
+	const int* columnTargets; // Target for each read column: -1 to skip the column, 0-2 for a vertex coordinate, 3+i for value slice i
+	int numValues; // Number of values read from each row
+	float* const* vertexCoordinates; // Per-axis vertex coordinate arrays, or null if coordinates are not read
+	float* const* slices; // Value slices
+	size_t errorRow; // Index of the first malformed row in the job's chunk, or numRows if there was no error
+	
+	/* Methods: */
+	void* countLinesThreadMethod(void); // Counts the lines in the job's chunk
+	void* parseThreadMethod(void); // Parses the job's chunk
+	};
+
+/*****************************************
+Methods of struct MCNPResultParser::ParseJob:
+*****************************************/
+
+void* MCNPResultParser::ParseJob::countLinesThreadMethod(void)
+	{
+	/* Count every line start, including a final line that is not terminated by a newline: */
+	numLines=0;
+	const char* ptr=chunkStart;
+	while(ptr<chunkEnd)
+		{
+		++numLines;
+		const char* newline=static_cast<const char*>(memchr(ptr,'\n',chunkEnd-ptr));
+		if(newline==0)
+			break;
+		ptr=newline+1;
+		}
+	
+	return 0;
+	}
+
+void* MCNPResultParser::ParseJob::parseThreadMethod(void)
+	{
+	errorRow=numRows;
+	if(firstRow>=numRows)
+		return 0;
+	
+	/* Calculate the grid index of the chunk's first row; K varies fastest: */
+	size_t lastRow=firstRow+numLines;
+	if(lastRow>numRows)
+		lastRow=numRows;
+	Index index;
+	index[2]=int(firstRow%size_t(numVertices[2]));
+	index[1]=int((firstRow/size_t(numVertices[2]))%size_t(numVertices[1]));
+	index[0]=int(firstRow/(size_t(numVertices[2])*size_t(numVertices[1])));
+	
+	/* Parse all rows in the chunk: */
+	const char* ptr=chunkStart;
+	double values[3+maxNumValues];
+	for(size_t row=firstRow;row<lastRow;++row)
+		{
+		/* Parse the vertex position and values from their columns, skipping all other columns: */
+		const char* linePtr=ptr;
+		ptr=MCNPResultParser::getNextLine(ptr,chunkEnd);
+		bool ok=true;
+		for(int column=0;column<numColumns&&ok;++column)
+			{
+			if(columnTargets[column]>=0)
+				ok=MCNPResultParser::parseNumber(linePtr,ptr,values[columnTargets[column]]);
+			else
+				ok=MCNPResultParser::skipToken(linePtr,ptr);
+			}
+		if(!ok)
+			{
+			errorRow=row;
+			break;
+			}
+		
+		/* Store the vertex coordinates along each grid axis: */
+		if(vertexCoordinates!=0)
+			{
+			if(index[1]==0&&index[2]==0)
+				vertexCoordinates[0][index[0]]=float(values[0]);
+			if(index[0]==0&&index[2]==0)
+				vertexCoordinates[1][index[1]]=float(values[1]);
+			if(index[0]==0&&index[1]==0)
+				vertexCoordinates[2][index[2]]=float(values[2]);
+			}
+		
+		/* Store the values in the slices; the row index is the vertex' linear index: */
+		for(int i=0;i<numValues;++i)
+			slices[i][row]=float(values[3+i]);
+		
+		/* Advance the grid index: */
+		if(++index[2]==numVertices[2])
+			{
+			index[2]=0;
+			if(++index[1]==numVertices[1])
+				{
+				index[1]=0;
+				++index[0];
+				}
+			}
+		}
+	
+	return 0;
+	}
+
+/*********************************
+Methods of class MCNPResultParser:
+*********************************/
+
+MCNPResultParser::MCNPResultParser(const char* sFileName)
+	:fileName(sFileName),
+	 fileStart(0),fileSize(0)
+	{
+	/* Open the file: */
+	int fd=open(sFileName,O_RDONLY);
+	if(fd<0)
+		Misc::throwStdErr("MCNPResultParser: Unable to open input file %s",sFileName);
+	struct stat fileStat;
+	if(fstat(fd,&fileStat)!=0)
+		{
+		close(fd);
+		Misc::throwStdErr("MCNPResultParser: Unable to query size of input file %s",sFileName);
+		}
+	
+	/* Map the entire file: */
+	fileSize=size_t(fileStat.st_size);
+	if(fileSize>0)
+		{
+		void* mapAddress=mmap(0,fileSize,PROT_READ,MAP_PRIVATE,fd,0);
+		if(mapAddress==MAP_FAILED)
+			{
+			close(fd);
+			Misc::throwStdErr("MCNPResultParser: Unable to map input file %s",sFileName);
+			}
+		fileStart=static_cast<char*>(mapAddress);
+		
+		/* The file is read front to back: */
+		madvise(mapAddress,fileSize,MADV_SEQUENTIAL);
+		}
+	close(fd);
+	}
+
+MCNPResultParser::~MCNPResultParser(void)
+	{
+	if(fileStart!=0)
+		munmap(fileStart,fileSize);
+	}
+
+const char* MCNPResultParser::getNextLine(const char* linePtr,const char* end)
+	{
+	const char* newline=static_cast<const char*>(memchr(linePtr,'\n',end-linePtr));
+	return newline!=0?newline+1:end;
+	}
+
+bool MCNPResultParser::skipToken(const char*& ptr,const char* end)
+	{
+	/* Skip blanks, but not line ends: */
+	const char* p=ptr;
+	while(p<end&&isBlank(*p))
+		++p;
+	
+	/* Skip the token: */
+	const char* tokenStart=p;
+	while(p<end&&!isBlank(*p)&&*p!='\n')
+		++p;
+	if(p==tokenStart)
+		return false;
+	
+	ptr=p;
+	return true;
+	}
+
+bool MCNPResultParser::parseNumber(const char*& ptr,const char* end,double& value)
+	{
+	/* Skip blanks, but not line ends: */
+	const char* p=ptr;
+	while(p<end&&isBlank(*p))
+		++p;
+	
+	/* Parse the sign: */
+	bool negative=false;
+	if(p<end&&(*p=='-'||*p=='+'))
+		{
+		negative=*p=='-';
+		++p;
+		}
+	
+	/* Accumulate up to 19 significant digits into an integer mantissa: */
+	unsigned long long mantissa=0;
+	int numMantissaDigits=0;
+	int exponent=0;
+	bool haveDigits=false;
+	for(;p<end&&isDigit(*p);++p)
+		{
+		haveDigits=true;
+		if(numMantissaDigits<19)
+			{
+			mantissa=mantissa*10U+(unsigned long long)(*p-'0');
+			if(mantissa!=0)
+				++numMantissaDigits;
+			}
+		else
+			++exponent;
+		}
+	if(p<end&&*p=='.')
+		{
+		for(++p;p<end&&isDigit(*p);++p)
+			{
+			haveDigits=true;
+			if(numMantissaDigits<19)
+				{
+				mantissa=mantissa*10U+(unsigned long long)(*p-'0');
+				if(mantissa!=0)
+					++numMantissaDigits;
+				--exponent;
+				}
+			}
+		}
+	if(!haveDigits)
+		return false;
+	
+	/* Parse the optional exponent; MCNP also writes exponents without the E for three-digit exponents, e.g. 1.0-100: */
+	if(p<end&&(*p=='e'||*p=='E'||*p=='d'||*p=='D'||((*p=='-'||*p=='+')&&p+1<end&&isDigit(p[1]))))
+		{
+		const char* expPtr=p;
+		if(*expPtr!='-'&&*expPtr!='+')
+			++expPtr;
+		bool negativeExponent=false;
+		if(expPtr<end&&(*expPtr=='-'||*expPtr=='+'))
+			{
+			negativeExponent=*expPtr=='-';
+			++expPtr;
+			}
+		if(expPtr<end&&isDigit(*expPtr))
+			{
+			int exp=0;
+			for(;expPtr<end&&isDigit(*expPtr);++expPtr)
+				if(exp<10000)
+					exp=exp*10+(*expPtr-'0');
+			exponent+=negativeExponent?-exp:exp;
+			p=expPtr;
+			}
+		}
+	
+	/* The number must be followed by a separator: */
+	if(p<end&&!isBlank(*p)&&*p!='\n')
+		return false;
+	
+	/* Scale the mantissa by the exponent: */
+	double result=double(mantissa);
+	if(mantissa!=0)
+		{
+		while(exponent>22)
+			{
+			result*=powersOfTen[22];
+			exponent-=22;
+			}
+		while(exponent<-22)
+			{
+			result/=powersOfTen[22];
+			exponent+=22;
+			}
+		if(exponent>=0)
+			result*=powersOfTen[exponent];
+		else
+			result/=powersOfTen[-exponent];
+		}
+	value=negative?-result:result;
+	
+	ptr=p;
+	return true;
+	}
+
+int MCNPResultParser::getDefaultNumThreads(void)
+	{
+	return getNumWorkerThreads(0);
+	}
+
+void MCNPResultParser::parseResultBlock(const char* blockStart,const MCNPResultParser::Index& numVertices,int numValues,float* const vertexCoordinates[3],float* const slices[],int numThreads) const
+	{
+	if(numValues<0||numValues>maxNumValues)
+		Misc::throwStdErr("MCNPResultParser: Unsupported number of values per row in input file %s",fileName.c_str());
+	
+	/* Rows contain the vertex position followed by the values: */
+	int coordinateColumns[3];
+	for(int i=0;i<3;++i)
+		coordinateColumns[i]=i;
+	int valueColumns[maxNumValues];
+	for(int i=0;i<numValues;++i)
+		valueColumns[i]=3+i;
+	parseResultBlock(blockStart,getFileEnd(),numVertices,coordinateColumns,vertexCoordinates,numValues,valueColumns,slices,numThreads);
+	}
+
+void MCNPResultParser::parseResultBlock(const char* blockStart,const char* blockEnd,const MCNPResultParser::Index& numVertices,const int coordinateColumns[3],float* const vertexCoordinates[3],int numValues,const int valueColumns[],float* const slices[],int numThreads) const
+	{
+	if(numValues<0||numValues>maxNumValues)
+		Misc::throwStdErr("MCNPResultParser: Unsupported number of values per row in input file %s",fileName.c_str());
+	size_t numRows=size_t(numVertices.calcIncrement(-1));
+	if(numRows==0)
+		return;
+	
+	/* Assign the read columns to their targets: */
+	int columnTargets[maxNumColumns];
+	for(int i=0;i<maxNumColumns;++i)
+		columnTargets[i]=-1;
+	int numColumns=0;
+	for(int i=0;i<3+numValues;++i)
+		{
+		if(i<3&&vertexCoordinates==0)
+			continue;
+		int column=i<3?coordinateColumns[i]:valueColumns[i-3];
+		if(column<0||column>=maxNumColumns)
+			Misc::throwStdErr("MCNPResultParser: Unsupported column index %d for input file %s",column,fileName.c_str());
+		columnTargets[column]=i;
+		if(numColumns<column+1)
+			numColumns=column+1;
+		}
+	
+	/* Split the block into line-aligned chunks of roughly equal size: */
+	if(numThreads<=0)
+		numThreads=getDefaultNumThreads();
+	size_t blockSize=size_t(blockEnd-blockStart);
+	if(size_t(numThreads)>blockSize/65536+1)
+		numThreads=int(blockSize/65536+1);
+	ParseJob* jobs=new ParseJob[numThreads];
+	const char* chunkStart=blockStart;
+	for(int i=0;i<numThreads;++i)
+		{
+		ParseJob& job=jobs[i];
+		job.chunkStart=chunkStart;
+		if(i<numThreads-1)
+			{
+			const char* chunkEnd=blockStart+(blockSize*size_t(i+1))/size_t(numThreads);
+			if(chunkEnd<chunkStart)
+				chunkEnd=chunkStart;
+			job.chunkEnd=chunkEnd>blockStart?getNextLine(chunkEnd-1,blockEnd):chunkEnd;
+			}
+		else
+			job.chunkEnd=blockEnd;
+		chunkStart=job.chunkEnd;
+		job.numVertices=numVertices;
+		job.numRows=numRows;
+		job.numColumns=numColumns;
+		job.columnTargets=columnTargets;
+		job.numValues=numValues;
+		job.vertexCoordinates=vertexCoordinates;
+		job.slices=slices;
+		}
+	/* Count the lines in all chunks, then parse all chunks, in parallel: */
+	Threads::Thread* threads=numThreads>1?new Threads::Thread[numThreads-1]:0;
+	for(int pass=0;pass<2;++pass)
+		{
+		void* (ParseJob::*threadMethod)(void)=pass==0?&ParseJob::countLinesThreadMethod:&ParseJob::parseThreadMethod;
+		for(int i=1;i<numThreads;++i)
+			threads[i-1].start(&jobs[i],threadMethod);
+		(jobs[0].*threadMethod)();
+		for(int i=1;i<numThreads;++i)
+			threads[i-1].join();
+		
+		if(pass==0)
+			{
+			/* Assign the first row index of each chunk: */
+			size_t firstRow=0;
+			for(int i=0;i<numThreads;++i)
+				{
+				jobs[i].firstRow=firstRow;
+				firstRow+=jobs[i].numLines;
+				}
+			if(firstRow<numRows)
+				{
+				delete[] threads;
+				delete[] jobs;
+				Misc::throwStdErr("MCNPResultParser: Result block in input file %s ends after %u of %u rows",fileName.c_str(),(unsigned int)firstRow,(unsigned int)numRows);
+				}
+			}
+		}
+	delete[] threads;
+	
+	/* Check for malformed rows: */
+	size_t errorRow=numRows;
+	for(int i=0;i<numThreads;++i)
+		if(errorRow>jobs[i].errorRow)
+			errorRow=jobs[i].errorRow;
+	delete[] jobs;
+	if(errorRow<numRows)
+		Misc::throwStdErr("MCNPResultParser: Malformed result row %u in input file %s",(unsigned int)errorRow,fileName.c_str());
+	}
+
+}
+
+}
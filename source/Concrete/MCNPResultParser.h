@@ -0,0 +1,77 @@
+/***********************************************************************
+MCNPResultParser - Class to parse the per-vertex result rows of MCNP
+mesh tally files in parallel, writing coordinates and values directly
+into a data set's per-axis coordinate arrays and value slices.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_CONCRETE_MCNPRESULTPARSER_INCLUDED
+#define VISUALIZATION_CONCRETE_MCNPRESULTPARSER_INCLUDED
+
+#include <stddef.h>
+#include <string>
+#include <Misc/ArrayIndex.h>
+
+namespace Visualization {
+
+namespace Concrete {
+
+class MCNPResultParser
+	{
+	/* Embedded classes: */
+	public:
+	typedef Misc::ArrayIndex<3> Index; // Type for grid sizes
+	static const int maxNumValues=16; // Maximum number of values read from each row
+	static const int maxNumColumns=32; // Maximum index plus one of any column read from a row
+	
+	private:
+	struct ParseJob; // Structure describing the part of a result block parsed by a single thread
+	
+	/* Elements: */
+	std::string fileName; // Name of the parsed file
+	char* fileStart; // Start address of the memory-mapped file
+	size_t fileSize; // Size of the memory-mapped file in bytes
+	
+	/* Constructors and destructors: */
+	public:
+	MCNPResultParser(const char* sFileName); // Maps the given file into memory; throws exception if file cannot be read
+	~MCNPResultParser(void);
+	
+	/* Methods: */
+	const char* getFileStart(void) const // Returns the beginning of the file's contents
+		{
+		return fileStart;
+		}
+	const char* getFileEnd(void) const // Returns the end of the file's contents
+		{
+		return fileStart+fileSize;
+		}
+	static const char* getNextLine(const char* linePtr,const char* end); // Returns the beginning of the line following the given position, or end
+	static bool skipToken(const char*& ptr,const char* end); // Skips blanks and the following token on the current line; advances pointer and returns true if there was a token
+	static bool parseNumber(const char*& ptr,const char* end,double& value); // Parses a number in C notation independent of the current locale after skipping blanks; advances pointer and returns true on success
+	static int getDefaultNumThreads(void); // Returns the number of parsing threads used by default
+	void parseResultBlock(const char* blockStart,const Index& numVertices,int numValues,float* const vertexCoordinates[3],float* const slices[],int numThreads =0) const; // Parses one line per grid vertex starting at the given position, with K varying fastest; each line contains the vertex' x, y, z coordinates followed by the given number of values; throws exception on malformed or missing lines
+	void parseResultBlock(const char* blockStart,const char* blockEnd,const Index& numVertices,const int coordinateColumns[3],float* const vertexCoordinates[3],int numValues,const int valueColumns[],float* const slices[],int numThreads =0) const; // Ditto, for lines inside the given range; reads vertex coordinates from the given columns unless vertexCoordinates is null, and values from the given columns
+	};
+
+}
+
+}
+
+#endif
@@ -363,6 +363,23 @@ void filterImageStack(StackDescriptor& sd,int sliceIndex,bool medianFilter,bool
 	std::cout<<"\b\b\b\bdone in "<<filterTimer.getTime()*1000.0<<" ms"<<std::endl;
 	}
 
+DS::ValueSlice::Format parseStorageFormat(const std::string& formatName)
+	{
+	if(strcasecmp(formatName.c_str(),"native")==0)
+		return DS::ValueSlice::NATIVE;
+	else if(strcasecmp(formatName.c_str(),"half")==0)
+		return DS::ValueSlice::HALF;
+	else if(strcasecmp(formatName.c_str(),"quantized8")==0)
+		return DS::ValueSlice::QUANTIZED8;
+	else if(strcasecmp(formatName.c_str(),"quantized16")==0)
+		return DS::ValueSlice::QUANTIZED16;
+	else
+		Misc::throwStdErr("MultiChannelImageStack::load: Unknown slice storage format %s",formatName.c_str());
+	
+	/* Never reached; just to make compiler happy: */
+	return DS::ValueSlice::NATIVE;
+	}
+
 }
 
 /***************************************
@@ -388,6 +405,7 @@ Visualization::Abstract::DataSet* MultiChannelImageStack::load(const std::vector
 	StackDescriptor sd(dataSet);
 	bool medianFilter=false;
 	bool lowpassFilter=false;
+	DS::ValueSlice::Format storageFormat=DS::ValueSlice::NATIVE;
 	for(size_t i=0;i<args.size();++i)
 		{
 		if(strcasecmp(args[i].c_str(),"-imageSize")==0)
@@ -449,6 +467,12 @@ Visualization::Abstract::DataSet* MultiChannelImageStack::load(const std::vector
 			medianFilter=true;
 		else if(strcasecmp(args[i].c_str(),"-lowpass")==0)
 			lowpassFilter=true;
+		else if(strcasecmp(args[i].c_str(),"-storage")==0)
+			{
+			++i;
+			if(i<args.size())
+				storageFormat=parseStorageFormat(args[i]);
+			}
 		else if(strcasecmp(args[i].c_str(),"-greyscale")==0)
 			{
 			if(i+2<args.size()&&sd.haveDs)
@@ -467,6 +491,9 @@ Visualization::Abstract::DataSet* MultiChannelImageStack::load(const std::vector
 					filterImageStack(sd,newSliceIndex,medianFilter,lowpassFilter);
 				medianFilter=false;
 				lowpassFilter=false;
+				
+				/* Convert the image stack to the requested storage format: */
+				dataSet.encodeSlice(newSliceIndex,storageFormat);
 				}
 			i+=2;
 			}
@@ -492,6 +519,10 @@ Visualization::Abstract::DataSet* MultiChannelImageStack::load(const std::vector
 						filterImageStack(sd,newSliceIndices[j],medianFilter,lowpassFilter);
 				medianFilter=false;
 				lowpassFilter=false;
+				
+				/* Convert the image stacks to the requested storage format: */
+				for(int j=0;j<3;++j)
+					dataSet.encodeSlice(newSliceIndices[j],storageFormat);
 				}
 			i+=4;
 			}
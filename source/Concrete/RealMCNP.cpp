@@ -11,19 +11,237 @@ The ExampleModule is free software under the GNU General Public License.
 
 #include <math.h>
 #include <stdio.h>
+#include <strings.h>
 #include <iostream>
 #include <Plugins/FactoryManager.h>
 #include <string>
 #include <Concrete/RealMCNP.h>
-#include <fstream>
-#include <string>
-#include <sstream>
+#include <vector>
+#include <stdexcept>
+#include <Misc/ThrowStdErr.h>
+#include <Misc/Timer.h>
+#include <Threads/Mutex.h>
+#include <Concrete/MCNPMeshCache.h>
+#include <Concrete/MCNPResultParser.h>
+#include <Concrete/MCNPMeshtalIndex.h>
 
 #define PI 3.1415926535897932384626
 namespace Visualization {
 
 namespace Concrete {
 
+namespace {
+
+/***********************************************************************
+Helper functions and classes:
+***********************************************************************/
+
+DS::Scalar toCoreCoordinate(int axis,double coordinate) // Converts a Mesh Tally coordinate to the core's coordinate system, except for the rotation
+	{
+	if(axis==2)
+		coordinate-=20.51685;
+	return DS::Scalar(coordinate*0.01);
+	}
+
+std::string makeVariableName(const MCNPMeshtalIndex& index,int binIndex,bool multipleTallies,const char* quantity) // Returns the name of a variable of the given energy bin
+	{
+	std::string result;
+	if(multipleTallies)
+		{
+		const MCNPMeshtalIndex::Bin& bin=index.getBin(binIndex);
+		int tallyNumber=index.getTally(bin.tallyIndex).tallyNumber;
+		char tallyName[32];
+		snprintf(tallyName,sizeof(tallyName),"Tally %d ",tallyNumber>=0?tallyNumber:bin.tallyIndex+1);
+		result.append(tallyName);
+		}
+	result.append(quantity);
+	const std::string& energyLabel=index.getBin(binIndex).energyLabel;
+	if(!energyLabel.empty())
+		{
+		result.append(" (");
+		result.append(energyLabel);
+		result.append(")");
+		}
+	return result;
+	}
+
+DS::ValueSlice::Format parseStorageFormat(const std::string& formatName) // Returns the slice storage format of the given name
+	{
+	if(strcasecmp(formatName.c_str(),"native")==0)
+		return DS::ValueSlice::NATIVE;
+	else if(strcasecmp(formatName.c_str(),"half")==0)
+		return DS::ValueSlice::HALF;
+	else if(strcasecmp(formatName.c_str(),"quantized8")==0)
+		return DS::ValueSlice::QUANTIZED8;
+	else if(strcasecmp(formatName.c_str(),"quantized16")==0)
+		return DS::ValueSlice::QUANTIZED16;
+	else
+		Misc::throwStdErr("RealMCNP::load: Unknown slice storage format %s",formatName.c_str());
+	
+	/* Never reached; just to make compiler happy: */
+	return DS::ValueSlice::NATIVE;
+	}
+
+int collectMeshBins(const MCNPMeshtalIndex& index,const char* meshtalFileName,std::vector<int>& binIndices,bool& multipleTallies) // Collects the energy bins of all tallies defined on the same mesh as the first rectangular tally; returns that tally's index, or -1 if there is none
+	{
+	/* Find the first tally on a rectangular mesh; cylindrical meshes are read by the CylindricalMCNP module: */
+	int meshTallyIndex;
+	for(meshTallyIndex=0;meshTallyIndex<index.getNumTallies()&&index.getTally(meshTallyIndex).cylindrical;++meshTallyIndex)
+		;
+	if(meshTallyIndex==index.getNumTallies())
+		return -1;
+	
+	/* Collect the energy bins of all tallies defined on the same mesh as the first tally: */
+	const MCNPMeshtalIndex::Tally& meshTally=index.getTally(meshTallyIndex);
+	binIndices.clear();
+	multipleTallies=false;
+	for(int binIndex=0;binIndex<index.getNumBins();++binIndex)
+		{
+		const MCNPMeshtalIndex::Tally& tally=index.getBinTally(binIndex);
+		bool sameMesh=!tally.cylindrical;
+		for(int axis=0;axis<3;++axis)
+			sameMesh=sameMesh&&tally.boundaries[axis]==meshTally.boundaries[axis];
+		if(sameMesh)
+			{
+			binIndices.push_back(binIndex);
+			multipleTallies=multipleTallies||index.getBin(binIndex).tallyIndex!=meshTallyIndex;
+			}
+		else if(binIndex==0||index.getBin(binIndex-1).tallyIndex!=index.getBin(binIndex).tallyIndex)
+			std::cerr<<"RealMCNP: Ignoring tally "<<tally.tallyNumber<<" in Mesh Tally file "<<meshtalFileName<<" due to mismatching mesh"<<std::endl;
+		}
+	
+	return meshTallyIndex;
+	}
+
+class BinLoader:public Visualization::Templatized::ExternalSliceStorage,public DataValue::SliceLoader // Class to read the values of energy bins on demand
+	{
+	/* Embedded classes: */
+	private:
+	struct SliceSource // Structure describing where a slice's values are stored in the Mesh Tally file
+		{
+		/* Elements: */
+		public:
+		int sliceIndex; // Index of the slice in the data set
+		const char* blockStart; // Beginning of the energy bin's result rows
+		const char* blockEnd; // End of the energy bin's result rows
+		int column; // Index of the slice's column in the result rows
+		DS::ValueScalar* values; // Slice values once they have been read, or null if they have been encoded
+		bool loaded; // Flag whether the slice's values have been read
+		};
+	
+	/* Elements: */
+	DS& dataSet; // Data set whose slices are loaded
+	MCNPResultParser* parser; // Parser owning the memory-mapped Mesh Tally file
+	DS::ValueSlice::Format storageFormat; // Format in which loaded slices are stored in the data set
+	std::vector<SliceSource> sliceSources; // List of slices loaded on demand
+	Threads::Mutex loadMutex; // Mutex serializing slice loading
+	
+	/* Constructors and destructors: */
+	public:
+	BinLoader(DS& sDataSet,MCNPResultParser* sParser,DS::ValueSlice::Format sStorageFormat) // Creates a loader for the given data set; takes ownership of the parser
+		:dataSet(sDataSet),parser(sParser),storageFormat(sStorageFormat)
+		{
+		}
+	virtual ~BinLoader(void)
+		{
+		for(std::vector<SliceSource>::iterator ssIt=sliceSources.begin();ssIt!=sliceSources.end();++ssIt)
+			delete[] ssIt->values;
+		delete parser;
+		}
+	
+	/* Methods: */
+	void addSlice(int sliceIndex,const char* blockStart,const char* blockEnd,int column) // Registers an external slice to be read from the given column of the given result rows
+		{
+		SliceSource ss;
+		ss.sliceIndex=sliceIndex;
+		ss.blockStart=blockStart;
+		ss.blockEnd=blockEnd;
+		ss.column=column;
+		ss.values=0;
+		ss.loaded=false;
+		sliceSources.push_back(ss);
+		}
+	virtual void loadSlice(int sliceIndex)
+		{
+		Threads::Mutex::Lock loadLock(loadMutex);
+		
+		/* Find the slice's source: */
+		std::vector<SliceSource>::iterator ssIt;
+		for(ssIt=sliceSources.begin();ssIt!=sliceSources.end()&&ssIt->sliceIndex!=sliceIndex;++ssIt)
+			;
+		if(ssIt==sliceSources.end()||ssIt->loaded)
+			return;
+		
+		/* Read the slice's values in parallel: */
+		size_t numValues=size_t(dataSet.getNumVertices().calcIncrement(-1));
+		ssIt->values=new DS::ValueScalar[numValues];
+		DS::ValueScalar* const slices[1]={ssIt->values};
+		try
+			{
+			parser->parseResultBlock(ssIt->blockStart,ssIt->blockEnd,dataSet.getNumVertices(),0,0,1,&ssIt->column,slices);
+			}
+		catch(std::runtime_error err)
+			{
+			/* Report the error and carry on with an empty slice: */
+			std::cerr<<"RealMCNP: Caught exception "<<err.what()<<" while reading slice "<<sliceIndex<<std::endl;
+			for(size_t i=0;i<numValues;++i)
+				ssIt->values[i]=DS::ValueScalar(0);
+			}
+		dataSet.setExternalSliceArray(sliceIndex,ssIt->values);
+		ssIt->loaded=true;
+		
+		/* Convert the slice to the requested storage format and release the native values: */
+		if(storageFormat!=DS::ValueSlice::NATIVE)
+			{
+			dataSet.encodeSlice(sliceIndex,storageFormat);
+			delete[] ssIt->values;
+			ssIt->values=0;
+			}
+		}
+	};
+
+class StepFileLoader:public RealMCNP::DataSetSeries::StepLoader // Class to read the values of one Mesh Tally file of a series
+	{
+	/* Elements: */
+	private:
+	std::vector<std::string> meshtalFileNames; // Names of the series' Mesh Tally files
+	DS::Index numVertices; // Number of vertices of the series' mesh
+	size_t numBins; // Number of energy bins read from each file
+	
+	/* Constructors and destructors: */
+	public:
+	StepFileLoader(const std::vector<std::string>& sMeshtalFileNames,const DS::Index& sNumVertices,size_t sNumBins)
+		:meshtalFileNames(sMeshtalFileNames),numVertices(sNumVertices),numBins(sNumBins)
+		{
+		}
+	
+	/* Methods: */
+	virtual void loadStep(int stepIndex,DS::ValueScalar* const slices[])
+		{
+		/* Map and index the step's Mesh Tally file: */
+		const char* meshtalFileName=meshtalFileNames[stepIndex].c_str();
+		MCNPResultParser parser(meshtalFileName);
+		MCNPMeshtalIndex index(parser.getFileStart(),parser.getFileEnd());
+		std::vector<int> binIndices;
+		bool multipleTallies;
+		int meshTallyIndex=collectMeshBins(index,meshtalFileName,binIndices,multipleTallies);
+		if(meshTallyIndex<0||index.getTally(meshTallyIndex).getNumVertices()!=numVertices||binIndices.size()!=numBins)
+			Misc::throwStdErr("RealMCNP: Mesh Tally file %s does not match the mesh and energy bins of the series' first file",meshtalFileName);
+		
+		/* Read the flux and relative error values of all energy bins: */
+		for(size_t i=0;i<numBins;++i)
+			{
+			const MCNPMeshtalIndex::Bin& bin=index.getBin(binIndices[i]);
+			const MCNPMeshtalIndex::Tally& tally=index.getBinTally(binIndices[i]);
+			const int valueColumns[2]={tally.resultColumn,tally.relativeErrorColumn};
+			DS::ValueScalar* const binSlices[2]={slices[i*2],slices[i*2+1]};
+			parser.parseResultBlock(bin.blockStart,bin.blockEnd,numVertices,tally.coordinateColumns,0,2,valueColumns,binSlices);
+			}
+		}
+	};
+
+}
+
 /******************************
 Methods of class RealMCNP:
 ******************************/
@@ -43,128 +261,264 @@ Method to load a data set from a file, given a particular command line.
 This method defines the format of the data files read by this module
 class and has to be written.
 ***********************************************************************/
-
+  
   Visualization::Abstract::DataSet* RealMCNP::load(const std::vector<std::string>& args, Comm::MulticastPipe* pipe) const
 	{
-	/* Create the result data set: */
-	DataSet* result=new DataSet;
-
-        /*Declare data to hold number of vertexes and help read file*/
-        int x_dim=0;
-        int y_dim=0;
-        int z_dim=0;
-        std::string line;
-        std::ifstream myfile;
-        size_t found;
-        
-        /*Read the Mesh Tally file provided*/
-        myfile.open(args[0].c_str());
-        for(int i=0; i<10000; i++)
-        {
-          //determining the number of x points
-          found= line.find("X direction:");
-          if(found!=std::string::npos)
-          {
-            line= line.substr(found+12, 100000);
-            double xs;
-            const char *p=line.c_str();
-            int n;
-            while(sscanf(p, "%lf%n ", &xs, &n)==1)
-            {
-              p+=n;//progress further through the string
-              x_dim++;
-            }
-          }
-          //determining the number of y points
-            found= line.find("Y direction:");
-            if(found!=std::string::npos)
-            {
-              line= line.substr(found+12, 100000);
-              double ys;
-              const char *p=line.c_str();
-              int n;
-              while(sscanf(p, "%lf%n ", &ys, &n)==1)
-              {
-                 p+=n;//progress further through the string
-                 y_dim++;
-              }
-            }
-            //determining the number of z points
-            found= line.find("Z direction:");
-            if(found!=std::string::npos)
-            {
-              line= line.substr(found+12, 100000);
-              double zs;
-              const char *p=line.c_str();
-              int n;
-              while(sscanf(p, "%lf%n ", &zs, &n)==1)
-              {
-                p+=n;//progress further through the string
-                z_dim++;
-              }
-            }
-            //searching for the begining of the data, once found, reading will temporarily stop, indicated by keyword "Result"
-            getline(myfile, line);
-            found= line.find("Result");
-            if(found!= std::string::npos)//Once result is found, stop reading
-            {
-              break;
-            }
-
-        }
-
-        DS::Index numVertices; // DS::Index is a helper type containing three integers NI, NJ, NK
-        /* Use the numbers of points found above to set the numVerticies. Must subtract one because we counted a range:*/
-        numVertices[0]=x_dim-1;
-        numVertices[1]=y_dim-1;
-        numVertices[2]=z_dim-1;
-        
-	/* Define the result data set's grid layout: */
-	DS& dataSet=result->getDs(); // Get the internal data representation from the result data set
-	dataSet.setGrid(numVertices); // Set the data set's number of vertices
-	dataSet.addSlice(); // Add a single scalar variable to the data set's grid
-	dataSet.addSlice(); // Add a single variable to the data set's grid, this call must occur for EACH variable to be stored
+	/* Parse the module command line, separating Mesh Tally file names from options: */
+	std::vector<std::string> meshtalFileNames;
+	bool verifyCache=false;
+	DS::ValueSlice::Format storageFormat=DS::ValueSlice::NATIVE;
+	for(std::vector<std::string>::const_iterator argIt=args.begin();argIt!=args.end();++argIt)
+		{
+		if(strcasecmp(argIt->c_str(),"-verifyCache")==0)
+			verifyCache=true;
+		else if(strcasecmp(argIt->c_str(),"-storage")==0)
+			{
+			++argIt;
+			if(argIt==args.end())
+				Misc::throwStdErr("RealMCNP::load: Missing slice storage format after -storage");
+			storageFormat=parseStorageFormat(*argIt);
+			}
+		else
+			meshtalFileNames.push_back(*argIt);
+		}
+	if(meshtalFileNames.empty())
+		Misc::throwStdErr("RealMCNP::load: No Mesh Tally file name provided");
+	
+	/* Value steps are swapped into the data set's slices in native form: */
+	if(meshtalFileNames.size()>1&&storageFormat!=DS::ValueSlice::NATIVE)
+		Misc::throwStdErr("RealMCNP::load: Encoded slice storage is not supported for series of Mesh Tally files");
 	
-	/* Define the result data set's variables as they are selected in 3D Visualizer's menus: */
+	/* Create the result data set; several Mesh Tally files on the same mesh, such as one per OSCC drum angle, become a series of value steps: */
+	DataSetSeries* series=meshtalFileNames.size()>1?new DataSetSeries:0;
+	DataSet* result=series!=0?series:new DataSet;
+	DS& dataSet=result->getDs(); // Get the internal data representation from the result data set
 	DataValue& dataValue=result->getDataValue(); // Get the internal representations of the data set's value space
-	dataValue.initialize(&dataSet); // Initialize the value space for the data set
-        dataValue.setScalarVariableName(0,"Flux"); // Set the name of the first scalar variable
-        dataValue.setScalarVariableName(1,"Relative Error"); // Set the name of the second scalar variable 
-	
-	/* Read all vertex positions flux, and relative error values where the reading of the file left off: */
-	DS::Index index; // Index counting variable containing three integers I, J, K
-	for(index[0]=0;index[0]<numVertices[0];++index[0]) // I varies most slowly
-		for(index[1]=0;index[1]<numVertices[1];++index[1])
-			for(index[2]=0;index[2]<numVertices[2];++index[2]) // K varies fastest
-				{
-				/* Read the vertex position, flux, and relative error values: */
-                                  double pos[3],flux, relative_err;
-                                  getline(myfile, line);
-                                  sscanf(line.c_str(),"%lf %lf %lf %lf %lf",&pos[0],&pos[1],&pos[2],&flux, &relative_err);
-				
-				  /*Rotating and resizing the data to fit in the core correctly */
-				  double temp_x=pos[0];
-				  pos[0]= ((pos[0]*cos(PI/4))-(pos[1]*sin(PI/4)))*0.01;
-				  pos[1]= ((temp_x*sin(PI/4))+ (pos[1]*cos(PI/4)))*0.01;
-				  pos[2]= (pos[2]-20.51685)*0.01;
-
-				
-				/* Store the positon and values in the data set: */
-				dataSet.getVertexPosition(index)=DS::Point(pos); // Store the vertex' position
-				dataSet.getVertexValue(0,index)=DS::ValueScalar(flux); // Store the vertex' flux
-                                dataSet.getVertexValue(1,index)=DS::ValueScalar(relative_err); //Store the vertex's relative error
-                                }
-	
-	/* Close the input file: */
-        myfile.close();
-
-        /* Finalize the data set's grid structure (required): */
+	
+	/* Map the binary cache file written by an earlier run, if it is still up to date: */
+	MCNPMeshCache* cache=series==0?MCNPMeshCache::open(meshtalFileNames[0].c_str(),"RealMCNP",2,verifyCache):0;
+	DataSetSeries::StepLoader* stepLoader=0;
+	if(series!=0)
+		{
+		try
+			{
+			stepLoader=loadMeshtalSeries(meshtalFileNames,*series);
+			}
+		catch(...)
+			{
+			delete result;
+			throw;
+			}
+		}
+	else if(cache!=0)
+		{
+		/* Define the result data set's grid layout and use the cached slices directly: */
+		dataSet.setGrid(cache->getNumVertices(),cache->getVertexCoordinates());
+		dataSet.addExternalSlice(cache->getSliceArray(0));
+		dataSet.addExternalSlice(cache->getSliceArray(1));
+		dataSet.adoptSliceStorage(cache);
+		
+		/* Convert the slices to the requested storage format: */
+		dataSet.encodeSlice(0,storageFormat);
+		dataSet.encodeSlice(1,storageFormat);
+		
+		/* Define the result data set's variables as they are selected in 3D Visualizer's menus: */
+		dataValue.initialize(&dataSet); // Initialize the value space for the data set
+		dataValue.setScalarVariableName(0,"Flux"); // Set the name of the first scalar variable
+		dataValue.setScalarVariableName(1,"Relative Error"); // Set the name of the second scalar variable
+		}
+	else
+		loadMeshtalFile(meshtalFileNames[0].c_str(),storageFormat,dataSet,dataValue);
+	
+	/* Rotate the grid to fit in the core correctly: */
+	dataSet.setGridTransformation(DS::GridTransformation::rotate(DS::GridTransformation::Rotation::rotateZ(DS::Scalar(PI/4))));
+	
+	/* Finalize the data set's grid structure (required): */
 	dataSet.finalizeGrid();
 	
+	/* Load the steps around the one being shown in the background, keeping a few of them in memory: */
+	if(series!=0)
+		series->startPrefetching(stepLoader,5,2);
+	
 	/* Return the result data set: */
 	return result;
 	}
 
+/***********************************************************************
+Method to index all tallies and energy bins in an ASCII Mesh Tally file.
+A file containing a single energy bin is read completely, and a binary
+cache file is written for subsequent runs; otherwise, every energy bin
+of every tally defined on the first tally's mesh becomes a pair of flux
+and relative error variables whose values are read when first used.
+***********************************************************************/
+
+void RealMCNP::loadMeshtalFile(const char* meshtalFileName,DS::ValueSlice::Format storageFormat,DS& dataSet,DataValue& dataValue) const
+	{
+	/* Map the Mesh Tally file provided and index all its tallies and energy bins in a single pass: */
+	MCNPResultParser* parser=new MCNPResultParser(meshtalFileName);
+	Misc::Timer indexTimer;
+	MCNPMeshtalIndex index(parser->getFileStart(),parser->getFileEnd());
+	indexTimer.elapse();
+	
+	/* Collect the energy bins of all tallies defined on the same mesh as the first rectangular tally: */
+	std::vector<int> binIndices;
+	bool multipleTallies;
+	int meshTallyIndex=collectMeshBins(index,meshtalFileName,binIndices,multipleTallies);
+	if(meshTallyIndex<0)
+		{
+		delete parser;
+		Misc::throwStdErr("RealMCNP::load: No complete rectangular mesh tally in Mesh Tally file %s",meshtalFileName);
+		}
+	const MCNPMeshtalIndex::Tally& meshTally=index.getTally(meshTallyIndex);
+	std::cout<<"RealMCNP: Indexed "<<index.getNumBins()<<" energy bins in "<<index.getNumTallies()<<" tallies in "<<indexTimer.getTime()*1000.0<<" ms"<<std::endl;
+	
+	/* Define the result data set's grid layout: */
+	DS::Index numVertices=meshTally.getNumVertices(); // One vertex per mesh cell
+	dataSet.setGrid(numVertices); // Set the data set's number of vertices
+	DS::Scalar* const vertexCoordinates[3]={dataSet.getVertexCoordinates(0),dataSet.getVertexCoordinates(1),dataSet.getVertexCoordinates(2)};
+	
+	if(binIndices.size()==1)
+		{
+		const MCNPMeshtalIndex::Bin& bin=index.getBin(binIndices[0]);
+		dataSet.addSlice(); // Add a single scalar variable to the data set's grid
+		dataSet.addSlice(); // Add a single variable to the data set's grid, this call must occur for EACH variable to be stored
+		
+		/* Read all vertex positions, flux, and relative error values in parallel, directly into the data set: */
+		DS::ValueScalar* const slices[2]={dataSet.getSliceArray(0),dataSet.getSliceArray(1)};
+		const int valueColumns[2]={meshTally.resultColumn,meshTally.relativeErrorColumn};
+		Misc::Timer parseTimer;
+		try
+			{
+			parser->parseResultBlock(bin.blockStart,bin.blockEnd,numVertices,meshTally.coordinateColumns,vertexCoordinates,2,valueColumns,slices);
+			}
+		catch(...)
+			{
+			delete parser;
+			throw;
+			}
+		parseTimer.elapse();
+		delete parser;
+		std::cout<<"RealMCNP: Parsed "<<numVertices.calcIncrement(-1)<<" result rows in "<<parseTimer.getTime()*1000.0<<" ms"<<std::endl;
+		
+		/* Resize the vertex coordinates to fit in the core; the rotation is applied by the grid transformation: */
+		for(int axis=0;axis<3;++axis)
+			for(int i=0;i<numVertices[axis];++i)
+				vertexCoordinates[axis][i]=toCoreCoordinate(axis,vertexCoordinates[axis][i]);
+		
+		/* Write a binary cache file to skip parsing on the next run: */
+		if(!MCNPMeshCache::write(meshtalFileName,"RealMCNP",numVertices,vertexCoordinates,2,slices))
+			std::cerr<<"RealMCNP: Unable to write cache file "<<MCNPMeshCache::getCacheFileName(meshtalFileName)<<std::endl;
+		
+		/* Convert the slices to the requested storage format; the cache file always stores native values: */
+		dataSet.encodeSlice(0,storageFormat);
+		dataSet.encodeSlice(1,storageFormat);
+		
+		/* Define the result data set's variables as they are selected in 3D Visualizer's menus: */
+		dataValue.initialize(&dataSet); // Initialize the value space for the data set
+		dataValue.setScalarVariableName(0,"Flux"); // Set the name of the first scalar variable
+		dataValue.setScalarVariableName(1,"Relative Error"); // Set the name of the second scalar variable
+		}
+	else
+		{
+		/* Place the vertices at the mesh cell centers, resized to fit in the core; the rotation is applied by the grid transformation: */
+		for(int axis=0;axis<3;++axis)
+			for(int i=0;i<numVertices[axis];++i)
+				vertexCoordinates[axis][i]=toCoreCoordinate(axis,(meshTally.boundaries[axis][i]+meshTally.boundaries[axis][i+1])*0.5);
+		
+		/* Create a loader that reads each energy bin's values when they are first requested; the data set takes ownership of the loader: */
+		BinLoader* loader=new BinLoader(dataSet,parser,storageFormat);
+		dataSet.adoptSliceStorage(loader);
+		for(std::vector<int>::iterator biIt=binIndices.begin();biIt!=binIndices.end();++biIt)
+			{
+			const MCNPMeshtalIndex::Bin& bin=index.getBin(*biIt);
+			const MCNPMeshtalIndex::Tally& tally=index.getBinTally(*biIt);
+			loader->addSlice(dataSet.addExternalSlice(0),bin.blockStart,bin.blockEnd,tally.resultColumn);
+			loader->addSlice(dataSet.addExternalSlice(0),bin.blockStart,bin.blockEnd,tally.relativeErrorColumn);
+			}
+		
+		/* Define the result data set's variables as they are selected in 3D Visualizer's menus: */
+		dataValue.initialize(&dataSet); // Initialize the value space for the data set
+		int sliceIndex=0;
+		for(std::vector<int>::iterator biIt=binIndices.begin();biIt!=binIndices.end();++biIt,sliceIndex+=2)
+			{
+			dataValue.setScalarVariableName(sliceIndex,makeVariableName(index,*biIt,multipleTallies,"Flux").c_str());
+			dataValue.setScalarVariableName(sliceIndex+1,makeVariableName(index,*biIt,multipleTallies,"Relative Error").c_str());
+			}
+		dataValue.setSliceLoader(loader);
+		}
+	}
+
+/***********************************************************************
+Method to define a series of value steps from a list of ASCII Mesh Tally
+files on the same mesh, such as MCNP runs at different OSCC drum angles.
+The first file defines the grid and variables as in loadMeshtalFile, and
+all energy bins of each file are read when its step is loaded.
+***********************************************************************/
+
+RealMCNP::DataSetSeries::StepLoader* RealMCNP::loadMeshtalSeries(const std::vector<std::string>& meshtalFileNames,RealMCNP::DataSetSeries& series) const
+	{
+	DS& dataSet=series.getDs();
+	DataValue& dataValue=series.getDataValue();
+	
+	/* Index the first Mesh Tally file to define the series' mesh and variables: */
+	MCNPResultParser parser(meshtalFileNames[0].c_str());
+	MCNPMeshtalIndex index(parser.getFileStart(),parser.getFileEnd());
+	std::vector<int> binIndices;
+	bool multipleTallies;
+	int meshTallyIndex=collectMeshBins(index,meshtalFileNames[0].c_str(),binIndices,multipleTallies);
+	if(meshTallyIndex<0)
+		Misc::throwStdErr("RealMCNP::load: No complete rectangular mesh tally in Mesh Tally file %s",meshtalFileNames[0].c_str());
+	const MCNPMeshtalIndex::Tally& meshTally=index.getTally(meshTallyIndex);
+	
+	/* Place the vertices at the mesh cell centers, resized to fit in the core; the rotation is applied by the grid transformation: */
+	DS::Index numVertices=meshTally.getNumVertices();
+	dataSet.setGrid(numVertices);
+	for(int axis=0;axis<3;++axis)
+		{
+		DS::Scalar* vertexCoordinates=dataSet.getVertexCoordinates(axis);
+		for(int i=0;i<numVertices[axis];++i)
+			vertexCoordinates[i]=toCoreCoordinate(axis,(meshTally.boundaries[axis][i]+meshTally.boundaries[axis][i+1])*0.5);
+		}
+	
+	/* Define the series' variables; the values of the current step are copied into the data set's own slices: */
+	for(size_t i=0;i<binIndices.size()*2;++i)
+		dataSet.addSlice();
+	dataValue.initialize(&dataSet);
+	int sliceIndex=0;
+	for(std::vector<int>::iterator biIt=binIndices.begin();biIt!=binIndices.end();++biIt,sliceIndex+=2)
+		{
+		dataValue.setScalarVariableName(sliceIndex,makeVariableName(index,*biIt,multipleTallies,"Flux").c_str());
+		dataValue.setScalarVariableName(sliceIndex+1,makeVariableName(index,*biIt,multipleTallies,"Relative Error").c_str());
+		}
+	
+	/* Name the steps after their Mesh Tally files: */
+	for(std::vector<std::string>::const_iterator mfnIt=meshtalFileNames.begin();mfnIt!=meshtalFileNames.end();++mfnIt)
+		{
+		std::string::size_type slashPos=mfnIt->rfind('/');
+		series.addStep(slashPos!=std::string::npos?mfnIt->c_str()+slashPos+1:mfnIt->c_str());
+		}
+	
+	/* Read the first step right away: */
+	StepFileLoader* loader=new StepFileLoader(meshtalFileNames,numVertices,binIndices.size());
+	std::vector<DS::ValueScalar*> slices;
+	for(int i=0;i<dataSet.getNumSlices();++i)
+		slices.push_back(dataSet.getSliceArray(i));
+	Misc::Timer parseTimer;
+	try
+		{
+		loader->loadStep(0,&slices[0]);
+		}
+	catch(...)
+		{
+		delete loader;
+		throw;
+		}
+	parseTimer.elapse();
+	std::cout<<"RealMCNP: Read first of "<<meshtalFileNames.size()<<" Mesh Tally files in "<<parseTimer.getTime()*1000.0<<" ms"<<std::endl;
+	
+	return loader;
+	}
+
 }
 
 }
@@ -17,8 +17,9 @@ Header files defining basic grid data structures and matching
 visualization algorithms:
 ***********************************************************************/
 
-#include <Wrappers/SlicedCurvilinearIncludes.h>
+#include <Wrappers/SlicedRectilinearIncludes.h>
 #include <Wrappers/SlicedScalarVectorDataValue.h>
+#include <Wrappers/DataSetSeries.h>
 
 #include <Wrappers/Module.h>
 
@@ -32,15 +33,15 @@ namespace {
 Basic type declarations, can be adapted according to requirements:
 ***********************************************************************/
 
-typedef float Scalar; // Data set uses 32-bit floats to store vertex positions
-typedef float VScalar; // Data set uses 32-bit floats to store vertex values
+typedef float Scalar; // Data set uses 32-bit floats to store vertex positions; must match the binary cache file format
+typedef float VScalar; // Data set uses 32-bit floats to store vertex values; must match the binary cache file format
 
 /***********************************************************************
 The following type declarations define how data is represented
 internally, and do not have to be changed:
 ***********************************************************************/
 
-typedef Visualization::Templatized::SlicedCurvilinear<Scalar,3,VScalar> DS; // Templatized data set type
+typedef Visualization::Templatized::SlicedRectilinear<Scalar,3,VScalar> DS; // Templatized data set type
 typedef Visualization::Wrappers::SlicedScalarVectorDataValue<DS,VScalar> DataValue; // Type of data value descriptor
 typedef Visualization::Wrappers::Module<DS,DataValue> BaseModule; // Module base class type
 
@@ -52,6 +53,15 @@ Declaration of the module class:
 
 class RealMCNP:public BaseModule
 	{
+	/* Embedded classes: */
+	public:
+	typedef Visualization::Wrappers::DataSetSeries<DS,VScalar,DataValue> DataSetSeries; // Data set class for series of Mesh Tally files, such as OSCC drum angle sweeps
+	
+	/* Private methods: */
+	private:
+	void loadMeshtalFile(const char* meshtalFileName,DS::ValueSlice::Format storageFormat,DS& dataSet,DataValue& dataValue) const; // Indexes an ASCII Mesh Tally file and defines the given data set's grid and variables; reads values now or on demand, and stores them in the given format
+	DataSetSeries::StepLoader* loadMeshtalSeries(const std::vector<std::string>& meshtalFileNames,DataSetSeries& series) const; // Defines the given series' grid, variables, and steps from a list of ASCII Mesh Tally files on the same mesh, and reads the first file; returns a loader for the other files
+	
 	/* Constructors and destructors: */
 	public:
 	RealMCNP(void); // Default constructor
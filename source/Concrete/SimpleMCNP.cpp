@@ -16,9 +16,15 @@ The ExampleModule is free software under the GNU General Public License.
 ***********************************************************************/
 #include <math.h>
 #include <stdio.h>
+#include <strings.h>
+#include <iostream>
 #include <Plugins/FactoryManager.h>
 
 #include <Concrete/SimpleMCNP.h>
+#include <Misc/ThrowStdErr.h>
+#include <Misc/Timer.h>
+#include <Concrete/MCNPMeshCache.h>
+#include <Concrete/MCNPResultParser.h>
 #define PI 3.1415926535897932384626
 namespace Visualization {
 
@@ -48,20 +54,26 @@ class and has to be written.
 	{
 	/* Create the result data set: */
 	DataSet* result=new DataSet;
+	DS& dataSet=result->getDs(); // Get the internal data representation from the result data set
 	
-	/* Open the input file: */
-	FILE* file=fopen(args[0].c_str(),"rt"); // args[0] is the first module command line parameter
-	
-	int status;
-	/* Read the input file's header: */
-	DS::Index numVertices; // DS::Index is a helper type containing three integers NI, NJ, NK
-	status = fscanf(file,"%d %d %d",&numVertices[0],&numVertices[1],&numVertices[2]);
+	/* Check for the option to verify the binary cache file's data against its checksum: */
+	bool verifyCache=false;
+	for(size_t i=1;i<args.size();++i)
+		if(strcasecmp(args[i].c_str(),"-verifyCache")==0)
+			verifyCache=true;
 	
-	/* Define the result data set's grid layout: */
-	DS& dataSet=result->getDs(); // Get the internal data representation from the result data set
-	dataSet.setGrid(numVertices); // Set the data set's number of vertices
-	dataSet.addSlice(); // Add a single scalar variable to the data set's grid, need as many calls as variables
-	dataSet.addSlice(); // Add a single scalar variable to the data set's grid
+	/* Map the binary cache file written by an earlier run, if it is still up to date: */
+	MCNPMeshCache* cache=MCNPMeshCache::open(args[0].c_str(),"SimpleMCNP",2,verifyCache); // args[0] is the first module command line parameter
+	if(cache!=0)
+		{
+		/* Define the result data set's grid layout and use the cached slices directly: */
+		dataSet.setGrid(cache->getNumVertices(),cache->getVertexCoordinates());
+		dataSet.addExternalSlice(cache->getSliceArray(0));
+		dataSet.addExternalSlice(cache->getSliceArray(1));
+		dataSet.adoptSliceStorage(cache);
+		}
+	else
+		loadDataFile(args[0].c_str(),dataSet);
 	
 	/* Define the result data set's variables as they are selected in 3D Visualizer's menus: */
 	DataValue& dataValue=result->getDataValue(); // Get the internal representations of the data set's value space
@@ -69,29 +81,8 @@ class and has to be written.
 	dataValue.setScalarVariableName(0,"Flux"); // Set the name of the first scalar variable
 	dataValue.setScalarVariableName(1,"Relative Error"); // Set the name of the first scalar variable,
 	
-	/* Read all vertex positions and temperature values: */
-	DS::Index index; // Index counting variable containing three integers I, J, K
-	for(index[0]=0;index[0]<numVertices[0];++index[0]) // I varies most slowly
-		for(index[1]=0;index[1]<numVertices[1];++index[1])
-			for(index[2]=0;index[2]<numVertices[2];++index[2]) // K varies fastest
-				{
-				/* Read the vertex position and flux and relative error values: */
-				  double pos[3],flux, relative_err;
-				  status = fscanf(file,"%lf %lf %lf %lf %lf",&pos[0],&pos[1],&pos[2],&flux, &relative_err);
-			        /*Rotating and resizing the data to fit correctly in the core*/
-				  double temp_x= pos[0];
-				  pos[0]= ((pos[0]*cos(PI/4)) - (pos[1]*sin(PI/4)))*0.01;
-				  pos[1]= ((temp_x*sin(PI/4)) + (pos[1]*cos(PI/4)))*0.01;
-				  pos[2]= (pos[2])*0.01;
-
-				/* Store the position and value in the data set: */
-				dataSet.getVertexPosition(index)=DS::Point(pos); // Store the vertex' position
-				dataSet.getVertexValue(0,index)=DS::ValueScalar(flux); // Store the vertex' flux
-				dataSet.getVertexValue(1,index)=DS::ValueScalar(relative_err); // Store the vertex' relative error
-				}
-	
-	/* Close the input file: */
-	fclose(file);
+	/* Rotate the grid to fit correctly in the core: */
+	dataSet.setGridTransformation(DS::GridTransformation::rotate(DS::GridTransformation::Rotation::rotateZ(DS::Scalar(PI/4))));
 	
 	/* Finalize the data set's grid structure (required): */
 	dataSet.finalizeGrid();
@@ -100,6 +91,52 @@ class and has to be written.
 	return result;
 	}
 
+/***********************************************************************
+Method to read the grid and all values from an ASCII data file, and to
+write a binary cache file for subsequent runs.
+***********************************************************************/
+
+void SimpleMCNP::loadDataFile(const char* dataFileName,DS& dataSet) const
+	{
+	/* Map the input file: */
+	MCNPResultParser parser(dataFileName);
+	const char* fileEnd=parser.getFileEnd();
+	
+	/* Read the input file's header: */
+	DS::Index numVertices; // DS::Index is a helper type containing three integers NI, NJ, NK
+	const char* headerPtr=parser.getFileStart();
+	const char* dataStart=MCNPResultParser::getNextLine(headerPtr,fileEnd);
+	for(int i=0;i<3;++i)
+		{
+		double numAxisVertices;
+		if(!MCNPResultParser::parseNumber(headerPtr,dataStart,numAxisVertices)||numAxisVertices<2.0)
+			Misc::throwStdErr("SimpleMCNP::load: Wrong format in header of input file %s",dataFileName);
+		numVertices[i]=int(numAxisVertices);
+		}
+	
+	/* Define the result data set's grid layout: */
+	dataSet.setGrid(numVertices); // Set the data set's number of vertices
+	dataSet.addSlice(); // Add a single scalar variable to the data set's grid, need as many calls as variables
+	dataSet.addSlice(); // Add a single scalar variable to the data set's grid
+	
+	/* Read all vertex positions and flux and relative error values in parallel, directly into the data set: */
+	DS::Scalar* const vertexCoordinates[3]={dataSet.getVertexCoordinates(0),dataSet.getVertexCoordinates(1),dataSet.getVertexCoordinates(2)};
+	DS::ValueScalar* const slices[2]={dataSet.getSliceArray(0),dataSet.getSliceArray(1)};
+	Misc::Timer parseTimer;
+	parser.parseResultBlock(dataStart,numVertices,2,vertexCoordinates,slices);
+	parseTimer.elapse();
+	std::cout<<"SimpleMCNP: Parsed "<<numVertices.calcIncrement(-1)<<" data rows in "<<parseTimer.getTime()*1000.0<<" ms"<<std::endl;
+	
+	/* Resize the vertex coordinates to fit correctly in the core; the rotation is applied by the grid transformation: */
+	for(int axis=0;axis<3;++axis)
+		for(int i=0;i<numVertices[axis];++i)
+			vertexCoordinates[axis][i]=DS::Scalar(double(vertexCoordinates[axis][i])*0.01);
+	
+	/* Write a binary cache file to skip parsing on the next run: */
+	if(!MCNPMeshCache::write(dataFileName,"SimpleMCNP",numVertices,vertexCoordinates,2,slices))
+		std::cerr<<"SimpleMCNP: Unable to write cache file "<<MCNPMeshCache::getCacheFileName(dataFileName)<<std::endl;
+	}
+
 }
 
 }
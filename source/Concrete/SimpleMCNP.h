@@ -29,7 +29,7 @@ Header files defining basic grid data structures and matching
 visualization algorithms:
 ***********************************************************************/
 
-#include <Wrappers/SlicedCurvilinearIncludes.h>
+#include <Wrappers/SlicedRectilinearIncludes.h>
 #include <Wrappers/SlicedScalarVectorDataValue.h>
 
 #include <Wrappers/Module.h>
@@ -44,15 +44,15 @@ namespace {
 Basic type declarations, can be adapted according to requirements:
 ***********************************************************************/
 
-typedef float Scalar; // Data set uses 32-bit floats to store vertex positions
-typedef float VScalar; // Data set uses 32-bit floats to store vertex values
+typedef float Scalar; // Data set uses 32-bit floats to store vertex positions; must match the binary cache file format
+typedef float VScalar; // Data set uses 32-bit floats to store vertex values; must match the binary cache file format
 
 /***********************************************************************
 The following type declarations define how data is represented
 internally, and do not have to be changed:
 ***********************************************************************/
 
-typedef Visualization::Templatized::SlicedCurvilinear<Scalar,3,VScalar> DS; // Templatized data set type
+typedef Visualization::Templatized::SlicedRectilinear<Scalar,3,VScalar> DS; // Templatized data set type
 typedef Visualization::Wrappers::SlicedScalarVectorDataValue<DS,VScalar> DataValue; // Type of data value descriptor
 typedef Visualization::Wrappers::Module<DS,DataValue> BaseModule; // Module base class type
 
@@ -64,6 +64,10 @@ Declaration of the module class:
 
 class SimpleMCNP:public BaseModule
 	{
+	/* Private methods: */
+	private:
+	void loadDataFile(const char* dataFileName,DS& dataSet) const; // Reads the grid and values from an ASCII data file into the given data set, and writes a binary cache file
+	
 	/* Constructors and destructors: */
 	public:
 	SimpleMCNP(void); // Default constructor
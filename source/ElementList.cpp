@@ -219,6 +219,29 @@ void ElementList::addElement(Element* newElement,const char* elementName)
 	showElementSettingsToggle->setToggle(false);
 	}
 
+bool ElementList::replaceElement(const Element* oldElement,Element* newElement)
+	{
+	/* Find the old element's list entry: */
+	ListElementList::iterator veIt;
+	for(veIt=elements.begin();veIt!=elements.end()&&veIt->element.getPointer()!=oldElement;++veIt)
+		;
+	if(veIt==elements.end())
+		return false;
+	
+	/* Replace the element and its settings dialog: */
+	if(veIt->settingsDialogVisible)
+		widgetManager->popdownWidget(veIt->settingsDialog);
+	delete veIt->settingsDialog;
+	veIt->element=newElement;
+	veIt->settingsDialog=newElement->createSettingsDialog(widgetManager);
+	veIt->settingsDialogVisible=false;
+	
+	/* Update the toggle buttons: */
+	updateUiState();
+	
+	return true;
+	}
+
 void ElementList::saveElements(const char* elementFileName,bool ascii,const Visualization::Abstract::VariableManager* variableManager) const
 	{
 	if(ascii)
@@ -92,6 +92,19 @@ class ElementList
 	/* Methods: */
 	void clear(void); // Deletes all elements from the list
 	void addElement(Element* newElement,const char* elementName); // Adds a new visualization element to the list
+	int getNumElements(void) const // Returns the number of elements in the list
+		{
+		return int(elements.size());
+		}
+	ElementPointer getElement(int elementIndex) const // Returns an element from the list
+		{
+		return elements[elementIndex].element;
+		}
+	const char* getElementName(int elementIndex) const // Returns the name of the algorithm used to create an element
+		{
+		return elements[elementIndex].name.c_str();
+		}
+	bool replaceElement(const Element* oldElement,Element* newElement); // Replaces an element with a re-extracted one, keeping its list entry and visibility; returns false if the old element is no longer in the list
 	void saveElements(const char* elementFileName,bool ascii,const Visualization::Abstract::VariableManager* variableManager) const; // Saves all visible visualization elements to the given file
 	void showElementList(const GLMotif::WidgetManager::Transformation& transformation); // Shows the element list dialog
 	void hideElementList(void); // Hides the element list dialog
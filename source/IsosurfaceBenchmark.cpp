@@ -0,0 +1,212 @@
+/*
+ * Description: IsosurfaceBenchmark.cpp - Measures how global isosurface
+ * extraction from a large Cartesian and a large curvilinear grid scales with
+ * the number of extraction threads, how much a cell block index saves, and
+ * how much extracting several isosurfaces in one pass saves, without
+ * opening a window
+ * Author: Patrick O'Leary
+ * Date: May 11, 2010
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <iostream>
+#include <vector>
+
+#include <Misc/Timer.h>
+#define NONSTANDARD_GLVERTEX_TEMPLATES
+#include <GL/GLVertex.h>
+
+#include <Templatized/Cartesian.h>
+#include <Templatized/Curvilinear.h>
+#include <Templatized/ScalarExtractor.h>
+#include <Templatized/IndexedTriangleSet.h>
+#include <Templatized/IsosurfaceExtractorIndexedTriangleSet.h>
+#include <Templatized/MultiIsosurfaceExtractor.h>
+
+typedef Visualization::Templatized::Cartesian<float, 3, float> CartesianDS;
+typedef Visualization::Templatized::Curvilinear<float, 3, float> CurvilinearDS;
+typedef Visualization::Templatized::ScalarExtractor<float, float> SE;
+typedef GLVertex<void, 0, void, 0, float, float, 3> Vertex;
+typedef Visualization::Templatized::IndexedTriangleSet<Vertex> Surface;
+
+/*
+ * calcValue - Returns the value of the benchmark's scalar field, a set of
+ * nested wavy shells, at the given position in the unit cube.
+ *
+ * parameter u - double
+ * parameter v - double
+ * parameter w - double
+ * return - float
+ */
+static float calcValue(double u, double v, double w) {
+	double r = sqrt((u - 0.5) * (u - 0.5) + (v - 0.5) * (v - 0.5) + (w - 0.5)
+			* (w - 0.5));
+	return float(sin(20.0 * r) + 0.25 * sin(13.0 * u) * cos(11.0 * v));
+} // end calcValue()
+
+/*
+ * benchmark - Extracts the isosurface for the value zero with 1, 2, 4, ...
+ * threads up to the given maximum and reports the extraction times, then
+ * repeats the extraction with all threads using a cell block index, and
+ * compares extracting five nested isosurfaces one after the other with
+ * extracting them in a single pass.
+ *
+ * parameter name - const char *
+ * parameter ds - const DSParam &
+ * parameter maxNumThreads - int
+ */
+template<class DSParam>
+static void benchmark(const char * name, const DSParam & ds, int maxNumThreads) {
+	typedef Visualization::Templatized::IsosurfaceExtractor<DSParam, SE,
+			Surface> ISE;
+	typedef Visualization::Templatized::MultiIsosurfaceExtractor<DSParam, SE,
+			Vertex> MISE;
+
+	std::cout << name << ":" << std::endl;
+	ISE ise(&ds, SE());
+	ise.setExtractionMode(ISE::SMOOTH);
+	double singleThreadTime = 0.0;
+	for (int numThreads = 1;; numThreads *= 2) {
+		if (numThreads > maxNumThreads) {
+			numThreads = maxNumThreads;
+		}
+		ise.setNumThreads(numThreads);
+		Surface surface(0);
+		Misc::Timer timer;
+		ise.extractIsosurface(0.0f, surface);
+		timer.elapse();
+		if (numThreads == 1) {
+			singleThreadTime = timer.getTime();
+		}
+		std::cout << "  " << numThreads << " threads: " << timer.getTime()
+				* 1000.0 << " ms, " << surface.getNumTriangles()
+				<< " triangles, speed-up " << singleThreadTime
+				/ timer.getTime() << std::endl;
+		if (numThreads == maxNumThreads) {
+			break;
+		}
+	}
+
+	/* Build a cell block index and extract the isosurface again: */
+	Misc::Timer indexTimer;
+	typename ISE::BlockIndex blockIndex;
+	blockIndex.build(ds, SE(), ISE::cellBlockSize);
+	indexTimer.elapse();
+	std::cout << "  Time to build cell block index: " << indexTimer.getTime()
+			* 1000.0 << " ms" << std::endl;
+	ise.setBlockIndex(&blockIndex);
+	Surface surface(0);
+	Misc::Timer timer;
+	ise.extractIsosurface(0.0f, surface);
+	timer.elapse();
+	std::cout << "  " << maxNumThreads << " threads with index: "
+			<< timer.getTime() * 1000.0 << " ms, "
+			<< surface.getNumTriangles() << " triangles, speed-up "
+			<< singleThreadTime / timer.getTime() << std::endl;
+	ise.setBlockIndex(0);
+
+	/* Extract five nested isosurfaces one after the other: */
+	std::vector<float> isovalues;
+	for (int i = 0; i < 5; ++i) {
+		isovalues.push_back(-0.8f + 0.4f * float(i));
+	}
+	Misc::Timer separateTimer;
+	size_t numSeparateTriangles = 0;
+	for (size_t i = 0; i < isovalues.size(); ++i) {
+		Surface levelSurface(0);
+		ise.extractIsosurface(isovalues[i], levelSurface);
+		numSeparateTriangles += levelSurface.getNumTriangles();
+	}
+	separateTimer.elapse();
+	std::cout << "  " << isovalues.size() << " isosurfaces separately: "
+			<< separateTimer.getTime() * 1000.0 << " ms, "
+			<< numSeparateTriangles << " triangles" << std::endl;
+
+	/* Extract the same isosurfaces in a single pass: */
+	MISE mise(&ds, SE());
+	mise.setExtractionMode(MISE::SMOOTH);
+	mise.setNumThreads(maxNumThreads);
+	std::vector<Surface*> levelSurfaces;
+	for (size_t i = 0; i < isovalues.size(); ++i) {
+		levelSurfaces.push_back(new Surface(0));
+	}
+	Misc::Timer multiTimer;
+	mise.extractIsosurfaces(isovalues, levelSurfaces);
+	multiTimer.elapse();
+	size_t numMultiTriangles = 0;
+	for (size_t i = 0; i < levelSurfaces.size(); ++i) {
+		numMultiTriangles += levelSurfaces[i]->getNumTriangles();
+		delete levelSurfaces[i];
+	}
+	std::cout << "  " << isovalues.size() << " isosurfaces in one pass: "
+			<< multiTimer.getTime() * 1000.0 << " ms, " << numMultiTriangles
+			<< " triangles, speed-up " << separateTimer.getTime()
+			/ multiTimer.getTime() << std::endl;
+} // end benchmark()
+
+/*
+ * main
+ *
+ * parameter argc - int
+ * parameter argv - char**
+ * return - int
+ */
+int main(int argc, char** argv) {
+	/* Parse the command line: */
+	int cartesianSize = 256;
+	int curvilinearSize = 160;
+	long numCpus = sysconf(_SC_NPROCESSORS_ONLN);
+	int maxNumThreads = numCpus < 1 ? 1 : int(numCpus);
+	for (int i = 1; i < argc; ++i) {
+		if (strcasecmp(argv[i], "-cartesianSize") == 0 && i + 1 < argc) {
+			cartesianSize = atoi(argv[++i]);
+		} else if (strcasecmp(argv[i], "-curvilinearSize") == 0 && i + 1
+				< argc) {
+			curvilinearSize = atoi(argv[++i]);
+		} else if (strcasecmp(argv[i], "-threads") == 0 && i + 1 < argc) {
+			maxNumThreads = atoi(argv[++i]);
+		}
+	}
+
+	/* Create a Cartesian grid in the unit cube: */
+	CartesianDS cartesian;
+	float cellSize = 1.0f / float(cartesianSize - 1);
+	cartesian.setData(CartesianDS::Index(cartesianSize, cartesianSize,
+			cartesianSize), CartesianDS::Size(cellSize, cellSize, cellSize));
+	for (int x = 0; x < cartesianSize; ++x) {
+		for (int y = 0; y < cartesianSize; ++y) {
+			for (int z = 0; z < cartesianSize; ++z) {
+				cartesian.getVertexValue(CartesianDS::Index(x, y, z))
+						= calcValue(double(x) * cellSize, double(y) * cellSize,
+								double(z) * cellSize);
+			}
+		}
+	}
+	benchmark("Cartesian", cartesian, maxNumThreads);
+
+	/* Create a curvilinear grid by warping the unit cube: */
+	CurvilinearDS curvilinear;
+	curvilinear.setData(CurvilinearDS::Index(curvilinearSize, curvilinearSize,
+			curvilinearSize));
+	for (int x = 0; x < curvilinearSize; ++x) {
+		for (int y = 0; y < curvilinearSize; ++y) {
+			for (int z = 0; z < curvilinearSize; ++z) {
+				double u = double(x) / double(curvilinearSize - 1);
+				double v = double(y) / double(curvilinearSize - 1);
+				double w = double(z) / double(curvilinearSize - 1);
+				CurvilinearDS::Index index(x, y, z);
+				curvilinear.getVertexPosition(index) = CurvilinearDS::Point(
+						float(u + 0.1 * sin(3.0 * v)), float(v + 0.1 * sin(3.0
+								* w)), float(w + 0.1 * sin(3.0 * u)));
+				curvilinear.getVertexValue(index) = calcValue(u, v, w);
+			}
+		}
+	}
+	curvilinear.finalizeGrid();
+	benchmark("Curvilinear", curvilinear, maxNumThreads);
+
+	return 0;
+} // end main()
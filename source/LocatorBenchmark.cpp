@@ -0,0 +1,125 @@
+/*
+ * Description: LocatorBenchmark.cpp - Compares the throughput of locating
+ * random points in a curvilinear grid when point location starts from the
+ * cell center kd-tree and from the cell bucket grid, without opening a
+ * window
+ * Author: Patrick O'Leary
+ * Date: May 11, 2010
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <iostream>
+#include <vector>
+
+#include <Misc/Timer.h>
+
+#include <Templatized/Curvilinear.h>
+
+typedef Visualization::Templatized::Curvilinear<float, 3, float> DS;
+
+/*
+ * locatePoints - Locates all points without tracing and returns the number
+ * of points found inside the grid.
+ *
+ * parameter ds - const DS &
+ * parameter points - const std::vector<DS::Point> &
+ * parameter seconds - double &
+ * return - size_t
+ */
+static size_t locatePoints(const DS & ds, const std::vector<DS::Point> & points,
+		double & seconds) {
+	DS::Locator locator = ds.getLocator();
+	size_t numFound = 0;
+	Misc::Timer t;
+	for (size_t i = 0; i < points.size(); ++i) {
+		if (locator.locatePoint(points[i], false)) {
+			++numFound;
+		}
+	}
+	t.elapse();
+	seconds = t.getTime();
+	return numFound;
+} // end locatePoints()
+
+/*
+ * main
+ *
+ * parameter argc - int
+ * parameter argv - char**
+ * return - int
+ */
+int main(int argc, char** argv) {
+	/* Parse the command line: */
+	int gridSize = 64;
+	size_t numPoints = 1000000;
+	for (int i = 1; i < argc; ++i) {
+		if (strcasecmp(argv[i], "-gridSize") == 0 && i + 1 < argc) {
+			gridSize = atoi(argv[++i]);
+		} else if (strcasecmp(argv[i], "-numPoints") == 0 && i + 1 < argc) {
+			numPoints = size_t(atol(argv[++i]));
+		}
+	}
+
+	/* Create a curvilinear grid shaped like a bent, twisted half-shell: */
+	DS ds;
+	ds.setData(DS::Index(gridSize, gridSize, gridSize));
+	for (int x = 0; x < gridSize; ++x) {
+		for (int y = 0; y < gridSize; ++y) {
+			for (int z = 0; z < gridSize; ++z) {
+				double u = double(x) / double(gridSize - 1);
+				double v = double(y) / double(gridSize - 1);
+				double w = double(z) / double(gridSize - 1);
+				double radius = 1.0 + u + 0.1 * sin(6.0 * w);
+				double angle = M_PI * v + 0.5 * w;
+				ds.getVertexPosition(DS::Index(x, y, z)) = DS::Point(float(radius
+						* cos(angle)), float(radius * sin(angle)), float(2.0 * w));
+				ds.getVertexValue(DS::Index(x, y, z)) = float(u);
+			}
+		}
+	}
+
+	/* Finalize the grid with the cell center kd-tree only: */
+	ds.setUseCellBuckets(false);
+	Misc::Timer kdTreeTimer;
+	ds.finalizeGrid();
+	kdTreeTimer.elapse();
+	std::cout << "Time to build cell center kd-tree: " << kdTreeTimer.getTime()
+			* 1000.0 << " ms" << std::endl;
+
+	/* Create random points in the grid's bounding box: */
+	const DS::Box & domainBox = ds.getDomainBox();
+	std::vector<DS::Point> points(numPoints);
+	srand48(1);
+	for (std::vector<DS::Point>::iterator pIt = points.begin(); pIt
+			!= points.end(); ++pIt) {
+		for (int i = 0; i < 3; ++i) {
+			(*pIt)[i] = domainBox.min[i] + float(drand48()) * (domainBox.max[i]
+					- domainBox.min[i]);
+		}
+	}
+
+	/* Locate the points starting from the kd-tree: */
+	double kdTreeSeconds;
+	size_t kdTreeFound = locatePoints(ds, points, kdTreeSeconds);
+	std::cout << "Kd-tree: " << kdTreeFound << " of " << numPoints
+			<< " points inside, " << double(numPoints) / kdTreeSeconds
+			<< " points/s" << std::endl;
+
+	/* Locate the points starting from the cell bucket grid: */
+	ds.setUseCellBuckets(true);
+	Misc::Timer bucketTimer;
+	ds.finalizeGrid();
+	bucketTimer.elapse();
+	std::cout << "Time to build cell center kd-tree and cell bucket grid: "
+			<< bucketTimer.getTime() * 1000.0 << " ms" << std::endl;
+	double bucketSeconds;
+	size_t bucketFound = locatePoints(ds, points, bucketSeconds);
+	std::cout << "Cell buckets: " << bucketFound << " of " << numPoints
+			<< " points inside, " << double(numPoints) / bucketSeconds
+			<< " points/s" << std::endl;
+	std::cout << "Speed-up: " << kdTreeSeconds / bucketSeconds << std::endl;
+
+	return 0;
+} // end main()
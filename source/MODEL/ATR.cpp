@@ -8,11 +8,10 @@
  */
 
 /* System headers */
+#include <string.h>
+#include <math.h>
 #include <iostream>
 
-/* Application headers */
-#include <SYNC/Guard.h>
-
 /* Delta3D headers */
 #include <dtCore/camera.h>
 #include <dtCore/infinitelight.h>
@@ -22,7 +21,13 @@
 #include <dtCore/environment.h>
 
 /* OSG headers */
+#include <osg/ComputeBoundsVisitor>
 #include <osg/DisplaySettings>
+#include <osg/Geode>
+#include <osg/Math>
+#include <osg/NodeVisitor>
+#include <osg/PolygonMode>
+#include <osg/ShapeDrawable>
 #include <osgDB/FileUtils>
 
 /* ODE headers */
@@ -32,11 +37,61 @@
 #include <Vrui/Vrui.h>
 
 #include "ATR.h"
+#include "SceneCache.h"
 
 static bool dophysics = false;
 static double lastTime = 0.0f;
 static double *simulationTime;
 
+/* Upper bound for the total file size of models kept loaded while hidden */
+static const size_t maxResidentModelBytes = 8 * 1024 * 1024;
+
+/* Model of the reactor core with all OSCC drums at zero rotation */
+static const char * osccModelFileName =
+		"models/zw/OSCC/OSCC_NW0_NE0_SE0_SW0.osg";
+
+/* Name prefix of the drum instances inside the OSCC model */
+static const char * osccDrumNamePrefix = "Individual Cylinder Assembly";
+
+/* Drum angles in degrees of the preset OSCC configurations, in NW, NE, SE, SW order */
+static const double osccConfigurationAngles[ATR::NUM_OSCC_CONFIGURATIONS][ATR::NUM_OSCC_QUADRANTS] = {
+		{ 5.0, 5.0, 5.0, 5.0 },
+		{ 51.8, 51.8, 51.8, 51.8 },
+		{ 85.0, 85.0, 85.0, 85.0 },
+		{ 120.0, 120.0, 120.0, 120.0 },
+		{ 155.0, 155.0, 155.0, 155.0 },
+		{ 30.0, 85.0, 85.0, 85.0 },
+		{ 40.0, 85.0, 85.0, 85.0 },
+		{ 50.0, 85.0, 85.0, 85.0 },
+		{ 60.0, 85.0, 85.0, 85.0 },
+		{ 70.0, 85.0, 85.0, 85.0 },
+		{ 80.0, 85.0, 85.0, 85.0 },
+		{ 90.0, 85.0, 85.0, 85.0 },
+		{ 100.0, 85.0, 85.0, 85.0 },
+		{ 110.0, 85.0, 85.0, 85.0 },
+		{ 120.0, 85.0, 85.0, 85.0 } };
+
+/*
+ * OSCCDrumFinder - Node visitor collecting the transformations of all drum
+ * instances in the OSCC model.
+ */
+class OSCCDrumFinder: public osg::NodeVisitor {
+public:
+	OSCCDrumFinder(void) :
+		osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN) {
+	}
+	virtual void apply(osg::MatrixTransform & node) {
+		if (node.getName().compare(0, strlen(osccDrumNamePrefix),
+				osccDrumNamePrefix) == 0) {
+			drums.push_back(&node);
+		} else {
+			traverse(node);
+		}
+	}
+
+	std::vector<osg::MatrixTransform *> drums;
+};
+
 using namespace std;
 using namespace dtCore;
 using namespace dtABC;
@@ -61,7 +116,8 @@ ATR::DataItem::~DataItem(void) {
  * ATR constructor
  */
 ATR::ATR(void) :
-	Application(true), drawMode(true), frameNumber(0) {
+	Application(true), drawMode(true), frameNumber(0), osccLoaded(false),
+			osccConfiguration(-1), modelLoader(0) {
 
 	atr = this;
 
@@ -78,6 +134,7 @@ ATR::ATR(void) :
 } // end ATR()
 
 ATR::~ATR(void) {
+	delete modelLoader;
 }
 
 /*******************************
@@ -97,28 +154,9 @@ void ATR::addObjects(void) {
 	GetScene()->AddDrawable(globalInfinite.get());
 	globalInfinite->SetEnabled(true);
 
-	/* 
-	 * oscc_#: # represents angle at which cylinders are rotated 
-	 * from 0 degrees. One number means all cylinders are at same 
-	 * rotation; multiple numbers mean NW quadrant, then NE 
-	 * quadrant, then SE quadrant, then SW quadrant (NOTE: 
-	 * decimals are represented by underscores. EX 51.8 = 51_8). 
-	 */
-	GetScene()->AddDrawable(oscc_5.get());
-	GetScene()->AddDrawable(oscc_51_8.get());
-	GetScene()->AddDrawable(oscc_85.get());
-	GetScene()->AddDrawable(oscc_120.get());
-	GetScene()->AddDrawable(oscc_155.get());
-	GetScene()->AddDrawable(oscc_30_85_85_85.get());
-	GetScene()->AddDrawable(oscc_40_85_85_85.get());
-	GetScene()->AddDrawable(oscc_50_85_85_85.get());
-	GetScene()->AddDrawable(oscc_60_85_85_85.get());
-	GetScene()->AddDrawable(oscc_70_85_85_85.get());
-	GetScene()->AddDrawable(oscc_80_85_85_85.get());
-	GetScene()->AddDrawable(oscc_90_85_85_85.get());
-	GetScene()->AddDrawable(oscc_100_85_85_85.get());
-	GetScene()->AddDrawable(oscc_110_85_85_85.get());
-	GetScene()->AddDrawable(oscc_120_85_85_85.get());
+	/* The drums start out hidden and are loaded when first shown */
+	GetScene()->AddDrawable(oscc.get());
+	oscc->DeltaDrawable::SetActive(false);
 } // end addObjects()
 
 /*
@@ -146,87 +184,27 @@ void ATR::createUser(dMass & mass) {
 
 void ATR::createVessel(void) {
 	vessel = new Object("Vessel");
-	vessel->LoadFile("models/SReactor_Vessel.osg");
+	vessel->LoadFile(SceneCache::getModelFileName("models/SReactor_Vessel.osg"));
 }
 
 void ATR::createClear_Vessel(void) {
 	clear_vessel = new Object("Clear_Vessel");
-	clear_vessel->LoadFile("models/zw/Clear_Vessel.osg");
+	clear_vessel->LoadFile(SceneCache::getModelFileName(
+			"models/zw/Clear_Vessel.osg"));
 }
 
-void ATR::createOSCC_5(void) {
-	oscc_5 = new Object("OSCC_5");
-	oscc_5->LoadFile("models/zw/OSCC/OSCC_NW5_NE5_SE5_SW5.osg");
-}
-
-void ATR::createOSCC_51_8(void) {
-	oscc_51_8 = new Object("OSCC_51_8");
-	oscc_51_8->LoadFile("models/zw/OSCC/OSCC_NW51_8_NE51_8_SE51_8_SW51_8.osg");
-}
-
-void ATR::createOSCC_85(void) {
-	oscc_85 = new Object("OSCC_85");
-	oscc_85->LoadFile("models/zw/OSCC/OSCC_NW85_NE85_SE85_SW85.osg");
-}
-
-void ATR::createOSCC_120(void) {
-	oscc_120 = new Object("OSCC_120");
-	oscc_120->LoadFile("models/zw/OSCC/OSCC_NW120_NE120_SE120_SW120.osg");
-}
-
-void ATR::createOSCC_155(void) {
-	oscc_155 = new Object("OSCC_155");
-	oscc_155->LoadFile("models/zw/OSCC/OSCC_NW155_NE155_SE155_SW155.osg");
-}
-
-void ATR::createOSCC_30_85_85_85(void) {
-	oscc_30_85_85_85 = new Object("OSCC_30_85_85_85");
-	oscc_30_85_85_85->LoadFile("models/zw/OSCC/OSCC_NW30_NE85_SE85_SW85.osg");
-}
-
-void ATR::createOSCC_40_85_85_85(void) {
-	oscc_40_85_85_85 = new Object("OSCC_40_85_85_85");
-	oscc_40_85_85_85->LoadFile("models/zw/OSCC/OSCC_NW40_NE85_SE85_SW85.osg");
-}
-
-void ATR::createOSCC_50_85_85_85(void) {
-	oscc_50_85_85_85 = new Object("OSCC_50_85_85_85");
-	oscc_50_85_85_85->LoadFile("models/zw/OSCC/OSCC_NW50_NE85_SE85_SW85.osg");
-}
-
-void ATR::createOSCC_60_85_85_85(void) {
-	oscc_60_85_85_85 = new Object("OSCC_60_85_85_85");
-	oscc_60_85_85_85->LoadFile("models/zw/OSCC/OSCC_NW60_NE85_SE85_SW85.osg");
-}
-
-void ATR::createOSCC_70_85_85_85(void) {
-	oscc_70_85_85_85 = new Object("OSCC_70_85_85_85");
-	oscc_70_85_85_85->LoadFile("models/zw/OSCC/OSCC_NW70_NE85_SE85_SW85.osg");
-}
-
-void ATR::createOSCC_80_85_85_85(void) {
-	oscc_80_85_85_85 = new Object("OSCC_80_85_85_85");
-	oscc_80_85_85_85->LoadFile("models/zw/OSCC/OSCC_NW80_NE85_SE85_SW85.osg");
-}
-
-void ATR::createOSCC_90_85_85_85(void) {
-	oscc_90_85_85_85 = new Object("OSCC_90_85_85_85");
-	oscc_90_85_85_85->LoadFile("models/zw/OSCC/OSCC_NW90_NE85_SE85_SW85.osg");
-}
-
-void ATR::createOSCC_100_85_85_85(void) {
-	oscc_100_85_85_85 = new Object("OSCC_100_85_85_85");
-	oscc_100_85_85_85->LoadFile("models/zw/OSCC/OSCC_NW100_NE85_SE85_SW85.osg");
-}
-
-void ATR::createOSCC_110_85_85_85(void) {
-	oscc_110_85_85_85 = new Object("OSCC_110_85_85_85");
-	oscc_110_85_85_85->LoadFile("models/zw/OSCC/OSCC_NW110_NE85_SE85_SW85.osg");
-}
-
-void ATR::createOSCC_120_85_85_85(void) {
-	oscc_120_85_85_85 = new Object("OSCC_120_85_85_85");
-	oscc_120_85_85_85->LoadFile("models/zw/OSCC/OSCC_NW120_NE85_SE85_SW85.osg");
+/*
+ * createOSCC - Creates an empty object for the OSCC drums and registers the
+ * drum model with the background loader. All drum angle combinations are
+ * shown by rotating the drum instances of a single model.
+ */
+void ATR::createOSCC(void) {
+	oscc = new Object("OSCC");
+	modelLoader = new ModelLoader(maxResidentModelBytes);
+	osccModel = modelLoader->addModel(osccModelFileName);
+	for (int i = 0; i < NUM_OSCC_QUADRANTS; ++i) {
+		osccAngles[i] = 0.0;
+	}
 }
 
 /*
@@ -240,21 +218,7 @@ void ATR::config(void) {
 	createUser(mass);
 	createVessel();
 	createClear_Vessel();
-	createOSCC_5();
-	createOSCC_51_8();
-	createOSCC_85();
-	createOSCC_120();
-	createOSCC_155();
-	createOSCC_30_85_85_85();
-	createOSCC_40_85_85_85();
-	createOSCC_50_85_85_85();
-	createOSCC_60_85_85_85();
-	createOSCC_70_85_85_85();
-	createOSCC_80_85_85_85();
-	createOSCC_90_85_85_85();
-	createOSCC_100_85_85_85();
-	createOSCC_110_85_85_85();
-	createOSCC_120_85_85_85();
+	createOSCC();
 
 	addObjects();
 } // end config()
@@ -268,10 +232,8 @@ void ATR::display(GLContextData & glContextData) const {
 	/* Get context data item: */
 	DataItem* dataItem = glContextData.retrieveDataItem<DataItem> (this);
 
+	/* The scene was already updated in frame(); only cull and draw it here: */
 	dataItem->viewer->advance(lastFrameTime);
-	if (!dataItem->viewer->done()) {
-		dataItem->viewer->updateTraversal();
-	}
 
 	GLint vp[4];
 	glGetIntegerv(GL_VIEWPORT, vp);
@@ -305,9 +267,44 @@ void ATR::frame(void) {
 	// particle system) function correctly.
 	updateVisitor->setTraversalNumber(frameNumber);
 
+	/* Show the drum model once it finished loading */
+	updateOSCC();
+
+	/* Run the update traversal once for all rendering contexts: */
+	GetRootNode()->accept(*updateVisitor);
+
 	lastFrameTime = newFrameTime;
 } // end frame()
 
+/*
+ * getOSCCAngle
+ *
+ * parameter quadrant - OSCCQuadrant
+ * return - double
+ */
+double ATR::getOSCCAngle(OSCCQuadrant quadrant) const {
+	return osccAngles[quadrant];
+}
+
+/*
+ * getOSCCConfiguration - Returns the preset configuration matching the
+ * current drum angles, or -1 if the angles were set individually.
+ *
+ * return - int
+ */
+int ATR::getOSCCConfiguration(void) const {
+	return osccConfiguration;
+}
+
+/*
+ * getOSCCVisible
+ *
+ * return - bool
+ */
+bool ATR::getOSCCVisible(void) const {
+	return oscc->DeltaDrawable::GetActive();
+}
+
 /*
  * initContext
  *
@@ -341,7 +338,6 @@ void ATR::initContext(GLContextData & glContextData) const {
 	root->addChild(atr->GetRootNode());
 
 	// Add the tree to the viewer and set properties
-	Guard<MutexPosix> viewerGuard(dataItem->viewerLock);
 	viewer->setSceneData(root);
 
 	dataItem->viewer = viewer;
@@ -349,93 +345,161 @@ void ATR::initContext(GLContextData & glContextData) const {
 	glContextData.addDataItem(this, dataItem);
 } // end initContext()
 
-void ATR::toggleLight(void) {
-	globalInfinite->SetEnabled(!globalInfinite->GetEnabled());
-}
-
-void ATR::toggleVessel(void) {
-	vessel.get()->DeltaDrawable::SetActive(
-			!vessel.get()->DeltaDrawable::GetActive());
-}
-
-void ATR::toggleClear_Vessel(void) {
-	clear_vessel.get()->DeltaDrawable::SetActive(
-			!clear_vessel.get()->DeltaDrawable::GetActive());
-}
-
-void ATR::toggleOSCC_5(void) {
-	oscc_5.get()->DeltaDrawable::SetActive(
-			!oscc_5.get()->DeltaDrawable::GetActive());
-}
-
-void ATR::toggleOSCC_51_8(void) {
-	oscc_51_8.get()->DeltaDrawable::SetActive(
-			!oscc_51_8.get()->DeltaDrawable::GetActive());
-}
-
-void ATR::toggleOSCC_85(void) {
-	oscc_85.get()->DeltaDrawable::SetActive(
-			!oscc_85.get()->DeltaDrawable::GetActive());
-}
-
-void ATR::toggleOSCC_120(void) {
-	oscc_120.get()->DeltaDrawable::SetActive(
-			!oscc_120.get()->DeltaDrawable::GetActive());
+/*
+ * setOSCCAngle - Sets the rotation angle in degrees of all drums in one
+ * quadrant.
+ *
+ * parameter quadrant - OSCCQuadrant
+ * parameter angle - double
+ */
+void ATR::setOSCCAngle(OSCCQuadrant quadrant, double angle) {
+	osccAngles[quadrant] = angle;
+	osccConfiguration = -1;
+	updateOSCCDrums();
 }
 
-void ATR::toggleOSCC_155(void) {
-	oscc_155.get()->DeltaDrawable::SetActive(
-			!oscc_155.get()->DeltaDrawable::GetActive());
+/*
+ * setOSCCConfiguration - Sets the drum angles of a preset configuration.
+ *
+ * parameter configuration - OSCCConfiguration
+ */
+void ATR::setOSCCConfiguration(OSCCConfiguration configuration) {
+	for (int i = 0; i < NUM_OSCC_QUADRANTS; ++i) {
+		osccAngles[i] = osccConfigurationAngles[configuration][i];
+	}
+	osccConfiguration = configuration;
+	updateOSCCDrums();
 }
 
-void ATR::toggleOSCC_30_85_85_85(void) {
-	oscc_30_85_85_85.get()->DeltaDrawable::SetActive(
-			!oscc_30_85_85_85.get()->DeltaDrawable::GetActive());
+/*
+ * setOSCCModel - Replaces the model shown by the drums' object.
+ *
+ * parameter node - osg::Node *
+ */
+void ATR::setOSCCModel(osg::Node * node) {
+	osg::MatrixTransform * matrixNode = oscc->GetMatrixNode();
+	matrixNode->removeChildren(0, matrixNode->getNumChildren());
+	if (node != 0) {
+		matrixNode->addChild(node);
+	}
 }
 
-void ATR::toggleOSCC_40_85_85_85(void) {
-	oscc_40_85_85_85.get()->DeltaDrawable::SetActive(
-			!oscc_40_85_85_85.get()->DeltaDrawable::GetActive());
+/*
+ * setOSCCVisible - Shows or hides the drums. A drum model that is shown for
+ * the first time, or that was unloaded in the meantime, is loaded in the
+ * background and represented by a placeholder until it is ready. A hidden
+ * drum model is released to the loader, which keeps it loaded until hidden
+ * models exceed the memory cap.
+ *
+ * parameter visible - bool
+ */
+void ATR::setOSCCVisible(bool visible) {
+	if (visible == oscc->DeltaDrawable::GetActive()) {
+		return;
+	}
+	oscc->DeltaDrawable::SetActive(visible);
+	if (visible) {
+		modelLoader->requestModel(osccModel);
+		setOSCCModel(osccPlaceholder.get());
+		updateOSCC();
+	} else {
+		/* Return the drums to zero rotation, such that a model that stays loaded can be shown again as is */
+		for (size_t i = 0; i < osccDrums.size(); ++i) {
+			osccDrums[i].transform->setMatrix(osccDrums[i].baseTransform);
+		}
+		osccDrums.clear();
+
+		/* Detach the model so that the loader can unload it when it runs out of room */
+		setOSCCModel(0);
+		osccLoaded = false;
+		modelLoader->releaseModel(osccModel);
+	}
 }
 
-void ATR::toggleOSCC_50_85_85_85(void) {
-	oscc_50_85_85_85.get()->DeltaDrawable::SetActive(
-			!oscc_50_85_85_85.get()->DeltaDrawable::GetActive());
+void ATR::toggleLight(void) {
+	globalInfinite->SetEnabled(!globalInfinite->GetEnabled());
 }
 
-void ATR::toggleOSCC_60_85_85_85(void) {
-	oscc_60_85_85_85.get()->DeltaDrawable::SetActive(
-			!oscc_60_85_85_85.get()->DeltaDrawable::GetActive());
+void ATR::toggleVessel(void) {
+	vessel.get()->DeltaDrawable::SetActive(
+			!vessel.get()->DeltaDrawable::GetActive());
 }
 
-void ATR::toggleOSCC_70_85_85_85(void) {
-	oscc_70_85_85_85.get()->DeltaDrawable::SetActive(
-			!oscc_70_85_85_85.get()->DeltaDrawable::GetActive());
+void ATR::toggleClear_Vessel(void) {
+	clear_vessel.get()->DeltaDrawable::SetActive(
+			!clear_vessel.get()->DeltaDrawable::GetActive());
 }
 
-void ATR::toggleOSCC_80_85_85_85(void) {
-	oscc_80_85_85_85.get()->DeltaDrawable::SetActive(
-			!oscc_80_85_85_85.get()->DeltaDrawable::GetActive());
-}
+/*
+ * updateOSCC - Replaces the placeholder with the drum model once it has been
+ * loaded and collects its drum instances.
+ */
+void ATR::updateOSCC(void) {
+	if (osccLoaded || !oscc->DeltaDrawable::GetActive()) {
+		return;
+	}
+	osg::Node * model = modelLoader->getModel(osccModel);
+	if (model == 0) {
+		/* Keep frames coming while the drum model is being loaded */
+		if (modelLoader->isPending()) {
+			Vrui::requestUpdate();
+		}
+		return;
+	}
 
-void ATR::toggleOSCC_90_85_85_85(void) {
-	oscc_90_85_85_85.get()->DeltaDrawable::SetActive(
-			!oscc_90_85_85_85.get()->DeltaDrawable::GetActive());
-}
+	/* Create a placeholder from the model's bounds, to be shown while the model is reloaded after it was unloaded */
+	if (!osccPlaceholder.valid()) {
+		osg::ComputeBoundsVisitor boundsVisitor;
+		model->accept(boundsVisitor);
+		const osg::BoundingBox& bounds = boundsVisitor.getBoundingBox();
+		osg::Geode * placeholder = new osg::Geode();
+		placeholder->addDrawable(new osg::ShapeDrawable(new osg::Box(
+				bounds.center(), bounds.xMax() - bounds.xMin(), bounds.yMax()
+						- bounds.yMin(), bounds.zMax() - bounds.zMin())));
+		osg::StateSet * stateSet = placeholder->getOrCreateStateSet();
+		stateSet->setAttributeAndModes(new osg::PolygonMode(
+				osg::PolygonMode::FRONT_AND_BACK, osg::PolygonMode::LINE));
+		stateSet->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+		osccPlaceholder = placeholder;
+	}
 
-void ATR::toggleOSCC_100_85_85_85(void) {
-	oscc_100_85_85_85.get()->DeltaDrawable::SetActive(
-			!oscc_100_85_85_85.get()->DeltaDrawable::GetActive());
-}
+	/* Find all drum instances; they share the model's drum geometry */
+	OSCCDrumFinder drumFinder;
+	model->accept(drumFinder);
+	osccDrums.clear();
+	for (size_t i = 0; i < drumFinder.drums.size(); ++i) {
+		OSCCDrum drum;
+		drum.transform = drumFinder.drums[i];
+		drum.transform->setDataVariance(osg::Object::DYNAMIC);
+		drum.baseTransform = drum.transform->getMatrix();
+		osg::Vec3d position = drum.baseTransform.getTrans();
+		if (position.y() >= 0.0) {
+			drum.quadrant = position.x() < 0.0 ? OSCC_NW : OSCC_NE;
+		} else {
+			drum.quadrant = position.x() < 0.0 ? OSCC_SW : OSCC_SE;
+		}
+		drum.direction = (position.x() * position.y() > 0.0) == (fabs(
+				position.x()) > fabs(position.y())) ? 1.0 : -1.0;
+		osccDrums.push_back(drum);
+	}
 
-void ATR::toggleOSCC_110_85_85_85(void) {
-	oscc_110_85_85_85.get()->DeltaDrawable::SetActive(
-			!oscc_110_85_85_85.get()->DeltaDrawable::GetActive());
+	setOSCCModel(model);
+	osccLoaded = true;
+	updateOSCCDrums();
 }
 
-void ATR::toggleOSCC_120_85_85_85(void) {
-	oscc_120_85_85_85.get()->DeltaDrawable::SetActive(
-			!oscc_120_85_85_85.get()->DeltaDrawable::GetActive());
+/*
+ * updateOSCCDrums - Rotates all drum instances about their axes to the
+ * current angles of their quadrants.
+ */
+void ATR::updateOSCCDrums(void) {
+	for (size_t i = 0; i < osccDrums.size(); ++i) {
+		const OSCCDrum& drum = osccDrums[i];
+		double angle = osg::DegreesToRadians(drum.direction
+				* osccAngles[drum.quadrant]);
+		drum.transform->setMatrix(osg::Matrix::rotate(angle, osg::Vec3d(0.0,
+				0.0, 1.0)) * drum.baseTransform);
+	}
 }
 
 void ATR::toggleWireframe(void) {
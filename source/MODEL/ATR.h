@@ -9,6 +9,9 @@
 #ifndef ATR_H_
 #define ATR_H_
 
+/* System headers */
+#include <vector>
+
 /* Delta3D includes */
 #include <dtABC/application.h>
 
@@ -22,14 +25,14 @@
 #include <osg/Matrix>
 #include <osg/Transform>
 #include <osg/Group>
+#include <osg/MatrixTransform>
 #include <osg/Camera>
 
 #include <osgUtil/UpdateVisitor>
 
 #include <osgViewer/Viewer>
 
-#include <SYNC/MutexPosix.h>
-#include <SYNC/NullMutex.h>
+#include <MODEL/ModelLoader.h>
 
 using namespace std;
 using namespace dtCore;
@@ -45,17 +48,49 @@ class dMass;
 
 class ATR: public Application , public GLObject {
 public:
+	/* 
+	 * OSCC_#: # represents angle at which cylinders are rotated 
+	 * from 0 degrees. One number means all cylinders are at same 
+	 * rotation; multiple numbers mean NW quadrant, then NE 
+	 * quadrant, then SE quadrant, then SW quadrant (NOTE: 
+	 * decimals are represented by underscores. EX 51.8 = 51_8). 
+	 */
+	enum OSCCQuadrant {
+		OSCC_NW, OSCC_NE, OSCC_SE, OSCC_SW, NUM_OSCC_QUADRANTS
+	};
+	enum OSCCConfiguration {
+		OSCC_5,
+		OSCC_51_8,
+		OSCC_85,
+		OSCC_120,
+		OSCC_155,
+		OSCC_30_85_85_85,
+		OSCC_40_85_85_85,
+		OSCC_50_85_85_85,
+		OSCC_60_85_85_85,
+		OSCC_70_85_85_85,
+		OSCC_80_85_85_85,
+		OSCC_90_85_85_85,
+		OSCC_100_85_85_85,
+		OSCC_110_85_85_85,
+		OSCC_120_85_85_85,
+		NUM_OSCC_CONFIGURATIONS
+	};
 	ATR(void);
 protected:
 	virtual ~ATR(void);
 private:
+	/*
+	 * Per-context viewer; it only culls and draws the shared scene, which is
+	 * updated once per frame in frame(). Each viewer is only used by its own
+	 * context's rendering thread, so contexts never wait for each other.
+	 */
 	struct DataItem: public GLObject::DataItem {
 	public:
 		/* Elements: */
 		int data;
 		osg::Group * root;
 		osg::ref_ptr<osgViewer::Viewer> viewer;
-		MutexPosix viewerLock;
 
 		/* Constructors and destructors: */
 		DataItem(void);
@@ -72,28 +107,12 @@ public:
 	void toggleClear_Vessel(void);
 	void toggleWireframe(void);
 
-	/* 
-	 * OSCC_#: # represents angle at which cylinders are rotated 
-	 * from 0 degrees. One number means all cylinders are at same 
-	 * rotation; multiple numbers mean NW quadrant, then NE 
-	 * quadrant, then SE quadrant, then SW quadrant (NOTE: 
-	 * decimals are represented by underscores. EX 51.8 = 51_8). 
-	 */
-	void toggleOSCC_5(void);
-	void toggleOSCC_51_8(void);
-	void toggleOSCC_85(void);
-	void toggleOSCC_120(void);
-	void toggleOSCC_155(void);
-	void toggleOSCC_30_85_85_85(void);
-	void toggleOSCC_40_85_85_85(void);
-	void toggleOSCC_50_85_85_85(void);
-	void toggleOSCC_60_85_85_85(void);
-	void toggleOSCC_70_85_85_85(void);
-	void toggleOSCC_80_85_85_85(void);
-	void toggleOSCC_90_85_85_85(void);
-	void toggleOSCC_100_85_85_85(void);
-	void toggleOSCC_110_85_85_85(void);
-	void toggleOSCC_120_85_85_85(void);
+	double getOSCCAngle(OSCCQuadrant quadrant) const;
+	int getOSCCConfiguration(void) const;
+	bool getOSCCVisible(void) const;
+	void setOSCCAngle(OSCCQuadrant quadrant, double angle);
+	void setOSCCConfiguration(OSCCConfiguration configuration);
+	void setOSCCVisible(bool visible);
 	ATR * atr;
 	bool drawMode;
 	RefPtr<Environment> environment;
@@ -104,43 +123,34 @@ public:
 	RefPtr<Object> user;
 	RefPtr<Object> vessel;
 	RefPtr<Object> clear_vessel;
-	RefPtr<Object> oscc_5;
-	RefPtr<Object> oscc_51_8;
-	RefPtr<Object> oscc_85;
-	RefPtr<Object> oscc_120;
-	RefPtr<Object> oscc_155;
-	RefPtr<Object> oscc_30_85_85_85;
-	RefPtr<Object> oscc_40_85_85_85;
-	RefPtr<Object> oscc_50_85_85_85;
-	RefPtr<Object> oscc_60_85_85_85;
-	RefPtr<Object> oscc_70_85_85_85;
-	RefPtr<Object> oscc_80_85_85_85;
-	RefPtr<Object> oscc_90_85_85_85;
-	RefPtr<Object> oscc_100_85_85_85;
-	RefPtr<Object> oscc_110_85_85_85;
-	RefPtr<Object> oscc_120_85_85_85;
+	RefPtr<Object> oscc;
+	int osccModel;
+	bool osccLoaded;
+	double osccAngles[NUM_OSCC_QUADRANTS];
+	int osccConfiguration;
+	ModelLoader * modelLoader;
+	osg::ref_ptr<osg::Node> osccPlaceholder;
 	RefPtr<Object> wandinstrument;
 	RefPtr<InfiniteLight> globalInfinite;
 private:
+	struct OSCCDrum {
+	public:
+		/* Elements: */
+		osg::ref_ptr<osg::MatrixTransform> transform; // Transformation of one drum instance in the shared model
+		osg::Matrix baseTransform; // The instance's transformation at zero rotation
+		OSCCQuadrant quadrant; // Quadrant the drum belongs to
+		double direction; // Sense of rotation of the drum; drums mirror each other across the quadrant diagonal
+	};
+	std::vector<OSCCDrum> osccDrums;
+
 	void createEnvironment(void);
 	void createUser(dMass & mass);
 	void createVessel(void);
 	void createClear_Vessel(void);
-	void createOSCC_5(void);
-	void createOSCC_51_8(void);
-	void createOSCC_85(void);
-	void createOSCC_120(void);
-	void createOSCC_155(void);
-	void createOSCC_30_85_85_85(void);
-	void createOSCC_40_85_85_85(void);
-	void createOSCC_50_85_85_85(void);
-	void createOSCC_60_85_85_85(void);
-	void createOSCC_70_85_85_85(void);
-	void createOSCC_80_85_85_85(void);
-	void createOSCC_90_85_85_85(void);
-	void createOSCC_100_85_85_85(void);
-	void createOSCC_110_85_85_85(void);
-	void createOSCC_120_85_85_85(void);
+	void createOSCC(void);
+	void setOSCCModel(osg::Node * node);
+	void updateOSCC(void);
+	void updateOSCCDrums(void);
 };
 
 #endif
@@ -0,0 +1,198 @@
+/*
+ * LODGenerator.cpp - Methods for creating levels of detail.
+ *
+ * Author: Patrick O'Leary
+ * Created: May 11, 2010
+ * Copyright: 2010
+ * Requirements: OSG 2.8.2
+ */
+
+/* System headers */
+#include <float.h>
+#include <set>
+
+/* OSG headers */
+#include <osg/CopyOp>
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/LOD>
+#include <osg/NodeVisitor>
+#include <osg/TriangleFunctor>
+#include <osg/ref_ptr>
+#include <osgUtil/Simplifier>
+
+#include "LODGenerator.h"
+
+/*
+ * TriangleCounter - Functor counting the triangles of a drawable.
+ */
+struct TriangleCounter {
+	TriangleCounter(void) :
+		numTriangles(0) {
+	}
+	void operator()(const osg::Vec3 &, const osg::Vec3 &, const osg::Vec3 &,
+			bool) {
+		++numTriangles;
+	}
+
+	size_t numTriangles;
+};
+
+/*
+ * countGeodeTriangles - Returns the number of triangles of all drawables of a
+ * geode.
+ *
+ * parameter geode - const osg::Geode &
+ * return - size_t
+ */
+static size_t countGeodeTriangles(const osg::Geode & geode) {
+	osg::TriangleFunctor<TriangleCounter> counter;
+	for (unsigned int i = 0; i < geode.getNumDrawables(); ++i) {
+		geode.getDrawable(i)->accept(counter);
+	}
+	return counter.numTriangles;
+}
+
+/*
+ * GeodeCollector - Node visitor collecting each geode once, even if it is
+ * shared by several parents.
+ */
+class GeodeCollector: public osg::NodeVisitor {
+public:
+	GeodeCollector(void) :
+		osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN) {
+	}
+	virtual void apply(osg::Geode & geode) {
+		if (visited.insert(&geode).second) {
+			geodes.push_back(&geode);
+		}
+	}
+
+	std::set<osg::Geode *> visited;
+	std::vector<osg::ref_ptr<osg::Geode> > geodes;
+};
+
+/*
+ * LevelTriangleCounter - Node visitor summing up the triangles rendered at
+ * each level of detail. Geometry outside of LOD nodes counts toward every
+ * level; shared geometry counts once per instance.
+ */
+class LevelTriangleCounter: public osg::NodeVisitor {
+public:
+	LevelTriangleCounter(int numLevels) :
+		osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN), level(-1),
+				triangles(numLevels, 0) {
+	}
+	virtual void apply(osg::LOD & lod) {
+		int parentLevel = level;
+		for (unsigned int i = 0; i < lod.getNumChildren(); ++i) {
+			level = int(i);
+			lod.getChild(i)->accept(*this);
+		}
+		level = parentLevel;
+	}
+	virtual void apply(osg::Geode & geode) {
+		size_t numTriangles = countGeodeTriangles(geode);
+		for (size_t i = 0; i < triangles.size(); ++i) {
+			if (level < 0 || size_t(level) == i) {
+				triangles[i] += numTriangles;
+			}
+		}
+	}
+
+	int level;
+	std::vector<size_t> triangles;
+};
+
+/****************************************************
+ Constructors and Destructors of class LODGenerator:
+ ****************************************************/
+/*
+ * LODGenerator constructor
+ *
+ * param sNumLevels - int
+ * param sSampleRatio - double
+ * param sRangeFactor - float
+ */
+LODGenerator::LODGenerator(int sNumLevels, double sSampleRatio,
+		float sRangeFactor) :
+	numLevels(sNumLevels), sampleRatio(sSampleRatio),
+			rangeFactor(sRangeFactor), minTriangles(256) {
+} // end LODGenerator()
+
+/********************************
+ Methods of class LODGenerator:
+ ********************************/
+
+/*
+ * apply - Replaces every geode of a model that has enough triangles by an
+ * LOD node switching between the geode and simplified copies of it. Shared
+ * geodes are simplified once and stay shared.
+ *
+ * parameter root - osg::Node *
+ */
+void LODGenerator::apply(osg::Node * root) const {
+	GeodeCollector collector;
+	root->accept(collector);
+
+	for (size_t i = 0; i < collector.geodes.size(); ++i) {
+		osg::Geode * geode = collector.geodes[i].get();
+		if (geode->getNumParents() == 0 || countGeodeTriangles(*geode)
+				< minTriangles) {
+			continue;
+		}
+
+		/* Create the LOD node with the original geode as the finest level: */
+		osg::ref_ptr<osg::LOD> lod = new osg::LOD;
+		lod->setName(geode->getName());
+		float radius = geode->getBound().radius();
+		float maxRange = radius * rangeFactor;
+		lod->addChild(geode, 0.0f, numLevels > 1 ? maxRange : FLT_MAX);
+
+		/* Create the coarser levels by simplifying copies of the previous level: */
+		osg::ref_ptr<osg::Geode> previous = geode;
+		for (int level = 1; level < numLevels; ++level) {
+			osg::ref_ptr<osg::Geode> simplified =
+					static_cast<osg::Geode *> (previous->clone(
+							osg::CopyOp::DEEP_COPY_ALL));
+			osgUtil::Simplifier simplifier(sampleRatio);
+			simplified->accept(simplifier);
+			float minRange = maxRange;
+			maxRange = level < numLevels - 1 ? minRange * 2.0f : FLT_MAX;
+			lod->addChild(simplified.get(), minRange, maxRange);
+			previous = simplified;
+		}
+
+		/* Replace the geode by the LOD node in all its parents: */
+		osg::Node::ParentList parents = geode->getParents();
+		for (size_t j = 0; j < parents.size(); ++j) {
+			if (parents[j] != lod.get()) {
+				parents[j]->replaceChild(geode, lod.get());
+			}
+		}
+	}
+} // end apply()
+
+/*
+ * countTriangles - Returns the number of triangles of a model rendered at
+ * each level of detail.
+ *
+ * parameter root - osg::Node *
+ * parameter numLevels - int
+ * return - std::vector<size_t>
+ */
+std::vector<size_t> LODGenerator::countTriangles(osg::Node * root,
+		int numLevels) {
+	LevelTriangleCounter counter(numLevels);
+	root->accept(counter);
+	return counter.triangles;
+} // end countTriangles()
+
+/*
+ * getNumLevels
+ *
+ * return - int
+ */
+int LODGenerator::getNumLevels(void) const {
+	return numLevels;
+} // end getNumLevels()
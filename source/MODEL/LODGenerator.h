@@ -0,0 +1,35 @@
+/*
+ * LODGenerator.h - Class to replace the geometry of a model with
+ * distance-switched levels of detail created by mesh simplification.
+ *
+ * Author: Patrick O'Leary
+ * Created: May 11, 2010
+ * Copyright: 2010
+ */
+
+#ifndef LODGENERATOR_H_
+#define LODGENERATOR_H_
+
+/* System headers */
+#include <stddef.h>
+#include <vector>
+
+/* osg includes */
+#include <osg/Node>
+
+class LODGenerator {
+public:
+	LODGenerator(int sNumLevels = 4, double sSampleRatio = 0.5,
+			float sRangeFactor = 8.0f);
+
+	void apply(osg::Node * root) const;
+	static std::vector<size_t> countTriangles(osg::Node * root, int numLevels);
+	int getNumLevels(void) const;
+private:
+	int numLevels; // Number of levels of detail, including the full-resolution level
+	double sampleRatio; // Fraction of triangles each level keeps from the previous level
+	float rangeFactor; // Viewing distance up to which the full-resolution level is shown, in units of the geometry's bounding radius; each further level doubles the distance
+	size_t minTriangles; // Geometry with fewer triangles is not simplified
+};
+
+#endif /* LODGENERATOR_H_ */
@@ -0,0 +1,219 @@
+/*
+ * ModelLoader.cpp - Methods for background model loading.
+ *
+ * Author: Patrick O'Leary
+ * Created: May 11, 2010
+ * Copyright: 2010
+ * Requirements: OSG 2.8.2
+ */
+
+/* System headers */
+#include <sys/stat.h>
+#include <algorithm>
+#include <iostream>
+
+/* Vrui headers */
+#include <Misc/Timer.h>
+#include <Vrui/Vrui.h>
+
+/* OSG headers */
+#include <osgDB/ReadFile>
+
+#include "ModelLoader.h"
+#include "SceneCache.h"
+
+/****************************************************
+ Constructors and Destructors of class ModelLoader:
+ ****************************************************/
+/*
+ * ModelLoader constructor
+ *
+ * param sMaxResidentBytes - size_t
+ */
+ModelLoader::ModelLoader(size_t sMaxResidentBytes) :
+	maxResidentBytes(sMaxResidentBytes), residentBytes(0), useCounter(0),
+			shutdown(false) {
+	/* Start the loader thread: */
+	loaderThread.start(this, &ModelLoader::loaderThreadMethod);
+} // end ModelLoader()
+
+ModelLoader::~ModelLoader(void) {
+	/* Shut down the loader thread; a model that is currently being read is finished first: */
+	{
+		Threads::Mutex::Lock lock(mutex);
+		shutdown = true;
+		requestCond.signal();
+	}
+	loaderThread.join();
+} // end ~ModelLoader()
+
+/*******************************
+ Methods of class ModelLoader:
+ *******************************/
+
+/*
+ * addModel - Registers a model file without loading it.
+ *
+ * parameter fileName - const std::string &
+ * return - int
+ */
+int ModelLoader::addModel(const std::string& fileName) {
+	Model model;
+	model.fileName = fileName;
+	struct stat fileStats;
+	model.size = stat(fileName.c_str(), &fileStats) == 0 ? size_t(
+			fileStats.st_size) : 0;
+	model.state = UNLOADED;
+	model.inUse = false;
+	model.lastUse = 0;
+
+	Threads::Mutex::Lock lock(mutex);
+	models.push_back(model);
+	return int(models.size()) - 1;
+} // end addModel()
+
+/*
+ * evictModels - Unloads the least recently used models that are not in use
+ * until the loaded models fit into the memory cap. Must be called with the
+ * mutex locked.
+ */
+void ModelLoader::evictModels(void) {
+	while (residentBytes > maxResidentBytes) {
+		/* Find the least recently used loaded model that is not in use: */
+		int victim = -1;
+		for (size_t i = 0; i < models.size(); ++i) {
+			if (models[i].state == LOADED && !models[i].inUse && (victim < 0
+					|| models[i].lastUse < models[victim].lastUse)) {
+				victim = int(i);
+			}
+		}
+		if (victim < 0) {
+			break;
+		}
+
+		/* Unload the model: */
+		models[victim].node = 0;
+		models[victim].state = UNLOADED;
+		residentBytes -= models[victim].size;
+	}
+} // end evictModels()
+
+/*
+ * getModel - Returns a model's root node if the model has been loaded.
+ *
+ * parameter modelIndex - int
+ * return - osg::Node *
+ */
+osg::Node * ModelLoader::getModel(int modelIndex) const {
+	Threads::Mutex::Lock lock(mutex);
+	return models[modelIndex].state == LOADED ? models[modelIndex].node.get()
+			: 0;
+} // end getModel()
+
+/*
+ * isPending - Returns true if requested models are still waiting to be
+ * loaded.
+ *
+ * return - bool
+ */
+bool ModelLoader::isPending(void) const {
+	Threads::Mutex::Lock lock(mutex);
+	for (size_t i = 0; i < models.size(); ++i) {
+		if (models[i].inUse && (models[i].state == QUEUED || models[i].state
+				== LOADING)) {
+			return true;
+		}
+	}
+	return false;
+} // end isPending()
+
+/*
+ * loaderThreadMethod
+ *
+ * return - void *
+ */
+void * ModelLoader::loaderThreadMethod(void) {
+	while (true) {
+		/* Wait for the next model request: */
+		int modelIndex;
+		std::string fileName;
+		{
+			Threads::Mutex::Lock lock(mutex);
+			while (!shutdown && requestQueue.empty()) {
+				requestCond.wait(mutex);
+			}
+			if (shutdown) {
+				break;
+			}
+			modelIndex = requestQueue.front();
+			requestQueue.pop_front();
+			models[modelIndex].state = LOADING;
+			fileName = models[modelIndex].fileName;
+		}
+
+		/* Read the model file without holding the lock; ASCII files are read from their binary cache: */
+		Misc::Timer t;
+		osg::ref_ptr<osg::Node> node = osgDB::readNodeFile(
+				SceneCache::getModelFileName(fileName));
+		t.elapse();
+		if (node.valid() && Vrui::isMaster()) {
+			std::cout << "Time to load model " << fileName << ": "
+					<< t.getTime() * 1000.0 << " ms" << std::endl;
+		}
+
+		Threads::Mutex::Lock lock(mutex);
+		Model& model = models[modelIndex];
+		if (node.valid()) {
+			model.node = node;
+			model.state = LOADED;
+			residentBytes += model.size;
+			evictModels();
+		} else {
+			std::cerr << "ModelLoader: could not load model file "
+					<< fileName << std::endl;
+			model.state = FAILED;
+		}
+	}
+
+	return 0;
+} // end loaderThreadMethod()
+
+/*
+ * releaseModel - Marks a model as no longer in use; it stays loaded until it
+ * is evicted to make room for other models.
+ *
+ * parameter modelIndex - int
+ */
+void ModelLoader::releaseModel(int modelIndex) {
+	Threads::Mutex::Lock lock(mutex);
+	Model& model = models[modelIndex];
+	model.inUse = false;
+	model.lastUse = ++useCounter;
+
+	/* Cancel a pending request: */
+	if (model.state == QUEUED) {
+		requestQueue.erase(std::find(requestQueue.begin(),
+				requestQueue.end(), modelIndex));
+		model.state = UNLOADED;
+	}
+
+	evictModels();
+} // end releaseModel()
+
+/*
+ * requestModel - Marks a model as in use and queues it for loading if it is
+ * not loaded yet. The most recent request is served first.
+ *
+ * parameter modelIndex - int
+ */
+void ModelLoader::requestModel(int modelIndex) {
+	Threads::Mutex::Lock lock(mutex);
+	Model& model = models[modelIndex];
+	model.inUse = true;
+	model.lastUse = ++useCounter;
+	if (model.state == UNLOADED) {
+		model.state = QUEUED;
+		requestQueue.push_front(modelIndex);
+		requestCond.signal();
+	}
+} // end requestModel()
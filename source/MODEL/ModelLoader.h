@@ -0,0 +1,67 @@
+/*
+ * ModelLoader.h - Class to load model files on a background thread and to
+ * keep the most recently used models resident within a memory cap.
+ *
+ * Author: Patrick O'Leary
+ * Created: May 11, 2010
+ * Copyright: 2010
+ */
+
+#ifndef MODELLOADER_H_
+#define MODELLOADER_H_
+
+/* System headers */
+#include <stddef.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+/* Vrui includes */
+#include <Threads/Mutex.h>
+#include <Threads/Cond.h>
+#include <Threads/Thread.h>
+
+/* osg includes */
+#include <osg/ref_ptr>
+#include <osg/Node>
+
+class ModelLoader {
+public:
+	ModelLoader(size_t sMaxResidentBytes);
+	~ModelLoader(void);
+private:
+	enum State {
+		UNLOADED, QUEUED, LOADING, LOADED, FAILED
+	};
+	struct Model {
+	public:
+		/* Elements: */
+		std::string fileName; // Name of the model file
+		size_t size; // Size of the model file, used as an estimate of the model's memory footprint
+		State state; // Current loading state of the model
+		osg::ref_ptr<osg::Node> node; // Root node of the loaded model
+		bool inUse; // Flag whether the model has been requested and not released since
+		unsigned int lastUse; // Use counter value at the time the model was last requested or released
+	};
+public:
+	int addModel(const std::string& fileName);
+	osg::Node * getModel(int modelIndex) const;
+	bool isPending(void) const;
+	void releaseModel(int modelIndex);
+	void requestModel(int modelIndex);
+private:
+	void evictModels(void);
+	void * loaderThreadMethod(void);
+
+	size_t maxResidentBytes; // Upper bound for the total size of loaded models that are not in use
+	size_t residentBytes; // Total size of all loaded models
+	std::vector<Model> models; // List of all registered models
+	std::deque<int> requestQueue; // Indices of models waiting to be loaded, most recently requested first
+	unsigned int useCounter; // Counter to order model requests and releases
+	bool shutdown; // Flag to tell the loader thread to exit
+	mutable Threads::Mutex mutex; // Mutex protecting the model list and the request queue
+	Threads::Cond requestCond; // Condition variable to wake up the loader thread
+	Threads::Thread loaderThread; // Thread loading queued models
+};
+
+#endif /* MODELLOADER_H_ */
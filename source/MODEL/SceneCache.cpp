@@ -0,0 +1,150 @@
+/*
+ * SceneCache.cpp - Methods for caching model files in binary form.
+ *
+ * Author: Patrick O'Leary
+ * Created: May 11, 2010
+ * Copyright: 2010
+ * Requirements: OSG 2.8.2
+ */
+
+/* System headers */
+#include <stdio.h>
+#include <unistd.h>
+#include <iostream>
+
+/* OSG headers */
+#include <osg/ref_ptr>
+#include <osg/Node>
+#include <osgDB/FileNameUtils>
+#include <osgDB/FileUtils>
+#include <osgDB/ReadFile>
+#include <osgDB/WriteFile>
+
+#include "LODGenerator.h"
+#include "SceneCache.h"
+
+/**************************************
+ Static elements of class SceneCache:
+ **************************************/
+const char * SceneCache::cacheDirectoryName = ".osgcache";
+const char * SceneCache::cacheExtension = "ive";
+
+/******************************
+ Methods of class SceneCache:
+ ******************************/
+
+/*
+ * getCacheFileName - Returns the name of the binary cache file for the
+ * current contents of a model file, or an empty string if the model file
+ * can not be read. The name contains a hash of the file contents and the
+ * number of levels of detail, so an edited model file never picks up a
+ * stale cache file.
+ *
+ * parameter fileName - const std::string &
+ * return - std::string
+ */
+std::string SceneCache::getCacheFileName(const std::string& fileName) {
+	unsigned long long hash;
+	if (!hashFile(fileName, hash)) {
+		return std::string();
+	}
+	char hashString[32];
+	snprintf(hashString, sizeof(hashString), "%016llx-lod%d", hash,
+			LODGenerator().getNumLevels());
+
+	std::string cacheDirectory = osgDB::getFilePath(fileName);
+	if (!cacheDirectory.empty()) {
+		cacheDirectory += '/';
+	}
+	cacheDirectory += cacheDirectoryName;
+	return cacheDirectory + '/' + osgDB::getStrippedName(fileName) + '-'
+			+ hashString + '.' + cacheExtension;
+} // end getCacheFileName()
+
+/*
+ * getModelFileName - Returns the name of the file a model should be loaded
+ * from. Binary files are returned as they are; ASCII files are converted to
+ * a binary cache file with generated levels of detail on first use, and the
+ * cache file is returned. If the conversion fails, the original file is
+ * returned.
+ *
+ * parameter fileName - const std::string &
+ * return - std::string
+ */
+std::string SceneCache::getModelFileName(const std::string& fileName) {
+	if (osgDB::getLowerCaseFileExtension(fileName) == cacheExtension) {
+		return fileName;
+	}
+	std::string cacheFileName = getCacheFileName(fileName);
+	if (cacheFileName.empty()) {
+		return fileName;
+	}
+	if (osgDB::fileExists(cacheFileName)) {
+		return cacheFileName;
+	}
+
+	/* Parse the ASCII file once, simplify it, and write the binary cache file: */
+	std::cout << "SceneCache: converting " << fileName << " to "
+			<< cacheFileName << std::endl;
+	osg::ref_ptr<osg::Node> node = osgDB::readNodeFile(fileName);
+	if (!node.valid()) {
+		return fileName;
+	}
+	LODGenerator().apply(node.get());
+	if (!osgDB::makeDirectoryForFile(cacheFileName)) {
+		std::cerr << "SceneCache: could not create cache directory for "
+				<< cacheFileName << std::endl;
+		return fileName;
+	}
+
+	/*
+	 * Write to a temporary file first, so that concurrent readers never see a
+	 * partial cache file. The temporary file name contains the host name and
+	 * the process ID, because cluster nodes sharing the model directory over
+	 * a network file system can run processes with the same ID:
+	 */
+	char hostName[256];
+	if (gethostname(hostName, sizeof(hostName)) != 0) {
+		hostName[0] = '\0';
+	}
+	hostName[sizeof(hostName) - 1] = '\0';
+	char uniqueString[sizeof(hostName) + 32];
+	snprintf(uniqueString, sizeof(uniqueString), ".%s.%d", hostName,
+			int(getpid()));
+	std::string tempFileName = cacheFileName + uniqueString + '.'
+			+ cacheExtension;
+	if (!osgDB::writeNodeFile(*node, tempFileName) || rename(
+			tempFileName.c_str(), cacheFileName.c_str()) != 0) {
+		std::cerr << "SceneCache: could not write cache file "
+				<< cacheFileName << std::endl;
+		remove(tempFileName.c_str());
+		return fileName;
+	}
+	return cacheFileName;
+} // end getModelFileName()
+
+/*
+ * hashFile - Calculates the 64-bit FNV-1a hash of a file's contents.
+ *
+ * parameter fileName - const std::string &
+ * parameter hash - unsigned long long &
+ * return - bool
+ */
+bool SceneCache::hashFile(const std::string& fileName, unsigned long long& hash) {
+	FILE * file = fopen(fileName.c_str(), "rb");
+	if (file == 0) {
+		return false;
+	}
+	hash = 14695981039346656037ULL;
+	unsigned char buffer[65536];
+	size_t bytesRead;
+	while ((bytesRead = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+		for (size_t i = 0; i < bytesRead; ++i) {
+			hash ^= buffer[i];
+			hash *= 1099511628211ULL;
+		}
+	}
+	bool ok = ferror(file) == 0;
+	fclose(file);
+	return ok;
+} // end hashFile()
@@ -0,0 +1,27 @@
+/*
+ * SceneCache.h - Class to convert ASCII model files to the OSG native
+ * binary format once and to hand out the cached binary files afterwards.
+ *
+ * Author: Patrick O'Leary
+ * Created: May 11, 2010
+ * Copyright: 2010
+ */
+
+#ifndef SCENECACHE_H_
+#define SCENECACHE_H_
+
+/* System headers */
+#include <string>
+
+class SceneCache {
+public:
+	static std::string getCacheFileName(const std::string& fileName);
+	static std::string getModelFileName(const std::string& fileName);
+private:
+	static bool hashFile(const std::string& fileName, unsigned long long& hash);
+
+	static const char * cacheDirectoryName; // Name of the cache directory, relative to the directory of each model file
+	static const char * cacheExtension; // File name extension selecting the OSG native binary format
+};
+
+#endif /* SCENECACHE_H_ */
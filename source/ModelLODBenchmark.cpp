@@ -0,0 +1,80 @@
+/*
+ * Description: ModelLODBenchmark.cpp - Reports the triangle counts of the
+ * generated levels of detail of model files and the time to generate them,
+ * without opening a window
+ * Author: Patrick O'Leary
+ * Date: May 11, 2010
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Misc/Timer.h>
+
+#include <osg/ref_ptr>
+#include <osg/Node>
+#include <osgDB/ReadFile>
+
+#include <MODEL/LODGenerator.h>
+
+/*
+ * main
+ *
+ * parameter argc - int
+ * parameter argv - char**
+ * return - int
+ */
+int main(int argc, char** argv) {
+	/* Parse the command line: */
+	int numLevels = 4;
+	double sampleRatio = 0.5;
+	std::vector<std::string> fileNames;
+	for (int i = 1; i < argc; ++i) {
+		if (strcasecmp(argv[i], "-levels") == 0 && i + 1 < argc) {
+			numLevels = atoi(argv[++i]);
+		} else if (strcasecmp(argv[i], "-ratio") == 0 && i + 1 < argc) {
+			sampleRatio = atof(argv[++i]);
+		} else {
+			fileNames.push_back(argv[i]);
+		}
+	}
+	if (fileNames.empty()) {
+		/* Benchmark the models loaded by the ATR scene: */
+		fileNames.push_back("models/SReactor_Vessel.osg");
+		fileNames.push_back("models/zw/Clear_Vessel.osg");
+		fileNames.push_back("models/zw/OSCC/OSCC_NW0_NE0_SE0_SW0.osg");
+	}
+
+	LODGenerator lodGenerator(numLevels, sampleRatio);
+	for (size_t i = 0; i < fileNames.size(); ++i) {
+		Misc::Timer loadTimer;
+		osg::ref_ptr<osg::Node> node = osgDB::readNodeFile(fileNames[i]);
+		loadTimer.elapse();
+		if (!node.valid()) {
+			std::cerr << "Could not load model file " << fileNames[i]
+					<< std::endl;
+			continue;
+		}
+		std::cout << fileNames[i] << ":" << std::endl;
+		std::cout << "  Time to load model: " << loadTimer.getTime() * 1000.0
+				<< " ms" << std::endl;
+
+		Misc::Timer simplificationTimer;
+		lodGenerator.apply(node.get());
+		simplificationTimer.elapse();
+		std::cout << "  Time to generate levels of detail: "
+				<< simplificationTimer.getTime() * 1000.0 << " ms" << std::endl;
+
+		std::vector<size_t> triangles = LODGenerator::countTriangles(
+				node.get(), numLevels);
+		for (int level = 0; level < numLevels; ++level) {
+			std::cout << "  Level " << level << ": " << triangles[level]
+					<< " triangles" << std::endl;
+		}
+	}
+
+	return 0;
+} // end main()
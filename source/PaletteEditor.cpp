@@ -39,6 +39,17 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 Methods of class PaletteEditor:
 ******************************/
 
+double PaletteEditor::calcDisplayValue(double controlPointValue) const
+	{
+	if(quantizer.getMode()==ScalarQuantizer::LINEAR)
+		return controlPointValue;
+	
+	/* Control point values index quantization levels linearly across the color map's value range: */
+	const ValueRange& valueRange=colorMap->getValueRange();
+	double level=valueRange.second>valueRange.first?(controlPointValue-valueRange.first)/(valueRange.second-valueRange.first):0.0;
+	return quantizer.unmap(level);
+	}
+
 void PaletteEditor::selectedControlPointChangedCallback(Misc::CallbackData* cbData)
 	{
 	GLMotif::ColorMap::SelectedControlPointChangedCallbackData* cbData2=static_cast<GLMotif::ColorMap::SelectedControlPointChangedCallbackData*>(cbData);
@@ -46,7 +57,7 @@ void PaletteEditor::selectedControlPointChangedCallback(Misc::CallbackData* cbDa
 	if(cbData2->newSelectedControlPoint!=0)
 		{
 		/* Copy the selected control point's data and color value to the color editor: */
-		controlPointValue->setValue(colorMap->getSelectedControlPointValue());
+		controlPointValue->setValue(calcDisplayValue(colorMap->getSelectedControlPointValue()));
 		GLMotif::ColorMap::ColorMapValue colorValue=colorMap->getSelectedControlPointColorValue();
 		colorPanel->setBackgroundColor(colorValue);
 		for(int i=0;i<4;++i)
@@ -66,7 +77,7 @@ void PaletteEditor::colorMapChangedCallback(Misc::CallbackData* cbData)
 	if(colorMap->hasSelectedControlPoint())
 		{
 		/* Copy the updated value of the selected control point to the color editor: */
-		controlPointValue->setValue(colorMap->getSelectedControlPointValue());
+		controlPointValue->setValue(calcDisplayValue(colorMap->getSelectedControlPointValue()));
 		colorSliders[3]->setValue(colorMap->getSelectedControlPointColorValue()[3]);
 		}
 	}
@@ -233,3 +244,12 @@ void PaletteEditor::exportColorMap(GLColorMap& glColorMap) const
 	/* Update the color map's value range: */
 	glColorMap.setScalarRange(colorMap->getValueRange().first,colorMap->getValueRange().second);
 	}
+
+void PaletteEditor::setQuantizer(const ScalarQuantizer& newQuantizer)
+	{
+	quantizer=newQuantizer;
+	
+	/* Update the displayed value of the selected control point: */
+	if(colorMap->hasSelectedControlPoint())
+		controlPointValue->setValue(calcDisplayValue(colorMap->getSelectedControlPointValue()));
+	}
@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <GLMotif/PopupWindow.h>
 
 #include "ColorMap.h"
+#include "ScalarQuantizer.h"
 
 /* Forward declarations: */
 namespace Misc {
@@ -67,8 +68,10 @@ class PaletteEditor:public GLMotif::PopupWindow
 	GLMotif::Blind* colorPanel; // The control point color display widget
 	GLMotif::Slider* colorSliders[4]; // The color selection slider widgets (R, G, B, alpha)
 	Misc::CallbackList savePaletteCallbacks; // List of callbacks called when the "Save Palette" button is pressed
+	ScalarQuantizer quantizer; // Quantizer mapping color map positions back to data values for display
 	
 	/* Private methods: */
+	double calcDisplayValue(double controlPointValue) const; // Returns the data value represented by the given control point value
 	void selectedControlPointChangedCallback(Misc::CallbackData* cbData);
 	void colorMapChangedCallback(Misc::CallbackData* cbData);
 	void colorSliderValueChangedCallback(Misc::CallbackData* cbData);
@@ -103,6 +106,11 @@ class PaletteEditor:public GLMotif::PopupWindow
 		return savePaletteCallbacks;
 		}
 	void exportColorMap(GLColorMap& glColorMap) const; // Exports color map to GLColorMap object
+	const ScalarQuantizer& getQuantizer(void) const // Returns the quantizer used to display data values
+		{
+		return quantizer;
+		}
+	void setQuantizer(const ScalarQuantizer& newQuantizer); // Displays control point values through the given quantizer's inverse mapping
 	};
 
 #endif
@@ -0,0 +1,243 @@
+/*
+ * Description: ParserBenchmark.cpp - Measures how long parsing the result
+ * block of a large synthetic MCNP mesh tally takes with the parallel
+ * MCNPResultParser, and with the getline and sscanf loop the MCNP modules
+ * used before, checking that both produce the same grid, without opening
+ * a window
+ * Author: Patrick O'Leary
+ * Date: May 24, 2010
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <math.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <Misc/Timer.h>
+
+#include <Concrete/MCNPResultParser.h>
+
+typedef Visualization::Concrete::MCNPResultParser MCNPResultParser;
+typedef MCNPResultParser::Index Index;
+
+/*
+ * writeTally - Writes a synthetic mesh tally result block with one row per
+ * grid vertex, K varying fastest, each row holding the vertex' x, y, z
+ * coordinates followed by a flux value and its relative error. Returns
+ * false if the file cannot be written.
+ *
+ * parameter fileName - const char *
+ * parameter numVertices - const Index &
+ * return - bool
+ */
+static bool writeTally(const char * fileName, const Index & numVertices) {
+	FILE * file = fopen(fileName, "w");
+	if (file == 0) {
+		return false;
+	}
+	for (int i = 0; i < numVertices[0]; ++i) {
+		double x = -100.0 + 0.25 * double(i);
+		for (int j = 0; j < numVertices[1]; ++j) {
+			double y = -50.0 + 0.5 * double(j);
+			for (int k = 0; k < numVertices[2]; ++k) {
+				double z = -25.0 + 0.125 * double(k);
+				double r2 = (x * x + y * y + z * z) * 1.0e-4;
+				double flux = 3.0e-4 * exp(-r2) * (1.5 + sin(x * 0.1 + z
+						* 0.3));
+				double error = 0.01 + 0.2 * r2 / (1.0 + r2);
+				fprintf(file, "%10.3f %10.3f %10.3f %12.5E %12.5E\n", x, y, z,
+						flux, error);
+			}
+		}
+	}
+	return fclose(file) == 0;
+} // end writeTally()
+
+/*
+ * parseWithSscanf - Parses the result block the way the MCNP modules did
+ * before the parallel parser, reading each row with getline and sscanf,
+ * and stores the coordinates along each grid axis and the values in the
+ * given slices. Returns false on a missing or malformed row.
+ *
+ * parameter fileName - const char *
+ * parameter numVertices - const Index &
+ * parameter vertexCoordinates - float * const *
+ * parameter slices - float * const *
+ * return - bool
+ */
+static bool parseWithSscanf(const char * fileName, const Index & numVertices,
+		float * const * vertexCoordinates, float * const * slices) {
+	std::ifstream file(fileName);
+	std::string line;
+	size_t row = 0;
+	for (int i = 0; i < numVertices[0]; ++i) {
+		for (int j = 0; j < numVertices[1]; ++j) {
+			for (int k = 0; k < numVertices[2]; ++k, ++row) {
+				double pos[3], flux, relativeError;
+				if (!std::getline(file, line) || sscanf(line.c_str(),
+						"%lf %lf %lf %lf %lf", &pos[0], &pos[1], &pos[2],
+						&flux, &relativeError) != 5) {
+					return false;
+				}
+				if (j == 0 && k == 0) {
+					vertexCoordinates[0][i] = float(pos[0]);
+				}
+				if (i == 0 && k == 0) {
+					vertexCoordinates[1][j] = float(pos[1]);
+				}
+				if (i == 0 && j == 0) {
+					vertexCoordinates[2][k] = float(pos[2]);
+				}
+				slices[0][row] = float(flux);
+				slices[1][row] = float(relativeError);
+			}
+		}
+	}
+	return true;
+} // end parseWithSscanf()
+
+/*
+ * countMismatches - Returns the number of coordinates and values that
+ * differ between the two parsed grids.
+ *
+ * parameter numVertices - const Index &
+ * parameter coordinates0 - const std::vector<float> *
+ * parameter slices0 - const std::vector<float> *
+ * parameter coordinates1 - const std::vector<float> *
+ * parameter slices1 - const std::vector<float> *
+ * return - size_t
+ */
+static size_t countMismatches(const Index & numVertices,
+		const std::vector<float> * coordinates0,
+		const std::vector<float> * slices0,
+		const std::vector<float> * coordinates1,
+		const std::vector<float> * slices1) {
+	size_t numMismatches = 0;
+	for (int axis = 0; axis < 3; ++axis) {
+		for (int i = 0; i < numVertices[axis]; ++i) {
+			if (coordinates0[axis][i] != coordinates1[axis][i]) {
+				++numMismatches;
+			}
+		}
+	}
+	for (int slice = 0; slice < 2; ++slice) {
+		for (size_t i = 0; i < slices0[slice].size(); ++i) {
+			if (slices0[slice][i] != slices1[slice][i]) {
+				++numMismatches;
+			}
+		}
+	}
+	return numMismatches;
+} // end countMismatches()
+
+/*
+ * main
+ *
+ * parameter argc - int
+ * parameter argv - char**
+ * return - int
+ */
+int main(int argc, char** argv) {
+	/* Parse the command line: */
+	size_t numLines = 50000000;
+	const char * fileName = "ParserBenchmark.meshtal";
+	bool keepFile = false;
+	long numCpus = sysconf(_SC_NPROCESSORS_ONLN);
+	int maxNumThreads = numCpus < 1 ? 1 : int(numCpus);
+	for (int i = 1; i < argc; ++i) {
+		if (strcasecmp(argv[i], "-lines") == 0 && i + 1 < argc) {
+			numLines = size_t(atof(argv[++i]));
+		} else if (strcasecmp(argv[i], "-file") == 0 && i + 1 < argc) {
+			fileName = argv[++i];
+		} else if (strcasecmp(argv[i], "-keep") == 0) {
+			keepFile = true;
+		} else if (strcasecmp(argv[i], "-threads") == 0 && i + 1 < argc) {
+			maxNumThreads = atoi(argv[++i]);
+		}
+	}
+
+	/* Lay out a grid of roughly the requested number of rows: */
+	Index numVertices(1, 200, 250);
+	numVertices[0] = int((numLines + size_t(numVertices[1] * numVertices[2])
+			/ 2) / size_t(numVertices[1] * numVertices[2]));
+	if (numVertices[0] < 1) {
+		numVertices[0] = 1;
+	}
+	size_t numRows = size_t(numVertices.calcIncrement(-1));
+
+	/* Write the synthetic tally: */
+	Misc::Timer writeTimer;
+	if (!writeTally(fileName, numVertices)) {
+		std::cerr << "Unable to write " << fileName << std::endl;
+		return 1;
+	}
+	writeTimer.elapse();
+	std::cout << numVertices[0] << "x" << numVertices[1] << "x"
+			<< numVertices[2] << " grid, " << numRows << " rows, written to "
+			<< fileName << " in " << writeTimer.getTime() << " s" << std::endl;
+
+	/* Parse the tally with getline and sscanf: */
+	std::vector<float> oldCoordinates[3], oldSlices[2];
+	std::vector<float> newCoordinates[3], newSlices[2];
+	float * oldCoordinatePtrs[3], *newCoordinatePtrs[3];
+	float * oldSlicePtrs[2], *newSlicePtrs[2];
+	for (int axis = 0; axis < 3; ++axis) {
+		oldCoordinates[axis].resize(numVertices[axis]);
+		newCoordinates[axis].resize(numVertices[axis]);
+		oldCoordinatePtrs[axis] = &oldCoordinates[axis][0];
+		newCoordinatePtrs[axis] = &newCoordinates[axis][0];
+	}
+	for (int slice = 0; slice < 2; ++slice) {
+		oldSlices[slice].resize(numRows);
+		newSlices[slice].resize(numRows);
+		oldSlicePtrs[slice] = &oldSlices[slice][0];
+		newSlicePtrs[slice] = &newSlices[slice][0];
+	}
+	Misc::Timer sscanfTimer;
+	bool sscanfOk = parseWithSscanf(fileName, numVertices, oldCoordinatePtrs,
+			oldSlicePtrs);
+	sscanfTimer.elapse();
+	std::cout << "  getline and sscanf: " << sscanfTimer.getTime() << " s"
+			<< (sscanfOk ? "" : " (malformed tally)") << std::endl;
+
+	/* Parse the tally with 1, 2, 4, ... threads; mapping the file is part of the parse time: */
+	size_t numErrors = sscanfOk ? 0 : 1;
+	for (int numThreads = 1;; numThreads *= 2) {
+		if (numThreads > maxNumThreads) {
+			numThreads = maxNumThreads;
+		}
+		Misc::Timer parseTimer;
+		try {
+			MCNPResultParser parser(fileName);
+			parser.parseResultBlock(parser.getFileStart(), numVertices, 2,
+					newCoordinatePtrs, newSlicePtrs, numThreads);
+		} catch (std::runtime_error err) {
+			std::cerr << "  " << err.what() << std::endl;
+			++numErrors;
+			break;
+		}
+		parseTimer.elapse();
+		size_t numMismatches = countMismatches(numVertices, oldCoordinates,
+				oldSlices, newCoordinates, newSlices);
+		numErrors += numMismatches;
+		std::cout << "  MCNPResultParser with " << numThreads << " threads: "
+				<< parseTimer.getTime() << " s, speed-up "
+				<< sscanfTimer.getTime() / parseTimer.getTime() << ", "
+				<< numMismatches << " mismatches" << std::endl;
+		if (numThreads == maxNumThreads) {
+			break;
+		}
+	}
+
+	if (!keepFile) {
+		unlink(fileName);
+	}
+
+	return numErrors == 0 ? 0 : 1;
+} // end main()
@@ -22,6 +22,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <Raycaster.h>
 
+#include <algorithm>
+#include <utility>
 #include <Misc/ThrowStdErr.h>
 #include <Math/Math.h>
 #include <Geometry/Vector.h>
@@ -141,32 +143,21 @@ Methods of class Raycaster:
 
 void Raycaster::initDataItem(Raycaster::DataItem* dataItem) const
 	{
-	/* Calculate the appropriate volume texture's size: */
-	if(dataItem->hasNPOTDTextures)
-		{
-		/* Use the data size directly: */
-		for(int i=0;i<3;++i)
-			dataItem->textureSize[i]=dataSize[i];
-		}
-	else
-		{
-		/* Pad to the next power of two: */
-		for(int i=0;i<3;++i)
-			for(dataItem->textureSize[i]=1;dataItem->textureSize[i]<GLsizei(dataSize[i]);dataItem->textureSize[i]<<=1)
-				;
-		}
+	/* Check that each brick fits into a single 3D texture: */
+	GLint max3DTextureSize;
+	glGetIntegerv(GL_MAX_3D_TEXTURE_SIZE,&max3DTextureSize);
+	if(GLint(maxBrickSize)>max3DTextureSize)
+		Misc::throwStdErr("Raycaster::initDataItem: Brick size %u exceeds local OpenGL's maximum 3D texture size %d",maxBrickSize,int(max3DTextureSize));
 	
-	/* Calculate the texture coordinate box for trilinear interpolation and the transformation from model space to data space: */
-	Point tcMin,tcMax;
-	for(int i=0;i<3;++i)
+	dataItem->brickItems.resize(bricks.size());
+	for(size_t brickIndex=0;brickIndex<bricks.size();++brickIndex)
 		{
-		tcMin[i]=Scalar(0.5)/Scalar(dataItem->textureSize[i]);
-		tcMax[i]=(Scalar(dataSize[i])-Scalar(0.5))/Scalar(dataItem->textureSize[i]);
-		Scalar scale=(tcMax[i]-tcMin[i])/domain.getSize(i);
-		dataItem->mcScale[i]=GLfloat(scale);
-		dataItem->mcOffset[i]=GLfloat(tcMin[i]-domain.min[i]*scale);
+		const Brick& brick=bricks[brickIndex];
+		DataItem::BrickItem& brickItem=dataItem->brickItems[brickIndex];
+		
+		/* Calculate the brick's volume texture size and texture coordinate mapping: */
+		calcBrickTextureMapping(int(brickIndex),!dataItem->hasNPOTDTextures,brickItem.textureSize,brickItem.mcScale,brickItem.mcOffset,brickItem.texCoords);
 		}
-	dataItem->texCoords=Box(tcMin,tcMax);
 	}
 
 void Raycaster::initShader(Raycaster::DataItem* dataItem) const
@@ -185,10 +176,6 @@ void Raycaster::initShader(Raycaster::DataItem* dataItem) const
 
 void Raycaster::bindShader(const Raycaster::PTransform& pmv,const Raycaster::PTransform& mv,Raycaster::DataItem* dataItem) const
 	{
-	/* Set up the data space transformation: */
-	glUniform3fvARB(dataItem->mcScaleLoc,1,dataItem->mcScale);
-	glUniform3fvARB(dataItem->mcOffsetLoc,1,dataItem->mcOffset);
-	
 	/* Bind the ray termination texture: */
 	glActiveTextureARB(GL_TEXTURE0_ARB);
 	glBindTexture(GL_TEXTURE_2D,dataItem->depthTextureID);
@@ -197,9 +184,6 @@ void Raycaster::bindShader(const Raycaster::PTransform& pmv,const Raycaster::PTr
 	/* Set the termination matrix: */
 	glUniformMatrix4fvARB(dataItem->depthMatrixLoc,1,GL_TRUE,pmv.getMatrix().getEntries());
 	
-	/* Set the depth texture size: */
-	glUniform2fARB(dataItem->depthSizeLoc,float(dataItem->depthTextureSize[0]),float(dataItem->depthTextureSize[1]));
-	
 	/* Calculate the eye position in model coordinates: */
 	Point eye=pmv.inverseTransform(PTransform::HVector(0,0,1,0)).toPoint();
 	glUniform3fvARB(dataItem->eyePositionLoc,1,eye.getComponents());
@@ -208,6 +192,17 @@ void Raycaster::bindShader(const Raycaster::PTransform& pmv,const Raycaster::PTr
 	glUniform1fARB(dataItem->stepSizeLoc,stepSize*cellSize);
 	}
 
+void Raycaster::bindBrick(int brickIndex,Raycaster::DataItem* dataItem) const
+	{
+	/* Set up the brick's data space transformation: */
+	const DataItem::BrickItem& brickItem=dataItem->brickItems[brickIndex];
+	glUniform3fvARB(dataItem->mcScaleLoc,1,brickItem.mcScale);
+	glUniform3fvARB(dataItem->mcOffsetLoc,1,brickItem.mcOffset);
+	
+	/* Set the depth texture size, which is current after the brick's ray termination pass: */
+	glUniform2fARB(dataItem->depthSizeLoc,float(dataItem->depthTextureSize[0]),float(dataItem->depthTextureSize[1]));
+	}
+
 void Raycaster::unbindShader(Raycaster::DataItem* dataItem) const
 	{
 	/* Unbind the ray termination texture: */
@@ -215,7 +210,23 @@ void Raycaster::unbindShader(Raycaster::DataItem* dataItem) const
 	glBindTexture(GL_TEXTURE_2D,0);
 	}
 
-Polyhedron<Raycaster::Scalar>* Raycaster::clipDomain(const Raycaster::PTransform& pmv,const Raycaster::PTransform& mv) const
+void Raycaster::uploadBrick(int brickIndex,GLenum format,GLenum type,const GLvoid* brickData) const
+	{
+	const Brick& brick=bricks[brickIndex];
+	
+	/* Select the brick's voxels from the volume data: */
+	glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+	glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH,dataSize[0]);
+	glPixelStorei(GL_UNPACK_IMAGE_HEIGHT_EXT,dataSize[1]);
+	
+	/* Upload the brick's voxels: */
+	glTexSubImage3DEXT(GL_TEXTURE_3D,0,0,0,0,brick.size[0],brick.size[1],brick.size[2],format,type,brickData);
+	
+	glPopClientAttrib();
+	}
+
+Polyhedron<Raycaster::Scalar>* Raycaster::clipDomain(const Polyhedron<Raycaster::Scalar>& renderDomain,const Raycaster::PTransform& pmv,const Raycaster::PTransform& mv) const
 	{
 	/* Clip the render domain against the view frustum's front plane: */
 	Point fv0=pmv.inverseTransform(Point(-1,-1,-1));
@@ -255,9 +266,48 @@ Polyhedron<Raycaster::Scalar>* Raycaster::clipDomain(const Raycaster::PTransform
 	return clippedDomain;
 	}
 
-Raycaster::Raycaster(const unsigned int sDataSize[3],const Raycaster::Box& sDomain)
+void Raycaster::calcBrickOrder(const Raycaster::Point& eye,std::vector<int>& brickOrder) const
+	{
+	/* Sort the bricks along each axis by decreasing distance from the eye: */
+	std::vector<int> axisOrders[3];
+	for(int i=0;i<3;++i)
+		{
+		std::vector<std::pair<Scalar,int> > distances;
+		for(unsigned int b=0;b<numBricks[i];++b)
+			{
+			/* Get the brick's extent along the axis from any brick in its slab: */
+			int brickIndex=int(b);
+			for(int j=0;j<i;++j)
+				brickIndex*=int(numBricks[j]);
+			const Box& brickDomain=bricks[brickIndex].domain;
+			Scalar dist(0);
+			if(eye[i]<brickDomain.min[i])
+				dist=brickDomain.min[i]-eye[i];
+			else if(eye[i]>brickDomain.max[i])
+				dist=eye[i]-brickDomain.max[i];
+			distances.push_back(std::make_pair(-dist,int(b)));
+			}
+		std::sort(distances.begin(),distances.end());
+		for(unsigned int b=0;b<numBricks[i];++b)
+			axisOrders[i].push_back(distances[b].second);
+		}
+	
+	/*********************************************************************
+	Any order that visits the bricks of each axis from far to near is a
+	valid back-to-front order for an axis-aligned grid of bricks, so the
+	three axis orders can simply be nested.
+	*********************************************************************/
+	
+	brickOrder.clear();
+	for(unsigned int z=0;z<numBricks[2];++z)
+		for(unsigned int y=0;y<numBricks[1];++y)
+			for(unsigned int x=0;x<numBricks[0];++x)
+				brickOrder.push_back((axisOrders[2][z]*int(numBricks[1])+axisOrders[1][y])*int(numBricks[0])+axisOrders[0][x]);
+	}
+
+Raycaster::Raycaster(const unsigned int sDataSize[3],const Raycaster::Box& sDomain,unsigned int sMaxBrickSize)
 	:domain(sDomain),domainExtent(0),cellSize(0),
-	 renderDomain(Polyhedron<Scalar>::Point(domain.min),Polyhedron<Scalar>::Point(domain.max)),
+	 maxBrickSize(sMaxBrickSize),
 	 stepSize(1)
 	{
 	/* Copy the data sizes and calculate the data strides and cell size: */
@@ -272,12 +322,76 @@ Raycaster::Raycaster(const unsigned int sDataSize[3],const Raycaster::Box& sDoma
 		}
 	domainExtent=Math::sqrt(domainExtent);
 	cellSize=Math::sqrt(cellSize);
+	
+	/* Split the data into the smallest number of evenly sized bricks along each axis: */
+	if(maxBrickSize<2)
+		Misc::throwStdErr("Raycaster::Raycaster: Invalid maximum brick size %u",maxBrickSize);
+	std::vector<unsigned int> brickStarts[3];
+	for(int i=0;i<3;++i)
+		{
+		/* Adjacent bricks share their boundary voxels, so that trilinear interpolation is seamless across bricks: */
+		unsigned int numCells=dataSize[i]-1;
+		numBricks[i]=(numCells+maxBrickSize-2)/(maxBrickSize-1);
+		for(unsigned int b=0;b<=numBricks[i];++b)
+			brickStarts[i].push_back((unsigned int)((unsigned long long)(numCells)*b/numBricks[i]));
+		}
+	bricks.resize(numBricks[0]*numBricks[1]*numBricks[2]);
+	std::vector<Brick>::iterator bIt=bricks.begin();
+	for(unsigned int z=0;z<numBricks[2];++z)
+		for(unsigned int y=0;y<numBricks[1];++y)
+			for(unsigned int x=0;x<numBricks[0];++x,++bIt)
+				{
+				unsigned int index[3]={x,y,z};
+				Point min,max;
+				for(int i=0;i<3;++i)
+					{
+					bIt->origin[i]=brickStarts[i][index[i]];
+					bIt->size[i]=brickStarts[i][index[i]+1]-brickStarts[i][index[i]]+1;
+					Scalar voxelSize=(domain.max[i]-domain.min[i])/Scalar(dataSize[i]-1);
+					min[i]=domain.min[i]+Scalar(bIt->origin[i])*voxelSize;
+					max[i]=index[i]+1<numBricks[i]?domain.min[i]+Scalar(bIt->origin[i]+bIt->size[i]-1)*voxelSize:domain.max[i];
+					}
+				bIt->domain=Box(min,max);
+				bIt->renderDomain=Polyhedron<Scalar>(Polyhedron<Scalar>::Point(min),Polyhedron<Scalar>::Point(max));
+				}
 	}
 
 Raycaster::~Raycaster(void)
 	{
 	}
 
+void Raycaster::calcBrickTextureMapping(int brickIndex,bool padToPowerOfTwo,GLsizei textureSize[3],GLfloat mcScale[3],GLfloat mcOffset[3],Raycaster::Box& texCoords) const
+	{
+	const Brick& brick=bricks[brickIndex];
+	
+	/* Calculate the appropriate volume texture's size: */
+	if(padToPowerOfTwo)
+		{
+		/* Pad to the next power of two: */
+		for(int i=0;i<3;++i)
+			for(textureSize[i]=1;textureSize[i]<GLsizei(brick.size[i]);textureSize[i]<<=1)
+				;
+		}
+	else
+		{
+		/* Use the brick size directly: */
+		for(int i=0;i<3;++i)
+			textureSize[i]=brick.size[i];
+		}
+	
+	/* Calculate the texture coordinate box for trilinear interpolation and the transformation from model space to the brick's data space: */
+	Point tcMin,tcMax;
+	for(int i=0;i<3;++i)
+		{
+		tcMin[i]=Scalar(0.5)/Scalar(textureSize[i]);
+		tcMax[i]=(Scalar(brick.size[i])-Scalar(0.5))/Scalar(textureSize[i]);
+		Scalar scale=(tcMax[i]-tcMin[i])/brick.domain.getSize(i);
+		mcScale[i]=GLfloat(scale);
+		mcOffset[i]=GLfloat(tcMin[i]-brick.domain.min[i]*scale);
+		}
+	texCoords=Box(tcMin,tcMax);
+	}
+
 void Raycaster::setStepSize(Raycaster::Scalar newStepSize)
 	{
 	/* Set the new step size: */
@@ -292,49 +406,61 @@ void Raycaster::glRenderAction(GLContextData& contextData) const
 	/* Save OpenGL state: */
 	glPushAttrib(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT|GL_ENABLE_BIT|GL_LIGHTING_BIT|GL_POLYGON_BIT);
 	
-	/* Initialize the ray termination depth frame buffer: */
-	dataItem->initDepthBuffer();
-	
-	/* Bind the ray termination framebuffer: */
-	GLint currentFramebuffer;
-	glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT,&currentFramebuffer);
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT,dataItem->depthFramebufferID);
-	
 	/* Get the projection and modelview matrices: */
 	PTransform mv=glGetModelviewMatrix<Scalar>();
 	PTransform pmv=glGetProjectionMatrix<Scalar>();
 	pmv*=mv;
 	
-	/* Clip the render domain against the view frustum's front plane and all clipping planes: */
-	Polyhedron<Scalar>* clippedDomain=clipDomain(pmv,mv);
-	
-	/* Draw the clipped domain's back faces to the depth buffer as ray termination conditions: */
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_FRONT);
-	clippedDomain->drawFaces();
-	
-	/* Unbind the depth framebuffer: */
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT,currentFramebuffer);
+	/* Sort the bricks back-to-front: */
+	Point eye=pmv.inverseTransform(PTransform::HVector(0,0,1,0)).toPoint();
+	std::vector<int> brickOrder;
+	calcBrickOrder(eye,brickOrder);
 	
 	/* Install the GLSL shader program: */
 	dataItem->shader.useProgram();
 	bindShader(pmv,mv,dataItem);
 	
-	/* Draw the clipped domain's front faces: */
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_ONE,GL_ONE_MINUS_SRC_ALPHA);
-	glDepthMask(GL_FALSE);
-	glCullFace(GL_BACK);
-	if(clippedDomain!=0)
+	glEnable(GL_CULL_FACE);
+	for(std::vector<int>::const_iterator boIt=brickOrder.begin();boIt!=brickOrder.end();++boIt)
+		{
+		/* Clip the brick's render domain against the view frustum's front plane and all clipping planes: */
+		Polyhedron<Scalar>* clippedDomain=clipDomain(bricks[*boIt].renderDomain,pmv,mv);
+		
+		/* Initialize the ray termination depth frame buffer: */
+		GLShader::disablePrograms();
+		dataItem->initDepthBuffer();
+		
+		/* Bind the ray termination framebuffer: */
+		GLint currentFramebuffer;
+		glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT,&currentFramebuffer);
+		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT,dataItem->depthFramebufferID);
+		
+		/* Draw the clipped brick's back faces to the depth buffer as ray termination conditions: */
+		glDepthMask(GL_TRUE);
+		glCullFace(GL_FRONT);
 		clippedDomain->drawFaces();
+		
+		/* Unbind the depth framebuffer: */
+		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT,currentFramebuffer);
+		
+		/* Draw the clipped brick's front faces: */
+		dataItem->shader.useProgram();
+		bindBrick(*boIt,dataItem);
+		glDepthMask(GL_FALSE);
+		glCullFace(GL_BACK);
+		if(clippedDomain!=0)
+			clippedDomain->drawFaces();
+		
+		/* Clean up: */
+		delete clippedDomain;
+		}
 	
 	/* Uninstall the GLSL shader program: */
 	unbindShader(dataItem);
 	GLShader::disablePrograms();
 	
-	/* Clean up: */
-	delete clippedDomain;
-	
 	/* Restore OpenGL state: */
 	glPopAttrib();
 	}
@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef RAYCASTER_INCLUDED
 #define RAYCASTER_INCLUDED
 
+#include <vector>
 #include <Geometry/Point.h>
 #include <Geometry/Box.h>
 #include <Geometry/Plane.h>
@@ -43,16 +44,34 @@ class Raycaster:public GLObject
 	typedef Geometry::Plane<Scalar,3> Plane;
 	typedef Geometry::ProjectiveTransformation<Scalar,3> PTransform;
 	
+	struct Brick // Structure describing a brick of the volume data that is uploaded into its own texture
+		{
+		/* Elements: */
+		public:
+		unsigned int origin[3]; // Index of the brick's first voxel in the volume data
+		unsigned int size[3]; // Number of voxels in the brick; adjacent bricks share one layer of voxels
+		Box domain; // The brick's domain box in model space
+		Polyhedron<Scalar> renderDomain; // Polyhedron used to render the clipped brick
+		};
+	
 	protected:
 	struct DataItem:public GLObject::DataItem // Structure containing per-context state
 		{
-		/* Elements: */
+		/* Embedded classes: */
 		public:
+		struct BrickItem // Structure containing per-context state of a volume brick
+			{
+			/* Elements: */
+			public:
+			GLsizei textureSize[3]; // Size of the texture able to hold the brick's volume data
+			Box texCoords; // Domain of texture coordinates to access the brick's volume data
+			GLfloat mcScale[3],mcOffset[3]; // Scale factors and offsets from model space to the brick's data space
+			};
+		
+		/* Elements: */
 		bool hasNPOTDTextures; // Flag whether the local OpenGL supports non-power of two textures
 		
-		GLsizei textureSize[3]; // Size of textures able to hold the volume data
-		Box texCoords; // Domain of texture coordinates to access the volume data
-		GLfloat mcScale[3],mcOffset[3]; // Scale factors and offsets from model space to data space
+		std::vector<BrickItem> brickItems; // Per-context state of all volume bricks
 		
 		GLuint depthTextureID; // Texture object ID of the depth texture used for ray termination
 		GLuint depthFramebufferID; // Framebuffer object ID to render to the ray termination buffer
@@ -82,7 +101,9 @@ class Raycaster:public GLObject
 	Box domain; // The volume renderer's domain box in model space
 	Scalar domainExtent; // Length of longest ray through domain
 	Scalar cellSize; // The data set's cell size
-	Polyhedron<Scalar> renderDomain; // Polyhedron used to render the clipped data set
+	unsigned int maxBrickSize; // Maximum number of voxels of a brick along each axis
+	unsigned int numBricks[3]; // Number of bricks along each axis
+	std::vector<Brick> bricks; // The volume data's bricks, with the x index varying fastest
 	
 	Scalar stepSize; // The ray casting step size in cell size units
 	
@@ -91,12 +112,15 @@ class Raycaster:public GLObject
 	virtual void initDataItem(DataItem* dataItem) const; // Initializes the given context data item
 	virtual void initShader(DataItem* dataItem) const; // Initializes the GLSL raycasting shader
 	virtual void bindShader(const PTransform& pmv,const PTransform& mv,DataItem* dataItem) const; // Prepares the GLSL raycasting shader for rendering
+	virtual void bindBrick(int brickIndex,DataItem* dataItem) const; // Prepares the GLSL raycasting shader for rendering the given brick
 	virtual void unbindShader(DataItem* dataItem) const; // Unbinds the GLSL raycasting shader after rendering
-	Polyhedron<Scalar>* clipDomain(const PTransform& pmv,const PTransform& mv) const; // Clips the domain against the view frustum and all clipping planes and returns the resulting polyhedron
+	void uploadBrick(int brickIndex,GLenum format,GLenum type,const GLvoid* brickData) const; // Uploads the given brick's voxels, starting at the given brick data pointer, into the currently bound 3D texture
+	Polyhedron<Scalar>* clipDomain(const Polyhedron<Scalar>& renderDomain,const PTransform& pmv,const PTransform& mv) const; // Clips the given domain against the view frustum and all clipping planes and returns the resulting polyhedron
+	void calcBrickOrder(const Point& eye,std::vector<int>& brickOrder) const; // Returns the indices of all bricks in back-to-front order as seen from the given eye position
 	
 	/* Constructors and destructors: */
 	public:
-	Raycaster(const unsigned int sDataSize[3],const Box& sDomain); // Creates a raycaster for the given data and domain sizes
+	Raycaster(const unsigned int sDataSize[3],const Box& sDomain,unsigned int sMaxBrickSize =512); // Creates a raycaster for the given data and domain sizes, splitting the data into bricks of at most the given size
 	virtual ~Raycaster(void); // Destroys the raycaster
 	
 	/* New methods: */
@@ -124,6 +148,19 @@ class Raycaster:public GLObject
 		{
 		return cellSize;
 		}
+	unsigned int getMaxBrickSize(void) const // Returns the maximum number of voxels of a brick along each axis
+		{
+		return maxBrickSize;
+		}
+	const unsigned int* getNumBricks(void) const // Returns the number of bricks along each axis
+		{
+		return numBricks;
+		}
+	const std::vector<Brick>& getBricks(void) const // Returns the volume data's bricks
+		{
+		return bricks;
+		}
+	void calcBrickTextureMapping(int brickIndex,bool padToPowerOfTwo,GLsizei textureSize[3],GLfloat mcScale[3],GLfloat mcOffset[3],Box& texCoords) const; // Calculates the size of the given brick's volume texture, the transformation from model space to its texture coordinates, and its texture coordinate box
 	Scalar getStepSize(void) const // Returns the raycaster's step size in cell size units
 		{
 		return stepSize;
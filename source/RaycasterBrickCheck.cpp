@@ -0,0 +1,376 @@
+/*
+ * Description: RaycasterBrickCheck.cpp - Checks that splitting a volume
+ * into raycaster bricks is seamless, by sampling every brick's volume
+ * texture the way OpenGL's trilinear interpolation does, both with and
+ * without padding to power-of-two sizes, at and near the voxel layers
+ * shared by adjacent bricks, and comparing the results against trilinear
+ * interpolation of the unbricked volume, without opening a window
+ * Author: Patrick O'Leary
+ * Date: June 1, 2010
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <iostream>
+#include <vector>
+
+#include <SingleChannelRaycaster.h>
+
+typedef SingleChannelRaycaster::Scalar Scalar;
+typedef SingleChannelRaycaster::Point Point;
+typedef SingleChannelRaycaster::Box Box;
+typedef SingleChannelRaycaster::Brick Brick;
+typedef SingleChannelRaycaster::Voxel Voxel;
+
+/*
+ * calcValue - Returns the check's voxel value, a set of nested wavy shells
+ * fading out towards the corners of the volume, at the given position in
+ * the unit cube.
+ *
+ * parameter u - double
+ * parameter v - double
+ * parameter w - double
+ * return - Voxel
+ */
+static Voxel calcValue(double u, double v, double w) {
+	double r = sqrt((u - 0.5) * (u - 0.5) + (v - 0.5) * (v - 0.5) + (w - 0.5)
+			* (w - 0.5));
+	double value = (0.5 + 0.5 * sin(20.0 * r)) * exp(-4.0 * r * r);
+	return Voxel(value * 65535.0 + 0.5);
+} // end calcValue()
+
+/*
+ * sampleVolume - Returns the trilinear interpolation of the given volume
+ * at the given voxel coordinates, clamped to the volume's extent.
+ *
+ * parameter data - const Voxel *
+ * parameter dataSize - const unsigned int *
+ * parameter dataStrides - const ptrdiff_t *
+ * parameter voxel - const double *
+ * return - double
+ */
+static double sampleVolume(const Voxel * data, const unsigned int * dataSize,
+		const ptrdiff_t * dataStrides, const double * voxel) {
+	int index[3];
+	double weight[3];
+	for (int i = 0; i < 3; ++i) {
+		double v = voxel[i] < 0.0 ? 0.0 : voxel[i] > double(dataSize[i] - 1)
+				? double(dataSize[i] - 1) : voxel[i];
+		index[i] = int(floor(v));
+		if (index[i] > int(dataSize[i]) - 2) {
+			index[i] = int(dataSize[i]) - 2;
+		}
+		weight[i] = v - double(index[i]);
+	}
+	double result = 0.0;
+	for (int corner = 0; corner < 8; ++corner) {
+		double w = 1.0;
+		ptrdiff_t offset = 0;
+		for (int i = 0; i < 3; ++i) {
+			int bit = (corner >> i) & 1;
+			w *= bit ? weight[i] : 1.0 - weight[i];
+			offset += ptrdiff_t(index[i] + bit) * dataStrides[i];
+		}
+		result += w * double(data[offset]);
+	}
+	return result;
+} // end sampleVolume()
+
+/*
+ * sampleTexture - Returns the value of the given 3D texture at the given
+ * texture coordinates, as looked up by OpenGL with GL_LINEAR filtering and
+ * GL_CLAMP wrapping, where texels outside the texture take on the border
+ * color of zero.
+ *
+ * parameter texels - const std::vector<double> &
+ * parameter textureSize - const GLsizei *
+ * parameter texCoord - const GLfloat *
+ * return - double
+ */
+static double sampleTexture(const std::vector<double> & texels,
+		const GLsizei * textureSize, const GLfloat * texCoord) {
+	int index[3];
+	double weight[3];
+	for (int i = 0; i < 3; ++i) {
+		double tc = texCoord[i] < 0.0f ? 0.0 : texCoord[i] > 1.0f ? 1.0
+				: double(texCoord[i]);
+		double u = tc * double(textureSize[i]) - 0.5;
+		index[i] = int(floor(u));
+		weight[i] = u - double(index[i]);
+	}
+	double result = 0.0;
+	for (int corner = 0; corner < 8; ++corner) {
+		double w = 1.0;
+		size_t offset = 0;
+		bool inside = true;
+		for (int i = 2; i >= 0; --i) {
+			int bit = (corner >> i) & 1;
+			int texel = index[i] + bit;
+			w *= bit ? weight[i] : 1.0 - weight[i];
+			if (texel < 0 || texel >= int(textureSize[i])) {
+				inside = false;
+			}
+			offset = offset * size_t(textureSize[i]) + size_t(texel);
+		}
+		if (inside) {
+			result += w * texels[offset];
+		}
+	}
+	return result;
+} // end sampleTexture()
+
+/*
+ * calcSamplePositions - Returns the voxel coordinates, relative to a
+ * brick's first voxel, at which to sample a brick of the given size along
+ * one axis: all voxel centers and cell midpoints, and additional positions
+ * inside the brick's first and last cells, next to the voxel layers it
+ * shares with its neighbors.
+ *
+ * parameter size - unsigned int
+ * return - std::vector<double>
+ */
+static std::vector<double> calcSamplePositions(unsigned int size) {
+	std::vector<double> positions;
+	for (unsigned int v = 0; v < size; ++v) {
+		positions.push_back(double(v));
+		if (v + 1 < size) {
+			positions.push_back(double(v) + 0.5);
+		}
+	}
+	double fractions[3] = { 0.01, 0.25, 0.99 };
+	for (int f = 0; f < 3; ++f) {
+		positions.push_back(fractions[f]);
+		positions.push_back(double(size - 2) + fractions[f]);
+	}
+	return positions;
+} // end calcSamplePositions()
+
+/*
+ * checkLayout - Returns the number of errors in the raycaster's brick
+ * layout: bricks that exceed the maximum brick size, that do not start
+ * on their predecessor's last voxel layer, whose domains do not meet
+ * their predecessor's, or that leave voxels at the end of the volume
+ * uncovered.
+ *
+ * parameter raycaster - const SingleChannelRaycaster &
+ * return - size_t
+ */
+static size_t checkLayout(const SingleChannelRaycaster & raycaster) {
+	const unsigned int * dataSize = raycaster.getDataSize();
+	const unsigned int * numBricks = raycaster.getNumBricks();
+	const std::vector<Brick> & bricks = raycaster.getBricks();
+	const Box & domain = raycaster.getDomain();
+	size_t numErrors = 0;
+	size_t brickIndex = 0;
+	for (unsigned int z = 0; z < numBricks[2]; ++z) {
+		for (unsigned int y = 0; y < numBricks[1]; ++y) {
+			for (unsigned int x = 0; x < numBricks[0]; ++x, ++brickIndex) {
+				unsigned int index[3] = { x, y, z };
+				size_t brickStride = 1;
+				for (int i = 0; i < 3; ++i) {
+					const Brick & brick = bricks[brickIndex];
+					if (brick.size[i] < 2 || brick.size[i]
+							> raycaster.getMaxBrickSize()) {
+						++numErrors;
+					}
+					if (index[i] == 0) {
+						if (brick.origin[i] != 0 || brick.domain.min[i]
+								!= domain.min[i]) {
+							++numErrors;
+						}
+					} else {
+						const Brick & pred = bricks[brickIndex - brickStride];
+						if (brick.origin[i] != pred.origin[i] + pred.size[i]
+								- 1 || brick.domain.min[i] != pred.domain.max[i]) {
+							++numErrors;
+						}
+					}
+					if (index[i] + 1 == numBricks[i]) {
+						if (brick.origin[i] + brick.size[i] != dataSize[i]
+								|| brick.domain.max[i] != domain.max[i]) {
+							++numErrors;
+						}
+					}
+					brickStride *= numBricks[i];
+				}
+			}
+		}
+	}
+	return numErrors;
+} // end checkLayout()
+
+/*
+ * checkBrick - Uploads the given brick into an emulated 3D texture,
+ * samples it through the raycaster's model-to-texture mapping at the
+ * brick's sample positions, and returns the number of samples that differ
+ * from the unbricked volume by more than the given tolerance. Updates the
+ * given maximum error and counts the given number of samples.
+ *
+ * parameter raycaster - const SingleChannelRaycaster &
+ * parameter brickIndex - int
+ * parameter padToPowerOfTwo - bool
+ * parameter tolerance - double
+ * parameter maxError - double &
+ * parameter numSamples - size_t &
+ * return - size_t
+ */
+static size_t checkBrick(const SingleChannelRaycaster & raycaster,
+		int brickIndex, bool padToPowerOfTwo, double tolerance,
+		double & maxError, size_t & numSamples) {
+	const Voxel * data = raycaster.getData();
+	const unsigned int * dataSize = raycaster.getDataSize();
+	const ptrdiff_t * dataStrides = raycaster.getDataStrides();
+	const Box & domain = raycaster.getDomain();
+	const Brick & brick = raycaster.getBricks()[brickIndex];
+
+	/* Calculate the brick's texture layout the way the raycaster does: */
+	GLsizei textureSize[3];
+	GLfloat mcScale[3], mcOffset[3];
+	Box texCoords;
+	raycaster.calcBrickTextureMapping(brickIndex, padToPowerOfTwo,
+			textureSize, mcScale, mcOffset, texCoords);
+
+	/* Copy the brick's voxels into the texture, and fill the padding with the largest voxel value so that any leaking texel shows up: */
+	std::vector<double> texels(size_t(textureSize[0])
+			* size_t(textureSize[1]) * size_t(textureSize[2]), 65535.0);
+	for (unsigned int z = 0; z < brick.size[2]; ++z) {
+		for (unsigned int y = 0; y < brick.size[1]; ++y) {
+			for (unsigned int x = 0; x < brick.size[0]; ++x) {
+				const Voxel * voxel = data + ptrdiff_t(brick.origin[0] + x)
+						* dataStrides[0] + ptrdiff_t(brick.origin[1] + y)
+						* dataStrides[1] + ptrdiff_t(brick.origin[2] + z)
+						* dataStrides[2];
+				texels[(size_t(z) * size_t(textureSize[1]) + size_t(y))
+						* size_t(textureSize[0]) + size_t(x)] = double(*voxel);
+			}
+		}
+	}
+
+	/* Sample the brick: */
+	std::vector<double> positions[3];
+	Scalar voxelSize[3];
+	for (int i = 0; i < 3; ++i) {
+		positions[i] = calcSamplePositions(brick.size[i]);
+		voxelSize[i] = (domain.max[i] - domain.min[i]) / Scalar(dataSize[i]
+				- 1);
+	}
+	size_t numErrors = 0;
+	for (size_t pz = 0; pz < positions[2].size(); ++pz) {
+		for (size_t py = 0; py < positions[1].size(); ++py) {
+			for (size_t px = 0; px < positions[0].size(); ++px) {
+				double local[3] = { positions[0][px], positions[1][py],
+						positions[2][pz] };
+
+				/* Calculate the sample's model-space position inside the brick's domain: */
+				Point p;
+				for (int i = 0; i < 3; ++i) {
+					p[i] = brick.domain.min[i] + Scalar(local[i])
+							* voxelSize[i];
+					if (p[i] > brick.domain.max[i]) {
+						p[i] = brick.domain.max[i];
+					}
+				}
+
+				/* Sample the brick texture as the raycasting shader does: */
+				GLfloat texCoord[3];
+				for (int i = 0; i < 3; ++i) {
+					texCoord[i] = GLfloat(p[i]) * mcScale[i] + mcOffset[i];
+				}
+				double brickValue = sampleTexture(texels, textureSize, texCoord);
+
+				/* Sample the unbricked volume at the same position: */
+				double voxel[3];
+				for (int i = 0; i < 3; ++i) {
+					voxel[i] = (double(p[i]) - double(domain.min[i]))
+							* double(dataSize[i] - 1) / (double(domain.max[i])
+							- double(domain.min[i]));
+				}
+				double volumeValue = sampleVolume(data, dataSize, dataStrides,
+						voxel);
+
+				double error = fabs(brickValue - volumeValue);
+				if (maxError < error) {
+					maxError = error;
+				}
+				if (error > tolerance) {
+					++numErrors;
+				}
+				++numSamples;
+			}
+		}
+	}
+	return numErrors;
+} // end checkBrick()
+
+/*
+ * main
+ *
+ * parameter argc - int
+ * parameter argv - char**
+ * return - int
+ */
+int main(int argc, char** argv) {
+	/* Parse the command line: */
+	unsigned int dataSize[3] = { 97, 61, 130 };
+	unsigned int maxBrickSize = 32;
+	double tolerance = 1.0;
+	for (int i = 1; i < argc; ++i) {
+		if (strcasecmp(argv[i], "-size") == 0 && i + 3 < argc) {
+			for (int j = 0; j < 3; ++j) {
+				dataSize[j] = (unsigned int) atoi(argv[++i]);
+			}
+		} else if (strcasecmp(argv[i], "-brickSize") == 0 && i + 1 < argc) {
+			maxBrickSize = (unsigned int) atoi(argv[++i]);
+		} else if (strcasecmp(argv[i], "-tolerance") == 0 && i + 1 < argc) {
+			tolerance = atof(argv[++i]);
+		}
+	}
+
+	/* Create a raycaster with a non-cubic domain and fill its volume: */
+	Box domain(Point(-1.0f, 0.25f, 2.0f), Point(1.5f, 1.45f, 4.8f));
+	SingleChannelRaycaster raycaster(dataSize, domain, maxBrickSize);
+	Voxel * data = raycaster.getData();
+	const ptrdiff_t * dataStrides = raycaster.getDataStrides();
+	for (unsigned int z = 0; z < dataSize[2]; ++z) {
+		for (unsigned int y = 0; y < dataSize[1]; ++y) {
+			for (unsigned int x = 0; x < dataSize[0]; ++x) {
+				data[x * dataStrides[0] + y * dataStrides[1] + z
+						* dataStrides[2]] = calcValue(double(x)
+						/ double(dataSize[0] - 1), double(y)
+						/ double(dataSize[1] - 1), double(z)
+						/ double(dataSize[2] - 1));
+			}
+		}
+	}
+
+	const unsigned int * numBricks = raycaster.getNumBricks();
+	std::cout << dataSize[0] << "x" << dataSize[1] << "x" << dataSize[2]
+			<< " voxels, " << numBricks[0] << "x" << numBricks[1] << "x"
+			<< numBricks[2] << " bricks of at most " << maxBrickSize
+			<< "^3 voxels:" << std::endl;
+
+	/* Check the brick layout: */
+	size_t numLayoutErrors = checkLayout(raycaster);
+	std::cout << "  Brick layout: " << numLayoutErrors << " errors"
+			<< std::endl;
+
+	/* Check the bricks' textures with and without padding: */
+	size_t numErrors = numLayoutErrors;
+	for (int pad = 0; pad < 2; ++pad) {
+		double maxError = 0.0;
+		size_t numSamples = 0;
+		size_t numSampleErrors = 0;
+		for (size_t b = 0; b < raycaster.getBricks().size(); ++b) {
+			numSampleErrors += checkBrick(raycaster, int(b), pad != 0,
+					tolerance, maxError, numSamples);
+		}
+		numErrors += numSampleErrors;
+		std::cout << "  " << (pad != 0 ? "Power-of-two" : "Exact-size")
+				<< " textures: " << numSamples << " samples, maximum error "
+				<< maxError << ", " << numSampleErrors << " errors"
+				<< std::endl;
+	}
+
+	return numErrors == 0 ? 0 : 1;
+} // end main()
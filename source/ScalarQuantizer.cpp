@@ -0,0 +1,168 @@
+/***********************************************************************
+ScalarQuantizer - Class to map scalar values to normalized quantization
+levels in [0, 1] using linear, logarithmic, or histogram-equalized
+transforms, and to map quantization levels back to scalar values.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <math.h>
+#include <algorithm>
+#include <Misc/ThrowStdErr.h>
+
+#include <ScalarQuantizer.h>
+
+/****************************************
+Static elements of class ScalarQuantizer:
+****************************************/
+
+const double ScalarQuantizer::defaultLogRange=8.0;
+
+/********************************
+Methods of class ScalarQuantizer:
+********************************/
+
+ScalarQuantizer::ScalarQuantizer(void)
+	:mode(LINEAR),
+	 valueMin(0.0),valueMax(1.0),
+	 logFloor(0.0),logAxis(false),
+	 axisMin(0.0),axisMax(1.0),axisScale(1.0)
+	{
+	}
+
+ScalarQuantizer::ScalarQuantizer(ScalarQuantizer::Mode sMode,double sValueMin,double sValueMax,double sLogFloor)
+	:mode(sMode),
+	 valueMin(sValueMin),valueMax(sValueMax),
+	 logFloor(sLogFloor),logAxis(false)
+	{
+	/* Place the default logarithmic floor at the smallest positive value, or a fixed number of decades below the maximum: */
+	if(logFloor<=0.0)
+		logFloor=valueMin>0.0?valueMin:valueMax*pow(10.0,-defaultLogRange);
+	
+	/*********************************************************************
+	Logarithmic quantization clamps all values below the floor. Histogram
+	equalization bins on the log10 axis as well if the value range is not
+	negative, so that it can resolve values spanning many decades with a
+	moderate number of bins.
+	*********************************************************************/
+	
+	if(mode==LOGARITHMIC)
+		logAxis=valueMax>0.0;
+	else if(mode==HISTOGRAM_EQUALIZED)
+		logAxis=valueMin>=0.0&&valueMax>0.0;
+	if(logAxis)
+		{
+		if(logFloor>valueMax)
+			logFloor=valueMax;
+		axisMin=log10(logFloor);
+		axisMax=log10(valueMax);
+		}
+	else
+		{
+		axisMin=valueMin;
+		axisMax=valueMax;
+		}
+	axisScale=axisMax>axisMin?1.0/(axisMax-axisMin):0.0;
+	}
+
+double ScalarQuantizer::calcAxisPosition(double value) const
+	{
+	double axis=value;
+	if(logAxis)
+		axis=log10(value>logFloor?value:logFloor);
+	double position=(axis-axisMin)*axisScale;
+	if(position<0.0)
+		position=0.0;
+	else if(position>1.0)
+		position=1.0;
+	return position;
+	}
+
+void ScalarQuantizer::setHistogram(unsigned int numBins,const size_t binCounts[])
+	{
+	/* Accumulate the bin counts: */
+	cdf.resize(numBins+1);
+	double total=0.0;
+	cdf[0]=0.0;
+	for(unsigned int i=0;i<numBins;++i)
+		{
+		total+=double(binCounts[i]);
+		cdf[i+1]=total;
+		}
+	
+	if(total>0.0)
+		{
+		/* Normalize the cumulative distribution: */
+		for(unsigned int i=1;i<=numBins;++i)
+			cdf[i]/=total;
+		}
+	else
+		{
+		/* Fall back to the unequalized quantization axis: */
+		for(unsigned int i=1;i<=numBins;++i)
+			cdf[i]=double(i)/double(numBins);
+		}
+	}
+
+void ScalarQuantizer::setCdf(const std::vector<double>& newCdf)
+	{
+	if(newCdf.size()==1)
+		Misc::throwStdErr("ScalarQuantizer::setCdf: Cumulative distribution has no bins");
+	cdf=newCdf;
+	}
+
+double ScalarQuantizer::map(double value) const
+	{
+	double position=calcAxisPosition(value);
+	if(cdf.empty())
+		return position;
+	
+	/* Interpolate the cumulative distribution inside the value's bin: */
+	unsigned int numBins=(unsigned int)(cdf.size()-1);
+	position*=double(numBins);
+	unsigned int bin=(unsigned int)(position);
+	if(bin>=numBins)
+		bin=numBins-1;
+	return cdf[bin]+(cdf[bin+1]-cdf[bin])*(position-double(bin));
+	}
+
+double ScalarQuantizer::unmap(double level) const
+	{
+	if(level<0.0)
+		level=0.0;
+	else if(level>1.0)
+		level=1.0;
+	
+	double position=level;
+	if(!cdf.empty())
+		{
+		/* Find the first bin whose cumulative distribution reaches the level: */
+		unsigned int numBins=(unsigned int)(cdf.size()-1);
+		unsigned int bin=(unsigned int)(std::lower_bound(cdf.begin(),cdf.end(),level)-cdf.begin());
+		bin=bin>0?bin-1:0;
+		if(bin>=numBins)
+			bin=numBins-1;
+		
+		/* Invert the interpolation inside the bin: */
+		double binFraction=cdf[bin+1]>cdf[bin]?(level-cdf[bin])/(cdf[bin+1]-cdf[bin]):0.0;
+		position=(double(bin)+binFraction)/double(numBins);
+		}
+	
+	double axis=axisMin+(axisMax-axisMin)*position;
+	return logAxis?pow(10.0,axis):axis;
+	}
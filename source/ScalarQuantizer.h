@@ -0,0 +1,104 @@
+/***********************************************************************
+ScalarQuantizer - Class to map scalar values to normalized quantization
+levels in [0, 1] using linear, logarithmic, or histogram-equalized
+transforms, and to map quantization levels back to scalar values.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef SCALARQUANTIZER_INCLUDED
+#define SCALARQUANTIZER_INCLUDED
+
+#include <stddef.h>
+#include <vector>
+
+class ScalarQuantizer
+	{
+	/* Embedded classes: */
+	public:
+	enum Mode // Enumerated type for quantization transforms
+		{
+		LINEAR=0,LOGARITHMIC,HISTOGRAM_EQUALIZED
+		};
+	
+	/* Elements: */
+	static const double defaultLogRange; // Number of decades below the maximum value at which the default logarithmic floor is placed
+	private:
+	Mode mode; // The quantization transform
+	double valueMin,valueMax; // Range of scalar values mapped to [0, 1]
+	double logFloor; // Smallest value resolved on a logarithmic axis; smaller values are clamped to it
+	bool logAxis; // Flag whether values are quantized on the log10 axis instead of the linear axis
+	double axisMin,axisMax; // Value range on the quantization axis
+	double axisScale; // Factor mapping the quantization axis' value range to [0, 1]
+	std::vector<double> cdf; // Cumulative distribution of values over equal-width bins on the quantization axis, with one more entry than bins; empty if no histogram is set
+	
+	/* Constructors and destructors: */
+	public:
+	ScalarQuantizer(void); // Creates a linear quantizer for the value range [0, 1]
+	ScalarQuantizer(Mode sMode,double sValueMin,double sValueMax,double sLogFloor =0.0); // Creates a quantizer for the given transform and value range; a non-positive logarithmic floor is replaced by a default
+	
+	/* Methods: */
+	Mode getMode(void) const // Returns the quantization transform
+		{
+		return mode;
+		}
+	double getValueMin(void) const // Returns the lower end of the value range
+		{
+		return valueMin;
+		}
+	double getValueMax(void) const // Returns the upper end of the value range
+		{
+		return valueMax;
+		}
+	double getLogFloor(void) const // Returns the logarithmic floor
+		{
+		return logFloor;
+		}
+	bool hasLogAxis(void) const // Returns true if values are quantized on the log10 axis
+		{
+		return logAxis;
+		}
+	bool isEqualized(void) const // Returns true if the quantizer has a histogram to equalize against
+		{
+		return !cdf.empty();
+		}
+	unsigned int getNumBins(void) const // Returns the number of histogram bins, or 0 if no histogram is set
+		{
+		return cdf.empty()?0:(unsigned int)(cdf.size()-1);
+		}
+	const std::vector<double>& getCdf(void) const // Returns the cumulative distribution over the histogram bins
+		{
+		return cdf;
+		}
+	double calcAxisPosition(double value) const; // Returns the given value's normalized position in [0, 1] on the quantization axis, ignoring any histogram
+	unsigned int calcBin(double value,unsigned int numBins) const // Returns the index of the equal-width quantization axis bin containing the given value
+		{
+		unsigned int bin=(unsigned int)(calcAxisPosition(value)*double(numBins));
+		return bin<numBins?bin:numBins-1;
+		}
+	double calcBinLevel(unsigned int bin) const // Returns the quantization level of the center of the given histogram bin
+		{
+		return (cdf[bin]+cdf[bin+1])*0.5;
+		}
+	void setHistogram(unsigned int numBins,const size_t binCounts[]); // Sets the cumulative distribution from the given value counts per equal-width quantization axis bin
+	void setCdf(const std::vector<double>& newCdf); // Sets a cumulative distribution received from another quantizer
+	double map(double value) const; // Maps the given scalar value to a quantization level in [0, 1]
+	double unmap(double level) const; // Maps the given quantization level in [0, 1] back to a scalar value
+	};
+
+#endif
@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include <string>
 #include <GL/gl.h>
+#include <vector>
 #include <GL/GLContextData.h>
 #include <GL/Extensions/GLARBTextureFloat.h>
 #include <GL/GLShader.h>
@@ -34,28 +35,28 @@ Methods of class SingleChannelRaycaster::DataItem:
 
 SingleChannelRaycaster::DataItem::DataItem(void)
 	:haveFloatTextures(GLARBTextureFloat::isSupported()),
-	 volumeTextureID(0),volumeTextureVersion(0),
-	 colorMapTextureID(0),
-	 volumeSamplerLoc(-1),colorMapSamplerLoc(-1)
+	 colorMapTextureID(0),blockTextureID(0),blockTextureVersion(0),
+	 volumeSamplerLoc(-1),colorMapSamplerLoc(-1),
+	 blockSamplerLoc(-1),blockTextureScaleLoc(-1),bcScaleLoc(-1),bcOffsetLoc(-1)
 	{
 	/* Initialize all required OpenGL extensions: */
 	if(haveFloatTextures)
 		GLARBTextureFloat::initExtension();
 	
-	/* Create the volume texture object: */
-	glGenTextures(1,&volumeTextureID);
-	
-	/* Create the color map texture object: */
+	/* Create the color map and block classification texture objects: */
 	glGenTextures(1,&colorMapTextureID);
+	glGenTextures(1,&blockTextureID);
 	}
 
 SingleChannelRaycaster::DataItem::~DataItem(void)
 	{
-	/* Destroy the volume texture object: */
-	glDeleteTextures(1,&volumeTextureID);
+	/* Destroy the volume texture objects: */
+	if(!volumeTextureIDs.empty())
+		glDeleteTextures(GLsizei(volumeTextureIDs.size()),&volumeTextureIDs[0]);
 	
-	/* Destroy the color map texture object: */
+	/* Destroy the color map and block classification texture objects: */
 	glDeleteTextures(1,&colorMapTextureID);
+	glDeleteTextures(1,&blockTextureID);
 	}
 
 /***************************************
@@ -70,14 +71,21 @@ void SingleChannelRaycaster::initDataItem(Raycaster::DataItem* dataItem) const
 	/* Get a pointer to the data item: */
 	DataItem* myDataItem=dynamic_cast<DataItem*>(dataItem);
 	
-	/* Create the data volume texture: */
-	glBindTexture(GL_TEXTURE_3D,myDataItem->volumeTextureID);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_S,GL_CLAMP);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_T,GL_CLAMP);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_R,GL_CLAMP);
-	glTexImage3DEXT(GL_TEXTURE_3D,0,GL_INTENSITY,myDataItem->textureSize[0],myDataItem->textureSize[1],myDataItem->textureSize[2],0,GL_LUMINANCE,GL_UNSIGNED_BYTE,0);
+	/* Create the bricks' data volume textures: */
+	myDataItem->volumeTextureIDs.resize(bricks.size());
+	myDataItem->volumeTextureVersions.resize(bricks.size(),0);
+	glGenTextures(GLsizei(bricks.size()),&myDataItem->volumeTextureIDs[0]);
+	for(size_t brickIndex=0;brickIndex<bricks.size();++brickIndex)
+		{
+		const GLsizei* textureSize=myDataItem->brickItems[brickIndex].textureSize;
+		glBindTexture(GL_TEXTURE_3D,myDataItem->volumeTextureIDs[brickIndex]);
+		glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_S,GL_CLAMP);
+		glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_T,GL_CLAMP);
+		glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_R,GL_CLAMP);
+		glTexImage3DEXT(GL_TEXTURE_3D,0,GL_INTENSITY16,textureSize[0],textureSize[1],textureSize[2],0,GL_LUMINANCE,GL_UNSIGNED_SHORT,0);
+		}
 	glBindTexture(GL_TEXTURE_3D,0);
 	
 	/* Create the color map texture: */
@@ -86,6 +94,33 @@ void SingleChannelRaycaster::initDataItem(Raycaster::DataItem* dataItem) const
 	glTexParameteri(GL_TEXTURE_1D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_1D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
 	glBindTexture(GL_TEXTURE_1D,0);
+	
+	/* Calculate the block classification texture's size: */
+	const unsigned int* numBlocks=blockIndex.getNumBlocks();
+	size_t numTexels=1;
+	for(int i=0;i<3;++i)
+		{
+		if(myDataItem->hasNPOTDTextures)
+			myDataItem->blockTextureSize[i]=numBlocks[i];
+		else
+			for(myDataItem->blockTextureSize[i]=1;myDataItem->blockTextureSize[i]<GLsizei(numBlocks[i]);myDataItem->blockTextureSize[i]<<=1)
+				;
+		numTexels*=size_t(myDataItem->blockTextureSize[i]);
+		}
+	
+	/* Create the block classification texture, marking any padding texels as not transparent: */
+	std::vector<GLubyte> padding(numTexels,GLubyte(255));
+	glBindTexture(GL_TEXTURE_3D,myDataItem->blockTextureID);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_R,GL_CLAMP_TO_EDGE);
+	glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+	glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+	glTexImage3DEXT(GL_TEXTURE_3D,0,GL_LUMINANCE8,myDataItem->blockTextureSize[0],myDataItem->blockTextureSize[1],myDataItem->blockTextureSize[2],0,GL_LUMINANCE,GL_UNSIGNED_BYTE,&padding[0]);
+	glPopClientAttrib();
+	glBindTexture(GL_TEXTURE_3D,0);
 	}
 
 void SingleChannelRaycaster::initShader(Raycaster::DataItem* dataItem) const
@@ -99,6 +134,10 @@ void SingleChannelRaycaster::initShader(Raycaster::DataItem* dataItem) const
 	/* Get the shader's uniform locations: */
 	myDataItem->volumeSamplerLoc=myDataItem->shader.getUniformLocation("volumeSampler");
 	myDataItem->colorMapSamplerLoc=myDataItem->shader.getUniformLocation("colorMapSampler");
+	myDataItem->blockSamplerLoc=myDataItem->shader.getUniformLocation("blockSampler");
+	myDataItem->blockTextureScaleLoc=myDataItem->shader.getUniformLocation("blockTextureScale");
+	myDataItem->bcScaleLoc=myDataItem->shader.getUniformLocation("bcScale");
+	myDataItem->bcOffsetLoc=myDataItem->shader.getUniformLocation("bcOffset");
 	}
 
 void SingleChannelRaycaster::bindShader(const Raycaster::PTransform& pmv,const Raycaster::PTransform& mv,Raycaster::DataItem* dataItem) const
@@ -109,21 +148,9 @@ void SingleChannelRaycaster::bindShader(const Raycaster::PTransform& pmv,const R
 	/* Get a pointer to the data item: */
 	DataItem* myDataItem=dynamic_cast<DataItem*>(dataItem);
 	
-	/* Bind the volume texture: */
-	glActiveTextureARB(GL_TEXTURE1_ARB);
-	glBindTexture(GL_TEXTURE_3D,myDataItem->volumeTextureID);
+	/* Select the texture unit for the bricks' volume textures: */
 	glUniform1iARB(myDataItem->volumeSamplerLoc,1);
 	
-	/* Check if the volume texture needs to be updated: */
-	if(myDataItem->volumeTextureVersion!=dataVersion)
-		{
-		/* Upload the new volume data: */
-		glTexSubImage3DEXT(GL_TEXTURE_3D,0,0,0,0,dataSize[0],dataSize[1],dataSize[2],GL_LUMINANCE,GL_UNSIGNED_BYTE,data);
-		
-		/* Mark the volume texture as up-to-date: */
-		myDataItem->volumeTextureVersion=dataVersion;
-		}
-	
 	/* Bind the color map texture: */
 	glActiveTextureARB(GL_TEXTURE2_ARB);
 	glBindTexture(GL_TEXTURE_1D,myDataItem->colorMapTextureID);
@@ -134,10 +161,78 @@ void SingleChannelRaycaster::bindShader(const Raycaster::PTransform& pmv,const R
 	adjustedColorMap.changeTransparency(stepSize*transparencyGamma);
 	adjustedColorMap.premultiplyAlpha();
 	glTexImage1D(GL_TEXTURE_1D,0,myDataItem->haveFloatTextures?GL_RGBA32F_ARB:GL_RGBA,256,0,GL_RGBA,GL_FLOAT,adjustedColorMap.getColors());
+	
+	/* Bind the block classification texture: */
+	glActiveTextureARB(GL_TEXTURE3_ARB);
+	glBindTexture(GL_TEXTURE_3D,myDataItem->blockTextureID);
+	glUniform1iARB(myDataItem->blockSamplerLoc,3);
+	glUniform3fARB(myDataItem->blockTextureScaleLoc,1.0f/GLfloat(myDataItem->blockTextureSize[0]),1.0f/GLfloat(myDataItem->blockTextureSize[1]),1.0f/GLfloat(myDataItem->blockTextureSize[2]));
+	
+	{
+	Threads::Mutex::Lock blockIndexLock(blockIndexMutex);
+	
+	/* Re-classify the blocks if the palette changed which color map entries are transparent; the color map is edited in place: */
+	if(blockIndex.classify(*colorMap))
+		++blockIndexVersion;
+	
+	/* Check if the block classification texture needs to be updated: */
+	if(myDataItem->blockTextureVersion!=blockIndexVersion)
+		{
+		/* Upload the new block classification: */
+		const unsigned int* numBlocks=blockIndex.getNumBlocks();
+		glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+		glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+		glTexSubImage3DEXT(GL_TEXTURE_3D,0,0,0,0,numBlocks[0],numBlocks[1],numBlocks[2],GL_LUMINANCE,GL_UNSIGNED_BYTE,blockIndex.getOpacities());
+		glPopClientAttrib();
+		
+		/* Mark the block classification texture as up-to-date: */
+		myDataItem->blockTextureVersion=blockIndexVersion;
+		}
+	}
+	}
+
+void SingleChannelRaycaster::bindBrick(int brickIndex,Raycaster::DataItem* dataItem) const
+	{
+	/* Call the base class method: */
+	Raycaster::bindBrick(brickIndex,dataItem);
+	
+	/* Get a pointer to the data item: */
+	DataItem* myDataItem=dynamic_cast<DataItem*>(dataItem);
+	
+	/* Set up the transformation from the brick's data space to the block index' block space: */
+	const Brick& brick=bricks[brickIndex];
+	const GLsizei* textureSize=myDataItem->brickItems[brickIndex].textureSize;
+	GLfloat blockSize=GLfloat(blockIndex.getBlockSize());
+	GLfloat bcScale[3],bcOffset[3];
+	for(int i=0;i<3;++i)
+		{
+		bcScale[i]=GLfloat(textureSize[i])/blockSize;
+		bcOffset[i]=(GLfloat(brick.origin[i])-0.5f)/blockSize;
+		}
+	glUniform3fvARB(myDataItem->bcScaleLoc,1,bcScale);
+	glUniform3fvARB(myDataItem->bcOffsetLoc,1,bcOffset);
+	
+	/* Bind the brick's volume texture: */
+	glActiveTextureARB(GL_TEXTURE1_ARB);
+	glBindTexture(GL_TEXTURE_3D,myDataItem->volumeTextureIDs[brickIndex]);
+	
+	/* Check if the brick's volume texture needs to be updated: */
+	if(myDataItem->volumeTextureVersions[brickIndex]!=dataVersion)
+		{
+		/* Upload the brick's new volume data: */
+		uploadBrick(brickIndex,GL_LUMINANCE,GL_UNSIGNED_SHORT,data+(brick.origin[0]*dataStrides[0]+brick.origin[1]*dataStrides[1]+brick.origin[2]*dataStrides[2]));
+		
+		/* Mark the brick's volume texture as up-to-date: */
+		myDataItem->volumeTextureVersions[brickIndex]=dataVersion;
+		}
 	}
 
 void SingleChannelRaycaster::unbindShader(Raycaster::DataItem* dataItem) const
 	{
+	/* Unbind the block classification texture: */
+	glActiveTextureARB(GL_TEXTURE3_ARB);
+	glBindTexture(GL_TEXTURE_3D,0);
+	
 	/* Unbind the color map texture: */
 	glActiveTextureARB(GL_TEXTURE2_ARB);
 	glBindTexture(GL_TEXTURE_1D,0);
@@ -150,10 +245,11 @@ void SingleChannelRaycaster::unbindShader(Raycaster::DataItem* dataItem) const
 	Raycaster::unbindShader(dataItem);
 	}
 
-SingleChannelRaycaster::SingleChannelRaycaster(const unsigned int sDataSize[3],const Raycaster::Box& sDomain)
-	:Raycaster(sDataSize,sDomain),
+SingleChannelRaycaster::SingleChannelRaycaster(const unsigned int sDataSize[3],const Raycaster::Box& sDomain,unsigned int sMaxBrickSize)
+	:Raycaster(sDataSize,sDomain,sMaxBrickSize),
 	 data(new Voxel[dataSize[0]*dataSize[1]*dataSize[2]]),dataVersion(0),
-	 colorMap(0),transparencyGamma(1.0f)
+	 colorMap(0),transparencyGamma(1.0f),
+	 blockIndex(dataSize),blockIndexVersion(0)
 	{
 	}
 
@@ -195,6 +291,10 @@ void SingleChannelRaycaster::updateData(void)
 	{
 	/* Bump up the data version number: */
 	++dataVersion;
+	
+	/* Rebuild the block index, which will be re-classified on the next rendering pass: */
+	Threads::Mutex::Lock blockIndexLock(blockIndexMutex);
+	blockIndex.build(data,dataStrides);
 	}
 
 void SingleChannelRaycaster::setColorMap(const GLColorMap* newColorMap)
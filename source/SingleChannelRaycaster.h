@@ -23,29 +23,40 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef SINGLECHANNELRAYCASTER_INCLUDED
 #define SINGLECHANNELRAYCASTER_INCLUDED
 
+#include <vector>
 #include <GL/gl.h>
+#include <Threads/Mutex.h>
 #include <GL/GLColorMap.h>
 
 #include <Raycaster.h>
+#include <VoxelBlockIndex.h>
 
 class SingleChannelRaycaster:public Raycaster
 	{
 	/* Embedded classes: */
-	protected:
-	typedef GLubyte Voxel; // Type for voxel data
+	public:
+	typedef GLushort Voxel; // Type for voxel data; 16 bits per voxel to preserve the dynamic range of the resampled variable
 	
+	protected:
 	struct DataItem:public Raycaster::DataItem
 		{
 		/* Elements: */
 		public:
 		bool haveFloatTextures; // Flag whether the local OpenGL supports floating-point textures
 		
-		GLuint volumeTextureID; // Texture object ID for volume data texture
-		unsigned int volumeTextureVersion; // Version number of volume data texture
+		std::vector<GLuint> volumeTextureIDs; // Texture object IDs for the volume data textures of all bricks
+		std::vector<unsigned int> volumeTextureVersions; // Version numbers of the volume data textures of all bricks
 		GLuint colorMapTextureID; // Texture object ID for stepsize-adjusted color map texture
+		GLuint blockTextureID; // Texture object ID for the classification of the volume data's blocks
+		GLsizei blockTextureSize[3]; // Size of the texture able to hold the classification of all blocks
+		unsigned int blockTextureVersion; // Version number of the block classification texture
 		
 		int volumeSamplerLoc; // Location of the volume data texture sampler
 		int colorMapSamplerLoc; // Location of the color map texture sampler
+		int blockSamplerLoc; // Location of the block classification texture sampler
+		int blockTextureScaleLoc; // Location of the scale factors from block space to block classification texture coordinates
+		int bcScaleLoc; // Location of the scale factors from the brick's data space to block space
+		int bcOffsetLoc; // Location of the offset from the brick's data space to block space
 		
 		/* Constructors and destructors: */
 		DataItem(void);
@@ -58,17 +69,21 @@ class SingleChannelRaycaster:public Raycaster
 	unsigned int dataVersion; // Version number of the volume dataset to track changes
 	const GLColorMap* colorMap; // Pointer to the color map
 	GLfloat transparencyGamma; // Adjustment factor for color map's overall opacity
+	mutable Threads::Mutex blockIndexMutex; // Mutex serializing access to the block index between rendering threads and data updates
+	mutable VoxelBlockIndex blockIndex; // Value ranges and classification of coarse blocks of the volume dataset to skip empty space
+	mutable unsigned int blockIndexVersion; // Version number of the block classification to track changes
 	
 	/* Protected methods: */
 	protected:
 	virtual void initDataItem(Raycaster::DataItem* dataItem) const;
 	virtual void initShader(Raycaster::DataItem* dataItem) const;
 	virtual void bindShader(const PTransform& pmv,const PTransform& mv,Raycaster::DataItem* dataItem) const;
+	virtual void bindBrick(int brickIndex,Raycaster::DataItem* dataItem) const;
 	virtual void unbindShader(Raycaster::DataItem* dataItem) const;
 	
 	/* Constructors and destructors: */
 	public:
-	SingleChannelRaycaster(const unsigned int sDataSize[3],const Box& sDomain); // Creates a volume renderer
+	SingleChannelRaycaster(const unsigned int sDataSize[3],const Box& sDomain,unsigned int sMaxBrickSize =512); // Creates a volume renderer
 	virtual ~SingleChannelRaycaster(void); // Destroys the raycaster
 	
 	/* Methods from GLObject: */
@@ -86,7 +101,11 @@ class SingleChannelRaycaster:public Raycaster
 		{
 		return data;
 		}
-	virtual void updateData(void); // Notifies the raycaster that the volume dataset has changed
+	virtual void updateData(void); // Notifies the raycaster that the volume dataset has changed; rebuilds the block index
+	const VoxelBlockIndex& getBlockIndex(void) const // Returns the block index of the volume dataset
+		{
+		return blockIndex;
+		}
 	const GLColorMap* getColorMap(void) const // Returns the raycaster's color map
 		{
 		return colorMap;
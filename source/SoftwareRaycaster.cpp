@@ -0,0 +1,426 @@
+/***********************************************************************
+SoftwareRaycaster - Class for single-channel volume renderers that can
+additionally render images on the CPU without an OpenGL context, using
+the same sampling, transfer function, clipping, and early ray
+termination as the single-channel GLSL raycaster.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <SoftwareRaycaster.h>
+
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <Misc/File.h>
+#include <Threads/Mutex.h>
+#include <Threads/Thread.h>
+#include <Math/Math.h>
+#include <Geometry/Vector.h>
+#include <GL/GLColorMap.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <WorkerThreads.h>
+
+namespace {
+
+/**********************************************************************
+Helper function to trilinearly interpolate the eight voxels of the cell
+starting at the given voxel; adjacent voxels along x must be consecutive
+in memory:
+**********************************************************************/
+
+inline
+GLfloat
+interpolateVoxels(
+	const SingleChannelRaycaster::Voxel* base,
+	const ptrdiff_t dataStrides[3],
+	const GLfloat weights[3])
+	{
+	#ifdef __SSE2__
+	
+	/* Load the cell's four pairs of adjacent x voxels: */
+	int pairs[4];
+	memcpy(&pairs[0],base,sizeof(int));
+	memcpy(&pairs[1],base+dataStrides[1],sizeof(int));
+	memcpy(&pairs[2],base+dataStrides[2],sizeof(int));
+	memcpy(&pairs[3],base+dataStrides[1]+dataStrides[2],sizeof(int));
+	__m128i voxels=_mm_loadu_si128(reinterpret_cast<const __m128i*>(pairs));
+	
+	/* Convert the voxels of the lower and upper z faces to floating point: */
+	__m128i zero=_mm_setzero_si128();
+	__m128 lower=_mm_cvtepi32_ps(_mm_unpacklo_epi16(voxels,zero));
+	__m128 upper=_mm_cvtepi32_ps(_mm_unpackhi_epi16(voxels,zero));
+	
+	/* Interpolate along z, then y, then x: */
+	__m128 face=_mm_add_ps(lower,_mm_mul_ps(_mm_sub_ps(upper,lower),_mm_set1_ps(weights[2])));
+	__m128 face1=_mm_movehl_ps(face,face);
+	__m128 edge=_mm_add_ps(face,_mm_mul_ps(_mm_sub_ps(face1,face),_mm_set1_ps(weights[1])));
+	GLfloat v0=_mm_cvtss_f32(edge);
+	GLfloat v1=_mm_cvtss_f32(_mm_shuffle_ps(edge,edge,_MM_SHUFFLE(1,1,1,1)));
+	return v0+(v1-v0)*weights[0];
+	
+	#else
+	
+	/* Interpolate along z, then y, then x: */
+	GLfloat edges[2][2];
+	for(int y=0;y<2;++y)
+		for(int x=0;x<2;++x)
+			{
+			const SingleChannelRaycaster::Voxel* vPtr=base+(y*dataStrides[1]+x);
+			GLfloat v0=GLfloat(vPtr[0]);
+			GLfloat v1=GLfloat(vPtr[dataStrides[2]]);
+			edges[y][x]=v0+(v1-v0)*weights[2];
+			}
+	GLfloat v0=edges[0][0]+(edges[1][0]-edges[0][0])*weights[1];
+	GLfloat v1=edges[0][1]+(edges[1][1]-edges[0][1])*weights[1];
+	return v0+(v1-v0)*weights[0];
+	
+	#endif
+	}
+
+}
+
+/**************************************************
+Declaration of struct SoftwareRaycaster::RenderJob:
+**************************************************/
+
+struct SoftwareRaycaster::RenderJob
+	{
+	/* Elements: */
+	public:
+	const SoftwareRaycaster* raycaster; // The raycaster rendering the image
+	const PTransform* pmv; // Projection and modelview matrix product of the view
+	bool perspective; // Flag whether the view has a finite eye position
+	Point eye; // Eye position in model space for perspective views
+	const std::vector<Plane>* clipPlanes; // Model-space clipping planes
+	const GLfloat* colors; // Step size-adjusted color map entries with premultiplied alpha
+	int numEntries; // Number of color map entries
+	Scalar modelStepSize; // Sampling step size in model space
+	GLfloat voxelScale[3],voxelOffset[3]; // Scale factors and offset from model space to voxel index space
+	unsigned int width,height; // Size of the rendered image
+	GLfloat* image; // The rendered image
+	unsigned int numTiles[2]; // Number of image tiles along each axis
+	Threads::Mutex* tileMutex; // Mutex protecting the tile counter
+	unsigned int* nextTile; // Index of the next unrendered tile
+	
+	/* Methods: */
+	void castRay(unsigned int x,unsigned int y,GLfloat* pixel) const // Casts the ray through the given pixel's center and stores its accumulated color and opacity
+		{
+		typedef Geometry::Vector<Scalar,3> Vector;
+		
+		/* Calculate the ray through the pixel center between the near and far planes: */
+		Scalar ndcX=(Scalar(x)+Scalar(0.5))*Scalar(2)/Scalar(width)-Scalar(1);
+		Scalar ndcY=(Scalar(y)+Scalar(0.5))*Scalar(2)/Scalar(height)-Scalar(1);
+		Point nearPoint=pmv->inverseTransform(Point(ndcX,ndcY,Scalar(-1)));
+		Point farPoint=pmv->inverseTransform(Point(ndcX,ndcY,Scalar(1)));
+		Point origin=perspective?eye:nearPoint;
+		Vector dir=farPoint-nearPoint;
+		dir.normalize();
+		Scalar tMin=(nearPoint-origin)*dir;
+		Scalar tMax=(farPoint-origin)*dir;
+		
+		/* Clip the ray against the domain box: */
+		const Box& domain=raycaster->domain;
+		for(int i=0;i<3&&tMin<tMax;++i)
+			{
+			if(dir[i]!=Scalar(0))
+				{
+				Scalar t0=(domain.min[i]-origin[i])/dir[i];
+				Scalar t1=(domain.max[i]-origin[i])/dir[i];
+				if(t0>t1)
+					std::swap(t0,t1);
+				if(tMin<t0)
+					tMin=t0;
+				if(tMax>t1)
+					tMax=t1;
+				}
+			else if(origin[i]<domain.min[i]||origin[i]>domain.max[i])
+				tMax=tMin;
+			}
+		
+		/* Clip the ray against all clipping planes, keeping the parts behind the planes like Polyhedron::clip: */
+		for(std::vector<Plane>::const_iterator cpIt=clipPlanes->begin();cpIt!=clipPlanes->end()&&tMin<tMax;++cpIt)
+			{
+			Scalar d0=cpIt->calcDistance(origin);
+			Scalar dd=cpIt->getNormal()*dir;
+			if(dd>Scalar(0))
+				{
+				Scalar t=-d0/dd;
+				if(tMax>t)
+					tMax=t;
+				}
+			else if(dd<Scalar(0))
+				{
+				Scalar t=-d0/dd;
+				if(tMin<t)
+					tMin=t;
+				}
+			else if(d0>=Scalar(0))
+				tMax=tMin;
+			}
+		
+		GLfloat accum[4]={0.0f,0.0f,0.0f,0.0f};
+		if(tMin<tMax)
+			{
+			/* Start at the first integer multiple of the step size from the ray origin inside the clipped ray segment: */
+			Scalar lambda=Math::ceil(tMin/modelStepSize);
+			Scalar lambdaMax=tMax/modelStepSize;
+			
+			/* Convert the ray to voxel index space: */
+			GLfloat vcOrigin[3],vcDir[3];
+			for(int i=0;i<3;++i)
+				{
+				vcOrigin[i]=GLfloat(origin[i])*voxelScale[i]+voxelOffset[i];
+				vcDir[i]=GLfloat(dir[i]*modelStepSize)*voxelScale[i];
+				}
+			
+			/* Convert the ray direction to block space, nudging zero components to keep block exit distances finite: */
+			const VoxelBlockIndex& blockIndex=raycaster->blockIndex;
+			const unsigned int* numBlocks=blockIndex.getNumBlocks();
+			GLfloat blockSize=GLfloat(blockIndex.getBlockSize());
+			GLfloat bcDir[3],bcExitFace[3];
+			for(int i=0;i<3;++i)
+				{
+				bcDir[i]=vcDir[i]/blockSize;
+				if(bcDir[i]==0.0f)
+					bcDir[i]=1.0e-6f;
+				bcExitFace[i]=bcDir[i]>=0.0f?1.0f:0.0f;
+				}
+			
+			const unsigned int* dataSize=raycaster->dataSize;
+			const ptrdiff_t* dataStrides=raycaster->dataStrides;
+			while(lambda<lambdaMax)
+				{
+				/* Calculate the sample position in voxel index space: */
+				GLfloat vcPos[3];
+				for(int i=0;i<3;++i)
+					vcPos[i]=vcOrigin[i]+vcDir[i]*GLfloat(lambda);
+				
+				/* Check whether the block containing the sample position is fully transparent: */
+				GLfloat block[3];
+				size_t blockIndexValue=0;
+				for(int i=2;i>=0;--i)
+					{
+					block[i]=floorf(vcPos[i]/blockSize);
+					int b=int(block[i]);
+					if(b<0)
+						b=0;
+					else if(b>int(numBlocks[i])-1)
+						b=int(numBlocks[i])-1;
+					blockIndexValue=blockIndexValue*size_t(numBlocks[i])+size_t(b);
+					}
+				if(blockIndex.isTransparent(blockIndexValue))
+					{
+					/* Leap to the first sample position past the block's exit point, staying on integer multiples of the step size: */
+					GLfloat minExitDist=0.0f;
+					for(int i=0;i<3;++i)
+						{
+						GLfloat exitDist=(block[i]+bcExitFace[i]-vcPos[i]/blockSize)/bcDir[i];
+						if(i==0||minExitDist>exitDist)
+							minExitDist=exitDist;
+						}
+					lambda+=Scalar(floorf(minExitDist)+1.0f);
+					continue;
+					}
+				
+				/* Find the cell containing the sample position and the sample's position inside the cell: */
+				ptrdiff_t offset=0;
+				GLfloat weights[3];
+				for(int i=0;i<3;++i)
+					{
+					GLfloat vc=vcPos[i];
+					if(vc<0.0f)
+						vc=0.0f;
+					int index=int(vc);
+					if(index>int(dataSize[i])-2)
+						index=int(dataSize[i])-2;
+					weights[i]=vc-GLfloat(index);
+					if(weights[i]>1.0f)
+						weights[i]=1.0f;
+					offset+=ptrdiff_t(index)*dataStrides[i];
+					}
+				
+				/* Look up the normalized sample value in the linearly interpolated color map: */
+				GLfloat value=interpolateVoxels(raycaster->data+offset,dataStrides,weights)/65535.0f;
+				GLfloat entry=value*GLfloat(numEntries)-0.5f;
+				GLfloat sample[4];
+				if(entry<=0.0f)
+					{
+					for(int i=0;i<4;++i)
+						sample[i]=colors[i];
+					}
+				else if(entry>=GLfloat(numEntries-1))
+					{
+					for(int i=0;i<4;++i)
+						sample[i]=colors[(numEntries-1)*4+i];
+					}
+				else
+					{
+					int entryIndex=int(entry);
+					GLfloat w=entry-GLfloat(entryIndex);
+					const GLfloat* c0=colors+entryIndex*4;
+					for(int i=0;i<4;++i)
+						sample[i]=c0[i]+(c0[4+i]-c0[i])*w;
+					}
+				
+				/* Accumulate color and opacity: */
+				GLfloat transparency=1.0f-accum[3];
+				for(int i=0;i<4;++i)
+					accum[i]+=sample[i]*transparency;
+				
+				/* Bail out when opacity hits 1.0: */
+				if(accum[3]>=1.0f-1.0f/256.0f)
+					break;
+				
+				/* Advance the sample position: */
+				lambda+=Scalar(1);
+				}
+			}
+		
+		for(int i=0;i<4;++i)
+			pixel[i]=accum[i];
+		}
+	void* renderThreadMethod(void)
+		{
+		while(true)
+			{
+			/* Grab the next tile: */
+			unsigned int tile;
+			{
+			Threads::Mutex::Lock tileLock(*tileMutex);
+			tile=(*nextTile)++;
+			}
+			if(tile>=numTiles[0]*numTiles[1])
+				break;
+			
+			/* Cast the rays through all the tile's pixels: */
+			unsigned int x0=(tile%numTiles[0])*tileSize;
+			unsigned int y0=(tile/numTiles[0])*tileSize;
+			unsigned int x1=x0+tileSize<width?x0+tileSize:width;
+			unsigned int y1=y0+tileSize<height?y0+tileSize:height;
+			for(unsigned int y=y0;y<y1;++y)
+				for(unsigned int x=x0;x<x1;++x)
+					castRay(x,y,image+(size_t(y)*size_t(width)+size_t(x))*4);
+			}
+		
+		return 0;
+		}
+	};
+
+/**********************************
+Methods of class SoftwareRaycaster:
+**********************************/
+
+SoftwareRaycaster::SoftwareRaycaster(const unsigned int sDataSize[3],const Raycaster::Box& sDomain,unsigned int sMaxBrickSize)
+	:SingleChannelRaycaster(sDataSize,sDomain,sMaxBrickSize),
+	 numThreads(0)
+	{
+	}
+
+void SoftwareRaycaster::renderImage(const Raycaster::PTransform& pmv,const std::vector<Raycaster::Plane>& clipPlanes,unsigned int width,unsigned int height,GLfloat* image) const
+	{
+	/* Create the stepsize-adjusted colormap with pre-multiplied alpha, as uploaded by the GLSL raycaster: */
+	GLColorMap adjustedColorMap(*colorMap);
+	adjustedColorMap.changeTransparency(stepSize*transparencyGamma);
+	adjustedColorMap.premultiplyAlpha();
+	int numEntries=int(adjustedColorMap.getNumEntries());
+	std::vector<GLfloat> colors(size_t(numEntries)*4);
+	for(int i=0;i<numEntries;++i)
+		for(int j=0;j<4;++j)
+			colors[i*4+j]=adjustedColorMap.getColors()[i][j];
+	
+	/* Determine the number of rendering threads: */
+	unsigned int numTiles[2];
+	numTiles[0]=(width+tileSize-1)/tileSize;
+	numTiles[1]=(height+tileSize-1)/tileSize;
+	int numRenderThreads=getNumWorkerThreads(numThreads);
+	if(numRenderThreads>int(numTiles[0]*numTiles[1]))
+		numRenderThreads=int(numTiles[0]*numTiles[1]);
+	if(numRenderThreads<1)
+		return;
+	
+	/* Keep the block index unchanged while rendering, and re-classify it if the palette changed which color map entries are transparent: */
+	Threads::Mutex::Lock blockIndexLock(blockIndexMutex);
+	if(blockIndex.classify(*colorMap))
+		++blockIndexVersion;
+	
+	/* Create one rendering job per thread, each handing out tiles from the same counter: */
+	PTransform::HVector eyeH=pmv.inverseTransform(PTransform::HVector(0,0,1,0));
+	Threads::Mutex tileMutex;
+	unsigned int nextTile=0;
+	RenderJob* jobs=new RenderJob[numRenderThreads];
+	for(int i=0;i<numRenderThreads;++i)
+		{
+		jobs[i].raycaster=this;
+		jobs[i].pmv=&pmv;
+		jobs[i].perspective=eyeH[3]!=Scalar(0);
+		if(jobs[i].perspective)
+			jobs[i].eye=eyeH.toPoint();
+		jobs[i].clipPlanes=&clipPlanes;
+		jobs[i].colors=&colors[0];
+		jobs[i].numEntries=numEntries;
+		jobs[i].modelStepSize=stepSize*cellSize;
+		for(int j=0;j<3;++j)
+			{
+			jobs[i].voxelScale[j]=GLfloat(Scalar(dataSize[j]-1)/(domain.max[j]-domain.min[j]));
+			jobs[i].voxelOffset[j]=-GLfloat(domain.min[j])*jobs[i].voxelScale[j];
+			}
+		jobs[i].width=width;
+		jobs[i].height=height;
+		jobs[i].image=image;
+		for(int j=0;j<2;++j)
+			jobs[i].numTiles[j]=numTiles[j];
+		jobs[i].tileMutex=&tileMutex;
+		jobs[i].nextTile=&nextTile;
+		}
+	
+	/* Run the first job in the calling thread, and all others in background threads: */
+	Threads::Thread* threads=new Threads::Thread[numRenderThreads-1];
+	for(int i=1;i<numRenderThreads;++i)
+		threads[i-1].start(&jobs[i],&RenderJob::renderThreadMethod);
+	jobs[0].renderThreadMethod();
+	for(int i=1;i<numRenderThreads;++i)
+		threads[i-1].join();
+	delete[] threads;
+	delete[] jobs;
+	}
+
+void SoftwareRaycaster::saveImage(const char* imageFileName,unsigned int width,unsigned int height,const GLfloat* image,const GLfloat backgroundColor[3])
+	{
+	/* Open the image file: */
+	Misc::File imageFile(imageFileName,"wb");
+	fprintf(imageFile.getFilePtr(),"P6\n%u %u\n255\n",width,height);
+	
+	/* Write the image's rows from top to bottom, compositing the premultiplied pixels over the background color: */
+	std::vector<unsigned char> row(size_t(width)*3);
+	for(unsigned int y=height;y>0;--y)
+		{
+		const GLfloat* pPtr=image+size_t(y-1)*size_t(width)*4;
+		for(unsigned int x=0;x<width;++x,pPtr+=4)
+			for(int i=0;i<3;++i)
+				{
+				GLfloat c=pPtr[i]+backgroundColor[i]*(1.0f-pPtr[3]);
+				row[x*3+i]=(unsigned char)(c<=0.0f?0:c>=1.0f?255:int(c*255.0f+0.5f));
+				}
+		imageFile.write(&row[0],row.size());
+		}
+	}
@@ -0,0 +1,60 @@
+/***********************************************************************
+SoftwareRaycaster - Class for single-channel volume renderers that can
+additionally render images on the CPU without an OpenGL context, using
+the same sampling, transfer function, clipping, and early ray
+termination as the single-channel GLSL raycaster.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef SOFTWARERAYCASTER_INCLUDED
+#define SOFTWARERAYCASTER_INCLUDED
+
+#include <vector>
+#include <GL/gl.h>
+
+#include <SingleChannelRaycaster.h>
+
+class SoftwareRaycaster:public SingleChannelRaycaster
+	{
+	/* Embedded classes: */
+	private:
+	struct RenderJob; // Structure describing one thread's share of rendering an image
+	
+	/* Elements: */
+	static const unsigned int tileSize=32; // Width and height of the image tiles handed out to rendering threads
+	int numThreads; // Number of rendering threads, or 0 to use one thread per CPU
+	
+	/* Constructors and destructors: */
+	public:
+	SoftwareRaycaster(const unsigned int sDataSize[3],const Box& sDomain,unsigned int sMaxBrickSize =512); // Creates a volume renderer
+	
+	/* New methods: */
+	int getNumThreads(void) const // Returns the number of rendering threads
+		{
+		return numThreads;
+		}
+	void setNumThreads(int newNumThreads) // Sets the number of rendering threads; 0 uses one thread per CPU
+		{
+		numThreads=newNumThreads;
+		}
+	void renderImage(const PTransform& pmv,const std::vector<Plane>& clipPlanes,unsigned int width,unsigned int height,GLfloat* image) const; // Renders the data into the given image of premultiplied RGBA pixels, bottom row first, as seen through the given projection and modelview matrix product, clipping away the parts of the domain on the positive sides of the given model-space planes
+	static void saveImage(const char* imageFileName,unsigned int width,unsigned int height,const GLfloat* image,const GLfloat backgroundColor[3]); // Composites the given rendered image over the given background color and saves it as a binary PPM file
+	};
+
+#endif
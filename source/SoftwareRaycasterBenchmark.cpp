@@ -0,0 +1,224 @@
+/*
+ * Description: SoftwareRaycasterBenchmark.cpp - Measures how rendering a
+ * volume image on the CPU scales with the number of threads, and saves
+ * the rendered image, without opening a window
+ * Author: Patrick O'Leary
+ * Date: May 25, 2010
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <iostream>
+#include <vector>
+
+#include <Misc/Timer.h>
+#include <GL/GLColorMap.h>
+
+#include <SoftwareRaycaster.h>
+
+typedef SoftwareRaycaster::Scalar Scalar;
+typedef SoftwareRaycaster::Point Point;
+typedef SoftwareRaycaster::Box Box;
+typedef SoftwareRaycaster::Plane Plane;
+typedef SoftwareRaycaster::PTransform PTransform;
+
+/*
+ * calcValue - Returns the benchmark's normalized scalar value, a set of
+ * nested wavy shells fading out towards the corners of the volume, at the
+ * given position in the unit cube.
+ *
+ * parameter u - double
+ * parameter v - double
+ * parameter w - double
+ * return - double
+ */
+static double calcValue(double u, double v, double w) {
+	double r = sqrt((u - 0.5) * (u - 0.5) + (v - 0.5) * (v - 0.5) + (w - 0.5)
+			* (w - 0.5));
+	return (0.5 + 0.5 * sin(20.0 * r)) * exp(-4.0 * r * r);
+} // end calcValue()
+
+/*
+ * calcViewMatrix - Returns the product of a perspective projection with the
+ * given vertical field of view and aspect ratio and a modelview
+ * transformation looking from the given eye position at the given center
+ * point, with the z axis pointing up.
+ *
+ * parameter eye - const Point &
+ * parameter center - const Point &
+ * parameter fovy - double
+ * parameter aspect - double
+ * return - PTransform
+ */
+static PTransform calcViewMatrix(const Point & eye, const Point & center,
+		double fovy, double aspect) {
+	/* Calculate the viewing frame: */
+	double f[3], s[3], u[3];
+	double up[3] = { 0.0, 0.0, 1.0 };
+	double fLen = 0.0;
+	for (int i = 0; i < 3; ++i) {
+		f[i] = double(center[i] - eye[i]);
+		fLen += f[i] * f[i];
+	}
+	fLen = sqrt(fLen);
+	for (int i = 0; i < 3; ++i) {
+		f[i] /= fLen;
+	}
+	s[0] = f[1] * up[2] - f[2] * up[1];
+	s[1] = f[2] * up[0] - f[0] * up[2];
+	s[2] = f[0] * up[1] - f[1] * up[0];
+	double sLen = sqrt(s[0] * s[0] + s[1] * s[1] + s[2] * s[2]);
+	for (int i = 0; i < 3; ++i) {
+		s[i] /= sLen;
+	}
+	u[0] = s[1] * f[2] - s[2] * f[1];
+	u[1] = s[2] * f[0] - s[0] * f[2];
+	u[2] = s[0] * f[1] - s[1] * f[0];
+
+	/* Set up the modelview and projection matrices like gluLookAt and gluPerspective: */
+	double mv[4][4], p[4][4];
+	for (int j = 0; j < 3; ++j) {
+		mv[0][j] = s[j];
+		mv[1][j] = u[j];
+		mv[2][j] = -f[j];
+		mv[3][j] = 0.0;
+	}
+	mv[0][3] = mv[1][3] = mv[2][3] = 0.0;
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			mv[i][3] -= mv[i][j] * double(eye[j]);
+		}
+	}
+	mv[3][3] = 1.0;
+	double zNear = fLen * 0.1;
+	double zFar = fLen * 10.0;
+	double cot = 1.0 / tan(fovy * M_PI / 360.0);
+	for (int i = 0; i < 4; ++i) {
+		for (int j = 0; j < 4; ++j) {
+			p[i][j] = 0.0;
+		}
+	}
+	p[0][0] = cot / aspect;
+	p[1][1] = cot;
+	p[2][2] = (zFar + zNear) / (zNear - zFar);
+	p[2][3] = 2.0 * zFar * zNear / (zNear - zFar);
+	p[3][2] = -1.0;
+
+	PTransform pmv;
+	for (int i = 0; i < 4; ++i) {
+		for (int j = 0; j < 4; ++j) {
+			double sum = 0.0;
+			for (int k = 0; k < 4; ++k) {
+				sum += p[i][k] * mv[k][j];
+			}
+			pmv.getMatrix()(i, j) = Scalar(sum);
+		}
+	}
+	return pmv;
+} // end calcViewMatrix()
+
+/*
+ * main
+ *
+ * parameter argc - int
+ * parameter argv - char**
+ * return - int
+ */
+int main(int argc, char** argv) {
+	/* Parse the command line: */
+	unsigned int size = 256;
+	unsigned int width = 512;
+	unsigned int height = 512;
+	Scalar stepSize = 1.0f;
+	bool clip = false;
+	const char * imageFileName = "SoftwareRaycaster.ppm";
+	long numCpus = sysconf(_SC_NPROCESSORS_ONLN);
+	int maxNumThreads = numCpus < 1 ? 1 : int(numCpus);
+	for (int i = 1; i < argc; ++i) {
+		if (strcasecmp(argv[i], "-size") == 0 && i + 1 < argc) {
+			size = (unsigned int) atoi(argv[++i]);
+		} else if (strcasecmp(argv[i], "-image") == 0 && i + 2 < argc) {
+			width = (unsigned int) atoi(argv[++i]);
+			height = (unsigned int) atoi(argv[++i]);
+		} else if (strcasecmp(argv[i], "-stepSize") == 0 && i + 1 < argc) {
+			stepSize = Scalar(atof(argv[++i]));
+		} else if (strcasecmp(argv[i], "-clip") == 0) {
+			clip = true;
+		} else if (strcasecmp(argv[i], "-threads") == 0 && i + 1 < argc) {
+			maxNumThreads = atoi(argv[++i]);
+		} else if (strcasecmp(argv[i], "-o") == 0 && i + 1 < argc) {
+			imageFileName = argv[++i];
+		}
+	}
+
+	/* Create a raycaster for a volume in the unit cube: */
+	unsigned int dataSize[3] = { size, size, size };
+	SoftwareRaycaster raycaster(dataSize, Box(Point(0.0f, 0.0f, 0.0f),
+			Point(1.0f, 1.0f, 1.0f)));
+	SoftwareRaycaster::Voxel * data = raycaster.getData();
+	const ptrdiff_t * dataStrides = raycaster.getDataStrides();
+	double cellSize = 1.0 / double(size - 1);
+	for (unsigned int z = 0; z < size; ++z) {
+		for (unsigned int y = 0; y < size; ++y) {
+			for (unsigned int x = 0; x < size; ++x) {
+				data[x * dataStrides[0] + y * dataStrides[1] + z
+						* dataStrides[2]] = SoftwareRaycaster::Voxel(calcValue(
+						double(x) * cellSize, double(y) * cellSize, double(z)
+								* cellSize) * 65535.0 + 0.5);
+			}
+		}
+	}
+	raycaster.updateData();
+
+	/* Use a color map that hides the low values between the shells: */
+	GLColorMap::Color colors[3];
+	colors[0] = GLColorMap::Color(0.0f, 0.0f, 1.0f, 0.0f);
+	colors[1] = GLColorMap::Color(0.0f, 1.0f, 0.0f, 0.0f);
+	colors[2] = GLColorMap::Color(1.0f, 0.0f, 0.0f, 0.5f);
+	GLdouble keys[3] = { 0.0, 0.3, 1.0 };
+	GLColorMap colorMap(3, colors, keys);
+	raycaster.setColorMap(&colorMap);
+	raycaster.setStepSize(stepSize);
+
+	/* Look at the volume from a corner, optionally cutting away its front half: */
+	PTransform pmv = calcViewMatrix(Point(2.2f, -1.6f, 1.8f), Point(0.5f,
+			0.5f, 0.5f), 40.0, double(width) / double(height));
+	std::vector<Plane> clipPlanes;
+	if (clip) {
+		clipPlanes.push_back(Plane(Plane::Vector(1.0f, -1.0f, 0.0f), 0.0f));
+	}
+
+	/* Render the image with 1, 2, 4, ... threads: */
+	std::vector<GLfloat> image(size_t(width) * size_t(height) * 4);
+	std::cout << size << "^3 voxels, " << width << "x" << height
+			<< " pixels, step size " << stepSize << ":" << std::endl;
+	double singleThreadTime = 0.0;
+	for (int numThreads = 1;; numThreads *= 2) {
+		if (numThreads > maxNumThreads) {
+			numThreads = maxNumThreads;
+		}
+		raycaster.setNumThreads(numThreads);
+		Misc::Timer timer;
+		raycaster.renderImage(pmv, clipPlanes, width, height, &image[0]);
+		timer.elapse();
+		if (numThreads == 1) {
+			singleThreadTime = timer.getTime();
+		}
+		std::cout << "  " << numThreads << " threads: " << timer.getTime()
+				* 1000.0 << " ms, speed-up " << singleThreadTime
+				/ timer.getTime() << std::endl;
+		if (numThreads == maxNumThreads) {
+			break;
+		}
+	}
+
+	/* Save the image over a white background: */
+	GLfloat backgroundColor[3] = { 1.0f, 1.0f, 1.0f };
+	SoftwareRaycaster::saveImage(imageFileName, width, height, &image[0],
+			backgroundColor);
+	std::cout << "Saved image to " << imageFileName << std::endl;
+
+	return 0;
+} // end main()
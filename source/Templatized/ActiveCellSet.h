@@ -0,0 +1,236 @@
+/***********************************************************************
+ActiveCellSet - Class to track the set of cells intersected by the
+isosurface of a changing isovalue. Cells are sorted by the minimum and
+by the maximum of their vertex values, so changing the isovalue only
+touches cells whose value ranges start or end between the old and the
+new isovalue.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_ACTIVECELLSET_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_ACTIVECELLSET_INCLUDED
+
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class DataSetParam,class ScalarExtractorParam>
+class ActiveCellSet
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSetParam DataSet; // Type of data set
+	typedef typename DataSet::CellID CellID; // Type of data set's cell IDs
+	typedef ScalarExtractorParam ScalarExtractor; // Type to extract scalar values from a data set
+	typedef typename ScalarExtractor::Scalar VScalar; // Value type of scalar extractor
+	
+	private:
+	typedef typename DataSet::CellTopology CellTopology; // Topology of the data set's cells
+	typedef typename DataSet::CellIterator CellIterator; // Type to iterate through data set's cells
+	
+	struct CellInterval // Structure describing the range of vertex values of a cell
+		{
+		/* Elements: */
+		public:
+		VScalar min,max; // Smallest and largest vertex value of the cell
+		size_t cellIndex; // Index of the cell in the cell ID list
+		};
+	
+	struct MinLess // Functor to compare cell intervals by minimum value
+		{
+		/* Methods: */
+		public:
+		bool operator()(const CellInterval& ci1,const CellInterval& ci2) const
+			{
+			return ci1.min<ci2.min;
+			}
+		bool operator()(const CellInterval& ci,VScalar value) const
+			{
+			return ci.min<value;
+			}
+		};
+	
+	struct MaxLess // Functor to compare cell intervals by maximum value
+		{
+		/* Methods: */
+		public:
+		bool operator()(const CellInterval& ci1,const CellInterval& ci2) const
+			{
+			return ci1.max<ci2.max;
+			}
+		bool operator()(const CellInterval& ci,VScalar value) const
+			{
+			return ci.max<value;
+			}
+		};
+	
+	typedef typename std::vector<CellInterval>::const_iterator IntervalIterator;
+	
+	/* Elements: */
+	std::vector<CellID> cellIDs; // IDs of all cells of the data set
+	std::vector<CellInterval> byMin; // Cell intervals sorted by minimum value
+	std::vector<CellInterval> byMax; // Cell intervals sorted by maximum value
+	std::vector<size_t> activePositions; // Position of each cell in the active cell list, or invalidPosition if the cell is inactive
+	std::vector<size_t> activeCells; // Indices of all active cells, sorted by cell index
+	bool haveIsovalue; // Flag whether the active cell list belongs to the current isovalue
+	VScalar isovalue; // Isovalue of the active cell list
+	
+	static const size_t invalidPosition=~size_t(0); // Position of inactive cells
+	
+	/* Private methods: */
+	void activate(size_t cellIndex) // Adds a cell to the active cell list
+		{
+		if(activePositions[cellIndex]==invalidPosition)
+			{
+			activePositions[cellIndex]=activeCells.size();
+			activeCells.push_back(cellIndex);
+			}
+		}
+	void deactivate(size_t cellIndex) // Removes a cell from the active cell list
+		{
+		size_t position=activePositions[cellIndex];
+		if(position!=invalidPosition)
+			{
+			/* Move the last active cell into the removed cell's position: */
+			size_t lastCellIndex=activeCells.back();
+			activeCells[position]=lastCellIndex;
+			activePositions[lastCellIndex]=position;
+			activeCells.pop_back();
+			activePositions[cellIndex]=invalidPosition;
+			}
+		}
+	
+	/* Constructors and destructors: */
+	public:
+	ActiveCellSet(void) // Creates an empty active cell set
+		:haveIsovalue(false),isovalue(0)
+		{
+		}
+	
+	/* Methods: */
+	bool isValid(void) const // Returns true if the cell intervals have been calculated
+		{
+		return !cellIDs.empty();
+		}
+	void clear(void) // Releases all cell intervals
+		{
+		std::vector<CellID>().swap(cellIDs);
+		std::vector<CellInterval>().swap(byMin);
+		std::vector<CellInterval>().swap(byMax);
+		std::vector<size_t>().swap(activePositions);
+		std::vector<size_t>().swap(activeCells);
+		haveIsovalue=false;
+		}
+	void build(const DataSet& dataSet,const ScalarExtractor& scalarExtractor) // Calculates and sorts the value ranges of all cells of the given data set
+		{
+		clear();
+		
+		/* Calculate all cells' value ranges: */
+		for(CellIterator cIt=dataSet.beginCells();cIt!=dataSet.endCells();++cIt)
+			{
+			CellInterval ci;
+			ci.min=ci.max=cIt->getVertexValue(0,scalarExtractor);
+			for(int i=1;i<CellTopology::numVertices;++i)
+				{
+				VScalar value=cIt->getVertexValue(i,scalarExtractor);
+				if(ci.min>value)
+					ci.min=value;
+				else if(ci.max<value)
+					ci.max=value;
+				}
+			ci.cellIndex=cellIDs.size();
+			cellIDs.push_back(cIt->getID());
+			byMin.push_back(ci);
+			}
+		
+		/* Sort the value ranges: */
+		byMax=byMin;
+		std::sort(byMin.begin(),byMin.end(),MinLess());
+		std::sort(byMax.begin(),byMax.end(),MaxLess());
+		activePositions.resize(cellIDs.size(),size_t(invalidPosition));
+		}
+	void setIsovalue(VScalar newIsovalue) // Updates the active cell list for the given isovalue
+		{
+		/* A cell is active if some of its vertices are below, and others at or above, the isovalue: */
+		if(!haveIsovalue)
+			{
+			/* Find all active cells among the cells whose minimum is below the new isovalue: */
+			IntervalIterator end=std::lower_bound(byMin.begin(),byMin.end(),newIsovalue,MinLess());
+			for(IntervalIterator ciIt=byMin.begin();ciIt!=end;++ciIt)
+				if(ciIt->max>=newIsovalue)
+					activate(ciIt->cellIndex);
+			}
+		else if(newIsovalue>isovalue)
+			{
+			/* Deactivate the cells whose maximum is no longer at or above the new isovalue: */
+			IntervalIterator begin=std::lower_bound(byMax.begin(),byMax.end(),isovalue,MaxLess());
+			IntervalIterator end=std::lower_bound(begin,IntervalIterator(byMax.end()),newIsovalue,MaxLess());
+			for(IntervalIterator ciIt=begin;ciIt!=end;++ciIt)
+				deactivate(ciIt->cellIndex);
+			
+			/* Activate the cells whose minimum is now below the new isovalue: */
+			begin=std::lower_bound(byMin.begin(),byMin.end(),isovalue,MinLess());
+			end=std::lower_bound(begin,IntervalIterator(byMin.end()),newIsovalue,MinLess());
+			for(IntervalIterator ciIt=begin;ciIt!=end;++ciIt)
+				if(ciIt->max>=newIsovalue)
+					activate(ciIt->cellIndex);
+			}
+		else if(newIsovalue<isovalue)
+			{
+			/* Deactivate the cells whose minimum is no longer below the new isovalue: */
+			IntervalIterator begin=std::lower_bound(byMin.begin(),byMin.end(),newIsovalue,MinLess());
+			IntervalIterator end=std::lower_bound(begin,IntervalIterator(byMin.end()),isovalue,MinLess());
+			for(IntervalIterator ciIt=begin;ciIt!=end;++ciIt)
+				deactivate(ciIt->cellIndex);
+			
+			/* Activate the cells whose maximum is now at or above the new isovalue: */
+			begin=std::lower_bound(byMax.begin(),byMax.end(),newIsovalue,MaxLess());
+			end=std::lower_bound(begin,IntervalIterator(byMax.end()),isovalue,MaxLess());
+			for(IntervalIterator ciIt=begin;ciIt!=end;++ciIt)
+				if(ciIt->min<newIsovalue)
+					activate(ciIt->cellIndex);
+			}
+		
+		/* Sort the active cells by index, such that blocks of consecutive active cells are spatially compact and share most of their edges: */
+		std::sort(activeCells.begin(),activeCells.end());
+		for(size_t i=0;i<activeCells.size();++i)
+			activePositions[activeCells[i]]=i;
+		
+		haveIsovalue=true;
+		isovalue=newIsovalue;
+		}
+	size_t getNumActiveCells(void) const // Returns the number of cells active for the current isovalue
+		{
+		return activeCells.size();
+		}
+	const CellID& getActiveCellID(size_t index) const // Returns the ID of the given active cell
+		{
+		return cellIDs[activeCells[index]];
+		}
+	};
+
+}
+
+}
+
+#endif
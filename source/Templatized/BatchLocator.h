@@ -0,0 +1,224 @@
+/***********************************************************************
+BatchLocator - Class to locate and evaluate many points in a data set at
+once. Queries are processed in spatially coherent order, so each point
+is found by tracing from the cell of the previous point instead of by a
+global search. Data sets whose locators compute cell indices directly
+from point positions skip the sorting and tracing altogether.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_BATCHLOCATOR_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_BATCHLOCATOR_INCLUDED
+
+#include <stddef.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/* Forward declarations: */
+namespace Visualization {
+namespace Templatized {
+template <class ScalarParam,int dimensionParam,class ValueParam>
+class Cartesian;
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class SlicedCartesian;
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class SlicedRectilinear;
+}
+}
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class DataSetParam>
+class BatchLocatorTraits // Traits class describing how a data set's locators find query points
+	{
+	/* Elements: */
+	public:
+	static const bool directIndex=false; // Flag if locators calculate a point's cell directly from its position instead of tracing or searching
+	};
+
+template <class ScalarParam,int dimensionParam,class ValueParam>
+class BatchLocatorTraits<Cartesian<ScalarParam,dimensionParam,ValueParam> >
+	{
+	/* Elements: */
+	public:
+	static const bool directIndex=true;
+	};
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class BatchLocatorTraits<SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam> >
+	{
+	/* Elements: */
+	public:
+	static const bool directIndex=true;
+	};
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class BatchLocatorTraits<SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam> > // Rectilinear locators find cells independently along each axis; directly on uniform axes, by a search starting from the previous cell on others
+	{
+	/* Elements: */
+	public:
+	static const bool directIndex=true;
+	};
+
+template <class DataSetParam>
+class BatchLocator
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSetParam DataSet; // Type of data set
+	typedef typename DataSet::Scalar Scalar; // Scalar type of data set's domain
+	static const int dimension=DataSet::dimension; // Dimension of data set's domain
+	typedef typename DataSet::Point Point; // Type for points in data set's domain
+	typedef typename DataSet::Locator Locator; // Type of data set's locators
+	
+	struct CellHit // Structure describing the cell containing a query point and the point's local coordinates inside it
+		{
+		/* Elements: */
+		Locator locator; // Locator positioned at the query point
+		bool valid; // Flag if the query point is inside the data set's domain
+		
+		/* Constructors and destructors: */
+		CellHit(void)
+			:valid(false)
+			{
+			}
+		};
+	
+	private:
+	typedef unsigned long long SortKey; // Type for Morton codes of query points
+	typedef std::pair<SortKey,size_t> SortEntry; // Type associating a query point's Morton code with its index
+	
+	/* Elements: */
+	Locator locator; // Locator tracing through the data set from query point to query point
+	bool canTrace; // Flag if the locator is positioned inside a cell from which it can trace to the next query point
+	bool sortQueries; // Flag whether to process queries in spatially coherent order
+	size_t minSortedQueries; // Smallest number of queries that is sorted
+	std::vector<SortEntry> order; // Processing order of the most recent batch of queries
+	
+	/* Private methods: */
+	void sortPoints(const Point* points,size_t numPoints) // Sorts the query points along a Morton curve through their bounding box
+		{
+		/* Calculate the query points' bounding box: */
+		Point min=points[0];
+		Point max=points[0];
+		for(size_t i=1;i<numPoints;++i)
+			for(int j=0;j<dimension;++j)
+				{
+				if(min[j]>points[i][j])
+					min[j]=points[i][j];
+				else if(max[j]<points[i][j])
+					max[j]=points[i][j];
+				}
+		
+		/* Quantize the points to as many bits per dimension as fit into a sort key: */
+		int numBits=int(sizeof(SortKey)*8-1)/dimension;
+		if(numBits>16)
+			numBits=16;
+		double numSteps=double((1U<<numBits)-1U);
+		double scale[dimension];
+		for(int j=0;j<dimension;++j)
+			scale[j]=max[j]>min[j]?numSteps/(double(max[j])-double(min[j])):0.0;
+		order.resize(numPoints);
+		for(size_t i=0;i<numPoints;++i)
+			{
+			/* Interleave the bits of the quantized coordinates: */
+			unsigned int q[dimension];
+			for(int j=0;j<dimension;++j)
+				q[j]=(unsigned int)((double(points[i][j])-double(min[j]))*scale[j]+0.5);
+			SortKey key=0;
+			for(int bit=numBits-1;bit>=0;--bit)
+				for(int j=0;j<dimension;++j)
+					key=(key<<1)|SortKey((q[j]>>bit)&1U);
+			order[i]=SortEntry(key,i);
+			}
+		std::sort(order.begin(),order.end());
+		}
+	void locatePoint(const Point& point,CellHit& hit) // Locates a single query point, tracing from the previous query point's cell if possible
+		{
+		/* Tracing can miss points that a search from scratch finds, so retry after a tracing failure: */
+		bool valid=locator.locatePoint(point,canTrace);
+		if(!valid&&canTrace)
+			valid=locator.locatePoint(point,false);
+		canTrace=valid;
+		
+		hit.locator=locator;
+		hit.valid=valid;
+		}
+	
+	/* Constructors and destructors: */
+	public:
+	BatchLocator(const Locator& sLocator) // Creates a batch locator from an unpositioned locator for a data set
+		:locator(sLocator),canTrace(false),
+		 sortQueries(true),minSortedQueries(64)
+		{
+		}
+	
+	/* Methods: */
+	bool getSortQueries(void) const // Returns true if queries are processed in spatially coherent order
+		{
+		return sortQueries;
+		}
+	void setSortQueries(bool newSortQueries) // Enables or disables sorting of queries; should be disabled if queries are already coherent
+		{
+		sortQueries=newSortQueries;
+		}
+	void locatePoints(const Point* points,size_t numPoints,CellHit* hits) // Locates the given points; hit i describes point i
+		{
+		canTrace=false;
+		if(BatchLocatorTraits<DataSet>::directIndex)
+			{
+			/* Locate the points in the given order; each point's cell is found directly, and a failed location can not be recovered by a search: */
+			for(size_t i=0;i<numPoints;++i)
+				{
+				hits[i].valid=locator.locatePoint(points[i],canTrace);
+				hits[i].locator=locator;
+				canTrace=true;
+				}
+			}
+		else if(sortQueries&&numPoints>=minSortedQueries)
+			{
+			/* Locate the points in spatially coherent order: */
+			sortPoints(points,numPoints);
+			for(typename std::vector<SortEntry>::const_iterator oIt=order.begin();oIt!=order.end();++oIt)
+				locatePoint(points[oIt->second],hits[oIt->second]);
+			}
+		else
+			{
+			/* Locate the points in the given order: */
+			for(size_t i=0;i<numPoints;++i)
+				locatePoint(points[i],hits[i]);
+			}
+		}
+	template <class ValueExtractorParam,class DestValueParam>
+	void calcValues(const CellHit* hits,size_t numHits,const ValueExtractorParam& extractor,DestValueParam* values) const // Evaluates the given extractor at the given hits; leaves values of invalid hits unchanged
+		{
+		for(size_t i=0;i<numHits;++i)
+			if(hits[i].valid)
+				values[i]=DestValueParam(hits[i].locator.calcValue(extractor));
+		}
+	};
+
+}
+
+}
+
+#endif
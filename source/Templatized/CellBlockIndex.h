@@ -0,0 +1,496 @@
+/***********************************************************************
+CellBlockIndex - Class to accelerate global extraction by splitting a
+data set's cells into blocks and storing the value range of a scalar
+variable and the bounding box of each block. Structured grids are split
+into spatially compact tiles of cells; other data sets into runs of
+consecutive cells. Blocks whose value range does not contain an
+isovalue are skipped by an interval tree over the blocks' value ranges,
+and blocks whose bounding box does not straddle a slicing plane are
+skipped without looking at their cells.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_CELLBLOCKINDEX_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_CELLBLOCKINDEX_INCLUDED
+
+#include <stddef.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <Geometry/Box.h>
+#include <Geometry/Plane.h>
+
+/* Forward declarations: */
+namespace Visualization {
+namespace Templatized {
+template <class ScalarParam,int dimensionParam,class ValueParam>
+class Cartesian;
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class SlicedCartesian;
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class SlicedRectilinear;
+template <class ScalarParam,int dimensionParam,class ValueParam>
+class Curvilinear;
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class SlicedCurvilinear;
+}
+}
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class DataSetParam>
+class CellBlockLayout // Generic class splitting a data set's cell list into runs of consecutive cells
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSetParam DataSet; // Type of data set
+	typedef typename DataSet::CellIterator CellIterator; // Type to iterate through data set's cells
+	typedef std::pair<CellIterator,CellIterator> CellRange; // Type for half-open ranges of cells
+	typedef CellRange Tile; // Type describing the cells of a block
+	
+	/* Methods: */
+	static void split(const DataSet& dataSet,size_t cellBlockSize,std::vector<Tile>& tiles) // Splits the data set's cells into blocks of the given size
+		{
+		CellIterator cIt=dataSet.beginCells();
+		CellIterator cEnd=dataSet.endCells();
+		while(cIt!=cEnd)
+			{
+			CellIterator blockBegin=cIt;
+			for(size_t i=0;i<cellBlockSize&&cIt!=cEnd;++i)
+				++cIt;
+			tiles.push_back(Tile(blockBegin,cIt));
+			}
+		}
+	static void appendRanges(const DataSet& dataSet,const Tile& tile,std::vector<CellRange>& ranges) // Appends the cell ranges covering the given block
+		{
+		ranges.push_back(tile);
+		}
+	};
+
+template <class DataSetParam>
+class StructuredCellBlockLayout // Class splitting the cells of a structured grid into tiles of about equal extent along all axes
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSetParam DataSet; // Type of data set
+	static const int dimension=DataSet::dimension; // Dimension of data set's domain
+	typedef typename DataSet::Index Index; // Type for cell indices
+	typedef typename DataSet::CellID CellID; // Type for cell IDs
+	typedef typename DataSet::CellIterator CellIterator; // Type to iterate through data set's cells
+	typedef std::pair<CellIterator,CellIterator> CellRange; // Type for half-open ranges of cells
+	
+	struct Tile // Structure describing a tile of cells by its half-open range of cell indices
+		{
+		/* Elements: */
+		public:
+		Index begin,end; // Index bounds of the tile's cells
+		};
+	
+	/* Private methods: */
+	private:
+	static CellIterator getCellIterator(const DataSet& dataSet,const Index& cellIndex) // Returns an iterator to the cell of the given index, or behind the last cell
+		{
+		if(cellIndex[0]>=dataSet.getNumCells()[0])
+			return dataSet.endCells();
+		return CellIterator(dataSet.getCell(CellID(typename CellID::Index(dataSet.getNumVertices().calcOffset(cellIndex)))));
+		}
+	
+	/* Methods: */
+	public:
+	static void split(const DataSet& dataSet,size_t cellBlockSize,std::vector<Tile>& tiles) // Splits the data set's cells into tiles containing at most the given number of cells
+		{
+		/* Find the largest tile extent whose tiles fit into a block: */
+		int tileSize=1;
+		while(true)
+			{
+			size_t tileCells=1;
+			for(int i=0;i<dimension;++i)
+				tileCells*=size_t(tileSize+1);
+			if(tileCells>cellBlockSize)
+				break;
+			++tileSize;
+			}
+		
+		/* Create the tiles in cell order: */
+		const Index& numCells=dataSet.getNumCells();
+		for(int i=0;i<dimension;++i)
+			if(numCells[i]<=0)
+				return;
+		Index numTiles;
+		for(int i=0;i<dimension;++i)
+			numTiles[i]=(numCells[i]+tileSize-1)/tileSize;
+		Index tileIndex(0);
+		while(tileIndex[0]<numTiles[0])
+			{
+			Tile tile;
+			for(int i=0;i<dimension;++i)
+				{
+				tile.begin[i]=tileIndex[i]*tileSize;
+				tile.end[i]=tile.begin[i]+tileSize;
+				if(tile.end[i]>numCells[i])
+					tile.end[i]=numCells[i];
+				}
+			tiles.push_back(tile);
+			tileIndex.preInc(numTiles);
+			}
+		}
+	static void appendRanges(const DataSet& dataSet,const Tile& tile,std::vector<CellRange>& ranges) // Appends the ranges of cells along the fastest-varying axis covering the given tile
+		{
+		const Index& numCells=dataSet.getNumCells();
+		Index rowBegin=tile.begin;
+		while(rowBegin[0]<tile.end[0])
+			{
+			/* Find the cell behind the row in cell order: */
+			Index rowEnd=rowBegin;
+			if(tile.end[dimension-1]<numCells[dimension-1])
+				rowEnd[dimension-1]=tile.end[dimension-1];
+			else
+				{
+				rowEnd[dimension-1]=numCells[dimension-1]-1;
+				rowEnd.preInc(numCells);
+				}
+			
+			/* Extend the previous range if the row follows it directly, as it does if the tile spans the fastest-varying axis: */
+			CellIterator begin=getCellIterator(dataSet,rowBegin);
+			if(!ranges.empty()&&ranges.back().second==begin)
+				ranges.back().second=getCellIterator(dataSet,rowEnd);
+			else
+				ranges.push_back(CellRange(begin,getCellIterator(dataSet,rowEnd)));
+			
+			/* Go to the next row of the tile: */
+			int i;
+			for(i=dimension-2;i>=0;--i)
+				{
+				if(++rowBegin[i]<tile.end[i])
+					break;
+				rowBegin[i]=tile.begin[i];
+				}
+			if(i<0)
+				break;
+			}
+		}
+	};
+
+template <class ScalarParam,int dimensionParam,class ValueParam>
+class CellBlockLayout<Cartesian<ScalarParam,dimensionParam,ValueParam> >:public StructuredCellBlockLayout<Cartesian<ScalarParam,dimensionParam,ValueParam> >
+	{
+	};
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class CellBlockLayout<SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam> >:public StructuredCellBlockLayout<SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam> >
+	{
+	};
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class CellBlockLayout<SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam> >:public StructuredCellBlockLayout<SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam> >
+	{
+	};
+
+template <class ScalarParam,int dimensionParam,class ValueParam>
+class CellBlockLayout<Curvilinear<ScalarParam,dimensionParam,ValueParam> >:public StructuredCellBlockLayout<Curvilinear<ScalarParam,dimensionParam,ValueParam> >
+	{
+	};
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class CellBlockLayout<SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam> >:public StructuredCellBlockLayout<SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam> >
+	{
+	};
+
+template <class DataSetParam,class ScalarExtractorParam>
+class CellBlockIndex
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSetParam DataSet; // Type of data set
+	typedef typename DataSet::Scalar Scalar; // Scalar type of data set's domain
+	static const int dimension=DataSet::dimension; // Dimension of data set's domain
+	typedef typename DataSet::Point Point; // Type for points in data set's domain
+	typedef Geometry::Box<Scalar,dimension> Box; // Type for axis-aligned boxes in data set's domain
+	typedef Geometry::Plane<Scalar,dimension> Plane; // Type for planes in data set's domain
+	typedef typename DataSet::CellIterator CellIterator; // Type to iterate through data set's cells
+	typedef std::pair<CellIterator,CellIterator> CellRange; // Type for half-open ranges of cells
+	typedef ScalarExtractorParam ScalarExtractor; // Type to extract scalar values from a data set
+	typedef typename ScalarExtractor::Scalar VScalar; // Value type of scalar extractor
+	
+	private:
+	typedef typename DataSet::CellTopology CellTopology; // Topology of the data set's cells
+	typedef CellBlockLayout<DataSet> Layout; // Class splitting the data set's cells into blocks
+	typedef typename Layout::Tile Tile; // Type describing the cells of a block
+	
+	struct Block // Structure describing a block of cells
+		{
+		/* Elements: */
+		public:
+		Tile cells; // The block's cells
+		VScalar minValue,maxValue; // Range of scalar values at the block's cell vertices
+		Box box; // Bounding box of the block's cell vertices
+		};
+	
+	struct IntervalNode // Structure for nodes of the interval tree over the blocks' value ranges
+		{
+		/* Elements: */
+		public:
+		VScalar center; // Value separating the node's subtrees; the node stores the blocks whose value ranges contain it
+		size_t begin,end; // Range of the node's blocks in the by-minimum and by-maximum block lists
+		size_t left,right; // Indices of the child nodes for smaller and larger value ranges, or ~0 for none
+		};
+	
+	class MinValueLess // Functor class to sort blocks by ascending minimum value
+		{
+		/* Elements: */
+		private:
+		const std::vector<Block>& blocks;
+		
+		/* Constructors and destructors: */
+		public:
+		MinValueLess(const std::vector<Block>& sBlocks)
+			:blocks(sBlocks)
+			{
+			}
+		
+		/* Methods: */
+		bool operator()(size_t b1,size_t b2) const
+			{
+			return blocks[b1].minValue<blocks[b2].minValue;
+			}
+		};
+	
+	class MaxValueGreater // Functor class to sort blocks by descending maximum value
+		{
+		/* Elements: */
+		private:
+		const std::vector<Block>& blocks;
+		
+		/* Constructors and destructors: */
+		public:
+		MaxValueGreater(const std::vector<Block>& sBlocks)
+			:blocks(sBlocks)
+			{
+			}
+		
+		/* Methods: */
+		bool operator()(size_t b1,size_t b2) const
+			{
+			return blocks[b1].maxValue>blocks[b2].maxValue;
+			}
+		};
+	
+	/* Elements: */
+	const DataSet* dataSet; // Data set whose cells are indexed
+	std::vector<Block> blocks; // List of blocks in cell order
+	std::vector<IntervalNode> nodes; // Nodes of the interval tree; the first node is the root
+	std::vector<size_t> blocksByMin; // Indices of each node's blocks sorted by ascending minimum value
+	std::vector<size_t> blocksByMax; // Indices of each node's blocks sorted by descending maximum value
+	
+	/* Private methods: */
+	size_t buildNode(std::vector<size_t>& nodeBlocks) // Builds an interval tree node for the given non-empty list of blocks; returns the node's index
+		{
+		/* Use the median of the blocks' maximum values as the node's center: */
+		std::nth_element(nodeBlocks.begin(),nodeBlocks.begin()+nodeBlocks.size()/2,nodeBlocks.end(),MaxValueGreater(blocks));
+		VScalar center=blocks[nodeBlocks[nodeBlocks.size()/2]].maxValue;
+		
+		/* Distribute the blocks to the node and its subtrees: */
+		std::vector<size_t> leftBlocks,rightBlocks;
+		size_t begin=blocksByMin.size();
+		for(std::vector<size_t>::const_iterator nbIt=nodeBlocks.begin();nbIt!=nodeBlocks.end();++nbIt)
+			{
+			if(blocks[*nbIt].maxValue<center)
+				leftBlocks.push_back(*nbIt);
+			else if(blocks[*nbIt].minValue>=center)
+				rightBlocks.push_back(*nbIt);
+			else
+				{
+				blocksByMin.push_back(*nbIt);
+				blocksByMax.push_back(*nbIt);
+				}
+			}
+		std::vector<size_t>().swap(nodeBlocks);
+		size_t end=blocksByMin.size();
+		std::sort(blocksByMin.begin()+begin,blocksByMin.end(),MinValueLess(blocks));
+		std::sort(blocksByMax.begin()+begin,blocksByMax.end(),MaxValueGreater(blocks));
+		
+		/* Create the node and its children: */
+		size_t nodeIndex=nodes.size();
+		IntervalNode node;
+		node.center=center;
+		node.begin=begin;
+		node.end=end;
+		node.left=node.right=~size_t(0);
+		nodes.push_back(node);
+		if(!leftBlocks.empty())
+			{
+			size_t left=buildNode(leftBlocks);
+			nodes[nodeIndex].left=left;
+			}
+		if(!rightBlocks.empty())
+			{
+			size_t right=buildNode(rightBlocks);
+			nodes[nodeIndex].right=right;
+			}
+		
+		return nodeIndex;
+		}
+	void findBlocks(VScalar isovalue,std::vector<size_t>& blockIndices) const // Appends the indices of all blocks whose value ranges contain the given isovalue
+		{
+		/* A cell contributes to the isosurface if some of its vertices are below, and others at or above, the isovalue: */
+		size_t nodeIndex=nodes.empty()?~size_t(0):0;
+		while(nodeIndex!=~size_t(0))
+			{
+			const IntervalNode& node=nodes[nodeIndex];
+			if(isovalue<=node.center)
+				{
+				/* All of the node's blocks reach up to the isovalue; take those that start below it: */
+				for(size_t i=node.begin;i<node.end&&blocks[blocksByMin[i]].minValue<isovalue;++i)
+					blockIndices.push_back(blocksByMin[i]);
+				nodeIndex=node.left;
+				}
+			else
+				{
+				/* All of the node's blocks start below the isovalue; take those that reach up to it: */
+				for(size_t i=node.begin;i<node.end&&blocks[blocksByMax[i]].maxValue>=isovalue;++i)
+					blockIndices.push_back(blocksByMax[i]);
+				nodeIndex=node.right;
+				}
+			}
+		}
+	
+	/* Constructors and destructors: */
+	public:
+	CellBlockIndex(void) // Creates an empty index
+		:dataSet(0)
+		{
+		}
+	
+	/* Methods: */
+	bool isValid(void) const // Returns true if the index has been built
+		{
+		return !blocks.empty();
+		}
+	size_t getNumBlocks(void) const // Returns the number of blocks in the index
+		{
+		return blocks.size();
+		}
+	void clear(void) // Releases all blocks
+		{
+		dataSet=0;
+		std::vector<Block>().swap(blocks);
+		std::vector<IntervalNode>().swap(nodes);
+		std::vector<size_t>().swap(blocksByMin);
+		std::vector<size_t>().swap(blocksByMax);
+		}
+	void build(const DataSet& sDataSet,const ScalarExtractor& scalarExtractor,size_t cellBlockSize) // Splits the data set's cells into blocks of at most the given size and calculates the blocks' value ranges and bounding boxes
+		{
+		clear();
+		dataSet=&sDataSet;
+		
+		/* Split the data set's cells into blocks: */
+		std::vector<Tile> tiles;
+		Layout::split(*dataSet,cellBlockSize,tiles);
+		blocks.reserve(tiles.size());
+		std::vector<CellRange> ranges;
+		for(typename std::vector<Tile>::const_iterator tIt=tiles.begin();tIt!=tiles.end();++tIt)
+			{
+			ranges.clear();
+			Layout::appendRanges(*dataSet,*tIt,ranges);
+			
+			/* Calculate the block's value range and bounding box: */
+			Block block;
+			block.cells=*tIt;
+			VScalar firstValue=ranges.front().first->getVertexValue(0,scalarExtractor);
+			block.minValue=block.maxValue=firstValue;
+			block.box=Box::empty;
+			for(typename std::vector<CellRange>::const_iterator rIt=ranges.begin();rIt!=ranges.end();++rIt)
+				for(CellIterator cIt=rIt->first;cIt!=rIt->second;++cIt)
+					for(int j=0;j<CellTopology::numVertices;++j)
+						{
+						VScalar value=cIt->getVertexValue(j,scalarExtractor);
+						if(block.minValue>value)
+							block.minValue=value;
+						else if(block.maxValue<value)
+							block.maxValue=value;
+						block.box.addPoint(cIt->getVertexPosition(j));
+						}
+			blocks.push_back(block);
+			}
+		
+		/* Build the interval tree over all blocks that can intersect any isosurface: */
+		std::vector<size_t> treeBlocks;
+		for(size_t i=0;i<blocks.size();++i)
+			if(blocks[i].minValue<blocks[i].maxValue)
+				treeBlocks.push_back(i);
+		if(!treeBlocks.empty())
+			buildNode(treeBlocks);
+		}
+	void findIsosurfaceBlocks(VScalar isovalue,std::vector<CellRange>& ranges) const // Appends the cell ranges of all blocks that can intersect the isosurface of the given isovalue
+		{
+		std::vector<size_t> blockIndices;
+		findBlocks(isovalue,blockIndices);
+		
+		/* Visit the blocks in cell order: */
+		std::sort(blockIndices.begin(),blockIndices.end());
+		for(std::vector<size_t>::const_iterator biIt=blockIndices.begin();biIt!=blockIndices.end();++biIt)
+			Layout::appendRanges(*dataSet,blocks[*biIt].cells,ranges);
+		}
+	void findIsosurfaceBlocks(const std::vector<VScalar>& isovalues,std::vector<CellRange>& ranges) const // Appends the cell ranges of all blocks that can intersect the isosurface of any of the given isovalues
+		{
+		std::vector<size_t> blockIndices;
+		for(typename std::vector<VScalar>::const_iterator ivIt=isovalues.begin();ivIt!=isovalues.end();++ivIt)
+			findBlocks(*ivIt,blockIndices);
+		
+		/* Visit each block once, in cell order: */
+		std::sort(blockIndices.begin(),blockIndices.end());
+		blockIndices.erase(std::unique(blockIndices.begin(),blockIndices.end()),blockIndices.end());
+		for(std::vector<size_t>::const_iterator biIt=blockIndices.begin();biIt!=blockIndices.end();++biIt)
+			Layout::appendRanges(*dataSet,blocks[*biIt].cells,ranges);
+		}
+	void findSliceBlocks(const Plane& plane,std::vector<CellRange>& ranges) const // Appends the cell ranges of all blocks that can intersect the given plane
+		{
+		/* Find the box corners closest to and farthest from the plane along its normal direction: */
+		const typename Plane::Vector& normal=plane.getNormal();
+		for(typename std::vector<Block>::const_iterator bIt=blocks.begin();bIt!=blocks.end();++bIt)
+			{
+			Point lower,upper;
+			for(int i=0;i<dimension;++i)
+				{
+				if(normal[i]>=Scalar(0))
+					{
+					lower[i]=bIt->box.min[i];
+					upper[i]=bIt->box.max[i];
+					}
+				else
+					{
+					lower[i]=bIt->box.max[i];
+					upper[i]=bIt->box.min[i];
+					}
+				}
+			
+			/* A cell contributes to the slice if some of its vertices are below, and others on or above, the plane: */
+			if(plane.calcDistance(lower)<Scalar(0)&&plane.calcDistance(upper)>=Scalar(0))
+				Layout::appendRanges(*dataSet,bIt->cells,ranges);
+			}
+		}
+	};
+
+}
+
+}
+
+#endif
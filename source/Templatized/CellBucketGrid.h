@@ -0,0 +1,222 @@
+/***********************************************************************
+CellBucketGrid - Class to accelerate point location in curvilinear data
+sets by sorting cells into the buckets of a uniform grid covering the
+data set's domain. Each cell is entered into every bucket its bounding
+box overlaps, so the bucket containing a query point lists all cells that
+can contain the point.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_CELLBUCKETGRID_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_CELLBUCKETGRID_INCLUDED
+
+#include <stddef.h>
+#include <math.h>
+#include <vector>
+#include <Geometry/Box.h>
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class StoredPointParam>
+class CellBucketGrid
+	{
+	/* Embedded classes: */
+	public:
+	typedef StoredPointParam StoredPoint; // Type of stored cell centers, associating a cell's center point and its ID
+	typedef typename StoredPoint::Scalar Scalar;
+	typedef typename StoredPoint::Point Point;
+	static const int dimension=Point::dimension;
+	typedef Geometry::Box<Scalar,dimension> Box;
+	
+	/* Elements: */
+	private:
+	Box domainBox; // Box covered by the bucket grid
+	int numBuckets[dimension]; // Number of buckets in each dimension
+	Scalar bucketScale[dimension]; // Scale factors from domain coordinates to bucket indices
+	std::vector<size_t> bucketStarts; // Index of the first cell of each bucket in the cell list, plus end index of the last bucket
+	std::vector<StoredPoint> cells; // Cell centers of all buckets, sorted by bucket
+	
+	/* Private methods: */
+	void calcBucketRange(const Box& box,int min[dimension],int max[dimension]) const // Calculates the index range of buckets overlapping the given box
+		{
+		for(int i=0;i<dimension;++i)
+			{
+			min[i]=calcBucketIndex(i,box.min[i]);
+			max[i]=calcBucketIndex(i,box.max[i]);
+			}
+		}
+	size_t calcLinearIndex(const int index[dimension]) const // Returns the linear index of the bucket of the given index
+		{
+		size_t result=size_t(index[dimension-1]);
+		for(int i=dimension-2;i>=0;--i)
+			result=result*size_t(numBuckets[i])+size_t(index[i]);
+		return result;
+		}
+	int calcBucketIndex(int dim,Scalar coord) const // Returns the index of the bucket containing the given coordinate, clamped to the grid
+		{
+		int result=int(floor((coord-domainBox.min[dim])*bucketScale[dim]));
+		return result<0?0:result>=numBuckets[dim]?numBuckets[dim]-1:result;
+		}
+	
+	/* Constructors and destructors: */
+	public:
+	CellBucketGrid(void) // Creates an empty bucket grid
+		{
+		for(int i=0;i<dimension;++i)
+			{
+			numBuckets[i]=0;
+			bucketScale[i]=Scalar(0);
+			}
+		}
+	
+	/* Methods: */
+	bool isValid(void) const // Returns true if the bucket grid has been built
+		{
+		return !bucketStarts.empty();
+		}
+	size_t getTotalNumBuckets(void) const // Returns the total number of buckets
+		{
+		return bucketStarts.empty()?0:bucketStarts.size()-1;
+		}
+	size_t getNumEntries(void) const // Returns the total number of cell entries in all buckets
+		{
+		return cells.size();
+		}
+	void clear(void) // Releases all buckets
+		{
+		std::vector<size_t>().swap(bucketStarts);
+		std::vector<StoredPoint>().swap(cells);
+		for(int i=0;i<dimension;++i)
+			numBuckets[i]=0;
+		}
+	void build(const Box& sDomainBox,size_t numCells,const Box* cellBoxes,const StoredPoint* cellCenters,double cellsPerBucket =8.0) // Sorts the given cells into a grid of about numCells/cellsPerBucket buckets, shaped to fit the domain
+		{
+		clear();
+		if(numCells==0)
+			return;
+		domainBox=sDomainBox;
+		
+		/* Calculate a bucket size that gives the requested number of roughly cube-shaped buckets: */
+		double volume=1.0;
+		int numNonEmpty=0;
+		for(int i=0;i<dimension;++i)
+			{
+			double size=double(domainBox.max[i])-double(domainBox.min[i]);
+			if(size>0.0)
+				{
+				volume*=size;
+				++numNonEmpty;
+				}
+			}
+		double targetNumBuckets=double(numCells)/cellsPerBucket;
+		if(targetNumBuckets<1.0)
+			targetNumBuckets=1.0;
+		double bucketSize=numNonEmpty>0?pow(volume/targetNumBuckets,1.0/double(numNonEmpty)):1.0;
+		size_t totalNumBuckets=1;
+		for(int i=0;i<dimension;++i)
+			{
+			double size=double(domainBox.max[i])-double(domainBox.min[i]);
+			numBuckets[i]=size>0.0?int(ceil(size/bucketSize)):1;
+			if(numBuckets[i]<1)
+				numBuckets[i]=1;
+			bucketScale[i]=size>0.0?Scalar(double(numBuckets[i])/size):Scalar(0);
+			totalNumBuckets*=size_t(numBuckets[i]);
+			}
+		
+		/* Count the cells overlapping each bucket: */
+		bucketStarts.resize(totalNumBuckets+1,0);
+		int min[dimension],max[dimension],index[dimension];
+		for(size_t cellIndex=0;cellIndex<numCells;++cellIndex)
+			{
+			calcBucketRange(cellBoxes[cellIndex],min,max);
+			for(int i=0;i<dimension;++i)
+				index[i]=min[i];
+			while(true)
+				{
+				++bucketStarts[calcLinearIndex(index)+1];
+				
+				/* Go to the next overlapping bucket: */
+				int dim;
+				for(dim=0;dim<dimension&&index[dim]==max[dim];++dim)
+					index[dim]=min[dim];
+				if(dim==dimension)
+					break;
+				++index[dim];
+				}
+			}
+		for(size_t i=1;i<=totalNumBuckets;++i)
+			bucketStarts[i]+=bucketStarts[i-1];
+		
+		/* Enter the cells into their buckets: */
+		cells.resize(bucketStarts[totalNumBuckets]);
+		std::vector<size_t> bucketEnds(bucketStarts.begin(),bucketStarts.end()-1);
+		for(size_t cellIndex=0;cellIndex<numCells;++cellIndex)
+			{
+			calcBucketRange(cellBoxes[cellIndex],min,max);
+			for(int i=0;i<dimension;++i)
+				index[i]=min[i];
+			while(true)
+				{
+				cells[bucketEnds[calcLinearIndex(index)]++]=cellCenters[cellIndex];
+				
+				/* Go to the next overlapping bucket: */
+				int dim;
+				for(dim=0;dim<dimension&&index[dim]==max[dim];++dim)
+					index[dim]=min[dim];
+				if(dim==dimension)
+					break;
+				++index[dim];
+				}
+			}
+		}
+	const StoredPoint* findClosestPoint(const Point& queryPosition,Scalar maxDist2) const // Returns the cell center closest to the query position among the cells of the query position's bucket, or null if the position is outside the grid or no center is closer than the given distance
+		{
+		int index[dimension];
+		for(int i=0;i<dimension;++i)
+			{
+			if(queryPosition[i]<domainBox.min[i]||queryPosition[i]>domainBox.max[i])
+				return 0;
+			index[i]=calcBucketIndex(i,queryPosition[i]);
+			}
+		size_t bucketIndex=calcLinearIndex(index);
+		
+		/* Find the closest cell center in the bucket: */
+		const StoredPoint* closestPoint=0;
+		Scalar minDist2=maxDist2;
+		typename std::vector<StoredPoint>::const_iterator bucketEnd=cells.begin()+bucketStarts[bucketIndex+1];
+		for(typename std::vector<StoredPoint>::const_iterator cIt=cells.begin()+bucketStarts[bucketIndex];cIt!=bucketEnd;++cIt)
+			{
+			Scalar dist2=Geometry::sqrDist(*cIt,queryPosition);
+			if(minDist2>dist2)
+				{
+				closestPoint=&*cIt;
+				minDist2=dist2;
+				}
+			}
+		return closestPoint;
+		}
+	};
+
+}
+
+}
+
+#endif
@@ -258,13 +258,12 @@ Curvilinear<ScalarParam,dimensionParam,ValueParam>::Locator::locatePoint(
 	if(!traceHint||cantTrace)
 		{
 		/* Start searching from cell whose cell center is closest to query position: */
-		FindClosestPointFunctor<CellCenter> f(position,ds->maxCellRadius2);
-		ds->cellCenterTree.traverseTreeDirected(f);
-		if(f.getClosestPoint()==0) // Bail out if no cell is close enough
+		const CellCenter* closestCenter=ds->findClosestCellCenter(position);
+		if(closestCenter==0) // Bail out if no cell is close enough
 			return false;
 		
 		/* Go to the found cell: */
-		Cell::operator=(ds->getCell(f.getClosestPoint()->value));
+		Cell::operator=(ds->getCell(closestCenter->value));
 		
 		/* Initialize local cell position: */
 		for(int i=0;i<dimension;++i)
@@ -273,7 +272,7 @@ Curvilinear<ScalarParam,dimensionParam,ValueParam>::Locator::locatePoint(
 		/* Now we can trace: */
 		cantTrace=false;
 		}
-
+	
 	/* Perform Newton-Raphson iteration until it converges and the current cell contains the query point: */
 	Scalar maxOut;
 	CellID previousCellID; // Cell ID to detect "thrashing" between cells
@@ -309,9 +308,8 @@ Curvilinear<ScalarParam,dimensionParam,ValueParam>::Locator::locatePoint(
 		if(iteration==0&&maxOut>Scalar(5))
 			{
 			/* We had a tracing failure; just start searching from scratch: */
-			FindClosestPointFunctor<CellCenter> f(position,ds->maxCellRadius2);
-			ds->cellCenterTree.traverseTreeDirected(f);
-			if(f.getClosestPoint()==0) // Bail out if no cell is close enough
+			const CellCenter* closestCenter=ds->findClosestCellCenter(position);
+			if(closestCenter==0) // Bail out if no cell is close enough
 				{
 				/* At this point, the locator is borked. Better not trace next time: */
 				cantTrace=true;
@@ -321,9 +319,9 @@ Curvilinear<ScalarParam,dimensionParam,ValueParam>::Locator::locatePoint(
 				}
 			
 			/* Go to the found cell: */
-			Cell::operator=(ds->getCell(f.getClosestPoint()->value));
+			Cell::operator=(ds->getCell(closestCenter->value));
 			previousCellID=currentCellID;
-			currentCellID=f.getClosestPoint()->value;
+			currentCellID=closestCenter->value;
 			previousMaxMove=maxOut;
 			
 			/* Initialize the local cell position: */
@@ -579,6 +577,7 @@ Curvilinear<ScalarParam,dimensionParam,ValueParam>::Curvilinear(
 	:numVertices(0),
 	 numCells(0),
 	 domainBox(Box::empty),
+	 useCellBuckets(true),
 	 locatorEpsilon(Scalar(1.0e-4))
 	{
 	/* Initialize vertex stride array: */
@@ -610,6 +609,7 @@ Curvilinear<ScalarParam,dimensionParam,ValueParam>::Curvilinear(
 	const typename Curvilinear<ScalarParam,dimensionParam,ValueParam>::Point* sVertexPositions,
 	const typename Curvilinear<ScalarParam,dimensionParam,ValueParam>::Value* sVertexValues)
 	:numVertices(sNumVertices),vertices(sNumVertices),
+	 useCellBuckets(true),
 	 locatorEpsilon(Scalar(1.0e-4))
 	{
 	initStructure();
@@ -644,6 +644,7 @@ Curvilinear<ScalarParam,dimensionParam,ValueParam>::Curvilinear(
 	const typename Curvilinear<ScalarParam,dimensionParam,ValueParam>::Index& sNumVertices,
 	const typename Curvilinear<ScalarParam,dimensionParam,ValueParam>::GridVertex* sVertices)
 	:numVertices(sNumVertices),vertices(sNumVertices),
+	 useCellBuckets(true),
 	 locatorEpsilon(Scalar(1.0e-4))
 	{
 	initStructure();
@@ -749,7 +750,13 @@ Curvilinear<ScalarParam,dimensionParam,ValueParam>::finalizeGrid(
 		domainBox.addPoint(vPtr->pos);
 	
 	/* Create array containing all cell centers and cell indices: */
-	CellCenter* ccPtr=cellCenterTree.createTree(numCells.calcIncrement(-1));
+	CellCenter* cellCenters=cellCenterTree.createTree(numCells.calcIncrement(-1));
+	CellCenter* ccPtr=cellCenters;
+	
+	/* Collect the cells' bounding boxes to build the cell bucket grid: */
+	std::vector<Box> cellBoxes;
+	if(useCellBuckets)
+		cellBoxes.reserve(numCells.calcIncrement(-1));
 	
 	/* Calculate all cell centers: */
 	Scalar minCellRadius2=Math::Constants<Scalar>::max;
@@ -777,10 +784,25 @@ Curvilinear<ScalarParam,dimensionParam,ValueParam>::finalizeGrid(
 		if(maxCellRadius2<maxDist2)
 			maxCellRadius2=maxDist2;
 		
+		/* Calculate the cell's bounding box: */
+		if(useCellBuckets)
+			{
+			Box cellBox=Box::empty;
+			for(int i=0;i<CellTopology::numVertices;++i)
+				cellBox.addPoint(cIt->getVertexPosition(i));
+			cellBoxes.push_back(cellBox);
+			}
+		
 		/* Store cell center and pointer: */
 		*ccPtr=CellCenter(center,cIt->getID());
 		}
 	
+	/* Sort the cells into the cell bucket grid before the kd-tree reorders the cell centers: */
+	if(useCellBuckets&&!cellBoxes.empty())
+		cellBuckets.build(domainBox,cellBoxes.size(),&cellBoxes[0],cellCenters);
+	else
+		cellBuckets.clear();
+	
 	/* Create the cell center tree: */
 	cellCenterTree.releasePoints(4); // Let's just go ahead and use the multithreaded version
 	
@@ -791,6 +813,35 @@ Curvilinear<ScalarParam,dimensionParam,ValueParam>::finalizeGrid(
 	setLocatorEpsilon(Math::sqrt(minCellRadius2)*Scalar(1.0e-4));
 	}
 
+template <class ScalarParam,int dimensionParam,class ValueParam>
+inline
+const typename Curvilinear<ScalarParam,dimensionParam,ValueParam>::CellCenter*
+Curvilinear<ScalarParam,dimensionParam,ValueParam>::findClosestCellCenter(
+	const typename Curvilinear<ScalarParam,dimensionParam,ValueParam>::Point& position) const
+	{
+	/* Only look at the cells overlapping the position's bucket if there is a cell bucket grid: */
+	if(cellBuckets.isValid())
+		return cellBuckets.findClosestPoint(position,maxCellRadius2);
+	
+	/* Otherwise, find the closest cell center in the kd-tree: */
+	FindClosestPointFunctor<CellCenter> f(position,maxCellRadius2);
+	cellCenterTree.traverseTreeDirected(f);
+	return f.getClosestPoint();
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueParam>
+inline
+void
+Curvilinear<ScalarParam,dimensionParam,ValueParam>::setUseCellBuckets(
+	bool newUseCellBuckets)
+	{
+	useCellBuckets=newUseCellBuckets;
+	
+	/* Release the bucket grid right away; a new one is only built by finalizeGrid(): */
+	if(!useCellBuckets)
+		cellBuckets.clear();
+	}
+
 template <class ScalarParam,int dimensionParam,class ValueParam>
 inline
 void
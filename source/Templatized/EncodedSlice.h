@@ -0,0 +1,316 @@
+/***********************************************************************
+EncodedSlice - Class to describe a slice of data set values stored in
+native, half-precision, or quantized form, and to decode its values.
+Half-precision and quantized values are mapped back to the native value
+type through a per-slice scale and offset.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_ENCODEDSLICE_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_ENCODEDSLICE_INCLUDED
+
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class ValueScalarParam>
+class EncodedSlice
+	{
+	/* Embedded classes: */
+	public:
+	typedef ValueScalarParam ValueScalar; // Native value type of the data set
+	typedef double DecodedScalar; // Type in which encoded values are mapped back to the native value range
+	
+	enum Format // Enumerated type for slice storage formats
+		{
+		NATIVE, // Values are stored as ValueScalar
+		HALF, // Values are stored as IEEE 754 half-precision floats, normalized to [-1, 1]
+		QUANTIZED8, // Values are stored as 8-bit unsigned integers spanning the slice's value range
+		QUANTIZED16 // Values are stored as 16-bit unsigned integers spanning the slice's value range
+		};
+	
+	typedef DecodedScalar (EncodedSlice::*Decoder)(ptrdiff_t linearIndex) const; // Type of methods decoding single values stored in one particular format
+	
+	/* Elements: */
+	private:
+	Format format; // Storage format of the slice's values
+	const void* values; // Pointer to the slice's value array
+	DecodedScalar scale,offset; // Mapping from stored to native values for encoded formats: native=stored*scale+offset
+	
+	/* Private methods: */
+	static float decodeHalf(unsigned short h) // Converts a half-precision float to single precision
+		{
+		unsigned int sign=(unsigned int)(h&0x8000U)<<16;
+		unsigned int exponent=(h>>10)&0x1fU;
+		unsigned int mantissa=h&0x3ffU;
+		float result;
+		if(exponent==0U)
+			{
+			/* Zero or denormalized number: */
+			result=float(mantissa)*(1.0f/16777216.0f);
+			return sign!=0U?-result:result;
+			}
+		unsigned int bits;
+		if(exponent==0x1fU)
+			bits=sign|0x7f800000U|(mantissa<<13); // Infinity or NaN
+		else
+			bits=sign|((exponent+112U)<<23)|(mantissa<<13);
+		memcpy(&result,&bits,sizeof(float));
+		return result;
+		}
+	static unsigned short encodeHalf(float f) // Converts a single-precision float to half precision, rounding to nearest
+		{
+		unsigned int bits;
+		memcpy(&bits,&f,sizeof(float));
+		unsigned short sign=(unsigned short)((bits>>16)&0x8000U);
+		int exponent=int((bits>>23)&0xffU);
+		unsigned int mantissa=bits&0x7fffffU;
+		if(exponent==0xff)
+			return (unsigned short)(sign|0x7c00U|(mantissa!=0U?0x200U:0x0U)); // Infinity or NaN
+		exponent+=15-127;
+		if(exponent>=31)
+			return (unsigned short)(sign|0x7c00U); // Overflow to infinity
+		if(exponent<=0)
+			{
+			/* Denormalized result, or underflow to zero: */
+			if(exponent<-10)
+				return sign;
+			mantissa|=0x800000U;
+			int shift=14-exponent;
+			unsigned int result=mantissa>>shift;
+			result+=(mantissa>>(shift-1))&0x1U;
+			return (unsigned short)(sign|result);
+			}
+		unsigned int result=(unsigned int)(exponent<<10)|(mantissa>>13);
+		result+=(mantissa>>12)&0x1U; // Rounding carries correctly into the exponent
+		return (unsigned short)(sign|result);
+		}
+	
+	/* Constructors and destructors: */
+	public:
+	EncodedSlice(void) // Creates a descriptor for a native slice without values
+		:format(NATIVE),values(0),scale(1),offset(0)
+		{
+		}
+	EncodedSlice(const ValueScalar* sValues) // Creates a descriptor for a native slice
+		:format(NATIVE),values(sValues),scale(1),offset(0)
+		{
+		}
+	
+	/* Methods: */
+	static size_t getValueSize(Format format) // Returns the number of bytes used to store one value in the given format
+		{
+		switch(format)
+			{
+			case HALF:
+			case QUANTIZED16:
+				return 2;
+			
+			case QUANTIZED8:
+				return 1;
+			
+			default:
+				return sizeof(ValueScalar);
+			}
+		}
+	static EncodedSlice encode(Format format,size_t numValues,const ValueScalar* sourceValues) // Returns a descriptor of a new encoded copy of the given native values; copy must be released with deleteValues()
+		{
+		EncodedSlice result;
+		result.format=format;
+		if(format==NATIVE)
+			{
+			ValueScalar* newValues=new ValueScalar[numValues];
+			memcpy(newValues,sourceValues,numValues*sizeof(ValueScalar));
+			result.values=newValues;
+			return result;
+			}
+		
+		/* Calculate the value range to map the encoded values to: */
+		ValueScalar min=numValues>0?sourceValues[0]:ValueScalar(0);
+		ValueScalar max=min;
+		for(size_t i=1;i<numValues;++i)
+			{
+			if(min>sourceValues[i])
+				min=sourceValues[i];
+			if(max<sourceValues[i])
+				max=sourceValues[i];
+			}
+		
+		if(format==HALF)
+			{
+			/* Normalize the values to [-1, 1] to make best use of the half-precision exponent range: */
+			DecodedScalar maxAbs=DecodedScalar(max);
+			if(-DecodedScalar(min)>maxAbs)
+				maxAbs=-DecodedScalar(min);
+			result.scale=maxAbs>DecodedScalar(0)?maxAbs:DecodedScalar(1);
+			result.offset=DecodedScalar(0);
+			unsigned short* newValues=new unsigned short[numValues];
+			DecodedScalar invScale=DecodedScalar(1)/result.scale;
+			for(size_t i=0;i<numValues;++i)
+				newValues[i]=encodeHalf(float(DecodedScalar(sourceValues[i])*invScale));
+			result.values=newValues;
+			}
+		else
+			{
+			/* Map the value range to the full range of the quantized type: */
+			double maxQuantized=format==QUANTIZED8?255.0:65535.0;
+			result.offset=DecodedScalar(min);
+			result.scale=(DecodedScalar(max)-DecodedScalar(min))/maxQuantized;
+			double invScale=result.scale>DecodedScalar(0)?1.0/result.scale:0.0;
+			if(format==QUANTIZED8)
+				{
+				unsigned char* newValues=new unsigned char[numValues];
+				for(size_t i=0;i<numValues;++i)
+					{
+					double q=floor((double(sourceValues[i])-double(min))*invScale+0.5);
+					newValues[i]=(unsigned char)(q<0.0?0.0:q>maxQuantized?maxQuantized:q);
+					}
+				result.values=newValues;
+				}
+			else
+				{
+				unsigned short* newValues=new unsigned short[numValues];
+				for(size_t i=0;i<numValues;++i)
+					{
+					double q=floor((double(sourceValues[i])-double(min))*invScale+0.5);
+					newValues[i]=(unsigned short)(q<0.0?0.0:q>maxQuantized?maxQuantized:q);
+					}
+				result.values=newValues;
+				}
+			}
+		
+		return result;
+		}
+	void deleteValues(void) // Deletes a value array created by encode()
+		{
+		switch(format)
+			{
+			case NATIVE:
+				delete[] static_cast<const ValueScalar*>(values);
+				break;
+			
+			case HALF:
+			case QUANTIZED16:
+				delete[] static_cast<const unsigned short*>(values);
+				break;
+			
+			case QUANTIZED8:
+				delete[] static_cast<const unsigned char*>(values);
+				break;
+			}
+		values=0;
+		}
+	Format getFormat(void) const // Returns the slice's storage format
+		{
+		return format;
+		}
+	const void* getValues(void) const // Returns the slice's value array
+		{
+		return values;
+		}
+	const ValueScalar* getNativeValues(void) const // Returns the slice's value array if the slice is stored natively, or null otherwise
+		{
+		return format==NATIVE?static_cast<const ValueScalar*>(values):0;
+		}
+	DecodedScalar getNativeValue(ptrdiff_t linearIndex) const // Returns the value at the given linear index of a native slice
+		{
+		return DecodedScalar(static_cast<const ValueScalar*>(values)[linearIndex]);
+		}
+	DecodedScalar getHalfValue(ptrdiff_t linearIndex) const // Returns the value at the given linear index of a half-precision slice
+		{
+		return DecodedScalar(decodeHalf(static_cast<const unsigned short*>(values)[linearIndex]))*scale;
+		}
+	DecodedScalar getQuantized8Value(ptrdiff_t linearIndex) const // Returns the value at the given linear index of an 8-bit quantized slice
+		{
+		return DecodedScalar(static_cast<const unsigned char*>(values)[linearIndex])*scale+offset;
+		}
+	DecodedScalar getQuantized16Value(ptrdiff_t linearIndex) const // Returns the value at the given linear index of a 16-bit quantized slice
+		{
+		return DecodedScalar(static_cast<const unsigned short*>(values)[linearIndex])*scale+offset;
+		}
+	Decoder getDecoder(void) const // Returns the method decoding single values of the slice's storage format, to dispatch on the format once per slice instead of once per value
+		{
+		switch(format)
+			{
+			case HALF:
+				return &EncodedSlice::getHalfValue;
+			
+			case QUANTIZED8:
+				return &EncodedSlice::getQuantized8Value;
+			
+			case QUANTIZED16:
+				return &EncodedSlice::getQuantized16Value;
+			
+			default:
+				return &EncodedSlice::getNativeValue;
+			}
+		}
+	DecodedScalar getValue(ptrdiff_t linearIndex) const // Returns the value at the given linear index
+		{
+		return (this->*getDecoder())(linearIndex);
+		}
+	template <class DestScalarParam>
+	void decode(ptrdiff_t firstLinearIndex,size_t numValues,DestScalarParam* destValues) const // Decodes a run of consecutive values; the format is only checked once per run
+		{
+		switch(format)
+			{
+			case NATIVE:
+				{
+				const ValueScalar* vPtr=static_cast<const ValueScalar*>(values)+firstLinearIndex;
+				for(size_t i=0;i<numValues;++i)
+					destValues[i]=DestScalarParam(vPtr[i]);
+				break;
+				}
+			
+			case HALF:
+				{
+				const unsigned short* vPtr=static_cast<const unsigned short*>(values)+firstLinearIndex;
+				for(size_t i=0;i<numValues;++i)
+					destValues[i]=DestScalarParam(DecodedScalar(decodeHalf(vPtr[i]))*scale);
+				break;
+				}
+			
+			case QUANTIZED8:
+				{
+				const unsigned char* vPtr=static_cast<const unsigned char*>(values)+firstLinearIndex;
+				for(size_t i=0;i<numValues;++i)
+					destValues[i]=DestScalarParam(DecodedScalar(vPtr[i])*scale+offset);
+				break;
+				}
+			
+			case QUANTIZED16:
+				{
+				const unsigned short* vPtr=static_cast<const unsigned short*>(values)+firstLinearIndex;
+				for(size_t i=0;i<numValues;++i)
+					destValues[i]=DestScalarParam(DecodedScalar(vPtr[i])*scale+offset);
+				break;
+				}
+			}
+		}
+	};
+
+}
+
+}
+
+#endif
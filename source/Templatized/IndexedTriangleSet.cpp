@@ -244,6 +244,144 @@ IndexedTriangleSet<VertexParam>::clear(
 	nextTriangle=0;
 	}
 
+template <class VertexParam>
+inline
+void
+IndexedTriangleSet<VertexParam>::append(
+	const IndexedTriangleSet<VertexParam>& source)
+	{
+	/* Copy the source's vertices; all source chunks except the last one are full: */
+	Index indexOffset=Index(numVertices);
+	size_t numSourceVertices=source.numVertices;
+	for(const VertexChunk* chunkPtr=source.vertexHead;numSourceVertices>0;chunkPtr=chunkPtr->succ)
+		{
+		size_t numChunkVertices=numSourceVertices<vertexChunkSize?numSourceVertices:vertexChunkSize;
+		for(size_t i=0;i<numChunkVertices;++i)
+			{
+			*getNextVertex()=chunkPtr->vertices[i];
+			addVertex();
+			}
+		numSourceVertices-=numChunkVertices;
+		}
+	
+	/* Copy the source's triangles, offsetting their vertex indices past this set's previous vertices: */
+	size_t numSourceTriangles=source.numTriangles;
+	for(const IndexChunk* chunkPtr=source.indexHead;numSourceTriangles>0;chunkPtr=chunkPtr->succ)
+		{
+		size_t numChunkTriangles=numSourceTriangles<indexChunkSize?numSourceTriangles:indexChunkSize;
+		const Index* sourceIndexPtr=chunkPtr->indices;
+		for(size_t i=0;i<numChunkTriangles;++i,sourceIndexPtr+=3)
+			{
+			Index* indexPtr=getNextTriangle();
+			for(int j=0;j<3;++j)
+				indexPtr[j]=sourceIndexPtr[j]+indexOffset;
+			addTriangle();
+			}
+		numSourceTriangles-=numChunkTriangles;
+		}
+	}
+
+template <class VertexParam>
+inline
+void
+IndexedTriangleSet<VertexParam>::append(
+	const IndexedTriangleSet<VertexParam>& source,
+	typename IndexedTriangleSet<VertexParam>::Index vertexMap[])
+	{
+	/* Copy the source's unmapped vertices, and map them to their copies: */
+	Index sourceIndex=0;
+	size_t numSourceVertices=source.numVertices;
+	for(const VertexChunk* chunkPtr=source.vertexHead;numSourceVertices>0;chunkPtr=chunkPtr->succ)
+		{
+		size_t numChunkVertices=numSourceVertices<vertexChunkSize?numSourceVertices:vertexChunkSize;
+		for(size_t i=0;i<numChunkVertices;++i,++sourceIndex)
+			if(vertexMap[sourceIndex]==~Index(0))
+				{
+				*getNextVertex()=chunkPtr->vertices[i];
+				vertexMap[sourceIndex]=addVertex();
+				}
+		numSourceVertices-=numChunkVertices;
+		}
+	
+	/* Copy the source's triangles, mapping their vertex indices: */
+	size_t numSourceTriangles=source.numTriangles;
+	for(const IndexChunk* chunkPtr=source.indexHead;numSourceTriangles>0;chunkPtr=chunkPtr->succ)
+		{
+		size_t numChunkTriangles=numSourceTriangles<indexChunkSize?numSourceTriangles:indexChunkSize;
+		const Index* sourceIndexPtr=chunkPtr->indices;
+		for(size_t i=0;i<numChunkTriangles;++i,sourceIndexPtr+=3)
+			{
+			Index* indexPtr=getNextTriangle();
+			for(int j=0;j<3;++j)
+				indexPtr[j]=vertexMap[sourceIndexPtr[j]];
+			addTriangle();
+			}
+		numSourceTriangles-=numChunkTriangles;
+		}
+	}
+
+template <class VertexParam>
+inline
+void
+IndexedTriangleSet<VertexParam>::adopt(
+	IndexedTriangleSet<VertexParam>& source)
+	{
+	if(numVertices!=0||numTriangles!=0)
+		{
+		/* Copy the source's data behind this set's own: */
+		append(source);
+		source.clear();
+		return;
+		}
+	
+	/* Take over the source's buffer chunks: */
+	clear();
+	numVertices=source.numVertices;
+	numTriangles=source.numTriangles;
+	vertexHead=source.vertexHead;
+	vertexTail=source.vertexTail;
+	indexHead=source.indexHead;
+	indexTail=source.indexTail;
+	numVerticesLeft=source.numVerticesLeft;
+	numTrianglesLeft=source.numTrianglesLeft;
+	nextVertex=source.nextVertex;
+	nextTriangle=source.nextTriangle;
+	
+	/* Leave the source empty: */
+	source.vertexHead=0;
+	source.indexHead=0;
+	source.clear();
+	
+	tailNumSentVertices=0;
+	tailNumSentTriangles=0;
+	if(pipe!=0)
+		{
+		/* Send all vertices across the pipe first to keep the indexed triangle set consistent on the other side: */
+		for(const VertexChunk* chunkPtr=vertexHead;chunkPtr!=0;chunkPtr=chunkPtr->succ)
+			{
+			size_t numChunkVertices=chunkPtr!=vertexTail?vertexChunkSize:vertexChunkSize-numVerticesLeft;
+			if(numChunkVertices>0)
+				{
+				pipe->write<unsigned int>((unsigned int)numChunkVertices);
+				pipe->write<unsigned int>(0U);
+				pipe->write<Vertex>(chunkPtr->vertices,numChunkVertices);
+				pipe->finishMessage();
+				}
+			}
+		if(vertexTail!=0)
+			tailNumSentVertices=vertexChunkSize-numVerticesLeft;
+		
+		/* Send all full index chunks across the pipe; the last chunk is sent by the next flush(): */
+		for(const IndexChunk* chunkPtr=indexHead;chunkPtr!=indexTail;chunkPtr=chunkPtr->succ)
+			{
+			pipe->write<unsigned int>(0U);
+			pipe->write<unsigned int>((unsigned int)indexChunkSize);
+			pipe->write<Index>(chunkPtr->indices,indexChunkSize*3);
+			pipe->finishMessage();
+			}
+		}
+	}
+
 template <class VertexParam>
 inline
 void
@@ -123,6 +123,9 @@ class IndexedTriangleSet:public GLObject
 	/* Methods: */
 	virtual void initContext(GLContextData& contextData) const;
 	void clear(void); // Removes all triangles from the set
+	void append(const IndexedTriangleSet& source); // Appends copies of all vertices and triangles of the given triangle set
+	void append(const IndexedTriangleSet& source,Index vertexMap[]); // Appends the triangles of the given triangle set, using vertexMap[i] as index of the source's i-th vertex; source vertices mapped to ~Index(0) are copied, and their new indices are stored in the map
+	void adopt(IndexedTriangleSet& source); // Takes over all vertices and triangles of the given triangle set without a pipe, leaving it empty; sends them across the pipe up to the next flush() point
 	Vertex* getNextVertex(void) // Returns pointer to next vertex in buffer
 		{
 		/* Check if there is room in the last vertex buffer chunk to add another vertex: */
@@ -22,12 +22,67 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #define VISUALIZATION_TEMPLATIZED_ISOSURFACEEXTRACTOR_IMPLEMENTATION
 
+#include <vector>
+#include <Threads/Mutex.h>
+#include <Threads/Thread.h>
+
+#include <WorkerThreads.h>
 #include <Templatized/IsosurfaceExtractor.h>
 
 namespace Visualization {
 
 namespace Templatized {
 
+/********************************************************
+Declaration of struct IsosurfaceExtractor::ExtractionJob:
+********************************************************/
+
+template <class DataSetParam,class ScalarExtractorParam,class IsosurfaceParam>
+struct IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::ExtractionJob
+	{
+	/* Elements: */
+	public:
+	IsosurfaceExtractor* extractor; // Isosurface extractor private to the thread
+	Isosurface* isosurface; // Isosurface collecting the thread's fragments
+	const std::vector<CellRange>* blocks; // List of blocks of cells to extract
+	size_t numBlocks; // Number of blocks of cells to extract
+	Threads::Mutex* nextBlockMutex; // Mutex protecting the index of the next unprocessed block
+	size_t* nextBlock; // Index of the next unprocessed block
+	Threads::Mutex* resultMutex; // Mutex serializing access to the result isosurface
+	Isosurface* result; // Isosurface receiving the thread's fragments after each block, and streaming them to the slaves
+	
+	/* Methods: */
+	void* extractThreadMethod(void)
+		{
+		while(true)
+			{
+			/* Grab the next block of cells: */
+			size_t block;
+			{
+			Threads::Mutex::Lock nextBlockLock(*nextBlockMutex);
+			block=(*nextBlock)++;
+			}
+			if(block>=numBlocks)
+				break;
+			
+			/* Extract the block's isosurface fragments: */
+			extractor->extractBlock(*blocks,block);
+			
+			/* Hand the block's fragments to the result isosurface, which sends them across its pipe as its chunks fill up: */
+			if(isosurface->getNumTriangles()>0)
+				{
+				{
+				Threads::Mutex::Lock resultLock(*resultMutex);
+				result->append(*isosurface);
+				}
+				isosurface->clear();
+				}
+			}
+		
+		return 0;
+		}
+	};
+
 /************************************
 Methods of class IsosurfaceExtractor:
 ************************************/
@@ -143,6 +198,63 @@ IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::extractS
 	return caseIndex;
 	}
 
+template <class DataSetParam,class ScalarExtractorParam,class IsosurfaceParam>
+inline
+void
+IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::extractCells(
+	const typename IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::CellIterator& begin,
+	const typename IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::CellIterator& end)
+	{
+	/* Extract isosurface fragments from all cells in the range: */
+	if(extractionMode==FLAT)
+		{
+		for(CellIterator cIt=begin;cIt!=end;++cIt)
+			{
+			/* Extract the cell's isosurface fragment: */
+			extractFlatIsosurfaceFragment(*cIt);
+			}
+		}
+	else
+		{
+		for(CellIterator cIt=begin;cIt!=end;++cIt)
+			{
+			/* Extract the cell's isosurface fragment: */
+			extractSmoothIsosurfaceFragment(*cIt);
+			}
+		}
+	}
+
+template <class DataSetParam,class ScalarExtractorParam,class IsosurfaceParam>
+inline
+void
+IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::extractBlock(
+	const std::vector<typename IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::CellRange>& blocks,
+	size_t block)
+	{
+	if(activeSet!=0)
+		{
+		/* Find the block's range of active cells: */
+		size_t begin=block*cellBlockSize;
+		size_t end=begin+cellBlockSize;
+		if(end>activeSet->getNumActiveCells())
+			end=activeSet->getNumActiveCells();
+		
+		/* Extract isosurface fragments from all active cells in the range: */
+		if(extractionMode==FLAT)
+			{
+			for(size_t i=begin;i<end;++i)
+				extractFlatIsosurfaceFragment(dataSet->getCell(activeSet->getActiveCellID(i)));
+			}
+		else
+			{
+			for(size_t i=begin;i<end;++i)
+				extractSmoothIsosurfaceFragment(dataSet->getCell(activeSet->getActiveCellID(i)));
+			}
+		}
+	else
+		extractCells(blocks[block].first,blocks[block].second);
+	}
+
 template <class DataSetParam,class ScalarExtractorParam,class IsosurfaceParam>
 inline
 IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::IsosurfaceExtractor(
@@ -150,7 +262,7 @@ IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::Isosurfa
 	const typename IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::ScalarExtractor& sScalarExtractor)
 	:dataSet(sDataSet),
 	 scalarExtractor(sScalarExtractor),
-	 extractionMode(FLAT),
+	 extractionMode(FLAT),numThreads(0),blockIndex(0),activeSet(0),
 	 isosurface(0),
 	 cellQueue(101)
 	{
@@ -172,6 +284,33 @@ IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::setExtra
 	extractionMode=newExtractionMode;
 	}
 
+template <class DataSetParam,class ScalarExtractorParam,class IsosurfaceParam>
+inline
+void
+IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::setNumThreads(
+	int newNumThreads)
+	{
+	numThreads=newNumThreads;
+	}
+
+template <class DataSetParam,class ScalarExtractorParam,class IsosurfaceParam>
+inline
+void
+IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::setBlockIndex(
+	const typename IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::BlockIndex* newBlockIndex)
+	{
+	blockIndex=newBlockIndex;
+	}
+
+template <class DataSetParam,class ScalarExtractorParam,class IsosurfaceParam>
+inline
+void
+IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::setActiveSet(
+	typename IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::ActiveSet* newActiveSet)
+	{
+	activeSet=newActiveSet;
+	}
+
 template <class DataSetParam,class ScalarExtractorParam,class IsosurfaceParam>
 inline
 void
@@ -183,22 +322,84 @@ IsosurfaceExtractor<DataSetParam,ScalarExtractorParam,IsosurfaceParam>::extractI
 	isovalue=newIsovalue;
 	isosurface=&newIsosurface;
 	
-	/* Extract isosurface fragments from all cells: */
-	if(extractionMode==FLAT)
+	/* Collect the blocks of cells to extract: */
+	std::vector<CellRange> blocks;
+	if(activeSet!=0)
 		{
-		for(typename DataSet::CellIterator cIt=dataSet->beginCells();cIt!=dataSet->endCells();++cIt)
+		/* Bring the active cell set up to date; its cells are handed out in blocks of consecutive active cells: */
+		activeSet->setIsovalue(isovalue);
+		}
+	else if(blockIndex!=0)
+		{
+		/* Only visit the blocks whose value ranges contain the isovalue: */
+		blockIndex->findIsosurfaceBlocks(isovalue,blocks);
+		}
+	else
+		{
+		/* Split the cell list into blocks of cells: */
+		CellIterator cIt=dataSet->beginCells();
+		CellIterator cEnd=dataSet->endCells();
+		while(cIt!=cEnd)
 			{
-			/* Extract the cell's isosurface fragment: */
-			extractFlatIsosurfaceFragment(*cIt);
+			CellIterator blockBegin=cIt;
+			for(size_t i=0;i<cellBlockSize&&cIt!=cEnd;++i)
+				++cIt;
+			blocks.push_back(CellRange(blockBegin,cIt));
 			}
 		}
+	size_t numBlocks=activeSet!=0?(activeSet->getNumActiveCells()+cellBlockSize-1)/cellBlockSize:blocks.size();
+	
+	/* Determine the number of threads: */
+	int numExtractionThreads=getNumWorkerThreads(numThreads);
+	if(size_t(numExtractionThreads)>numBlocks)
+		numExtractionThreads=numBlocks>0?int(numBlocks):1;
+	
+	if(numExtractionThreads==1)
+		{
+		/* Extract isosurface fragments from all blocks directly into the isosurface: */
+		for(size_t block=0;block<numBlocks;++block)
+			extractBlock(blocks,block);
+		}
 	else
 		{
-		for(typename DataSet::CellIterator cIt=dataSet->beginCells();cIt!=dataSet->endCells();++cIt)
+		/* Keep this thread from being cancelled while the workers use its stack and the result isosurface: */
+		WorkerThreadSection workerThreadSection;
+		
+		/* Let all threads grab blocks of cells until all cells are processed; each thread extracts a block into a private isosurface, and then appends it to the isosurface: */
+		Threads::Mutex nextBlockMutex;
+		size_t nextBlock=0;
+		Threads::Mutex resultMutex;
+		ExtractionJob* jobs=new ExtractionJob[numExtractionThreads];
+		for(int i=0;i<numExtractionThreads;++i)
 			{
-			/* Extract the cell's isosurface fragment: */
-	  	extractSmoothIsosurfaceFragment(*cIt);
+			jobs[i].extractor=new IsosurfaceExtractor(dataSet,scalarExtractor);
+			jobs[i].extractor->extractionMode=extractionMode;
+			jobs[i].extractor->isovalue=isovalue;
+			jobs[i].extractor->activeSet=activeSet;
+			jobs[i].isosurface=new Isosurface(0);
+			jobs[i].extractor->isosurface=jobs[i].isosurface;
+			jobs[i].blocks=&blocks;
+			jobs[i].numBlocks=numBlocks;
+			jobs[i].nextBlockMutex=&nextBlockMutex;
+			jobs[i].nextBlock=&nextBlock;
+			jobs[i].resultMutex=&resultMutex;
+			jobs[i].result=isosurface;
+			}
+		Threads::Thread* threads=new Threads::Thread[numExtractionThreads-1];
+		for(int i=1;i<numExtractionThreads;++i)
+			threads[i-1].start(&jobs[i],&ExtractionJob::extractThreadMethod);
+		jobs[0].extractThreadMethod();
+		for(int i=1;i<numExtractionThreads;++i)
+			threads[i-1].join();
+		delete[] threads;
+		
+		/* Clean up: */
+		for(int i=0;i<numExtractionThreads;++i)
+			{
+			delete jobs[i].isosurface;
+			delete jobs[i].extractor;
 			}
+		delete[] jobs;
 		}
 	isosurface->flush();
 	
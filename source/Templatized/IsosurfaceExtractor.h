@@ -23,7 +23,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef VISUALIZATION_TEMPLATIZED_ISOSURFACEEXTRACTOR_INCLUDED
 #define VISUALIZATION_TEMPLATIZED_ISOSURFACEEXTRACTOR_INCLUDED
 
+#include <stddef.h>
+#include <vector>
 #include <Misc/OneTimeQueue.h>
+#include <Templatized/ActiveCellSet.h>
+#include <Templatized/CellBlockIndex.h>
 
 /* Forward declarations: */
 namespace Visualization {
@@ -51,25 +55,35 @@ class IsosurfaceExtractor
 	typedef ScalarExtractorParam ScalarExtractor; // Type to extract scalar values from a data set
 	typedef typename ScalarExtractor::Scalar VScalar; // Value type of scalar extractor
 	typedef IsosurfaceParam Isosurface; // Type of isosurface representation
+	typedef CellBlockIndex<DataSet,ScalarExtractor> BlockIndex; // Type of index to skip blocks of cells during global isosurface extraction
+	typedef ActiveCellSet<DataSet,ScalarExtractor> ActiveSet; // Type of sets of active cells for incremental global isosurface extraction
 	
 	enum ExtractionMode // Enumerated type for isosurface extraction modes
 		{
 		FLAT,SMOOTH
 		};
 	
+	static const size_t cellBlockSize=4096; // Number of cells in each block of cells handed to an extraction thread or summarized by a block index
+	
 	private:
 	typedef typename DataSet::CellTopology CellTopology; // Topology of the data set's cells
 	typedef typename DataSet::CellID CellID; // Type of the data set's cell IDs
 	typedef typename DataSet::Cell Cell; // Type of the data set's cells
+	typedef typename DataSet::CellIterator CellIterator; // Type to iterate through the data set's cells
+	typedef typename BlockIndex::CellRange CellRange; // Type for half-open ranges of cells
 	typedef Misc::OneTimeQueue<CellID,CellID> CellQueue; // Type for queues of cell IDs waiting for expansion
 	typedef IsosurfaceCaseTable<CellTopology> CaseTable; // Type of isosurface case table
 	typedef typename Isosurface::Vertex Vertex; // Type of vertices stored in isosurface
+	struct ExtractionJob; // Structure describing one thread's share of a global isosurface extraction
 	
 	/* Elements: */
 	private:
 	const DataSet* dataSet; // Data set the isosurface extractor works on
 	ScalarExtractor scalarExtractor; // Scalar extractor working on data set
 	ExtractionMode extractionMode; // Surface extraction mode
+	int numThreads; // Number of threads for global isosurface extraction, or 0 to use one thread per CPU
+	const BlockIndex* blockIndex; // Index to skip blocks of cells that cannot intersect the isosurface during global isosurface extraction, or null to visit all cells
+	ActiveSet* activeSet; // Set of active cells updated incrementally by global isosurface extraction, or null to find the active cells from scratch
 	
 	/* Isosurface extraction state: */
 	VScalar isovalue; // The current isovalue
@@ -79,6 +93,8 @@ class IsosurfaceExtractor
 	/* Private methods: */
 	int extractFlatIsosurfaceFragment(const Cell& cell); // Extracts a flat-shaded isosurface fragment from a cell and stores it in the current isosurface representation
 	int extractSmoothIsosurfaceFragment(const Cell& cell); // Extracts a gradient-shaded isosurface fragment from a cell and stores it in the current isosurface representation
+	void extractCells(const CellIterator& begin,const CellIterator& end); // Extracts isosurface fragments from a range of cells
+	void extractBlock(const std::vector<CellRange>& blocks,size_t block); // Extracts isosurface fragments from a block of cells, or from a block of the active cell set's cells if there is one
 	
 	/* Constructors and destructors: */
 	public:
@@ -111,7 +127,22 @@ class IsosurfaceExtractor
 		dataSet=newDataSet;
 		scalarExtractor=newScalarExtractor;
 		}
+	int getNumThreads(void) const // Returns the number of threads for global isosurface extraction
+		{
+		return numThreads;
+		}
+	const BlockIndex* getBlockIndex(void) const // Returns the block index used for global isosurface extraction
+		{
+		return blockIndex;
+		}
+	ActiveSet* getActiveSet(void) const // Returns the active cell set used for global isosurface extraction
+		{
+		return activeSet;
+		}
 	void setExtractionMode(ExtractionMode newExtractionMode); // Sets the current isosurface extraction mode
+	void setNumThreads(int newNumThreads); // Sets the number of threads for global isosurface extraction; 0 uses one thread per CPU
+	void setBlockIndex(const BlockIndex* newBlockIndex); // Sets an index built for the current data set and scalar extractor to skip blocks of cells during global isosurface extraction; null visits all cells
+	void setActiveSet(ActiveSet* newActiveSet); // Sets an active cell set built for the current data set and scalar extractor, which is updated from its previous isovalue by global isosurface extraction; null finds the active cells from scratch
 	void extractIsosurface(VScalar newIsovalue,Isosurface& newIsosurface); // Extracts a global isosurface for the given isovalue and stores it in the given isosurface
 	void extractSeededIsosurface(const Locator& seedLocator,Isosurface& newIsosurface); // Extracts a seeded isosurface for the given isovalue from the given cell and stores it in the given isosurface
 	void startSeededIsosurface(const Locator& seedLocator,Isosurface& newIsosurface); // Starts extracting a seeded isosurface for the given isovalue from the given cell
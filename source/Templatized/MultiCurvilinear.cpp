@@ -332,13 +332,12 @@ MultiCurvilinear<ScalarParam,dimensionParam,ValueParam>::Locator::locatePoint(
 	if(!traceHint||cantTrace)
 		{
 		/* Start searching from cell whose cell center is closest to query position: */
-		FindClosestPointFunctor<CellCenter> f(position,ds->maxCellRadius2);
-		ds->cellCenterTree.traverseTreeDirected(f);
-		if(f.getClosestPoint()==0) // Bail out if no cell is close enough
+		const CellCenter* closestCenter=ds->findClosestCellCenter(position);
+		if(closestCenter==0) // Bail out if no cell is close enough
 			return false;
 		
 		/* Go to the found cell: */
-		Cell::operator=(ds->getCell(f.getClosestPoint()->value));
+		Cell::operator=(ds->getCell(closestCenter->value));
 		
 		/* Initialize local cell position: */
 		for(int i=0;i<dimension;++i)
@@ -383,9 +382,8 @@ MultiCurvilinear<ScalarParam,dimensionParam,ValueParam>::Locator::locatePoint(
 		if(iteration==0&&maxOut>Scalar(5))
 			{
 			/* We had a tracing failure; just start searching from scratch: */
-			FindClosestPointFunctor<CellCenter> f(position,ds->maxCellRadius2);
-			ds->cellCenterTree.traverseTreeDirected(f);
-			if(f.getClosestPoint()==0) // Bail out if no cell is close enough
+			const CellCenter* closestCenter=ds->findClosestCellCenter(position);
+			if(closestCenter==0) // Bail out if no cell is close enough
 				{
 				/* At this point, the locator is borked. Better not trace next time: */
 				cantTrace=true;
@@ -395,9 +393,9 @@ MultiCurvilinear<ScalarParam,dimensionParam,ValueParam>::Locator::locatePoint(
 				}
 			
 			/* Go to the found cell: */
-			Cell::operator=(ds->getCell(f.getClosestPoint()->value));
+			Cell::operator=(ds->getCell(closestCenter->value));
 			previousCellID=currentCellID;
-			currentCellID=f.getClosestPoint()->value;
+			currentCellID=closestCenter->value;
 			previousMaxMove=maxOut;
 			
 			/* Initialize the local cell position: */
@@ -718,7 +716,7 @@ MultiCurvilinear<ScalarParam,dimensionParam,ValueParam>::retrieveGridConnector(
 		{
 		const Grid& grid=grids[cell.gridIndex];
 		int faceDimension=faceIndex>>1;
-
+		
 		/* Retrieve the other cell's ID: */
 		int gcIndex=0;
 		for(int i=0;i<dimension;++i)
@@ -737,6 +735,7 @@ MultiCurvilinear<ScalarParam,dimensionParam,ValueParam>::MultiCurvilinear(
 	 vertexIDBases(0),edgeIDBases(0),cellIDBases(0),
 	 gridConnectors(0),
 	 domainBox(Box::empty),
+	 useCellBuckets(true),
 	 locatorEpsilon(Scalar(1.0e-4))
 	{
 	}
@@ -752,6 +751,7 @@ MultiCurvilinear<ScalarParam,dimensionParam,ValueParam>::MultiCurvilinear(
 	 cellIDBases(new CellID::Index[numGrids]),
 	 gridConnectors(0),
 	 domainBox(Box::empty),
+	 useCellBuckets(true),
 	 locatorEpsilon(Scalar(1.0e-4))
 	{
 	}
@@ -768,6 +768,7 @@ MultiCurvilinear<ScalarParam,dimensionParam,ValueParam>::MultiCurvilinear(
 	 cellIDBases(new CellID::Index[numGrids]),
 	 gridConnectors(0),
 	 domainBox(Box::empty),
+	 useCellBuckets(true),
 	 locatorEpsilon(Scalar(1.0e-4))
 	{
 	/* Initialize grid structures: */
@@ -894,7 +895,13 @@ MultiCurvilinear<ScalarParam,dimensionParam,ValueParam>::finalizeGrid(
 		}
 	
 	/* Create array containing all cell centers and cell indices: */
-	CellCenter* ccPtr=cellCenterTree.createTree(totalNumCells);
+	CellCenter* cellCenters=cellCenterTree.createTree(totalNumCells);
+	CellCenter* ccPtr=cellCenters;
+	
+	/* Collect the cells' bounding boxes to build the cell bucket grid: */
+	std::vector<Box> cellBoxes;
+	if(useCellBuckets)
+		cellBoxes.reserve(totalNumCells);
 	
 	/* Calculate all cell centers: */
 	Scalar minCellRadius2=Math::Constants<Scalar>::max;
@@ -922,10 +929,25 @@ MultiCurvilinear<ScalarParam,dimensionParam,ValueParam>::finalizeGrid(
 		if(maxCellRadius2<maxDist2)
 			maxCellRadius2=maxDist2;
 		
+		/* Calculate the cell's bounding box: */
+		if(useCellBuckets)
+			{
+			Box cellBox=Box::empty;
+			for(int i=0;i<CellTopology::numVertices;++i)
+				cellBox.addPoint(cIt->getVertexPosition(i));
+			cellBoxes.push_back(cellBox);
+			}
+		
 		/* Store cell center and pointer: */
 		*ccPtr=CellCenter(center,cIt->getID());
 		}
 	
+	/* Sort the cells into the cell bucket grid before the kd-tree reorders the cell centers: */
+	if(useCellBuckets&&!cellBoxes.empty())
+		cellBuckets.build(domainBox,cellBoxes.size(),&cellBoxes[0],cellCenters);
+	else
+		cellBuckets.clear();
+	
 	/* Create the cell center tree: */
 	cellCenterTree.releasePoints(4); // Let's just go ahead and use the multithreaded version
 	
@@ -1049,6 +1071,35 @@ MultiCurvilinear<ScalarParam,dimensionParam,ValueParam>::finalizeGrid(
 	}
 	}
 
+template <class ScalarParam,int dimensionParam,class ValueParam>
+inline
+const typename MultiCurvilinear<ScalarParam,dimensionParam,ValueParam>::CellCenter*
+MultiCurvilinear<ScalarParam,dimensionParam,ValueParam>::findClosestCellCenter(
+	const typename MultiCurvilinear<ScalarParam,dimensionParam,ValueParam>::Point& position) const
+	{
+	/* Only look at the cells overlapping the position's bucket if there is a cell bucket grid: */
+	if(cellBuckets.isValid())
+		return cellBuckets.findClosestPoint(position,maxCellRadius2);
+	
+	/* Otherwise, find the closest cell center in the kd-tree: */
+	FindClosestPointFunctor<CellCenter> f(position,maxCellRadius2);
+	cellCenterTree.traverseTreeDirected(f);
+	return f.getClosestPoint();
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueParam>
+inline
+void
+MultiCurvilinear<ScalarParam,dimensionParam,ValueParam>::setUseCellBuckets(
+	bool newUseCellBuckets)
+	{
+	useCellBuckets=newUseCellBuckets;
+	
+	/* Release the bucket grid right away; a new one is only built by finalizeGrid(): */
+	if(!useCellBuckets)
+		cellBuckets.clear();
+	}
+
 template <class ScalarParam,int dimensionParam,class ValueParam>
 inline
 void
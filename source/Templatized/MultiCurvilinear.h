@@ -32,6 +32,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Geometry/ValuedPoint.h>
 #include <Geometry/ArrayKdTree.h>
 
+#include <Templatized/CellBucketGrid.h>
 #include <Templatized/Tesseract.h>
 #include <Templatized/LinearIndexID.h>
 #include <Templatized/IteratorWrapper.h>
@@ -356,6 +357,7 @@ class MultiCurvilinear
 	private:
 	typedef Geometry::ValuedPoint<Point,CellID> CellCenter; // Data type to associate a cell's center point and its ID
 	typedef Geometry::ArrayKdTree<CellCenter> CellCenterTree; // Data type for kd-trees to locate closest cell centers
+	typedef CellBucketGrid<CellCenter> CellBuckets; // Data type for uniform grids of buckets to locate cells overlapping a point
 	
 	friend class Vertex;
 	friend class Cell;
@@ -377,9 +379,12 @@ class MultiCurvilinear
 	Box domainBox; // Bounding box of all vertices
 	Scalar avgCellRadius; // Average "radius" of all cells
 	Scalar maxCellRadius2; // Squared maximum "radius" of any cell in any grid (used as trivial reject threshold during point location)
+	bool useCellBuckets; // Flag whether point location starts from the cell bucket grid instead of the cell center kd-tree
+	CellBuckets cellBuckets; // Uniform grid of buckets listing the cells overlapping each bucket
 	Scalar locatorEpsilon; // Default accuracy threshold for locators working on this data set
 	
 	/* Private methods: */
+	const CellCenter* findClosestCellCenter(const Point& position) const; // Returns the center of the cell to start locating the given position from, or null if the position is outside the data set
 	void initStructure(void);
 	template <class ScalarExtractorParam>
 	Vector calcVertexGradient(int gridIndex,const Index& vertexIndex,const ScalarExtractorParam& extractor) const; // Returns gradient at a vertex based on the given scalar extractor
@@ -412,6 +417,11 @@ class MultiCurvilinear
 		return grids[gridIndex];
 		}
 	void finalizeGrid(void); // Recalculates derived grid information after grid structure change
+	bool getUseCellBuckets(void) const // Returns true if point location uses the cell bucket grid
+		{
+		return useCellBuckets;
+		}
+	void setUseCellBuckets(bool newUseCellBuckets); // Selects the cell bucket grid or the cell center kd-tree to start point location; a bucket grid is built by the next call to finalizeGrid()
 	Scalar getLocatorEpsilon(void) const // Returns the current default accuracy threshold for locators working on this data set
 		{
 		return locatorEpsilon;
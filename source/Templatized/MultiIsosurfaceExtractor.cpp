@@ -0,0 +1,415 @@
+/***********************************************************************
+MultiIsosurfaceExtractor - Class to extract the global isosurfaces of
+several isovalues from data sets in a single pass over the data set's
+cells. Each cell's vertex values are read once, and the cell's fragments
+for all isovalues are stored in one indexed triangle set per isovalue.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#define VISUALIZATION_TEMPLATIZED_MULTIISOSURFACEEXTRACTOR_IMPLEMENTATION
+
+#include <algorithm>
+#include <Threads/Mutex.h>
+#include <Threads/Thread.h>
+
+#include <WorkerThreads.h>
+#include <Templatized/MultiIsosurfaceExtractor.h>
+
+namespace Visualization {
+
+namespace Templatized {
+
+/*************************************************************
+Declaration of struct MultiIsosurfaceExtractor::ExtractionJob:
+*************************************************************/
+
+template <class DataSetParam,class ScalarExtractorParam,class VertexParam>
+struct MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::ExtractionJob
+	{
+	/* Elements: */
+	public:
+	MultiIsosurfaceExtractor* extractor; // Multi-isosurface extractor private to the thread, collecting the fragments of the thread's current block
+	const std::vector<CellRange>* blocks; // List of blocks of cells to extract
+	Threads::Mutex* nextBlockMutex; // Mutex protecting the index of the next unprocessed block
+	size_t* nextBlock; // Index of the next unprocessed block
+	Threads::Mutex* resultMutex; // Mutex serializing access to the result isosurfaces
+	MultiIsosurfaceExtractor* result; // Multi-isosurface extractor whose isosurfaces and hashers receive the thread's fragments after each block
+	std::vector<Index> vertexMap; // Map from the thread's isosurfaces' vertex indices to the result isosurfaces'
+	
+	/* Methods: */
+	void* extractThreadMethod(void)
+		{
+		size_t numLevels=extractor->isovalues.size();
+		while(true)
+			{
+			/* Grab the next block of cells: */
+			size_t block;
+			{
+			Threads::Mutex::Lock nextBlockLock(*nextBlockMutex);
+			block=(*nextBlock)++;
+			}
+			if(block>=blocks->size())
+				break;
+			
+			/* Extract the block's isosurface fragments: */
+			extractor->extractBlock(*blocks,block);
+			
+			/* Hand the block's fragments to the result isosurfaces one level at a time: */
+			for(size_t level=0;level<numLevels;++level)
+				{
+				Isosurface* isosurface=extractor->isosurfaces[level];
+				if(isosurface->getNumTriangles()>0)
+					{
+					VertexIndexHasher& levelVertexIndices=*extractor->vertexIndices[level];
+					vertexMap.assign(isosurface->getNumVertices(),~Index(0));
+					{
+					Threads::Mutex::Lock resultLock(*resultMutex);
+					VertexIndexHasher& resultVertexIndices=*result->vertexIndices[level];
+					
+					/* Reuse the result's vertices on edges shared with previously appended blocks: */
+					for(typename VertexIndexHasher::Iterator vIt=levelVertexIndices.begin();!vIt.isFinished();++vIt)
+						{
+						typename VertexIndexHasher::Iterator rvIt=resultVertexIndices.findEntry(vIt->getSource());
+						if(!rvIt.isFinished())
+							vertexMap[vIt->getDest()]=rvIt->getDest();
+						}
+					
+					/* Append the block's triangles and remaining vertices: */
+					result->isosurfaces[level]->append(*isosurface,&vertexMap[0]);
+					
+					/* Record the result's vertices on the block's edges: */
+					for(typename VertexIndexHasher::Iterator vIt=levelVertexIndices.begin();!vIt.isFinished();++vIt)
+						resultVertexIndices.setEntry(typename VertexIndexHasher::Entry(vIt->getSource(),vertexMap[vIt->getDest()]));
+					}
+					isosurface->clear();
+					levelVertexIndices.clear();
+					}
+				}
+			}
+		
+		return 0;
+		}
+	};
+
+/*****************************************
+Methods of class MultiIsosurfaceExtractor:
+*****************************************/
+
+template <class DataSetParam,class ScalarExtractorParam,class VertexParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::extractFragments(
+	const typename MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::Cell& cell)
+	{
+	/* Determine the cell vertex values and their range: */
+	VScalar cvvs[CellTopology::numVertices];
+	cvvs[0]=cell.getVertexValue(0,scalarExtractor);
+	VScalar minValue=cvvs[0];
+	VScalar maxValue=cvvs[0];
+	for(int i=1;i<CellTopology::numVertices;++i)
+		{
+		cvvs[i]=cell.getVertexValue(i,scalarExtractor);
+		if(minValue>cvvs[i])
+			minValue=cvvs[i];
+		else if(maxValue<cvvs[i])
+			maxValue=cvvs[i];
+		}
+	
+	/* Cell vertex gradients are calculated on demand and shared by all isosurfaces: */
+	bool cvgvs[CellTopology::numVertices];
+	for(int i=0;i<CellTopology::numVertices;++i)
+		cvgvs[i]=false;
+	Vector cvgs[CellTopology::numVertices];
+	
+	/* Only the isovalues above the cell's minimum and at or below its maximum intersect the cell: */
+	size_t numLevels=isovalues.size();
+	for(size_t level=std::upper_bound(isovalues.begin(),isovalues.end(),minValue)-isovalues.begin();level<numLevels&&isovalues[level]<=maxValue;++level)
+		{
+		VScalar isovalue=isovalues[level];
+		Isosurface* isosurface=isosurfaces[level];
+		
+		/* Determine the cell's case index for the current isovalue: */
+		int caseIndex=0x0;
+		for(int i=0;i<CellTopology::numVertices;++i)
+			if(cvvs[i]>=isovalue)
+				caseIndex|=1<<i;
+		int cem=CaseTable::edgeMasks[caseIndex];
+		
+		if(extractionMode==FLAT)
+			{
+			/* Calculate the edge intersection points: */
+			Point edgeVertices[CellTopology::numEdges];
+			for(int edge=0;edge<CellTopology::numEdges;++edge)
+				if(cem&(1<<edge))
+					{
+					/* Calculate intersection point on the edge: */
+					int vi0=CellTopology::edgeVertexIndices[edge][0];
+					VScalar d0=cvvs[vi0];
+					int vi1=CellTopology::edgeVertexIndices[edge][1];
+					VScalar d1=cvvs[vi1];
+					Scalar w1=Scalar((isovalue-d0)/(d1-d0));
+					edgeVertices[edge]=cell.calcEdgePosition(edge,w1);
+					}
+			
+			/* Store the resulting fragment in the isosurface: */
+			for(const int* ctei=CaseTable::triangleEdgeIndices[caseIndex];*ctei>=0;ctei+=3)
+				{
+				Index* iPtr=isosurface->getNextTriangle();
+				Vector normal=Geometry::cross(edgeVertices[ctei[1]]-edgeVertices[ctei[0]],edgeVertices[ctei[2]]-edgeVertices[ctei[0]]);
+				for(int i=0;i<3;++i)
+					{
+					Vertex* vertex=isosurface->getNextVertex();
+					vertex->normal=normal.getComponents();
+					vertex->position=edgeVertices[ctei[i]].getComponents();
+					iPtr[i]=isosurface->addVertex();
+					}
+				isosurface->addTriangle();
+				}
+			}
+		else
+			{
+			/* Get the indices of all vertices that have already been computed: */
+			VertexIndexHasher& levelVertexIndices=*vertexIndices[level];
+			Index edgeVertexIndices[CellTopology::numEdges];
+			for(int edge=0;edge<CellTopology::numEdges;++edge)
+				if(cem&(1<<edge))
+					{
+					/* Check if the edge already has a vertex in the isosurface: */
+					typename VertexIndexHasher::Iterator vIt=levelVertexIndices.findEntry(cell.getEdgeID(edge));
+					if(!vIt.isFinished())
+						edgeVertexIndices[edge]=vIt->getDest();
+					else
+						{
+						/* Mark the vertex as invalid: */
+						edgeVertexIndices[edge]=~Index(0);
+						
+						/* Calculate the edge's vertex gradients unless an earlier isosurface already needed them: */
+						for(int i=0;i<2;++i)
+							{
+							int vi=CellTopology::edgeVertexIndices[edge][i];
+							if(!cvgvs[vi])
+								{
+								cvgs[vi]=cell.calcVertexGradient(vi,scalarExtractor);
+								cvgvs[vi]=true;
+								}
+							}
+						}
+					}
+			
+			/* Calculate the edge intersection points: */
+			for(int edge=0;edge<CellTopology::numEdges;++edge)
+				if((cem&(1<<edge))&&edgeVertexIndices[edge]==~Index(0))
+					{
+					/* Create a new vertex: */
+					Vertex* vertex=isosurface->getNextVertex();
+					
+					/* Calculate the intersection point on the edge: */
+					int vi0=CellTopology::edgeVertexIndices[edge][0];
+					VScalar d0=cvvs[vi0];
+					int vi1=CellTopology::edgeVertexIndices[edge][1];
+					VScalar d1=cvvs[vi1];
+					Scalar w1=Scalar((isovalue-d0)/(d1-d0));
+					Vector v=cvgs[vi0]*(Scalar(1)-w1)+cvgs[vi1]*w1;
+					v/=-v.mag();
+					vertex->normal=v.getComponents();
+					vertex->position=cell.calcEdgePosition(edge,w1).getComponents();
+					
+					/* Store the vertex in the isosurface, and its index in the hash table: */
+					edgeVertexIndices[edge]=isosurface->addVertex();
+					levelVertexIndices.setEntry(typename VertexIndexHasher::Entry(cell.getEdgeID(edge),edgeVertexIndices[edge]));
+					}
+			
+			/* Store the resulting isosurface fragment in the isosurface: */
+			for(const int* ctei=CaseTable::triangleEdgeIndices[caseIndex];*ctei>=0;ctei+=3)
+				{
+				Index* iPtr=isosurface->getNextTriangle();
+				for(int i=0;i<3;++i)
+					iPtr[i]=edgeVertexIndices[ctei[i]];
+				isosurface->addTriangle();
+				}
+			}
+		}
+	}
+
+template <class DataSetParam,class ScalarExtractorParam,class VertexParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::extractBlock(
+	const std::vector<typename MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::CellRange>& blocks,
+	size_t block)
+	{
+	/* Extract the fragments of all isosurfaces from all cells in the block: */
+	for(CellIterator cIt=blocks[block].first;cIt!=blocks[block].second;++cIt)
+		extractFragments(*cIt);
+	}
+
+template <class DataSetParam,class ScalarExtractorParam,class VertexParam>
+inline
+MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::MultiIsosurfaceExtractor(
+	const typename MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::DataSet* sDataSet,
+	const typename MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::ScalarExtractor& sScalarExtractor)
+	:dataSet(sDataSet),
+	 scalarExtractor(sScalarExtractor),
+	 extractionMode(FLAT),numThreads(0),blockIndex(0)
+	{
+	}
+
+template <class DataSetParam,class ScalarExtractorParam,class VertexParam>
+inline
+MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::~MultiIsosurfaceExtractor(
+	void)
+	{
+	for(typename std::vector<VertexIndexHasher*>::iterator viIt=vertexIndices.begin();viIt!=vertexIndices.end();++viIt)
+		delete *viIt;
+	}
+
+template <class DataSetParam,class ScalarExtractorParam,class VertexParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::setExtractionMode(
+	typename MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::ExtractionMode newExtractionMode)
+	{
+	extractionMode=newExtractionMode;
+	}
+
+template <class DataSetParam,class ScalarExtractorParam,class VertexParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::setNumThreads(
+	int newNumThreads)
+	{
+	numThreads=newNumThreads;
+	}
+
+template <class DataSetParam,class ScalarExtractorParam,class VertexParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::setBlockIndex(
+	const typename MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::BlockIndex* newBlockIndex)
+	{
+	blockIndex=newBlockIndex;
+	}
+
+template <class DataSetParam,class ScalarExtractorParam,class VertexParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::extractIsosurfaces(
+	const std::vector<typename MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::VScalar>& newIsovalues,
+	const std::vector<typename MultiIsosurfaceExtractor<DataSetParam,ScalarExtractorParam,VertexParam>::Isosurface*>& newIsosurfaces)
+	{
+	/* Set the isosurface extraction parameters: */
+	isovalues=newIsovalues;
+	size_t numLevels=isovalues.size();
+	
+	/* Collect the blocks of cells to extract: */
+	std::vector<CellRange> blocks;
+	if(blockIndex!=0)
+		{
+		/* Only visit the blocks whose value ranges contain any of the isovalues: */
+		blockIndex->findIsosurfaceBlocks(isovalues,blocks);
+		}
+	else
+		{
+		/* Split the cell list into blocks of cells: */
+		CellIterator cIt=dataSet->beginCells();
+		CellIterator cEnd=dataSet->endCells();
+		while(cIt!=cEnd)
+			{
+			CellIterator blockBegin=cIt;
+			for(size_t i=0;i<cellBlockSize&&cIt!=cEnd;++i)
+				++cIt;
+			blocks.push_back(CellRange(blockBegin,cIt));
+			}
+		}
+	
+	/* Determine the number of threads: */
+	int numExtractionThreads=getNumWorkerThreads(numThreads);
+	if(size_t(numExtractionThreads)>blocks.size())
+		numExtractionThreads=blocks.size()>0?int(blocks.size()):1;
+	
+	/* Keep this thread from being cancelled while the workers use its stack and the result isosurfaces: */
+	WorkerThreadSection workerThreadSection;
+	
+	/*********************************************************************
+	Each thread, including the calling thread, extracts blocks into private
+	isosurfaces, and appends them to the result isosurfaces after each
+	block. The first isosurface streams its fragments to the slaves as its
+	chunks fill up; as the slaves receive the isosurfaces one after the
+	other, the other levels are collected in staging isosurfaces, and are
+	handed to their isosurfaces one level at a time at the end.
+	*********************************************************************/
+	
+	for(size_t level=0;level<numLevels;++level)
+		{
+		isosurfaces.push_back(level==0?newIsosurfaces[level]:new Isosurface(0));
+		vertexIndices.push_back(new VertexIndexHasher(101));
+		}
+	Threads::Mutex nextBlockMutex;
+	size_t nextBlock=0;
+	Threads::Mutex resultMutex;
+	ExtractionJob* jobs=new ExtractionJob[numExtractionThreads];
+	for(int i=0;i<numExtractionThreads;++i)
+		{
+		jobs[i].extractor=new MultiIsosurfaceExtractor(dataSet,scalarExtractor);
+		jobs[i].extractor->extractionMode=extractionMode;
+		jobs[i].extractor->isovalues=isovalues;
+		for(size_t level=0;level<numLevels;++level)
+			{
+			jobs[i].extractor->isosurfaces.push_back(new Isosurface(0));
+			jobs[i].extractor->vertexIndices.push_back(new VertexIndexHasher(101));
+			}
+		jobs[i].blocks=&blocks;
+		jobs[i].nextBlockMutex=&nextBlockMutex;
+		jobs[i].nextBlock=&nextBlock;
+		jobs[i].resultMutex=&resultMutex;
+		jobs[i].result=this;
+		}
+	Threads::Thread* threads=new Threads::Thread[numExtractionThreads-1];
+	for(int i=1;i<numExtractionThreads;++i)
+		threads[i-1].start(&jobs[i],&ExtractionJob::extractThreadMethod);
+	jobs[0].extractThreadMethod();
+	for(int i=1;i<numExtractionThreads;++i)
+		threads[i-1].join();
+	delete[] threads;
+	for(int i=0;i<numExtractionThreads;++i)
+		{
+		for(size_t level=0;level<numLevels;++level)
+			delete jobs[i].extractor->isosurfaces[level];
+		delete jobs[i].extractor;
+		}
+	delete[] jobs;
+	
+	/* Finish streaming the first isosurface, and hand the staged isosurfaces to the other ones, which streams them to the slaves: */
+	for(size_t level=0;level<numLevels;++level)
+		{
+		if(level>0)
+			{
+			newIsosurfaces[level]->adopt(*isosurfaces[level]);
+			delete isosurfaces[level];
+			}
+		newIsosurfaces[level]->flush();
+		delete vertexIndices[level];
+		}
+	isosurfaces.clear();
+	vertexIndices.clear();
+	}
+
+}
+
+}
@@ -0,0 +1,149 @@
+/***********************************************************************
+MultiIsosurfaceExtractor - Class to extract the global isosurfaces of
+several isovalues from data sets in a single pass over the data set's
+cells. Each cell's vertex values are read once, and the cell's fragments
+for all isovalues are stored in one indexed triangle set per isovalue.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_MULTIISOSURFACEEXTRACTOR_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_MULTIISOSURFACEEXTRACTOR_INCLUDED
+
+#include <stddef.h>
+#include <vector>
+#include <Misc/HashTable.h>
+#include <Templatized/CellBlockIndex.h>
+#include <Templatized/IndexedTriangleSet.h>
+
+/* Forward declarations: */
+namespace Visualization {
+namespace Templatized {
+template <class CellTopologyParam>
+class IsosurfaceCaseTable;
+}
+}
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class DataSetParam,class ScalarExtractorParam,class VertexParam>
+class MultiIsosurfaceExtractor
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSetParam DataSet; // Type of the data set the isosurface extractor works on
+	typedef typename DataSet::Scalar Scalar; // Scalar type of the data set's domain
+	static const int dimension=DataSet::dimension; // Dimension of the data set's domain
+	typedef typename DataSet::Point Point; // Type for points in the data set's domain
+	typedef typename DataSet::Vector Vector; // Type for vectors in the data set's domain
+	typedef ScalarExtractorParam ScalarExtractor; // Type to extract scalar values from a data set
+	typedef typename ScalarExtractor::Scalar VScalar; // Value type of scalar extractor
+	typedef IndexedTriangleSet<VertexParam> Isosurface; // Type of isosurface representation
+	typedef CellBlockIndex<DataSet,ScalarExtractor> BlockIndex; // Type of index to skip blocks of cells during isosurface extraction
+	
+	enum ExtractionMode // Enumerated type for isosurface extraction modes
+		{
+		FLAT,SMOOTH
+		};
+	
+	static const size_t cellBlockSize=4096; // Number of cells in each block of cells handed to an extraction thread
+	
+	private:
+	typedef typename DataSet::CellTopology CellTopology; // Topology of the data set's cells
+	typedef typename DataSet::Cell Cell; // Type of the data set's cells
+	typedef typename DataSet::CellIterator CellIterator; // Type to iterate through the data set's cells
+	typedef typename DataSet::EdgeID EdgeID; // Type of the data set's edge IDs
+	typedef typename BlockIndex::CellRange CellRange; // Type for half-open ranges of cells
+	typedef IsosurfaceCaseTable<CellTopology> CaseTable; // Type of isosurface case table
+	typedef typename Isosurface::Vertex Vertex; // Type of vertices stored in isosurface
+	typedef typename Isosurface::Index Index; // Type for vertex indices
+	typedef Misc::HashTable<EdgeID,Index,EdgeID> VertexIndexHasher; // Hash table to map edge IDs to vertex indices in an isosurface
+	struct ExtractionJob; // Structure describing one thread's share of a multi-isosurface extraction
+	
+	/* Elements: */
+	const DataSet* dataSet; // Data set the isosurface extractor works on
+	ScalarExtractor scalarExtractor; // Scalar extractor working on data set
+	ExtractionMode extractionMode; // Surface extraction mode
+	int numThreads; // Number of threads for isosurface extraction, or 0 to use one thread per CPU
+	const BlockIndex* blockIndex; // Index to skip blocks of cells that cannot intersect any of the isosurfaces, or null to visit all cells
+	
+	/* Isosurface extraction state: */
+	std::vector<VScalar> isovalues; // The current isovalues in ascending order
+	std::vector<Isosurface*> isosurfaces; // Pointers to the isosurface representations storing extracted fragments, one per isovalue
+	std::vector<VertexIndexHasher*> vertexIndices; // Hashers mapping edge IDs to vertex indices, one per isosurface
+	
+	/* Private methods: */
+	void extractFragments(const Cell& cell); // Extracts the fragments of all isosurfaces from a cell and stores them in the current isosurface representations
+	void extractBlock(const std::vector<CellRange>& blocks,size_t block); // Extracts the fragments of all isosurfaces from a block of cells
+	
+	/* Constructors and destructors: */
+	public:
+	MultiIsosurfaceExtractor(const DataSet* sDataSet,const ScalarExtractor& sScalarExtractor); // Creates a multi-isosurface extractor for the given data set and scalar extractor
+	private:
+	MultiIsosurfaceExtractor(const MultiIsosurfaceExtractor& source); // Prohibit copy constructor
+	MultiIsosurfaceExtractor& operator=(const MultiIsosurfaceExtractor& source); // Prohibit assignment operator
+	public:
+	~MultiIsosurfaceExtractor(void); // Destroys the multi-isosurface extractor
+	
+	/* Methods: */
+	const DataSet* getDataSet(void) const // Returns the data set
+		{
+		return dataSet;
+		}
+	const ScalarExtractor& getScalarExtractor(void) const // Returns the scalar extractor
+		{
+		return scalarExtractor;
+		}
+	ScalarExtractor& getScalarExtractor(void) // Ditto
+		{
+		return scalarExtractor;
+		}
+	ExtractionMode getExtractionMode(void) const // Returns the current isosurface extraction mode
+		{
+		return extractionMode;
+		}
+	void update(const DataSet* newDataSet,const ScalarExtractor& newScalarExtractor) // Sets a new data set and scalar extractor for subsequent isosurface extraction
+		{
+		dataSet=newDataSet;
+		scalarExtractor=newScalarExtractor;
+		}
+	int getNumThreads(void) const // Returns the number of threads for isosurface extraction
+		{
+		return numThreads;
+		}
+	const BlockIndex* getBlockIndex(void) const // Returns the block index used for isosurface extraction
+		{
+		return blockIndex;
+		}
+	void setExtractionMode(ExtractionMode newExtractionMode); // Sets the current isosurface extraction mode
+	void setNumThreads(int newNumThreads); // Sets the number of threads for isosurface extraction; 0 uses one thread per CPU
+	void setBlockIndex(const BlockIndex* newBlockIndex); // Sets an index built for the current data set and scalar extractor to skip blocks of cells; null visits all cells
+	void extractIsosurfaces(const std::vector<VScalar>& newIsovalues,const std::vector<Isosurface*>& newIsosurfaces); // Extracts the global isosurfaces of the given isovalues, which must be sorted in ascending order, and stores each in the isosurface of the same index
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_TEMPLATIZED_MULTIISOSURFACEEXTRACTOR_IMPLEMENTATION
+#include <Templatized/MultiIsosurfaceExtractor.cpp>
+#endif
+
+#endif
@@ -21,6 +21,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #define VISUALIZATION_TEMPLATIZED_SLICEEXTRACTOR_IMPLEMENTATION
 
+#include <vector>
+
 #include <Templatized/SliceExtractor.h>
 
 namespace Visualization {
@@ -88,6 +90,7 @@ SliceExtractor<DataSetParam,ScalarExtractorParam,SliceParam>::SliceExtractor(
 	const typename SliceExtractor<DataSetParam,ScalarExtractorParam,SliceParam>::ScalarExtractor& sScalarExtractor)
 	:dataSet(sDataSet),
 	 scalarExtractor(sScalarExtractor),
+	 blockIndex(0),
 	 slice(0),
 	 cellQueue(101)
 	{
@@ -111,11 +114,26 @@ SliceExtractor<DataSetParam,ScalarExtractorParam,SliceParam>::extractSlice(
 	slicePlane=newSlicePlane;
 	slice=&newSlice;
 	
-	/* Extract slice fragments from all cells: */
-	for(typename DataSet::CellIterator cIt=dataSet->beginCells();cIt!=dataSet->endCells();++cIt)
+	if(blockIndex!=0)
 		{
-		/* Extract the cell's slice fragment: */
-		extractSliceFragment(*cIt);
+		/* Extract slice fragments only from the blocks whose bounding boxes straddle the slicing plane: */
+		std::vector<typename BlockIndex::CellRange> blocks;
+		blockIndex->findSliceBlocks(slicePlane,blocks);
+		for(typename std::vector<typename BlockIndex::CellRange>::const_iterator bIt=blocks.begin();bIt!=blocks.end();++bIt)
+			for(typename DataSet::CellIterator cIt=bIt->first;cIt!=bIt->second;++cIt)
+				{
+				/* Extract the cell's slice fragment: */
+				extractSliceFragment(*cIt);
+				}
+		}
+	else
+		{
+		/* Extract slice fragments from all cells: */
+		for(typename DataSet::CellIterator cIt=dataSet->beginCells();cIt!=dataSet->endCells();++cIt)
+			{
+			/* Extract the cell's slice fragment: */
+			extractSliceFragment(*cIt);
+			}
 		}
 	
 	/* Clean up: */
@@ -22,6 +22,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #define VISUALIZATION_TEMPLATIZED_SLICEEXTRACTORINDEXEDTRIANGLESET_IMPLEMENTATION
 
+#include <vector>
+
 #include <Templatized/SliceExtractorIndexedTriangleSet.h>
 
 namespace Visualization {
@@ -102,6 +104,7 @@ SliceExtractor<DataSetParam,ScalarExtractorParam,IndexedTriangleSet<VertexParam>
 	const typename SliceExtractor<DataSetParam,ScalarExtractorParam,IndexedTriangleSet<VertexParam> >::ScalarExtractor& sScalarExtractor)
 	:dataSet(sDataSet),
 	 scalarExtractor(sScalarExtractor),
+	 blockIndex(0),
 	 slice(0),
 	 vertexIndices(101),
 	 cellQueue(101)
@@ -126,11 +129,26 @@ SliceExtractor<DataSetParam,ScalarExtractorParam,IndexedTriangleSet<VertexParam>
 	slicePlane=newSlicePlane;
 	slice=&newSlice;
 	
-	/* Extract slice fragments from all cells: */
-	for(typename DataSet::CellIterator cIt=dataSet->beginCells();cIt!=dataSet->endCells();++cIt)
+	if(blockIndex!=0)
 		{
-		/* Extract the cell's slice fragment: */
-		extractSliceFragment(*cIt);
+		/* Extract slice fragments only from the blocks whose bounding boxes straddle the slicing plane: */
+		std::vector<typename BlockIndex::CellRange> blocks;
+		blockIndex->findSliceBlocks(slicePlane,blocks);
+		for(typename std::vector<typename BlockIndex::CellRange>::const_iterator bIt=blocks.begin();bIt!=blocks.end();++bIt)
+			for(typename DataSet::CellIterator cIt=bIt->first;cIt!=bIt->second;++cIt)
+				{
+				/* Extract the cell's slice fragment: */
+				extractSliceFragment(*cIt);
+				}
+		}
+	else
+		{
+		/* Extract slice fragments from all cells: */
+		for(typename DataSet::CellIterator cIt=dataSet->beginCells();cIt!=dataSet->endCells();++cIt)
+			{
+			/* Extract the cell's slice fragment: */
+			extractSliceFragment(*cIt);
+			}
 		}
 	
 	/* Clean up: */
@@ -26,6 +26,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Misc/HashTable.h>
 #include <Misc/OneTimeQueue.h>
 #include <Geometry/Plane.h>
+#include <Templatized/CellBlockIndex.h>
 #include <Templatized/IndexedTriangleSet.h>
 #include <Templatized/SliceExtractor.h>
 
@@ -56,6 +57,7 @@ class SliceExtractor<DataSetParam,ScalarExtractorParam,IndexedTriangleSet<Vertex
 	typedef ScalarExtractorParam ScalarExtractor; // Type to extract scalar values from a data set
 	typedef typename ScalarExtractor::Scalar VScalar; // Value type of scalar extractor
 	typedef IndexedTriangleSet<VertexParam> Slice; // Type of slice representation
+	typedef CellBlockIndex<DataSet,ScalarExtractor> BlockIndex; // Type of index to skip blocks of cells during global slice extraction
 	
 	private:
 	typedef typename DataSet::CellTopology CellTopology; // Topology of the data set's cells
@@ -72,6 +74,7 @@ class SliceExtractor<DataSetParam,ScalarExtractorParam,IndexedTriangleSet<Vertex
 	private:
 	const DataSet* dataSet; // Data set the isosurface extractor works on
 	ScalarExtractor scalarExtractor; // Scalar extractor working on data set
+	const BlockIndex* blockIndex; // Index to skip blocks of cells that cannot intersect the slicing plane during global slice extraction, or null to visit all cells
 	
 	/* Slice extraction state: */
 	Plane slicePlane; // The current slicing plane
@@ -109,6 +112,14 @@ class SliceExtractor<DataSetParam,ScalarExtractorParam,IndexedTriangleSet<Vertex
 		dataSet=newDataSet;
 		scalarExtractor=newScalarExtractor;
 		}
+	const BlockIndex* getBlockIndex(void) const // Returns the block index used for global slice extraction
+		{
+		return blockIndex;
+		}
+	void setBlockIndex(const BlockIndex* newBlockIndex) // Sets an index built for the current data set to skip blocks of cells during global slice extraction; null visits all cells
+		{
+		blockIndex=newBlockIndex;
+		}
 	void extractSlice(const Plane& newSlicePlane,Slice& newSlice); // Extracts a global slice for the given plane and stores it in the given slice
 	void extractSeededSlice(const Locator& seedLocator,const Plane& newSlicePlane,Slice& newSlice); // Extracts a seeded slice for the given plane from the given cell and stores it in the given slice
 	void startSeededSlice(const Locator& seedLocator,const Plane& newSlicePlane,Slice& newSlice); // Starts extracting a seeded slice for the given plane from the given cell
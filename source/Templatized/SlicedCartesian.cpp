@@ -349,7 +349,7 @@ SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>::SlicedCartesian(
 	 cellSize(Scalar(0)),
 	 domainBox(Box::empty),
 	 numSlices(0),
-	 slices(0)
+	 slices(0),encodedSlices(0)
 	{
 	/* Initialize vertex stride array: */
 	for(int i=0;i<dimension;++i)
@@ -377,7 +377,7 @@ SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>::SlicedCartesian(
 	const typename SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>::Size& sCellSize,
 	int sNumSlices,
 	const typename SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>::ValueScalar* sVertexValues)
-	:slices(0)
+	:numSlices(0),slices(0),encodedSlices(0)
 	{
 	setData(sNumVertices,sCellSize,sNumSlices,sVertexValues);
 	}
@@ -389,8 +389,12 @@ SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>::~SlicedCartesian(
 	{
 	/* Delete slice arrays: */
 	for(int slice=0;slice<numSlices;++slice)
+		{
 		delete[] slices[slice];
+		encodedSlices[slice].deleteValues();
+		}
 	delete[] slices;
+	delete[] encodedSlices;
 	}
 
 template <class ScalarParam,int dimensionParam,class ValueScalarParam>
@@ -447,10 +451,15 @@ SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>::setData(
 	
 	/* Re-initialize the slice arrays: */
 	for(int slice=0;slice<numSlices;++slice)
+		{
 		delete[] slices[slice];
+		encodedSlices[slice].deleteValues();
+		}
 	delete[] slices;
+	delete[] encodedSlices;
 	numSlices=sNumSlices;
 	slices=new ValueScalar*[numSlices];
+	encodedSlices=new ValueSlice[numSlices];
 	size_t totalNumVertices=size_t(numVertices.calcIncrement(-1));
 	for(int slice=0;slice<numSlices;++slice)
 		slices[slice]=new ValueScalar[totalNumVertices];
@@ -477,8 +486,12 @@ SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>::addSlice(
 	{
 	/* Create a new slice array: */
 	ValueScalar** newSlices=new ValueScalar*[numSlices+1];
+	ValueSlice* newEncodedSlices=new ValueSlice[numSlices+1];
 	for(int slice=0;slice<numSlices;++slice)
+		{
 		newSlices[slice]=slices[slice];
+		newEncodedSlices[slice]=encodedSlices[slice];
+		}
 	
 	/* Initialize the new slice: */
 	size_t totalNumVertices=size_t(numVertices.calcIncrement(-1));
@@ -494,12 +507,43 @@ SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>::addSlice(
 	
 	/* Install the new slice array: */
 	delete[] slices;
+	delete[] encodedSlices;
 	++numSlices;
 	slices=newSlices;
+	encodedSlices=newEncodedSlices;
 	
 	return numSlices-1;
 	}
 
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+int
+SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>::addSlice(
+	const typename SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>::ValueScalar* sSliceValues,
+	typename SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>::ValueSlice::Format format)
+	{
+	int sliceIndex=addSlice(sSliceValues);
+	encodeSlice(sliceIndex,format);
+	
+	return sliceIndex;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>::encodeSlice(
+	int sliceIndex,
+	typename SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>::ValueSlice::Format format)
+	{
+	if(format==ValueSlice::NATIVE||encodedSlices[sliceIndex].getValues()!=0)
+		return;
+	
+	/* Replace the native slice with an encoded copy: */
+	encodedSlices[sliceIndex]=ValueSlice::encode(format,getTotalNumVertices(),slices[sliceIndex]);
+	delete[] slices[sliceIndex];
+	slices[sliceIndex]=0;
+	}
+
 template <class ScalarParam,int dimensionParam,class ValueScalarParam>
 inline
 typename SlicedCartesian<ScalarParam,dimensionParam,ValueScalarParam>::Point
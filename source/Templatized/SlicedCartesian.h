@@ -30,6 +30,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Geometry/Box.h>
 
 #include <Templatized/SlicedDataValue.h>
+#include <Templatized/EncodedSlice.h>
 #include <Templatized/Tesseract.h>
 #include <Templatized/LinearIndexID.h>
 #include <Templatized/IteratorWrapper.h>
@@ -58,6 +59,7 @@ class SlicedCartesian
 	/* Definition of the data set's value space: */
 	typedef ValueScalarParam ValueScalar; // Data set's value type
 	typedef SlicedDataValue<ValueScalar> Value; // Data set's compound value type
+	typedef EncodedSlice<ValueScalar> ValueSlice; // Type of descriptors for value slices stored in native or encoded form
 	
 	/* Low-level definitions of data set storage: */
 	typedef Misc::ArrayIndex<dimensionParam> Index; // Index type for data set storage
@@ -253,7 +255,8 @@ class SlicedCartesian
 	CellIterator firstCell,lastCell; // Bounds of cell list
 	Box domainBox; // Bounding box of all vertices
 	int numSlices; // Number of scalar value slices in the data set
-	ValueScalar** slices; // Array of vertex value slices
+	ValueScalar** slices; // Array of vertex value slices; encoded slices have null value arrays
+	ValueSlice* encodedSlices; // Array of descriptors of encoded value slices; descriptors of native slices have null value arrays
 	
 	/* Private methods: */
 	template <class ScalarExtractorParam>
@@ -268,6 +271,14 @@ class SlicedCartesian
 	/* Data set construction methods: */
 	void setData(const Index& sNumVertices,const Size& sCellSize,int sNumSlices,const ValueScalar* sVertexValues =0); // Sets the number of vertices and cell size of the data set; copies slice-major vertex data if pointer is not null
 	int addSlice(const ValueScalar* sSliceValues =0); // Adds another slice to the data set; copies vertex data if pointer is not null
+	int addSlice(const ValueScalar* sSliceValues,typename ValueSlice::Format format); // Adds another slice storing the given vertex data in the given format; returns index of new slice
+	void encodeSlice(int sliceIndex,typename ValueSlice::Format format); // Converts a native slice to the given storage format; the slice's values are read-only afterwards
+	void swapSliceArray(int sliceIndex,ValueScalar*& sliceArray) // Exchanges the array of a native slice owned by the data set with the given array of the same size; the data set takes ownership of the given array, and the caller of the slice's old array
+		{
+		ValueScalar* oldSliceArray=slices[sliceIndex];
+		slices[sliceIndex]=sliceArray;
+		sliceArray=oldSliceArray;
+		}
 	
 	/* Low-level data access methods: */
 	const Index& getNumVertices(void) const // Returns number of vertices in the data set
@@ -283,7 +294,7 @@ class SlicedCartesian
 		{
 		return numSlices;
 		}
-	const ValueScalar* getSliceArray(int sliceIndex) const // Returns one of the data set's value slices as a C array
+	const ValueScalar* getSliceArray(int sliceIndex) const // Returns one of the data set's value slices as a C array; returns null for encoded slices
 		{
 		return slices[sliceIndex];
 		}
@@ -291,11 +302,15 @@ class SlicedCartesian
 		{
 		return slices[sliceIndex];
 		}
+	ValueSlice getValueSlice(int sliceIndex) const // Returns a descriptor of one of the data set's value slices
+		{
+		return encodedSlices[sliceIndex].getValues()!=0?encodedSlices[sliceIndex]:ValueSlice(slices[sliceIndex]);
+		}
 	ValueScalar getVertexValue(int sliceIndex,const Index& vertexIndex) const // Returns a vertex' data value inside a slice
 		{
-		return slices[sliceIndex][numVertices.calcOffset(vertexIndex)];
+		return ValueScalar(getValueSlice(sliceIndex).getValue(numVertices.calcOffset(vertexIndex)));
 		}
-	ValueScalar& getVertexValue(int sliceIndex,const Index& vertexIndex)  // Ditto
+	ValueScalar& getVertexValue(int sliceIndex,const Index& vertexIndex)  // Ditto; slice must be native
 		{
 		return slices[sliceIndex][numVertices.calcOffset(vertexIndex)];
 		}
@@ -239,13 +239,12 @@ SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::Locator::locateP
 	if(!traceHint||cantTrace)
 		{
 		/* Start searching from cell whose cell center is closest to query position: */
-		FindClosestPointFunctor<CellCenter> f(position,ds->maxCellRadius2);
-		ds->cellCenterTree.traverseTreeDirected(f);
-		if(f.getClosestPoint()==0) // Bail out if no cell is close enough
+		const CellCenter* closestCenter=ds->findClosestCellCenter(position);
+		if(closestCenter==0) // Bail out if no cell is close enough
 			return false;
 		
 		/* Go to the found cell: */
-		Cell::operator=(ds->getCell(f.getClosestPoint()->value));
+		Cell::operator=(ds->getCell(closestCenter->value));
 		
 		/* Initialize local cell position: */
 		for(int i=0;i<dimension;++i)
@@ -254,7 +253,7 @@ SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::Locator::locateP
 		/* Now we can trace: */
 		cantTrace=false;
 		}
-
+	
 	/* Perform Newton-Raphson iteration until it converges and the current cell contains the query point: */
 	Scalar maxOut;
 	CellID previousCellID; // Cell ID to detect "thrashing" between cells
@@ -290,9 +289,8 @@ SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::Locator::locateP
 		if(iteration==0&&maxOut>Scalar(5))
 			{
 			/* We had a tracing failure; just start searching from scratch: */
-			FindClosestPointFunctor<CellCenter> f(position,ds->maxCellRadius2);
-			ds->cellCenterTree.traverseTreeDirected(f);
-			if(f.getClosestPoint()==0) // Bail out if no cell is close enough
+			const CellCenter* closestCenter=ds->findClosestCellCenter(position);
+			if(closestCenter==0) // Bail out if no cell is close enough
 				{
 				/* At this point, the locator is borked. Better not trace next time: */
 				cantTrace=true;
@@ -302,9 +300,9 @@ SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::Locator::locateP
 				}
 			
 			/* Go to the found cell: */
-			Cell::operator=(ds->getCell(f.getClosestPoint()->value));
+			Cell::operator=(ds->getCell(closestCenter->value));
 			previousCellID=currentCellID;
-			currentCellID=f.getClosestPoint()->value;
+			currentCellID=closestCenter->value;
 			previousMaxMove=maxOut;
 			
 			/* Initialize the local cell position: */
@@ -559,9 +557,10 @@ inline
 SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::SlicedCurvilinear(
 	void)
 	:numVertices(0),
-	 numSlices(0),slices(0),
+	 numSlices(0),slices(0),encodedSlices(0),
 	 numCells(0),
 	 domainBox(Box::empty),
+	 useCellBuckets(true),
 	 locatorEpsilon(Scalar(1.0e-4))
 	{
 	/* Initialize vertex stride array: */
@@ -594,7 +593,8 @@ SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::SlicedCurvilinea
 	const typename SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::Point* sVertexPositions)
 	:numVertices(sNumVertices),
 	 grid(numVertices),
-	 numSlices(sNumSlices),slices(new ValueArray[numSlices]),
+	 numSlices(sNumSlices),slices(new ValueArray[numSlices]),encodedSlices(new ValueSlice[numSlices]),
+	 useCellBuckets(true),
 	 locatorEpsilon(Scalar(1.0e-4))
 	{
 	initStructure();
@@ -624,6 +624,9 @@ SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::~SlicedCurviline
 	{
 	/* Delete value slice arrays: */
 	delete[] slices;
+	for(int sliceIndex=0;sliceIndex<numSlices;++sliceIndex)
+		encodedSlices[sliceIndex].deleteValues();
+	delete[] encodedSlices;
 	}
 
 template <class ScalarParam,int dimensionParam,class ValueScalarParam>
@@ -639,9 +642,13 @@ SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::setGrid(
 	
 	initStructure();
 	
-	/* Resize all value slices: */
+	/* Resize all value slices; encoded slices become native again: */
 	for(int sliceIndex=0;sliceIndex<numSlices;++sliceIndex)
+		{
 		slices[sliceIndex].resize(numVertices);
+		encodedSlices[sliceIndex].deleteValues();
+		encodedSlices[sliceIndex]=ValueSlice();
+		}
 	
 	/* Copy source vertex positions, if present: */
 	if(sVertexPositions!=0)
@@ -665,11 +672,13 @@ SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::addSlice(
 	{
 	/* Create a new slice array and copy over the old slices and initialize the new slice: */
 	ValueArray* newSlices=new ValueArray[numSlices+1];
+	ValueSlice* newEncodedSlices=new ValueSlice[numSlices+1];
 	for(int sliceIndex=0;sliceIndex<numSlices;++sliceIndex)
 		{
 		/* Move the old value slice over to the new array without copying elements: */
 		newSlices[sliceIndex].ownArray(slices[sliceIndex].getSize(),slices[sliceIndex].getArray());
 		slices[sliceIndex].disownArray();
+		newEncodedSlices[sliceIndex]=encodedSlices[sliceIndex];
 		}
 	newSlices[numSlices].resize(numVertices);
 	
@@ -684,12 +693,43 @@ SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::addSlice(
 	
 	/* Install the new slice array: */
 	delete[] slices;
+	delete[] encodedSlices;
 	++numSlices;
 	slices=newSlices;
+	encodedSlices=newEncodedSlices;
 	
 	return numSlices-1;
 	}
 
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+int
+SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::addSlice(
+	const typename SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::ValueScalar* sSliceValues,
+	typename SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::ValueSlice::Format format)
+	{
+	int sliceIndex=addSlice(sSliceValues);
+	encodeSlice(sliceIndex,format);
+	
+	return sliceIndex;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::encodeSlice(
+	int sliceIndex,
+	typename SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::ValueSlice::Format format)
+	{
+	if(format==ValueSlice::NATIVE||encodedSlices[sliceIndex].getValues()!=0)
+		return;
+	
+	/* Replace the native slice with an encoded copy, and release the native slice's array: */
+	encodedSlices[sliceIndex]=ValueSlice::encode(format,getTotalNumVertices(),slices[sliceIndex].getArray());
+	delete[] slices[sliceIndex].getArray();
+	slices[sliceIndex].disownArray();
+	}
+
 template <class ScalarParam,int dimensionParam,class ValueScalarParam>
 inline
 void
@@ -704,7 +744,13 @@ SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::finalizeGrid(
 		domainBox.addPoint(*vPtr);
 	
 	/* Create array containing all cell centers and cell indices: */
-	CellCenter* ccPtr=cellCenterTree.createTree(numCells.calcIncrement(-1));
+	CellCenter* cellCenters=cellCenterTree.createTree(numCells.calcIncrement(-1));
+	CellCenter* ccPtr=cellCenters;
+	
+	/* Collect the cells' bounding boxes to build the cell bucket grid: */
+	std::vector<Box> cellBoxes;
+	if(useCellBuckets)
+		cellBoxes.reserve(numCells.calcIncrement(-1));
 	
 	/* Calculate all cell centers: */
 	Scalar minCellRadius2(Math::Constants<Scalar>::max);
@@ -732,10 +778,25 @@ SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::finalizeGrid(
 		if(maxCellRadius2<maxDist2)
 			maxCellRadius2=maxDist2;
 		
+		/* Calculate the cell's bounding box: */
+		if(useCellBuckets)
+			{
+			Box cellBox=Box::empty;
+			for(int i=0;i<CellTopology::numVertices;++i)
+				cellBox.addPoint(cIt->getVertexPosition(i));
+			cellBoxes.push_back(cellBox);
+			}
+		
 		/* Store cell center and pointer: */
 		*ccPtr=CellCenter(center,cIt->getID());
 		}
 	
+	/* Sort the cells into the cell bucket grid before the kd-tree reorders the cell centers: */
+	if(useCellBuckets&&!cellBoxes.empty())
+		cellBuckets.build(domainBox,cellBoxes.size(),&cellBoxes[0],cellCenters);
+	else
+		cellBuckets.clear();
+	
 	/* Create the cell center tree: */
 	cellCenterTree.releasePoints(4); // Let's just go ahead and use the multithreaded version
 	
@@ -746,6 +807,35 @@ SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::finalizeGrid(
 	setLocatorEpsilon(Math::sqrt(minCellRadius2)*Scalar(1.0e-4));
 	}
 
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+const typename SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::CellCenter*
+SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::findClosestCellCenter(
+	const typename SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::Point& position) const
+	{
+	/* Only look at the cells overlapping the position's bucket if there is a cell bucket grid: */
+	if(cellBuckets.isValid())
+		return cellBuckets.findClosestPoint(position,maxCellRadius2);
+	
+	/* Otherwise, find the closest cell center in the kd-tree: */
+	FindClosestPointFunctor<CellCenter> f(position,maxCellRadius2);
+	cellCenterTree.traverseTreeDirected(f);
+	return f.getClosestPoint();
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+SlicedCurvilinear<ScalarParam,dimensionParam,ValueScalarParam>::setUseCellBuckets(
+	bool newUseCellBuckets)
+	{
+	useCellBuckets=newUseCellBuckets;
+	
+	/* Release the bucket grid right away; a new one is only built by finalizeGrid(): */
+	if(!useCellBuckets)
+		cellBuckets.clear();
+	}
+
 template <class ScalarParam,int dimensionParam,class ValueScalarParam>
 inline
 void
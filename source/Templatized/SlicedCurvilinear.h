@@ -33,6 +33,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Geometry/ArrayKdTree.h>
 
 #include <Templatized/SlicedDataValue.h>
+#include <Templatized/EncodedSlice.h>
+#include <Templatized/CellBucketGrid.h>
 #include <Templatized/Tesseract.h>
 #include <Templatized/LinearIndexID.h>
 #include <Templatized/IteratorWrapper.h>
@@ -60,6 +62,7 @@ class SlicedCurvilinear
 	/* Definition of the data set's value space: */
 	typedef ValueScalarParam ValueScalar; // Data set's value type for scalar values
 	typedef SlicedDataValue<ValueScalar> Value; // Data set's compound value type
+	typedef EncodedSlice<ValueScalar> ValueSlice; // Type of descriptors for value slices stored in native or encoded form
 	
 	/* Low-level definitions of data set storage: */
 	typedef Misc::ArrayIndex<dimensionParam> Index; // Index type for data set storage (grids and value slices)
@@ -253,6 +256,7 @@ class SlicedCurvilinear
 	private:
 	typedef Geometry::ValuedPoint<Point,CellID> CellCenter; // Data type to associate a cell's center point and its ID
 	typedef Geometry::ArrayKdTree<CellCenter> CellCenterTree; // Data type for kd-trees to locate closest cell centers
+	typedef CellBucketGrid<CellCenter> CellBuckets; // Data type for uniform grids of buckets to locate cells overlapping a point
 	
 	friend class Vertex;
 	friend class Cell;
@@ -263,7 +267,8 @@ class SlicedCurvilinear
 	Index numVertices; // Number of vertices in data set in each dimension
 	GridArray grid; // Array defining data set's grid
 	int numSlices; // Number of scalar value slices in data set
-	ValueArray* slices; // Array of arrays defining data set's value slices
+	ValueArray* slices; // Array of arrays defining data set's value slices; encoded slices have empty arrays
+	ValueSlice* encodedSlices; // Array of descriptors of encoded value slices; descriptors of native slices have null value arrays
 	int vertexStrides[dimension]; // Array of pointer stride values in the vertex array
 	Index numCells; // Number of cells in data set in each dimension
 	int vertexOffsets[CellTopology::numVertices]; // Array of pointer offsets from a cell's base vertex to all cell vertices
@@ -273,9 +278,12 @@ class SlicedCurvilinear
 	Box domainBox; // Bounding box of all vertices
 	Scalar avgCellRadius; // Average "radius" of all cells
 	Scalar maxCellRadius2; // Squared maximum "radius" of any cell (used as trivial reject threshold during point location)
+	bool useCellBuckets; // Flag whether point location starts from the cell bucket grid instead of the cell center kd-tree
+	CellBuckets cellBuckets; // Uniform grid of buckets listing the cells overlapping each bucket
 	Scalar locatorEpsilon; // Default accuracy threshold for locators working on this data set
 	
 	/* Private methods: */
+	const CellCenter* findClosestCellCenter(const Point& position) const; // Returns the center of the cell to start locating the given position from, or null if the position is outside the data set
 	void initStructure(void);
 	template <class ScalarExtractorParam>
 	Vector calcVertexGradient(const Index& vertexIndex,const ScalarExtractorParam& extractor) const; // Returns gradient at a vertex based on the given scalar extractor
@@ -289,6 +297,16 @@ class SlicedCurvilinear
 	/* Data set construction methods: */
 	void setGrid(const Index& sNumVertices,const Point* sVertexPositions =0); // Creates a data set with the given number of vertices; copies vertex positions if pointer is not null
 	int addSlice(const ValueScalar* sSliceValues =0); // Adds another slice to the data set; copies slice values from given array if pointer is not null; returns index of new slice
+	int addSlice(const ValueScalar* sSliceValues,typename ValueSlice::Format format); // Adds another slice storing the given values in the given format; returns index of new slice
+	void encodeSlice(int sliceIndex,typename ValueSlice::Format format); // Converts a native slice to the given storage format; the slice's values are read-only afterwards
+	void swapSliceArray(int sliceIndex,ValueScalar*& sliceArray) // Exchanges the array of a native slice with the given array of the same size; the data set takes ownership of the given array, and the caller of the slice's old array
+		{
+		ValueScalar* oldSliceArray=slices[sliceIndex].getArray();
+		Index sliceSize=slices[sliceIndex].getSize();
+		slices[sliceIndex].disownArray();
+		slices[sliceIndex].ownArray(sliceSize,sliceArray);
+		sliceArray=oldSliceArray;
+		}
 	
 	/* Low-level data access methods: */
 	const Index& getNumVertices(void) const // Returns number of vertices in the data set
@@ -323,7 +341,7 @@ class SlicedCurvilinear
 		{
 		return slices[sliceIndex];
 		}
-	const ValueScalar* getSliceArray(int sliceIndex) const // Returns one of the data set's value slices as a C array
+	const ValueScalar* getSliceArray(int sliceIndex) const // Returns one of the data set's value slices as a C array; returns null for encoded slices
 		{
 		return slices[sliceIndex].getArray();
 		}
@@ -331,11 +349,15 @@ class SlicedCurvilinear
 		{
 		return slices[sliceIndex].getArray();
 		}
+	ValueSlice getValueSlice(int sliceIndex) const // Returns a descriptor of one of the data set's value slices
+		{
+		return encodedSlices[sliceIndex].getValues()!=0?encodedSlices[sliceIndex]:ValueSlice(slices[sliceIndex].getArray());
+		}
 	ValueScalar getVertexValue(int sliceIndex,const Index& vertexIndex) const // Returns a vertex' data value from one slice
 		{
-		return slices[sliceIndex](vertexIndex);
+		return ValueScalar(getValueSlice(sliceIndex).getValue(numVertices.calcOffset(vertexIndex)));
 		}
-	ValueScalar& getVertexValue(int sliceIndex,const Index& vertexIndex) // Ditto
+	ValueScalar& getVertexValue(int sliceIndex,const Index& vertexIndex) // Ditto; slice must be native
 		{
 		return slices[sliceIndex](vertexIndex);
 		}
@@ -344,6 +366,11 @@ class SlicedCurvilinear
 		return numCells;
 		}
 	void finalizeGrid(void); // Recalculates derived grid information after grid structure change
+	bool getUseCellBuckets(void) const // Returns true if point location uses the cell bucket grid
+		{
+		return useCellBuckets;
+		}
+	void setUseCellBuckets(bool newUseCellBuckets); // Selects the cell bucket grid or the cell center kd-tree to start point location; a bucket grid is built by the next call to finalizeGrid()
 	Scalar getLocatorEpsilon(void) const // Returns the current default accuracy threshold for locators working on this data set
 		{
 		return locatorEpsilon;
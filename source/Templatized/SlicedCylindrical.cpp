@@ -0,0 +1,758 @@
+/***********************************************************************
+SlicedCylindrical - Base class for vertex-centered cylindrical data sets
+containing arbitrary numbers of independent scalar fields, combined into
+vector and/or tensor fields using special value extractors. Vertex
+positions are defined by one coordinate array each for the radius, the
+height along the cylinder axis, and the angle around the cylinder axis,
+and the grid can be placed in the domain by an orthonormal
+transformation.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#define VISUALIZATION_TEMPLATIZED_SLICEDCYLINDRICAL_IMPLEMENTATION
+
+#include <Templatized/SlicedCylindrical.h>
+
+#include <Math/Math.h>
+#include <Math/Constants.h>
+
+#include <Templatized/LinearInterpolator.h>
+
+namespace Visualization {
+
+namespace Templatized {
+
+/****************************************
+Methods of class SlicedCylindrical::Cell:
+****************************************/
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Index
+SlicedCylindrical<ScalarParam,ValueScalarParam>::Cell::getVertexIndex(
+	int vertexIndex) const
+	{
+	/* Calculate the index of the cell vertex: */
+	Index cellVertexIndex=index;
+	for(int i=0;i<3;++i)
+		if(vertexIndex&(1<<i))
+			++cellVertexIndex[i];
+	
+	/* Wrap around in a closed angular direction: */
+	if(cellVertexIndex[2]==ds->numVertices[2])
+		cellVertexIndex[2]=0;
+	
+	return cellVertexIndex;
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+typename SlicedCylindrical<ScalarParam,ValueScalarParam>::EdgeID
+SlicedCylindrical<ScalarParam,ValueScalarParam>::Cell::getEdgeID(
+	int edgeIndex) const
+	{
+	EdgeID::Index index(baseVertexIndex);
+	index+=getVertexOffset(CellTopology::edgeVertexIndices[edgeIndex][0]);
+	index*=3;
+	index+=edgeIndex>>2;
+	return EdgeID(index);
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Point
+SlicedCylindrical<ScalarParam,ValueScalarParam>::Cell::calcEdgePosition(
+	int edgeIndex,
+	typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Scalar weight) const
+	{
+	/* Compute the edge point in cylinder coordinates: */
+	int edgeBaseIndex=CellTopology::edgeVertexIndices[edgeIndex][0];
+	int edgeDirection=edgeIndex>>2;
+	Scalar cylinderPos[3];
+	for(int i=0;i<3;++i)
+		{
+		int pos=index[i];
+		if(edgeBaseIndex&(1<<i))
+			++pos;
+		cylinderPos[i]=ds->getAxisCoordinate(i,pos);
+		}
+	int edgeBase=index[edgeDirection];
+	cylinderPos[edgeDirection]+=weight*(ds->getAxisCoordinate(edgeDirection,edgeBase+1)-ds->getAxisCoordinate(edgeDirection,edgeBase));
+	
+	/* Edges along the angular direction are circular arcs: */
+	return ds->calcPosition(cylinderPos[0],cylinderPos[1],cylinderPos[2]);
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+typename SlicedCylindrical<ScalarParam,ValueScalarParam>::CellID
+SlicedCylindrical<ScalarParam,ValueScalarParam>::Cell::getNeighbourID(
+	int neighbourIndex) const
+	{
+	int direction=neighbourIndex>>1;
+	if(neighbourIndex&0x1)
+		{
+		if(index[direction]<ds->numCells[direction]-1)
+			return CellID(CellID::Index(baseVertexIndex+ds->vertexStrides[direction]));
+		else if(direction==2&&ds->closedAngle)
+			return CellID(CellID::Index(baseVertexIndex+ds->vertexStrides[2]+ds->angleWrapOffset));
+		else
+			return CellID();
+		}
+	else
+		{
+		if(index[direction]>0)
+			return CellID(CellID::Index(baseVertexIndex-ds->vertexStrides[direction]));
+		else if(direction==2&&ds->closedAngle)
+			return CellID(CellID::Index(baseVertexIndex-ds->vertexStrides[2]-ds->angleWrapOffset));
+		else
+			return CellID();
+		}
+	}
+
+/*******************************************
+Methods of class SlicedCylindrical::Locator:
+*******************************************/
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+SlicedCylindrical<ScalarParam,ValueScalarParam>::Locator::Locator(
+	void)
+	{
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+SlicedCylindrical<ScalarParam,ValueScalarParam>::Locator::Locator(
+	const SlicedCylindrical<ScalarParam,ValueScalarParam>* sDs)
+	:Cell(sDs)
+	{
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+bool
+SlicedCylindrical<ScalarParam,ValueScalarParam>::Locator::locatePoint(
+	const typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Point& position,
+	bool traceHint)
+	{
+	/* Transform the position to cylinder space and convert it to cylinder coordinates: */
+	Point gridPos=ds->gridTransformation.inverseTransform(position);
+	Scalar cylinderPos[3];
+	cylinderPos[0]=Math::sqrt(Math::sqr(gridPos[0])+Math::sqr(gridPos[1]));
+	cylinderPos[1]=gridPos[2];
+	cylinderPos[2]=Math::atan2(gridPos[1],gridPos[0]);
+	
+	/* Move the angle into the full circle starting at the first vertex angle: */
+	Scalar twoPi=Scalar(2)*Math::Constants<Scalar>::pi;
+	Scalar angle0=ds->vertexCoordinates[2][0];
+	cylinderPos[2]-=Math::floor((cylinderPos[2]-angle0)/twoPi)*twoPi;
+	if(cylinderPos[2]<angle0)
+		cylinderPos[2]=angle0;
+	
+	/* Only use the previous cell as search start if the locator has been localized before: */
+	bool trace=traceHint&&baseVertexIndex>=0;
+	
+	/* Locate the new position independently along each axis: */
+	bool result=true;
+	for(int i=0;i<3;++i)
+		{
+		/* Find the index of the cell containing the position: */
+		Scalar p=cylinderPos[i];
+		const Scalar* coords=ds->vertexCoordinates[i];
+		int lastVertexIndex=ds->numVertices[i]-1;
+		if(p<coords[0])
+			{
+			index[i]=0;
+			result=false;
+			}
+		else if(p>=coords[lastVertexIndex]&&i==2&&ds->closedAngle)
+			{
+			/* The position is in the wedge between the last and the first angle: */
+			index[i]=lastVertexIndex;
+			}
+		else if(p>coords[lastVertexIndex])
+			{
+			if(i==2&&p-coords[lastVertexIndex]>angle0+twoPi-p)
+				{
+				/* The position is closer to the first angle from below: */
+				index[i]=0;
+				p-=twoPi;
+				}
+			else
+				index[i]=ds->numCells[i]-1;
+			result=false;
+			}
+		else
+			index[i]=ds->findCell(i,p,trace?index[i]:-1);
+		
+		/* Calculate the position's local coordinate inside its cell: */
+		Scalar c0=ds->getAxisCoordinate(i,index[i]);
+		cellPos[i]=(p-c0)/(ds->getAxisCoordinate(i,index[i]+1)-c0);
+		}
+	
+	/* Update the cell's base vertex index: */
+	baseVertexIndex=ds->numVertices.calcOffset(index);
+	
+	return result;
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+template <class ValueExtractorParam>
+inline
+typename ValueExtractorParam::DestValue
+SlicedCylindrical<ScalarParam,ValueScalarParam>::Locator::calcValue(
+	const ValueExtractorParam& extractor) const
+	{
+	typedef typename ValueExtractorParam::DestValue DestValue;
+	typedef LinearInterpolator<DestValue,Scalar> Interpolator;
+	
+	/* Perform trilinear interpolation in cylinder coordinates, starting along the angle: */
+	DestValue v[4]; // Array of intermediate interpolation values
+	ptrdiff_t angleStep=Cell::getVertexOffset(0x4);
+	Scalar w1=cellPos[2];
+	Scalar w0=Scalar(1)-w1;
+	for(int vi=0;vi<4;++vi)
+		{
+		ptrdiff_t vIndex=baseVertexIndex+ds->vertexOffsets[vi];
+		v[vi]=Interpolator::interpolate(extractor.getValue(vIndex),w0,extractor.getValue(vIndex+angleStep),w1);
+		}
+	w1=cellPos[1];
+	w0=Scalar(1)-w1;
+	for(int vi=0;vi<2;++vi)
+		v[vi]=Interpolator::interpolate(v[vi],w0,v[vi+2],w1);
+	w1=cellPos[0];
+	w0=Scalar(1)-w1;
+	
+	/* Return final result: */
+	return Interpolator::interpolate(v[0],w0,v[1],w1);
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+template <class ScalarExtractorParam>
+inline
+typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Vector
+SlicedCylindrical<ScalarParam,ValueScalarParam>::Locator::calcGradient(
+	const ScalarExtractorParam& extractor) const
+	{
+	typedef LinearInterpolator<Vector,Scalar> Interpolator;
+	
+	/* Interpolate the vertex gradients trilinearly in cylinder coordinates, starting along the angle: */
+	Vector v[4]; // Array of intermediate interpolation values
+	Scalar w1=cellPos[2];
+	Scalar w0=Scalar(1)-w1;
+	for(int vi=0;vi<4;++vi)
+		{
+		Vector v0=Cell::calcVertexGradient(vi,extractor);
+		Vector v1=Cell::calcVertexGradient(vi|0x4,extractor);
+		v[vi]=Interpolator::interpolate(v0,w0,v1,w1);
+		}
+	w1=cellPos[1];
+	w0=Scalar(1)-w1;
+	for(int vi=0;vi<2;++vi)
+		v[vi]=Interpolator::interpolate(v[vi],w0,v[vi+2],w1);
+	w1=cellPos[0];
+	w0=Scalar(1)-w1;
+	
+	/* Return final result: */
+	return Interpolator::interpolate(v[0],w0,v[1],w1);
+	}
+
+/**********************************
+Methods of class SlicedCylindrical:
+**********************************/
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+void
+SlicedCylindrical<ScalarParam,ValueScalarParam>::initStructure(
+	void)
+	{
+	/* Initialize vertex stride array: */
+	for(int i=0;i<3;++i)
+		vertexStrides[i]=numVertices.calcIncrement(i);
+	
+	/* Calculate number of cells; a closed angular axis has an additional cell between the last and first angles: */
+	for(int i=0;i<3;++i)
+		numCells[i]=numVertices[i]-1;
+	if(closedAngle)
+		++numCells[2];
+	
+	/* Initialize vertex offset array: */
+	for(int i=0;i<CellTopology::numVertices;++i)
+		{
+		/* Vertex indices are, as usual, bit masks of a vertex' position in cell coordinates: */
+		vertexOffsets[i]=0;
+		for(int j=0;j<3;++j)
+			if(i&(1<<j))
+				vertexOffsets[i]+=vertexStrides[j];
+		}
+	angleWrapOffset=-numVertices[2]*vertexStrides[2];
+	
+	/* Initialize vertex list bounds: */
+	Index vertexIndex(0);
+	firstVertex=Vertex(this,vertexIndex);
+	vertexIndex[0]=numVertices[0];
+	lastVertex=Vertex(this,vertexIndex);
+	
+	/* Initialize cell list bounds: */
+	Index cellIndex(0);
+	firstCell=Cell(this,cellIndex);
+	cellIndex[0]=numCells[0];
+	lastCell=Cell(this,cellIndex);
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+void
+SlicedCylindrical<ScalarParam,ValueScalarParam>::installSlice(
+	typename SlicedCylindrical<ScalarParam,ValueScalarParam>::ValueScalar* newSlice,
+	bool external)
+	{
+	/* Create new slice and flag arrays: */
+	ValueScalar** newSlices=new ValueScalar*[numSlices+1];
+	bool* newExternalSlices=new bool[numSlices+1];
+	for(int slice=0;slice<numSlices;++slice)
+		{
+		newSlices[slice]=slices[slice];
+		newExternalSlices[slice]=externalSlices[slice];
+		}
+	newSlices[numSlices]=newSlice;
+	newExternalSlices[numSlices]=external;
+	
+	/* Install the new arrays: */
+	delete[] slices;
+	delete[] externalSlices;
+	++numSlices;
+	slices=newSlices;
+	externalSlices=newExternalSlices;
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Point
+SlicedCylindrical<ScalarParam,ValueScalarParam>::calcPosition(
+	typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Scalar radius,
+	typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Scalar height,
+	typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Scalar angle) const
+	{
+	return gridTransformation.transform(Point(radius*Math::cos(angle),radius*Math::sin(angle),height));
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+int
+SlicedCylindrical<ScalarParam,ValueScalarParam>::findCell(
+	int axis,
+	typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Scalar coordinate,
+	int startIndex) const
+	{
+	const Scalar* coords=vertexCoordinates[axis];
+	int lastCellIndex=numVertices[axis]-2; // Last cell between two vertices; the wrap-around cell is handled by the caller
+	
+	if(uniformAxes[axis])
+		{
+		/* Calculate the cell index directly: */
+		int cellIndex=int(Math::floor((coordinate-axisOrigins[axis])/axisCellSizes[axis]));
+		
+		/* Correct for rounding errors near cell boundaries: */
+		if(cellIndex<0)
+			cellIndex=0;
+		else if(cellIndex>lastCellIndex)
+			cellIndex=lastCellIndex;
+		if(cellIndex>0&&coordinate<coords[cellIndex])
+			--cellIndex;
+		else if(cellIndex<lastCellIndex&&coordinate>=coords[cellIndex+1])
+			++cellIndex;
+		return cellIndex;
+		}
+	
+	/* Check the start cell and its immediate neighbours first: */
+	int l=0;
+	int r=lastCellIndex+1;
+	if(startIndex>=0&&startIndex<=lastCellIndex)
+		{
+		if(coordinate>=coords[startIndex])
+			{
+			if(startIndex==lastCellIndex||coordinate<coords[startIndex+1])
+				return startIndex;
+			if(startIndex+1==lastCellIndex||coordinate<coords[startIndex+2])
+				return startIndex+1;
+			l=startIndex+2;
+			}
+		else
+			{
+			if(startIndex==1||coordinate>=coords[startIndex-1])
+				return startIndex-1;
+			r=startIndex-1;
+			}
+		}
+	
+	/* Find the cell by binary search; invariant: coords[l]<=coordinate<coords[r]: */
+	while(r-l>1)
+		{
+		int m=(l+r)>>1;
+		if(coordinate<coords[m])
+			r=m;
+		else
+			l=m;
+		}
+	return l;
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+template <class ScalarExtractorParam>
+inline
+typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Vector
+SlicedCylindrical<ScalarParam,ValueScalarParam>::calcVertexGradient(
+	const typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Index& vertexIndex,
+	const ScalarExtractorParam& extractor) const
+	{
+	/* Calculate the partial derivatives in cylinder coordinates using second-order differences on the non-uniform grid: */
+	Scalar partials[3];
+	ptrdiff_t vertex=numVertices.calcOffset(vertexIndex);
+	Scalar twoPi=Scalar(2)*Math::Constants<Scalar>::pi;
+	for(int i=0;i<3;++i)
+		{
+		const Scalar* coords=vertexCoordinates[i];
+		int vi=vertexIndex[i];
+		int n=numVertices[i];
+		if(i==2&&closedAngle)
+			{
+			/* Use central differences, wrapping around the full circle: */
+			ptrdiff_t left=vi>0?vertex-vertexStrides[i]:vertex+(n-1)*vertexStrides[i];
+			ptrdiff_t right=vi<n-1?vertex+vertexStrides[i]:vertex-(n-1)*vertexStrides[i];
+			Scalar h1=vi>0?coords[vi]-coords[vi-1]:coords[0]+twoPi-coords[n-1];
+			Scalar h2=vi<n-1?coords[vi+1]-coords[vi]:coords[0]+twoPi-coords[n-1];
+			Scalar f0=Scalar(extractor.getValue(left));
+			Scalar f1=Scalar(extractor.getValue(vertex));
+			Scalar f2=Scalar(extractor.getValue(right));
+			partials[i]=-h2/(h1*(h1+h2))*f0+(h2-h1)/(h1*h2)*f1+h1/(h2*(h1+h2))*f2;
+			}
+		else if(n==2)
+			{
+			/* Use the only available difference: */
+			partials[i]=(Scalar(extractor.getValue(vertex+(1-2*vi)*vertexStrides[i]))-Scalar(extractor.getValue(vertex)))/(coords[1-vi]-coords[vi]);
+			}
+		else if(vi==0)
+			{
+			ptrdiff_t left=vertex+vertexStrides[i];
+			ptrdiff_t right=left+vertexStrides[i];
+			Scalar h1=coords[1]-coords[0];
+			Scalar h2=coords[2]-coords[1];
+			Scalar f0=Scalar(extractor.getValue(vertex));
+			Scalar f1=Scalar(extractor.getValue(left));
+			Scalar f2=Scalar(extractor.getValue(right));
+			partials[i]=-(Scalar(2)*h1+h2)/(h1*(h1+h2))*f0+(h1+h2)/(h1*h2)*f1-h1/(h2*(h1+h2))*f2;
+			}
+		else if(vi==n-1)
+			{
+			ptrdiff_t right=vertex-vertexStrides[i];
+			ptrdiff_t left=right-vertexStrides[i];
+			Scalar h1=coords[vi-1]-coords[vi-2];
+			Scalar h2=coords[vi]-coords[vi-1];
+			Scalar f0=Scalar(extractor.getValue(left));
+			Scalar f1=Scalar(extractor.getValue(right));
+			Scalar f2=Scalar(extractor.getValue(vertex));
+			partials[i]=h2/(h1*(h1+h2))*f0-(h1+h2)/(h1*h2)*f1+(Scalar(2)*h2+h1)/(h2*(h1+h2))*f2;
+			}
+		else
+			{
+			ptrdiff_t left=vertex-vertexStrides[i];
+			ptrdiff_t right=vertex+vertexStrides[i];
+			Scalar h1=coords[vi]-coords[vi-1];
+			Scalar h2=coords[vi+1]-coords[vi];
+			Scalar f0=Scalar(extractor.getValue(left));
+			Scalar f1=Scalar(extractor.getValue(vertex));
+			Scalar f2=Scalar(extractor.getValue(right));
+			partials[i]=-h2/(h1*(h1+h2))*f0+(h2-h1)/(h1*h2)*f1+h1/(h2*(h1+h2))*f2;
+			}
+		}
+	
+	/* Convert the partial derivatives to a gradient in cylinder space: */
+	Scalar radius=vertexCoordinates[0][vertexIndex[0]];
+	Scalar angle=vertexCoordinates[2][vertexIndex[2]];
+	Scalar c=Math::cos(angle);
+	Scalar s=Math::sin(angle);
+	Scalar tangential=radius>Scalar(0)?partials[2]/radius:Scalar(0);
+	Vector gridGradient(partials[0]*c-tangential*s,partials[0]*s+tangential*c,partials[1]);
+	
+	/* Rotate the gradient into domain space: */
+	return gridTransformation.transform(gridGradient);
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+SlicedCylindrical<ScalarParam,ValueScalarParam>::SlicedCylindrical(
+	void)
+	:numVertices(0),
+	 closedAngle(false),
+	 gridTransformation(GridTransformation::identity),
+	 numCells(0),
+	 angleWrapOffset(0),
+	 domainBox(Box::empty),
+	 numSlices(0),
+	 slices(0),
+	 externalSlices(0),
+	 numSliceStorages(0),
+	 sliceStorages(0)
+	{
+	/* Initialize per-axis arrays: */
+	for(int i=0;i<3;++i)
+		{
+		vertexCoordinates[i]=0;
+		vertexStrides[i]=0;
+		uniformAxes[i]=false;
+		axisOrigins[i]=Scalar(0);
+		axisCellSizes[i]=Scalar(0);
+		}
+	
+	/* Initialize vertex offset array: */
+	for(int i=0;i<CellTopology::numVertices;++i)
+		vertexOffsets[i]=0;
+	
+	/* Initialize vertex list bounds: */
+	Index vertexIndex(0);
+	firstVertex=Vertex(this,vertexIndex);
+	lastVertex=Vertex(this,vertexIndex);
+	
+	/* Initialize cell list bounds: */
+	Index cellIndex(0);
+	firstCell=Cell(this,cellIndex);
+	lastCell=Cell(this,cellIndex);
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+SlicedCylindrical<ScalarParam,ValueScalarParam>::SlicedCylindrical(
+	const typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Index& sNumVertices,
+	int sNumSlices,
+	const typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Scalar* const sVertexCoordinates[3],
+	bool sClosedAngle)
+	:numVertices(0),
+	 closedAngle(false),
+	 gridTransformation(GridTransformation::identity),
+	 angleWrapOffset(0),
+	 domainBox(Box::empty),
+	 numSlices(0),
+	 slices(0),
+	 externalSlices(0),
+	 numSliceStorages(0),
+	 sliceStorages(0)
+	{
+	for(int i=0;i<3;++i)
+		vertexCoordinates[i]=0;
+	
+	/* Create the slices: */
+	for(int sliceIndex=0;sliceIndex<sNumSlices;++sliceIndex)
+		addSlice();
+	
+	/* Create the grid: */
+	setGrid(sNumVertices,sVertexCoordinates,sClosedAngle);
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+SlicedCylindrical<ScalarParam,ValueScalarParam>::~SlicedCylindrical(
+	void)
+	{
+	/* Delete vertex coordinate arrays: */
+	for(int i=0;i<3;++i)
+		delete[] vertexCoordinates[i];
+	
+	/* Delete slice arrays: */
+	for(int slice=0;slice<numSlices;++slice)
+		if(!externalSlices[slice])
+			delete[] slices[slice];
+	delete[] slices;
+	delete[] externalSlices;
+	
+	/* Release external slice storage: */
+	for(int i=0;i<numSliceStorages;++i)
+		delete sliceStorages[i];
+	delete[] sliceStorages;
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+void
+SlicedCylindrical<ScalarParam,ValueScalarParam>::setGrid(
+	const typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Index& sNumVertices,
+	const typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Scalar* const sVertexCoordinates[3],
+	bool sClosedAngle)
+	{
+	/* Resize the vertex coordinate arrays: */
+	numVertices=sNumVertices;
+	closedAngle=sClosedAngle;
+	for(int i=0;i<3;++i)
+		{
+		delete[] vertexCoordinates[i];
+		vertexCoordinates[i]=new Scalar[numVertices[i]];
+		}
+	
+	initStructure();
+	
+	/* Resize all value slices: */
+	size_t totalNumVertices=size_t(numVertices.calcIncrement(-1));
+	for(int slice=0;slice<numSlices;++slice)
+		{
+		if(!externalSlices[slice])
+			delete[] slices[slice];
+		slices[slice]=new ValueScalar[totalNumVertices];
+		externalSlices[slice]=false;
+		}
+	
+	/* Copy source vertex coordinates, if present: */
+	if(sVertexCoordinates!=0)
+		{
+		for(int i=0;i<3;++i)
+			for(int j=0;j<numVertices[i];++j)
+				vertexCoordinates[i][j]=sVertexCoordinates[i][j];
+		
+		/* Finalize grid structure: */
+		finalizeGrid();
+		}
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+int
+SlicedCylindrical<ScalarParam,ValueScalarParam>::addSlice(
+	const typename SlicedCylindrical<ScalarParam,ValueScalarParam>::ValueScalar* sSliceValues)
+	{
+	/* Initialize the new slice: */
+	size_t totalNumVertices=size_t(numVertices.calcIncrement(-1));
+	ValueScalar* newSlice=new ValueScalar[totalNumVertices];
+	
+	if(sSliceValues!=0)
+		{
+		/* Copy the given slice values: */
+		ValueScalar* slicePtr=newSlice;
+		for(size_t i=0;i<totalNumVertices;++i,++slicePtr,++sSliceValues)
+			*slicePtr=*sSliceValues;
+		}
+	
+	/* Install the new slice: */
+	installSlice(newSlice,false);
+	
+	return numSlices-1;
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+int
+SlicedCylindrical<ScalarParam,ValueScalarParam>::addExternalSlice(
+	typename SlicedCylindrical<ScalarParam,ValueScalarParam>::ValueScalar* sSliceArray)
+	{
+	/* Install the given array as new slice without copying: */
+	installSlice(sSliceArray,true);
+	
+	return numSlices-1;
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+void
+SlicedCylindrical<ScalarParam,ValueScalarParam>::adoptSliceStorage(
+	ExternalSliceStorage* sSliceStorage)
+	{
+	/* Append the storage object to the list of owned storage objects: */
+	ExternalSliceStorage** newSliceStorages=new ExternalSliceStorage*[numSliceStorages+1];
+	for(int i=0;i<numSliceStorages;++i)
+		newSliceStorages[i]=sliceStorages[i];
+	newSliceStorages[numSliceStorages]=sSliceStorage;
+	delete[] sliceStorages;
+	++numSliceStorages;
+	sliceStorages=newSliceStorages;
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+void
+SlicedCylindrical<ScalarParam,ValueScalarParam>::setGridTransformation(
+	const typename SlicedCylindrical<ScalarParam,ValueScalarParam>::GridTransformation& newGridTransformation)
+	{
+	gridTransformation=newGridTransformation;
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+void
+SlicedCylindrical<ScalarParam,ValueScalarParam>::finalizeGrid(
+	void)
+	{
+	/* Analyze the vertex coordinates along each axis: */
+	for(int i=0;i<3;++i)
+		{
+		const Scalar* coords=vertexCoordinates[i];
+		int lastVertexIndex=numVertices[i]-1;
+		axisOrigins[i]=coords[0];
+		axisCellSizes[i]=lastVertexIndex>0?(coords[lastVertexIndex]-coords[0])/Scalar(lastVertexIndex):Scalar(0);
+		
+		/* Check if the axis is evenly spaced, to allow direct cell lookup during point location: */
+		Scalar maxDeviation=Scalar(0);
+		for(int j=1;j<numVertices[i];++j)
+			{
+			Scalar deviation=Math::abs(coords[j]-(axisOrigins[i]+Scalar(j)*axisCellSizes[i]));
+			if(maxDeviation<deviation)
+				maxDeviation=deviation;
+			}
+		uniformAxes[i]=lastVertexIndex>0&&maxDeviation<=axisCellSizes[i]*Scalar(1.0e-4);
+		}
+	
+	/* Calculate the angular range covered by the grid: */
+	Scalar twoPi=Scalar(2)*Math::Constants<Scalar>::pi;
+	Scalar angle0=vertexCoordinates[2][0];
+	Scalar angle1=closedAngle?angle0+twoPi:vertexCoordinates[2][numVertices[2]-1];
+	
+	/* Calculate the bounding box of the annular sector, whose extremes are at the angular range's ends or at the coordinate axes: */
+	domainBox=Box::empty;
+	Scalar radii[2]={vertexCoordinates[0][0],vertexCoordinates[0][numVertices[0]-1]};
+	Scalar heights[2]={vertexCoordinates[1][0],vertexCoordinates[1][numVertices[1]-1]};
+	for(int hi=0;hi<2;++hi)
+		{
+		for(int ri=0;ri<2;++ri)
+			{
+			domainBox.addPoint(calcPosition(radii[ri],heights[hi],angle0));
+			domainBox.addPoint(calcPosition(radii[ri],heights[hi],angle1));
+			}
+		for(int quadrant=int(Math::ceil(angle0/(Scalar(0.5)*Math::Constants<Scalar>::pi)));Scalar(quadrant)*Scalar(0.5)*Math::Constants<Scalar>::pi<=angle1;++quadrant)
+			domainBox.addPoint(calcPosition(radii[1],heights[hi],Scalar(quadrant)*Scalar(0.5)*Math::Constants<Scalar>::pi));
+		}
+	}
+
+template <class ScalarParam,class ValueScalarParam>
+inline
+typename SlicedCylindrical<ScalarParam,ValueScalarParam>::Scalar
+SlicedCylindrical<ScalarParam,ValueScalarParam>::calcAverageCellSize(
+	void) const
+	{
+	/* Calculate the average arc length of a cell at the middle radius: */
+	Scalar twoPi=Scalar(2)*Math::Constants<Scalar>::pi;
+	Scalar angleRange=closedAngle?twoPi:vertexCoordinates[2][numVertices[2]-1]-vertexCoordinates[2][0];
+	Scalar middleRadius=(vertexCoordinates[0][0]+vertexCoordinates[0][numVertices[0]-1])*Scalar(0.5);
+	Scalar arcLength=middleRadius*angleRange/Scalar(numCells[2]);
+	
+	/* Compute and return the geometric mean of the average cell sizes along each axis: */
+	return Math::pow(axisCellSizes[0]*axisCellSizes[1]*arcLength,Scalar(1)/Scalar(3));
+	}
+
+}
+
+}
@@ -0,0 +1,447 @@
+/***********************************************************************
+SlicedCylindrical - Base class for vertex-centered cylindrical data sets
+containing arbitrary numbers of independent scalar fields, combined into
+vector and/or tensor fields using special value extractors. Vertex
+positions are defined by one coordinate array each for the radius, the
+height along the cylinder axis, and the angle around the cylinder axis,
+and the grid can be placed in the domain by an orthonormal
+transformation.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_SLICEDCYLINDRICAL_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_SLICEDCYLINDRICAL_INCLUDED
+
+#include <Misc/ArrayIndex.h>
+#include <Math/Constants.h>
+#include <Geometry/ComponentArray.h>
+#include <Geometry/Point.h>
+#include <Geometry/Vector.h>
+#include <Geometry/Box.h>
+#include <Geometry/OrthonormalTransformation.h>
+
+#include <Templatized/SlicedDataValue.h>
+#include <Templatized/EncodedSlice.h>
+#include <Templatized/ExternalSliceStorage.h>
+#include <Templatized/Tesseract.h>
+#include <Templatized/LinearIndexID.h>
+#include <Templatized/IteratorWrapper.h>
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class ScalarParam,class ValueScalarParam>
+class SlicedCylindrical
+	{
+	/* Embedded classes: */
+	public:
+	
+	/* Definition of the data set's domain space: */
+	typedef ScalarParam Scalar; // Scalar type of data set's domain
+	static const int dimension=3; // Dimension of data set's domain
+	typedef Geometry::Point<Scalar,3> Point; // Type for points in data set's domain
+	typedef Geometry::Vector<Scalar,3> Vector; // Type for vectors in data set's domain
+	typedef Geometry::Box<Scalar,3> Box; // Type for axis-aligned boxes in data set's domain
+	typedef Geometry::OrthonormalTransformation<Scalar,3> GridTransformation; // Type for transformations from cylinder space (cylinder axis along z, zero angle along x) to the data set's domain
+	
+	/* Definition of the data set's cell topology: */
+	typedef Tesseract<3> CellTopology; // Policy class to select appropriate cell algorithms
+	
+	/* Definition of the data set's value space: */
+	typedef ValueScalarParam ValueScalar; // Data set's value type for scalar values
+	typedef SlicedDataValue<ValueScalar> Value; // Data set's compound value type
+	typedef EncodedSlice<ValueScalar> ValueSlice; // Type of descriptors for value slices; this data set only stores native slices
+	
+	/* Low-level definitions of data set storage: */
+	typedef Misc::ArrayIndex<3> Index; // Index type for data set storage (value slices); indices are (radius, height, angle), with angle varying fastest
+	
+	/* Data set interface classes: */
+	typedef LinearIndexID VertexID;
+	
+	class Vertex // Class to represent and iterate through vertices
+		{
+		friend class SlicedCylindrical;
+		
+		/* Elements: */
+		private:
+		const SlicedCylindrical* ds; // Pointer to data set containing the vertex
+		Index index; // Array index of vertex in data set storage
+		
+		/* Constructors and destructors: */
+		public:
+		Vertex(void) // Creates an invalid vertex
+			:ds(0)
+			{
+			}
+		private:
+		Vertex(const SlicedCylindrical* sDs,const Index& sIndex)
+			:ds(sDs),index(sIndex)
+			{
+			}
+		
+		/* Methods: */
+		public:
+		Point getPosition(void) const // Returns vertex' position in domain
+			{
+			return ds->getVertexPosition(index);
+			}
+		template <class ValueExtractorParam>
+		typename ValueExtractorParam::DestValue getValue(const ValueExtractorParam& extractor) const // Returns vertex' value based on given extractor
+			{
+			return extractor.getValue(ds->numVertices.calcOffset(index));
+			}
+		template <class ScalarExtractorParam>
+		Vector calcGradient(const ScalarExtractorParam& extractor) const // Returns gradient at the vertex, based on given scalar extractor
+			{
+			return ds->calcVertexGradient(index,extractor);
+			}
+		VertexID getID(void) const // Returns vertex' ID
+			{
+			return VertexID(VertexID::Index(ds->numVertices.calcOffset(index)));
+			}
+		
+		/* Iterator methods: */
+		friend bool operator==(const Vertex& v1,const Vertex& v2)
+			{
+			return v1.index==v2.index&&v1.ds==v2.ds;
+			}
+		friend bool operator!=(const Vertex& v1,const Vertex& v2)
+			{
+			return v1.index!=v2.index||v1.ds!=v2.ds;
+			}
+		Vertex& operator++(void) // Pre-increment operator
+			{
+			index.preInc(ds->numVertices);
+			return *this;
+			}
+		};
+	
+	typedef IteratorWrapper<Vertex> VertexIterator; // Class to iterate through vertices
+	
+	typedef LinearIndexID EdgeID; // Class to identify cell edges
+	
+	typedef LinearIndexID CellID; // Class to identify cells
+	
+	class Locator;
+	
+	class Cell // Class to represent and iterate through cells
+		{
+		friend class SlicedCylindrical;
+		friend class Locator;
+		
+		/* Elements: */
+		private:
+		const SlicedCylindrical* ds; // Pointer to the data set containing the cell
+		Index index; // Array index of cell's base vertex in data set storage
+		ptrdiff_t baseVertexIndex; // Linear index of cell's base vertex in data set storage
+		
+		/* Constructors and destructors: */
+		public:
+		Cell(void) // Creates an invalid cell
+			:ds(0),baseVertexIndex(-1)
+			{
+			}
+		private:
+		Cell(const SlicedCylindrical* sDs) // Creates an invalid cell in the given data set
+			:ds(sDs),baseVertexIndex(-1)
+			{
+			}
+		Cell(const SlicedCylindrical* sDs,const Index& sIndex) // Elementwise constructor
+			:ds(sDs),index(sIndex),baseVertexIndex(ds->numVertices.calcOffset(index))
+			{
+			}
+		
+		/* Private methods: */
+		ptrdiff_t getVertexOffset(int vertexIndex) const // Returns pointer offset from the cell's base vertex to the given cell vertex; wraps around in a closed angular direction
+			{
+			ptrdiff_t result=ds->vertexOffsets[vertexIndex];
+			if((vertexIndex&0x4)&&index[2]==ds->numVertices[2]-1)
+				result+=ds->angleWrapOffset;
+			return result;
+			}
+		Index getVertexIndex(int vertexIndex) const; // Returns array index of the given cell vertex
+		
+		/* Methods: */
+		public:
+		bool isValid(void) const // Returns true if the cell is valid
+			{
+			return baseVertexIndex>=0;
+			}
+		VertexID getVertexID(int vertexIndex) const // Returns ID of given vertex of the cell
+			{
+			return VertexID(VertexID::Index(baseVertexIndex+getVertexOffset(vertexIndex)));
+			}
+		Vertex getVertex(int vertexIndex) const // Returns the given vertex of the cell
+			{
+			return Vertex(ds,getVertexIndex(vertexIndex));
+			}
+		Point getVertexPosition(int vertexIndex) const // Returns position of given vertex of the cell
+			{
+			return ds->getVertexPosition(getVertexIndex(vertexIndex));
+			}
+		template <class ValueExtractorParam>
+		typename ValueExtractorParam::DestValue getVertexValue(int vertexIndex,const ValueExtractorParam& extractor) const // Returns value of given vertex of the cell, based on given extractor
+			{
+			return extractor.getValue(baseVertexIndex+getVertexOffset(vertexIndex));
+			}
+		template <class ScalarExtractorParam>
+		Vector calcVertexGradient(int vertexIndex,const ScalarExtractorParam& extractor) const // Returns gradient at given vertex of the cell, based on given scalar extractor
+			{
+			return ds->calcVertexGradient(getVertexIndex(vertexIndex),extractor);
+			}
+		EdgeID getEdgeID(int edgeIndex) const; // Returns ID of given edge of the cell
+		Point calcEdgePosition(int edgeIndex,Scalar weight) const; // Returns an interpolated point along the given edge
+		CellID getID(void) const // Returns cell's ID
+			{
+			return CellID(CellID::Index(baseVertexIndex));
+			}
+		CellID getNeighbourID(int neighbourIndex) const; // Returns ID of neighbour across the given face of the cell
+		
+		/* Iterator methods: */
+		friend bool operator==(const Cell& cell1,const Cell& cell2)
+			{
+			return cell1.baseVertexIndex==cell2.baseVertexIndex&&cell1.ds==cell2.ds;
+			}
+		friend bool operator!=(const Cell& cell1,const Cell& cell2)
+			{
+			return cell1.baseVertexIndex!=cell2.baseVertexIndex||cell1.ds!=cell2.ds;
+			}
+		Cell& operator++(void) // Pre-increment operator
+			{
+			index.preInc(ds->numCells);
+			baseVertexIndex=ds->numVertices.calcOffset(index);
+			return *this;
+			}
+		};
+	
+	typedef IteratorWrapper<Cell> CellIterator; // Class to iterate through cells
+	
+	class Locator:private Cell // Class responsible for evaluating a data set at a given position
+		{
+		friend class SlicedCylindrical;
+		
+		/* Embedded classes: */
+		private:
+		typedef Geometry::ComponentArray<Scalar,3> CellPosition; // Type for local cell coordinates
+		
+		/* Elements: */
+		using Cell::ds;
+		using Cell::index;
+		using Cell::baseVertexIndex;
+		CellPosition cellPos; // Local coordinates of last located point inside its cell
+		
+		/* Constructors and destructors: */
+		public:
+		Locator(void); // Creates invalid locator
+		private:
+		Locator(const SlicedCylindrical* sDs); // Creates non-localized locator associated with given data set
+		
+		/* Methods: */
+		public:
+		void setEpsilon(Scalar newEpsilon) // Sets a new accuracy threshold in local cell dimension
+			{
+			/* Not needed for cylindrical data sets */
+			}
+		CellID getCellID(void) const // Returns the ID of the cell containing the last located point
+			{
+			return Cell::getID();
+			}
+		bool locatePoint(const Point& position,bool traceHint =false); // Sets locator to given position; returns true if position is inside found cell
+		template <class ValueExtractorParam>
+		typename ValueExtractorParam::DestValue calcValue(const ValueExtractorParam& extractor) const; // Calculates value at last located position
+		template <class ScalarExtractorParam>
+		Vector calcGradient(const ScalarExtractorParam& extractor) const; // Calculates gradient at last located position
+		};
+	
+	friend class Vertex;
+	friend class Cell;
+	friend class Locator;
+	
+	/* Elements: */
+	private:
+	Index numVertices; // Number of vertices in data set in each dimension
+	Scalar* vertexCoordinates[3]; // Arrays of strictly increasing vertex radii, heights, and angles in radians
+	bool closedAngle; // Flag whether the angular axis wraps around the full circle, adding cells between the last and first angles
+	GridTransformation gridTransformation; // Transformation from cylinder space to the data set's domain
+	int vertexStrides[3]; // Array of pointer stride values in the vertex array
+	Index numCells; // Number of cells in data set in each dimension
+	int vertexOffsets[CellTopology::numVertices]; // Array of pointer offsets from a cell's base vertex to all cell vertices
+	int angleWrapOffset; // Pointer offset correction for cell vertices beyond the last angle in a closed grid
+	bool uniformAxes[3]; // Flags whether the vertex coordinates along each axis are evenly spaced
+	Scalar axisOrigins[3]; // First vertex coordinate along each axis
+	Scalar axisCellSizes[3]; // Average cell size along each axis; exact cell size along uniform axes
+	VertexIterator firstVertex,lastVertex; // Bounds of vertex list
+	CellIterator firstCell,lastCell; // Bounds of cell list
+	Box domainBox; // Bounding box of all vertices
+	int numSlices; // Number of scalar value slices in the data set
+	ValueScalar** slices; // Array of vertex value slices
+	bool* externalSlices; // Array of flags whether each value slice is backed by external storage instead of owned by the data set
+	int numSliceStorages; // Number of external slice storage objects owned by the data set
+	ExternalSliceStorage** sliceStorages; // Array of external slice storage objects owned by the data set
+	
+	/* Private methods: */
+	void initStructure(void);
+	void installSlice(ValueScalar* newSlice,bool external); // Appends the given array to the list of value slices
+	Scalar getAxisCoordinate(int axis,int vertexIndex) const // Returns vertex coordinate along the given axis; continues the angle beyond the last vertex in a closed grid
+		{
+		if(vertexIndex==numVertices[axis])
+			return vertexCoordinates[axis][0]+Scalar(2)*Math::Constants<Scalar>::pi;
+		return vertexCoordinates[axis][vertexIndex];
+		}
+	Point calcPosition(Scalar radius,Scalar height,Scalar angle) const; // Returns the domain position of the given cylinder coordinates
+	int findCell(int axis,Scalar coordinate,int startIndex) const; // Returns index of cell along given axis containing given coordinate; starts searching at given cell index
+	template <class ScalarExtractorParam>
+	Vector calcVertexGradient(const Index& vertexIndex,const ScalarExtractorParam& extractor) const; // Returns gradient at a vertex based on the given scalar extractor
+	
+	/* Constructors and destructors: */
+	public:
+	SlicedCylindrical(void); // Creates an "empty" data set
+	SlicedCylindrical(const Index& sNumVertices,int sNumSlices,const Scalar* const sVertexCoordinates[3] =0,bool sClosedAngle =false); // Creates a data set with the given number of vertices and slices; copies vertex coordinates if pointer is not null
+	~SlicedCylindrical(void);
+	
+	/* Data set construction methods: */
+	void setGrid(const Index& sNumVertices,const Scalar* const sVertexCoordinates[3] =0,bool sClosedAngle =false); // Sets the number of vertices of the data set and whether the angular axis wraps around; copies per-axis vertex coordinates if pointer is not null
+	int addSlice(const ValueScalar* sSliceValues =0); // Adds another slice to the data set; copies slice values from given array if pointer is not null; returns index of new slice
+	int addExternalSlice(ValueScalar* sSliceArray); // Adds another slice to the data set that uses the given array directly; array must remain valid until the data set is destroyed, or can be null to be set later; returns index of new slice
+	void setExternalSliceArray(int sliceIndex,ValueScalar* sSliceArray) // Sets the array used by a slice added with addExternalSlice; array must remain valid until the data set is destroyed
+		{
+		slices[sliceIndex]=sSliceArray;
+		}
+	void adoptSliceStorage(ExternalSliceStorage* sSliceStorage); // Transfers ownership of an object backing external slices to the data set; object is deleted when the data set is destroyed
+	void swapSliceArray(int sliceIndex,ValueScalar*& sliceArray) // Exchanges the array of a native slice owned by the data set with the given array of the same size; the data set takes ownership of the given array, and the caller of the slice's old array
+		{
+		ValueScalar* oldSliceArray=slices[sliceIndex];
+		slices[sliceIndex]=sliceArray;
+		sliceArray=oldSliceArray;
+		}
+	
+	/* Low-level data access methods: */
+	const Index& getNumVertices(void) const // Returns number of vertices in the data set
+		{
+		return numVertices;
+		}
+	int getVertexStride(int direction) const // Returns the data set's vertex stride in one direction
+		{
+		return vertexStrides[direction];
+		}
+	const Scalar* getVertexCoordinates(int axis) const // Returns the array of vertex coordinates along the given grid axis
+		{
+		return vertexCoordinates[axis];
+		}
+	Scalar* getVertexCoordinates(int axis) // Ditto
+		{
+		return vertexCoordinates[axis];
+		}
+	bool isAngleClosed(void) const // Returns true if the angular axis wraps around the full circle
+		{
+		return closedAngle;
+		}
+	const GridTransformation& getGridTransformation(void) const // Returns the transformation from cylinder space to the data set's domain
+		{
+		return gridTransformation;
+		}
+	void setGridTransformation(const GridTransformation& newGridTransformation); // Sets the transformation from cylinder space to the data set's domain; requires call to finalizeGrid
+	Point getVertexPosition(const Index& vertexIndex) const // Returns a vertex' position
+		{
+		return calcPosition(vertexCoordinates[0][vertexIndex[0]],vertexCoordinates[1][vertexIndex[1]],vertexCoordinates[2][vertexIndex[2]]);
+		}
+	int getNumSlices(void) const // Returns the number of value slices in the data set
+		{
+		return numSlices;
+		}
+	const ValueScalar* getSliceArray(int sliceIndex) const // Returns one of the data set's value slices as a C array
+		{
+		return slices[sliceIndex];
+		}
+	ValueScalar* getSliceArray(int sliceIndex) // Ditto
+		{
+		return slices[sliceIndex];
+		}
+	ValueSlice getValueSlice(int sliceIndex) const // Returns a descriptor of one of the data set's value slices
+		{
+		return ValueSlice(slices[sliceIndex]);
+		}
+	ValueScalar getVertexValue(int sliceIndex,const Index& vertexIndex) const // Returns a vertex' data value from one slice
+		{
+		return slices[sliceIndex][numVertices.calcOffset(vertexIndex)];
+		}
+	ValueScalar& getVertexValue(int sliceIndex,const Index& vertexIndex) // Ditto
+		{
+		return slices[sliceIndex][numVertices.calcOffset(vertexIndex)];
+		}
+	const Index& getNumCells(void) const // Returns number of cells in grid
+		{
+		return numCells;
+		}
+	void finalizeGrid(void); // Recalculates derived grid information after grid structure change
+	
+	/* Methods implementing the data set interface: */
+	size_t getTotalNumVertices(void) const // Returns total number of vertices in the data set
+		{
+		return numVertices.calcIncrement(-1);
+		}
+	Vertex getVertex(const VertexID& vertexID) const // Returns vertex of given valid ID
+		{
+		return Vertex(this,numVertices.calcIndex(vertexID.getIndex()));
+		}
+	const VertexIterator& beginVertices(void) const // Returns iterator to first vertex in the data set
+		{
+		return firstVertex;
+		}
+	const VertexIterator& endVertices(void) const // Returns iterator behind last vertex in the data set
+		{
+		return lastVertex;
+		}
+	size_t getTotalNumCells(void) const // Returns total number of cells in the data set
+		{
+		return numCells.calcIncrement(-1);
+		}
+	Cell getCell(const CellID& cellID) const // Return cell of given valid ID
+		{
+		return Cell(this,numVertices.calcIndex(cellID.getIndex()));
+		}
+	const CellIterator& beginCells(void) const // Returns iterator to first cell in the data set
+		{
+		return firstCell;
+		}
+	const CellIterator& endCells(void) const // Returns iterator behind last cell in the data set
+		{
+		return lastCell;
+		}
+	const Box& getDomainBox(void) const // Returns bounding box of the data set's domain
+		{
+		return domainBox;
+		}
+	Scalar calcAverageCellSize(void) const; // Calculates an estimate of the average cell size in the data set
+	Locator getLocator(void) const // Returns an unlocalized locator for the data set
+		{
+		return Locator(this);
+		}
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_TEMPLATIZED_SLICEDCYLINDRICAL_IMPLEMENTATION
+#include <Templatized/SlicedCylindrical.cpp>
+#endif
+
+#endif
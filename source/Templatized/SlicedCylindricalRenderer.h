@@ -0,0 +1,50 @@
+/***********************************************************************
+SlicedCylindricalRenderer - Class to render sliced cylindrical data
+sets. Implemented as a specialization of the generic DataSetRenderer
+class.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_SLICEDCYLINDRICALRENDERER_INCLUDED
+#define VISUALIZATION_SLICEDCYLINDRICALRENDERER_INCLUDED
+
+#include <Templatized/DataSetRenderer.h>
+#include <Templatized/SlicedCylindrical.h>
+#include <Templatized/CurvilinearGridRenderer.h>
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class ScalarParam,class ValueScalarParam>
+class DataSetRenderer<SlicedCylindrical<ScalarParam,ValueScalarParam> >:public CurvilinearGridRenderer<SlicedCylindrical<ScalarParam,ValueScalarParam> >
+	{
+	/* Constructors and destructors: */
+	public:
+	DataSetRenderer(const SlicedCylindrical<ScalarParam,ValueScalarParam>* sDataSet) // Creates a renderer for the given data set
+		:CurvilinearGridRenderer<SlicedCylindrical<ScalarParam,ValueScalarParam> >(sDataSet)
+		{
+		}
+	};
+
+}
+
+}
+
+#endif
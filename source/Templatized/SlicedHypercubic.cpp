@@ -149,7 +149,7 @@ SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam>::Locator::newtonRa
 	typedef Geometry::Matrix<Scalar,dimension,dimension> Matrix;
 	
 	/* Transform the current cell position to domain space: */
-
+	
 	/* Perform multilinear interpolation: */
 	Point p[CellTopology::numVertices>>1]; // Array of intermediate interpolation points
 	int interpolationDimension=dimension-1;
@@ -471,6 +471,10 @@ SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam>::resizeSlices(
 	size_t numVertices=gridVertices.size();
 	for(int sliceIndex=0;sliceIndex<numSlices;++sliceIndex)
 		{
+		/* Skip encoded slices: */
+		if(encodedSlices[sliceIndex].getValues()!=0)
+			continue;
+		
 		/* Create a new slice: */
 		ValueScalar* newSlice=new ValueScalar[newAllocatedSize];
 		
@@ -491,7 +495,7 @@ template <class ScalarParam,int dimensionParam,class ValueScalarParam>
 inline
 SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam>::SlicedHypercubic(
 	void)
-	:numSlices(0),allocatedSliceSize(0),slices(0),
+	:numSlices(0),allocatedSliceSize(0),slices(0),encodedSlices(0),
 	 domainBox(Box::empty),
 	 locatorEpsilon(Scalar(1.0e-4)),
 	 gridFaces(0)
@@ -505,8 +509,12 @@ SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam>::~SlicedHypercubic
 	{
 	delete gridFaces;
 	for(int i=0;i<numSlices;++i)
+		{
 		delete[] slices[i];
+		encodedSlices[i].deleteValues();
+		}
 	delete[] slices;
+	delete[] encodedSlices;
 	}
 
 template <class ScalarParam,int dimensionParam,class ValueScalarParam>
@@ -602,8 +610,12 @@ SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam>::addSlice(
 	{
 	/* Create a new slice array and copy over the old slices and initialize the new slice: */
 	ValueScalar** newSlices=new ValueScalar*[numSlices+1];
+	ValueSlice* newEncodedSlices=new ValueSlice[numSlices+1];
 	for(int sliceIndex=0;sliceIndex<numSlices;++sliceIndex)
+		{
 		newSlices[sliceIndex]=slices[sliceIndex];
+		newEncodedSlices[sliceIndex]=encodedSlices[sliceIndex];
+		}
 	newSlices[numSlices]=allocatedSliceSize>0?new ValueScalar[allocatedSliceSize]:0;
 	
 	if(sSliceValues!=0)
@@ -617,12 +629,43 @@ SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam>::addSlice(
 	
 	/* Install the new slice array: */
 	delete[] slices;
+	delete[] encodedSlices;
 	++numSlices;
 	slices=newSlices;
+	encodedSlices=newEncodedSlices;
 	
 	return numSlices-1;
 	}
 
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+int
+SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam>::addSlice(
+	const typename SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam>::ValueScalar* sSliceValues,
+	typename SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam>::ValueSlice::Format format)
+	{
+	int sliceIndex=addSlice(sSliceValues);
+	encodeSlice(sliceIndex,format);
+	
+	return sliceIndex;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam>::encodeSlice(
+	int sliceIndex,
+	typename SlicedHypercubic<ScalarParam,dimensionParam,ValueScalarParam>::ValueSlice::Format format)
+	{
+	if(format==ValueSlice::NATIVE||encodedSlices[sliceIndex].getValues()!=0)
+		return;
+	
+	/* Replace the native slice with an encoded copy of the values of all current vertices: */
+	encodedSlices[sliceIndex]=ValueSlice::encode(format,gridVertices.size(),slices[sliceIndex]);
+	delete[] slices[sliceIndex];
+	slices[sliceIndex]=0;
+	}
+
 template <class ScalarParam,int dimensionParam,class ValueParam>
 inline
 void
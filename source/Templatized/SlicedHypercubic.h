@@ -36,6 +36,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Geometry/ArrayKdTree.h>
 
 #include <Templatized/SlicedDataValue.h>
+#include <Templatized/EncodedSlice.h>
 #include <Templatized/Tesseract.h>
 #include <Templatized/LinearIndexID.h>
 #include <Templatized/IteratorWrapper.h>
@@ -63,6 +64,7 @@ class SlicedHypercubic
 	/* Definition of the data set's value space: */
 	typedef ValueScalarParam ValueScalar; // Data set's value type
 	typedef SlicedDataValue<ValueScalar> Value; // Data set's compound value type
+	typedef EncodedSlice<ValueScalar> ValueSlice; // Type of descriptors for value slices stored in native or encoded form
 	
 	/* First batch of data set interface classes: */
 	typedef LinearIndexID VertexID; // ID type for vertices
@@ -290,7 +292,8 @@ class SlicedHypercubic
 	GridCellList gridCells; // List of all grid cells
 	int numSlices; // Number of scalar value slices in data set
 	size_t allocatedSliceSize; // Allocated size of all slice arrays
-	ValueScalar** slices; // Array of 1D arrays defining data set's value slices
+	ValueScalar** slices; // Array of 1D arrays defining data set's value slices; null for encoded slices
+	ValueSlice* encodedSlices; // Array of descriptors of encoded value slices; descriptors of native slices have null value arrays
 	CellCenterTree cellCenterTree; // Kd-tree containing cell centers
 	VertexIterator firstVertex,lastVertex; // Bounds of vertex list
 	CellIterator firstCell,lastCell; // Bounds of cell list
@@ -301,7 +304,7 @@ class SlicedHypercubic
 	GridFaceHasher* gridFaces; // Pointer to grid face hasher used during data set construction to connect grid cells
 	
 	/* Private methods: */
-	void resizeSlices(size_t newAllocatedSize); // Resizes all existing value slices
+	void resizeSlices(size_t newAllocatedSize); // Resizes all existing native value slices
 	
 	/* Constructors and destructors: */
 	public:
@@ -314,6 +317,14 @@ class SlicedHypercubic
 	VertexID addVertex(const Point& vertexPosition); // Adds a vertex to the grid; returns vertex' ID
 	CellID addCell(const VertexID cellVertices[CellTopology::numVertices]); // Adds a cell to the grid; returns cell's ID
 	int addSlice(const ValueScalar* sSliceValues =0); // Adds another slice to the data set; copies slice values for all points in all grids from given array if pointer is not null; returns index of new slice
+	int addSlice(const ValueScalar* sSliceValues,typename ValueSlice::Format format); // Adds another slice storing the given values in the given format; must be called after all vertices have been added; returns index of new slice
+	void encodeSlice(int sliceIndex,typename ValueSlice::Format format); // Converts a native slice to the given storage format; must be called after all vertices have been added; the slice's values are read-only afterwards
+	void swapSliceArray(int sliceIndex,ValueScalar*& sliceArray) // Exchanges the array of a native slice owned by the data set with the given array of the same size; the data set takes ownership of the given array, and the caller of the slice's old array
+		{
+		ValueScalar* oldSliceArray=slices[sliceIndex];
+		slices[sliceIndex]=sliceArray;
+		sliceArray=oldSliceArray;
+		}
 	
 	/* Low-level data access methods: */
 	const Point& getVertexPosition(VertexIndex vertexIndex) const // Returns position of a vertex
@@ -328,7 +339,7 @@ class SlicedHypercubic
 		{
 		return numSlices;
 		}
-	const ValueScalar* getSliceArray(int sliceIndex) const // Returns one of the data set's value slices
+	const ValueScalar* getSliceArray(int sliceIndex) const // Returns one of the data set's value slices; returns null for encoded slices
 		{
 		return slices[sliceIndex];
 		}
@@ -336,11 +347,15 @@ class SlicedHypercubic
 		{
 		return slices[sliceIndex];
 		}
+	ValueSlice getValueSlice(int sliceIndex) const // Returns a descriptor of one of the data set's value slices
+		{
+		return encodedSlices[sliceIndex].getValues()!=0?encodedSlices[sliceIndex]:ValueSlice(slices[sliceIndex]);
+		}
 	ValueScalar getVertexValue(int sliceIndex,VertexIndex vertexIndex) const // Returns a vertex' data value from one slice
 		{
-		return slices[sliceIndex][vertexIndex];
+		return ValueScalar(getValueSlice(sliceIndex).getValue(vertexIndex));
 		}
-	void setVertexValue(int sliceIndex,VertexIndex vertexIndex,ValueScalar newValue); // Sets the given vertex' value in the given slice
+	void setVertexValue(int sliceIndex,VertexIndex vertexIndex,ValueScalar newValue); // Sets the given vertex' value in the given slice; slice must be native
 	void finalizeGrid(void); // Recalculates derived grid information after grid structure change
 	Scalar getLocatorEpsilon(void) const // Returns the current default accuracy threshold for locators working on this data set
 		{
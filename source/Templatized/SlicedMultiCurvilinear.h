@@ -34,6 +34,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Geometry/ArrayKdTree.h>
 
 #include <Templatized/SlicedDataValue.h>
+#include <Templatized/EncodedSlice.h>
+#include <Templatized/CellBucketGrid.h>
 #include <Templatized/Tesseract.h>
 #include <Templatized/LinearIndexID.h>
 #include <Templatized/IteratorWrapper.h>
@@ -61,6 +63,7 @@ class SlicedMultiCurvilinear
 	/* Definition of the data set's value space: */
 	typedef ValueScalarParam ValueScalar; // Data set's value type for scalar values
 	typedef SlicedDataValue<ValueScalar> Value; // Data set's compound value type
+	typedef EncodedSlice<ValueScalar> ValueSlice; // Type of descriptors for value slices; this data set only stores native slices
 	
 	/* Low-level definitions of data set storage: */
 	typedef Misc::ArrayIndex<dimensionParam> Index; // Index type for data set storage (grids and value slices)
@@ -336,6 +339,7 @@ class SlicedMultiCurvilinear
 	private:
 	typedef Geometry::ValuedPoint<Point,CellID> CellCenter; // Data type to associate a cell's center point and its ID
 	typedef Geometry::ArrayKdTree<CellCenter> CellCenterTree; // Data type for kd-trees to locate closest cell centers
+	typedef CellBucketGrid<CellCenter> CellBuckets; // Data type for uniform grids of buckets to locate cells overlapping a point
 	
 	friend class Vertex;
 	friend class Cell;
@@ -356,9 +360,12 @@ class SlicedMultiCurvilinear
 	Box domainBox; // Bounding box of all vertices
 	Scalar avgCellRadius; // Average "radius" of all cells
 	Scalar maxCellRadius2; // Squared maximum "radius" of any cell in any grid (used as trivial reject threshold during point location)
+	bool useCellBuckets; // Flag whether point location starts from the cell bucket grid instead of the cell center kd-tree
+	CellBuckets cellBuckets; // Uniform grid of buckets listing the cells overlapping each bucket
 	Scalar locatorEpsilon; // Default accuracy threshold for locators working on this data set
 	
 	/* Private methods: */
+	const CellCenter* findClosestCellCenter(const Point& position) const; // Returns the center of the cell to start locating the given position from, or null if the position is outside the data set
 	template <class ScalarExtractorParam>
 	Vector calcVertexGradient(int gridIndex,const Index& vertexIndex,const ScalarExtractorParam& extractor) const; // Returns gradient at a vertex based on the given scalar extractor
 	void storeGridConnector(const Cell& cell,int faceIndex,const CellID& otherCell); // Stores a connection between a cell face and another cell during grid finalization
@@ -376,6 +383,12 @@ class SlicedMultiCurvilinear
 	void setGrid(int gridIndex,const Index& sNumVertices,const Point* sVertexPositions =0); // Creates a grid with the given number of vertices; copies vertex positions if pointer is not null
 	int addGrid(const Index& sNumVertices,const Point* sVertexPositions =0); // Adds another grid with the given number of vertices; copies vertex positions if pointer is not null; returns index of new grid
 	int addSlice(const ValueScalar* sSliceValues =0); // Adds another slice to the data set; copies slice values for all points in all grids from given array if pointer is not null; returns index of new slice
+	void swapSliceArray(int sliceIndex,ValueScalar*& sliceArray) // Exchanges the array of a native slice owned by the data set with the given array of the same size; the data set takes ownership of the given array, and the caller of the slice's old array
+		{
+		ValueScalar* oldSliceArray=slices[sliceIndex];
+		slices[sliceIndex]=sliceArray;
+		sliceArray=oldSliceArray;
+		}
 	
 	/* Low-level data access methods: */
 	const int getNumGrids(void) const // Returns number of grids in the data set
@@ -410,6 +423,10 @@ class SlicedMultiCurvilinear
 		{
 		return slices[sliceIndex];
 		}
+	ValueSlice getValueSlice(int sliceIndex) const // Returns a descriptor of one of the data set's value slices
+		{
+		return ValueSlice(slices[sliceIndex]);
+		}
 	ValueScalar getVertexValue(int sliceIndex,int gridIndex,const Index& vertexIndex) const // Returns a vertex' data value from one slice
 		{
 		return slices[sliceIndex][grids[gridIndex].getVertexLinearIndex(vertexIndex)];
@@ -419,6 +436,11 @@ class SlicedMultiCurvilinear
 		return slices[sliceIndex][grids[gridIndex].getVertexLinearIndex(vertexIndex)];
 		}
 	void finalizeGrid(void); // Recalculates derived grid information after grid structure change
+	bool getUseCellBuckets(void) const // Returns true if point location uses the cell bucket grid
+		{
+		return useCellBuckets;
+		}
+	void setUseCellBuckets(bool newUseCellBuckets); // Selects the cell bucket grid or the cell center kd-tree to start point location; a bucket grid is built by the next call to finalizeGrid()
 	Scalar getLocatorEpsilon(void) const // Returns the current default accuracy threshold for locators working on this data set
 		{
 		return locatorEpsilon;
@@ -0,0 +1,775 @@
+/***********************************************************************
+SlicedRectilinear - Base class for vertex-centered rectilinear data sets
+containing arbitrary numbers of independent scalar fields, combined into
+vector and/or tensor fields using special value extractors. Vertex
+positions are defined by one coordinate array per axis, and the grid can
+be placed in the domain by an orthonormal transformation.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#define VISUALIZATION_TEMPLATIZED_SLICEDRECTILINEAR_IMPLEMENTATION
+
+#include <Templatized/SlicedRectilinear.h>
+
+#include <Math/Math.h>
+
+#include <Templatized/LinearInterpolator.h>
+
+namespace Visualization {
+
+namespace Templatized {
+
+/****************************************
+Methods of class SlicedRectilinear::Cell:
+****************************************/
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Vertex
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Cell::getVertex(
+	int vertexIndex) const
+	{
+	/* Calculate the index of the cell vertex: */
+	Index cellVertexIndex=index;
+	for(int i=0;i<dimension;++i)
+		if(vertexIndex&(1<<i))
+			++cellVertexIndex[i];
+	
+	return Vertex(ds,cellVertexIndex);
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Point
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Cell::getVertexPosition(
+	int vertexIndex) const
+	{
+	/* Calculate the index of the cell vertex: */
+	Index cellVertexIndex=index;
+	for(int i=0;i<dimension;++i)
+		if(vertexIndex&(1<<i))
+			++cellVertexIndex[i];
+	
+	return ds->getVertexPosition(cellVertexIndex);
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+template <class ScalarExtractorParam>
+inline
+typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Vector
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Cell::calcVertexGradient(
+	int vertexIndex,
+	const ScalarExtractorParam& extractor) const
+	{
+	/* Calculate the index of the cell vertex: */
+	Index cellVertexIndex=index;
+	for(int i=0;i<dimension;++i)
+		if(vertexIndex&(1<<i))
+			++cellVertexIndex[i];
+	
+	/* Return the vertex gradient: */
+	return ds->calcVertexGradient(cellVertexIndex,extractor);
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::EdgeID
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Cell::getEdgeID(
+	int edgeIndex) const
+	{
+	EdgeID::Index index(baseVertexIndex);
+	index+=ds->vertexOffsets[CellTopology::edgeVertexIndices[edgeIndex][0]];
+	index*=dimension;
+	index+=edgeIndex>>(dimension-1);
+	return EdgeID(index);
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Point
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Cell::calcEdgePosition(
+	int edgeIndex,
+	SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Scalar weight) const
+	{
+	/* Compute the edge point in grid space: */
+	int edgeBaseIndex=CellTopology::edgeVertexIndices[edgeIndex][0];
+	int edgeDirection=edgeIndex>>(dimension-1);
+	Point result;
+	for(int i=0;i<dimension;++i)
+		{
+		int pos=index[i];
+		if(edgeBaseIndex&(1<<i))
+			++pos;
+		result[i]=ds->vertexCoordinates[i][pos];
+		}
+	const Scalar* edgeCoords=ds->vertexCoordinates[edgeDirection]+index[edgeDirection];
+	result[edgeDirection]+=weight*(edgeCoords[1]-edgeCoords[0]);
+	
+	/* Transform the edge point to domain space: */
+	return ds->gridTransformation.transform(result);
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::CellID
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Cell::getNeighbourID(
+	int neighbourIndex) const
+	{
+	int direction=neighbourIndex>>1;
+	if(neighbourIndex&0x1)
+		{
+		if(index[direction]<ds->numCells[direction]-1)
+			return CellID(CellID::Index(baseVertexIndex+ds->vertexStrides[direction]));
+		else
+			return CellID();
+		}
+	else
+		{
+		if(index[direction]>0)
+			return CellID(CellID::Index(baseVertexIndex-ds->vertexStrides[direction]));
+		else
+			return CellID();
+		}
+	}
+
+/*******************************************
+Methods of class SlicedRectilinear::Locator:
+*******************************************/
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Locator::Locator(
+	void)
+	{
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Locator::Locator(
+	const SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>* sDs)
+	:Cell(sDs)
+	{
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+bool
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Locator::locatePoint(
+	const typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Point& position,
+	bool traceHint)
+	{
+	/* Transform the position to grid space: */
+	Point gridPos=ds->gridTransformation.inverseTransform(position);
+	
+	/* Only use the previous cell as search start if the locator has been localized before: */
+	bool trace=traceHint&&baseVertexIndex>=0;
+	
+	/* Locate the new position independently along each axis: */
+	bool result=true;
+	for(int i=0;i<dimension;++i)
+		{
+		/* Find the index of the cell containing the position: */
+		Scalar p=gridPos[i];
+		const Scalar* coords=ds->vertexCoordinates[i];
+		if(p<coords[0])
+			{
+			index[i]=0;
+			result=false;
+			}
+		else if(p>coords[ds->numCells[i]])
+			{
+			index[i]=ds->numCells[i]-1;
+			result=false;
+			}
+		else
+			index[i]=ds->findCell(i,p,trace?index[i]:-1);
+		
+		/* Calculate the position's local coordinate inside its cell: */
+		cellPos[i]=(p-coords[index[i]])/(coords[index[i]+1]-coords[index[i]]);
+		}
+	
+	/* Update the cell's base vertex index: */
+	baseVertexIndex=ds->numVertices.calcOffset(index);
+	
+	return result;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+template <class ValueExtractorParam>
+inline
+typename ValueExtractorParam::DestValue
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Locator::calcValue(
+	const ValueExtractorParam& extractor) const
+	{
+	typedef typename ValueExtractorParam::DestValue DestValue;
+	typedef LinearInterpolator<DestValue,Scalar> Interpolator;
+	
+	/* Perform multilinear interpolation: */
+	DestValue v[CellTopology::numVertices>>1]; // Array of intermediate interpolation values
+	int interpolationDimension=dimension-1;
+	int numSteps=CellTopology::numVertices>>1;
+	Scalar w1=cellPos[interpolationDimension];
+	Scalar w0=Scalar(1)-w1;
+	for(int vi=0;vi<numSteps;++vi)
+		{
+		ptrdiff_t vIndex=baseVertexIndex+ds->vertexOffsets[vi];
+		v[vi]=Interpolator::interpolate(extractor.getValue(vIndex+0),w0,extractor.getValue(vIndex+1),w1);
+		}
+	for(int i=1;i<dimension;++i)
+		{
+		--interpolationDimension;
+		numSteps>>=1;
+		w1=cellPos[interpolationDimension];
+		w0=Scalar(1)-w1;
+		for(int vi=0;vi<numSteps;++vi)
+			v[vi]=Interpolator::interpolate(v[vi],w0,v[vi+numSteps],w1);
+		}
+	
+	/* Return final result: */
+	return v[0];
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+template <class ScalarExtractorParam>
+inline
+typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Vector
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Locator::calcGradient(
+	const ScalarExtractorParam& extractor) const
+	{
+	typedef LinearInterpolator<Vector,Scalar> Interpolator;
+	
+	/* Perform multilinear interpolation: */
+	Vector v[CellTopology::numVertices>>1]; // Array of intermediate interpolation values
+	int interpolationDimension=dimension-1;
+	int numSteps=CellTopology::numVertices>>1;
+	Scalar w1=cellPos[interpolationDimension];
+	Scalar w0=Scalar(1)-w1;
+	for(int vi=0;vi<numSteps;++vi)
+		{
+		Index vertexIndex=index;
+		for(int i=0;i<interpolationDimension;++i)
+			if(vi&(1<<i))
+				++vertexIndex[i];
+		Vector v0=ds->calcVertexGradient(vertexIndex,extractor);
+		++vertexIndex[interpolationDimension];
+		Vector v1=ds->calcVertexGradient(vertexIndex,extractor);
+		v[vi]=Interpolator::interpolate(v0,w0,v1,w1);
+		}
+	for(int i=1;i<dimension;++i)
+		{
+		--interpolationDimension;
+		numSteps>>=1;
+		w1=cellPos[interpolationDimension];
+		w0=Scalar(1)-w1;
+		for(int vi=0;vi<numSteps;++vi)
+			v[vi]=Interpolator::interpolate(v[vi],w0,v[vi+numSteps],w1);
+		}
+	
+	/* Return final result: */
+	return v[0];
+	}
+
+/**********************************
+Methods of class SlicedRectilinear:
+**********************************/
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::initStructure(
+	void)
+	{
+	/* Initialize vertex stride array: */
+	for(int i=0;i<dimension;++i)
+		vertexStrides[i]=numVertices.calcIncrement(i);
+	
+	/* Calculate number of cells: */
+	for(int i=0;i<dimension;++i)
+		numCells[i]=numVertices[i]-1;
+	
+	/* Initialize vertex offset array: */
+	for(int i=0;i<CellTopology::numVertices;++i)
+		{
+		/* Vertex indices are, as usual, bit masks of a vertex' position in cell coordinates: */
+		vertexOffsets[i]=0;
+		for(int j=0;j<dimension;++j)
+			if(i&(1<<j))
+				vertexOffsets[i]+=vertexStrides[j];
+		}
+	
+	/* Initialize vertex list bounds: */
+	Index vertexIndex(0);
+	firstVertex=Vertex(this,vertexIndex);
+	vertexIndex[0]=numVertices[0];
+	lastVertex=Vertex(this,vertexIndex);
+	
+	/* Initialize cell list bounds: */
+	Index cellIndex(0);
+	firstCell=Cell(this,cellIndex);
+	cellIndex[0]=numCells[0];
+	lastCell=Cell(this,cellIndex);
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::installSlice(
+	typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::ValueScalar* newSlice,
+	bool external)
+	{
+	/* Create new slice, descriptor, and flag arrays: */
+	ValueScalar** newSlices=new ValueScalar*[numSlices+1];
+	ValueSlice* newEncodedSlices=new ValueSlice[numSlices+1];
+	bool* newExternalSlices=new bool[numSlices+1];
+	for(int slice=0;slice<numSlices;++slice)
+		{
+		newSlices[slice]=slices[slice];
+		newEncodedSlices[slice]=encodedSlices[slice];
+		newExternalSlices[slice]=externalSlices[slice];
+		}
+	newSlices[numSlices]=newSlice;
+	newExternalSlices[numSlices]=external;
+	
+	/* Install the new arrays: */
+	delete[] slices;
+	delete[] encodedSlices;
+	delete[] externalSlices;
+	++numSlices;
+	slices=newSlices;
+	encodedSlices=newEncodedSlices;
+	externalSlices=newExternalSlices;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+int
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::findCell(
+	int axis,
+	typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Scalar coordinate,
+	int startIndex) const
+	{
+	const Scalar* coords=vertexCoordinates[axis];
+	int lastCellIndex=numCells[axis]-1;
+	
+	if(uniformAxes[axis])
+		{
+		/* Calculate the cell index directly: */
+		int cellIndex=int(Math::floor((coordinate-axisOrigins[axis])/axisCellSizes[axis]));
+		
+		/* Correct for rounding errors near cell boundaries: */
+		if(cellIndex<0)
+			cellIndex=0;
+		else if(cellIndex>lastCellIndex)
+			cellIndex=lastCellIndex;
+		if(cellIndex>0&&coordinate<coords[cellIndex])
+			--cellIndex;
+		else if(cellIndex<lastCellIndex&&coordinate>=coords[cellIndex+1])
+			++cellIndex;
+		return cellIndex;
+		}
+	
+	/* Check the start cell and its immediate neighbours first: */
+	int l=0;
+	int r=lastCellIndex+1;
+	if(startIndex>=0)
+		{
+		if(coordinate>=coords[startIndex])
+			{
+			if(startIndex==lastCellIndex||coordinate<coords[startIndex+1])
+				return startIndex;
+			if(startIndex+1==lastCellIndex||coordinate<coords[startIndex+2])
+				return startIndex+1;
+			l=startIndex+2;
+			}
+		else
+			{
+			if(startIndex==1||coordinate>=coords[startIndex-1])
+				return startIndex-1;
+			r=startIndex-1;
+			}
+		}
+	
+	/* Find the cell by binary search; invariant: coords[l]<=coordinate<coords[r]: */
+	while(r-l>1)
+		{
+		int m=(l+r)>>1;
+		if(coordinate<coords[m])
+			r=m;
+		else
+			l=m;
+		}
+	return l;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+template <class ScalarExtractorParam>
+inline
+typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Vector
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::calcVertexGradient(
+	const typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Index& vertexIndex,
+	const ScalarExtractorParam& extractor) const
+	{
+	/* Calculate the gradient in grid space using second-order differences on the non-uniform grid: */
+	Vector gridGradient;
+	ptrdiff_t vertex=numVertices.calcOffset(vertexIndex);
+	for(int i=0;i<dimension;++i)
+		{
+		const Scalar* coords=vertexCoordinates[i];
+		int vi=vertexIndex[i];
+		if(numVertices[i]<3)
+			{
+			/* Fall back to a first-order difference across the axis' only cell, if there is one: */
+			if(numVertices[i]==2)
+				{
+				ptrdiff_t left=vertex-vertexStrides[i]*vi;
+				ptrdiff_t right=left+vertexStrides[i];
+				gridGradient[i]=(Scalar(extractor.getValue(right))-Scalar(extractor.getValue(left)))/(coords[1]-coords[0]);
+				}
+			else
+				gridGradient[i]=Scalar(0);
+			}
+		else if(vi==0)
+			{
+			ptrdiff_t left=vertex+vertexStrides[i];
+			ptrdiff_t right=left+vertexStrides[i];
+			Scalar h1=coords[1]-coords[0];
+			Scalar h2=coords[2]-coords[1];
+			Scalar f0=Scalar(extractor.getValue(vertex));
+			Scalar f1=Scalar(extractor.getValue(left));
+			Scalar f2=Scalar(extractor.getValue(right));
+			gridGradient[i]=-(Scalar(2)*h1+h2)/(h1*(h1+h2))*f0+(h1+h2)/(h1*h2)*f1-h1/(h2*(h1+h2))*f2;
+			}
+		else if(vi==numVertices[i]-1)
+			{
+			ptrdiff_t right=vertex-vertexStrides[i];
+			ptrdiff_t left=right-vertexStrides[i];
+			Scalar h1=coords[vi-1]-coords[vi-2];
+			Scalar h2=coords[vi]-coords[vi-1];
+			Scalar f0=Scalar(extractor.getValue(left));
+			Scalar f1=Scalar(extractor.getValue(right));
+			Scalar f2=Scalar(extractor.getValue(vertex));
+			gridGradient[i]=h2/(h1*(h1+h2))*f0-(h1+h2)/(h1*h2)*f1+(Scalar(2)*h2+h1)/(h2*(h1+h2))*f2;
+			}
+		else
+			{
+			ptrdiff_t left=vertex-vertexStrides[i];
+			ptrdiff_t right=vertex+vertexStrides[i];
+			Scalar h1=coords[vi]-coords[vi-1];
+			Scalar h2=coords[vi+1]-coords[vi];
+			Scalar f0=Scalar(extractor.getValue(left));
+			Scalar f1=Scalar(extractor.getValue(vertex));
+			Scalar f2=Scalar(extractor.getValue(right));
+			gridGradient[i]=-h2/(h1*(h1+h2))*f0+(h2-h1)/(h1*h2)*f1+h1/(h2*(h1+h2))*f2;
+			}
+		}
+	
+	/* Rotate the gradient into domain space: */
+	return gridTransformation.transform(gridGradient);
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::SlicedRectilinear(
+	void)
+	:numVertices(0),
+	 gridTransformation(GridTransformation::identity),
+	 numCells(0),
+	 domainBox(Box::empty),
+	 numSlices(0),
+	 slices(0),
+	 encodedSlices(0),
+	 externalSlices(0),
+	 numSliceStorages(0),
+	 sliceStorages(0)
+	{
+	/* Initialize per-axis arrays: */
+	for(int i=0;i<dimension;++i)
+		{
+		vertexCoordinates[i]=0;
+		vertexStrides[i]=0;
+		uniformAxes[i]=false;
+		axisOrigins[i]=Scalar(0);
+		axisCellSizes[i]=Scalar(0);
+		}
+	
+	/* Initialize vertex offset array: */
+	for(int i=0;i<CellTopology::numVertices;++i)
+		vertexOffsets[i]=0;
+	
+	/* Initialize vertex list bounds: */
+	Index vertexIndex(0);
+	firstVertex=Vertex(this,vertexIndex);
+	lastVertex=Vertex(this,vertexIndex);
+	
+	/* Initialize cell list bounds: */
+	Index cellIndex(0);
+	firstCell=Cell(this,cellIndex);
+	lastCell=Cell(this,cellIndex);
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::SlicedRectilinear(
+	const typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Index& sNumVertices,
+	int sNumSlices,
+	const typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Scalar* const sVertexCoordinates[dimensionParam])
+	:numVertices(0),
+	 gridTransformation(GridTransformation::identity),
+	 domainBox(Box::empty),
+	 numSlices(0),
+	 slices(0),
+	 encodedSlices(0),
+	 externalSlices(0),
+	 numSliceStorages(0),
+	 sliceStorages(0)
+	{
+	for(int i=0;i<dimension;++i)
+		vertexCoordinates[i]=0;
+	
+	/* Create the slices: */
+	for(int sliceIndex=0;sliceIndex<sNumSlices;++sliceIndex)
+		addSlice();
+	
+	/* Create the grid: */
+	setGrid(sNumVertices,sVertexCoordinates);
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::~SlicedRectilinear(
+	void)
+	{
+	/* Delete vertex coordinate arrays: */
+	for(int i=0;i<dimension;++i)
+		delete[] vertexCoordinates[i];
+	
+	/* Delete slice arrays: */
+	for(int slice=0;slice<numSlices;++slice)
+		{
+		if(!externalSlices[slice])
+			delete[] slices[slice];
+		encodedSlices[slice].deleteValues();
+		}
+	delete[] slices;
+	delete[] encodedSlices;
+	delete[] externalSlices;
+	
+	/* Release external slice storage: */
+	for(int i=0;i<numSliceStorages;++i)
+		delete sliceStorages[i];
+	delete[] sliceStorages;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::setGrid(
+	const typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Index& sNumVertices,
+	const typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Scalar* const sVertexCoordinates[dimensionParam])
+	{
+	/* Resize the vertex coordinate arrays: */
+	numVertices=sNumVertices;
+	for(int i=0;i<dimension;++i)
+		{
+		delete[] vertexCoordinates[i];
+		vertexCoordinates[i]=new Scalar[numVertices[i]];
+		}
+	
+	initStructure();
+	
+	/* Resize all value slices: */
+	size_t totalNumVertices=size_t(numVertices.calcIncrement(-1));
+	for(int slice=0;slice<numSlices;++slice)
+		{
+		if(!externalSlices[slice])
+			delete[] slices[slice];
+		encodedSlices[slice].deleteValues();
+		encodedSlices[slice]=ValueSlice();
+		slices[slice]=new ValueScalar[totalNumVertices];
+		externalSlices[slice]=false;
+		}
+	
+	/* Copy source vertex coordinates, if present: */
+	if(sVertexCoordinates!=0)
+		{
+		for(int i=0;i<dimension;++i)
+			for(int j=0;j<numVertices[i];++j)
+				vertexCoordinates[i][j]=sVertexCoordinates[i][j];
+		
+		/* Finalize grid structure: */
+		finalizeGrid();
+		}
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+int
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::addSlice(
+	const typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::ValueScalar* sSliceValues)
+	{
+	/* Initialize the new slice: */
+	size_t totalNumVertices=size_t(numVertices.calcIncrement(-1));
+	ValueScalar* newSlice=new ValueScalar[totalNumVertices];
+	
+	if(sSliceValues!=0)
+		{
+		/* Copy the given slice values: */
+		ValueScalar* slicePtr=newSlice;
+		for(size_t i=0;i<totalNumVertices;++i,++slicePtr,++sSliceValues)
+			*slicePtr=*sSliceValues;
+		}
+	
+	/* Install the new slice: */
+	installSlice(newSlice,false);
+	
+	return numSlices-1;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+int
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::addSlice(
+	const typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::ValueScalar* sSliceValues,
+	typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::ValueSlice::Format format)
+	{
+	int sliceIndex=addSlice(sSliceValues);
+	encodeSlice(sliceIndex,format);
+	
+	return sliceIndex;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+int
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::addExternalSlice(
+	typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::ValueScalar* sSliceArray)
+	{
+	/* Install the given array as new slice without copying: */
+	installSlice(sSliceArray,true);
+	
+	return numSlices-1;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::encodeSlice(
+	int sliceIndex,
+	typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::ValueSlice::Format format)
+	{
+	if(format==ValueSlice::NATIVE||encodedSlices[sliceIndex].getValues()!=0)
+		return;
+	
+	/* Replace the native slice with an encoded copy; the arrays of external slices are left to their owners: */
+	encodedSlices[sliceIndex]=ValueSlice::encode(format,getTotalNumVertices(),slices[sliceIndex]);
+	if(!externalSlices[sliceIndex])
+		delete[] slices[sliceIndex];
+	slices[sliceIndex]=0;
+	externalSlices[sliceIndex]=false;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::adoptSliceStorage(
+	ExternalSliceStorage* sSliceStorage)
+	{
+	/* Append the storage object to the list of owned storage objects: */
+	ExternalSliceStorage** newSliceStorages=new ExternalSliceStorage*[numSliceStorages+1];
+	for(int i=0;i<numSliceStorages;++i)
+		newSliceStorages[i]=sliceStorages[i];
+	newSliceStorages[numSliceStorages]=sSliceStorage;
+	delete[] sliceStorages;
+	++numSliceStorages;
+	sliceStorages=newSliceStorages;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::setGridTransformation(
+	const typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::GridTransformation& newGridTransformation)
+	{
+	gridTransformation=newGridTransformation;
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Point
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::getVertexPosition(
+	const typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Index& vertexIndex) const
+	{
+	/* Compute vertex position on-the-fly: */
+	Point result;
+	for(int i=0;i<dimension;++i)
+		result[i]=vertexCoordinates[i][vertexIndex[i]];
+	return gridTransformation.transform(result);
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+void
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::finalizeGrid(
+	void)
+	{
+	/* Analyze the vertex coordinates along each axis: */
+	for(int i=0;i<dimension;++i)
+		{
+		const Scalar* coords=vertexCoordinates[i];
+		axisOrigins[i]=coords[0];
+		axisCellSizes[i]=(coords[numCells[i]]-coords[0])/Scalar(numCells[i]);
+		
+		/* Check if the axis is evenly spaced, to allow direct cell lookup during point location: */
+		Scalar maxDeviation=Scalar(0);
+		for(int j=1;j<numVertices[i];++j)
+			{
+			Scalar deviation=Math::abs(coords[j]-(axisOrigins[i]+Scalar(j)*axisCellSizes[i]));
+			if(maxDeviation<deviation)
+				maxDeviation=deviation;
+			}
+		uniformAxes[i]=maxDeviation<=axisCellSizes[i]*Scalar(1.0e-4);
+		}
+	
+	/* Calculate the bounding box of the transformed grid-space bounding box's corners: */
+	domainBox=Box::empty;
+	for(int corner=0;corner<(1<<dimension);++corner)
+		{
+		Point gridCorner;
+		for(int i=0;i<dimension;++i)
+			gridCorner[i]=corner&(1<<i)?vertexCoordinates[i][numCells[i]]:vertexCoordinates[i][0];
+		domainBox.addPoint(gridTransformation.transform(gridCorner));
+		}
+	}
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+inline
+typename SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::Scalar
+SlicedRectilinear<ScalarParam,dimensionParam,ValueScalarParam>::calcAverageCellSize(
+	void) const
+	{
+	/* Compute and return the geometric mean of the average cell sizes along each axis: */
+	Scalar size=axisCellSizes[0];
+	for(int i=1;i<dimension;++i)
+		size*=axisCellSizes[i];
+	return Math::pow(size,Scalar(1)/Scalar(dimension));
+	}
+
+}
+
+}
@@ -0,0 +1,412 @@
+/***********************************************************************
+SlicedRectilinear - Base class for vertex-centered rectilinear data sets
+containing arbitrary numbers of independent scalar fields, combined into
+vector and/or tensor fields using special value extractors. Vertex
+positions are defined by one coordinate array per axis, and the grid can
+be placed in the domain by an orthonormal transformation.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_SLICEDRECTILINEAR_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_SLICEDRECTILINEAR_INCLUDED
+
+#include <Misc/ArrayIndex.h>
+#include <Geometry/ComponentArray.h>
+#include <Geometry/Point.h>
+#include <Geometry/Vector.h>
+#include <Geometry/Box.h>
+#include <Geometry/OrthonormalTransformation.h>
+
+#include <Templatized/SlicedDataValue.h>
+#include <Templatized/EncodedSlice.h>
+#include <Templatized/ExternalSliceStorage.h>
+#include <Templatized/Tesseract.h>
+#include <Templatized/LinearIndexID.h>
+#include <Templatized/IteratorWrapper.h>
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class ScalarParam,int dimensionParam,class ValueScalarParam>
+class SlicedRectilinear
+	{
+	/* Embedded classes: */
+	public:
+	
+	/* Definition of the data set's domain space: */
+	typedef ScalarParam Scalar; // Scalar type of data set's domain
+	static const int dimension=dimensionParam; // Dimension of data set's domain
+	typedef Geometry::Point<Scalar,dimensionParam> Point; // Type for points in data set's domain
+	typedef Geometry::Vector<Scalar,dimensionParam> Vector; // Type for vectors in data set's domain
+	typedef Geometry::Box<Scalar,dimensionParam> Box; // Type for axis-aligned boxes in data set's domain
+	typedef Geometry::OrthonormalTransformation<Scalar,dimensionParam> GridTransformation; // Type for transformations from grid space to the data set's domain
+	
+	/* Definition of the data set's cell topology: */
+	typedef Tesseract<dimensionParam> CellTopology; // Policy class to select appropriate cell algorithms
+	
+	/* Definition of the data set's value space: */
+	typedef ValueScalarParam ValueScalar; // Data set's value type for scalar values
+	typedef SlicedDataValue<ValueScalar> Value; // Data set's compound value type
+	typedef EncodedSlice<ValueScalar> ValueSlice; // Type of descriptors for value slices stored in native or encoded form
+	
+	/* Low-level definitions of data set storage: */
+	typedef Misc::ArrayIndex<dimensionParam> Index; // Index type for data set storage (value slices)
+	
+	/* Data set interface classes: */
+	typedef LinearIndexID VertexID;
+	
+	class Vertex // Class to represent and iterate through vertices
+		{
+		friend class SlicedRectilinear;
+		
+		/* Elements: */
+		private:
+		const SlicedRectilinear* ds; // Pointer to data set containing the vertex
+		Index index; // Array index of vertex in data set storage
+		
+		/* Constructors and destructors: */
+		public:
+		Vertex(void) // Creates an invalid vertex
+			:ds(0)
+			{
+			}
+		private:
+		Vertex(const SlicedRectilinear* sDs,const Index& sIndex)
+			:ds(sDs),index(sIndex)
+			{
+			}
+		
+		/* Methods: */
+		public:
+		Point getPosition(void) const // Returns vertex' position in domain
+			{
+			return ds->getVertexPosition(index);
+			}
+		template <class ValueExtractorParam>
+		typename ValueExtractorParam::DestValue getValue(const ValueExtractorParam& extractor) const // Returns vertex' value based on given extractor
+			{
+			return extractor.getValue(ds->numVertices.calcOffset(index));
+			}
+		template <class ScalarExtractorParam>
+		Vector calcGradient(const ScalarExtractorParam& extractor) const // Returns gradient at the vertex, based on given scalar extractor
+			{
+			return ds->calcVertexGradient(index,extractor);
+			}
+		VertexID getID(void) const // Returns vertex' ID
+			{
+			return VertexID(VertexID::Index(ds->numVertices.calcOffset(index)));
+			}
+		
+		/* Iterator methods: */
+		friend bool operator==(const Vertex& v1,const Vertex& v2)
+			{
+			return v1.index==v2.index&&v1.ds==v2.ds;
+			}
+		friend bool operator!=(const Vertex& v1,const Vertex& v2)
+			{
+			return v1.index!=v2.index||v1.ds!=v2.ds;
+			}
+		Vertex& operator++(void) // Pre-increment operator
+			{
+			index.preInc(ds->numVertices);
+			return *this;
+			}
+		};
+	
+	typedef IteratorWrapper<Vertex> VertexIterator; // Class to iterate through vertices
+	
+	typedef LinearIndexID EdgeID; // Class to identify cell edges
+	
+	typedef LinearIndexID CellID; // Class to identify cells
+	
+	class Locator;
+	
+	class Cell // Class to represent and iterate through cells
+		{
+		friend class SlicedRectilinear;
+		friend class Locator;
+		
+		/* Elements: */
+		private:
+		const SlicedRectilinear* ds; // Pointer to the data set containing the cell
+		Index index; // Array index of cell's base vertex in data set storage
+		ptrdiff_t baseVertexIndex; // Linear index of cell's base vertex in data set storage
+		
+		/* Constructors and destructors: */
+		public:
+		Cell(void) // Creates an invalid cell
+			:ds(0),baseVertexIndex(-1)
+			{
+			}
+		private:
+		Cell(const SlicedRectilinear* sDs) // Creates an invalid cell in the given data set
+			:ds(sDs),baseVertexIndex(-1)
+			{
+			}
+		Cell(const SlicedRectilinear* sDs,const Index& sIndex) // Elementwise constructor
+			:ds(sDs),index(sIndex),baseVertexIndex(ds->numVertices.calcOffset(index))
+			{
+			}
+		
+		/* Methods: */
+		public:
+		bool isValid(void) const // Returns true if the cell is valid
+			{
+			return baseVertexIndex>=0;
+			}
+		VertexID getVertexID(int vertexIndex) const // Returns ID of given vertex of the cell
+			{
+			return VertexID(VertexID::Index(baseVertexIndex+ds->vertexOffsets[vertexIndex]));
+			}
+		Vertex getVertex(int vertexIndex) const; // Returns the given vertex of the cell
+		Point getVertexPosition(int vertexIndex) const; // Returns position of given vertex of the cell
+		template <class ValueExtractorParam>
+		typename ValueExtractorParam::DestValue getVertexValue(int vertexIndex,const ValueExtractorParam& extractor) const // Returns value of given vertex of the cell, based on given extractor
+			{
+			return extractor.getValue(baseVertexIndex+ds->vertexOffsets[vertexIndex]);
+			}
+		template <class ScalarExtractorParam>
+		Vector calcVertexGradient(int vertexIndex,const ScalarExtractorParam& extractor) const; // Returns gradient at given vertex of the cell, based on given scalar extractor
+		EdgeID getEdgeID(int edgeIndex) const; // Returns ID of given edge of the cell
+		Point calcEdgePosition(int edgeIndex,Scalar weight) const; // Returns an interpolated point along the given edge
+		CellID getID(void) const // Returns cell's ID
+			{
+			return CellID(CellID::Index(baseVertexIndex));
+			}
+		CellID getNeighbourID(int neighbourIndex) const; // Returns ID of neighbour across the given face of the cell
+		
+		/* Iterator methods: */
+		friend bool operator==(const Cell& cell1,const Cell& cell2)
+			{
+			return cell1.baseVertexIndex==cell2.baseVertexIndex&&cell1.ds==cell2.ds;
+			}
+		friend bool operator!=(const Cell& cell1,const Cell& cell2)
+			{
+			return cell1.baseVertexIndex!=cell2.baseVertexIndex||cell1.ds!=cell2.ds;
+			}
+		Cell& operator++(void) // Pre-increment operator
+			{
+			index.preInc(ds->numCells);
+			baseVertexIndex=ds->numVertices.calcOffset(index);
+			return *this;
+			}
+		};
+	
+	typedef IteratorWrapper<Cell> CellIterator; // Class to iterate through cells
+	
+	class Locator:private Cell // Class responsible for evaluating a data set at a given position
+		{
+		friend class SlicedRectilinear;
+		
+		/* Embedded classes: */
+		private:
+		typedef Geometry::ComponentArray<Scalar,dimensionParam> CellPosition; // Type for local cell coordinates
+		
+		/* Elements: */
+		using Cell::ds;
+		using Cell::index;
+		using Cell::baseVertexIndex;
+		CellPosition cellPos; // Local coordinates of last located point inside its cell
+		
+		/* Constructors and destructors: */
+		public:
+		Locator(void); // Creates invalid locator
+		private:
+		Locator(const SlicedRectilinear* sDs); // Creates non-localized locator associated with given data set
+		
+		/* Methods: */
+		public:
+		void setEpsilon(Scalar newEpsilon) // Sets a new accuracy threshold in local cell dimension
+			{
+			/* Not needed for rectilinear data sets */
+			}
+		CellID getCellID(void) const // Returns the ID of the cell containing the last located point
+			{
+			return Cell::getID();
+			}
+		bool locatePoint(const Point& position,bool traceHint =false); // Sets locator to given position; returns true if position is inside found cell
+		template <class ValueExtractorParam>
+		typename ValueExtractorParam::DestValue calcValue(const ValueExtractorParam& extractor) const; // Calculates value at last located position
+		template <class ScalarExtractorParam>
+		Vector calcGradient(const ScalarExtractorParam& extractor) const; // Calculates gradient at last located position
+		};
+	
+	friend class Vertex;
+	friend class Cell;
+	friend class Locator;
+	
+	/* Elements: */
+	private:
+	Index numVertices; // Number of vertices in data set in each dimension
+	Scalar* vertexCoordinates[dimension]; // Arrays of strictly increasing vertex coordinates along each grid axis
+	GridTransformation gridTransformation; // Transformation from grid space to the data set's domain
+	int vertexStrides[dimension]; // Array of pointer stride values in the vertex array
+	Index numCells; // Number of cells in data set in each dimension
+	int vertexOffsets[CellTopology::numVertices]; // Array of pointer offsets from a cell's base vertex to all cell vertices
+	bool uniformAxes[dimension]; // Flags whether the vertex coordinates along each axis are evenly spaced
+	Scalar axisOrigins[dimension]; // First vertex coordinate along each axis
+	Scalar axisCellSizes[dimension]; // Average cell size along each axis; exact cell size along uniform axes
+	VertexIterator firstVertex,lastVertex; // Bounds of vertex list
+	CellIterator firstCell,lastCell; // Bounds of cell list
+	Box domainBox; // Bounding box of all vertices
+	int numSlices; // Number of scalar value slices in the data set
+	ValueScalar** slices; // Array of vertex value slices; encoded slices have null value arrays
+	ValueSlice* encodedSlices; // Array of descriptors of encoded value slices; descriptors of native slices have null value arrays
+	bool* externalSlices; // Array of flags whether each value slice is backed by external storage instead of owned by the data set
+	int numSliceStorages; // Number of external slice storage objects owned by the data set
+	ExternalSliceStorage** sliceStorages; // Array of external slice storage objects owned by the data set
+	
+	/* Private methods: */
+	void initStructure(void);
+	void installSlice(ValueScalar* newSlice,bool external); // Appends the given array to the list of value slices
+	int findCell(int axis,Scalar coordinate,int startIndex) const; // Returns index of cell along given axis containing given coordinate; starts searching at given cell index
+	template <class ScalarExtractorParam>
+	Vector calcVertexGradient(const Index& vertexIndex,const ScalarExtractorParam& extractor) const; // Returns gradient at a vertex based on the given scalar extractor
+	
+	/* Constructors and destructors: */
+	public:
+	SlicedRectilinear(void); // Creates an "empty" data set
+	SlicedRectilinear(const Index& sNumVertices,int sNumSlices,const Scalar* const sVertexCoordinates[dimensionParam] =0); // Creates a data set with the given number of vertices and slices; copies vertex coordinates if pointer is not null
+	~SlicedRectilinear(void);
+	
+	/* Data set construction methods: */
+	void setGrid(const Index& sNumVertices,const Scalar* const sVertexCoordinates[dimensionParam] =0); // Sets the number of vertices of the data set; copies per-axis vertex coordinates if pointer is not null
+	int addSlice(const ValueScalar* sSliceValues =0); // Adds another slice to the data set; copies slice values from given array if pointer is not null; returns index of new slice
+	int addSlice(const ValueScalar* sSliceValues,typename ValueSlice::Format format); // Adds another slice storing the given slice values in the given format; returns index of new slice
+	int addExternalSlice(ValueScalar* sSliceArray); // Adds another slice to the data set that uses the given array directly; array must remain valid until the data set is destroyed, or can be null to be set later; returns index of new slice
+	void setExternalSliceArray(int sliceIndex,ValueScalar* sSliceArray) // Sets the array used by a slice added with addExternalSlice; array must remain valid until the data set is destroyed
+		{
+		slices[sliceIndex]=sSliceArray;
+		}
+	void encodeSlice(int sliceIndex,typename ValueSlice::Format format); // Converts a native slice to the given storage format; the slice's values are read-only afterwards, and the array of an external slice is no longer used
+	void adoptSliceStorage(ExternalSliceStorage* sSliceStorage); // Transfers ownership of an object backing external slices to the data set; object is deleted when the data set is destroyed
+	void swapSliceArray(int sliceIndex,ValueScalar*& sliceArray) // Exchanges the array of a native slice owned by the data set with the given array of the same size; the data set takes ownership of the given array, and the caller of the slice's old array
+		{
+		ValueScalar* oldSliceArray=slices[sliceIndex];
+		slices[sliceIndex]=sliceArray;
+		sliceArray=oldSliceArray;
+		}
+	
+	/* Low-level data access methods: */
+	const Index& getNumVertices(void) const // Returns number of vertices in the data set
+		{
+		return numVertices;
+		}
+	int getVertexStride(int direction) const // Returns the data set's vertex stride in one direction
+		{
+		return vertexStrides[direction];
+		}
+	const Scalar* getVertexCoordinates(int axis) const // Returns the array of vertex coordinates along the given grid axis
+		{
+		return vertexCoordinates[axis];
+		}
+	Scalar* getVertexCoordinates(int axis) // Ditto
+		{
+		return vertexCoordinates[axis];
+		}
+	const GridTransformation& getGridTransformation(void) const // Returns the transformation from grid space to the data set's domain
+		{
+		return gridTransformation;
+		}
+	void setGridTransformation(const GridTransformation& newGridTransformation); // Sets the transformation from grid space to the data set's domain; requires call to finalizeGrid
+	Point getVertexPosition(const Index& vertexIndex) const; // Returns a vertex' position
+	int getNumSlices(void) const // Returns the number of value slices in the data set
+		{
+		return numSlices;
+		}
+	const ValueScalar* getSliceArray(int sliceIndex) const // Returns one of the data set's value slices as a C array; returns null for encoded slices
+		{
+		return slices[sliceIndex];
+		}
+	ValueScalar* getSliceArray(int sliceIndex) // Ditto
+		{
+		return slices[sliceIndex];
+		}
+	ValueSlice getValueSlice(int sliceIndex) const // Returns a descriptor of one of the data set's value slices
+		{
+		return encodedSlices[sliceIndex].getValues()!=0?encodedSlices[sliceIndex]:ValueSlice(slices[sliceIndex]);
+		}
+	ValueScalar getVertexValue(int sliceIndex,const Index& vertexIndex) const // Returns a vertex' data value from one slice
+		{
+		return ValueScalar(getValueSlice(sliceIndex).getValue(numVertices.calcOffset(vertexIndex)));
+		}
+	ValueScalar& getVertexValue(int sliceIndex,const Index& vertexIndex) // Ditto; slice must be native
+		{
+		return slices[sliceIndex][numVertices.calcOffset(vertexIndex)];
+		}
+	const Index& getNumCells(void) const // Returns number of cells in grid
+		{
+		return numCells;
+		}
+	void finalizeGrid(void); // Recalculates derived grid information after grid structure change
+	
+	/* Methods implementing the data set interface: */
+	size_t getTotalNumVertices(void) const // Returns total number of vertices in the data set
+		{
+		return numVertices.calcIncrement(-1);
+		}
+	Vertex getVertex(const VertexID& vertexID) const // Returns vertex of given valid ID
+		{
+		return Vertex(this,numVertices.calcIndex(vertexID.getIndex()));
+		}
+	const VertexIterator& beginVertices(void) const // Returns iterator to first vertex in the data set
+		{
+		return firstVertex;
+		}
+	const VertexIterator& endVertices(void) const // Returns iterator behind last vertex in the data set
+		{
+		return lastVertex;
+		}
+	size_t getTotalNumCells(void) const // Returns total number of cells in the data set
+		{
+		return numCells.calcIncrement(-1);
+		}
+	Cell getCell(const CellID& cellID) const // Return cell of given valid ID
+		{
+		return Cell(this,numVertices.calcIndex(cellID.getIndex()));
+		}
+	const CellIterator& beginCells(void) const // Returns iterator to first cell in the data set
+		{
+		return firstCell;
+		}
+	const CellIterator& endCells(void) const // Returns iterator behind last cell in the data set
+		{
+		return lastCell;
+		}
+	const Box& getDomainBox(void) const // Returns bounding box of the data set's domain
+		{
+		return domainBox;
+		}
+	Scalar calcAverageCellSize(void) const; // Calculates an estimate of the average cell size in the data set
+	Locator getLocator(void) const // Returns an unlocalized locator for the data set
+		{
+		return Locator(this);
+		}
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_TEMPLATIZED_SLICEDRECTILINEAR_IMPLEMENTATION
+#include <Templatized/SlicedRectilinear.cpp>
+#endif
+
+#endif
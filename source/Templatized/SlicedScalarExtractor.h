@@ -26,6 +26,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <stddef.h>
 
 #include <Templatized/SlicedDataValue.h>
+#include <Templatized/EncodedSlice.h>
 
 /* Forward declarations: */
 namespace Visualization {
@@ -47,22 +48,37 @@ class ScalarExtractor<ScalarParam,SlicedDataValue<SourceValueScalarParam> >
 	typedef ScalarParam Scalar; // Returned scalar type
 	typedef ScalarParam DestValue; // Alias to use scalar extractor as generic value extractor
 	typedef SourceValueScalarParam SourceValueScalar; // Source value scalar type
+	typedef EncodedSlice<SourceValueScalar> Slice; // Type of descriptors for possibly encoded slices
 	
 	/* Elements: */
 	private:
-	const SourceValueScalar* valueArray; // Pointer to the used slice value array
+	const SourceValueScalar* nativeValues; // Value array of the used slice if it is stored natively, or null
+	Slice slice; // Descriptor of the used slice
+	typename Slice::Decoder decoder; // Method decoding single values of the used slice's storage format
 	
 	/* Constructors and destructors: */
 	public:
-	ScalarExtractor(const SourceValueScalar* sValueArray) // Creates extractor for given value array
-		:valueArray(sValueArray)
+	ScalarExtractor(const SourceValueScalar* sValueArray) // Creates extractor for given native value array
+		:nativeValues(sValueArray),slice(sValueArray),decoder(slice.getDecoder())
+		{
+		}
+	ScalarExtractor(const Slice& sSlice) // Creates extractor for given slice
+		:nativeValues(sSlice.getNativeValues()),slice(sSlice),decoder(slice.getDecoder())
 		{
 		}
 	
 	/* Methods: */
 	DestValue getValue(ptrdiff_t linearIndex) const // Extracts scalar from given linear index in slice value array
 		{
-		return DestValue(valueArray[linearIndex]);
+		/* Read native slices directly; the storage format of encoded slices was dispatched when the extractor was created: */
+		if(nativeValues!=0)
+			return DestValue(nativeValues[linearIndex]);
+		else
+			return DestValue((slice.*decoder)(linearIndex));
+		}
+	void getValues(ptrdiff_t firstLinearIndex,size_t numValues,DestValue* values) const // Extracts scalars from a run of consecutive linear indices in slice value array
+		{
+		slice.decode(firstLinearIndex,numValues,values);
 		}
 	};
 
@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Geometry/Vector.h>
 
 #include <Templatized/SlicedDataValue.h>
+#include <Templatized/EncodedSlice.h>
 
 /* Forward declarations: */
 namespace Visualization {
@@ -49,29 +50,65 @@ class VectorExtractor<VectorParam,SlicedDataValue<SourceValueScalarParam> >
 	typedef VectorParam DestValue; // Alias to use vector extractor as generic value extractor
 	static const int dimension=Vector::dimension; // Dimension of returned vector type
 	typedef SourceValueScalarParam SourceValueScalar; // Source value scalar type
+	typedef EncodedSlice<SourceValueScalar> Slice; // Type of descriptors for possibly encoded slices
 	
 	/* Elements: */
 	private:
-	const SourceValueScalar* valueArrays[dimension]; // Pointers to the used slice value arrays
+	const SourceValueScalar* nativeValues[dimension]; // Value arrays of the used slices if they are stored natively, or null
+	Slice slices[dimension]; // Descriptors of the used slices
+	typename Slice::Decoder decoders[dimension]; // Methods decoding single values of the used slices' storage formats
 	
 	/* Constructors and destructors: */
 	public:
 	VectorExtractor(void) // Creates an undefined vector extractor
 		{
+		for(int i=0;i<dimension;++i)
+			{
+			nativeValues[i]=0;
+			decoders[i]=slices[i].getDecoder();
+			}
 		}
 	
 	/* Methods: */
-	void setSlice(int sliceIndex,const SourceValueScalar* sValueArray) // Sets the value array for one result vector component
+	void setSlice(int sliceIndex,const SourceValueScalar* sValueArray) // Sets the native value array for one result vector component
+		{
+		nativeValues[sliceIndex]=sValueArray;
+		slices[sliceIndex]=Slice(sValueArray);
+		decoders[sliceIndex]=slices[sliceIndex].getDecoder();
+		}
+	void setSlice(int sliceIndex,const Slice& sSlice) // Sets the slice for one result vector component
 		{
-		valueArrays[sliceIndex]=sValueArray;
+		nativeValues[sliceIndex]=sSlice.getNativeValues();
+		slices[sliceIndex]=sSlice;
+		decoders[sliceIndex]=slices[sliceIndex].getDecoder();
 		}
 	DestValue getValue(ptrdiff_t linearIndex) const // Extracts vector from given linear index in all slice value arrays
 		{
 		DestValue result;
 		for(int i=0;i<dimension;++i)
-			result[i]=typename Vector::Scalar(valueArrays[i][linearIndex]);
+			{
+			if(nativeValues[i]!=0)
+				result[i]=typename Vector::Scalar(nativeValues[i][linearIndex]);
+			else
+				result[i]=typename Vector::Scalar((slices[i].*decoders[i])(linearIndex));
+			}
 		return result;
 		}
+	void getValues(ptrdiff_t firstLinearIndex,size_t numValues,DestValue* values) const // Extracts vectors from a run of consecutive linear indices in all slice value arrays
+		{
+		/* Decode each component in runs that fit into a local buffer: */
+		typename Vector::Scalar buffer[256];
+		for(size_t runStart=0;runStart<numValues;runStart+=256)
+			{
+			size_t runLength=numValues-runStart<256?numValues-runStart:256;
+			for(int i=0;i<dimension;++i)
+				{
+				slices[i].decode(firstLinearIndex+ptrdiff_t(runStart),runLength,buffer);
+				for(size_t j=0;j<runLength;++j)
+					values[runStart+j][i]=buffer[j];
+				}
+			}
+		}
 	};
 
 }
@@ -170,6 +170,29 @@ TriangleSet<VertexParam>::clear(
 	nextVertex=0;
 	}
 
+template <class VertexParam>
+inline
+void
+TriangleSet<VertexParam>::append(
+	const TriangleSet<VertexParam>& source)
+	{
+	/* Copy the source's triangles; all source chunks except the last one are full: */
+	size_t numSourceTriangles=source.numTriangles;
+	for(const Chunk* chunkPtr=source.head;numSourceTriangles>0;chunkPtr=chunkPtr->succ)
+		{
+		size_t numChunkTriangles=numSourceTriangles<chunkSize?numSourceTriangles:chunkSize;
+		const Vertex* sourceVertexPtr=chunkPtr->vertices;
+		for(size_t i=0;i<numChunkTriangles;++i,sourceVertexPtr+=3)
+			{
+			Vertex* vertexPtr=getNextTriangleVertices();
+			for(int j=0;j<3;++j)
+				vertexPtr[j]=sourceVertexPtr[j];
+			addTriangle();
+			}
+		numSourceTriangles-=numChunkTriangles;
+		}
+	}
+
 template <class VertexParam>
 inline
 void
@@ -98,6 +98,7 @@ class TriangleSet:public GLObject
 	/* Methods: */
 	virtual void initContext(GLContextData& contextData) const;
 	void clear(void); // Removes all triangles from the set
+	void append(const TriangleSet& source); // Appends copies of all triangles of the given triangle set
 	Vertex* getNextTriangleVertices(void) // Returns pointer to next vertex triple in buffer
 		{
 		/* Check if there is room to add another triangle: */
@@ -0,0 +1,135 @@
+/***********************************************************************
+ValueRangeCalculator - Helper class to calculate the ranges of scalar
+values and vector magnitudes of a data set. Sliced data sets read their
+values in runs of consecutive linear indices, such that encoded slices
+are decoded in bulk.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_TEMPLATIZED_VALUERANGECALCULATOR_INCLUDED
+#define VISUALIZATION_TEMPLATIZED_VALUERANGECALCULATOR_INCLUDED
+
+#include <stddef.h>
+#include <Geometry/Vector.h>
+
+#include <Templatized/SlicedDataValue.h>
+
+namespace Visualization {
+
+namespace Templatized {
+
+template <class DataSetParam,class DataValueParam>
+class ValueRangeCalculator // Generic class iterating through all vertices of a data set
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSetParam DataSet; // Type of data set
+	
+	/* Methods: */
+	template <class ScalarExtractorParam,class ScalarParam>
+	static void calcScalarRange(const DataSet& dataSet,const ScalarExtractorParam& extractor,ScalarParam& min,ScalarParam& max) // Calculates the range of scalar values of the given data set
+		{
+		typename DataSet::VertexIterator vIt=dataSet.beginVertices();
+		min=max=ScalarParam(vIt->getValue(extractor));
+		for(++vIt;vIt!=dataSet.endVertices();++vIt)
+			{
+			ScalarParam v=ScalarParam(vIt->getValue(extractor));
+			if(min>v)
+				min=v;
+			else if(max<v)
+				max=v;
+			}
+		}
+	template <class VectorExtractorParam,class ScalarParam>
+	static void calcVectorMagnitude2Range(const DataSet& dataSet,const VectorExtractorParam& extractor,ScalarParam& min2,ScalarParam& max2) // Calculates the range of squared vector magnitudes of the given data set
+		{
+		typename DataSet::VertexIterator vIt=dataSet.beginVertices();
+		min2=max2=ScalarParam(Geometry::sqr(vIt->getValue(extractor)));
+		for(++vIt;vIt!=dataSet.endVertices();++vIt)
+			{
+			ScalarParam v2=ScalarParam(Geometry::sqr(vIt->getValue(extractor)));
+			if(min2>v2)
+				min2=v2;
+			else if(max2<v2)
+				max2=v2;
+			}
+		}
+	};
+
+template <class DataSetParam,class ValueScalarParam>
+class ValueRangeCalculator<DataSetParam,SlicedDataValue<ValueScalarParam> > // Specialized class for sliced data sets, reading values in runs through the extractors' getValues methods
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSetParam DataSet; // Type of data set
+	
+	private:
+	static const size_t runLength=1024; // Number of values read from the extractor at once
+	
+	/* Methods: */
+	public:
+	template <class ScalarExtractorParam,class ScalarParam>
+	static void calcScalarRange(const DataSet& dataSet,const ScalarExtractorParam& extractor,ScalarParam& min,ScalarParam& max) // Calculates the range of scalar values of the given data set
+		{
+		typename ScalarExtractorParam::DestValue values[runLength];
+		size_t totalNumVertices=dataSet.getTotalNumVertices();
+		extractor.getValues(0,1,values);
+		min=max=ScalarParam(values[0]);
+		for(size_t runStart=0;runStart<totalNumVertices;runStart+=runLength)
+			{
+			size_t numValues=totalNumVertices-runStart<runLength?totalNumVertices-runStart:runLength;
+			extractor.getValues(ptrdiff_t(runStart),numValues,values);
+			for(size_t i=0;i<numValues;++i)
+				{
+				ScalarParam v=ScalarParam(values[i]);
+				if(min>v)
+					min=v;
+				else if(max<v)
+					max=v;
+				}
+			}
+		}
+	template <class VectorExtractorParam,class ScalarParam>
+	static void calcVectorMagnitude2Range(const DataSet& dataSet,const VectorExtractorParam& extractor,ScalarParam& min2,ScalarParam& max2) // Calculates the range of squared vector magnitudes of the given data set
+		{
+		typename VectorExtractorParam::DestValue values[runLength];
+		size_t totalNumVertices=dataSet.getTotalNumVertices();
+		extractor.getValues(0,1,values);
+		min2=max2=ScalarParam(Geometry::sqr(values[0]));
+		for(size_t runStart=0;runStart<totalNumVertices;runStart+=runLength)
+			{
+			size_t numValues=totalNumVertices-runStart<runLength?totalNumVertices-runStart:runLength;
+			extractor.getValues(ptrdiff_t(runStart),numValues,values);
+			for(size_t i=0;i<numValues;++i)
+				{
+				ScalarParam v2=ScalarParam(Geometry::sqr(values[i]));
+				if(min2>v2)
+					min2=v2;
+				else if(max2<v2)
+					max2=v2;
+				}
+			}
+		}
+	};
+
+}
+
+}
+
+#endif
@@ -22,17 +22,179 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #define VISUALIZATION_TEMPLATIZED_VOLUMERENDERINGSAMPLER_IMPLEMENTATION
 
-#include <Templatized/VolumeRenderingSampler.h>
-
+#include <vector>
+#include <limits>
 #include <Misc/Utility.h>
+#include <Threads/Mutex.h>
+#include <Threads/Thread.h>
 #include <Comm/MulticastPipe.h>
 
+#include <WorkerThreads.h>
+#include <Templatized/VolumeRenderingSampler.h>
+#include <Templatized/BatchLocator.h>
+
 #include <Abstract/Algorithm.h>
 
 namespace Visualization {
 
 namespace Templatized {
 
+/*********************************************************
+Declaration of struct VolumeRenderingSampler::SamplingJob:
+*********************************************************/
+
+template <class DataSetParam>
+template <class ScalarExtractorParam,class VoxelParam>
+struct VolumeRenderingSampler<DataSetParam>::SamplingJob
+	{
+	/* Embedded classes: */
+	public:
+	typedef VoxelParam Voxel;
+	typedef Visualization::Templatized::BatchLocator<DataSet> BatchLocator; // Type of batch locators for the sampled data set
+	typedef typename BatchLocator::CellHit CellHit;
+	
+	/* Elements: */
+	const VolumeRenderingSampler* sampler; // The sampler defining the resulting Cartesian volume
+	int numChannels; // Number of sampled channels
+	const ScalarExtractorParam* const* scalarExtractors; // Scalar extractors for all channels
+	ScalarQuantizer* const* quantizers; // Quantizers mapping all channels' values to the full voxel range
+	double voxelMax; // Largest voxel value
+	double voxelRound; // Offset to round mapped values to integer voxel values
+	unsigned int numBins; // Number of histogram bins for histogram-equalized channels
+	size_t* histograms; // Histograms of all channels private to this job, or null if no channel is histogram-equalized
+	const Voxel* const* binLevels; // Tables mapping histogram bins to voxel values for all channels, or null for channels that are not histogram-equalized
+	Voxel* const* voxels; // Voxel blocks for all channels
+	const ptrdiff_t* voxelStrides; // Voxel block strides shared by all channels
+	const int* dims; // Voxel block dimensions sorted by decreasing stride
+	Threads::Mutex* slabMutex; // Mutex protecting the slab counters
+	unsigned int* nextSlab; // Index of the next unsampled slab
+	unsigned int* numFinishedSlabs; // Number of completely sampled slabs
+	Visualization::Abstract::Algorithm* algorithm; // Algorithm whose busy function to update, or null if the job runs in a background thread
+	float percentageScale,percentageOffset; // Mapping from sampling progress to busy function percentages
+	
+	/* Methods: */
+	void sampleSlab(unsigned int slab,BatchLocator& batchLocator,Point* rowPoints,CellHit* rowHits,double* rowValues) const // Samples one slab of voxels orthogonal to the dimension of largest stride, one row of voxels at a time
+		{
+		const unsigned int* samplerSize=sampler->samplerSize;
+		unsigned int rowSize=samplerSize[dims[2]];
+		
+		/* Initialize the row's sample positions along the dimension of smallest stride: */
+		for(unsigned int i=0;i<rowSize;++i)
+			{
+			rowPoints[i][dims[0]]=sampler->samplerOrigin[dims[0]]+Scalar(slab)*sampler->samplerCellSize[dims[0]];
+			rowPoints[i][dims[2]]=sampler->samplerOrigin[dims[2]]+Scalar(i)*sampler->samplerCellSize[dims[2]];
+			}
+		
+		ptrdiff_t offset1=ptrdiff_t(slab)*voxelStrides[dims[0]];
+		for(unsigned int i1=0;i1<samplerSize[dims[1]];++i1,offset1+=voxelStrides[dims[1]])
+			{
+			/* Locate all grid points of the row at once: */
+			Scalar rowPos=sampler->samplerOrigin[dims[1]]+Scalar(i1)*sampler->samplerCellSize[dims[1]];
+			for(unsigned int i=0;i<rowSize;++i)
+				rowPoints[i][dims[1]]=rowPos;
+			batchLocator.locatePoints(rowPoints,rowSize,rowHits);
+			
+			for(int channel=0;channel<numChannels;++channel)
+				{
+				/* Evaluate the channel's scalar values at the row's grid points: */
+				batchLocator.calcValues(rowHits,rowSize,*scalarExtractors[channel],rowValues);
+				
+				ptrdiff_t offset2=offset1;
+				for(unsigned int i2=0;i2<rowSize;++i2,offset2+=voxelStrides[dims[2]])
+					{
+					if(rowHits[i2].valid)
+						{
+						double value=rowValues[i2];
+						if(quantizers[channel]->getMode()==ScalarQuantizer::HISTOGRAM_EQUALIZED)
+							{
+							/* Store the value's histogram bin until the histogram is complete: */
+							unsigned int bin=quantizers[channel]->calcBin(value,numBins);
+							++histograms[channel*numBins+bin];
+							voxels[channel][offset2]=Voxel(bin);
+							}
+						else
+							{
+							/* Map the value to the voxel range: */
+							voxels[channel][offset2]=Voxel(quantizers[channel]->map(value)*voxelMax+voxelRound);
+							}
+						}
+					else
+						{
+						/* Assign a default value: */
+						voxels[channel][offset2]=Voxel(0);
+						}
+					}
+				}
+			}
+		}
+	void* sampleThreadMethod(void)
+		{
+		/* Create a batch locator and row buffers private to this thread; rows of grid points are already coherent and need not be sorted: */
+		BatchLocator batchLocator(sampler->dataSet.getLocator());
+		batchLocator.setSortQueries(false);
+		unsigned int rowSize=sampler->samplerSize[dims[2]];
+		std::vector<Point> rowPoints(rowSize);
+		std::vector<CellHit> rowHits(rowSize);
+		std::vector<double> rowValues(rowSize);
+		
+		while(true)
+			{
+			/* Grab the next slab: */
+			unsigned int slab;
+			{
+			Threads::Mutex::Lock slabLock(*slabMutex);
+			slab=(*nextSlab)++;
+			}
+			if(slab>=sampler->samplerSize[dims[0]])
+				break;
+			
+			/* Sample the slab: */
+			sampleSlab(slab,batchLocator,&rowPoints[0],&rowHits[0],&rowValues[0]);
+			
+			/* Update the progress counter, and the busy dialog if this job runs in the main thread: */
+			unsigned int finished;
+			{
+			Threads::Mutex::Lock slabLock(*slabMutex);
+			finished=++(*numFinishedSlabs);
+			}
+			if(algorithm!=0)
+				algorithm->callBusyFunction(float(finished)*percentageScale/float(sampler->samplerSize[dims[0]])+percentageOffset);
+			}
+		
+		return 0;
+		}
+	void* equalizeThreadMethod(void)
+		{
+		const unsigned int* samplerSize=sampler->samplerSize;
+		while(true)
+			{
+			/* Grab the next slab: */
+			unsigned int slab;
+			{
+			Threads::Mutex::Lock slabLock(*slabMutex);
+			slab=(*nextSlab)++;
+			}
+			if(slab>=samplerSize[dims[0]])
+				break;
+			
+			/* Replace the histogram bins stored in the slab's voxels by their equalized voxel values: */
+			for(int channel=0;channel<numChannels;++channel)
+				if(binLevels[channel]!=0)
+					{
+					Voxel* base1=voxels[channel]+ptrdiff_t(slab)*voxelStrides[dims[0]];
+					for(unsigned int i1=0;i1<samplerSize[dims[1]];++i1,base1+=voxelStrides[dims[1]])
+						{
+						Voxel* base2=base1;
+						for(unsigned int i2=0;i2<samplerSize[dims[2]];++i2,base2+=voxelStrides[dims[2]])
+							*base2=binLevels[channel][size_t(*base2)];
+						}
+					}
+			}
+		
+		return 0;
+		}
+	};
+
 /***************************************
 Methods of class VolumeRenderingSampler:
 ***************************************/
@@ -40,8 +202,10 @@ Methods of class VolumeRenderingSampler:
 template <class DataSetParam>
 inline
 VolumeRenderingSampler<DataSetParam>::VolumeRenderingSampler(
-	const typename VolumeRenderingSampler<DataSetParam>::DataSet& sDataSet)
-	:dataSet(sDataSet)
+	const typename VolumeRenderingSampler<DataSetParam>::DataSet& sDataSet,
+	unsigned int maxSamplerSize)
+	:dataSet(sDataSet),
+	 numThreads(0)
 	{
 	/* Calculate the optimal Cartesian volume size: */
 	samplerOrigin=dataSet.getDomainBox().getOrigin();
@@ -51,7 +215,7 @@ VolumeRenderingSampler<DataSetParam>::VolumeRenderingSampler(
 		{
 		/* Find a power-of-two grid size that approximates the data set's average cell size: */
 		Scalar optSize=Scalar(2)*boxSize[i]/avgCellSize;
-		for(samplerSize[i]=2;samplerSize[i]<512&&Scalar(samplerSize[i])*Math::sqrt(Scalar(2))<optSize;samplerSize[i]<<=1)
+		for(samplerSize[i]=2;samplerSize[i]<maxSamplerSize&&Scalar(samplerSize[i])*Math::sqrt(Scalar(2))<optSize;samplerSize[i]<<=1)
 			;
 		samplerCellSize[i]=boxSize[i]/Scalar(samplerSize[i]-1);
 		}
@@ -63,6 +227,7 @@ inline
 void
 VolumeRenderingSampler<DataSetParam>::sample(
 	const ScalarExtractorParam& scalarExtractor,
+	ScalarQuantizer& quantizer,
 	VoxelParam* voxels,
 	const ptrdiff_t voxelStrides[3],
 	Comm::MulticastPipe* pipe,
@@ -70,8 +235,28 @@ VolumeRenderingSampler<DataSetParam>::sample(
 	float percentageOffset,
 	Visualization::Abstract::Algorithm* algorithm) const
 	{
-	typedef typename ScalarExtractorParam::Scalar VScalar;
+	const ScalarExtractorParam* scalarExtractors[1]={&scalarExtractor};
+	ScalarQuantizer* quantizers[1]={&quantizer};
+	sample(1,scalarExtractors,quantizers,&voxels,voxelStrides,pipe,percentageScale,percentageOffset,algorithm);
+	}
+
+template <class DataSetParam>
+template <class ScalarExtractorParam,class VoxelParam>
+inline
+void
+VolumeRenderingSampler<DataSetParam>::sample(
+	int numChannels,
+	const ScalarExtractorParam* const scalarExtractors[],
+	ScalarQuantizer* const quantizers[],
+	VoxelParam* const voxels[],
+	const ptrdiff_t voxelStrides[3],
+	Comm::MulticastPipe* pipe,
+	float percentageScale,
+	float percentageOffset,
+	Visualization::Abstract::Algorithm* algorithm) const
+	{
 	typedef VoxelParam Voxel;
+	typedef SamplingJob<ScalarExtractorParam,VoxelParam> Job;
 	
 	/* Sort the voxel block's dimensions according to their stride values: */
 	int dims[3];
@@ -84,87 +269,178 @@ VolumeRenderingSampler<DataSetParam>::sample(
 	if(voxelStrides[dims[0]]<voxelStrides[dims[1]])
 		Misc::swap(dims[0],dims[1]);
 	
+	/* Histogram-equalized channels store histogram bins in the voxel range during sampling: */
+	unsigned int numBins=std::numeric_limits<Voxel>::is_integer&&double(std::numeric_limits<Voxel>::max())<65536.0?(unsigned int)(std::numeric_limits<Voxel>::max())+1U:65536U;
+	bool equalize=false;
+	for(int channel=0;channel<numChannels;++channel)
+		if(quantizers[channel]->getMode()==ScalarQuantizer::HISTOGRAM_EQUALIZED)
+			equalize=true;
+	
 	/* Sample volume data on the master, and receive results on the slaves: */
 	Voxel* spanBuffer=0;
 	if(pipe!=0)
 		spanBuffer=new Voxel[samplerSize[dims[2]]];
 	if(pipe==0||pipe->isMaster())
 		{
-		/* Determine the data set's value range: */
-		VScalar minValue,maxValue;
-		typename DataSet::VertexIterator vIt=dataSet.beginVertices();
-		minValue=maxValue=vIt->getValue(scalarExtractor);
-		for(++vIt;vIt!=dataSet.endVertices();++vIt)
+		/* Quantization levels map to the full range of integer voxel types, or to [0, 1] for floating-point voxel types: */
+		double voxelMax=std::numeric_limits<Voxel>::is_integer?double(std::numeric_limits<Voxel>::max()):1.0;
+		double voxelRound=std::numeric_limits<Voxel>::is_integer?0.5:0.0;
+		
+		/* Determine the number of sampling threads: */
+		int numSamplingThreads=getNumWorkerThreads(numThreads);
+		if(numSamplingThreads>int(samplerSize[dims[0]]))
+			numSamplingThreads=int(samplerSize[dims[0]]);
+		
+		/* Keep this thread from being cancelled while the workers use its stack: */
+		WorkerThreadSection workerThreadSection;
+		
+		/* Create one sampling job per thread, each handing out slabs from the same counter: */
+		Threads::Mutex slabMutex;
+		unsigned int nextSlab=0;
+		unsigned int numFinishedSlabs=0;
+		Job* jobs=new Job[numSamplingThreads];
+		for(int i=0;i<numSamplingThreads;++i)
 			{
-			VScalar value=vIt->getValue(scalarExtractor);
-			if(minValue>value)
-				minValue=value;
-			if(maxValue<value)
-				maxValue=value;
+			jobs[i].sampler=this;
+			jobs[i].numChannels=numChannels;
+			jobs[i].scalarExtractors=scalarExtractors;
+			jobs[i].quantizers=quantizers;
+			jobs[i].voxelMax=voxelMax;
+			jobs[i].voxelRound=voxelRound;
+			jobs[i].numBins=numBins;
+			jobs[i].histograms=0;
+			if(equalize)
+				{
+				jobs[i].histograms=new size_t[size_t(numChannels)*size_t(numBins)];
+				for(size_t j=0;j<size_t(numChannels)*size_t(numBins);++j)
+					jobs[i].histograms[j]=0;
+				}
+			jobs[i].binLevels=0;
+			jobs[i].voxels=voxels;
+			jobs[i].voxelStrides=voxelStrides;
+			jobs[i].dims=dims;
+			jobs[i].slabMutex=&slabMutex;
+			jobs[i].nextSlab=&nextSlab;
+			jobs[i].numFinishedSlabs=&numFinishedSlabs;
+			
+			/* Only the job running in the calling thread may update the busy dialog: */
+			jobs[i].algorithm=i==0?algorithm:0;
+			jobs[i].percentageScale=percentageScale;
+			jobs[i].percentageOffset=percentageOffset;
 			}
 		
-		/* Sample the data set's scalar values into the voxel block: */
-		typename DataSet::Locator sampleLocator=dataSet.getLocator();
-		bool sampleValid=false;
-		unsigned int index[3];
-		Point samplePos;
-		Voxel* base0;
-		for(index[dims[0]]=0,samplePos[dims[0]]=samplerOrigin[dims[0]],base0=voxels;index[dims[0]]<samplerSize[dims[0]];++index[dims[0]],samplePos[dims[0]]+=samplerCellSize[dims[0]],base0+=voxelStrides[dims[0]])
+		/* Run the first job in the calling thread, and all others in background threads: */
+		Threads::Thread* threads=new Threads::Thread[numSamplingThreads-1];
+		for(int i=1;i<numSamplingThreads;++i)
+			threads[i-1].start(&jobs[i],&Job::sampleThreadMethod);
+		jobs[0].sampleThreadMethod();
+		for(int i=1;i<numSamplingThreads;++i)
+			threads[i-1].join();
+		
+		if(equalize)
 			{
-			Voxel* base1;
-			for(index[dims[1]]=0,samplePos[dims[1]]=samplerOrigin[dims[1]],base1=base0;index[dims[1]]<samplerSize[dims[1]];++index[dims[1]],samplePos[dims[1]]+=samplerCellSize[dims[1]],base1+=voxelStrides[dims[1]])
+			/* Merge the jobs' histograms and equalize the histogram-equalized channels' quantizers: */
+			Voxel** binLevels=new Voxel*[numChannels];
+			for(int channel=0;channel<numChannels;++channel)
 				{
-				Voxel* base2;
-				for(index[dims[2]]=0,samplePos[dims[2]]=samplerOrigin[dims[2]],base2=base1;index[dims[2]]<samplerSize[dims[2]];++index[dims[2]],samplePos[dims[2]]+=samplerCellSize[dims[2]],base2+=voxelStrides[dims[2]])
+				binLevels[channel]=0;
+				if(quantizers[channel]->getMode()!=ScalarQuantizer::HISTOGRAM_EQUALIZED)
+					continue;
+				
+				size_t* histogram=jobs[0].histograms+size_t(channel)*size_t(numBins);
+				for(int i=1;i<numSamplingThreads;++i)
 					{
-					/* Locate the grid point: */
-					sampleValid=sampleLocator.locatePoint(samplePos,sampleValid);
-					if(sampleValid)
-						{
-						/* Get the vertex' scalar value: */
-						VScalar value=sampleLocator.calcValue(scalarExtractor);
-						*base2=Voxel((value-minValue)*VScalar(255)/(maxValue-minValue)+VScalar(0.5));
-						}
-					else
-						{
-						/* Assign a default value: */
-						*base2=Voxel(0);
-						}
+					const size_t* jobHistogram=jobs[i].histograms+size_t(channel)*size_t(numBins);
+					for(unsigned int bin=0;bin<numBins;++bin)
+						histogram[bin]+=jobHistogram[bin];
 					}
+				quantizers[channel]->setHistogram(numBins,histogram);
 				
-				if(pipe!=0)
+				/* Calculate the voxel value of each histogram bin: */
+				binLevels[channel]=new Voxel[numBins];
+				for(unsigned int bin=0;bin<numBins;++bin)
+					binLevels[channel][bin]=Voxel(quantizers[channel]->calcBinLevel(bin)*voxelMax+voxelRound);
+				}
+			
+			/* Replace all stored histogram bins by their voxel values, using the same threads: */
+			nextSlab=0;
+			for(int i=0;i<numSamplingThreads;++i)
+				jobs[i].binLevels=binLevels;
+			for(int i=1;i<numSamplingThreads;++i)
+				threads[i-1].start(&jobs[i],&Job::equalizeThreadMethod);
+			jobs[0].equalizeThreadMethod();
+			for(int i=1;i<numSamplingThreads;++i)
+				threads[i-1].join();
+			
+			for(int channel=0;channel<numChannels;++channel)
+				delete[] binLevels[channel];
+			delete[] binLevels;
+			for(int i=0;i<numSamplingThreads;++i)
+				delete[] jobs[i].histograms;
+			}
+		delete[] threads;
+		delete[] jobs;
+		
+		/* Update the busy dialog: */
+		algorithm->callBusyFunction(percentageScale+percentageOffset);
+		
+		if(pipe!=0)
+			{
+			/* Write the cumulative distributions of all histogram-equalized channels to the pipe: */
+			for(int channel=0;channel<numChannels;++channel)
+				if(quantizers[channel]->isEqualized())
+					pipe->write<double>(&quantizers[channel]->getCdf()[0],numBins+1);
+			
+			/* Write the resampled data set to the pipe in span order: */
+			for(int channel=0;channel<numChannels;++channel)
+				{
+				unsigned int index[3];
+				Voxel* base0;
+				for(index[dims[0]]=0,base0=voxels[channel];index[dims[0]]<samplerSize[dims[0]];++index[dims[0]],base0+=voxelStrides[dims[0]])
 					{
-					/* Write the most recent span of voxels to the pipe: */
-					base2=base1;
-					for(unsigned int i=0;i<samplerSize[dims[2]];++i,base2+=voxelStrides[dims[2]])
-						spanBuffer[i]=*base2;
-					pipe->write<Voxel>(spanBuffer,samplerSize[dims[2]]);
+					Voxel* base1;
+					for(index[dims[1]]=0,base1=base0;index[dims[1]]<samplerSize[dims[1]];++index[dims[1]],base1+=voxelStrides[dims[1]])
+						{
+						Voxel* base2=base1;
+						for(unsigned int i=0;i<samplerSize[dims[2]];++i,base2+=voxelStrides[dims[2]])
+							spanBuffer[i]=*base2;
+						pipe->write<Voxel>(spanBuffer,samplerSize[dims[2]]);
+						}
 					}
 				}
-			
-			/* Update the busy dialog: */
-			algorithm->callBusyFunction(float(index[dims[0]]+1)*percentageScale/float(samplerSize[dims[0]])+percentageOffset);
 			}
 		}
 	else
 		{
+		/* Receive the cumulative distributions of all histogram-equalized channels from the multicast pipe: */
+		for(int channel=0;channel<numChannels;++channel)
+			if(quantizers[channel]->getMode()==ScalarQuantizer::HISTOGRAM_EQUALIZED)
+				{
+				std::vector<double> cdf(numBins+1);
+				pipe->read<double>(&cdf[0],numBins+1);
+				quantizers[channel]->setCdf(cdf);
+				}
+		
 		/* Receive the resampled data set from the multicast pipe: */
-		unsigned int index[3];
-		Voxel* base0;
-		for(index[dims[0]]=0,base0=voxels;index[dims[0]]<samplerSize[dims[0]];++index[dims[0]],base0+=voxelStrides[dims[0]])
+		for(int channel=0;channel<numChannels;++channel)
 			{
-			Voxel* base1;
-			for(index[dims[1]]=0,base1=base0;index[dims[1]]<samplerSize[dims[1]];++index[dims[1]],base1+=voxelStrides[dims[1]])
+			unsigned int index[3];
+			Voxel* base0;
+			for(index[dims[0]]=0,base0=voxels[channel];index[dims[0]]<samplerSize[dims[0]];++index[dims[0]],base0+=voxelStrides[dims[0]])
 				{
-				/* Read a span of voxels: */
-				pipe->read<VoxelParam>(spanBuffer,samplerSize[dims[2]]);
-				Voxel* base2=base1;
-				for(unsigned int i=0;i<samplerSize[dims[2]];++i,base2+=voxelStrides[dims[2]])
-					*base2=spanBuffer[i];
+				Voxel* base1;
+				for(index[dims[1]]=0,base1=base0;index[dims[1]]<samplerSize[dims[1]];++index[dims[1]],base1+=voxelStrides[dims[1]])
+					{
+					/* Read a span of voxels: */
+					pipe->read<VoxelParam>(spanBuffer,samplerSize[dims[2]]);
+					Voxel* base2=base1;
+					for(unsigned int i=0;i<samplerSize[dims[2]];++i,base2+=voxelStrides[dims[2]])
+						*base2=spanBuffer[i];
+					}
+				
+				/* Update the busy dialog: */
+				algorithm->callBusyFunction((float(channel*samplerSize[dims[0]]+index[dims[0]]+1)*percentageScale)/float(numChannels*samplerSize[dims[0]])+percentageOffset);
 				}
-			
-			/* Update the busy dialog: */
-			algorithm->callBusyFunction(float(index[dims[0]]+1)*percentageScale/float(samplerSize[dims[0]])+percentageOffset);
 			}
 		}
 	if(pipe!=0)
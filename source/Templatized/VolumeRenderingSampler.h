@@ -23,6 +23,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef VISUALIZATION_TEMPLATIZED_VOLUMERENDERINGSAMPLER_INCLUDED
 #define VISUALIZATION_TEMPLATIZED_VOLUMERENDERINGSAMPLER_INCLUDED
 
+#include <stddef.h>
+
+#include <ScalarQuantizer.h>
+
 /* Forward declarations: */
 namespace Comm {
 class MulticastPipe;
@@ -48,24 +52,38 @@ class VolumeRenderingSampler
 	typedef typename DataSet::Box Box; // Type for domain boxes
 	typedef typename Box::Size Size; // Type for domain sizes
 	
-	/* Elements: */
 	private:
+	template <class ScalarExtractorParam,class VoxelParam>
+	struct SamplingJob; // Structure describing one thread's share of a sampling operation
+	
+	/* Elements: */
 	const DataSet& dataSet; // The data set from which the sampler samples
 	unsigned int samplerSize[3]; // Optimal size of the resulting Cartesian volume
 	Point samplerOrigin; // Origin point of the resulting Cartesian volume
 	Size samplerCellSize; // Cell size of the resulting Cartesian volume
+	int numThreads; // Number of sampling threads, or 0 to use one thread per CPU
 	
 	/* Constructors and destructors: */
 	public:
-	VolumeRenderingSampler(const DataSet& sDataSet); // Creates a sampler for the given data set
+	VolumeRenderingSampler(const DataSet& sDataSet,unsigned int maxSamplerSize =512); // Creates a sampler for the given data set whose resulting Cartesian volume has at most the given size along each axis
 	
 	/* Methods: */
 	const unsigned int* getSamplerSize(void) const // Returns the size of the resulting Cartesian volume
 		{
 		return samplerSize;
 		}
+	int getNumThreads(void) const // Returns the number of sampling threads
+		{
+		return numThreads;
+		}
+	void setNumThreads(int newNumThreads) // Sets the number of sampling threads; 0 uses one thread per CPU
+		{
+		numThreads=newNumThreads;
+		}
+	template <class ScalarExtractorParam,class VoxelParam>
+	void sample(const ScalarExtractorParam& scalarExtractor,ScalarQuantizer& quantizer,VoxelParam* voxels,const ptrdiff_t voxelStrides[3],Comm::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples scalar values from the given scalar extractor, mapping them through the given quantizer to the full voxel range, into the given voxel block; integer voxels use their type's full range, floating-point voxels the range [0, 1]; histogram-equalized quantizers receive the sampled values' histogram
 	template <class ScalarExtractorParam,class VoxelParam>
-	void sample(const ScalarExtractorParam& scalarExtractor,VoxelParam* voxels,const ptrdiff_t voxelStrides[3],Comm::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples scalar values from the given scalar extractor into the given voxel block
+	void sample(int numChannels,const ScalarExtractorParam* const scalarExtractors[],ScalarQuantizer* const quantizers[],VoxelParam* const voxels[],const ptrdiff_t voxelStrides[3],Comm::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples several channels of scalar values with identical voxel layouts at once, locating each sample point only once
 	};
 
 }
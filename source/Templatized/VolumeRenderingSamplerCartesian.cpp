@@ -22,6 +22,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #define VISUALIZATION_TEMPLATIZED_VOLUMERENDERINGSAMPLERCARTESIAN_IMPLEMENTATION
 
+#include <vector>
+#include <limits>
+
 #include <Templatized/VolumeRenderingSamplerCartesian.h>
 
 #include <Abstract/Algorithm.h>
@@ -38,8 +41,10 @@ Methods of class VolumeRenderingSamplerCartesian:
 template <class ScalarParam,class ValueParam>
 inline
 VolumeRenderingSampler<Cartesian<ScalarParam,3,ValueParam> >::VolumeRenderingSampler(
-	const typename VolumeRenderingSampler<Cartesian<ScalarParam,3,ValueParam> >::DataSet& sDataSet)
-	:dataSet(sDataSet)
+	const typename VolumeRenderingSampler<Cartesian<ScalarParam,3,ValueParam> >::DataSet& sDataSet,
+	unsigned int)
+	:dataSet(sDataSet),
+	 numThreads(0)
 	{
 	/* Copy the original Cartesian volume size: */
 	for(int i=0;i<3;++i)
@@ -52,6 +57,7 @@ inline
 void
 VolumeRenderingSampler<Cartesian<ScalarParam,3,ValueParam> >::sample(
 	const ScalarExtractorParam& scalarExtractor,
+	ScalarQuantizer& quantizer,
 	VoxelParam* voxels,
 	const ptrdiff_t voxelStrides[3],
 	Comm::MulticastPipe* pipe,
@@ -59,43 +65,96 @@ VolumeRenderingSampler<Cartesian<ScalarParam,3,ValueParam> >::sample(
 	float percentageOffset,
 	Visualization::Abstract::Algorithm* algorithm) const
 	{
-	typedef typename ScalarExtractorParam::Scalar VScalar;
+	const ScalarExtractorParam* scalarExtractors[1]={&scalarExtractor};
+	ScalarQuantizer* quantizers[1]={&quantizer};
+	sample(1,scalarExtractors,quantizers,&voxels,voxelStrides,pipe,percentageScale,percentageOffset,algorithm);
+	}
+
+template <class ScalarParam,class ValueParam>
+template <class ScalarExtractorParam,class VoxelParam>
+inline
+void
+VolumeRenderingSampler<Cartesian<ScalarParam,3,ValueParam> >::sample(
+	int numChannels,
+	const ScalarExtractorParam* const scalarExtractors[],
+	ScalarQuantizer* const quantizers[],
+	VoxelParam* const voxels[],
+	const ptrdiff_t voxelStrides[3],
+	Comm::MulticastPipe* pipe,
+	float percentageScale,
+	float percentageOffset,
+	Visualization::Abstract::Algorithm* algorithm) const
+	{
 	typedef VoxelParam Voxel;
 	
-	/* Determine the data set's value range: */
-	VScalar minValue,maxValue;
-	typename DataSet::VertexIterator vIt=dataSet.beginVertices();
-	minValue=maxValue=vIt->getValue(scalarExtractor);
-	for(++vIt;vIt!=dataSet.endVertices();++vIt)
-		{
-		VScalar value=vIt->getValue(scalarExtractor);
-		if(minValue>value)
-			minValue=value;
-		if(maxValue<value)
-			maxValue=value;
-		}
+	/* Quantization levels map to the full range of integer voxel types, or to [0, 1] for floating-point voxel types: */
+	double voxelMax=std::numeric_limits<Voxel>::is_integer?double(std::numeric_limits<Voxel>::max()):1.0;
+	double voxelRound=std::numeric_limits<Voxel>::is_integer?0.5:0.0;
+	
+	/* Histogram-equalized channels store histogram bins in the voxel range until their histograms are complete: */
+	unsigned int numBins=std::numeric_limits<Voxel>::is_integer&&double(std::numeric_limits<Voxel>::max())<65536.0?(unsigned int)(std::numeric_limits<Voxel>::max())+1U:65536U;
+	std::vector<size_t> histograms;
+	for(int channel=0;channel<numChannels;++channel)
+		if(quantizers[channel]->getMode()==ScalarQuantizer::HISTOGRAM_EQUALIZED)
+			histograms.resize(size_t(numChannels)*size_t(numBins),0);
 	
 	typename DataSet::Index index;
-	Voxel* vPtr0=voxels;
-	for(index[0]=0;index[0]<dataSet.getNumVertices()[0];++index[0],vPtr0+=voxelStrides[0])
+	ptrdiff_t offset0=0;
+	for(index[0]=0;index[0]<dataSet.getNumVertices()[0];++index[0],offset0+=voxelStrides[0])
 		{
-		Voxel* vPtr1=vPtr0;
-		for(index[1]=0;index[1]<dataSet.getNumVertices()[1];++index[1],vPtr1+=voxelStrides[1])
+		ptrdiff_t offset1=offset0;
+		for(index[1]=0;index[1]<dataSet.getNumVertices()[1];++index[1],offset1+=voxelStrides[1])
 			{
-			Voxel* vPtr2=vPtr1;
-			for(index[2]=0;index[2]<dataSet.getNumVertices()[2];++index[2],vPtr2+=voxelStrides[2])
+			ptrdiff_t offset2=offset1;
+			for(index[2]=0;index[2]<dataSet.getNumVertices()[2];++index[2],offset2+=voxelStrides[2])
 				{
-				/* Get the vertex' scalar value: */
-				VScalar value=scalarExtractor.getValue(dataSet.getVertexValue(index));
-				
-				/* Convert the value to unsigned char: */
-				*vPtr2=Voxel((value-minValue)*VScalar(255)/(maxValue-minValue)+VScalar(0.5));
+				/* Get the vertex' value once for all channels: */
+				const typename DataSet::Value& vertexValue=dataSet.getVertexValue(index);
+				for(int channel=0;channel<numChannels;++channel)
+					{
+					double value=double(scalarExtractors[channel]->getValue(vertexValue));
+					if(quantizers[channel]->getMode()==ScalarQuantizer::HISTOGRAM_EQUALIZED)
+						{
+						/* Store the value's histogram bin: */
+						unsigned int bin=quantizers[channel]->calcBin(value,numBins);
+						++histograms[channel*numBins+bin];
+						voxels[channel][offset2]=Voxel(bin);
+						}
+					else
+						{
+						/* Convert the channel's scalar value to the voxel range: */
+						voxels[channel][offset2]=Voxel(quantizers[channel]->map(value)*voxelMax+voxelRound);
+						}
+					}
 				}
 			}
 		
 		/* Update the busy dialog: */
 		algorithm->callBusyFunction(float(index[0]+1)*percentageScale/float(dataSet.getNumVertices()[0])+percentageOffset);
 		}
+	
+	for(int channel=0;channel<numChannels;++channel)
+		if(quantizers[channel]->getMode()==ScalarQuantizer::HISTOGRAM_EQUALIZED)
+			{
+			/* Equalize the channel's quantizer and calculate the voxel value of each histogram bin: */
+			quantizers[channel]->setHistogram(numBins,&histograms[channel*numBins]);
+			std::vector<Voxel> binLevels(numBins);
+			for(unsigned int bin=0;bin<numBins;++bin)
+				binLevels[bin]=Voxel(quantizers[channel]->calcBinLevel(bin)*voxelMax+voxelRound);
+			
+			/* Replace the stored histogram bins by their voxel values: */
+			ptrdiff_t offset0=0;
+			for(index[0]=0;index[0]<dataSet.getNumVertices()[0];++index[0],offset0+=voxelStrides[0])
+				{
+				ptrdiff_t offset1=offset0;
+				for(index[1]=0;index[1]<dataSet.getNumVertices()[1];++index[1],offset1+=voxelStrides[1])
+					{
+					ptrdiff_t offset2=offset1;
+					for(index[2]=0;index[2]<dataSet.getNumVertices()[2];++index[2],offset2+=voxelStrides[2])
+						voxels[channel][offset2]=binLevels[size_t(voxels[channel][offset2])];
+					}
+				}
+			}
 	}
 
 }
@@ -58,18 +58,29 @@ class VolumeRenderingSampler<Cartesian<ScalarParam,3,ValueParam> >
 	private:
 	const DataSet& dataSet; // The data set from which the sampler samples
 	unsigned int samplerSize[3]; // Size of the Cartesian volume
+	int numThreads; // Number of sampling threads; ignored, as vertex values are copied directly
 	
 	/* Constructors and destructors: */
 	public:
-	VolumeRenderingSampler(const DataSet& sDataSet); // Creates a sampler for the given data set
+	VolumeRenderingSampler(const DataSet& sDataSet,unsigned int maxSamplerSize =512); // Creates a sampler for the given data set; the Cartesian volume always has the data set's size
 	
 	/* Methods: */
 	const unsigned int* getSamplerSize(void) const // Returns the size of the Cartesian volume
 		{
 		return samplerSize;
 		}
+	int getNumThreads(void) const // Returns the number of sampling threads
+		{
+		return numThreads;
+		}
+	void setNumThreads(int newNumThreads) // Sets the number of sampling threads
+		{
+		numThreads=newNumThreads;
+		}
+	template <class ScalarExtractorParam,class VoxelParam>
+	void sample(const ScalarExtractorParam& scalarExtractor,ScalarQuantizer& quantizer,VoxelParam* voxels,const ptrdiff_t voxelStrides[3],Comm::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples scalar values from the given scalar extractor, mapping them through the given quantizer to the full voxel range, into the given voxel block
 	template <class ScalarExtractorParam,class VoxelParam>
-	void sample(const ScalarExtractorParam& scalarExtractor,VoxelParam* voxels,const ptrdiff_t voxelStrides[3],Comm::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples scalar values from the given scalar extractor into the given voxel block
+	void sample(int numChannels,const ScalarExtractorParam* const scalarExtractors[],ScalarQuantizer* const quantizers[],VoxelParam* const voxels[],const ptrdiff_t voxelStrides[3],Comm::MulticastPipe* pipe,float percentageScale,float percentageOffset,Visualization::Abstract::Algorithm* algorithm) const; // Samples several channels of scalar values with identical voxel layouts at once
 	};
 
 }
@@ -34,7 +34,6 @@ Methods of class TripleChannelRaycaster::DataItem:
 
 TripleChannelRaycaster::DataItem::DataItem(void)
 	:haveFloatTextures(GLARBTextureFloat::isSupported()),
-	 volumeTextureID(0),volumeTextureVersion(0),
 	 volumeSamplerLoc(-1),channelEnabledsLoc(-1),colorMapSamplersLoc(-1)
 	{
 	for(int channel=0;channel<3;++channel)
@@ -44,17 +43,15 @@ TripleChannelRaycaster::DataItem::DataItem(void)
 	if(haveFloatTextures)
 		GLARBTextureFloat::initExtension();
 	
-	/* Create the volume texture object: */
-	glGenTextures(1,&volumeTextureID);
-	
 	/* Create the color map texture objects: */
 	glGenTextures(3,colorMapTextureIDs);
 	}
 
 TripleChannelRaycaster::DataItem::~DataItem(void)
 	{
-	/* Destroy the volume texture object: */
-	glDeleteTextures(1,&volumeTextureID);
+	/* Destroy the volume texture objects: */
+	if(!volumeTextureIDs.empty())
+		glDeleteTextures(GLsizei(volumeTextureIDs.size()),&volumeTextureIDs[0]);
 	
 	/* Destroy the color map texture objects: */
 	glDeleteTextures(3,colorMapTextureIDs);
@@ -72,14 +69,21 @@ void TripleChannelRaycaster::initDataItem(Raycaster::DataItem* dataItem) const
 	/* Get a pointer to the data item: */
 	DataItem* myDataItem=dynamic_cast<DataItem*>(dataItem);
 	
-	/* Create the data volume texture: */
-	glBindTexture(GL_TEXTURE_3D,myDataItem->volumeTextureID);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_S,GL_CLAMP);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_T,GL_CLAMP);
-	glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_R,GL_CLAMP);
-	glTexImage3DEXT(GL_TEXTURE_3D,0,GL_RGB8,myDataItem->textureSize[0],myDataItem->textureSize[1],myDataItem->textureSize[2],0,GL_RGB,GL_UNSIGNED_BYTE,0);
+	/* Create the bricks' data volume textures: */
+	myDataItem->volumeTextureIDs.resize(bricks.size());
+	myDataItem->volumeTextureVersions.resize(bricks.size(),0);
+	glGenTextures(GLsizei(bricks.size()),&myDataItem->volumeTextureIDs[0]);
+	for(size_t brickIndex=0;brickIndex<bricks.size();++brickIndex)
+		{
+		const GLsizei* textureSize=myDataItem->brickItems[brickIndex].textureSize;
+		glBindTexture(GL_TEXTURE_3D,myDataItem->volumeTextureIDs[brickIndex]);
+		glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_S,GL_CLAMP);
+		glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_T,GL_CLAMP);
+		glTexParameteri(GL_TEXTURE_3D,GL_TEXTURE_WRAP_R,GL_CLAMP);
+		glTexImage3DEXT(GL_TEXTURE_3D,0,GL_RGB8,textureSize[0],textureSize[1],textureSize[2],0,GL_RGB,GL_UNSIGNED_BYTE,0);
+		}
 	glBindTexture(GL_TEXTURE_3D,0);
 	
 	/* Create the color map textures: */
@@ -115,21 +119,9 @@ void TripleChannelRaycaster::bindShader(const Raycaster::PTransform& pmv,const R
 	/* Get a pointer to the data item: */
 	DataItem* myDataItem=dynamic_cast<DataItem*>(dataItem);
 	
-	/* Bind the volume texture: */
-	glActiveTextureARB(GL_TEXTURE1_ARB);
-	glBindTexture(GL_TEXTURE_3D,myDataItem->volumeTextureID);
+	/* Select the texture unit for the bricks' volume textures: */
 	glUniform1iARB(myDataItem->volumeSamplerLoc,1);
 	
-	/* Check if the volume texture needs to be updated: */
-	if(myDataItem->volumeTextureVersion!=dataVersion)
-		{
-		/* Upload the new volume data: */
-		glTexSubImage3DEXT(GL_TEXTURE_3D,0,0,0,0,dataSize[0],dataSize[1],dataSize[2],GL_RGB,GL_UNSIGNED_BYTE,data);
-		
-		/* Mark the volume texture as up-to-date: */
-		myDataItem->volumeTextureVersion=dataVersion;
-		}
-	
 	/* Bind the color map textures: */
 	GLint colorMapSamplers[3];
 	GLint channelEnabledsValues[3];
@@ -140,7 +132,7 @@ void TripleChannelRaycaster::bindShader(const Raycaster::PTransform& pmv,const R
 		glActiveTextureARB(GL_TEXTURE2_ARB+channel);
 		glBindTexture(GL_TEXTURE_1D,myDataItem->colorMapTextureIDs[channel]);
 		colorMapSamplers[channel]=2+channel;
-
+		
 		/* Create the stepsize-adjusted colormap with pre-multiplied alpha: */
 		GLColorMap adjustedColorMap(*colorMaps[channel]);
 		adjustedColorMap.changeTransparency(stepSize*transparencyGammas[channel]);
@@ -151,6 +143,30 @@ void TripleChannelRaycaster::bindShader(const Raycaster::PTransform& pmv,const R
 	glUniform1ivARB(myDataItem->colorMapSamplersLoc,3,colorMapSamplers);
 	}
 
+void TripleChannelRaycaster::bindBrick(int brickIndex,Raycaster::DataItem* dataItem) const
+	{
+	/* Call the base class method: */
+	Raycaster::bindBrick(brickIndex,dataItem);
+	
+	/* Get a pointer to the data item: */
+	DataItem* myDataItem=dynamic_cast<DataItem*>(dataItem);
+	
+	/* Bind the brick's volume texture: */
+	glActiveTextureARB(GL_TEXTURE1_ARB);
+	glBindTexture(GL_TEXTURE_3D,myDataItem->volumeTextureIDs[brickIndex]);
+	
+	/* Check if the brick's volume texture needs to be updated: */
+	if(myDataItem->volumeTextureVersions[brickIndex]!=dataVersion)
+		{
+		/* Upload the brick's new volume data: */
+		const Brick& brick=bricks[brickIndex];
+		uploadBrick(brickIndex,GL_RGB,GL_UNSIGNED_BYTE,data+(brick.origin[0]*dataStrides[0]+brick.origin[1]*dataStrides[1]+brick.origin[2]*dataStrides[2]));
+		
+		/* Mark the brick's volume texture as up-to-date: */
+		myDataItem->volumeTextureVersions[brickIndex]=dataVersion;
+		}
+	}
+
 void TripleChannelRaycaster::unbindShader(Raycaster::DataItem* dataItem) const
 	{
 	/* Unbind the color map textures: */
@@ -168,8 +184,8 @@ void TripleChannelRaycaster::unbindShader(Raycaster::DataItem* dataItem) const
 	Raycaster::unbindShader(dataItem);
 	}
 
-TripleChannelRaycaster::TripleChannelRaycaster(const unsigned int sDataSize[3],const Raycaster::Box& sDomain)
-	:Raycaster(sDataSize,sDomain),
+TripleChannelRaycaster::TripleChannelRaycaster(const unsigned int sDataSize[3],const Raycaster::Box& sDomain,unsigned int sMaxBrickSize)
+	:Raycaster(sDataSize,sDomain,sMaxBrickSize),
 	 data(new Voxel[dataSize[0]*dataSize[1]*dataSize[2]*3]),dataVersion(0)
 	{
 	/* Multiply the data stride values with the number of channels: */
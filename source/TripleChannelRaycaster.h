@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef TRIPLECHANNELRAYCASTER_INCLUDED
 #define TRIPLECHANNELRAYCASTER_INCLUDED
 
+#include <vector>
 #include <GL/gl.h>
 #include <GL/GLColor.h>
 #include <GL/GLColorMap.h>
@@ -32,17 +33,18 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 class TripleChannelRaycaster:public Raycaster
 	{
 	/* Embedded classes: */
-	protected:
+	public:
 	typedef GLubyte Voxel; // Type for voxel data
 	
+	protected:
 	struct DataItem:public Raycaster::DataItem
 		{
 		/* Elements: */
 		public:
 		bool haveFloatTextures; // Flag whether the local OpenGL supports floating-point textures
 		
-		GLuint volumeTextureID; // Texture object ID for volume data texture
-		unsigned int volumeTextureVersion; // Version number of volume data texture
+		std::vector<GLuint> volumeTextureIDs; // Texture object IDs for the volume data textures of all bricks
+		std::vector<unsigned int> volumeTextureVersions; // Version numbers of the volume data textures of all bricks
 		GLuint colorMapTextureIDs[3]; // Texture object IDs for per-channel stepsize-adjusted color map textures
 		
 		int volumeSamplerLoc; // Location of the volume data texture sampler
@@ -67,11 +69,12 @@ class TripleChannelRaycaster:public Raycaster
 	virtual void initDataItem(Raycaster::DataItem* dataItem) const;
 	virtual void initShader(Raycaster::DataItem* dataItem) const;
 	virtual void bindShader(const PTransform& pmv,const PTransform& mv,Raycaster::DataItem* dataItem) const;
+	virtual void bindBrick(int brickIndex,Raycaster::DataItem* dataItem) const;
 	virtual void unbindShader(Raycaster::DataItem* dataItem) const;
 	
 	/* Constructors and destructors: */
 	public:
-	TripleChannelRaycaster(const unsigned int sDataSize[3],const Box& sDomain); // Creates a volume renderer
+	TripleChannelRaycaster(const unsigned int sDataSize[3],const Box& sDomain,unsigned int sMaxBrickSize =512); // Creates a volume renderer
 	virtual ~TripleChannelRaycaster(void); // Destroys the raycaster
 	
 	/* Methods from GLObject: */
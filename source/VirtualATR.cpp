@@ -5,6 +5,8 @@
  */
 
 #include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdexcept>
 #include <vector>
@@ -62,6 +64,7 @@
 #include <ANALYSIS/ClippingPlaneLocator.h>
 #include <ANALYSIS/CuttingPlane.h>
 #include <ANALYSIS/CuttingPlaneLocator.h>
+#include <ANALYSIS/Extractor.h>
 #include <ANALYSIS/ExtractorLocator.h>
 #include <ANALYSIS/ScalarEvaluationLocator.h>
 #include <ANALYSIS/VectorEvaluationLocator.h>
@@ -141,26 +144,20 @@ VirtualATR::DataItem::~DataItem(void) {
  */
 VirtualATR::VirtualATR(int& argc, char**& argv, char**& appDefaults) :
 	Vrui::Application(argc, argv, appDefaults), algorithm(0), analysisTool(0),
-	clippingPlanes(0), coordinateTransformer(0), cuttingPlanes(0), dataSet(0), dataSetRenderer(0), elementList(0), firstScalarAlgorithmIndex(0), firstVectorAlgorithmIndex(0), inLoadElements(false), inLoadPalette(false), mainMenu(0), module(0), moduleManager(VIRTUALATR_MODULENAMETEMPLATE), numberOfClippingPlanes(0), numberOfCuttingPlanes(0), renderDialog(0), osccDialog(0), showElementListToggle(0), variableManager(0) {
+	clippingPlanes(0), coordinateTransformer(0), cuttingPlanes(0), dataSet(0), dataSetRenderer(0), elementList(0), firstScalarAlgorithmIndex(0), firstVectorAlgorithmIndex(0), inLoadElements(false), inLoadPalette(false), mainMenu(0), module(0), moduleManager(VIRTUALATR_MODULENAMETEMPLATE), numberOfClippingPlanes(0), numberOfCuttingPlanes(0), renderDialog(0), osccDialog(0), stepDialog(0), stepNameLabel(0), requestedStep(0), pendingStep(-1), stepPipe(0), showElementListToggle(0), variableManager(0) {
 
 	/* Create the ATR Scene */
+	Misc::Timer modelTimer;
 	atr = new ATR();
 	atr->config();
+	modelTimer.elapse();
+	if (Vrui::isMaster())
+		std::cout << "Time to load facility models: " << modelTimer.getTime()
+				* 1000.0 << " ms" << std::endl;
 	atr->toggleClear_Vessel();
-	atr->toggleOSCC_5();
-	atr->toggleOSCC_85();
-	atr->toggleOSCC_120();
-	atr->toggleOSCC_155();
-	atr->toggleOSCC_30_85_85_85();
-	atr->toggleOSCC_40_85_85_85();
-	atr->toggleOSCC_50_85_85_85();
-	atr->toggleOSCC_60_85_85_85();
-	atr->toggleOSCC_70_85_85_85();
-	atr->toggleOSCC_80_85_85_85();
-	atr->toggleOSCC_90_85_85_85();
-	atr->toggleOSCC_100_85_85_85();
-	atr->toggleOSCC_110_85_85_85();
-	atr->toggleOSCC_120_85_85_85();
+	/* Show the drums in the default configuration */
+	atr->setOSCCConfiguration(ATR::OSCC_51_8);
+	atr->setOSCCVisible(true);
 
 	/* Initialize Clippling Planes */
 	numberOfClippingPlanes = 6;
@@ -175,6 +172,9 @@ VirtualATR::VirtualATR(int& argc, char**& argv, char**& appDefaults) :
 	std::vector<std::string> dataSetArgs;
 	const char* argColorMapName=0;
 	std::vector<const char*> loadFileNames;
+	std::vector<std::pair<std::string,std::string> > derivedVariables;
+	std::vector<std::string> compareDataSetArgs;
+	std::vector<std::string> compareVariableNames;
 	for(int i=1;i<argc;++i)
 		{
 		if(argv[i][0]=='-')
@@ -212,6 +212,47 @@ VirtualATR::VirtualATR(int& argc, char**& argv, char**& appDefaults) :
 				else
 					std::cerr<<"Missing element file name after -load"<<std::endl;
 				}
+			else if(strcasecmp(argv[i]+1,"compare")==0)
+				{
+				/* Get the data set arguments of a second data set to compare against: */
+				++i;
+				while(i<argc&&strcmp(argv[i],";")!=0)
+					{
+					compareDataSetArgs.push_back(argv[i]);
+					++i;
+					}
+				}
+			else if(strcasecmp(argv[i]+1,"compareVariable")==0)
+				{
+				++i;
+				if(i<argc)
+					compareVariableNames.push_back(argv[i]);
+				else
+					std::cerr<<"Missing variable name after -compareVariable"<<std::endl;
+				}
+			else if(strcasecmp(argv[i]+1,"drumAngles")==0)
+				{
+				if(i+ATR::NUM_OSCC_QUADRANTS<argc)
+					{
+					/* Set the drum angles of the NW, NE, SE, and SW quadrants: */
+					for(int quadrant=0;quadrant<ATR::NUM_OSCC_QUADRANTS;++quadrant)
+						atr->setOSCCAngle(ATR::OSCCQuadrant(quadrant),atof(argv[i+1+quadrant]));
+					}
+				else
+					std::cerr<<"Missing drum angles after -drumAngles"<<std::endl;
+				i+=ATR::NUM_OSCC_QUADRANTS;
+				}
+			else if(strcasecmp(argv[i]+1,"derive")==0)
+				{
+				i+=2;
+				if(i<argc)
+					{
+					/* Define a derived variable after the data set is loaded: */
+					derivedVariables.push_back(std::pair<std::string,std::string>(argv[i-1],argv[i]));
+					}
+				else
+					std::cerr<<"Missing variable name or expression after -derive"<<std::endl;
+				}
 			}
 		else
 			{
@@ -265,6 +306,79 @@ VirtualATR::VirtualATR(int& argc, char**& argv, char**& appDefaults) :
 		Misc::throwStdErr("VirtualATR::VirtualATR: Could not load data set due to exception %s",err.what());
 		}
 	
+	/* Resample the comparison data set onto the data set's grid and define difference variables: */
+	if(!compareDataSetArgs.empty())
+		{
+		Visualization::Abstract::DataSet* compareDataSet=0;
+		std::vector<std::pair<std::string,std::string> > differenceVariables;
+		try
+			{
+			Misc::Timer t;
+			Comm::MulticastPipe* pipe=Vrui::openPipe(); // Implicit synchronization point
+			try
+				{
+				compareDataSet=module->load(compareDataSetArgs,pipe);
+				}
+			catch(...)
+				{
+				/* Close the pipe before bailing out: */
+				delete pipe;
+				throw;
+				}
+			delete pipe; // Implicit synchronization point
+			
+			/* Compare the first scalar variable by default: */
+			if(compareVariableNames.empty()&&dataSet->getNumScalarVariables()>0)
+				compareVariableNames.push_back(dataSet->getScalarVariableName(0));
+			for(std::vector<std::string>::const_iterator cvIt=compareVariableNames.begin();cvIt!=compareVariableNames.end();++cvIt)
+				{
+				/* Find the variable in the comparison data set: */
+				int compareVariableIndex;
+				for(compareVariableIndex=0;compareVariableIndex<compareDataSet->getNumScalarVariables();++compareVariableIndex)
+					if(*cvIt==compareDataSet->getScalarVariableName(compareVariableIndex))
+						break;
+				if(compareVariableIndex==compareDataSet->getNumScalarVariables())
+					{
+					std::cerr<<"Comparison data set has no variable "<<*cvIt<<std::endl;
+					continue;
+					}
+				
+				/* Add the resampled variable B, and the differences to the data set's variable A: */
+				std::string a="["+*cvIt+"]";
+				std::string b="["+*cvIt+" (B)]";
+				dataSet->addResampledScalarVariable((*cvIt+" (B)").c_str(),compareDataSet,compareVariableIndex);
+				differenceVariables.push_back(std::pair<std::string,std::string>(*cvIt+" (A-B)",a+"-"+b));
+				differenceVariables.push_back(std::pair<std::string,std::string>(*cvIt+" (A-B)/A","if(abs("+a+")>0,("+a+"-"+b+")/"+a+",0)"));
+				}
+			t.elapse();
+			if(Vrui::isMaster())
+				std::cout<<"Time to load and resample comparison data set: "<<t.getTime()*1000.0<<" ms"<<std::endl;
+			}
+		catch(std::runtime_error err)
+			{
+			/* Fail on all nodes alike instead of continuing with a partially defined set of variables: */
+			delete compareDataSet;
+			Misc::throwStdErr("VirtualATR::VirtualATR: Could not compare against data set due to exception %s",err.what());
+			}
+		delete compareDataSet;
+		
+		/* Define the difference variables before any user-defined variables, which can refer to them: */
+		derivedVariables.insert(derivedVariables.begin(),differenceVariables.begin(),differenceVariables.end());
+		}
+	
+	/* Define derived variables; their values are computed when they are first used: */
+	for(std::vector<std::pair<std::string,std::string> >::const_iterator dvIt=derivedVariables.begin();dvIt!=derivedVariables.end();++dvIt)
+		{
+		try
+			{
+			dataSet->addDerivedScalarVariable(dvIt->first.c_str(),dvIt->second.c_str());
+			}
+		catch(std::runtime_error err)
+			{
+			std::cerr<<"Could not define derived variable "<<dvIt->first<<" due to exception "<<err.what()<<std::endl;
+			}
+		}
+	
        	/* Create a variable manager: */
 	variableManager=new VariableManager(dataSet,argColorMapName);
 
@@ -312,6 +426,14 @@ VirtualATR::VirtualATR(int& argc, char**& argv, char**& appDefaults) :
 	Vrui::setMainMenu(mainMenu);
 	renderDialog = createRenderDialog();
 	osccDialog = createOSCCDialog();
+	updateOSCCWidgets();
+	if(dataSet->getNumSteps()>1)
+		{
+		stepDialog = createStepDialog();
+
+		/* Open a pipe for the master to tell the slaves when to show a new value step: */
+		stepPipe = Vrui::openPipe();
+		}
 
 	/* Initialize Vrui navigation transformation: */
 //	centerDisplayCallback(0);
@@ -321,10 +443,18 @@ VirtualATR::VirtualATR(int& argc, char**& argv, char**& appDefaults) :
  * ~VirtualATR - Destructor for VirtualATR class.
  */
 VirtualATR::~VirtualATR(void) {
+	/* Stop re-extracting visualization elements: */
+	for(ReextractionList::iterator rIt=reextractions.begin();rIt!=reextractions.end();++rIt)
+		delete rIt->second;
+	for(ExtractorList::iterator aIt=abandonedExtractors.begin();aIt!=abandonedExtractors.end();++aIt)
+		delete *aIt;
+	delete stepPipe;
+
 	/* Delete the user interface: */
 	delete mainMenu;
 	delete renderDialog;
 	delete osccDialog;
+	delete stepDialog;
 } // end ~VirtualATR()
 
 /*******************************
@@ -411,6 +541,24 @@ void VirtualATR::clearElementsCallback(Misc::CallbackData * cbData)
 	elementList->clear();
 	} // end clearElementsCallback()
 
+/*
+ * createAlgorithm
+ * parameter algorithmName - const char*
+ * return - Algorithm *
+ */
+VirtualATR::Algorithm * VirtualATR::createAlgorithm(const char* algorithmName) const
+	{
+	/* Find the module algorithm of the given name; without a pipe, it extracts elements on the local node only: */
+	for(int i=0;i<module->getNumScalarAlgorithms();++i)
+		if(strcmp(algorithmName,module->getScalarAlgorithmName(i))==0)
+			return module->getScalarAlgorithm(i,variableManager,0);
+	for(int i=0;i<module->getNumVectorAlgorithms();++i)
+		if(strcmp(algorithmName,module->getVectorAlgorithmName(i))==0)
+			return module->getVectorAlgorithm(i,variableManager,0);
+
+	return 0;
+	} // end createAlgorithm()
+
 /*
  * createAlgorithmsMenu
  * return - GLMotif::Popup *
@@ -591,6 +739,15 @@ GLMotif::PopupMenu* VirtualATR::createMainMenu(void) {
 	showOSCCDialogToggle->getValueChangedCallbacks().add(this,
 			&VirtualATR::menuToggleSelectCallback);
 
+	if(dataSet->getNumSteps()>1) {
+		/* Create a toggle button to show the value step dialog: */
+		GLMotif::ToggleButton* showStepDialogToggle = new GLMotif::ToggleButton(
+				"showStepDialogToggle", mainMenu, "Show Step Dialog");
+		showStepDialogToggle->setToggle(false);
+		showStepDialogToggle->getValueChangedCallbacks().add(this,
+				&VirtualATR::menuToggleSelectCallback);
+	}
+
 	GLMotif::CascadeButton* renderingModesCascade=new GLMotif::CascadeButton("RenderingModesCascade",mainMenu,"Rendering Modes");
 	renderingModesCascade->setPopup(createRenderingModesMenu());
 
@@ -868,6 +1025,27 @@ GLMotif::PopupWindow * VirtualATR::createOSCCDialog(void) {
 	showOSCC_120_85_85_85ToggleOSCCD->getValueChangedCallbacks().add(this,
 			&VirtualATR::menuToggleSelectCallback);
 
+	/* Create sliders to rotate the drums of each quadrant to arbitrary angles: */
+	static const char * quadrantNames[ATR::NUM_OSCC_QUADRANTS] = { "NW", "NE",
+			"SE", "SW" };
+	for (int quadrant = 0; quadrant < ATR::NUM_OSCC_QUADRANTS; ++quadrant) {
+		char widgetName[40];
+		snprintf(widgetName, sizeof(widgetName), "OSCC%sAngleLabel",
+				quadrantNames[quadrant]);
+		char labelText[40];
+		snprintf(labelText, sizeof(labelText), "%s angle (deg)",
+				quadrantNames[quadrant]);
+		new GLMotif::Label(widgetName, rowColumn, labelText);
+
+		snprintf(widgetName, sizeof(widgetName), "OSCC%sAngleSlider",
+				quadrantNames[quadrant]);
+		osccAngleSliders[quadrant] = new GLMotif::Slider(widgetName, rowColumn,
+				GLMotif::Slider::HORIZONTAL, ss.fontHeight * 10.0f);
+		osccAngleSliders[quadrant]->setValueRange(0.0, 180.0, 0.1);
+		osccAngleSliders[quadrant]->getValueChangedCallbacks().add(this,
+				&VirtualATR::sliderCallback);
+	}
+
 	rowColumn->manageChild();
 
 	return osccDialogPopup;
@@ -1196,6 +1374,40 @@ void VirtualATR::createStandardSaturationPaletteCallback(GLMotif::Menu::EntrySel
 		variableManager->createPalette(VariableManager::SATURATION_RED_CYAN+cbData->menu->getEntryIndex(cbData->selectedButton));
 	} // end createStandardSaturationPaletteCallback()
 
+/*
+ * createStepDialog
+ *
+ * return - GLMotif::PopupWindow *
+ */
+GLMotif::PopupWindow * VirtualATR::createStepDialog(void) {
+	const GLMotif::StyleSheet& ss = *Vrui::getWidgetManager()->getStyleSheet();
+
+	GLMotif::PopupWindow* stepDialogPopup = new GLMotif::PopupWindow(
+			"StepDialogPopup", Vrui::getWidgetManager(), "Value Steps");
+	stepDialogPopup->setResizableFlags(true, false);
+
+	GLMotif::RowColumn* rowColumn = new GLMotif::RowColumn("RowColumn",
+			stepDialogPopup, false);
+	rowColumn->setOrientation(GLMotif::RowColumn::VERTICAL);
+	rowColumn->setPacking(GLMotif::RowColumn::PACK_TIGHT);
+	rowColumn->setNumMinorWidgets(1);
+
+	/* Create a label showing the name of the requested step, such as its drum angle: */
+	stepNameLabel = new GLMotif::Label("StepNameLabel", rowColumn,
+			dataSet->getStepName(requestedStep));
+
+	GLMotif::Slider* stepSlider = new GLMotif::Slider("StepSlider", rowColumn,
+			GLMotif::Slider::HORIZONTAL, ss.fontHeight * 10.0f);
+	stepSlider->setValueRange(0.0, double(dataSet->getNumSteps() - 1), 1.0);
+	stepSlider->setValue(double(requestedStep));
+	stepSlider->getValueChangedCallbacks().add(this,
+			&VirtualATR::sliderCallback);
+
+	rowColumn->manageChild();
+
+	return stepDialogPopup;
+} // end createStepDialog()
+
 /*
  * createVectorVariablesMenu
  * return - GLMotif::Popup *
@@ -1310,6 +1522,36 @@ void VirtualATR::display(GLContextData & glContextData) const {
  * frame
  */
 void VirtualATR::frame(void) {
+	if (stepPipe != 0) {
+		/* The master decides when to show a new value step, such that all nodes show the same step in the same frame: */
+		int newStep = -1;
+		if (Vrui::isMaster()) {
+			/* Stop all extractors once the requested step has been loaded, without waiting for it: */
+			if (pendingStep < 0 && dataSet->getCurrentStep() != requestedStep
+					&& dataSet->isStepLoaded(requestedStep)) {
+				pendingStep = requestedStep;
+				holdExtractors();
+			}
+
+			/* Show the step once the extractors have finished their current elements: */
+			if (pendingStep >= 0 && areExtractorsIdle()) {
+				newStep = pendingStep;
+				pendingStep = -1;
+			} else if (pendingStep >= 0 || dataSet->getCurrentStep() != requestedStep)
+				Vrui::requestUpdate();
+
+			stepPipe->write<int>(newStep);
+			stepPipe->finishMessage();
+		} else
+			newStep = stepPipe->read<int>();
+
+		if (newStep >= 0)
+			showStep(newStep);
+	}
+
+	/* Pick up visualization elements re-extracted for the current value step: */
+	updateReextractions();
+
 	atr->frame();
 } // end frame()
 
@@ -1630,65 +1872,35 @@ void VirtualATR::menuToggleSelectCallback(
 		showClear_VesselToggle->setToggle(callbackData->set);
 		showClear_VesselToggleRD->setToggle(callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_5Toggle") == 0) {
-		atr->toggleOSCC_5();
-		showOSCC_5Toggle->setToggle(callbackData->set);
-		showOSCC_5ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_5, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_51_8Toggle") == 0) {
-		atr->toggleOSCC_51_8();
-		showOSCC_51_8Toggle->setToggle(callbackData->set);
-		showOSCC_51_8ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_51_8, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_85Toggle") == 0) {
-		atr->toggleOSCC_85();
-		showOSCC_85Toggle->setToggle(callbackData->set);
-		showOSCC_85ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_85, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_120Toggle") == 0) {
-		atr->toggleOSCC_120();
-		showOSCC_120Toggle->setToggle(callbackData->set);
-		showOSCC_120ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_120, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_155Toggle") == 0) {
-		atr->toggleOSCC_155();
-		showOSCC_155Toggle->setToggle(callbackData->set);
-		showOSCC_155ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_155, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_30_85_85_85Toggle") == 0) {
-		atr->toggleOSCC_30_85_85_85();
-		showOSCC_30_85_85_85Toggle->setToggle(callbackData->set);
-		showOSCC_30_85_85_85ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_30_85_85_85, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_40_85_85_85Toggle") == 0) {
-		atr->toggleOSCC_40_85_85_85();
-		showOSCC_40_85_85_85Toggle->setToggle(callbackData->set);
-		showOSCC_40_85_85_85ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_40_85_85_85, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_50_85_85_85Toggle") == 0) {
-		atr->toggleOSCC_50_85_85_85();
-		showOSCC_50_85_85_85Toggle->setToggle(callbackData->set);
-		showOSCC_50_85_85_85ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_50_85_85_85, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_60_85_85_85Toggle") == 0) {
-		atr->toggleOSCC_60_85_85_85();
-		showOSCC_60_85_85_85Toggle->setToggle(callbackData->set);
-		showOSCC_60_85_85_85ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_60_85_85_85, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_70_85_85_85Toggle") == 0) {
-		atr->toggleOSCC_70_85_85_85();
-		showOSCC_70_85_85_85Toggle->setToggle(callbackData->set);
-		showOSCC_70_85_85_85ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_70_85_85_85, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_80_85_85_85Toggle") == 0) {
-		atr->toggleOSCC_80_85_85_85();
-		showOSCC_80_85_85_85Toggle->setToggle(callbackData->set);
-		showOSCC_80_85_85_85ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_80_85_85_85, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_90_85_85_85Toggle") == 0) {
-		atr->toggleOSCC_90_85_85_85();
-		showOSCC_90_85_85_85Toggle->setToggle(callbackData->set);
-		showOSCC_90_85_85_85ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_90_85_85_85, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_100_85_85_85Toggle") == 0) {
-		atr->toggleOSCC_100_85_85_85();
-		showOSCC_100_85_85_85Toggle->setToggle(callbackData->set);
-		showOSCC_100_85_85_85ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_100_85_85_85, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_110_85_85_85Toggle") == 0) {
-		atr->toggleOSCC_110_85_85_85();
-		showOSCC_110_85_85_85Toggle->setToggle(callbackData->set);
-		showOSCC_110_85_85_85ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_110_85_85_85, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "showOSCC_120_85_85_85Toggle") == 0) {
-		atr->toggleOSCC_120_85_85_85();
-		showOSCC_120_85_85_85Toggle->setToggle(callbackData->set);
-		showOSCC_120_85_85_85ToggleOSCCD->setToggle(callbackData->set);
+		selectOSCCConfiguration(ATR::OSCC_120_85_85_85, callbackData->set);
 	} else if (strcmp(callbackData->toggle->getName(), "wireframeToggle") == 0) {
 		atr->toggleWireframe();
 		wireframeToggle->setToggle(callbackData->set);
@@ -1719,9 +1931,118 @@ void VirtualATR::menuToggleSelectCallback(
 			/* Close the oscc dialog: */
 			Vrui::popdownPrimaryWidget(osccDialog);
 		}
+	} else if (strcmp(callbackData->toggle->getName(), "showStepDialogToggle")
+			== 0) {
+		if (callbackData->set) {
+			/* Open the step dialog at the same position as the main menu: */
+			Vrui::getWidgetManager()->popupPrimaryWidget(
+					stepDialog,
+					Vrui::getWidgetManager()->calcWidgetTransformation(mainMenu));
+		} else {
+			/* Close the step dialog: */
+			Vrui::popdownPrimaryWidget(stepDialog);
+		}
 	}
 } // end menuToggleSelectCallback()
 
+/*
+ * holdExtractors
+ */
+void VirtualATR::holdExtractors(void)
+	{
+	/* Abandon elements still being re-extracted for the current step, and keep showing their old elements; their extractors may still be extracting, and are only deleted once they are idle: */
+	for(ReextractionList::iterator rIt=reextractions.begin();rIt!=reextractions.end();++rIt)
+		{
+		rIt->second->hold();
+		abandonedExtractors.push_back(rIt->second);
+		}
+	reextractions.clear();
+
+	/* Keep the locators' extractors from starting new elements; their seed requests are processed after the step changed: */
+	for(BaseLocatorList::iterator blIt=baseLocators.begin();blIt!=baseLocators.end();++blIt)
+		{
+		Extractor* extractor=dynamic_cast<Extractor*>(*blIt);
+		if(extractor!=0)
+			extractor->hold();
+		}
+	} // end holdExtractors()
+
+/*
+ * areExtractorsIdle
+ *
+ * return - bool
+ */
+bool VirtualATR::areExtractorsIdle(void)
+	{
+	for(BaseLocatorList::iterator blIt=baseLocators.begin();blIt!=baseLocators.end();++blIt)
+		{
+		Extractor* extractor=dynamic_cast<Extractor*>(*blIt);
+		if(extractor!=0&&!extractor->isIdle())
+			return false;
+		}
+	for(ExtractorList::iterator aIt=abandonedExtractors.begin();aIt!=abandonedExtractors.end();++aIt)
+		if(!(*aIt)->isIdle())
+			return false;
+	return true;
+	} // end areExtractorsIdle()
+
+/*
+ * showStep
+ *
+ * parameter newStep - int
+ */
+void VirtualATR::showStep(int newStep)
+	{
+	/* Slaves stop their extractors now; the master has done so already and waited for them: */
+	holdExtractors();
+	for(BaseLocatorList::iterator blIt=baseLocators.begin();blIt!=baseLocators.end();++blIt)
+		{
+		Extractor* extractor=dynamic_cast<Extractor*>(*blIt);
+		if(extractor!=0)
+			extractor->waitIdle();
+		}
+	for(ExtractorList::iterator aIt=abandonedExtractors.begin();aIt!=abandonedExtractors.end();++aIt)
+		{
+		(*aIt)->waitIdle();
+		delete *aIt;
+		}
+	abandonedExtractors.clear();
+
+	/* Swap the step's values into the data set, and point the shared extractors at them: */
+	dataSet->showStep(newStep);
+	variableManager->updateExtractors();
+
+	/* Let the extractors continue, and re-extract all elements from the new step's values: */
+	for(BaseLocatorList::iterator blIt=baseLocators.begin();blIt!=baseLocators.end();++blIt)
+		{
+		Extractor* extractor=dynamic_cast<Extractor*>(*blIt);
+		if(extractor!=0)
+			extractor->release();
+		}
+	reextractElements();
+	} // end showStep()
+
+/*
+ * reextractElements
+ */
+void VirtualATR::reextractElements(void)
+	{
+	/* Re-extract each element in the background using a copy of its parameters; the old element is shown until its replacement is done: */
+	for(int i=0;i<elementList->getNumElements();++i)
+		{
+		/* Every node re-extracts its own elements, as all nodes load the same value steps: */
+		Algorithm* algorithm=createAlgorithm(elementList->getElementName(i));
+		if(algorithm!=0)
+			{
+			const Element* element=elementList->getElement(i).getPointer();
+			Extractor* extractor=new Extractor(algorithm);
+			extractor->seedRequest(1,element->getParameters()->clone());
+			extractor->finalize(1);
+			reextractions.push_back(std::make_pair(element,extractor));
+			}
+		}
+	} // end reextractElements()
+
 /*
  * saveElementsCallback
  * parameter cbData - Misc::CallbackData *
@@ -1748,6 +2069,23 @@ void VirtualATR::saveElementsCallback(Misc::CallbackData * cbData)
 		}
 	} // end saveElementsCallback()
 
+/*
+ * selectOSCCConfiguration - Shows the drums in a preset configuration, or
+ * hides them if the preset was deselected.
+ *
+ * parameter configuration - int
+ * parameter set - bool
+ */
+void VirtualATR::selectOSCCConfiguration(int configuration, bool set) {
+	if (set) {
+		atr->setOSCCConfiguration(ATR::OSCCConfiguration(configuration));
+		atr->setOSCCVisible(true);
+	} else if (atr->getOSCCConfiguration() == configuration) {
+		atr->setOSCCVisible(false);
+	}
+	updateOSCCWidgets();
+} // end selectOSCCConfiguration()
+
 /*
  * showColorBarCallback
  * parameter cbData - GLMotif::ToggleButton::ValueChangedCallbackData *
@@ -1794,6 +2132,25 @@ void VirtualATR::sliderCallback(
 	} else if (strcmp(callbackData->slider->getName(), "GridTransparencySlider")
 			== 0) {
 		;
+	} else if (strncmp(callbackData->slider->getName(), "OSCC", 4) == 0) {
+		/* Rotate the drums of the slider's quadrant: */
+		for (int quadrant = 0; quadrant < ATR::NUM_OSCC_QUADRANTS; ++quadrant) {
+			if (callbackData->slider == osccAngleSliders[quadrant]) {
+				atr->setOSCCAngle(ATR::OSCCQuadrant(quadrant),
+						callbackData->value);
+			}
+		}
+		atr->setOSCCVisible(true);
+		updateOSCCWidgets();
+	} else if (strcmp(callbackData->slider->getName(), "StepSlider") == 0) {
+		/* Request the new value step; it is shown by frame() once it has been loaded: */
+		int newStep = int(callbackData->value + 0.5);
+		if (newStep != requestedStep) {
+			requestedStep = newStep;
+			dataSet->requestStep(requestedStep);
+			stepNameLabel->setLabel(dataSet->getStepName(requestedStep));
+			Vrui::requestUpdate();
+		}
 	}
 } // end sliderCallback()
 
@@ -1867,6 +2224,66 @@ void VirtualATR::toolDestructionCallback(
 		}
 } // end toolDestructionCallback()
 
+/*
+ * updateOSCCWidgets - Updates the preset toggles and angle sliders to the
+ * current drum state; only the preset matching the drum angles is set.
+ */
+void VirtualATR::updateOSCCWidgets(void) {
+	GLMotif::ToggleButton * presetToggles[ATR::NUM_OSCC_CONFIGURATIONS][2] = {
+			{ showOSCC_5Toggle, showOSCC_5ToggleOSCCD },
+			{ showOSCC_51_8Toggle, showOSCC_51_8ToggleOSCCD },
+			{ showOSCC_85Toggle, showOSCC_85ToggleOSCCD },
+			{ showOSCC_120Toggle, showOSCC_120ToggleOSCCD },
+			{ showOSCC_155Toggle, showOSCC_155ToggleOSCCD },
+			{ showOSCC_30_85_85_85Toggle, showOSCC_30_85_85_85ToggleOSCCD },
+			{ showOSCC_40_85_85_85Toggle, showOSCC_40_85_85_85ToggleOSCCD },
+			{ showOSCC_50_85_85_85Toggle, showOSCC_50_85_85_85ToggleOSCCD },
+			{ showOSCC_60_85_85_85Toggle, showOSCC_60_85_85_85ToggleOSCCD },
+			{ showOSCC_70_85_85_85Toggle, showOSCC_70_85_85_85ToggleOSCCD },
+			{ showOSCC_80_85_85_85Toggle, showOSCC_80_85_85_85ToggleOSCCD },
+			{ showOSCC_90_85_85_85Toggle, showOSCC_90_85_85_85ToggleOSCCD },
+			{ showOSCC_100_85_85_85Toggle, showOSCC_100_85_85_85ToggleOSCCD },
+			{ showOSCC_110_85_85_85Toggle, showOSCC_110_85_85_85ToggleOSCCD },
+			{ showOSCC_120_85_85_85Toggle, showOSCC_120_85_85_85ToggleOSCCD } };
+	int configuration = atr->getOSCCVisible() ? atr->getOSCCConfiguration()
+			: -1;
+	for (int i = 0; i < ATR::NUM_OSCC_CONFIGURATIONS; ++i) {
+		presetToggles[i][0]->setToggle(i == configuration);
+		presetToggles[i][1]->setToggle(i == configuration);
+	}
+	for (int quadrant = 0; quadrant < ATR::NUM_OSCC_QUADRANTS; ++quadrant) {
+		osccAngleSliders[quadrant]->setValue(atr->getOSCCAngle(
+				ATR::OSCCQuadrant(quadrant)));
+	}
+} // end updateOSCCWidgets()
+
+/*
+ * updateReextractions
+ */
+void VirtualATR::updateReextractions(void)
+	{
+	/* Replace the elements whose re-extraction has finished: */
+	ReextractionList::iterator rIt=reextractions.begin();
+	while(rIt!=reextractions.end())
+		{
+		Extractor::ElementPointer newElement=rIt->second->checkUpdates();
+		if(!rIt->second->isFinalizationPending())
+			{
+			/* The element may have been deleted in the meantime: */
+			if(newElement!=0)
+				elementList->replaceElement(rIt->first,newElement.getPointer());
+			delete rIt->second;
+			rIt=reextractions.erase(rIt);
+			}
+		else
+			++rIt;
+		}
+
+	/* Keep checking while elements are being re-extracted: */
+	if(!reextractions.empty())
+		Vrui::requestUpdate();
+	} // end updateReextractions()
+
 /*
  * main - The application main method.
  *
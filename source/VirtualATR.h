@@ -6,6 +6,7 @@
 #ifndef VIRTUALATR_INCLUDED
 #define VIRTUALATR_INCLUDED
 
+#include <utility>
 #include <vector>
 
 #include <GL/gl.h>
@@ -27,6 +28,10 @@ class BaseLocator;
 class ClippingPlane;
 class CuttingPlane;
 class ElementList;
+class Extractor;
+namespace Comm {
+class MulticastPipe;
+}
 namespace Visualization {
 namespace Abstract {
 class Algorithm;
@@ -40,6 +45,7 @@ class VariableManager;
 }
 }
 namespace GLMotif {
+class Label;
 class Popup;
 class PopupMenu;
 class PopupWindow;
@@ -59,6 +65,8 @@ private:
 	typedef Visualization::Abstract::Module Module;
 	typedef Plugins::FactoryManager<Module> ModuleManager;
 	typedef std::vector<BaseLocator*> BaseLocatorList;
+	typedef std::vector<std::pair<const Element*,Extractor*> > ReextractionList;
+	typedef std::vector<Extractor*> ExtractorList;
 
 	friend class BaseLocator;
 	friend class CuttingPlaneLocator;
@@ -121,6 +129,13 @@ private:
 	int numberOfClippingPlanes;
 	GLMotif::PopupWindow* renderDialog;
 	GLMotif::PopupWindow* osccDialog;
+	GLMotif::PopupWindow* stepDialog; // Dialog to select the data set's value step, or 0 if the data set has a single step
+	GLMotif::Label* stepNameLabel; // Label showing the name of the requested value step
+	int requestedStep; // Index of the most recently requested value step
+	int pendingStep; // Index of the loaded value step the master shows once all extractors are idle, or -1
+	Comm::MulticastPipe* stepPipe; // Pipe to broadcast value step changes from the master to the slaves, or 0 if the data set has a single step
+	ReextractionList reextractions; // List of visualization elements being re-extracted for the current value step, with their extractors
+	ExtractorList abandonedExtractors; // Held extractors of abandoned re-extractions, deleted once they are idle before the next value step is shown
 	GLMotif::ToggleButton * lightToggle;
 	GLMotif::ToggleButton * lightToggleRD;
 	GLMotif::ToggleButton * showVesselToggle;
@@ -167,6 +182,7 @@ private:
 	GLMotif::ToggleButton * showOSCC_110_85_85_85ToggleOSCCD;
 	GLMotif::ToggleButton * showOSCC_120_85_85_85Toggle;
 	GLMotif::ToggleButton * showOSCC_120_85_85_85ToggleOSCCD;
+	GLMotif::Slider * osccAngleSliders[4]; // Sliders for the drum angles of the NW, NE, SE, and SW quadrants
 
 	/* Private methods: */
 
@@ -184,6 +200,14 @@ private:
 	GLMotif::PopupMenu * createMainMenu(void);
 	GLMotif::PopupWindow * createRenderDialog(void);
 	GLMotif::PopupWindow * createOSCCDialog(void);
+	GLMotif::PopupWindow * createStepDialog(void);
+	Algorithm * createAlgorithm(const char* algorithmName) const; // Returns a new instance of the named algorithm extracting elements on the local node only, or 0
+	void holdExtractors(void); // Keeps all extractors from starting new visualization elements and abandons running re-extractions, keeping their old elements
+	bool areExtractorsIdle(void); // Returns true if no extractor is working on a visualization element
+	void showStep(int newStep); // Shows the given value step once all extractors are idle, and re-extracts all visualization elements
+	void reextractElements(void); // Starts re-extracting all visualization elements in the background after the value step changed
+	void updateReextractions(void); // Replaces re-extracted visualization elements that have finished
+	void updateOSCCWidgets(void); // Updates the drum preset toggles and angle sliders to the current drum state
 	GLMotif::Popup * createRenderTogglesMenu(void);
 	GLMotif::Popup * createOSCCTogglesMenu(void);
 	GLMotif::Popup * createVesselTogglesMenu(void);
@@ -202,6 +226,7 @@ private:
 	void loadPaletteCancelCallback(GLMotif::FileSelectionDialog::CancelCallbackData* cbData);
 	void loadPaletteOKCallback(GLMotif::FileSelectionDialog::OKCallbackData* cbData);
 	void saveElementsCallback(Misc::CallbackData* cbData);
+	void selectOSCCConfiguration(int configuration, bool set); // Shows the drums in a preset configuration or hides them
 	void showColorBarCallback(GLMotif::ToggleButton::ValueChangedCallbackData* cbData);
 	void showElementListCallback(GLMotif::ToggleButton::ValueChangedCallbackData* cbData);
 	void showPaletteEditorCallback(GLMotif::ToggleButton::ValueChangedCallbackData* cbData);
@@ -0,0 +1,230 @@
+/***********************************************************************
+VoxelBlockIndex - Class to store the minimum and maximum voxel values of
+coarse blocks of a raycaster's volume data, and to classify the blocks
+as fully transparent or not under a color map, to let raycasters skip
+empty space.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <math.h>
+#include <limits>
+#include <Misc/ThrowStdErr.h>
+#include <Threads/Mutex.h>
+#include <Threads/Thread.h>
+#include <GL/GLColorMap.h>
+
+#include <WorkerThreads.h>
+#include <VoxelBlockIndex.h>
+
+/************************************************
+Declaration of struct VoxelBlockIndex::BuildJob:
+************************************************/
+
+struct VoxelBlockIndex::BuildJob
+	{
+	/* Elements: */
+	public:
+	VoxelBlockIndex* index; // The index being built
+	const Voxel* data; // The indexed volume data
+	const ptrdiff_t* dataStrides; // Volume data strides in x, y, z dimensions
+	Threads::Mutex* slabMutex; // Mutex protecting the slab counter
+	unsigned int* nextSlab; // Index of the next unprocessed slab of blocks orthogonal to the z axis
+	
+	/* Methods: */
+	void buildSlab(unsigned int slab) const // Calculates the value ranges of one slab of blocks orthogonal to the z axis
+		{
+		const unsigned int* dataSize=index->dataSize;
+		unsigned int blockSize=index->blockSize;
+		const unsigned int* numBlocks=index->numBlocks;
+		
+		/* Blocks include the voxels on both of their faces along each axis, which they share with their neighbors: */
+		unsigned int z0=slab*blockSize;
+		unsigned int z1=z0+blockSize<dataSize[2]-1?z0+blockSize:dataSize[2]-1;
+		for(unsigned int by=0;by<numBlocks[1];++by)
+			{
+			unsigned int y0=by*blockSize;
+			unsigned int y1=y0+blockSize<dataSize[1]-1?y0+blockSize:dataSize[1]-1;
+			size_t rowIndex=(size_t(slab)*size_t(numBlocks[1])+size_t(by))*size_t(numBlocks[0]);
+			Voxel* rowMins=&index->minValues[rowIndex];
+			Voxel* rowMaxs=&index->maxValues[rowIndex];
+			for(unsigned int bx=0;bx<numBlocks[0];++bx)
+				{
+				rowMins[bx]=std::numeric_limits<Voxel>::max();
+				rowMaxs[bx]=std::numeric_limits<Voxel>::min();
+				}
+			
+			/* Sweep the voxel rows intersecting the row of blocks: */
+			for(unsigned int z=z0;z<=z1;++z)
+				for(unsigned int y=y0;y<=y1;++y)
+					{
+					const Voxel* row=data+(ptrdiff_t(z)*dataStrides[2]+ptrdiff_t(y)*dataStrides[1]);
+					for(unsigned int bx=0;bx<numBlocks[0];++bx)
+						{
+						unsigned int x0=bx*blockSize;
+						unsigned int x1=x0+blockSize<dataSize[0]-1?x0+blockSize:dataSize[0]-1;
+						Voxel min=rowMins[bx];
+						Voxel max=rowMaxs[bx];
+						for(unsigned int x=x0;x<=x1;++x)
+							{
+							Voxel value=row[ptrdiff_t(x)*dataStrides[0]];
+							if(min>value)
+								min=value;
+							if(max<value)
+								max=value;
+							}
+						rowMins[bx]=min;
+						rowMaxs[bx]=max;
+						}
+					}
+			}
+		}
+	void* buildThreadMethod(void)
+		{
+		while(true)
+			{
+			/* Grab the next slab: */
+			unsigned int slab;
+			{
+			Threads::Mutex::Lock slabLock(*slabMutex);
+			slab=(*nextSlab)++;
+			}
+			if(slab>=index->numBlocks[2])
+				break;
+			
+			/* Process the slab: */
+			buildSlab(slab);
+			}
+		
+		return 0;
+		}
+	};
+
+/*********************************
+Methods of class VoxelBlockIndex:
+*********************************/
+
+VoxelBlockIndex::VoxelBlockIndex(const unsigned int sDataSize[3],unsigned int sBlockSize)
+	:blockSize(sBlockSize),
+	 numThreads(0),
+	 numTransparentBlocks(0)
+	{
+	if(blockSize<1)
+		Misc::throwStdErr("VoxelBlockIndex::VoxelBlockIndex: Invalid block size %u",blockSize);
+	
+	/* Split the data's cells into blocks, rounding up to cover partial blocks at the upper faces: */
+	size_t totalNumBlocks=1;
+	for(int i=0;i<3;++i)
+		{
+		dataSize[i]=sDataSize[i];
+		if(dataSize[i]<2)
+			Misc::throwStdErr("VoxelBlockIndex::VoxelBlockIndex: Invalid data size %u",dataSize[i]);
+		numBlocks[i]=(dataSize[i]-1+blockSize-1)/blockSize;
+		totalNumBlocks*=size_t(numBlocks[i]);
+		}
+	minValues.resize(totalNumBlocks,Voxel(0));
+	maxValues.resize(totalNumBlocks,std::numeric_limits<Voxel>::max());
+	
+	/* Classify all blocks as not transparent until the index is built: */
+	opacities.resize(totalNumBlocks,255U);
+	}
+
+void VoxelBlockIndex::build(const VoxelBlockIndex::Voxel* data,const ptrdiff_t dataStrides[3])
+	{
+	/* Determine the number of threads: */
+	int numBuildThreads=getNumWorkerThreads(numThreads);
+	if(numBuildThreads>int(numBlocks[2]))
+		numBuildThreads=int(numBlocks[2]);
+	
+	/* Create one job per thread, each handing out slabs from the same counter: */
+	Threads::Mutex slabMutex;
+	unsigned int nextSlab=0;
+	BuildJob* jobs=new BuildJob[numBuildThreads];
+	for(int i=0;i<numBuildThreads;++i)
+		{
+		jobs[i].index=this;
+		jobs[i].data=data;
+		jobs[i].dataStrides=dataStrides;
+		jobs[i].slabMutex=&slabMutex;
+		jobs[i].nextSlab=&nextSlab;
+		}
+	
+	/* Run the first job in the calling thread, and all others in background threads: */
+	Threads::Thread* threads=new Threads::Thread[numBuildThreads-1];
+	for(int i=1;i<numBuildThreads;++i)
+		threads[i-1].start(&jobs[i],&BuildJob::buildThreadMethod);
+	jobs[0].buildThreadMethod();
+	for(int i=1;i<numBuildThreads;++i)
+		threads[i-1].join();
+	delete[] threads;
+	delete[] jobs;
+	
+	/* Invalidate the blocks' classification: */
+	transparentEntries.clear();
+	}
+
+bool VoxelBlockIndex::classify(const GLColorMap& colorMap)
+	{
+	/* Find the color map's entries of zero opacity: */
+	int numEntries=int(colorMap.getNumEntries());
+	const GLColorMap::Color* colors=colorMap.getColors();
+	std::vector<bool> newTransparentEntries(numEntries);
+	for(int i=0;i<numEntries;++i)
+		newTransparentEntries[i]=colors[i][3]<=0.0f;
+	
+	/* Bail out if the color map's opacities changed only where they were non-zero before: */
+	if(newTransparentEntries==transparentEntries)
+		return false;
+	transparentEntries.swap(newTransparentEntries);
+	
+	/* Count the opaque entries up to each entry, so that any range of entries can be checked in constant time: */
+	std::vector<int> numOpaqueEntries(numEntries+1);
+	numOpaqueEntries[0]=0;
+	for(int i=0;i<numEntries;++i)
+		numOpaqueEntries[i+1]=numOpaqueEntries[i]+(transparentEntries[i]?0:1);
+	
+	/*********************************************************************
+	Raycasters look up normalized voxel values in a linearly interpolated
+	color map texture, which blends the two entries around each lookup
+	position. Trilinear interpolation keeps the values sampled inside a
+	block between the block's minimum and maximum voxel values, so a block
+	is transparent if all entries touched by lookups in that range have
+	zero opacity.
+	*********************************************************************/
+	
+	double entryScale=double(numEntries)/double(std::numeric_limits<Voxel>::max());
+	numTransparentBlocks=0;
+	for(size_t blockIndex=0;blockIndex<opacities.size();++blockIndex)
+		{
+		int firstEntry=int(floor(double(minValues[blockIndex])*entryScale-0.5));
+		if(firstEntry<0)
+			firstEntry=0;
+		int lastEntry=int(floor(double(maxValues[blockIndex])*entryScale-0.5))+1;
+		if(lastEntry>numEntries-1)
+			lastEntry=numEntries-1;
+		if(numOpaqueEntries[lastEntry+1]==numOpaqueEntries[firstEntry])
+			{
+			opacities[blockIndex]=0U;
+			++numTransparentBlocks;
+			}
+		else
+			opacities[blockIndex]=255U;
+		}
+	
+	return true;
+	}
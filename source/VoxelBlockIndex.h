@@ -0,0 +1,106 @@
+/***********************************************************************
+VoxelBlockIndex - Class to store the minimum and maximum voxel values of
+coarse blocks of a raycaster's volume data, and to classify the blocks
+as fully transparent or not under a color map, to let raycasters skip
+empty space.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VOXELBLOCKINDEX_INCLUDED
+#define VOXELBLOCKINDEX_INCLUDED
+
+#include <stddef.h>
+#include <vector>
+
+/* Forward declarations: */
+class GLColorMap;
+
+class VoxelBlockIndex
+	{
+	/* Embedded classes: */
+	public:
+	typedef unsigned short Voxel; // Type for voxel data; matches the single-channel raycaster's 16-bit voxels
+	
+	private:
+	struct BuildJob; // Structure describing one thread's share of building the index
+	
+	/* Elements: */
+	unsigned int dataSize[3]; // Size of the indexed volume data
+	unsigned int blockSize; // Number of cells of a block along each axis; adjacent blocks share one layer of voxels
+	unsigned int numBlocks[3]; // Number of blocks along each axis
+	int numThreads; // Number of threads to build the index, or 0 to use one thread per CPU
+	std::vector<Voxel> minValues,maxValues; // Smallest and largest voxel values of all blocks, with the x index varying fastest
+	std::vector<unsigned char> opacities; // Classification of all blocks; 0 if all of a block's voxels map to zero opacity, 255 otherwise
+	size_t numTransparentBlocks; // Number of blocks classified as fully transparent
+	std::vector<bool> transparentEntries; // Flags for the color map entries of zero opacity the blocks were last classified against; empty if the blocks need to be classified
+	
+	/* Constructors and destructors: */
+	public:
+	VoxelBlockIndex(const unsigned int sDataSize[3],unsigned int sBlockSize =8); // Creates an index for volume data of the given size, split into blocks of the given number of cells along each axis
+	
+	/* Methods: */
+	const unsigned int* getDataSize(void) const // Returns the indexed volume data's size
+		{
+		return dataSize;
+		}
+	unsigned int getBlockSize(void) const // Returns the number of cells of a block along each axis
+		{
+		return blockSize;
+		}
+	const unsigned int* getNumBlocks(void) const // Returns the number of blocks along each axis
+		{
+		return numBlocks;
+		}
+	size_t getTotalNumBlocks(void) const // Returns the total number of blocks
+		{
+		return minValues.size();
+		}
+	int getNumThreads(void) const // Returns the number of threads to build the index
+		{
+		return numThreads;
+		}
+	void setNumThreads(int newNumThreads) // Sets the number of threads to build the index; 0 uses one thread per CPU
+		{
+		numThreads=newNumThreads;
+		}
+	Voxel getMinValue(size_t blockIndex) const // Returns the smallest voxel value of the given block
+		{
+		return minValues[blockIndex];
+		}
+	Voxel getMaxValue(size_t blockIndex) const // Returns the largest voxel value of the given block
+		{
+		return maxValues[blockIndex];
+		}
+	const unsigned char* getOpacities(void) const // Returns the classification of all blocks, with the x index varying fastest
+		{
+		return &opacities[0];
+		}
+	bool isTransparent(size_t blockIndex) const // Returns true if the given block was classified as fully transparent
+		{
+		return opacities[blockIndex]==0;
+		}
+	size_t getNumTransparentBlocks(void) const // Returns the number of blocks classified as fully transparent
+		{
+		return numTransparentBlocks;
+		}
+	void build(const Voxel* data,const ptrdiff_t dataStrides[3]); // Calculates the value ranges of all blocks from the given volume data, and invalidates the blocks' classification
+	bool classify(const GLColorMap& colorMap); // Classifies all blocks against the given color map, mapping the full voxel range to the color map's entries; returns false if the color map's zero-opacity entries did not change since the last classification
+	};
+
+#endif
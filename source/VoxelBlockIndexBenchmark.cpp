@@ -0,0 +1,234 @@
+/*
+ * Description: VoxelBlockIndexBenchmark.cpp - Measures how building the
+ * raycaster's empty-space skipping block index scales with the number of
+ * threads, and how long classifying the blocks against a color map takes,
+ * checking both against a brute-force pass over the voxels, without
+ * opening a window
+ * Author: Patrick O'Leary
+ * Date: May 18, 2010
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <iostream>
+#include <vector>
+
+#include <Misc/Timer.h>
+#include <GL/GLColorMap.h>
+
+#include <VoxelBlockIndex.h>
+
+typedef VoxelBlockIndex::Voxel Voxel;
+
+/*
+ * calcValue - Returns the benchmark's voxel value, a set of nested wavy
+ * shells fading out towards the corners of the volume, at the given
+ * position in the unit cube.
+ *
+ * parameter u - double
+ * parameter v - double
+ * parameter w - double
+ * return - Voxel
+ */
+static Voxel calcValue(double u, double v, double w) {
+	double r = sqrt((u - 0.5) * (u - 0.5) + (v - 0.5) * (v - 0.5) + (w - 0.5)
+			* (w - 0.5));
+	double value = (0.5 + 0.5 * sin(20.0 * r)) * exp(-4.0 * r * r);
+	return Voxel(value * 65535.0 + 0.5);
+} // end calcValue()
+
+/*
+ * createColorMap - Returns a greyscale color map that is fully transparent
+ * below the given normalized threshold, and ramps up to full opacity above.
+ *
+ * parameter threshold - double
+ * return - GLColorMap *
+ */
+static GLColorMap * createColorMap(double threshold) {
+	GLColorMap::Color colors[3];
+	colors[0] = GLColorMap::Color(0.0f, 0.0f, 0.0f, 0.0f);
+	colors[1] = GLColorMap::Color(float(threshold), float(threshold),
+			float(threshold), 0.0f);
+	colors[2] = GLColorMap::Color(1.0f, 1.0f, 1.0f, 1.0f);
+	GLdouble keys[3] = { 0.0, threshold, 1.0 };
+	return new GLColorMap(3, colors, keys);
+} // end createColorMap()
+
+/*
+ * isTransparent - Returns true if the given voxel value maps to color map
+ * entries of zero opacity under linear color map interpolation.
+ *
+ * parameter colorMap - const GLColorMap &
+ * parameter value - Voxel
+ * return - bool
+ */
+static bool isTransparent(const GLColorMap & colorMap, Voxel value) {
+	int numEntries = int(colorMap.getNumEntries());
+	double entry = double(value) * double(numEntries) / 65535.0 - 0.5;
+	int entry0 = int(floor(entry));
+	for (int i = entry0; i <= entry0 + 1; ++i) {
+		int clamped = i < 0 ? 0 : i > numEntries - 1 ? numEntries - 1 : i;
+		if (colorMap.getColors()[clamped][3] > 0.0f) {
+			return false;
+		}
+	}
+	return true;
+} // end isTransparent()
+
+/*
+ * checkIndex - Compares the given block index' value ranges and
+ * classification against a brute-force pass over the voxels of each
+ * block, and returns the number of blocks with wrong value ranges or that
+ * are classified as transparent while containing visible voxels.
+ *
+ * parameter index - const VoxelBlockIndex &
+ * parameter data - const Voxel *
+ * parameter dataStrides - const ptrdiff_t *
+ * parameter colorMap - const GLColorMap &
+ * return - size_t
+ */
+static size_t checkIndex(const VoxelBlockIndex & index, const Voxel * data,
+		const ptrdiff_t * dataStrides, const GLColorMap & colorMap) {
+	const unsigned int * dataSize = index.getDataSize();
+	const unsigned int * numBlocks = index.getNumBlocks();
+	unsigned int blockSize = index.getBlockSize();
+	size_t numErrors = 0;
+	size_t blockIndex = 0;
+	for (unsigned int bz = 0; bz < numBlocks[2]; ++bz) {
+		for (unsigned int by = 0; by < numBlocks[1]; ++by) {
+			for (unsigned int bx = 0; bx < numBlocks[0]; ++bx, ++blockIndex) {
+				unsigned int block[3] = { bx, by, bz };
+				unsigned int min[3], max[3];
+				for (int i = 0; i < 3; ++i) {
+					min[i] = block[i] * blockSize;
+					max[i] = min[i] + blockSize < dataSize[i] - 1 ? min[i]
+							+ blockSize : dataSize[i] - 1;
+				}
+				Voxel minValue = 65535;
+				Voxel maxValue = 0;
+				bool visible = false;
+				for (unsigned int z = min[2]; z <= max[2]; ++z) {
+					for (unsigned int y = min[1]; y <= max[1]; ++y) {
+						for (unsigned int x = min[0]; x <= max[0]; ++x) {
+							Voxel value = data[x * dataStrides[0] + y
+									* dataStrides[1] + z * dataStrides[2]];
+							if (minValue > value) {
+								minValue = value;
+							}
+							if (maxValue < value) {
+								maxValue = value;
+							}
+							if (!isTransparent(colorMap, value)) {
+								visible = true;
+							}
+						}
+					}
+				}
+				if (index.getMinValue(blockIndex) != minValue
+						|| index.getMaxValue(blockIndex) != maxValue
+						|| (visible && index.isTransparent(blockIndex))) {
+					++numErrors;
+				}
+			}
+		}
+	}
+	return numErrors;
+} // end checkIndex()
+
+/*
+ * main
+ *
+ * parameter argc - int
+ * parameter argv - char**
+ * return - int
+ */
+int main(int argc, char** argv) {
+	/* Parse the command line: */
+	unsigned int size = 256;
+	unsigned int blockSize = 8;
+	long numCpus = sysconf(_SC_NPROCESSORS_ONLN);
+	int maxNumThreads = numCpus < 1 ? 1 : int(numCpus);
+	for (int i = 1; i < argc; ++i) {
+		if (strcasecmp(argv[i], "-size") == 0 && i + 1 < argc) {
+			size = (unsigned int) atoi(argv[++i]);
+		} else if (strcasecmp(argv[i], "-blockSize") == 0 && i + 1 < argc) {
+			blockSize = (unsigned int) atoi(argv[++i]);
+		} else if (strcasecmp(argv[i], "-threads") == 0 && i + 1 < argc) {
+			maxNumThreads = atoi(argv[++i]);
+		}
+	}
+
+	/* Create a volume in the unit cube: */
+	unsigned int dataSize[3] = { size, size, size };
+	ptrdiff_t dataStrides[3] = { 1, ptrdiff_t(size), ptrdiff_t(size)
+			* ptrdiff_t(size) };
+	std::vector<Voxel> data(size_t(size) * size_t(size) * size_t(size));
+	double cellSize = 1.0 / double(size - 1);
+	for (unsigned int z = 0; z < size; ++z) {
+		for (unsigned int y = 0; y < size; ++y) {
+			for (unsigned int x = 0; x < size; ++x) {
+				data[x * dataStrides[0] + y * dataStrides[1] + z
+						* dataStrides[2]] = calcValue(double(x) * cellSize,
+						double(y) * cellSize, double(z) * cellSize);
+			}
+		}
+	}
+
+	/* Build the block index with 1, 2, 4, ... threads: */
+	VoxelBlockIndex index(dataSize, blockSize);
+	std::cout << size << "^3 voxels, " << index.getTotalNumBlocks()
+			<< " blocks of " << blockSize << "^3 cells:" << std::endl;
+	double singleThreadTime = 0.0;
+	for (int numThreads = 1;; numThreads *= 2) {
+		if (numThreads > maxNumThreads) {
+			numThreads = maxNumThreads;
+		}
+		index.setNumThreads(numThreads);
+		Misc::Timer timer;
+		index.build(&data[0], dataStrides);
+		timer.elapse();
+		if (numThreads == 1) {
+			singleThreadTime = timer.getTime();
+		}
+		std::cout << "  Build with " << numThreads << " threads: "
+				<< timer.getTime() * 1000.0 << " ms, speed-up "
+				<< singleThreadTime / timer.getTime() << std::endl;
+		if (numThreads == maxNumThreads) {
+			break;
+		}
+	}
+
+	/* Classify the blocks against color maps of increasing transparency: */
+	size_t numErrors = 0;
+	for (int i = 0; i < 4; ++i) {
+		double threshold = 0.2 * double(i);
+		GLColorMap * colorMap = createColorMap(threshold);
+		Misc::Timer classifyTimer;
+		index.classify(*colorMap);
+		classifyTimer.elapse();
+
+		/* Change only the visible entries' opacities, which must not trigger another classification: */
+		colorMap->changeTransparency(2.0f);
+		Misc::Timer reclassifyTimer;
+		bool reclassified = index.classify(*colorMap);
+		reclassifyTimer.elapse();
+
+		size_t numThresholdErrors = checkIndex(index, &data[0], dataStrides,
+				*colorMap);
+		numErrors += numThresholdErrors;
+		std::cout << "  Classify at threshold " << threshold << ": "
+				<< classifyTimer.getTime() * 1000.0 << " ms, "
+				<< index.getNumTransparentBlocks() << " transparent blocks ("
+				<< 100.0 * double(index.getNumTransparentBlocks())
+						/ double(index.getTotalNumBlocks())
+				<< "%), unchanged palette check "
+				<< reclassifyTimer.getTime() * 1000.0 << " ms"
+				<< (reclassified ? " (re-classified)" : "") << ", "
+				<< numThresholdErrors << " errors" << std::endl;
+		delete colorMap;
+	}
+
+	return numErrors == 0 ? 0 : 1;
+} // end main()
@@ -0,0 +1,60 @@
+/***********************************************************************
+WorkerThreads - Helpers for functions that split their work across a
+pool of worker threads sharing state on the calling thread's stack.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef WORKERTHREADS_INCLUDED
+#define WORKERTHREADS_INCLUDED
+
+#include <unistd.h>
+#include <pthread.h>
+
+class WorkerThreadSection // Class disabling cancellation of the calling thread while it runs a pool of worker threads, such that a cancelled extraction thread cannot free the state the workers share, or die holding one of their mutexes
+	{
+	/* Elements: */
+	private:
+	int oldCancelState; // Cancellation state of the calling thread before the section was entered
+	
+	/* Constructors and destructors: */
+	public:
+	WorkerThreadSection(void) // Enters a worker thread section by disabling cancellation of the calling thread
+		{
+		pthread_setcancelstate(PTHREAD_CANCEL_DISABLE,&oldCancelState);
+		}
+	private:
+	WorkerThreadSection(const WorkerThreadSection& source); // Prohibit copy constructor
+	WorkerThreadSection& operator=(const WorkerThreadSection& source); // Prohibit assignment operator
+	public:
+	~WorkerThreadSection(void) // Leaves the worker thread section after all workers have been joined; a cancellation request received in the meantime is acted upon from here on
+		{
+		int cancelState;
+		pthread_setcancelstate(oldCancelState,&cancelState);
+		}
+	};
+
+inline int getNumWorkerThreads(int numThreads) // Returns the given number of worker threads if positive, or one thread per CPU, up to 64, otherwise
+	{
+	if(numThreads>0)
+		return numThreads;
+	long numCpus=sysconf(_SC_NPROCESSORS_ONLN);
+	return numCpus<1?1:numCpus>64?64:int(numCpus);
+	}
+
+#endif
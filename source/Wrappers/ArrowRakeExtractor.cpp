@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #define VISUALIZATION_WRAPPERS_ARROWRAKEEXTRACTOR_IMPLEMENTATION
 
+#include <vector>
 #include <Misc/ThrowStdErr.h>
 #include <Misc/File.h>
 #include <Comm/MulticastPipe.h>
@@ -37,6 +38,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Vrui/Vrui.h>
 
 #include <Abstract/VariableManager.h>
+#include <Templatized/BatchLocator.h>
 #include <Wrappers/ScalarExtractor.h>
 #include <Wrappers/VectorExtractor.h>
 #include <Wrappers/ParametersIOHelper.h>
@@ -300,6 +302,53 @@ const char* ArrowRakeExtractor<DataSetWrapperParam>::name="Arrow Rake";
 Methods of class ArrowRakeExtractor:
 ***********************************/
 
+template <class DataSetWrapperParam>
+inline
+void
+ArrowRakeExtractor<DataSetWrapperParam>::calcArrows(
+	const typename ArrowRakeExtractor<DataSetWrapperParam>::Parameters* arrowParameters,
+	typename ArrowRakeExtractor<DataSetWrapperParam>::Rake& rake)
+	{
+	typedef Visualization::Templatized::BatchLocator<DS> BatchLocator;
+	
+	/* Calculate the arrow base points: */
+	std::vector<Point> bases;
+	for(Index index(0);index[0]<arrowParameters->rakeSize[0];index.preInc(arrowParameters->rakeSize))
+		{
+		Point base=arrowParameters->base;
+		for(int i=0;i<2;++i)
+			base+=arrowParameters->frame[i]*(Scalar(index[i])*arrowParameters->cellSize[i]);
+		bases.push_back(base);
+		}
+	if(bases.empty())
+		return;
+	
+	/* Locate all base points at once; the rake's rows are already spatially coherent: */
+	std::vector<typename BatchLocator::CellHit> hits(bases.size());
+	BatchLocator batchLocator(arrowParameters->dsl);
+	batchLocator.setSortQueries(false);
+	batchLocator.locatePoints(&bases[0],bases.size(),&hits[0]);
+	
+	/* Calculate the arrow directions and scalar values: */
+	std::vector<Vector> directions(bases.size());
+	batchLocator.calcValues(&hits[0],hits.size(),*arrowParameters->ve,&directions[0]);
+	std::vector<Scalar> scalarValues(bases.size());
+	batchLocator.calcValues(&hits[0],hits.size(),*arrowParameters->cse,&scalarValues[0]);
+	
+	/* Store the arrows: */
+	size_t arrowIndex=0;
+	for(Index index(0);index[0]<arrowParameters->rakeSize[0];index.preInc(arrowParameters->rakeSize),++arrowIndex)
+		{
+		Arrow& arrow=rake(index);
+		arrow.base=bases[arrowIndex];
+		if((arrow.valid=hits[arrowIndex].valid))
+			{
+			arrow.direction=directions[arrowIndex];
+			arrow.scalarValue=scalarValues[arrowIndex];
+			}
+		}
+	}
+
 template <class DataSetWrapperParam>
 inline
 ArrowRakeExtractor<DataSetWrapperParam>::ArrowRakeExtractor(
@@ -425,19 +474,7 @@ ArrowRakeExtractor<DataSetWrapperParam>::createElement(
 	ArrowRake* result=new ArrowRake(myParameters,myParameters->rakeSize,myParameters->lengthScale,myParameters->shaftRadius,myParameters->numArrowVertices,getVariableManager()->getColorMap(csvi),getPipe());
 	
 	/* Calculate the arrow base points and directions: */
-	for(Index index(0);index[0]<myParameters->rakeSize[0];index.preInc(myParameters->rakeSize))
-		{
-		Arrow& arrow=result->getRake()(index);
-		arrow.base=myParameters->base;
-		for(int i=0;i<2;++i)
-			arrow.base+=myParameters->frame[i]*(Scalar(index[i])*myParameters->cellSize[i]);
-		
-		if((arrow.valid=myParameters->dsl.locatePoint(arrow.base)))
-			{
-			arrow.direction=Vector(myParameters->dsl.calcValue(*myParameters->ve));
-			arrow.scalarValue=Scalar(myParameters->dsl.calcValue(*myParameters->cse));
-			}
-		}
+	calcArrows(myParameters,result->getRake());
 	result->update();
 	
 	/* Return the result: */
@@ -473,19 +510,7 @@ ArrowRakeExtractor<DataSetWrapperParam>::continueElement(
 	const Realtime::AlarmTimer& alarm)
 	{
 	/* Calculate the arrow base points and directions: */
-	for(Index index(0);index[0]<currentParameters->rakeSize[0];index.preInc(currentParameters->rakeSize))
-		{
-		Arrow& arrow=currentArrowRake->getRake()(index);
-		arrow.base=currentParameters->base;
-		for(int i=0;i<2;++i)
-			arrow.base+=currentParameters->frame[i]*(Scalar(index[i])*currentParameters->cellSize[i]);
-		
-		if((arrow.valid=currentParameters->dsl.locatePoint(arrow.base)))
-			{
-			arrow.direction=Vector(currentParameters->dsl.calcValue(*currentParameters->ve));
-			arrow.scalarValue=Scalar(currentParameters->dsl.calcValue(*currentParameters->cse));
-			}
-		}
+	calcArrows(currentParameters,currentArrowRake->getRake());
 	currentArrowRake->update();
 	
 	return true;
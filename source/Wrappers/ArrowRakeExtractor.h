@@ -152,6 +152,9 @@ class ArrowRakeExtractor:public Visualization::Abstract::Algorithm
 	GLMotif::TextField* lengthScaleValue; // Text field to display the current arrow length scaling factor
 	GLMotif::Slider* lengthScaleSlider; // Sliders to adjust the current arrow length scaling factor
 	
+	/* Private methods: */
+	static void calcArrows(const Parameters* arrowParameters,Rake& rake); // Calculates the base points, directions, and scalar values of all arrows of a rake
+	
 	/* Constructors and destructors: */
 	public:
 	ArrowRakeExtractor(Visualization::Abstract::VariableManager* sVariableManager,Comm::MulticastPipe* sPipe); // Creates an arrow rake extractor
@@ -0,0 +1,70 @@
+/***********************************************************************
+CellBlockIndex - Wrapper class to cache a templatized cell block index
+for a scalar variable in the variable manager.
+Part of the wrapper layer of the templatized visualization
+components.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_CELLBLOCKINDEX_INCLUDED
+#define VISUALIZATION_WRAPPERS_CELLBLOCKINDEX_INCLUDED
+
+#include <stddef.h>
+
+#include <Abstract/ExtractionIndex.h>
+#include <Templatized/CellBlockIndex.h>
+
+namespace Visualization {
+
+namespace Wrappers {
+
+template <class DataSetWrapperParam>
+class CellBlockIndex:public Visualization::Abstract::ExtractionIndex
+	{
+	/* Embedded classes: */
+	public:
+	typedef Visualization::Abstract::ExtractionIndex Base; // Base class type
+	typedef DataSetWrapperParam DataSetWrapper; // Compatible data set type
+	typedef typename DataSetWrapper::DS DS; // Type of templatized data set
+	typedef typename DataSetWrapper::SE SE; // Type of templatized scalar extractor
+	typedef Visualization::Templatized::CellBlockIndex<DS,SE> BlockIndex; // Type of templatized cell block index
+	
+	/* Elements: */
+	private:
+	BlockIndex blockIndex; // Templatized cell block index
+	
+	/* Constructors and destructors: */
+	public:
+	CellBlockIndex(const DS& ds,const SE& se,size_t cellBlockSize) // Builds a cell block index for the given data set and scalar extractor
+		{
+		blockIndex.build(ds,se,cellBlockSize);
+		}
+	
+	/* Methods: */
+	const BlockIndex& getBlockIndex(void) const // Returns the templatized cell block index
+		{
+		return blockIndex;
+		}
+	};
+
+}
+
+}
+
+#endif
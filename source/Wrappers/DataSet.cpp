@@ -22,10 +22,13 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #define VISUALIZATION_WRAPPERS_DATASET_IMPLEMENTATION
 
+#include <vector>
 #include <Misc/ThrowStdErr.h>
 #include <Math/Math.h>
 #include <Geometry/Vector.h>
 
+#include <Templatized/BatchLocator.h>
+#include <Templatized/ValueRangeCalculator.h>
 #include <Templatized/ScalarExtractor.h>
 #include <Wrappers/ScalarExtractor.h>
 #include <Templatized/VectorExtractor.h>
@@ -99,7 +102,7 @@ DataSet<DSParam,VScalarParam,DataValueParam>::Locator::calcScalar(
 	/* Check if the locator is valid: */
 	if(!valid)
 		Misc::throwStdErr("DataSet::Locator::calcScalar: Attempt to evaluate invalid locator");
-		
+	
 	/* Calculate and return the value: */
 	return VScalar(dsl.calcValue(myScalarExtractor->getSe()));
 	}
@@ -118,11 +121,73 @@ DataSet<DSParam,VScalarParam,DataValueParam>::Locator::calcVector(
 	/* Check if the locator is valid: */
 	if(!valid)
 		Misc::throwStdErr("DataSet::Locator::calcVector: Attempt to evaluate invalid locator");
-		
+	
 	/* Calculate and return the value: */
 	return VVector(dsl.calcValue(myVectorExtractor->getVe()));
 	}
 
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+void
+DataSet<DSParam,VScalarParam,DataValueParam>::Locator::calcScalars(
+	const Visualization::Abstract::ScalarExtractor* scalarExtractor,
+	size_t numPoints,
+	const Visualization::Abstract::DataSet::Point* positions,
+	typename DataSet<DSParam,VScalarParam,DataValueParam>::DestScalar* values,
+	bool* valids) const
+	{
+	typedef Visualization::Templatized::BatchLocator<DS> BatchLocator;
+	
+	/* Convert the extractor base class pointer to the proper type: */
+	const ScalarExtractor* myScalarExtractor=dynamic_cast<const ScalarExtractor*>(scalarExtractor);
+	if(myScalarExtractor==0)
+		Misc::throwStdErr("DataSet::Locator::calcScalars: Mismatching scalar extractor type");
+	if(numPoints==0)
+		return;
+	
+	/* Locate all positions at once: */
+	std::vector<typename DS::Point> dsPositions(positions,positions+numPoints);
+	std::vector<typename BatchLocator::CellHit> hits(numPoints);
+	BatchLocator batchLocator(dsl);
+	batchLocator.locatePoints(&dsPositions[0],numPoints,&hits[0]);
+	
+	/* Calculate the values: */
+	batchLocator.calcValues(&hits[0],numPoints,myScalarExtractor->getSe(),values);
+	for(size_t i=0;i<numPoints;++i)
+		valids[i]=hits[i].valid;
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+void
+DataSet<DSParam,VScalarParam,DataValueParam>::Locator::calcVectors(
+	const Visualization::Abstract::VectorExtractor* vectorExtractor,
+	size_t numPoints,
+	const Visualization::Abstract::DataSet::Point* positions,
+	typename DataSet<DSParam,VScalarParam,DataValueParam>::DestVector* values,
+	bool* valids) const
+	{
+	typedef Visualization::Templatized::BatchLocator<DS> BatchLocator;
+	
+	/* Convert the extractor base class pointer to the proper type: */
+	const VectorExtractor* myVectorExtractor=dynamic_cast<const VectorExtractor*>(vectorExtractor);
+	if(myVectorExtractor==0)
+		Misc::throwStdErr("DataSet::Locator::calcVectors: Mismatching vector extractor type");
+	if(numPoints==0)
+		return;
+	
+	/* Locate all positions at once: */
+	std::vector<typename DS::Point> dsPositions(positions,positions+numPoints);
+	std::vector<typename BatchLocator::CellHit> hits(numPoints);
+	BatchLocator batchLocator(dsl);
+	batchLocator.locatePoints(&dsPositions[0],numPoints,&hits[0]);
+	
+	/* Calculate the values: */
+	batchLocator.calcValues(&hits[0],numPoints,myVectorExtractor->getVe(),values);
+	for(size_t i=0;i<numPoints;++i)
+		valids[i]=hits[i].valid;
+	}
+
 /************************
 Methods of class DataSet:
 ************************/
@@ -182,16 +247,7 @@ DataSet<DSParam,VScalarParam,DataValueParam>::calcScalarValueRange(
 	const SE& se=myScalarExtractor->getSe();
 	
 	VScalar min,max;
-	typename DS::VertexIterator vIt=ds.beginVertices();
-	min=max=vIt->getValue(se);
-	for(++vIt;vIt!=ds.endVertices();++vIt)
-		{
-		VScalar v=vIt->getValue(se);
-		if(min>v)
-			min=v;
-		else if(max<v)
-			max=v;
-		}
+	Visualization::Templatized::ValueRangeCalculator<DS,DSValue>::calcScalarRange(ds,se,min,max);
 	
 	return DestScalarRange(min,max);
 	}
@@ -242,20 +298,46 @@ DataSet<DSParam,VScalarParam,DataValueParam>::calcVectorValueMagnitudeRange(
 	const VE& ve=myVectorExtractor->getVe();
 	
 	VScalar min2,max2;
-	typename DS::VertexIterator vIt=ds.beginVertices();
-	min2=max2=Geometry::sqr(vIt->getValue(ve));
-	for(++vIt;vIt!=ds.endVertices();++vIt)
-		{
-		VScalar v2=Geometry::sqr(vIt->getValue(ve));
-		if(min2>v2)
-			min2=v2;
-		else if(max2<v2)
-			max2=v2;
-		}
+	Visualization::Templatized::ValueRangeCalculator<DS,DSValue>::calcVectorMagnitude2Range(ds,ve,min2,max2);
 	
 	return DestScalarRange(Math::sqrt(min2),Math::sqrt(max2));
 	}
 
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+void
+DataSet<DSParam,VScalarParam,DataValueParam>::updateScalarExtractor(
+	Visualization::Abstract::ScalarExtractor* scalarExtractor,
+	int scalarVariableIndex) const
+	{
+	/* Convert the extractor base class pointer to the proper type: */
+	ScalarExtractor* myScalarExtractor=dynamic_cast<ScalarExtractor*>(scalarExtractor);
+	if(myScalarExtractor==0)
+		Misc::throwStdErr("DataSet::updateScalarExtractor: Mismatching scalar extractor type");
+	if(scalarVariableIndex<0||scalarVariableIndex>=dataValue.getNumScalarVariables())
+		Misc::throwStdErr("DataSet::updateScalarExtractor: invalid variable index %d",scalarVariableIndex);
+	
+	/* Update the extractor in place, as extractor pointers are shared by the variable manager's clients: */
+	myScalarExtractor->setSe(dataValue.getScalarExtractor(scalarVariableIndex));
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+void
+DataSet<DSParam,VScalarParam,DataValueParam>::updateVectorExtractor(
+	Visualization::Abstract::VectorExtractor* vectorExtractor,
+	int vectorVariableIndex) const
+	{
+	/* Convert the extractor base class pointer to the proper type: */
+	VectorExtractor* myVectorExtractor=dynamic_cast<VectorExtractor*>(vectorExtractor);
+	if(myVectorExtractor==0)
+		Misc::throwStdErr("DataSet::updateVectorExtractor: Mismatching vector extractor type");
+	if(vectorVariableIndex<0||vectorVariableIndex>=dataValue.getNumVectorVariables())
+		Misc::throwStdErr("DataSet::updateVectorExtractor: invalid variable index %d",vectorVariableIndex);
+	
+	myVectorExtractor->setVe(dataValue.getVectorExtractor(vectorVariableIndex));
+	}
+
 }
 
 }
@@ -100,6 +100,8 @@ class DataSet:public Visualization::Abstract::DataSet
 			}
 		virtual DestScalar calcScalar(const Visualization::Abstract::ScalarExtractor* scalarExtractor) const;
 		virtual DestVector calcVector(const Visualization::Abstract::VectorExtractor* vectorExtractor) const;
+		virtual void calcScalars(const Visualization::Abstract::ScalarExtractor* scalarExtractor,size_t numPoints,const Point* positions,DestScalar* values,bool* valids) const;
+		virtual void calcVectors(const Visualization::Abstract::VectorExtractor* vectorExtractor,size_t numPoints,const Point* positions,DestVector* values,bool* valids) const;
 		};
 	
 	/* Elements: */
@@ -149,15 +151,29 @@ class DataSet:public Visualization::Abstract::DataSet
 	virtual int getNumScalarVariables(void) const;
 	virtual const char* getScalarVariableName(int scalarVariableIndex) const;
 	virtual Visualization::Abstract::ScalarExtractor* getScalarExtractor(int scalarVariableIndex) const;
+	virtual unsigned int getScalarVariableVersion(int scalarVariableIndex) const
+		{
+		return dataValue.getScalarVariableVersion(scalarVariableIndex);
+		}
 	virtual DestScalarRange calcScalarValueRange(const Visualization::Abstract::ScalarExtractor* scalarExtractor) const;
 	virtual int getNumVectorVariables(void) const;
 	virtual const char* getVectorVariableName(int vectorVariableIndex) const;
 	virtual Visualization::Abstract::VectorExtractor* getVectorExtractor(int vectorVariableIndex) const;
 	virtual DestScalarRange calcVectorValueMagnitudeRange(const Visualization::Abstract::VectorExtractor* vectorExtractor) const;
+	virtual int addDerivedScalarVariable(const char* name,const char* expression)
+		{
+		return dataValue.addDerivedScalarVariable(ds,name,expression);
+		}
+	virtual int addResampledScalarVariable(const char* name,const Visualization::Abstract::DataSet* source,int sourceScalarVariableIndex)
+		{
+		return dataValue.addResampledScalarVariable(ds,name,source,sourceScalarVariableIndex);
+		}
 	virtual BaseLocator* getLocator(void) const
 		{
 		return new Locator(ds);
 		}
+	virtual void updateScalarExtractor(Visualization::Abstract::ScalarExtractor* scalarExtractor,int scalarVariableIndex) const;
+	virtual void updateVectorExtractor(Visualization::Abstract::VectorExtractor* vectorExtractor,int vectorVariableIndex) const;
 	};
 
 }
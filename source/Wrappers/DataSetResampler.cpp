@@ -0,0 +1,129 @@
+/***********************************************************************
+DataSetResampler - Class to evaluate a scalar variable of a data set at
+many points at once, such as the vertices of another data set's grid.
+Points are processed in blocks of consecutive points by several threads,
+each walking its own locator through the source data set.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <Wrappers/DataSetResampler.h>
+
+#include <Threads/Thread.h>
+
+#include <WorkerThreads.h>
+
+namespace Visualization {
+
+namespace Wrappers {
+
+/***************************************************
+Declaration of struct DataSetResampler::ResampleJob:
+***************************************************/
+
+struct DataSetResampler::ResampleJob
+	{
+	/* Elements: */
+	public:
+	const DataSetResampler* resampler; // The resampler
+	size_t numPoints; // Total number of points
+	const Point* points; // Array of points
+	VScalar* values; // Array receiving the resampled values
+	VScalar outsideValue; // Value assigned to points outside the source's domain
+	Threads::Mutex nextBlockMutex; // Mutex protecting the index of the next unprocessed block
+	size_t nextBlockStart; // Index of the first point of the next unprocessed block
+	
+	/* Methods: */
+	void* resampleThreadMethod(void)
+		{
+		/* Each thread evaluates its blocks through its own locator's batched interface; points in a block are located in spatially coherent order: */
+		Visualization::Abstract::DataSet::Locator* locator=resampler->source->getLocator();
+		bool* valids=new bool[blockSize];
+		
+		while(true)
+			{
+			/* Grab the next block of points: */
+			size_t blockStart;
+			{
+			Threads::Mutex::Lock nextBlockLock(nextBlockMutex);
+			blockStart=nextBlockStart;
+			nextBlockStart+=blockSize;
+			}
+			if(blockStart>=numPoints)
+				break;
+			size_t blockEnd=blockStart+blockSize;
+			if(blockEnd>numPoints)
+				blockEnd=numPoints;
+			
+			/* Resample the block: */
+			locator->calcScalars(resampler->scalarExtractor,blockEnd-blockStart,points+blockStart,values+blockStart,valids);
+			for(size_t i=blockStart;i<blockEnd;++i)
+				if(!valids[i-blockStart])
+					values[i]=outsideValue;
+			}
+		
+		delete[] valids;
+		delete locator;
+		
+		return 0;
+		}
+	};
+
+/*********************************
+Methods of class DataSetResampler:
+*********************************/
+
+DataSetResampler::DataSetResampler(const Visualization::Abstract::DataSet* sSource,int sourceScalarVariableIndex)
+	:source(sSource),
+	 scalarExtractor(source->getScalarExtractor(sourceScalarVariableIndex))
+	{
+	}
+
+DataSetResampler::~DataSetResampler(void)
+	{
+	delete scalarExtractor;
+	}
+
+void DataSetResampler::resample(size_t numPoints,const DataSetResampler::Point* points,DataSetResampler::VScalar* values,DataSetResampler::VScalar outsideValue,int numThreads) const
+	{
+	/* Determine the number of threads: */
+	numThreads=getNumWorkerThreads(numThreads);
+	size_t numBlocks=(numPoints+blockSize-1)/blockSize;
+	if(size_t(numThreads)>numBlocks)
+		numThreads=numBlocks>0?int(numBlocks):1;
+	
+	/* Let all threads grab blocks until all points are processed; locating points costs different amounts of time in different parts of the source: */
+	ResampleJob job;
+	job.resampler=this;
+	job.numPoints=numPoints;
+	job.points=points;
+	job.values=values;
+	job.outsideValue=outsideValue;
+	job.nextBlockStart=0;
+	Threads::Thread* threads=numThreads>1?new Threads::Thread[numThreads-1]:0;
+	for(int i=1;i<numThreads;++i)
+		threads[i-1].start(&job,&ResampleJob::resampleThreadMethod);
+	job.resampleThreadMethod();
+	for(int i=1;i<numThreads;++i)
+		threads[i-1].join();
+	delete[] threads;
+	}
+
+}
+
+}
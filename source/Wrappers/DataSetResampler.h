@@ -0,0 +1,71 @@
+/***********************************************************************
+DataSetResampler - Class to evaluate a scalar variable of a data set at
+many points at once, such as the vertices of another data set's grid.
+Points are processed in blocks of consecutive points by several threads,
+each evaluating its blocks through the batched interface of its own
+locator into the source data set.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_DATASETRESAMPLER_INCLUDED
+#define VISUALIZATION_WRAPPERS_DATASETRESAMPLER_INCLUDED
+
+#include <stddef.h>
+#include <Threads/Mutex.h>
+
+#include <Abstract/DataSet.h>
+
+namespace Visualization {
+
+namespace Wrappers {
+
+class DataSetResampler
+	{
+	/* Embedded classes: */
+	public:
+	typedef Visualization::Abstract::DataSet::Point Point; // Point type in source data set's domain
+	typedef Visualization::Abstract::DataSet::VScalar VScalar; // Scalar value type
+	
+	static const size_t blockSize=4096; // Number of consecutive points handed to a thread at a time
+	
+	private:
+	struct ResampleJob; // Structure holding the state shared by all resampling threads
+	
+	/* Elements: */
+	const Visualization::Abstract::DataSet* source; // The data set being resampled
+	Visualization::Abstract::ScalarExtractor* scalarExtractor; // Extractor for the resampled scalar variable
+	
+	/* Constructors and destructors: */
+	public:
+	DataSetResampler(const Visualization::Abstract::DataSet* sSource,int sourceScalarVariableIndex); // Prepares to resample the given scalar variable of the given data set
+	private:
+	DataSetResampler(const DataSetResampler& source); // Prohibit copy constructor
+	DataSetResampler& operator=(const DataSetResampler& source); // Prohibit assignment operator
+	public:
+	~DataSetResampler(void);
+	
+	/* Methods: */
+	void resample(size_t numPoints,const Point* points,VScalar* values,VScalar outsideValue,int numThreads =0) const; // Evaluates the scalar variable at the given points, using the given number of threads or one thread per CPU; points outside the source's domain receive the outside value
+	};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,418 @@
+/***********************************************************************
+DataSetSeries - Wrapper class for series of value steps defined on a
+single data set grid, such as simulation runs at different parameter
+settings. Steps are loaded by a background thread into a bounded cache,
+and swapped with the data set's value slices when they are shown.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#define VISUALIZATION_WRAPPERS_DATASETSERIES_IMPLEMENTATION
+
+#include <stdexcept>
+#include <iostream>
+#include <Misc/ThrowStdErr.h>
+#include <Misc/Timer.h>
+
+#include <Wrappers/DataSetSeries.h>
+
+namespace Visualization {
+
+namespace Wrappers {
+
+/******************************
+Methods of class DataSetSeries:
+******************************/
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+int
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::findCachedStep(
+	int stepIndex) const
+	{
+	for(size_t i=0;i<cache.size();++i)
+		if(cache[i].stepIndex==stepIndex)
+			return int(i);
+	return -1;
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+int
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::getStepDistance(
+	int stepIndex) const
+	{
+	return stepIndex>=requestedStep?stepIndex-requestedStep:requestedStep-stepIndex;
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+bool
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::isStepComplete(
+	const typename DataSetSeries<DSParam,VScalarParam,DataValueParam>::CachedStep& step) const
+	{
+	return !step.busy&&this->getDataValue().areDerivedStepSlicesComplete(step.derivedComputed);
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+int
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::findEvictionCandidate(
+	void) const
+	{
+	/* Never evict the previous step, so that stepping back is immediate; prefer the least recently used step outside the prefetch window, then the farthest step: */
+	int result=-1;
+	for(int i=0;i<int(cache.size());++i)
+		{
+		if(cache[i].stepIndex==previousStep||cache[i].busy)
+			continue;
+		if(result<0)
+			{
+			result=i;
+			continue;
+			}
+		
+		bool outside=getStepDistance(cache[i].stepIndex)>prefetchRadius;
+		bool resultOutside=getStepDistance(cache[result].stepIndex)>prefetchRadius;
+		if(outside!=resultOutside)
+			{
+			if(outside)
+				result=i;
+			}
+		else if(outside)
+			{
+			if(cache[result].lastUse>cache[i].lastUse)
+				result=i;
+			}
+		else if(getStepDistance(cache[result].stepIndex)<getStepDistance(cache[i].stepIndex))
+			result=i;
+		}
+	
+	return result;
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+int
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::getNextPrefetchStep(
+	void) const
+	{
+	/* Only load steps that are closer to the requested step than the step they would evict: */
+	int maxLoadDistance=prefetchRadius;
+	if(int(cache.size())>=maxNumCachedSteps)
+		{
+		int evictIndex=findEvictionCandidate();
+		if(evictIndex<0)
+			maxLoadDistance=-1;
+		else if(getStepDistance(cache[evictIndex].stepIndex)<=prefetchRadius)
+			maxLoadDistance=getStepDistance(cache[evictIndex].stepIndex)-1;
+		}
+	
+	/* Check the requested step first, then alternate between the following and preceding steps: */
+	int numSteps=int(stepNames.size());
+	for(int distance=0;distance<=prefetchRadius;++distance)
+		for(int side=0;side<(distance>0?2:1);++side)
+			{
+			int stepIndex=side==0?requestedStep+distance:requestedStep-distance;
+			if(stepIndex<0||stepIndex>=numSteps||stepIndex==currentStep)
+				continue;
+			
+			/* Load missing steps, and compute derived variables used since a step was loaded: */
+			int cacheIndex=findCachedStep(stepIndex);
+			if(cacheIndex<0)
+				{
+				if(distance<=maxLoadDistance)
+					return stepIndex;
+				}
+			else if(!cache[cacheIndex].busy&&!isStepComplete(cache[cacheIndex]))
+				return stepIndex;
+			}
+	
+	return -1;
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+void
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::deleteCachedStep(
+	typename DataSetSeries<DSParam,VScalarParam,DataValueParam>::CachedStep& step)
+	{
+	for(int i=0;i<numStepSlices;++i)
+		delete[] step.slices[i];
+	delete[] step.slices;
+	for(typename std::vector<ValueScalar*>::iterator dsIt=step.derivedSlices.begin();dsIt!=step.derivedSlices.end();++dsIt)
+		delete[] *dsIt;
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+void*
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::prefetchThreadMethod(
+	void)
+	{
+	int numSlices=numStepSlices;
+	size_t numValues=this->getDs().getTotalNumVertices();
+	
+	/* Load value steps until shut down: */
+	while(true)
+		{
+		/* Wait until there is a step to load or to complete: */
+		int stepIndex;
+		int cacheIndex;
+		{
+		Threads::Mutex::Lock cacheLock(cacheMutex);
+		while(!shutdown&&(stepIndex=getNextPrefetchStep())<0)
+			prefetchCond.wait(cacheMutex);
+		if(shutdown)
+			break;
+		
+		/* Keep a cached step from being shown or evicted while its derived variables are computed: */
+		cacheIndex=findCachedStep(stepIndex);
+		if(cacheIndex>=0)
+			cache[cacheIndex].busy=true;
+		}
+		
+		if(cacheIndex>=0)
+			{
+			/* Compute the derived variables without holding the cache lock; only this thread changes the cache's layout: */
+			CachedStep& step=cache[cacheIndex];
+			this->getDataValue().computeDerivedStepSlices(step.slices,numSlices,step.derivedSlices,step.derivedComputed);
+			
+			Threads::Mutex::Lock cacheLock(cacheMutex);
+			step.busy=false;
+			loadedCond.broadcast();
+			continue;
+			}
+		
+		/* Load the step's values without holding the cache lock: */
+		CachedStep newStep;
+		newStep.stepIndex=stepIndex;
+		newStep.slices=new ValueScalar*[numSlices];
+		for(int i=0;i<numSlices;++i)
+			newStep.slices[i]=new ValueScalar[numValues];
+		newStep.busy=false;
+		Misc::Timer loadTimer;
+		try
+			{
+			stepLoader->loadStep(stepIndex,newStep.slices);
+			loadTimer.elapse();
+			std::cout<<"DataSetSeries: Loaded step "<<stepNames[stepIndex]<<" in "<<loadTimer.getTime()*1000.0<<" ms"<<std::endl;
+			}
+		catch(std::runtime_error err)
+			{
+			/* Report the error and carry on with an empty step: */
+			std::cerr<<"DataSetSeries: Caught exception "<<err.what()<<" while loading step "<<stepNames[stepIndex]<<std::endl;
+			for(int i=0;i<numSlices;++i)
+				for(size_t j=0;j<numValues;++j)
+					newStep.slices[i][j]=ValueScalar(0);
+			}
+		
+		/* Compute the step's derived variables, such that showing the step only has to swap arrays: */
+		this->getDataValue().computeDerivedStepSlices(newStep.slices,numSlices,newStep.derivedSlices,newStep.derivedComputed);
+		
+		/* Store the step in the cache; if the cache is full, evict a step based on the (possibly changed) requested step: */
+		{
+		Threads::Mutex::Lock cacheLock(cacheMutex);
+		newStep.lastUse=++useCounter;
+		cache.push_back(newStep);
+		if(int(cache.size())>maxNumCachedSteps)
+			{
+			int evictIndex=findEvictionCandidate();
+			if(evictIndex>=0)
+				{
+				deleteCachedStep(cache[evictIndex]);
+				cache.erase(cache.begin()+evictIndex);
+				}
+			}
+		loadedCond.broadcast();
+		}
+		}
+	
+	return 0;
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::DataSetSeries(
+	void)
+	:stepLoader(0),
+	 maxNumCachedSteps(0),prefetchRadius(0),numStepSlices(0),
+	 useCounter(0),
+	 currentStep(0),previousStep(-1),requestedStep(0),
+	 shutdown(false)
+	{
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::~DataSetSeries(
+	void)
+	{
+	if(stepLoader!=0)
+		{
+		/* Wake the prefetch thread up to die; a step being loaded is finished first: */
+		{
+		Threads::Mutex::Lock cacheLock(cacheMutex);
+		shutdown=true;
+		prefetchCond.signal();
+		}
+		prefetchThread.join();
+		
+		delete stepLoader;
+		}
+	
+	/* Delete all cached steps: */
+	for(typename std::vector<CachedStep>::iterator cIt=cache.begin();cIt!=cache.end();++cIt)
+		deleteCachedStep(*cIt);
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+void
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::addStep(
+	const char* stepName)
+	{
+	stepNames.push_back(stepName);
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+void
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::startPrefetching(
+	typename DataSetSeries<DSParam,VScalarParam,DataValueParam>::StepLoader* sStepLoader,
+	int sMaxNumCachedSteps,
+	int sPrefetchRadius)
+	{
+	if(stepLoader!=0)
+		Misc::throwStdErr("DataSetSeries::startPrefetching: Prefetch thread is already running");
+	
+	/* Store the loader and cache settings; the cache holds at least the previous step and one more: */
+	stepLoader=sStepLoader;
+	maxNumCachedSteps=sMaxNumCachedSteps>=2?sMaxNumCachedSteps:2;
+	prefetchRadius=sPrefetchRadius>=0?sPrefetchRadius:0;
+	numStepSlices=this->getDs().getNumSlices();
+	
+	/* Start loading the steps around the first step: */
+	prefetchThread.start(this,&DataSetSeries::prefetchThreadMethod);
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+int
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::getNumSteps(
+	void) const
+	{
+	return int(stepNames.size());
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+const char*
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::getStepName(
+	int stepIndex) const
+	{
+	if(stepIndex<0||stepIndex>=int(stepNames.size()))
+		Misc::throwStdErr("DataSetSeries::getStepName: invalid step index %d",stepIndex);
+	return stepNames[stepIndex].c_str();
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+int
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::getCurrentStep(
+	void) const
+	{
+	return currentStep;
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+void
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::requestStep(
+	int stepIndex)
+	{
+	if(stepIndex<0||stepIndex>=int(stepNames.size()))
+		Misc::throwStdErr("DataSetSeries::requestStep: invalid step index %d",stepIndex);
+	
+	/* Point the prefetch thread at the new step: */
+	Threads::Mutex::Lock cacheLock(cacheMutex);
+	requestedStep=stepIndex;
+	prefetchCond.signal();
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+bool
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::isStepLoaded(
+	int stepIndex) const
+	{
+	Threads::Mutex::Lock cacheLock(cacheMutex);
+	if(stepIndex==currentStep)
+		return true;
+	int cacheIndex=findCachedStep(stepIndex);
+	return cacheIndex>=0&&isStepComplete(cache[cacheIndex]);
+	}
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+inline
+void
+DataSetSeries<DSParam,VScalarParam,DataValueParam>::showStep(
+	int stepIndex)
+	{
+	if(stepIndex<0||stepIndex>=int(stepNames.size()))
+		Misc::throwStdErr("DataSetSeries::showStep: invalid step index %d",stepIndex);
+	
+	Threads::Mutex::Lock cacheLock(cacheMutex);
+	if(stepIndex==currentStep)
+		return;
+	
+	/* Wait for the prefetch thread if the step is not loaded yet, as happens on slave nodes lagging behind the master: */
+	int cacheIndex;
+	while((cacheIndex=findCachedStep(stepIndex))<0||!isStepComplete(cache[cacheIndex]))
+		{
+		if(requestedStep!=stepIndex)
+			{
+			requestedStep=stepIndex;
+			prefetchCond.signal();
+			}
+		loadedCond.wait(cacheMutex);
+		}
+	
+	/* Swap the step's arrays into the data set; nothing is copied or computed here: */
+	CachedStep& step=cache[cacheIndex];
+	DS& ds=this->getDs();
+	for(int i=0;i<numStepSlices;++i)
+		{
+		ds.swapSliceArray(i,step.slices[i]);
+		this->getDataValue().invalidateScalarVariable(i);
+		}
+	this->getDataValue().swapDerivedStepSlices(step.derivedSlices,step.derivedComputed);
+	
+	/* The cache entry now holds the outgoing step, which is kept as the previous step: */
+	step.stepIndex=currentStep;
+	step.lastUse=++useCounter;
+	previousStep=currentStep;
+	currentStep=stepIndex;
+	
+	/* Let the prefetch thread load the new step's neighbours: */
+	prefetchCond.signal();
+	}
+
+}
+
+}
@@ -0,0 +1,126 @@
+/***********************************************************************
+DataSetSeries - Wrapper class for series of value steps defined on a
+single data set grid, such as simulation runs at different parameter
+settings. Steps are loaded by a background thread into a bounded cache,
+and swapped with the data set's value slices when they are shown.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_DATASETSERIES_INCLUDED
+#define VISUALIZATION_WRAPPERS_DATASETSERIES_INCLUDED
+
+#include <string>
+#include <vector>
+#include <Threads/Mutex.h>
+#include <Threads/Cond.h>
+#include <Threads/Thread.h>
+
+#include <Wrappers/DataSet.h>
+
+namespace Visualization {
+
+namespace Wrappers {
+
+template <class DSParam,class VScalarParam,class DataValueParam>
+class DataSetSeries:public DataSet<DSParam,VScalarParam,DataValueParam>
+	{
+	/* Embedded classes: */
+	public:
+	typedef DataSet<DSParam,VScalarParam,DataValueParam> Base; // Base class
+	typedef typename Base::DS DS; // Type of templatized data set
+	typedef typename DS::ValueScalar ValueScalar; // Type of values stored in the data set's slices
+	
+	class StepLoader // Abstract base class for objects reading the values of value steps
+		{
+		/* Constructors and destructors: */
+		public:
+		virtual ~StepLoader(void)
+			{
+			}
+		
+		/* Methods: */
+		virtual void loadStep(int stepIndex,ValueScalar* const slices[]) =0; // Writes the given step's values into one array per data set slice; called from the prefetch thread; throws exception on error
+		};
+	
+	private:
+	struct CachedStep // Structure holding the values of a loaded value step
+		{
+		/* Elements: */
+		public:
+		int stepIndex; // Index of the value step
+		ValueScalar** slices; // Array of the step's value arrays, one per loaded data set slice
+		std::vector<ValueScalar*> derivedSlices; // The step's value arrays of derived scalar variables in order of definition; null for arrays not allocated yet
+		std::vector<bool> derivedComputed; // Flags whether each derived array holds the step's values
+		bool busy; // Flag whether the prefetch thread is computing the step's derived variables
+		unsigned int lastUse; // Time stamp of the step's most recent loading or showing
+		};
+	
+	/* Elements: */
+	std::vector<std::string> stepNames; // Descriptive names of all value steps
+	StepLoader* stepLoader; // Object loading value steps, or null if the prefetch thread is not running
+	int maxNumCachedSteps; // Maximum number of loaded value steps kept in the cache
+	int prefetchRadius; // Number of steps on either side of the requested step that are loaded ahead of time
+	int numStepSlices; // Number of data set slices loaded with each step; slices added later hold derived variables
+	mutable Threads::Mutex cacheMutex; // Mutex protecting the step cache and the step request state
+	Threads::Cond prefetchCond; // Condition variable for the prefetch thread to block on
+	Threads::Cond loadedCond; // Condition variable signalled when the prefetch thread finished a step
+	std::vector<CachedStep> cache; // List of loaded value steps
+	unsigned int useCounter; // Counter to time stamp cached steps
+	int currentStep; // Index of the value step whose values are currently stored in the data set
+	int previousStep; // Index of the value step shown before the current one, which is never evicted from the cache, or -1
+	int requestedStep; // Index of the most recently requested value step
+	bool shutdown; // Flag to tell the prefetch thread to shut itself down
+	Threads::Thread prefetchThread; // Thread loading value steps in the background
+	
+	/* Private methods: */
+	int findCachedStep(int stepIndex) const; // Returns the cache index of the given step, or -1; must be called with locked cache
+	int getStepDistance(int stepIndex) const; // Returns the distance of the given step from the requested step; must be called with locked cache
+	bool isStepComplete(const CachedStep& step) const; // Returns true if the given cached step can be shown; must be called with locked cache
+	int findEvictionCandidate(void) const; // Returns the cache index of the step to evict when the cache overflows, or -1; must be called with locked cache
+	int getNextPrefetchStep(void) const; // Returns the index of the next step to load or to complete, or -1 if all nearby steps are cached; must be called with locked cache
+	void deleteCachedStep(CachedStep& step); // Deletes a cached step's value arrays
+	void* prefetchThreadMethod(void); // The prefetch thread method
+	
+	/* Constructors and destructors: */
+	public:
+	DataSetSeries(void); // Creates a series containing no value steps
+	virtual ~DataSetSeries(void); // Stops the prefetch thread and deletes all cached steps
+	
+	/* Series construction methods: */
+	void addStep(const char* stepName); // Adds a value step of the given name to the series
+	void startPrefetching(StepLoader* sStepLoader,int sMaxNumCachedSteps,int sPrefetchRadius); // Starts loading steps with the given loader; data set's slices must be owned by the data set and contain the first step's values; series inherits loader; derived variables added afterwards are computed for each loaded step
+	
+	/* Methods from Visualization::Abstract::DataSet: */
+	virtual int getNumSteps(void) const;
+	virtual const char* getStepName(int stepIndex) const;
+	virtual int getCurrentStep(void) const;
+	virtual void requestStep(int stepIndex);
+	virtual bool isStepLoaded(int stepIndex) const;
+	virtual void showStep(int stepIndex);
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_WRAPPERS_DATASETSERIES_IMPLEMENTATION
+#include <Wrappers/DataSetSeries.cpp>
+#endif
+
+#endif
@@ -32,6 +32,9 @@ template <class ScalarParam,int dimensionParam>
 class Vector;
 }
 namespace Visualization {
+namespace Abstract {
+class DataSet;
+}
 namespace Templatized {
 template <class ScalarParam,class SourceValueParam>
 class ScalarExtractor;
@@ -68,6 +71,10 @@ class DataValue
 		Misc::throwStdErr("DataValue::getScalarVariableName: unimplemented method called");
 		return 0;
 		}
+	unsigned int getScalarVariableVersion(int scalarVariableIndex) const // Returns a number that changes whenever the scalar variable's values change
+		{
+		return 0;
+		}
 	SE getScalarExtractor(int scalarVariableIndex) const // Returns scalar extractor for a scalar variable
 		{
 		/* This method is never called */
@@ -89,6 +96,16 @@ class DataValue
 		Misc::throwStdErr("DataValue::getVectorExtractor: unimplemented method called");
 		return VE();
 		}
+	int addDerivedScalarVariable(DS& ds,const char* name,const char* expression) // Adds a scalar variable defined by an expression over the existing scalar variables
+		{
+		Misc::throwStdErr("DataValue::addDerivedScalarVariable: data value does not support derived variables");
+		return -1;
+		}
+	int addResampledScalarVariable(DS& ds,const char* name,const Visualization::Abstract::DataSet* source,int sourceScalarVariableIndex) // Adds a scalar variable holding another data set's scalar variable resampled at the data set's vertices
+		{
+		Misc::throwStdErr("DataValue::addResampledScalarVariable: data value does not support resampled variables");
+		return -1;
+		}
 	};
 
 }
@@ -42,6 +42,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Abstract/VariableManager.h>
 #include <Templatized/IsosurfaceExtractorIndexedTriangleSet.h>
 #include <Wrappers/ScalarExtractor.h>
+#include <Templatized/ActiveCellSet.h>
+#include <Wrappers/CellBlockIndex.h>
 #include <Wrappers/ParametersIOHelper.h>
 
 #include <Wrappers/GlobalIsosurfaceExtractor.h>
@@ -245,7 +247,8 @@ GlobalIsosurfaceExtractor<DataSetWrapperParam>::GlobalIsosurfaceExtractor(
 	 parameters(sVariableManager->getCurrentScalarVariable()),
 	 ise(getDs(sVariableManager->getDataSetByScalarVariable(parameters.scalarVariableIndex)),getSe(sVariableManager->getScalarExtractor(parameters.scalarVariableIndex))),
 	 valueRange(sVariableManager->getScalarValueRange(parameters.scalarVariableIndex)),
-	 extractionModeBox(0),isovalueValue(0),isovalueSlider(0)
+	 incremental(true),activeSet(0),activeSetScalarVariableIndex(-1),activeSetVersion(0),
+	 extractionModeBox(0),incrementalToggle(0),isovalueValue(0),isovalueSlider(0)
 	{
 	/* Initialize parameters: */
 	parameters.smoothShading=true;
@@ -260,6 +263,7 @@ inline
 GlobalIsosurfaceExtractor<DataSetWrapperParam>::~GlobalIsosurfaceExtractor(
 	void)
 	{
+	delete activeSet;
 	}
 
 template <class DataSetWrapperParam>
@@ -294,6 +298,14 @@ GlobalIsosurfaceExtractor<DataSetWrapperParam>::createSettingsDialog(
 	
 	extractionModeBox->manageChild();
 	
+	new GLMotif::Label("IsovalueChangesLabel",settingsDialog,"Isovalue Changes");
+	
+	incrementalToggle=new GLMotif::ToggleButton("IncrementalToggle",settingsDialog,"Incremental");
+	incrementalToggle->setBorderWidth(0.0f);
+	incrementalToggle->setHAlignment(GLFont::Left);
+	incrementalToggle->setToggle(incremental);
+	incrementalToggle->getValueChangedCallbacks().add(this,&GlobalIsosurfaceExtractor::incrementalToggleCallback);
+	
 	new GLMotif::Label("IsovalueLabel",settingsDialog,"Isovalue");
 	
 	GLMotif::RowColumn* isovalueBox=new GLMotif::RowColumn("IsovalueBox",settingsDialog,false);
@@ -330,13 +342,54 @@ GlobalIsosurfaceExtractor<DataSetWrapperParam>::createElement(
 	Isosurface* result=new Isosurface(myParameters,myParameters->isovalue,getVariableManager()->getColorMap(svi),getPipe());
 	
 	/* Update the isosurface extractor: */
-	ise.update(getDs(getVariableManager()->getDataSetByScalarVariable(svi)),getSe(getVariableManager()->getScalarExtractor(svi)));
+	const Visualization::Abstract::DataSet* dataSet=getVariableManager()->getDataSetByScalarVariable(svi);
+	const DS* ds=getDs(dataSet);
+	const SE& se=getSe(getVariableManager()->getScalarExtractor(svi));
+	unsigned int version=dataSet->getScalarVariableVersion(svi);
+	ise.update(ds,se);
 	
 	/* Set the templatized isosurface extractor's extraction mode: */
 	ise.setExtractionMode(myParameters->smoothShading?ISE::SMOOTH:ISE::FLAT);
 	
-	/* Extract the isosurface into the visualization element: */
-	ise.extractIsosurface(myParameters->isovalue,result->getSurface());
+	if(incremental)
+		{
+		/* Find the active cells from scratch only after the scalar variable or its values changed: */
+		if(activeSet==0)
+			activeSet=new ActiveSet;
+		if(!activeSet->isValid()||activeSetScalarVariableIndex!=svi||activeSetVersion!=version)
+			{
+			activeSet->build(*ds,se);
+			activeSetScalarVariableIndex=svi;
+			activeSetVersion=version;
+			}
+		
+		/* Extract the isosurface into the visualization element, updating the active cells of the previous isosurface: */
+		ise.setActiveSet(activeSet);
+		ise.extractIsosurface(myParameters->isovalue,result->getSurface());
+		ise.setActiveSet(0);
+		}
+	else
+		{
+		/* Release the active cells of previous incremental extractions: */
+		delete activeSet;
+		activeSet=0;
+		
+		/* Get the scalar variable's cell block index, or build it on the first extraction from the variable's current values: */
+		Visualization::Abstract::VariableManager::ExtractionIndexPointer extractionIndex=getVariableManager()->getExtractionIndex(svi);
+		const BlockIndex* blockIndex=dynamic_cast<const BlockIndex*>(extractionIndex.getPointer());
+		if(blockIndex==0)
+			{
+			BlockIndex* newBlockIndex=new BlockIndex(*ds,se,ISE::cellBlockSize);
+			extractionIndex=Visualization::Abstract::VariableManager::ExtractionIndexPointer(newBlockIndex);
+			getVariableManager()->setExtractionIndex(svi,version,extractionIndex);
+			blockIndex=newBlockIndex;
+			}
+		
+		/* Extract the isosurface into the visualization element, skipping all cell blocks that do not contain the isovalue: */
+		ise.setBlockIndex(&blockIndex->getBlockIndex());
+		ise.extractIsosurface(myParameters->isovalue,result->getSurface());
+		ise.setBlockIndex(0);
+		}
 	
 	/* Return the result: */
 	return result;
@@ -385,6 +438,16 @@ GlobalIsosurfaceExtractor<DataSetWrapperParam>::extractionModeBoxCallback(
 		}
 	}
 
+template <class DataSetWrapperParam>
+inline
+void
+GlobalIsosurfaceExtractor<DataSetWrapperParam>::incrementalToggleCallback(
+	GLMotif::ToggleButton::ValueChangedCallbackData* cbData)
+	{
+	/* Set the incremental update flag; the extraction thread creates or releases the active cell set: */
+	incremental=cbData->set;
+	}
+
 template <class DataSetWrapperParam>
 inline
 void
@@ -396,6 +459,10 @@ GlobalIsosurfaceExtractor<DataSetWrapperParam>::isovalueSliderCallback(
 	
 	/* Update the text field: */
 	isovalueValue->setValue(parameters.isovalue);
+	
+	/* Preview the isosurface for the new isovalue while the slider is dragged; incremental updates only visit the cells near the previous isosurface: */
+	if(incremental)
+		callParametersChangedFunction();
 	}
 
 }
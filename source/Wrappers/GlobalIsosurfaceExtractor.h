@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Misc/Autopointer.h>
 #include <GLMotif/RadioBox.h>
 #include <GLMotif/Slider.h>
+#include <GLMotif/ToggleButton.h>
 
 #include <Abstract/DataSet.h>
 #include <Abstract/Parameters.h>
@@ -48,10 +49,14 @@ template <class ScalarParam,class SourceValueParam>
 class ScalarExtractor;
 template <class DataSetParam,class ScalarExtractorParam,class IsosurfaceParam>
 class IsosurfaceExtractor;
+template <class DataSetParam,class ScalarExtractorParam>
+class ActiveCellSet;
 }
 namespace Wrappers {
 template <class SEParam>
 class ScalarExtractor;
+template <class DataSetWrapperParam>
+class CellBlockIndex;
 }
 }
 
@@ -74,6 +79,8 @@ class GlobalIsosurfaceExtractor:public Visualization::Abstract::Algorithm
 	typedef Misc::Autopointer<Isosurface> IsosurfacePointer; // Type for pointers to created visualization elements
 	typedef typename Isosurface::Surface Surface; // Type of low-level surface representation
 	typedef Visualization::Templatized::IsosurfaceExtractor<DS,SE,Surface> ISE; // Type of templatized isosurface extractor
+	typedef Visualization::Wrappers::CellBlockIndex<DataSetWrapper> BlockIndex; // Type of cell block indices cached in the variable manager
+	typedef Visualization::Templatized::ActiveCellSet<DS,SE> ActiveSet; // Type of active cell sets for incremental extraction
 	
 	private:
 	class Parameters:public Visualization::Abstract::Parameters // Class to store extraction parameters for global isosurfaces
@@ -122,9 +129,14 @@ class GlobalIsosurfaceExtractor:public Visualization::Abstract::Algorithm
 	Parameters parameters; // The isosurface extraction parameters used by this extractor
 	ISE ise; // The templatized isosurface extractor
 	Visualization::Abstract::DataSet::VScalarRange valueRange; // Value range of the scalar variable used by this extractor
+	bool incremental; // Flag whether to update the active cells of the previous isosurface instead of finding them from scratch
+	ActiveSet* activeSet; // Active cells of the most recently extracted isosurface in incremental mode, or null
+	int activeSetScalarVariableIndex; // Index of the scalar variable for which the active cell set was built
+	unsigned int activeSetVersion; // Version number of the scalar variable's values from which the active cell set was built
 	
 	/* UI components: */
 	GLMotif::RadioBox* extractionModeBox; // Radio box with toggles for extraction modes
+	GLMotif::ToggleButton* incrementalToggle; // Toggle button to enable/disable incremental isosurface updates
 	GLMotif::TextField* isovalueValue; // Text field to display the current isovalue
 	GLMotif::Slider* isovalueSlider; // Slider to select the current isovalue
 	
@@ -168,6 +180,7 @@ class GlobalIsosurfaceExtractor:public Visualization::Abstract::Algorithm
 		return ise;
 		}
 	void extractionModeBoxCallback(GLMotif::RadioBox::ValueChangedCallbackData* cbData);
+	void incrementalToggleCallback(GLMotif::ToggleButton::ValueChangedCallbackData* cbData);
 	void isovalueSliderCallback(GLMotif::Slider::ValueChangedCallbackData* cbData);
 	};
 
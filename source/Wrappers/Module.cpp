@@ -33,6 +33,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Wrappers/SeededColoredIsosurfaceExtractor.h>
 #include <Wrappers/VolumeRendererExtractor.h>
 #include <Wrappers/TripleChannelVolumeRendererExtractor.h>
+#include <Wrappers/MultiIsosurfaceExtractor.h>
 #include <Wrappers/ArrowRakeExtractor.h>
 #include <Wrappers/StreamlineExtractor.h>
 #include <Wrappers/MultiStreamlineExtractor.h>
@@ -71,7 +72,7 @@ int
 Module<DSParam,DataValueParam>::getNumScalarAlgorithms(
 	void) const
 	{
-	return 6;
+	return 7;
 	}
 
 template <class DSParam,class DataValueParam>
@@ -80,7 +81,7 @@ const char*
 Module<DSParam,DataValueParam>::getScalarAlgorithmName(
 	int scalarAlgorithmIndex) const
 	{
-	if(scalarAlgorithmIndex<0||scalarAlgorithmIndex>=6)
+	if(scalarAlgorithmIndex<0||scalarAlgorithmIndex>=7)
 		Misc::throwStdErr("Module::getAlgorithmName: invalid algorithm index %d",scalarAlgorithmIndex);
 	
 	const char* result=0;
@@ -109,6 +110,10 @@ Module<DSParam,DataValueParam>::getScalarAlgorithmName(
 		case 5:
 			result=TripleChannelVolumeRendererExtractor::getClassName();
 			break;
+		
+		case 6:
+			result=MultiIsosurfaceExtractor::getClassName();
+			break;
 		}
 	return result;
 	}
@@ -121,7 +126,7 @@ Module<DSParam,DataValueParam>::getScalarAlgorithm(
 	Visualization::Abstract::VariableManager* variableManager,
 	Comm::MulticastPipe* pipe) const
 	{
-	if(scalarAlgorithmIndex<0||scalarAlgorithmIndex>=6)
+	if(scalarAlgorithmIndex<0||scalarAlgorithmIndex>=7)
 		Misc::throwStdErr("Module::getAlgorithm: invalid algorithm index %d",scalarAlgorithmIndex);
 	
 	Visualization::Abstract::Algorithm* result=0;
@@ -150,6 +155,10 @@ Module<DSParam,DataValueParam>::getScalarAlgorithm(
 		case 5:
 			result=new TripleChannelVolumeRendererExtractor(variableManager,pipe);
 			break;
+		
+		case 6:
+			result=new MultiIsosurfaceExtractor(variableManager,pipe);
+			break;
 		}
 	return result;
 	}
@@ -45,6 +45,8 @@ class VolumeRendererExtractor;
 template <class DataSetWrapperParam>
 class TripleChannelVolumeRendererExtractor;
 template <class DataSetWrapperParam>
+class MultiIsosurfaceExtractor;
+template <class DataSetWrapperParam>
 class ArrowRakeExtractor;
 template <class DataSetWrapperParam>
 class StreamlineExtractor;
@@ -75,6 +77,7 @@ class Module:public Visualization::Abstract::Module
 	typedef Visualization::Wrappers::SeededColoredIsosurfaceExtractor<DataSet> SeededColoredIsosurfaceExtractor; // Colored seeded isosurface extractor class
 	typedef Visualization::Wrappers::VolumeRendererExtractor<DataSet> VolumeRendererExtractor; // Volume renderer extractor class
 	typedef Visualization::Wrappers::TripleChannelVolumeRendererExtractor<DataSet> TripleChannelVolumeRendererExtractor; // Volume renderer extractor class with three scalar channels
+	typedef Visualization::Wrappers::MultiIsosurfaceExtractor<DataSet> MultiIsosurfaceExtractor; // Nested global isosurfaces extractor class
 	typedef Visualization::Wrappers::ArrowRakeExtractor<DataSet> ArrowRakeExtractor; // Arrow rake extractor class
 	typedef Visualization::Wrappers::StreamlineExtractor<DataSet> StreamlineExtractor; // Streamline extractor class
 	typedef Visualization::Wrappers::MultiStreamlineExtractor<DataSet> MultiStreamlineExtractor; // Streamline bundle extractor class
@@ -0,0 +1,137 @@
+/***********************************************************************
+MultiIsosurface - Wrapper class for the isosurfaces of several
+isovalues of the same scalar variable as visualization elements.
+Part of the wrapper layer of the templatized visualization
+components.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#define VISUALIZATION_WRAPPERS_MULTIISOSURFACE_IMPLEMENTATION
+
+#include <GL/gl.h>
+#include <GL/GLMaterial.h>
+
+#include <Wrappers/MultiIsosurface.h>
+
+namespace Visualization {
+
+namespace Wrappers {
+
+/********************************
+Methods of class MultiIsosurface:
+********************************/
+
+template <class DataSetWrapperParam>
+inline
+MultiIsosurface<DataSetWrapperParam>::MultiIsosurface(
+	Visualization::Abstract::Parameters* sParameters,
+	const std::vector<typename MultiIsosurface<DataSetWrapperParam>::VScalar>& sIsovalues,
+	const GLColorMap* sColorMap,
+	Comm::MulticastPipe* pipe)
+	:Visualization::Abstract::Element(sParameters),
+	 isovalues(sIsovalues),
+	 colorMap(sColorMap)
+	{
+	/* Create one surface per isovalue: */
+	for(size_t i=0;i<isovalues.size();++i)
+		surfaces.push_back(new Surface(pipe));
+	}
+
+template <class DataSetWrapperParam>
+inline
+MultiIsosurface<DataSetWrapperParam>::~MultiIsosurface(
+	void)
+	{
+	for(typename std::vector<Surface*>::iterator sIt=surfaces.begin();sIt!=surfaces.end();++sIt)
+		delete *sIt;
+	}
+
+template <class DataSetWrapperParam>
+inline
+std::string
+MultiIsosurface<DataSetWrapperParam>::getName(
+	void) const
+	{
+	return "Nested Isosurfaces";
+	}
+
+template <class DataSetWrapperParam>
+inline
+size_t
+MultiIsosurface<DataSetWrapperParam>::getSize(
+	void) const
+	{
+	size_t result=0;
+	for(typename std::vector<Surface*>::const_iterator sIt=surfaces.begin();sIt!=surfaces.end();++sIt)
+		result+=(*sIt)->getNumTriangles();
+	return result;
+	}
+
+template <class DataSetWrapperParam>
+inline
+void
+MultiIsosurface<DataSetWrapperParam>::glRenderAction(
+	GLContextData& contextData) const
+	{
+	/* Set up OpenGL state for isosurface rendering: */
+	GLboolean cullFaceEnabled=glIsEnabled(GL_CULL_FACE);
+	if(cullFaceEnabled)
+		glDisable(GL_CULL_FACE);
+	GLboolean lightingEnabled=glIsEnabled(GL_LIGHTING);
+	if(!lightingEnabled)
+		glEnable(GL_LIGHTING);
+	GLboolean normalizeEnabled=glIsEnabled(GL_NORMALIZE);
+	if(!normalizeEnabled)
+		glEnable(GL_NORMALIZE);
+	GLboolean lightModelTwoSide;
+	glGetBooleanv(GL_LIGHT_MODEL_TWO_SIDE,&lightModelTwoSide);
+	if(!lightModelTwoSide)
+		glLightModeli(GL_LIGHT_MODEL_TWO_SIDE,GL_TRUE);
+	GLboolean colorMaterialEnabled=glIsEnabled(GL_COLOR_MATERIAL);
+	if(colorMaterialEnabled)
+		glDisable(GL_COLOR_MATERIAL);
+	GLMaterial frontMaterial=glGetMaterial(GLMaterialEnums::FRONT);
+	GLMaterial backMaterial=glGetMaterial(GLMaterialEnums::BACK);
+	
+	/* Render each surface representation in the color of its isovalue: */
+	for(size_t i=0;i<surfaces.size();++i)
+		{
+		GLMaterial::Color surfaceColor=(*colorMap)(isovalues[i]);
+		glMaterial(GLMaterialEnums::FRONT_AND_BACK,GLMaterial(surfaceColor,GLMaterial::Color(0.6f,0.6f,0.6f),25.0f));
+		surfaces[i]->glRenderAction(contextData);
+		}
+	
+	/* Reset OpenGL state: */
+	glMaterial(GLMaterialEnums::FRONT,frontMaterial);
+	glMaterial(GLMaterialEnums::BACK,backMaterial);
+	if(colorMaterialEnabled)
+		glEnable(GL_COLOR_MATERIAL);
+	if(!lightModelTwoSide)
+		glLightModeli(GL_LIGHT_MODEL_TWO_SIDE,GL_FALSE);
+	if(!normalizeEnabled)
+		glDisable(GL_NORMALIZE);
+	if(!lightingEnabled)
+		glDisable(GL_LIGHTING);
+	if(cullFaceEnabled)
+		glEnable(GL_CULL_FACE);
+	}
+
+}
+
+}
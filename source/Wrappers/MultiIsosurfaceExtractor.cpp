@@ -0,0 +1,520 @@
+/***********************************************************************
+MultiIsosurfaceExtractor - Wrapper class to map from the abstract
+visualization algorithm interface to a templatized multi-isosurface
+extractor implementation, which extracts the global isosurfaces of
+several isovalues in a single pass over the data set.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#define VISUALIZATION_WRAPPERS_MULTIISOSURFACEEXTRACTOR_IMPLEMENTATION
+
+#include <algorithm>
+#include <Misc/ThrowStdErr.h>
+#include <Misc/File.h>
+#include <Comm/MulticastPipe.h>
+#include <Comm/ClusterPipe.h>
+#include <Math/Math.h>
+#include <GL/GLColorMap.h>
+#include <GLMotif/StyleSheet.h>
+#include <GLMotif/WidgetManager.h>
+#include <GLMotif/PopupWindow.h>
+#include <GLMotif/Margin.h>
+#include <GLMotif/Label.h>
+#include <GLMotif/TextField.h>
+#include <GLMotif/RowColumn.h>
+
+#include <Abstract/VariableManager.h>
+#include <Templatized/MultiIsosurfaceExtractor.h>
+#include <Wrappers/ScalarExtractor.h>
+#include <Wrappers/CellBlockIndex.h>
+#include <Wrappers/ParametersIOHelper.h>
+
+#include <Wrappers/MultiIsosurfaceExtractor.h>
+
+namespace Visualization {
+
+namespace Wrappers {
+
+/*****************************************************
+Methods of class MultiIsosurfaceExtractor::Parameters:
+*****************************************************/
+
+template <class DataSetWrapperParam>
+template <class DataSourceParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetWrapperParam>::Parameters::readBinary(
+	DataSourceParam& dataSource,
+	bool raw,
+	const Visualization::Abstract::VariableManager* variableManager)
+	{
+	/* Read all elements: */
+	if(raw)
+		scalarVariableIndex=dataSource.template read<int>();
+	else
+		scalarVariableIndex=readScalarVariableNameBinary<DataSourceParam>(dataSource,variableManager);
+	smoothShading=dataSource.template read<int>()!=0;
+	isovalues.resize(dataSource.template read<unsigned int>());
+	if(!isovalues.empty())
+		dataSource.template read<VScalar>(&isovalues[0],isovalues.size());
+	
+	/* Extraction requires the isovalues in ascending order: */
+	std::sort(isovalues.begin(),isovalues.end());
+	}
+
+template <class DataSetWrapperParam>
+template <class DataSinkParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetWrapperParam>::Parameters::writeBinary(
+	DataSinkParam& dataSink,
+	bool raw,
+	const Visualization::Abstract::VariableManager* variableManager) const
+	{
+	/* Write all elements: */
+	if(raw)
+		dataSink.template write<int>(scalarVariableIndex);
+	else
+		writeScalarVariableNameBinary<DataSinkParam>(dataSink,scalarVariableIndex,variableManager);
+	dataSink.template write<int>(smoothShading?1:0);
+	dataSink.template write<unsigned int>(isovalues.size());
+	if(!isovalues.empty())
+		dataSink.template write<VScalar>(&isovalues[0],isovalues.size());
+	}
+
+template <class DataSetWrapperParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetWrapperParam>::Parameters::read(
+	Misc::File& file,
+	bool ascii,
+	Visualization::Abstract::VariableManager* variableManager)
+	{
+	if(ascii)
+		{
+		/* Parse the parameter section: */
+		AsciiParameterFileSectionHash* hash=parseAsciiParameterFileSection<Misc::File>(file);
+		
+		/* Extract the parameters: */
+		scalarVariableIndex=readScalarVariableNameAscii(hash,"scalarVariable",variableManager);
+		smoothShading=readParameterAscii<int>(hash,"smoothShading",smoothShading)!=0;
+		isovalues.resize(readParameterAscii<unsigned int>(hash,"numIsovalues",isovalues.size()));
+		if(!isovalues.empty())
+			readParameterAscii<VScalar>(hash,"isovalues",&isovalues[0],isovalues.size());
+		
+		/* Clean up: */
+		deleteAsciiParameterFileSectionHash(hash);
+		
+		/* Extraction requires the isovalues in ascending order: */
+		std::sort(isovalues.begin(),isovalues.end());
+		}
+	else
+		{
+		/* Read from binary file: */
+		readBinary(file,false,variableManager);
+		}
+	}
+
+template <class DataSetWrapperParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetWrapperParam>::Parameters::read(
+	Comm::MulticastPipe& pipe,
+	Visualization::Abstract::VariableManager* variableManager)
+	{
+	/* Read from multicast pipe: */
+	readBinary(pipe,true,variableManager);
+	}
+
+template <class DataSetWrapperParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetWrapperParam>::Parameters::read(
+	Comm::ClusterPipe& pipe,
+	Visualization::Abstract::VariableManager* variableManager)
+	{
+	/* Read (and ignore) the parameter packet size from the cluster pipe: */
+	pipe.read<unsigned int>();
+	
+	/* Read from cluster pipe: */
+	readBinary(pipe,false,variableManager);
+	}
+
+template <class DataSetWrapperParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetWrapperParam>::Parameters::write(
+	Misc::File& file,
+	bool ascii,
+	const Visualization::Abstract::VariableManager* variableManager) const
+	{
+	if(ascii)
+		{
+		/* Write to ASCII file: */
+		file.write("{\n",2);
+		writeScalarVariableNameAscii<Misc::File>(file,"scalarVariable",scalarVariableIndex,variableManager);
+		writeParameterAscii<Misc::File,int>(file,"smoothShading",smoothShading?1:0);
+		writeParameterAscii<Misc::File,unsigned int>(file,"numIsovalues",isovalues.size());
+		if(!isovalues.empty())
+			writeParameterAscii<Misc::File,VScalar>(file,"isovalues",&isovalues[0],isovalues.size());
+		file.write("}\n",2);
+		}
+	else
+		{
+		/* Write to binary file: */
+		writeBinary(file,false,variableManager);
+		}
+	}
+
+template <class DataSetWrapperParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetWrapperParam>::Parameters::write(
+	Comm::MulticastPipe& pipe,
+	const Visualization::Abstract::VariableManager* variableManager) const
+	{
+	/* Write to multicast pipe: */
+	writeBinary(pipe,true,variableManager);
+	}
+
+template <class DataSetWrapperParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetWrapperParam>::Parameters::write(
+	Comm::ClusterPipe& pipe,
+	const Visualization::Abstract::VariableManager* variableManager) const
+	{
+	/* Calculate the byte size of the marshalled parameter packet: */
+	size_t packetSize=0;
+	packetSize+=getScalarVariableNameLength(scalarVariableIndex,variableManager);
+	packetSize+=sizeof(int)+sizeof(unsigned int)+isovalues.size()*sizeof(VScalar);
+	
+	/* Write the packet size to the cluster pipe: */
+	pipe.write<unsigned int>(packetSize);
+	
+	/* Write to cluster pipe: */
+	writeBinary(pipe,false,variableManager);
+	}
+
+/*************************************************
+Static elements of class MultiIsosurfaceExtractor:
+*************************************************/
+
+template <class DataSetWrapperParam>
+const char* MultiIsosurfaceExtractor<DataSetWrapperParam>::name="Nested Isosurfaces";
+
+/*****************************************
+Methods of class MultiIsosurfaceExtractor:
+*****************************************/
+
+template <class DataSetWrapperParam>
+inline
+const typename MultiIsosurfaceExtractor<DataSetWrapperParam>::DS*
+MultiIsosurfaceExtractor<DataSetWrapperParam>::getDs(
+	const Visualization::Abstract::DataSet* sDataSet)
+	{
+	/* Get a pointer to the data set wrapper: */
+	const DataSetWrapper* myDataSet=dynamic_cast<const DataSetWrapper*>(sDataSet);
+	if(myDataSet==0)
+		Misc::throwStdErr("MultiIsosurfaceExtractor::MultiIsosurfaceExtractor: Mismatching data set type");
+	
+	return &myDataSet->getDs();
+	}
+
+template <class DataSetWrapperParam>
+inline
+const typename MultiIsosurfaceExtractor<DataSetWrapperParam>::SE&
+MultiIsosurfaceExtractor<DataSetWrapperParam>::getSe(
+	const Visualization::Abstract::ScalarExtractor* sScalarExtractor)
+	{
+	/* Get a pointer to the scalar extractor wrapper: */
+	const ScalarExtractor* myScalarExtractor=dynamic_cast<const ScalarExtractor*>(sScalarExtractor);
+	if(myScalarExtractor==0)
+		Misc::throwStdErr("MultiIsosurfaceExtractor::MultiIsosurfaceExtractor: Mismatching scalar extractor type");
+	
+	return myScalarExtractor->getSe();
+	}
+
+template <class DataSetWrapperParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetWrapperParam>::updateIsovalues(
+	void)
+	{
+	/* Space the isovalues evenly between the lowest and the highest isovalue: */
+	parameters.isovalues.resize(numLevels);
+	if(numLevels==1)
+		parameters.isovalues[0]=minIsovalue;
+	else
+		for(int i=0;i<numLevels;++i)
+			parameters.isovalues[i]=VScalar(minIsovalue+(maxIsovalue-minIsovalue)*VScalar(i)/VScalar(numLevels-1));
+	
+	/* Extraction requires the isovalues in ascending order: */
+	std::sort(parameters.isovalues.begin(),parameters.isovalues.end());
+	}
+
+template <class DataSetWrapperParam>
+inline
+MultiIsosurfaceExtractor<DataSetWrapperParam>::MultiIsosurfaceExtractor(
+	Visualization::Abstract::VariableManager* sVariableManager,
+	Comm::MulticastPipe* sPipe)
+	:Abstract::Algorithm(sVariableManager,sPipe),
+	 parameters(sVariableManager->getCurrentScalarVariable()),
+	 mise(getDs(sVariableManager->getDataSetByScalarVariable(parameters.scalarVariableIndex)),getSe(sVariableManager->getScalarExtractor(parameters.scalarVariableIndex))),
+	 valueRange(sVariableManager->getScalarValueRange(parameters.scalarVariableIndex)),
+	 extractionModeBox(0),
+	 numLevelsValue(0),numLevelsSlider(0),
+	 minIsovalueValue(0),minIsovalueSlider(0),
+	 maxIsovalueValue(0),maxIsovalueSlider(0)
+	{
+	/* Initialize parameters: */
+	parameters.smoothShading=true;
+	numLevels=3;
+	minIsovalue=VScalar(valueRange.first+(valueRange.second-valueRange.first)*0.25);
+	maxIsovalue=VScalar(valueRange.first+(valueRange.second-valueRange.first)*0.75);
+	updateIsovalues();
+	
+	/* Set the templatized multi-isosurface extractor's extraction mode: */
+	mise.setExtractionMode(parameters.smoothShading?MISE::SMOOTH:MISE::FLAT);
+	}
+
+template <class DataSetWrapperParam>
+inline
+MultiIsosurfaceExtractor<DataSetWrapperParam>::~MultiIsosurfaceExtractor(
+	void)
+	{
+	}
+
+template <class DataSetWrapperParam>
+inline
+GLMotif::Widget*
+MultiIsosurfaceExtractor<DataSetWrapperParam>::createSettingsDialog(
+	GLMotif::WidgetManager* widgetManager)
+	{
+	/* Get the style sheet: */
+	const GLMotif::StyleSheet* ss=widgetManager->getStyleSheet();
+	
+	/* Create the settings dialog window: */
+	GLMotif::PopupWindow* settingsDialogPopup=new GLMotif::PopupWindow("MultiIsosurfaceExtractorSettingsDialogPopup",widgetManager,"Nested Isosurfaces Extractor Settings");
+	settingsDialogPopup->setResizableFlags(true,false);
+	
+	GLMotif::RowColumn* settingsDialog=new GLMotif::RowColumn("SettingsDialog",settingsDialogPopup,false);
+	settingsDialog->setNumMinorWidgets(2);
+	
+	new GLMotif::Label("ExtractionModeLabel",settingsDialog,"Extraction Mode");
+	
+	extractionModeBox=new GLMotif::RadioBox("ExtractionModeBox",settingsDialog,false);
+	extractionModeBox->setOrientation(GLMotif::RowColumn::HORIZONTAL);
+	extractionModeBox->setPacking(GLMotif::RowColumn::PACK_GRID);
+	extractionModeBox->setAlignment(GLMotif::Alignment::LEFT);
+	extractionModeBox->setSelectionMode(GLMotif::RadioBox::ALWAYS_ONE);
+	
+	extractionModeBox->addToggle("Flat Shading");
+	extractionModeBox->addToggle("Smooth Shading");
+	
+	extractionModeBox->setSelectedToggle(parameters.smoothShading?1:0);
+	extractionModeBox->getValueChangedCallbacks().add(this,&MultiIsosurfaceExtractor::extractionModeBoxCallback);
+	
+	extractionModeBox->manageChild();
+	
+	new GLMotif::Label("NumLevelsLabel",settingsDialog,"Number Of Isosurfaces");
+	
+	GLMotif::RowColumn* numLevelsBox=new GLMotif::RowColumn("NumLevelsBox",settingsDialog,false);
+	numLevelsBox->setOrientation(GLMotif::RowColumn::HORIZONTAL);
+	
+	numLevelsValue=new GLMotif::TextField("NumLevelsValue",numLevelsBox,2);
+	numLevelsValue->setValue(numLevels);
+	
+	numLevelsSlider=new GLMotif::Slider("NumLevelsSlider",numLevelsBox,GLMotif::Slider::HORIZONTAL,ss->fontHeight*20.0f);
+	numLevelsSlider->setValueRange(1.0,double(maxNumLevels),1.0);
+	numLevelsSlider->setValue(double(numLevels));
+	numLevelsSlider->getValueChangedCallbacks().add(this,&MultiIsosurfaceExtractor::numLevelsSliderCallback);
+	
+	numLevelsBox->manageChild();
+	
+	new GLMotif::Label("MinIsovalueLabel",settingsDialog,"Lowest Isovalue");
+	
+	GLMotif::RowColumn* minIsovalueBox=new GLMotif::RowColumn("MinIsovalueBox",settingsDialog,false);
+	minIsovalueBox->setOrientation(GLMotif::RowColumn::HORIZONTAL);
+	
+	minIsovalueValue=new GLMotif::TextField("MinIsovalueValue",minIsovalueBox,12);
+	minIsovalueValue->setValue(minIsovalue);
+	
+	minIsovalueSlider=new GLMotif::Slider("MinIsovalueSlider",minIsovalueBox,GLMotif::Slider::HORIZONTAL,ss->fontHeight*20.0f);
+	minIsovalueSlider->setValueRange(valueRange.first,valueRange.second,0.0);
+	minIsovalueSlider->setValue(minIsovalue);
+	minIsovalueSlider->getValueChangedCallbacks().add(this,&MultiIsosurfaceExtractor::minIsovalueSliderCallback);
+	
+	minIsovalueBox->manageChild();
+	
+	new GLMotif::Label("MaxIsovalueLabel",settingsDialog,"Highest Isovalue");
+	
+	GLMotif::RowColumn* maxIsovalueBox=new GLMotif::RowColumn("MaxIsovalueBox",settingsDialog,false);
+	maxIsovalueBox->setOrientation(GLMotif::RowColumn::HORIZONTAL);
+	
+	maxIsovalueValue=new GLMotif::TextField("MaxIsovalueValue",maxIsovalueBox,12);
+	maxIsovalueValue->setValue(maxIsovalue);
+	
+	maxIsovalueSlider=new GLMotif::Slider("MaxIsovalueSlider",maxIsovalueBox,GLMotif::Slider::HORIZONTAL,ss->fontHeight*20.0f);
+	maxIsovalueSlider->setValueRange(valueRange.first,valueRange.second,0.0);
+	maxIsovalueSlider->setValue(maxIsovalue);
+	maxIsovalueSlider->getValueChangedCallbacks().add(this,&MultiIsosurfaceExtractor::maxIsovalueSliderCallback);
+	
+	maxIsovalueBox->manageChild();
+	
+	settingsDialog->manageChild();
+	
+	return settingsDialogPopup;
+	}
+
+template <class DataSetWrapperParam>
+inline
+Visualization::Abstract::Element*
+MultiIsosurfaceExtractor<DataSetWrapperParam>::createElement(
+	Visualization::Abstract::Parameters* extractParameters)
+	{
+	/* Get proper pointer to parameter object: */
+	Parameters* myParameters=dynamic_cast<Parameters*>(extractParameters);
+	if(myParameters==0)
+		Misc::throwStdErr("MultiIsosurfaceExtractor::createElement: Mismatching parameter object type");
+	int svi=myParameters->scalarVariableIndex;
+	
+	/* Create a new multi-isosurface visualization element: */
+	MultiIsosurface* result=new MultiIsosurface(myParameters,myParameters->isovalues,getVariableManager()->getColorMap(svi),getPipe());
+	
+	/* Update the multi-isosurface extractor: */
+	const Visualization::Abstract::DataSet* dataSet=getVariableManager()->getDataSetByScalarVariable(svi);
+	const DS* ds=getDs(dataSet);
+	const SE& se=getSe(getVariableManager()->getScalarExtractor(svi));
+	unsigned int version=dataSet->getScalarVariableVersion(svi);
+	mise.update(ds,se);
+	
+	/* Set the templatized multi-isosurface extractor's extraction mode: */
+	mise.setExtractionMode(myParameters->smoothShading?MISE::SMOOTH:MISE::FLAT);
+	
+	/* Get the scalar variable's cell block index, or build it on the first extraction from the variable's current values: */
+	Visualization::Abstract::VariableManager::ExtractionIndexPointer extractionIndex=getVariableManager()->getExtractionIndex(svi);
+	const BlockIndex* blockIndex=dynamic_cast<const BlockIndex*>(extractionIndex.getPointer());
+	if(blockIndex==0)
+		{
+		BlockIndex* newBlockIndex=new BlockIndex(*ds,se,MISE::cellBlockSize);
+		extractionIndex=Visualization::Abstract::VariableManager::ExtractionIndexPointer(newBlockIndex);
+		getVariableManager()->setExtractionIndex(svi,version,extractionIndex);
+		blockIndex=newBlockIndex;
+		}
+	
+	/* Extract all isosurfaces into the visualization element in one pass, skipping all cell blocks that do not contain any of the isovalues: */
+	mise.setBlockIndex(&blockIndex->getBlockIndex());
+	mise.extractIsosurfaces(myParameters->isovalues,result->getSurfaces());
+	mise.setBlockIndex(0);
+	
+	/* Return the result: */
+	return result;
+	}
+
+template <class DataSetWrapperParam>
+inline
+Visualization::Abstract::Element*
+MultiIsosurfaceExtractor<DataSetWrapperParam>::startSlaveElement(
+	Visualization::Abstract::Parameters* extractParameters)
+	{
+	if(isMaster())
+		Misc::throwStdErr("MultiIsosurfaceExtractor::startSlaveElement: Cannot be called on master node");
+	
+	/* Get proper pointer to parameter object: */
+	Parameters* myParameters=dynamic_cast<Parameters*>(extractParameters);
+	if(myParameters==0)
+		Misc::throwStdErr("MultiIsosurfaceExtractor::startSlaveElement: Mismatching parameter object type");
+	
+	/* Create a new multi-isosurface visualization element: */
+	MultiIsosurface* result=new MultiIsosurface(myParameters,myParameters->isovalues,getVariableManager()->getColorMap(myParameters->scalarVariableIndex),getPipe());
+	
+	/* Receive the isosurfaces from the master in order of ascending isovalues: */
+	const std::vector<typename MultiIsosurface::Surface*>& surfaces=result->getSurfaces();
+	for(size_t i=0;i<surfaces.size();++i)
+		surfaces[i]->receive();
+	
+	return result;
+	}
+
+template <class DataSetWrapperParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetWrapperParam>::extractionModeBoxCallback(
+	GLMotif::RadioBox::ValueChangedCallbackData* cbData)
+	{
+	switch(extractionModeBox->getToggleIndex(cbData->newSelectedToggle))
+		{
+		case 0:
+			parameters.smoothShading=false;
+			mise.setExtractionMode(MISE::FLAT);
+			break;
+		
+		case 1:
+			parameters.smoothShading=true;
+			mise.setExtractionMode(MISE::SMOOTH);
+			break;
+		}
+	}
+
+template <class DataSetWrapperParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetWrapperParam>::numLevelsSliderCallback(
+	GLMotif::Slider::ValueChangedCallbackData* cbData)
+	{
+	/* Get the new number of isovalues: */
+	numLevels=int(Math::floor(double(cbData->value)+0.5));
+	updateIsovalues();
+	
+	/* Update the text field: */
+	numLevelsValue->setValue(numLevels);
+	}
+
+template <class DataSetWrapperParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetWrapperParam>::minIsovalueSliderCallback(
+	GLMotif::Slider::ValueChangedCallbackData* cbData)
+	{
+	/* Get the new lowest isovalue: */
+	minIsovalue=VScalar(cbData->value);
+	updateIsovalues();
+	
+	/* Update the text field: */
+	minIsovalueValue->setValue(minIsovalue);
+	}
+
+template <class DataSetWrapperParam>
+inline
+void
+MultiIsosurfaceExtractor<DataSetWrapperParam>::maxIsovalueSliderCallback(
+	GLMotif::Slider::ValueChangedCallbackData* cbData)
+	{
+	/* Get the new highest isovalue: */
+	maxIsovalue=VScalar(cbData->value);
+	updateIsovalues();
+	
+	/* Update the text field: */
+	maxIsovalueValue->setValue(maxIsovalue);
+	}
+
+}
+
+}
@@ -0,0 +1,197 @@
+/***********************************************************************
+MultiIsosurfaceExtractor - Wrapper class to map from the abstract
+visualization algorithm interface to a templatized multi-isosurface
+extractor implementation, which extracts the global isosurfaces of
+several isovalues in a single pass over the data set.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_MULTIISOSURFACEEXTRACTOR_INCLUDED
+#define VISUALIZATION_WRAPPERS_MULTIISOSURFACEEXTRACTOR_INCLUDED
+
+#include <vector>
+#include <Misc/Autopointer.h>
+#include <GLMotif/RadioBox.h>
+#include <GLMotif/Slider.h>
+
+#include <Abstract/DataSet.h>
+#include <Abstract/Parameters.h>
+#include <Abstract/Algorithm.h>
+
+#include <Wrappers/MultiIsosurface.h>
+
+/* Forward declarations: */
+namespace GLMotif {
+class TextField;
+}
+namespace Visualization {
+namespace Abstract {
+class ScalarExtractor;
+class Element;
+}
+namespace Templatized {
+template <class ScalarParam,class SourceValueParam>
+class ScalarExtractor;
+template <class DataSetParam,class ScalarExtractorParam,class VertexParam>
+class MultiIsosurfaceExtractor;
+}
+namespace Wrappers {
+template <class SEParam>
+class ScalarExtractor;
+template <class DataSetWrapperParam>
+class CellBlockIndex;
+}
+}
+
+namespace Visualization {
+
+namespace Wrappers {
+
+template <class DataSetWrapperParam>
+class MultiIsosurfaceExtractor:public Visualization::Abstract::Algorithm
+	{
+	/* Embedded classes: */
+	public:
+	typedef Visualization::Abstract::Algorithm Base; // Base class
+	typedef DataSetWrapperParam DataSetWrapper; // Compatible data set type
+	typedef typename DataSetWrapper::DS DS; // Type of templatized data set
+	typedef typename DataSetWrapper::SE SE; // Type of templatized scalar extractor
+	typedef typename SE::Scalar VScalar; // Value type of scalar extractor
+	typedef typename DataSetWrapper::ScalarExtractor ScalarExtractor; // Compatible scalar extractor wrapper class
+	typedef Visualization::Wrappers::MultiIsosurface<DataSetWrapper> MultiIsosurface; // Type of created visualization elements
+	typedef Misc::Autopointer<MultiIsosurface> MultiIsosurfacePointer; // Type for pointers to created visualization elements
+	typedef typename MultiIsosurface::Vertex Vertex; // Type of vertices of low-level surface representations
+	typedef Visualization::Templatized::MultiIsosurfaceExtractor<DS,SE,Vertex> MISE; // Type of templatized multi-isosurface extractor
+	typedef Visualization::Wrappers::CellBlockIndex<DataSetWrapper> BlockIndex; // Type of cell block indices cached in the variable manager
+	
+	private:
+	class Parameters:public Visualization::Abstract::Parameters // Class to store extraction parameters for nested isosurfaces
+		{
+		friend class MultiIsosurfaceExtractor;
+		
+		/* Elements: */
+		private:
+		int scalarVariableIndex; // Index of the scalar variable to extract isosurfaces from
+		bool smoothShading; // Flag to enable smooth shading by calculating scalar field gradients at each vertex position
+		std::vector<VScalar> isovalues; // The isosurfaces' isovalues in ascending order
+		
+		/* Private methods: */
+		template <class DataSourceParam>
+		void readBinary(DataSourceParam& dataSource,bool raw,const Visualization::Abstract::VariableManager* variableManager); // Reads parameters from a binary data source
+		template <class DataSourceParam>
+		void writeBinary(DataSourceParam& dataSink,bool raw,const Visualization::Abstract::VariableManager* variableManager) const; // Writes parameters to a binary data source
+		
+		/* Constructors and destructors: */
+		public:
+		Parameters(int sScalarVariableIndex)
+			:scalarVariableIndex(sScalarVariableIndex)
+			{
+			}
+		
+		/* Methods from Abstract::Parameters: */
+		virtual bool isValid(void) const
+			{
+			return !isovalues.empty();
+			}
+		virtual void read(Misc::File& file,bool ascii,Visualization::Abstract::VariableManager* variableManager);
+		virtual void read(Comm::MulticastPipe& pipe,Visualization::Abstract::VariableManager* variableManager);
+		virtual void read(Comm::ClusterPipe& pipe,Visualization::Abstract::VariableManager* variableManager);
+		virtual void write(Misc::File& file,bool ascii,const Visualization::Abstract::VariableManager* variableManager) const;
+		virtual void write(Comm::MulticastPipe& pipe,const Visualization::Abstract::VariableManager* variableManager) const;
+		virtual void write(Comm::ClusterPipe& pipe,const Visualization::Abstract::VariableManager* variableManager) const;
+		virtual Visualization::Abstract::Parameters* clone(void) const
+			{
+			return new Parameters(*this);
+			}
+		};
+	
+	/* Elements: */
+	private:
+	static const char* name; // Identifying name of this algorithm
+	static const int maxNumLevels=8; // Maximum number of isovalues selectable in the settings dialog
+	Parameters parameters; // The isosurface extraction parameters used by this extractor
+	MISE mise; // The templatized multi-isosurface extractor
+	Visualization::Abstract::DataSet::VScalarRange valueRange; // Value range of the scalar variable used by this extractor
+	int numLevels; // Number of evenly spaced isovalues selected in the settings dialog
+	VScalar minIsovalue,maxIsovalue; // Lowest and highest isovalue selected in the settings dialog
+	
+	/* UI components: */
+	GLMotif::RadioBox* extractionModeBox; // Radio box with toggles for extraction modes
+	GLMotif::TextField* numLevelsValue; // Text field to display the current number of isovalues
+	GLMotif::Slider* numLevelsSlider; // Slider to select the current number of isovalues
+	GLMotif::TextField* minIsovalueValue; // Text field to display the current lowest isovalue
+	GLMotif::Slider* minIsovalueSlider; // Slider to select the current lowest isovalue
+	GLMotif::TextField* maxIsovalueValue; // Text field to display the current highest isovalue
+	GLMotif::Slider* maxIsovalueSlider; // Slider to select the current highest isovalue
+	
+	/* Private methods: */
+	static const DS* getDs(const Visualization::Abstract::DataSet* sDataSet);
+	static const SE& getSe(const Visualization::Abstract::ScalarExtractor* sScalarExtractor);
+	void updateIsovalues(void); // Spaces the parameters' isovalues evenly between the lowest and highest isovalue
+	
+	/* Constructors and destructors: */
+	public:
+	MultiIsosurfaceExtractor(Visualization::Abstract::VariableManager* sVariableManager,Comm::MulticastPipe* sPipe); // Creates a multi-isosurface extractor
+	virtual ~MultiIsosurfaceExtractor(void);
+	
+	/* Methods from Visualization::Abstract::Algorithm: */
+	virtual const char* getName(void) const
+		{
+		return name;
+		}
+	virtual bool hasGlobalCreator(void) const
+		{
+		return true;
+		}
+	virtual GLMotif::Widget* createSettingsDialog(GLMotif::WidgetManager* widgetManager);
+	virtual Visualization::Abstract::Parameters* cloneParameters(void) const
+		{
+		return new Parameters(parameters);
+		}
+	virtual Visualization::Abstract::Element* createElement(Visualization::Abstract::Parameters* extractParameters);
+	virtual Visualization::Abstract::Element* startSlaveElement(Visualization::Abstract::Parameters* extractParameters);
+	
+	/* New methods: */
+	static const char* getClassName(void) // Returns the algorithm class name
+		{
+		return name;
+		}
+	const MISE& getMise(void) const // Returns the templatized multi-isosurface extractor
+		{
+		return mise;
+		}
+	MISE& getMise(void) // Ditto
+		{
+		return mise;
+		}
+	void extractionModeBoxCallback(GLMotif::RadioBox::ValueChangedCallbackData* cbData);
+	void numLevelsSliderCallback(GLMotif::Slider::ValueChangedCallbackData* cbData);
+	void minIsovalueSliderCallback(GLMotif::Slider::ValueChangedCallbackData* cbData);
+	void maxIsovalueSliderCallback(GLMotif::Slider::ValueChangedCallbackData* cbData);
+	};
+
+}
+
+}
+
+#ifndef VISUALIZATION_WRAPPERS_MULTIISOSURFACEEXTRACTOR_IMPLEMENTATION
+#include <Wrappers/MultiIsosurfaceExtractor.cpp>
+#endif
+
+#endif
@@ -68,6 +68,10 @@ class ScalarExtractor:public Visualization::Abstract::ScalarExtractor
 		{
 		return se;
 		}
+	void setSe(const SE& newSe) // Replaces the templatized scalar extractor
+		{
+		se=newSe;
+		}
 	};
 
 }
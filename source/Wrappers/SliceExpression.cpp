@@ -0,0 +1,460 @@
+/***********************************************************************
+SliceExpression - Class for arithmetic expressions over the scalar
+variables of a sliced data set, used to define derived variables such as
+masked or error-bounded results. Expressions are compiled into a small
+stack program that is evaluated over blocks of values in parallel.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#include <Wrappers/SliceExpression.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <Misc/ThrowStdErr.h>
+#include <Threads/Thread.h>
+
+#include <WorkerThreads.h>
+#include <Wrappers/SlicedScalarVectorDataValue.h>
+
+namespace Visualization {
+
+namespace Wrappers {
+
+/********************************************
+Declaration of class SliceExpression::Parser:
+********************************************/
+
+class SliceExpression::Parser
+	{
+	/* Elements: */
+	private:
+	const char* expression; // The full expression string, for error messages
+	const char* ptr; // Current parsing position
+	const SlicedScalarVectorDataValueBase& variables; // Data value defining the scalar variable names
+	SliceExpression& result; // Expression receiving the compiled program
+	int stackDepth; // Number of blocks on the evaluation stack after the instructions emitted so far
+	
+	/* Private methods: */
+	void skipWhitespace(void)
+		{
+		while(*ptr==' '||*ptr=='\t')
+			++ptr;
+		}
+	void fail(const char* message) const
+		{
+		Misc::throwStdErr("SliceExpression: %s at position %d in expression \"%s\"",message,int(ptr-expression),expression);
+		}
+	void emit(OpCode opCode,int numArguments,double constant =0.0,int sourceIndex =-1)
+		{
+		Instruction instruction;
+		instruction.opCode=opCode;
+		instruction.constant=constant;
+		instruction.sourceIndex=sourceIndex;
+		result.program.push_back(instruction);
+		stackDepth+=1-numArguments;
+		if(result.maxStackDepth<stackDepth)
+			result.maxStackDepth=stackDepth;
+		}
+	void parseComparison(void);
+	void parseSum(void);
+	void parseProduct(void);
+	void parseUnary(void);
+	void parsePrimary(void);
+	
+	/* Constructors and destructors: */
+	public:
+	Parser(const char* sExpression,const SlicedScalarVectorDataValueBase& sVariables,SliceExpression& sResult)
+		:expression(sExpression),ptr(sExpression),
+		 variables(sVariables),result(sResult),
+		 stackDepth(0)
+		{
+		}
+	
+	/* Methods: */
+	void parse(void)
+		{
+		parseComparison();
+		skipWhitespace();
+		if(*ptr!='\0')
+			fail("unexpected character");
+		}
+	};
+
+/****************************************
+Methods of class SliceExpression::Parser:
+****************************************/
+
+void SliceExpression::Parser::parseComparison(void)
+	{
+	parseSum();
+	skipWhitespace();
+	OpCode opCode;
+	if(ptr[0]=='<')
+		opCode=ptr[1]=='='?LESSEQUAL:LESS;
+	else if(ptr[0]=='>')
+		opCode=ptr[1]=='='?GREATEREQUAL:GREATER;
+	else
+		return;
+	ptr+=opCode==LESSEQUAL||opCode==GREATEREQUAL?2:1;
+	parseSum();
+	emit(opCode,2);
+	}
+
+void SliceExpression::Parser::parseSum(void)
+	{
+	parseProduct();
+	while(true)
+		{
+		skipWhitespace();
+		if(*ptr!='+'&&*ptr!='-')
+			break;
+		OpCode opCode=*ptr=='+'?ADD:SUBTRACT;
+		++ptr;
+		parseProduct();
+		emit(opCode,2);
+		}
+	}
+
+void SliceExpression::Parser::parseProduct(void)
+	{
+	parseUnary();
+	while(true)
+		{
+		skipWhitespace();
+		if(*ptr!='*'&&*ptr!='/')
+			break;
+		OpCode opCode=*ptr=='*'?MULTIPLY:DIVIDE;
+		++ptr;
+		parseUnary();
+		emit(opCode,2);
+		}
+	}
+
+void SliceExpression::Parser::parseUnary(void)
+	{
+	skipWhitespace();
+	if(*ptr=='-')
+		{
+		++ptr;
+		parseUnary();
+		emit(NEGATE,1);
+		}
+	else if(*ptr=='+')
+		{
+		++ptr;
+		parseUnary();
+		}
+	else
+		parsePrimary();
+	}
+
+void SliceExpression::Parser::parsePrimary(void)
+	{
+	skipWhitespace();
+	if(*ptr=='(')
+		{
+		/* Parse a parenthesized subexpression: */
+		++ptr;
+		parseComparison();
+		skipWhitespace();
+		if(*ptr!=')')
+			fail("missing closing parenthesis");
+		++ptr;
+		}
+	else if(*ptr=='[')
+		{
+		/* Look up the variable name: */
+		const char* nameStart=++ptr;
+		while(*ptr!='\0'&&*ptr!=']')
+			++ptr;
+		if(*ptr!=']')
+			fail("missing closing bracket");
+		std::string name(nameStart,ptr);
+		++ptr;
+		int sliceIndex;
+		for(sliceIndex=0;sliceIndex<variables.getNumScalarVariables();++sliceIndex)
+			if(name==variables.getScalarVariableName(sliceIndex))
+				break;
+		if(sliceIndex==variables.getNumScalarVariables())
+			Misc::throwStdErr("SliceExpression: unknown variable \"%s\" in expression \"%s\"",name.c_str(),expression);
+		
+		/* Reuse the source slot if the variable was referenced before: */
+		int sourceIndex;
+		for(sourceIndex=0;sourceIndex<int(result.sourceSlices.size());++sourceIndex)
+			if(result.sourceSlices[sourceIndex]==sliceIndex)
+				break;
+		if(sourceIndex==int(result.sourceSlices.size()))
+			result.sourceSlices.push_back(sliceIndex);
+		emit(SOURCE,0,0.0,sourceIndex);
+		}
+	else if((*ptr>='0'&&*ptr<='9')||*ptr=='.')
+		{
+		/* Parse a numeric constant: */
+		char* numberEnd;
+		double value=strtod(ptr,&numberEnd);
+		if(numberEnd==ptr)
+			fail("malformed number");
+		ptr=numberEnd;
+		emit(CONSTANT,0,value);
+		}
+	else if((*ptr>='a'&&*ptr<='z')||(*ptr>='A'&&*ptr<='Z'))
+		{
+		/* Parse a function name: */
+		const char* nameStart=ptr;
+		while((*ptr>='a'&&*ptr<='z')||(*ptr>='A'&&*ptr<='Z')||(*ptr>='0'&&*ptr<='9'))
+			++ptr;
+		std::string name(nameStart,ptr);
+		static const char* const functionNames[7]={"abs","sqrt","log10","exp","min","max","if"};
+		static const OpCode functionOpCodes[7]={ABS,SQRT,LOG10,EXP,MIN,MAX,IF};
+		static const int functionNumArguments[7]={1,1,1,1,2,2,3};
+		int function;
+		for(function=0;function<7&&name!=functionNames[function];++function)
+			;
+		if(function==7)
+			{
+			ptr=nameStart;
+			fail("unknown function");
+			}
+		
+		/* Parse the argument list: */
+		skipWhitespace();
+		if(*ptr!='(')
+			fail("missing argument list");
+		++ptr;
+		for(int i=0;i<functionNumArguments[function];++i)
+			{
+			if(i>0)
+				{
+				skipWhitespace();
+				if(*ptr!=',')
+					fail("missing function argument");
+				++ptr;
+				}
+			parseComparison();
+			}
+		skipWhitespace();
+		if(*ptr!=')')
+			fail("missing closing parenthesis");
+		++ptr;
+		emit(functionOpCodes[function],functionNumArguments[function]);
+		}
+	else
+		fail("missing operand");
+	}
+
+/****************************************************
+Declaration of struct SliceExpression::EvaluationJob:
+****************************************************/
+
+struct SliceExpression::EvaluationJob
+	{
+	/* Elements: */
+	public:
+	const SliceExpression* expression; // The evaluated expression
+	const BlockIO* io; // Object reading and writing values
+	size_t firstValue,lastValue; // Range of values evaluated by this job
+	
+	/* Methods: */
+	void* evaluateThreadMethod(void)
+		{
+		double* stack=new double[expression->maxStackDepth*blockSize];
+		for(size_t blockStart=firstValue;blockStart<lastValue;blockStart+=blockSize)
+			{
+			size_t numValues=lastValue-blockStart;
+			if(numValues>blockSize)
+				numValues=blockSize;
+			expression->evaluateBlock(*io,blockStart,numValues,stack);
+			}
+		delete[] stack;
+		
+		return 0;
+		}
+	};
+
+/********************************
+Methods of class SliceExpression:
+********************************/
+
+void SliceExpression::evaluateBlock(const SliceExpression::BlockIO& io,size_t firstValue,size_t numValues,double* stack) const
+	{
+	/* Run the program on whole blocks; top points to the block on the top of the stack: */
+	double* top=stack-blockSize;
+	for(std::vector<Instruction>::const_iterator iIt=program.begin();iIt!=program.end();++iIt)
+		{
+		switch(iIt->opCode)
+			{
+			case CONSTANT:
+				top+=blockSize;
+				for(size_t i=0;i<numValues;++i)
+					top[i]=iIt->constant;
+				break;
+			
+			case SOURCE:
+				top+=blockSize;
+				io.readSourceBlock(sourceSlices[iIt->sourceIndex],firstValue,numValues,top);
+				break;
+			
+			case NEGATE:
+				for(size_t i=0;i<numValues;++i)
+					top[i]=-top[i];
+				break;
+			
+			case ABS:
+				for(size_t i=0;i<numValues;++i)
+					top[i]=fabs(top[i]);
+				break;
+			
+			case SQRT:
+				for(size_t i=0;i<numValues;++i)
+					top[i]=sqrt(top[i]);
+				break;
+			
+			case LOG10:
+				for(size_t i=0;i<numValues;++i)
+					top[i]=log10(top[i]);
+				break;
+			
+			case EXP:
+				for(size_t i=0;i<numValues;++i)
+					top[i]=exp(top[i]);
+				break;
+			
+			case IF:
+				{
+				/* Select between the second and third operands based on the first: */
+				top-=2*blockSize;
+				const double* a=top+blockSize;
+				const double* b=top+2*blockSize;
+				for(size_t i=0;i<numValues;++i)
+					top[i]=top[i]!=0.0?a[i]:b[i];
+				break;
+				}
+			
+			default:
+				{
+				/* Combine the two topmost blocks: */
+				top-=blockSize;
+				const double* b=top+blockSize;
+				switch(iIt->opCode)
+					{
+					case ADD:
+						for(size_t i=0;i<numValues;++i)
+							top[i]+=b[i];
+						break;
+					
+					case SUBTRACT:
+						for(size_t i=0;i<numValues;++i)
+							top[i]-=b[i];
+						break;
+					
+					case MULTIPLY:
+						for(size_t i=0;i<numValues;++i)
+							top[i]*=b[i];
+						break;
+					
+					case DIVIDE:
+						for(size_t i=0;i<numValues;++i)
+							top[i]/=b[i];
+						break;
+					
+					case LESS:
+						for(size_t i=0;i<numValues;++i)
+							top[i]=top[i]<b[i]?1.0:0.0;
+						break;
+					
+					case LESSEQUAL:
+						for(size_t i=0;i<numValues;++i)
+							top[i]=top[i]<=b[i]?1.0:0.0;
+						break;
+					
+					case GREATER:
+						for(size_t i=0;i<numValues;++i)
+							top[i]=top[i]>b[i]?1.0:0.0;
+						break;
+					
+					case GREATEREQUAL:
+						for(size_t i=0;i<numValues;++i)
+							top[i]=top[i]>=b[i]?1.0:0.0;
+						break;
+					
+					case MIN:
+						for(size_t i=0;i<numValues;++i)
+							if(top[i]>b[i])
+								top[i]=b[i];
+						break;
+					
+					case MAX:
+						for(size_t i=0;i<numValues;++i)
+							if(top[i]<b[i])
+								top[i]=b[i];
+						break;
+					
+					default:
+						;
+					}
+				break;
+				}
+			}
+		}
+	
+	/* Write the result: */
+	io.writeResultBlock(firstValue,numValues,top);
+	}
+
+SliceExpression::SliceExpression(const char* expression,const SlicedScalarVectorDataValueBase& variables)
+	:maxStackDepth(0)
+	{
+	Parser parser(expression,variables,*this);
+	parser.parse();
+	}
+
+void SliceExpression::evaluate(size_t numValues,const SliceExpression::BlockIO& io,int numThreads) const
+	{
+	/* Split the values into runs of whole blocks of roughly equal size: */
+	numThreads=getNumWorkerThreads(numThreads);
+	size_t numBlocks=(numValues+blockSize-1)/blockSize;
+	if(size_t(numThreads)>numBlocks/16+1)
+		numThreads=int(numBlocks/16+1);
+	EvaluationJob* jobs=new EvaluationJob[numThreads];
+	for(int i=0;i<numThreads;++i)
+		{
+		jobs[i].expression=this;
+		jobs[i].io=&io;
+		jobs[i].firstValue=((numBlocks*size_t(i))/size_t(numThreads))*blockSize;
+		jobs[i].lastValue=((numBlocks*size_t(i+1))/size_t(numThreads))*blockSize;
+		if(jobs[i].lastValue>numValues)
+			jobs[i].lastValue=numValues;
+		}
+	
+	/* Evaluate all runs in parallel: */
+	Threads::Thread* threads=numThreads>1?new Threads::Thread[numThreads-1]:0;
+	for(int i=1;i<numThreads;++i)
+		threads[i-1].start(&jobs[i],&EvaluationJob::evaluateThreadMethod);
+	jobs[0].evaluateThreadMethod();
+	for(int i=1;i<numThreads;++i)
+		threads[i-1].join();
+	delete[] threads;
+	delete[] jobs;
+	}
+
+}
+
+}
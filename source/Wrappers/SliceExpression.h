@@ -0,0 +1,106 @@
+/***********************************************************************
+SliceExpression - Class for arithmetic expressions over the scalar
+variables of a sliced data set, used to define derived variables such as
+masked or error-bounded results. Expressions are compiled into a small
+stack program that is evaluated over blocks of values in parallel.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_SLICEEXPRESSION_INCLUDED
+#define VISUALIZATION_WRAPPERS_SLICEEXPRESSION_INCLUDED
+
+#include <stddef.h>
+#include <vector>
+
+/* Forward declarations: */
+namespace Visualization {
+namespace Wrappers {
+class SlicedScalarVectorDataValueBase;
+}
+}
+
+namespace Visualization {
+
+namespace Wrappers {
+
+class SliceExpression
+	{
+	/* Embedded classes: */
+	public:
+	class BlockIO // Abstract base class to read source values and write result values in blocks of consecutive vertices
+		{
+		/* Constructors and destructors: */
+		public:
+		virtual ~BlockIO(void)
+			{
+			}
+		
+		/* Methods: */
+		virtual void readSourceBlock(int sourceSliceIndex,size_t firstValue,size_t numValues,double* values) const =0; // Reads a block of values from the given source slice; called from multiple threads
+		virtual void writeResultBlock(size_t firstValue,size_t numValues,const double* values) const =0; // Writes a block of result values; called from multiple threads on disjoint blocks
+		};
+	
+	static const size_t blockSize=1024; // Number of values evaluated in one go
+	
+	private:
+	enum OpCode // Enumerated type for stack program instructions
+		{
+		CONSTANT,SOURCE,
+		ADD,SUBTRACT,MULTIPLY,DIVIDE,NEGATE,
+		LESS,LESSEQUAL,GREATER,GREATEREQUAL,
+		ABS,SQRT,LOG10,EXP,MIN,MAX,IF
+		};
+	
+	struct Instruction // Structure for stack program instructions
+		{
+		/* Elements: */
+		public:
+		OpCode opCode; // Operation
+		double constant; // Constant value for CONSTANT instructions
+		int sourceIndex; // Index into the source slice list for SOURCE instructions
+		};
+	
+	class Parser; // Class to compile expression strings
+	struct EvaluationJob; // Structure describing a range of blocks evaluated by one thread
+	
+	/* Elements: */
+	std::vector<Instruction> program; // The compiled expression in postfix order
+	std::vector<int> sourceSlices; // Indices of the data set slices referenced by the expression
+	int maxStackDepth; // Maximum number of blocks on the evaluation stack
+	
+	/* Private methods: */
+	void evaluateBlock(const BlockIO& io,size_t firstValue,size_t numValues,double* stack) const; // Evaluates the expression for a single block using the given stack space
+	
+	/* Constructors and destructors: */
+	public:
+	SliceExpression(const char* expression,const SlicedScalarVectorDataValueBase& variables); // Compiles an expression referring to the given data value's scalar variables by name in square brackets; throws exception on syntax error
+	
+	/* Methods: */
+	const std::vector<int>& getSourceSlices(void) const // Returns the indices of all slices the expression depends on
+		{
+		return sourceSlices;
+		}
+	void evaluate(size_t numValues,const BlockIO& io,int numThreads =0) const; // Evaluates the expression for the given number of vertices using the given number of threads, or one thread per CPU
+	};
+
+}
+
+}
+
+#endif
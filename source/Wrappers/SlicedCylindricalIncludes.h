@@ -0,0 +1,33 @@
+/***********************************************************************
+SlicedCylindricalIncludes - Includes header files required by
+visualization modules representing cylindrical data sets with sliced
+data storage.
+Copyright (c) 2010 Patrick O'Leary
+
+This file is part of the 3D Data Visualizer (Visualizer).
+
+The 3D Data Visualizer is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+The 3D Data Visualizer is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with the 3D Data Visualizer; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+***********************************************************************/
+
+#ifndef VISUALIZATION_WRAPPERS_SLICEDCYLINDRICALINCLUDES_INCLUDED
+#define VISUALIZATION_WRAPPERS_SLICEDCYLINDRICALINCLUDES_INCLUDED
+
+#define NONSTANDARD_GLVERTEX_TEMPLATES
+#include <Templatized/SlicedCylindrical.h>
+#include <Templatized/SlicedCylindricalRenderer.h>
+#include <Templatized/SliceCaseTableTesseract.h>
+#include <Templatized/IsosurfaceCaseTableTesseract.h>
+
+#endif
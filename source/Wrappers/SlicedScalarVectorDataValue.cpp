@@ -34,9 +34,10 @@ Methods of class SlicedScalarVectorDataValueBase:
 ************************************************/
 
 SlicedScalarVectorDataValueBase::SlicedScalarVectorDataValueBase(void)
-	:numScalarVariables(0),scalarVariableNames(0),
+	:numScalarVariables(0),scalarVariableNames(0),scalarVariableVersions(0),
 	 numVectorComponents(0),
-	 numVectorVariables(0),vectorVariableNames(0),vectorVariableScalarIndices(0)
+	 numVectorVariables(0),vectorVariableNames(0),vectorVariableScalarIndices(0),
+	 sliceLoader(0)
 	{
 	}
 
@@ -45,6 +46,7 @@ SlicedScalarVectorDataValueBase::~SlicedScalarVectorDataValueBase(void)
 	for(int i=0;i<numScalarVariables;++i)
 		delete[] scalarVariableNames[i];
 	delete[] scalarVariableNames;
+	delete[] scalarVariableVersions;
 	for(int i=0;i<numVectorVariables;++i)
 		delete[] vectorVariableNames[i];
 	delete[] vectorVariableNames;
@@ -57,10 +59,15 @@ void SlicedScalarVectorDataValueBase::initialize(int sNumScalarVariables,int sNu
 	for(int i=0;i<numScalarVariables;++i)
 		delete[] scalarVariableNames[i];
 	delete[] scalarVariableNames;
+	delete[] scalarVariableVersions;
 	numScalarVariables=sNumScalarVariables;
 	scalarVariableNames=new char*[numScalarVariables];
+	scalarVariableVersions=new unsigned int[numScalarVariables];
 	for(int i=0;i<numScalarVariables;++i)
+		{
 		scalarVariableNames[i]=0;
+		scalarVariableVersions[i]=0;
+		}
 	
 	/* Initialize vector variable arrays: */
 	for(int i=0;i<numVectorVariables;++i)
@@ -98,15 +105,22 @@ int SlicedScalarVectorDataValueBase::addScalarVariable(const char* newScalarVari
 	{
 	/* Make room in the scalar variable array and copy the old variable names and create the new one: */
 	char** newScalarVariableNames=new char*[numScalarVariables+1];
+	unsigned int* newScalarVariableVersions=new unsigned int[numScalarVariables+1];
 	for(int i=0;i<numScalarVariables;++i)
+		{
 		newScalarVariableNames[i]=scalarVariableNames[i];
+		newScalarVariableVersions[i]=scalarVariableVersions[i];
+		}
 	newScalarVariableNames[numScalarVariables]=new char[strlen(newScalarVariableName)+1];
 	strcpy(newScalarVariableNames[numScalarVariables],newScalarVariableName);
+	newScalarVariableVersions[numScalarVariables]=0;
 	
-	/* Install the new scalar variable array: */
+	/* Install the new scalar variable arrays: */
 	delete[] scalarVariableNames;
+	delete[] scalarVariableVersions;
 	++numScalarVariables;
 	scalarVariableNames=newScalarVariableNames;
+	scalarVariableVersions=newScalarVariableVersions;
 	
 	return numScalarVariables-1;
 	}
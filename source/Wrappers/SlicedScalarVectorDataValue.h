@@ -24,9 +24,13 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef VISUALIZATION_WRAPPERS_SLICEDSCALARVECTORDATAVALUE_INCLUDED
 #define VISUALIZATION_WRAPPERS_SLICEDSCALARVECTORDATAVALUE_INCLUDED
 
+#include <vector>
+#include <Threads/Mutex.h>
 #include <Templatized/SlicedScalarExtractor.h>
 #include <Templatized/SlicedVectorExtractor.h>
 #include <Wrappers/DataValue.h>
+#include <Wrappers/SliceExpression.h>
+#include <Wrappers/DataSetResampler.h>
 
 namespace Visualization {
 
@@ -34,14 +38,30 @@ namespace Wrappers {
 
 class SlicedScalarVectorDataValueBase // Base class managing variable naming and indexing
 	{
+	/* Embedded classes: */
+	public:
+	class SliceLoader // Abstract base class for objects filling in data set slices when they are first accessed
+		{
+		/* Constructors and destructors: */
+		public:
+		virtual ~SliceLoader(void)
+			{
+			}
+		
+		/* Methods: */
+		virtual void loadSlice(int sliceIndex) =0; // Ensures that the given slice's values are present in the data set
+		};
+	
 	/* Elements: */
 	private:
 	int numScalarVariables; // Number of scalar variables in the sliced data set
 	char** scalarVariableNames; // Array of names of the individual scalar variables
+	unsigned int* scalarVariableVersions; // Array of version numbers of the individual scalar variables' values, incremented whenever the values change
 	int numVectorComponents; // Dimension of vectors
 	int numVectorVariables; // Number of vector variables in the sliced data set
 	char** vectorVariableNames; // Array of names of the individual vector variables
 	int* vectorVariableScalarIndices; // 2D array of indices of scalar variables defining each vector variable
+	SliceLoader* sliceLoader; // Object loading slices on demand, or null if all slices are present
 	
 	/* Constructors and destructors: */
 	public:
@@ -63,6 +83,14 @@ class SlicedScalarVectorDataValueBase // Base class managing variable naming and
 		{
 		return scalarVariableNames[scalarVariableIndex];
 		}
+	unsigned int getScalarVariableVersion(int scalarVariableIndex) const // Returns the version number of the given scalar variable's values
+		{
+		return scalarVariableVersions[scalarVariableIndex];
+		}
+	void invalidateScalarVariable(int scalarVariableIndex) // Marks the given scalar variable's values as changed
+		{
+		++scalarVariableVersions[scalarVariableIndex];
+		}
 	int getNumVectorVariables(void) const
 		{
 		return numVectorVariables;
@@ -75,6 +103,19 @@ class SlicedScalarVectorDataValueBase // Base class managing variable naming and
 		{
 		return vectorVariableScalarIndices[vectorVariableIndex*numVectorComponents+componentIndex];
 		}
+	SliceLoader* getSliceLoader(void) const // Returns the object loading slices on demand, or null
+		{
+		return sliceLoader;
+		}
+	void setSliceLoader(SliceLoader* newSliceLoader) // Sets an object to load slices on demand; object is not owned by the data value
+		{
+		sliceLoader=newSliceLoader;
+		}
+	void loadSlice(int sliceIndex) const // Ensures that the given slice is present in the data set
+		{
+		if(sliceLoader!=0)
+			sliceLoader->loadSlice(sliceIndex);
+		}
 	};
 
 template <class DSParam,class VScalarParam>
@@ -88,15 +129,258 @@ class SlicedScalarVectorDataValue:public SlicedScalarVectorDataValueBase,public
 	typedef typename Base::SE SE;
 	typedef typename Base::VE VE;
 	
-	/* Elements: */
 	private:
+	class DerivedVariables:public SliceLoader // Class computing derived scalar variables when their slices are first accessed
+		{
+		/* Embedded classes: */
+		private:
+		typedef typename DS::ValueScalar ValueScalar;
+		typedef typename DS::ValueSlice ValueSlice;
+		
+		struct Variable // Structure describing a derived scalar variable
+			{
+			/* Elements: */
+			public:
+			int sliceIndex; // Index of the slice holding the variable's values
+			SliceExpression* expression; // Expression defining the variable
+			bool computed; // Flag whether the slice holds the variable's current values
+			bool used; // Flag whether the variable has been accessed, such that it is computed ahead of time for other value steps
+			};
+		
+		class SliceIO:public SliceExpression::BlockIO // Class reading blocks of data set slice values and writing blocks of result values
+			{
+			/* Elements: */
+			private:
+			const DS& ds; // The data set
+			ValueScalar* resultArray; // Array receiving the expression's values
+			
+			/* Constructors and destructors: */
+			public:
+			SliceIO(const DS& sDs,ValueScalar* sResultArray)
+				:ds(sDs),resultArray(sResultArray)
+				{
+				}
+			
+			/* Methods from SliceExpression::BlockIO: */
+			virtual void readSourceBlock(int sourceSliceIndex,size_t firstValue,size_t numValues,double* values) const
+				{
+				/* Decode the block in one go; source slices might be stored in half-precision or quantized form: */
+				ds.getValueSlice(sourceSliceIndex).decode(firstValue,numValues,values);
+				}
+			virtual void writeResultBlock(size_t firstValue,size_t numValues,const double* values) const
+				{
+				ValueScalar* dPtr=resultArray+firstValue;
+				for(size_t i=0;i<numValues;++i,++dPtr)
+					*dPtr=ValueScalar(values[i]);
+				}
+			};
+		
+		class StepSliceIO:public SliceExpression::BlockIO // Class reading blocks of source values of a value step that is not stored in the data set
+			{
+			/* Elements: */
+			private:
+			const std::vector<ValueSlice>& sourceSlices; // Descriptors of the value step's slices, indexed by data set slice index
+			ValueScalar* resultArray; // Array receiving the expression's values
+			
+			/* Constructors and destructors: */
+			public:
+			StepSliceIO(const std::vector<ValueSlice>& sSourceSlices,ValueScalar* sResultArray)
+				:sourceSlices(sSourceSlices),resultArray(sResultArray)
+				{
+				}
+			
+			/* Methods from SliceExpression::BlockIO: */
+			virtual void readSourceBlock(int sourceSliceIndex,size_t firstValue,size_t numValues,double* values) const
+				{
+				sourceSlices[sourceSliceIndex].decode(firstValue,numValues,values);
+				}
+			virtual void writeResultBlock(size_t firstValue,size_t numValues,const double* values) const
+				{
+				ValueScalar* dPtr=resultArray+firstValue;
+				for(size_t i=0;i<numValues;++i,++dPtr)
+					*dPtr=ValueScalar(values[i]);
+				}
+			};
+		
+		/* Elements: */
+		DS& ds; // The data set containing the derived variables' slices
+		SlicedScalarVectorDataValueBase& dataValue; // The data value whose variable versions are updated when derived variables are computed
+		SliceLoader* sourceLoader; // Object loading the data set's other slices on demand, or null
+		Threads::Mutex& slicesMutex; // Mutex protecting the data set's list of slices against background threads
+		Threads::Mutex variablesMutex; // Mutex serializing computation of derived variables
+		std::vector<Variable> variables; // List of derived variables in order of definition
+		
+		/* Constructors and destructors: */
+		public:
+		DerivedVariables(DS& sDs,SlicedScalarVectorDataValueBase& sDataValue,SliceLoader* sSourceLoader,Threads::Mutex& sSlicesMutex)
+			:ds(sDs),dataValue(sDataValue),sourceLoader(sSourceLoader),slicesMutex(sSlicesMutex)
+			{
+			}
+		virtual ~DerivedVariables(void)
+			{
+			for(typename std::vector<Variable>::iterator vIt=variables.begin();vIt!=variables.end();++vIt)
+				delete vIt->expression;
+			}
+		
+		/* Methods from SliceLoader: */
+		virtual void loadSlice(int sliceIndex)
+			{
+			/* Pass requests for non-derived slices on: */
+			size_t variableIndex;
+			SliceExpression* expression=0;
+			{
+			Threads::Mutex::Lock variablesLock(variablesMutex);
+			for(variableIndex=0;variableIndex<variables.size()&&variables[variableIndex].sliceIndex!=sliceIndex;++variableIndex)
+				;
+			if(variableIndex<variables.size())
+				{
+				variables[variableIndex].used=true;
+				if(variables[variableIndex].computed)
+					return;
+				expression=variables[variableIndex].expression;
+				}
+			}
+			if(expression==0)
+				{
+				if(sourceLoader!=0)
+					sourceLoader->loadSlice(sliceIndex);
+				return;
+				}
+			
+			/* Make sure the source slices are present; they might be derived variables themselves: */
+			const std::vector<int>& sourceSlices=expression->getSourceSlices();
+			for(std::vector<int>::const_iterator sIt=sourceSlices.begin();sIt!=sourceSlices.end();++sIt)
+				loadSlice(*sIt);
+			
+			/* Compute the variable into a new array without holding the lock, such that the slice's current array is never written: */
+			size_t numValues=ds.getTotalNumVertices();
+			ValueScalar* newArray=new ValueScalar[numValues];
+			SliceIO io(ds,newArray);
+			expression->evaluate(numValues,io);
+			
+			/* Swap the new array in unless another thread beat us to it: */
+			{
+			Threads::Mutex::Lock variablesLock(variablesMutex);
+			Variable& variable=variables[variableIndex];
+			if(!variable.computed)
+				{
+				ds.swapSliceArray(variable.sliceIndex,newArray);
+				variable.computed=true;
+				dataValue.invalidateScalarVariable(variable.sliceIndex);
+				}
+			}
+			delete[] newArray;
+			}
+		
+		/* New methods: */
+		void addVariable(int sliceIndex,SliceExpression* expression) // Adds a derived variable; object inherits expression
+			{
+			Threads::Mutex::Lock variablesLock(variablesMutex);
+			Variable newVariable;
+			newVariable.sliceIndex=sliceIndex;
+			newVariable.expression=expression;
+			newVariable.computed=false;
+			newVariable.used=false;
+			variables.push_back(newVariable);
+			}
+		bool isStepComplete(const std::vector<bool>& stepComputed) // Returns true if the given flags show all used derived variables as computed for a value step
+			{
+			Threads::Mutex::Lock variablesLock(variablesMutex);
+			for(size_t i=0;i<variables.size();++i)
+				if(variables[i].used&&(i>=stepComputed.size()||!stepComputed[i]))
+					return false;
+			return true;
+			}
+		void computeStep(const ValueScalar* const stepSlices[],int numStepSlices,std::vector<ValueScalar*>& stepDerivedSlices,std::vector<bool>& stepComputed) // Computes all used derived variables for a value step that is not stored in the data set
+			{
+			/* Take a snapshot of the data set's slices and the derived variables; the first slices hold the step's own values: */
+			std::vector<ValueSlice> sourceSlices;
+			std::vector<Variable> stepVariables;
+			{
+			Threads::Mutex::Lock slicesLock(slicesMutex);
+			Threads::Mutex::Lock variablesLock(variablesMutex);
+			int numSlices=ds.getNumSlices();
+			sourceSlices.reserve(numSlices);
+			for(int i=0;i<numSlices;++i)
+				sourceSlices.push_back(i<numStepSlices?ValueSlice(stepSlices[i]):ds.getValueSlice(i));
+			stepVariables=variables;
+			}
+			size_t numVariables=stepVariables.size();
+			
+			/* Find the derived variables needed by the used ones, in reverse order of definition: */
+			std::vector<int> variableIndices(sourceSlices.size(),-1);
+			for(size_t i=0;i<numVariables;++i)
+				variableIndices[stepVariables[i].sliceIndex]=int(i);
+			for(size_t i=numVariables;i>0;--i)
+				if(stepVariables[i-1].used)
+					{
+					const std::vector<int>& sources=stepVariables[i-1].expression->getSourceSlices();
+					for(std::vector<int>::const_iterator sIt=sources.begin();sIt!=sources.end();++sIt)
+						if(variableIndices[*sIt]>=0)
+							stepVariables[variableIndices[*sIt]].used=true;
+					}
+			
+			/* Make room for variables defined since the step was last computed: */
+			if(stepDerivedSlices.size()<numVariables)
+				{
+				stepDerivedSlices.resize(numVariables,0);
+				stepComputed.resize(numVariables,false);
+				}
+			
+			/* Compute the needed variables in order of definition, reading derived sources from the step's own arrays: */
+			size_t numValues=ds.getTotalNumVertices();
+			for(size_t i=0;i<numVariables;++i)
+				{
+				if(!stepComputed[i]&&stepVariables[i].used)
+					{
+					if(stepDerivedSlices[i]==0)
+						stepDerivedSlices[i]=new ValueScalar[numValues];
+					
+					/* Use a single thread to leave the other CPUs to the extraction threads: */
+					StepSliceIO io(sourceSlices,stepDerivedSlices[i]);
+					stepVariables[i].expression->evaluate(numValues,io,1);
+					stepComputed[i]=true;
+					}
+				if(stepComputed[i])
+					sourceSlices[stepVariables[i].sliceIndex]=ValueSlice(stepDerivedSlices[i]);
+				}
+			}
+		void swapStep(std::vector<ValueScalar*>& stepDerivedSlices,std::vector<bool>& stepComputed) // Exchanges the derived variables' arrays and computation flags with those of a value step
+			{
+			Threads::Mutex::Lock variablesLock(variablesMutex);
+			size_t numValues=ds.getTotalNumVertices();
+			if(stepDerivedSlices.size()<variables.size())
+				{
+				stepDerivedSlices.resize(variables.size(),0);
+				stepComputed.resize(variables.size(),false);
+				}
+			for(size_t i=0;i<variables.size();++i)
+				{
+				if(stepDerivedSlices[i]==0)
+					stepDerivedSlices[i]=new ValueScalar[numValues];
+				ds.swapSliceArray(variables[i].sliceIndex,stepDerivedSlices[i]);
+				bool computed=stepComputed[i];
+				stepComputed[i]=variables[i].computed;
+				variables[i].computed=computed;
+				dataValue.invalidateScalarVariable(variables[i].sliceIndex);
+				}
+			}
+		};
+	
+	/* Elements: */
 	const DS* dataSet; // Pointer to the data set described by this data value
+	Threads::Mutex slicesMutex; // Mutex serializing adding slices to the data set against background threads computing derived variables
+	DerivedVariables* derivedVariables; // Object computing derived scalar variables, or null if there are none
 	
 	/* Constructors and destructors: */
 	public:
 	SlicedScalarVectorDataValue(void) // Creates uninitialized data value
-		:dataSet(0)
+		:dataSet(0),derivedVariables(0)
+		{
+		}
+	~SlicedScalarVectorDataValue(void)
 		{
+		delete derivedVariables;
 		}
 	private:
 	SlicedScalarVectorDataValue(const SlicedScalarVectorDataValue& source); // Prohibit copy constructor
@@ -114,19 +398,86 @@ class SlicedScalarVectorDataValue:public SlicedScalarVectorDataValueBase,public
 		}
 	using SlicedScalarVectorDataValueBase::getNumScalarVariables;
 	using SlicedScalarVectorDataValueBase::getScalarVariableName;
+	using SlicedScalarVectorDataValueBase::getScalarVariableVersion;
 	using SlicedScalarVectorDataValueBase::getNumVectorVariables;
 	using SlicedScalarVectorDataValueBase::getVectorVariableName;
 	SE getScalarExtractor(int scalarVariableIndex) const
 		{
-		return SE(dataSet->getSliceArray(scalarVariableIndex));
+		loadSlice(scalarVariableIndex);
+		return SE(dataSet->getValueSlice(scalarVariableIndex));
 		}
 	VE getVectorExtractor(int vectorVariableIndex) const
 		{
 		VE result;
 		for(int i=0;i<dimension;++i)
-			result.setSlice(i,dataSet->getSliceArray(getVectorVariableScalarIndex(vectorVariableIndex,i)));
+			{
+			int sliceIndex=getVectorVariableScalarIndex(vectorVariableIndex,i);
+			loadSlice(sliceIndex);
+			result.setSlice(i,dataSet->getValueSlice(sliceIndex));
+			}
 		return result;
 		}
+	int addDerivedScalarVariable(DS& ds,const char* name,const char* expression) // Adds a scalar variable defined by an expression over the existing scalar variables; values are computed when the variable is first accessed
+		{
+		/* Compile the expression against the existing variables: */
+		SliceExpression* newExpression=new SliceExpression(expression,*this);
+		
+		/* Add a slice to hold the variable's values: */
+		int sliceIndex;
+		{
+		Threads::Mutex::Lock slicesLock(slicesMutex);
+		sliceIndex=ds.addSlice();
+		}
+		if(derivedVariables==0)
+			{
+			/* Intercept slice loading to compute derived variables on demand: */
+			derivedVariables=new DerivedVariables(ds,*this,getSliceLoader(),slicesMutex);
+			setSliceLoader(derivedVariables);
+			}
+		derivedVariables->addVariable(sliceIndex,newExpression);
+		
+		return addScalarVariable(name);
+		}
+	int addResampledScalarVariable(DS& ds,const char* name,const Visualization::Abstract::DataSet* source,int sourceScalarVariableIndex) // Adds a scalar variable holding another data set's scalar variable resampled at the data set's vertices; vertices outside the other data set's domain receive zero
+		{
+		/* Collect the vertex positions in the order of the slice arrays: */
+		size_t numVertices=ds.getTotalNumVertices();
+		std::vector<DataSetResampler::Point> vertexPositions;
+		vertexPositions.reserve(numVertices);
+		for(typename DS::VertexIterator vIt=ds.beginVertices();vIt!=ds.endVertices();++vIt)
+			vertexPositions.push_back(DataSetResampler::Point(vIt->getPosition()));
+		
+		/* Resample the other data set's variable at the vertices: */
+		DataSetResampler resampler(source,sourceScalarVariableIndex);
+		std::vector<DataSetResampler::VScalar> values(numVertices);
+		resampler.resample(numVertices,&vertexPositions[0],&values[0],DataSetResampler::VScalar(0));
+		
+		/* Store the values in a new slice: */
+		int sliceIndex;
+		{
+		Threads::Mutex::Lock slicesLock(slicesMutex);
+		sliceIndex=ds.addSlice();
+		}
+		typename DS::ValueScalar* slicePtr=ds.getSliceArray(sliceIndex);
+		for(size_t i=0;i<numVertices;++i,++slicePtr)
+			*slicePtr=typename DS::ValueScalar(values[i]);
+		
+		return addScalarVariable(name);
+		}
+	bool areDerivedStepSlicesComplete(const std::vector<bool>& stepComputed) const // Returns true if the given flags show all derived scalar variables used so far as computed for a value step
+		{
+		return derivedVariables==0||derivedVariables->isStepComplete(stepComputed);
+		}
+	void computeDerivedStepSlices(const typename DS::ValueScalar* const stepSlices[],int numStepSlices,std::vector<typename DS::ValueScalar*>& stepDerivedSlices,std::vector<bool>& stepComputed) const // Computes the derived scalar variables used so far for a value step that is not stored in the data set, given the step's values of the data set's first slices; can be called from a background thread
+		{
+		if(derivedVariables!=0)
+			derivedVariables->computeStep(stepSlices,numStepSlices,stepDerivedSlices,stepComputed);
+		}
+	void swapDerivedStepSlices(std::vector<typename DS::ValueScalar*>& stepDerivedSlices,std::vector<bool>& stepComputed) // Exchanges the derived scalar variables' values with those of a value step whose values of the data set's first slices were just swapped in
+		{
+		if(derivedVariables!=0)
+			derivedVariables->swapStep(stepDerivedSlices,stepComputed);
+		}
 	};
 
 }
@@ -37,6 +37,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Templatized/VolumeRenderingSampler.h>
 #include <Wrappers/TripleChannelVolumeRendererExtractor.h>
 
+#include <ScalarQuantizer.h>
 #include <TripleChannelRaycaster.h>
 
 namespace Visualization {
@@ -86,13 +87,17 @@ TripleChannelVolumeRenderer<DataSetWrapperParam>::TripleChannelVolumeRenderer(
 		Misc::throwStdErr("TripleChannelVolumeRenderer: Mismatching data set type");
 	const DS& ds=myDataSet->getDs();
 	
-	/* Create a volume rendering sampler: */
-	Visualization::Templatized::VolumeRenderingSampler<DS> sampler(ds);
+	/* Create a volume rendering sampler; the raycaster splits volumes larger than a single texture into bricks: */
+	Visualization::Templatized::VolumeRenderingSampler<DS> sampler(ds,1024);
 	
 	/* Initialize the raycaster: */
 	raycaster=new TripleChannelRaycaster(sampler.getSamplerSize(),ds.getDomainBox());
 	
-	/* Sample the three scalar channels: */
+	/* Get the three channels' scalar extractors, and quantize their cached value ranges linearly: */
+	const SE* ses[3];
+	ScalarQuantizer quantizers[3];
+	ScalarQuantizer* quantizerPtrs[3];
+	TripleChannelRaycaster::Voxel* voxels[3];
 	for(int channel=0;channel<3;++channel)
 		{
 		/* Get a scalar extractor for the channel: */
@@ -100,12 +105,20 @@ TripleChannelVolumeRenderer<DataSetWrapperParam>::TripleChannelVolumeRenderer(
 		const ScalarExtractor* myScalarExtractor=dynamic_cast<const ScalarExtractor*>(variableManager->getScalarExtractor(svi));
 		if(myScalarExtractor==0)
 			Misc::throwStdErr("TripleChannelVolumeRenderer: Mismatching scalar extractor type");
-		const SE& se=myScalarExtractor->getSe();
-		
-		/* Sample the channel: */
-		sampler.sample(se,raycaster->getData(channel),raycaster->getDataStrides(),algorithm->getPipe(),100.0f/3.0f,100.0f*float(channel)/3.0f,algorithm);
-		
-		/* Set the channel's parameters: */
+		ses[channel]=&myScalarExtractor->getSe();
+		const Visualization::Abstract::DataSet::VScalarRange& valueRange=variableManager->getScalarValueRange(svi);
+		quantizers[channel]=ScalarQuantizer(ScalarQuantizer::LINEAR,valueRange.first,valueRange.second);
+		quantizerPtrs[channel]=&quantizers[channel];
+		voxels[channel]=raycaster->getData(channel);
+		}
+	
+	/* Sample all three channels in a single pass, locating each sample point only once: */
+	sampler.sample(3,ses,quantizerPtrs,voxels,raycaster->getDataStrides(),algorithm->getPipe(),100.0f,0.0f,algorithm);
+	
+	/* Set the channels' parameters: */
+	for(int channel=0;channel<3;++channel)
+		{
+		int svi=myParameters->scalarVariableIndices[channel];
 		raycaster->setChannelEnabled(channel,myParameters->channelEnableds[channel]);
 		raycaster->setColorMap(channel,variableManager->getColorMap(svi));
 		raycaster->setTransparencyGamma(channel,myParameters->transparencyGammas[channel]);
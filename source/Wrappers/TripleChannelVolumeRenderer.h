@@ -51,6 +51,7 @@ class TripleChannelVolumeRenderer:public Visualization::Abstract::Element
 	typedef typename DataSetWrapper::DS DS; // Type of templatized data set
 	typedef typename DS::Scalar Scalar; // Scalar type of data set's domain
 	typedef typename DataSetWrapper::SE SE; // Type of templatized scalar extractor
+	typedef typename SE::Scalar VScalar; // Value type of scalar extractor
 	typedef typename DataSetWrapper::ScalarExtractor ScalarExtractor; // Compatible scalar extractor wrapper class
 	
 	/* Elements: */
@@ -68,6 +68,10 @@ class VectorExtractor:public Visualization::Abstract::VectorExtractor
 		{
 		return ve;
 		}
+	void setVe(const VE& newVe) // Replaces the templatized vector extractor
+		{
+		ve=newVe;
+		}
 	};
 
 }
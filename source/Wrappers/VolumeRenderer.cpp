@@ -39,10 +39,13 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <GLMotif/RowColumn.h>
 #include <GLMotif/Label.h>
 #include <GLMotif/TextField.h>
+#include <GLMotif/ToggleButton.h>
 
+#include <Abstract/VariableManager.h>
 #include <Templatized/VolumeRenderingSampler.h>
 #include <Wrappers/VolumeRendererExtractor.h>
 
+#include <ColorBar.h>
 #ifdef VISUALIZATION_USE_SHADERS
 #include <SingleChannelRaycaster.h>
 #else
@@ -63,11 +66,10 @@ VolumeRenderer<DataSetWrapperParam>::VolumeRenderer(
 	Visualization::Abstract::Algorithm* algorithm,
 	Visualization::Abstract::Parameters* sParameters)
 	:Visualization::Abstract::Element(sParameters),
-	 #ifndef VISUALIZATION_USE_SHADERS
+	 variableManager(algorithm->getVariableManager()),
 	 colorMap(0),
-	 #endif
 	 renderer(0),
-	 sliceFactorValue(0),sliceFactorSlider(0),transparencyGammaValue(0),transparencyGammaSlider(0)
+	 sliceFactorValue(0),sliceFactorSlider(0),transparencyGammaValue(0),transparencyGammaSlider(0),paletteEditorQuantizerToggle(0)
 	{
 	/* Get proper pointers to the algorithm and parameter objects: */
 	typedef VolumeRendererExtractor<DataSetWrapper> MyAlgorithm;
@@ -80,7 +82,6 @@ VolumeRenderer<DataSetWrapperParam>::VolumeRenderer(
 		Misc::throwStdErr("VolumeRenderer: Mismatching parameter object type");
 	
 	/* Get a reference to the templatized data set: */
-	Visualization::Abstract::VariableManager* variableManager=algorithm->getVariableManager();
 	const Visualization::Abstract::DataSet* dataSet=variableManager->getDataSetByScalarVariable(myParameters->scalarVariableIndex);
 	const DataSetWrapper* myDataSet=dynamic_cast<const DataSetWrapper*>(dataSet);
 	if(myDataSet==0)
@@ -93,27 +94,37 @@ VolumeRenderer<DataSetWrapperParam>::VolumeRenderer(
 	if(myScalarExtractor==0)
 		Misc::throwStdErr("VolumeRenderer: Mismatching scalar extractor type");
 	const SE& se=myScalarExtractor->getSe();
-
-	/* Create a volume rendering sampler: */
-	Visualization::Templatized::VolumeRenderingSampler<DS> sampler(ds);
+	
+	/* Get the scalar variable's color map: */
+	colorMap=variableManager->getColorMap(svi);
+	
+	/* Create a quantizer mapping the scalar variable's cached value range to the full voxel range: */
+	const Visualization::Abstract::DataSet::VScalarRange& valueRange=variableManager->getScalarValueRange(svi);
+	quantizer=ScalarQuantizer(ScalarQuantizer::Mode(myParameters->quantizationMode),valueRange.first,valueRange.second);
 	
 	#ifdef VISUALIZATION_USE_SHADERS
 	
+	/* Create a volume rendering sampler; the raycaster splits volumes larger than a single texture into bricks: */
+	Visualization::Templatized::VolumeRenderingSampler<DS> sampler(ds,1024);
+	
 	/* Initialize the raycaster: */
 	renderer=new SingleChannelRaycaster(sampler.getSamplerSize(),ds.getDomainBox());
 	
 	/* Sample the scalar variable: */
-	sampler.sample(se,renderer->getData(),renderer->getDataStrides(),algorithm->getPipe(),100.0f,0.0f,algorithm);
+	sampler.sample(se,quantizer,renderer->getData(),renderer->getDataStrides(),algorithm->getPipe(),100.0f,0.0f,algorithm);
 	
 	renderer->updateData();
 	
 	/* Set the raycaster's parameters: */
-	renderer->setColorMap(variableManager->getColorMap(svi));
+	renderer->setColorMap(colorMap);
 	renderer->setTransparencyGamma(myParameters->transparencyGamma);
 	renderer->setStepSize(myParameters->sliceFactor);
 	
 	#else
 	
+	/* Create a volume rendering sampler: */
+	Visualization::Templatized::VolumeRenderingSampler<DS> sampler(ds);
+	
 	/* Initialize the slice-based volume renderer: */
 	renderer=new PaletteRenderer;
 	
@@ -129,7 +140,7 @@ VolumeRenderer<DataSetWrapperParam>::VolumeRenderer(
 	ptrdiff_t dataStrides[3];
 	for(int i=0;i<3;++i)
 		dataStrides[i]=increments[i];
-	sampler.sample(se,voxels,dataStrides,algorithm->getPipe(),100.0f,0.0f,algorithm);
+	sampler.sample(se,quantizer,voxels,dataStrides,algorithm->getPipe(),100.0f,0.0f,algorithm);
 	renderer->finishVoxelBlock();
 	
 	/* Set the renderer's model space position and size: */
@@ -198,10 +209,15 @@ VolumeRenderer<DataSetWrapperParam>::createSettingsDialog(
 	settingsDialogPopup->setResizableFlags(true,false);
 	
 	GLMotif::RowColumn* settingsDialog=new GLMotif::RowColumn("SettingsDialog",settingsDialogPopup,false);
-	settingsDialog->setNumMinorWidgets(3);
+	settingsDialog->setOrientation(GLMotif::RowColumn::VERTICAL);
+	settingsDialog->setPacking(GLMotif::RowColumn::PACK_TIGHT);
+	settingsDialog->setNumMinorWidgets(1);
+	
+	GLMotif::RowColumn* sliderBox=new GLMotif::RowColumn("SliderBox",settingsDialog,false);
+	sliderBox->setNumMinorWidgets(3);
 	
 	/* Create a slider/textfield combo to change the slice factor: */
-	new GLMotif::Label("SliceFactorLabel",settingsDialog,"Slice Factor");
+	new GLMotif::Label("SliceFactorLabel",sliderBox,"Slice Factor");
 	
 	#ifdef VISUALIZATION_USE_SHADERS
 	double sliceFactor=renderer->getStepSize();
@@ -209,33 +225,58 @@ VolumeRenderer<DataSetWrapperParam>::createSettingsDialog(
 	double sliceFactor=renderer->getSliceFactor();
 	#endif
 	
-	sliceFactorValue=new GLMotif::TextField("SliceFactorValue",settingsDialog,5);
+	sliceFactorValue=new GLMotif::TextField("SliceFactorValue",sliderBox,5);
 	sliceFactorValue->setPrecision(3);
 	sliceFactorValue->setFloatFormat(GLMotif::TextField::FIXED);
 	sliceFactorValue->setValue(sliceFactor);
 	
-	sliceFactorSlider=new GLMotif::Slider("SliceFactorSlider",settingsDialog,GLMotif::Slider::HORIZONTAL,ss->fontHeight*10.0f);
+	sliceFactorSlider=new GLMotif::Slider("SliceFactorSlider",sliderBox,GLMotif::Slider::HORIZONTAL,ss->fontHeight*10.0f);
 	sliceFactorSlider->setValueRange(0.25,4.0,0.05);
 	sliceFactorSlider->setValue(sliceFactor);
 	sliceFactorSlider->getValueChangedCallbacks().add(this,&VolumeRenderer::sliderValueChangedCallback);
 	
 	/* Create a slider/textfield combo to change the transparency gamma factor: */
-	new GLMotif::Label("TransparencyGammaLabel",settingsDialog,"Transparency Gamma");
+	new GLMotif::Label("TransparencyGammaLabel",sliderBox,"Transparency Gamma");
 	
 	#ifdef VISUALIZATION_USE_SHADERS
 	float transparencyGamma=renderer->getTransparencyGamma();
 	#endif
 	
-	transparencyGammaValue=new GLMotif::TextField("TransparencyGammaValue",settingsDialog,5);
+	transparencyGammaValue=new GLMotif::TextField("TransparencyGammaValue",sliderBox,5);
 	transparencyGammaValue->setPrecision(3);
 	transparencyGammaValue->setFloatFormat(GLMotif::TextField::FIXED);
 	transparencyGammaValue->setValue(transparencyGamma);
 	
-	transparencyGammaSlider=new GLMotif::Slider("TransparencyGammaSlider",settingsDialog,GLMotif::Slider::HORIZONTAL,ss->fontHeight*10.0f);
+	transparencyGammaSlider=new GLMotif::Slider("TransparencyGammaSlider",sliderBox,GLMotif::Slider::HORIZONTAL,ss->fontHeight*10.0f);
 	transparencyGammaSlider->setValueRange(0.125,8.0,0.025);
 	transparencyGammaSlider->setValue(transparencyGamma);
 	transparencyGammaSlider->getValueChangedCallbacks().add(this,&VolumeRenderer::sliderValueChangedCallback);
 	
+	sliderBox->manageChild();
+	
+	if(quantizer.getMode()!=ScalarQuantizer::LINEAR)
+		{
+		/* Label this element's own color bar with the data values its non-linearly quantized voxels represent, leaving the shared color bar linear for other elements: */
+		GLMotif::ColorBar* colorBar=new GLMotif::ColorBar("VoxelValueColorBar",settingsDialog,ss->fontHeight*3.0f,6,5);
+		colorBar->setColorMap(colorMap);
+		colorBar->setQuantizer(quantizer);
+		
+		/* Create a toggle to display the palette editor's control point values through this element's quantizer while the element's scalar variable is edited: */
+		paletteEditorQuantizerToggle=new GLMotif::ToggleButton("PaletteEditorQuantizerToggle",settingsDialog,"Show Voxel Values in Palette Editor");
+		paletteEditorQuantizerToggle->setBorderWidth(0.0f);
+		paletteEditorQuantizerToggle->setHAlignment(GLFont::Left);
+		
+		/* An element re-extracted for a new value step takes over the palette editor from the element it replaces: */
+		typename VolumeRendererExtractor<DataSetWrapper>::Parameters* myParameters=dynamic_cast<typename VolumeRendererExtractor<DataSetWrapper>::Parameters*>(getParameters());
+		if(myParameters==0)
+			Misc::throwStdErr("VolumeRenderer: Mismatching parameter object type");
+		bool quantized=variableManager->isPaletteEditorQuantized(myParameters->scalarVariableIndex);
+		if(quantized)
+			variableManager->setPaletteEditorQuantizer(myParameters->scalarVariableIndex,quantizer);
+		paletteEditorQuantizerToggle->setToggle(quantized);
+		paletteEditorQuantizerToggle->getValueChangedCallbacks().add(this,&VolumeRenderer::paletteEditorQuantizerToggleCallback);
+		}
+	
 	settingsDialog->manageChild();
 	
 	return settingsDialogPopup;
@@ -329,6 +370,22 @@ VolumeRenderer<DataSetWrapperParam>::sliderValueChangedCallback(
 		}
 	}
 
+template <class DataSetWrapperParam>
+inline
+void
+VolumeRenderer<DataSetWrapperParam>::paletteEditorQuantizerToggleCallback(
+	GLMotif::ToggleButton::ValueChangedCallbackData* cbData)
+	{
+	/* Get proper pointer to the parameter object: */
+	typename VolumeRendererExtractor<DataSetWrapper>::Parameters* myParameters=dynamic_cast<typename VolumeRendererExtractor<DataSetWrapper>::Parameters*>(getParameters());
+	if(myParameters==0)
+		Misc::throwStdErr("VolumeRenderer: Mismatching parameter object type");
+	
+	/* Display the palette editor's control point values through this element's quantizer, or linearly again; this only works while the element's scalar variable is the current one: */
+	if(!variableManager->setPaletteEditorQuantizer(myParameters->scalarVariableIndex,cbData->set?quantizer:ScalarQuantizer()))
+		cbData->toggle->setToggle(false);
+	}
+
 }
 
 }
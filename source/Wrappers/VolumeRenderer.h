@@ -26,8 +26,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #define VISUALIZATION_WRAPPERS_VOLUMERENDERER_INCLUDED
 
 #include <GLMotif/Slider.h>
+#include <GLMotif/ToggleButton.h>
 
 #include <Abstract/Element.h>
+#include <ScalarQuantizer.h>
 
 /* Forward declarations: */
 class GLColorMap;
@@ -39,6 +41,11 @@ class SingleChannelRaycaster;
 #else
 class PaletteRenderer;
 #endif
+namespace Visualization {
+namespace Abstract {
+class VariableManager;
+}
+}
 
 namespace Visualization {
 
@@ -54,14 +61,17 @@ class VolumeRenderer:public Visualization::Abstract::Element
 	typedef typename DataSetWrapper::DS DS; // Type of templatized data set
 	typedef typename DS::Scalar Scalar; // Scalar type of data set's domain
 	typedef typename DataSetWrapper::SE SE; // Type of templatized scalar extractor
+	typedef typename SE::Scalar VScalar; // Value type of scalar extractor
 	typedef typename DataSetWrapper::ScalarExtractor ScalarExtractor; // Compatible scalar extractor wrapper class
 	
 	/* Elements: */
 	private:
+	const GLColorMap* colorMap; // A transfer function to map scalar values to colors and opacities
+	Visualization::Abstract::VariableManager* variableManager; // Variable manager owning the scalar variable's palette editor
+	ScalarQuantizer quantizer; // The quantizer that mapped the scalar variable's values to voxel values, i.e., to color map positions
 	#ifdef VISUALIZATION_USE_SHADERS
 	SingleChannelRaycaster* renderer; // A raycasting volume renderer
 	#else
-	const GLColorMap* colorMap; // A transfer function to map scalar values to colors and opacities
 	PaletteRenderer* renderer; // A texture-based volume renderer
 	float transparencyGamma; // A gamma correction factor to apply to color map opacities
 	#endif
@@ -71,6 +81,7 @@ class VolumeRenderer:public Visualization::Abstract::Element
 	GLMotif::Slider* sliceFactorSlider; // Slider to change current slice factor value
 	GLMotif::TextField* transparencyGammaValue; // Text field to display current gamma correction factor
 	GLMotif::Slider* transparencyGammaSlider; // Slider to change current gamma correction factor value
+	GLMotif::ToggleButton* paletteEditorQuantizerToggle; // Toggle button to display the palette editor's control point values through the element's quantizer
 	
 	/* Constructors and destructors: */
 	public:
@@ -93,6 +104,7 @@ class VolumeRenderer:public Visualization::Abstract::Element
 	
 	/* New methods: */
 	void sliderValueChangedCallback(GLMotif::Slider::ValueChangedCallbackData* cbData); // Callback when the sliders in the settings dialog change value
+	void paletteEditorQuantizerToggleCallback(GLMotif::ToggleButton::ValueChangedCallbackData* cbData); // Callback when the palette editor quantizer toggle changes value
 	};
 
 }
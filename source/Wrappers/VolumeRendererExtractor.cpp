@@ -29,6 +29,13 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include <Misc/File.h>
 #include <Comm/MulticastPipe.h>
 #include <Comm/ClusterPipe.h>
+#include <GLMotif/StyleSheet.h>
+#include <GLMotif/WidgetManager.h>
+#include <GLMotif/PopupWindow.h>
+#include <GLMotif/RowColumn.h>
+#include <GLMotif/Label.h>
+
+#include <ScalarQuantizer.h>
 
 #include <Abstract/VariableManager.h>
 #include <Wrappers/ScalarExtractor.h>
@@ -57,6 +64,7 @@ VolumeRendererExtractor<DataSetWrapperParam>::Parameters::readBinary(
 		scalarVariableIndex=readScalarVariableNameBinary<DataSourceParam>(dataSource,variableManager);
 	sliceFactor=dataSource.template read<Scalar>();
 	transparencyGamma=dataSource.template read<float>();
+	quantizationMode=dataSource.template read<int>();
 	}
 
 template <class DataSetWrapperParam>
@@ -75,6 +83,7 @@ VolumeRendererExtractor<DataSetWrapperParam>::Parameters::writeBinary(
 		writeScalarVariableNameBinary<DataSinkParam>(dataSink,scalarVariableIndex,variableManager);
 	dataSink.template write<Scalar>(sliceFactor);
 	dataSink.template write<float>(transparencyGamma);
+	dataSink.template write<int>(quantizationMode);
 	}
 
 template <class DataSetWrapperParam>
@@ -94,6 +103,7 @@ VolumeRendererExtractor<DataSetWrapperParam>::Parameters::read(
 		scalarVariableIndex=readScalarVariableNameAscii(hash,"scalarVariable",variableManager);
 		sliceFactor=readParameterAscii<Scalar>(hash,"sliceFactor",sliceFactor);
 		transparencyGamma=readParameterAscii<float>(hash,"transparencyGamma",transparencyGamma);
+		quantizationMode=readParameterAscii<int>(hash,"quantizationMode",quantizationMode);
 		
 		/* Clean up: */
 		deleteAsciiParameterFileSectionHash(hash);
@@ -145,6 +155,7 @@ VolumeRendererExtractor<DataSetWrapperParam>::Parameters::write(
 		writeScalarVariableNameAscii<Misc::File>(file,"scalarVariable",scalarVariableIndex,variableManager);
 		writeParameterAscii<Misc::File,Scalar>(file,"sliceFactor",sliceFactor);
 		writeParameterAscii<Misc::File,float>(file,"transparencyGamma",transparencyGamma);
+		writeParameterAscii<Misc::File,int>(file,"quantizationMode",quantizationMode);
 		file.write("}\n",2);
 		}
 	else
@@ -175,7 +186,7 @@ VolumeRendererExtractor<DataSetWrapperParam>::Parameters::write(
 	/* Calculate the byte size of the marshalled parameter packet: */
 	size_t packetSize=0;
 	packetSize+=getScalarVariableNameLength(scalarVariableIndex,variableManager);
-	packetSize+=sizeof(Scalar)+sizeof(float);
+	packetSize+=sizeof(Scalar)+sizeof(float)+sizeof(int);
 	
 	/* Write the packet size to the cluster pipe: */
 	pipe.write<unsigned int>(packetSize);
@@ -201,11 +212,13 @@ VolumeRendererExtractor<DataSetWrapperParam>::VolumeRendererExtractor(
 	Visualization::Abstract::VariableManager* sVariableManager,
 	 Comm::MulticastPipe* sPipe)
 	:Abstract::Algorithm(sVariableManager,sPipe),
-	 parameters(sVariableManager->getCurrentScalarVariable())
+	 parameters(sVariableManager->getCurrentScalarVariable()),
+	 quantizationModeBox(0)
 	{
 	/* Initialize parameters: */
 	parameters.sliceFactor=Scalar(1);
 	parameters.transparencyGamma=1.0f;
+	parameters.quantizationMode=ScalarQuantizer::LINEAR;
 	}
 
 template <class DataSetWrapperParam>
@@ -215,6 +228,41 @@ VolumeRendererExtractor<DataSetWrapperParam>::~VolumeRendererExtractor(
 	{
 	}
 
+template <class DataSetWrapperParam>
+inline
+GLMotif::Widget*
+VolumeRendererExtractor<DataSetWrapperParam>::createSettingsDialog(
+	GLMotif::WidgetManager* widgetManager)
+	{
+	/* Create the settings dialog window: */
+	GLMotif::PopupWindow* settingsDialogPopup=new GLMotif::PopupWindow("VolumeRendererExtractorSettingsDialogPopup",widgetManager,"Volume Renderer Extractor Settings");
+	settingsDialogPopup->setResizableFlags(false,false);
+	
+	GLMotif::RowColumn* settingsDialog=new GLMotif::RowColumn("SettingsDialog",settingsDialogPopup,false);
+	settingsDialog->setNumMinorWidgets(2);
+	
+	new GLMotif::Label("QuantizationModeLabel",settingsDialog,"Quantization");
+	
+	quantizationModeBox=new GLMotif::RadioBox("QuantizationModeBox",settingsDialog,false);
+	quantizationModeBox->setOrientation(GLMotif::RowColumn::HORIZONTAL);
+	quantizationModeBox->setPacking(GLMotif::RowColumn::PACK_GRID);
+	quantizationModeBox->setAlignment(GLMotif::Alignment::LEFT);
+	quantizationModeBox->setSelectionMode(GLMotif::RadioBox::ALWAYS_ONE);
+	
+	quantizationModeBox->addToggle("Linear");
+	quantizationModeBox->addToggle("Logarithmic");
+	quantizationModeBox->addToggle("Histogram Equalized");
+	
+	quantizationModeBox->setSelectedToggle(parameters.quantizationMode);
+	quantizationModeBox->getValueChangedCallbacks().add(this,&VolumeRendererExtractor::quantizationModeBoxCallback);
+	
+	quantizationModeBox->manageChild();
+	
+	settingsDialog->manageChild();
+	
+	return settingsDialogPopup;
+	}
+
 template <class DataSetWrapperParam>
 inline
 Visualization::Abstract::Element*
@@ -238,6 +286,16 @@ VolumeRendererExtractor<DataSetWrapperParam>::startSlaveElement(
 	return new VolumeRenderer(this,extractParameters);
 	}
 
+template <class DataSetWrapperParam>
+inline
+void
+VolumeRendererExtractor<DataSetWrapperParam>::quantizationModeBoxCallback(
+	GLMotif::RadioBox::ValueChangedCallbackData* cbData)
+	{
+	/* Select the quantization transform for subsequently created volume renderers: */
+	parameters.quantizationMode=quantizationModeBox->getToggleIndex(cbData->newSelectedToggle);
+	}
+
 }
 
 }
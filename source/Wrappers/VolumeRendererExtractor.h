@@ -25,6 +25,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #define VISUALIZATION_WRAPPERS_VOLUMERENDEREREXTRACTOR_INCLUDED
 
 #include <Misc/Autopointer.h>
+#include <GLMotif/RadioBox.h>
 
 #include <Abstract/DataSet.h>
 #include <Abstract/Parameters.h>
@@ -75,6 +76,7 @@ class VolumeRendererExtractor:public Visualization::Abstract::Algorithm
 		int scalarVariableIndex; // Index of the scalar variable for direct volume rendering
 		Scalar sliceFactor; // Slice distance for texture- or raycasting-based volume rendering
 		float transparencyGamma; // Overall transparency adjustment factor
+		int quantizationMode; // Transform mapping scalar values to voxel values, as a ScalarQuantizer::Mode
 		
 		/* Private methods: */
 		template <class DataSourceParam>
@@ -111,6 +113,9 @@ class VolumeRendererExtractor:public Visualization::Abstract::Algorithm
 	static const char* name; // Identifying name of this algorithm
 	Parameters parameters; // The volume renderer extraction parameters used by this extractor
 	
+	/* UI components: */
+	GLMotif::RadioBox* quantizationModeBox; // Radio box with toggles for quantization transforms
+	
 	/* Constructors and destructors: */
 	public:
 	VolumeRendererExtractor(Visualization::Abstract::VariableManager* sVariableManager,Comm::MulticastPipe* sPipe); // Creates a volume renderer extractor
@@ -125,6 +130,7 @@ class VolumeRendererExtractor:public Visualization::Abstract::Algorithm
 		{
 		return true;
 		}
+	virtual GLMotif::Widget* createSettingsDialog(GLMotif::WidgetManager* widgetManager);
 	virtual Visualization::Abstract::Parameters* cloneParameters(void) const
 		{
 		return new Parameters(parameters);
@@ -137,6 +143,7 @@ class VolumeRendererExtractor:public Visualization::Abstract::Algorithm
 		{
 		return name;
 		}
+	void quantizationModeBoxCallback(GLMotif::RadioBox::ValueChangedCallbackData* cbData);
 	};
 
 }